@@ -70,6 +70,7 @@
 #include <tofino/bf_pal/pltfm_intf.h>
 #include <bf_pm/bf_pm_intf.h>
 #include <bf_rt/bf_rt_init.h>
+#include <ctx_json/ctx_json_cache.h>
 /* Required for lld_sku API */
 #include <lld/lld_dr_if.h>
 #include <kdrv/bf_kdrv/bf_ioctl.h>
@@ -5109,6 +5110,26 @@ static int bf_switchd_load_switch_conf_file() {
       switchd_ctx->args.install_dir, switchd_ctx->args.conf_file, switchd_ctx);
 }
 
+static void bf_switchd_ctx_json_cache_init() {
+  const char *dir = switchd_ctx->ctx_json_cache_dir;
+  if (!strlen(dir)) return;
+
+  if (mkdir(dir, 0755) && errno != EEXIST) {
+    bf_sys_log_and_trace(BF_MOD_SWITCHD,
+                         BF_LOG_ERR,
+                         "Cannot create ctx_json_cache_dir %s: %s, Context "
+                         "JSON caching disabled",
+                         dir,
+                         strerror(errno));
+    return;
+  }
+  ctx_json_cache_dir_set(dir);
+  bf_sys_log_and_trace(BF_MOD_SWITCHD,
+                       BF_LOG_DBG,
+                       "bf_switchd: caching Context JSON in %s",
+                       dir);
+}
+
 void *bf_dma2virt_dbg(bf_dma_addr_t dma_addr) {
   /* Iterate through all the dma memory pools created to get the virtual
      address */
@@ -5383,6 +5404,12 @@ void bf_switchd_exit_sighandler(int signum) {
   bf_dev_id_t dev_id;
   bf_subdev_id_t subdev_id;
 
+  if (signum == SIGTERM || signum == SIGQUIT) {
+    /* Deliver the queued port events and stop the driver's threads while the
+     * devices are still mapped.  Not from the SIGIO handler, the threads
+     * cannot be joined from a signal handler. */
+    bf_drv_cleanup();
+  }
   if (signum == SIGKILL || signum == SIGTERM || signum == SIGQUIT ||
       signum == SIGIO) {
     for (dev_id = 0; dev_id < BF_MAX_DEV_COUNT; dev_id++) {
@@ -5871,6 +5898,7 @@ int bf_switchd_lib_init(bf_switchd_context_t *ctx) {
     if (switchd_ctx) free(switchd_ctx);
     return ret;
   }
+  bf_switchd_ctx_json_cache_init();
 
   bf_switchd_set_dflt_skip_options();
 
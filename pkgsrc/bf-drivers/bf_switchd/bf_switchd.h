@@ -266,6 +266,8 @@ typedef struct bf_switchd_internal_context_t {
   /* MUST keep dma_info of all subdevices within a device contiguous!! */
   bf_dma_info_t dma_info[BF_MAX_DEV_COUNT][BF_MAX_SUBDEV_COUNT];
   char board_port_map_conf_file[BF_SWITCHD_MAX_FILE_NAME];
+  /* Context JSON binary cache directory, empty if caching is disabled. */
+  char ctx_json_cache_dir[BF_SWITCHD_MAX_FILE_NAME];
   void *rpc_server_cookie;
   uint32_t (*dru_sim_cpu_to_pcie_rd_fn)(bf_dev_id_t asic, uint32_t addr);
   void (*dru_sim_cpu_to_pcie_wr_fn)(bf_dev_id_t asic,
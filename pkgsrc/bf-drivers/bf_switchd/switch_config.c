@@ -768,6 +768,9 @@ static char *get_line(char *string_to_parse, int line_no) {
  *       "pipe_scope": integer list, describes the logical pipelines of the chip
  *                                   which will be programmed with this P4
  *                                   pipeline.
+ * The optional top level "ctx_json_cache_dir" string names a directory, created
+ * if missing, where parsed context.json files are cached in binary form so that
+ * later loads of the same file skip the JSON parsing.
  */
 int switch_dev_config_init(const char *install_dir,
                            const char *config_filename,
@@ -805,6 +808,10 @@ int switch_dev_config_init(const char *install_dir,
         cJSON *swch = cJSON_ParseWithOpts(config_file, &ptr, true);
         if (swch) {
           switch_parse_chip_list(swch, self);
+          to_abs_path(self->ctx_json_cache_dir,
+                      swch,
+                      "ctx_json_cache_dir",
+                      install_dir);
           switch_p4_pipeline_config_init(install_dir, swch, self);
         } else {
           int lines_in_cfg = count_chars(config_file, '\n');
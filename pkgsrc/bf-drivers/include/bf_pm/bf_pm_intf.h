@@ -1005,6 +1005,18 @@ bf_status_t bf_pm_port_fsm_init_in_up_state(
  */
 bf_status_t bf_pm_tasklet_scheduler();
 
+/**
+ * @brief Run port FSM tasklets on a pool of worker threads. FSMs of
+ * different ports then execute in parallel while each port's FSM still runs
+ * one step at a time. Zero, the default, runs every tasklet on the thread
+ * calling bf_pm_tasklet_scheduler.
+ *
+ * @param num_workers Number of worker threads, at most 16
+ *
+ * @return Status of the API call
+ */
+bf_status_t bf_pm_tasklet_workers_set(uint32_t num_workers);
+
 /**
  * @brief Initialize the bf PM module
  *
@@ -354,6 +354,13 @@ class BfRtTable {
    */
   using keyDataPairs = std::vector<std::pair<BfRtTableKey *, BfRtTableData *>>;
 
+  /**
+   * @brief Vector of pair of Key and Data passed in to the multi entry
+   * modify API.
+   */
+  using constKeyDataPairs =
+      std::vector<std::pair<const BfRtTableKey *, const BfRtTableData *>>;
+
   virtual ~BfRtTable() = default;
   //// Table APIs
   /**
@@ -735,6 +742,27 @@ class BfRtTable {
                                        const BfRtTableKey &key,
                                        const BfRtTableData &data) const = 0;
 
+  /**
+   * @brief Modify several existing entries of the table in one call.
+   * Index based resource tables (Meter, LPF, WRED) program runs of
+   * consecutive indices with a single range update, converting each distinct
+   * spec to the hardware format only once. Other tables modify the entries
+   * one by one. Processing stops at the first failure.
+   *
+   * @param[in] session Session Object
+   * @param[in] dev_tgt Device target
+   * @param[in] flags Call flags
+   * @param[in] key_data_pairs Vector of Pairs(key, data) to modify. When the
+   * same key appears more than once the last data wins.
+   *
+   * @return Status of the API call
+   */
+  virtual bf_status_t tableEntryModMulti(
+      const BfRtSession &session,
+      const bf_rt_target_t &dev_tgt,
+      const uint64_t &flags,
+      const constKeyDataPairs &key_data_pairs) const = 0;
+
   /**
    * @brief Delete an entry of the table
    *
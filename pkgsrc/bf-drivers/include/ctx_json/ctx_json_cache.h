@@ -0,0 +1,95 @@
+/*******************************************************************************
+ *  Copyright (C) 2024 Intel Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing,
+ *  software distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions
+ *  and limitations under the License.
+ *
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+
+/**
+ * @file ctx_json_cache.h
+ *
+ * Loading of Context JSON files through a precompiled binary cache.
+ *
+ * The first load of a Context JSON parses the text and stores the resulting
+ * tree in a pointer-free binary file named after the XXH64 hash of the JSON
+ * contents. Later loads of identical contents, including copies in temporary
+ * files, map that file and rebuild the tree with one allocation and no text
+ * parsing. Stale or corrupted caches are ignored and rewritten.
+ *
+ * Caching is disabled until a cache directory is set with
+ * ctx_json_cache_dir_set. bf_switchd sets it from the "ctx_json_cache_dir"
+ * entry of its conf file.
+ */
+
+#ifndef __CTX_JSON_CACHE__
+#define __CTX_JSON_CACHE__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <target-utils/third-party/cJSON/cJSON.h>
+
+#define CTX_JSON_CACHE_VERSION 2
+
+typedef struct ctx_json_file_s ctx_json_file_t;
+
+/**
+ * Load a Context JSON file.
+ *
+ * @param path The path to the Context JSON file.
+ * @param use_cache Look up and populate the binary cache. When false, or when
+ * no cache directory is set, the file is always parsed from text and no cache
+ * is written.
+ *
+ * @return A handle owning the parsed tree, or NULL on error. The handle must
+ * be released with ctx_json_file_free, never with cJSON_Delete on its root.
+ */
+ctx_json_file_t *ctx_json_file_load(const char *path, bool use_cache);
+
+/**
+ * @return The root of the tree. Its structure must not be changed, string
+ * values may be modified in place.
+ */
+cJSON *ctx_json_file_root(const ctx_json_file_t *file);
+
+/**
+ * @return True if the tree was rebuilt from the binary cache.
+ */
+bool ctx_json_file_from_cache(const ctx_json_file_t *file);
+
+/**
+ * @return The size of the Context JSON text in bytes.
+ */
+size_t ctx_json_file_size(const ctx_json_file_t *file);
+
+/**
+ * Release a handle returned by ctx_json_file_load and its tree.
+ */
+void ctx_json_file_free(ctx_json_file_t *file);
+
+/**
+ * Set the directory the binary caches are stored in and enable caching. By
+ * default no directory is set and Context JSON files are always parsed.
+ *
+ * @param dir The cache directory, NULL disables caching.
+ */
+void ctx_json_cache_dir_set(const char *dir);
+
+/**
+ * @return The cache directory, NULL if caching is disabled.
+ */
+const char *ctx_json_cache_dir_get(void);
+
+#endif /* __CTX_JSON_CACHE__ */
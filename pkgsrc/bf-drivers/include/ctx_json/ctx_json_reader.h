@@ -0,0 +1,119 @@
+/*******************************************************************************
+ *  Copyright (C) 2024 Intel Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing,
+ *  software distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions
+ *  and limitations under the License.
+ *
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+
+/**
+ * @file ctx_json_reader.h
+ *
+ * Low memory JSON reader for the Context JSON and BF-RT JSON files.
+ *
+ * The reader produces a regular cJSON tree, so all existing cJSON accessors
+ * keep working, but allocates it in two passes: a first scan validates the
+ * text and sizes the tree, a second one fills a single node array and a
+ * single string area. There is no per node or per string allocation and no
+ * copy of the text is needed.
+ *
+ * Objects with many members are indexed by key when the tree is built, so
+ * that ctx_json_object_get finds a member in constant time instead of
+ * scanning the object.
+ */
+
+#ifndef __CTX_JSON_READER__
+#define __CTX_JSON_READER__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <target-utils/third-party/cJSON/cJSON.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Objects with at least this many members are indexed by key. */
+#define CTX_JSON_READER_INDEX_MIN_MEMBERS 16
+
+/**
+ * Parse a JSON text.
+ *
+ * @param json The JSON text, it does not have to be NUL terminated.
+ * @param len The length of the text in bytes.
+ *
+ * @return The root of the tree, or NULL on error. The tree must be released
+ * with ctx_json_reader_free, never with cJSON_Delete.
+ */
+cJSON *ctx_json_reader_parse(const char *json, size_t len);
+
+/**
+ * Index a tree whose nodes were allocated by the caller as one array, in
+ * pre-order, with node 0 as the root.
+ *
+ * @param nodes The node array.
+ * @param num_nodes The number of nodes in the array.
+ *
+ * @return 0 if successful, -1 on error. The caller keeps ownership of the
+ * nodes and must call ctx_json_reader_free on the root before freeing them.
+ */
+int ctx_json_reader_attach(cJSON *nodes, uint32_t num_nodes);
+
+/**
+ * Release a tree returned by ctx_json_reader_parse, or the index of a tree
+ * passed to ctx_json_reader_attach.
+ *
+ * Items added to the tree with the cJSON_Add functions after parsing are
+ * released as well.
+ */
+void ctx_json_reader_free(cJSON *root);
+
+/**
+ * Fetch a member of an object by key, matched exactly as with
+ * cJSON_GetObjectItemCaseSensitive.
+ *
+ * Indexed objects of a tree built by the reader are searched in constant
+ * time, any other object is scanned.
+ *
+ * @param object The object.
+ * @param key The key of the member.
+ *
+ * @return The member, or NULL if the object has no member with this key.
+ */
+cJSON *ctx_json_object_get(const cJSON *object, const char *key);
+
+/**
+ * Replace the value of an item of a tree built by the reader with a string.
+ * The new value is released together with the tree.
+ *
+ * @param item The item, it must not be a non empty array or object.
+ * @param value The new value.
+ *
+ * @return 0 if successful, -1 on error.
+ */
+int ctx_json_reader_set_string(cJSON *item, const char *value);
+
+/**
+ * @return The number of bytes allocated for a tree built by the reader,
+ * including its index, or 0 if the tree was not built by the reader.
+ */
+size_t ctx_json_reader_mem_size(const cJSON *root);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CTX_JSON_READER__ */
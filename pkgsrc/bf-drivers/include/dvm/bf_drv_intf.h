@@ -234,6 +234,14 @@ static inline unsigned int bf_dma_get_buf_cnt(bf_dma_info_t *dma_info,
  */
 bf_status_t bf_drv_init(void);
 
+/**
+ * @brief Stop the threads of the port event bus, see
+ * bf_drv_client_port_events_async_set and bf_drv_port_event_dampening_set.
+ * Events already queued are delivered first.  Call at teardown, before the
+ * devices are removed or unmapped, bf_switchd does so on SIGTERM and SIGQUIT.
+ */
+void bf_drv_cleanup(void);
+
 /**
  * @brief Add a new device to the pktmgr on the device. After this call, the
  * device is ready for packet rx/tx api processing.
@@ -558,6 +566,109 @@ bf_status_t bf_port_client_register_status_notif(
 bf_status_t bf_port_client_register_speed_notif(bf_drv_port_speed_cb port_speed,
                                                 void *cookie);
 
+/**
+ * @brief Port link flap dampening parameters.
+ *
+ * Every link down event adds @c penalty to the port's figure of merit, which
+ * decays exponentially with @c half_life_ms.  Once it reaches
+ * @c suppress_threshold the port is held down for consumers of the port event
+ * bus until it decays below @c reuse_threshold.  The figure of merit is capped
+ * so that a port is never held down for longer than @c max_suppress_ms after
+ * its last flap.  Zero valued fields take the defaults when enabling.
+ */
+typedef struct bf_drv_port_dampening_cfg_s {
+  bool enable;
+  uint32_t penalty;
+  uint32_t suppress_threshold;
+  uint32_t reuse_threshold;
+  uint32_t half_life_ms;
+  uint32_t max_suppress_ms;
+} bf_drv_port_dampening_cfg_t;
+
+/**
+ * @brief Port event bus counters of a device.
+ */
+typedef struct bf_drv_port_event_stats_s {
+  /* Link and speed events received from port manager while an asynchronous
+   * consumer or dampening is in use, others go straight to the application */
+  uint64_t events;
+  /* Events queued for asynchronous clients */
+  uint64_t queued;
+  /* Queued events merged into a later event for the same port or dropped as
+   * no longer changing the state already delivered */
+  uint64_t coalesced;
+  /* Events delivered from client threads */
+  uint64_t delivered;
+  /* Link events withheld from consumers by dampening */
+  uint64_t suppressed;
+  /* Number of times a port was released from suppression */
+  uint64_t reused;
+  /* Ports currently suppressed */
+  uint32_t ports_suppressed;
+} bf_drv_port_event_stats_t;
+
+/**
+ * @brief Deliver the application port status and speed notifications
+ * asynchronously.
+ *
+ * When enabled, the callbacks registered with
+ * bf_port_client_register_status_notif and bf_port_client_register_speed_notif
+ * are no longer invoked from the port manager context.  Events are queued,
+ * coalesced per port and delivered in batches from a dedicated thread.
+ *
+ * @param[in] async Deliver from a dedicated thread if @c true, inline if
+ *                  @c false.
+ *
+ * @return Status of the API call.
+ */
+bf_status_t bf_port_client_port_events_async_set(bool async);
+
+/**
+ * @brief Configure link flap dampening of a device.
+ *
+ * Dampening applies to the application notifications and to driver clients
+ * which opted in with bf_drv_client_port_events_async_set.  Other driver
+ * clients always see every link event.
+ *
+ * @param[in] dev_id The ASIC id.
+ * @param[in] cfg Dampening parameters.
+ *
+ * @return Status of the API call.
+ */
+bf_status_t bf_drv_port_event_dampening_set(
+    bf_dev_id_t dev_id, const bf_drv_port_dampening_cfg_t *cfg);
+
+/**
+ * @brief Get the link flap dampening configuration of a device.
+ *
+ * @param[in] dev_id The ASIC id.
+ * @param[out] cfg Dampening parameters in effect.
+ *
+ * @return Status of the API call.
+ */
+bf_status_t bf_drv_port_event_dampening_get(bf_dev_id_t dev_id,
+                                            bf_drv_port_dampening_cfg_t *cfg);
+
+/**
+ * @brief Get the port event bus counters of a device.
+ *
+ * @param[in] dev_id The ASIC id.
+ * @param[out] stats Counters.
+ *
+ * @return Status of the API call.
+ */
+bf_status_t bf_drv_port_event_stats_get(bf_dev_id_t dev_id,
+                                        bf_drv_port_event_stats_t *stats);
+
+/**
+ * @brief Clear the port event bus counters of a device.
+ *
+ * @param[in] dev_id The ASIC id.
+ *
+ * @return Status of the API call.
+ */
+bf_status_t bf_drv_port_event_stats_clear(bf_dev_id_t dev_id);
+
 /**
  * @brief Register port mode change callback.
  *
@@ -1065,6 +1176,24 @@ bf_status_t bf_drv_client_register_warm_init_flags(
     bool override_fast_recfg,
     bool issue_fast_recfg_port_cb);
 
+/**
+ * @brief Move a client's port status and speed callbacks onto the port event
+ * bus.
+ *
+ * By default these callbacks are issued synchronously from the port manager
+ * context.  A client which does not need to act on a link change before the
+ * port manager moves on may opt in to have them queued, coalesced per port,
+ * dampened and delivered in batches from a thread of its own.
+ *
+ * @param[in] client_handle The client handle allocated.
+ * @param[in] async Deliver from a dedicated thread if @c true, inline if
+ *                  @c false.
+ *
+ * @return Status of the API call
+ */
+bf_status_t bf_drv_client_port_events_async_set(
+    bf_drv_client_handle_t client_handle, bool async);
+
 /**
  * @brief Get the drivers version
  *
@@ -79,6 +79,44 @@ typedef struct pbus_arb_ctrl_s {
   uint32_t ctrl_1[BF_PIPE_COUNT];
 } pbus_arb_ctrl_t;
 
+/* Maximum number of descriptors pushed by a single burst call. */
+#define LLD_DR_PUSH_BURST_MAX 64
+
+/* An instruction list descriptor, see lld_push_ilist and
+ * lld_push_ilist_mcast.  A zero mcast_vector pushes a unicast descriptor. */
+typedef struct lld_ilist_desc_s {
+  bf_dma_addr_t list;
+  int list_len;
+  int rsp_sz;
+  bool s_f;
+  bf_dma_addr_t ack_ptr;
+  uint64_t msg_id;
+  uint32_t mcast_vector;
+} lld_ilist_desc_t;
+
+/* A write-block descriptor, see lld_push_wb and lld_push_wb_mcast.  A zero
+ * mcast_vector pushes a unicast descriptor. */
+typedef struct lld_wb_desc_s {
+  int entry_sz;
+  uint32_t addr_inc;
+  int data_sz;
+  bool single_entry;
+  bf_dma_addr_t source;
+  uint64_t dest;
+  uint64_t msg_id;
+  uint32_t mcast_vector;
+} lld_wb_desc_t;
+
+/* A read-block descriptor, see lld_push_rb. */
+typedef struct lld_rb_desc_s {
+  int entry_sz;
+  uint32_t addr_inc;
+  int data_sz;
+  uint64_t source;
+  bf_dma_addr_t dest;
+  uint64_t msg_id;
+} lld_rb_desc_t;
+
 int lld_dr_lock_required(bf_dev_id_t dev_id, bf_dma_dr_id_t dr);
 int lld_subdev_dr_lock_required(bf_dev_id_t dev_id,
                                 bf_subdev_id_t subdev_id,
@@ -133,6 +171,10 @@ int lld_push_ilist(bf_dev_id_t dev_id,
                    bool s_f,
                    bf_dma_addr_t ack_ptr,
                    uint64_t msg_id);
+int lld_push_ilist_burst(bf_dev_id_t dev_id,
+                         int dr_0_3,
+                         const lld_ilist_desc_t *ilists,
+                         int n_descs);
 int lld_push_ilist_mcast(bf_dev_id_t dev_id,
                          int dr_0_3,
                          bf_dma_addr_t list,
@@ -151,6 +193,9 @@ int lld_push_wb(bf_dev_id_t dev_id,
                 uint64_t dest,
                 uint64_t msg_id);
 
+int lld_push_wb_burst(bf_dev_id_t dev_id,
+                      const lld_wb_desc_t *wbs,
+                      int n_descs);
 int lld_push_wb_mcast(bf_dev_id_t dev_id,
                       int entry_sz,
                       uint32_t addr_inc,
@@ -184,6 +229,9 @@ int lld_push_rb(bf_dev_id_t dev_id,
                 uint64_t source,
                 bf_dma_addr_t dest,
                 uint64_t msg_id);
+int lld_push_rb_burst(bf_dev_id_t dev_id,
+                      const lld_rb_desc_t *rbs,
+                      int n_descs);
 int lld_push_que_rb(bf_dev_id_t dev_id,
                     int dr_0_1,
                     int entry_sz,
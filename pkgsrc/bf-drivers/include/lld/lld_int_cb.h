@@ -39,4 +39,8 @@ typedef void (*lld_mac_int_dump_cb)(lld_mac_int_dump_this_cb fn,
 typedef void (*lld_mac_int_poll_cb)(bf_dev_id_t dev_id, int mac_block, int ch);
 typedef void (*lld_mac_int_bh_wakeup_cb)(bf_dev_id_t dev_id);
 
+#ifdef __cplusplus
+}
+#endif /* C++ */
+
 #endif  // lld_int_cb_h
@@ -21,6 +21,8 @@
 #ifndef lld_subdev_dr_if_h
 #define lld_subdev_dr_if_h
 
+#include <lld/lld_dr_if.h>
+
 /* Allow the use in C++ code.  */
 #ifdef __cplusplus
 extern "C" {
@@ -42,6 +44,11 @@ int lld_subdev_push_ilist(bf_dev_id_t dev_id,
                           bool s_f,
                           bf_dma_addr_t ack_ptr,
                           uint64_t msg_id);
+int lld_subdev_push_ilist_burst(bf_dev_id_t dev_id,
+                                bf_subdev_id_t subdev_id,
+                                int dr_0_3,
+                                const lld_ilist_desc_t *ilists,
+                                int n_descs);
 int lld_subdev_push_ilist_mcast(bf_dev_id_t dev_id,
                                 bf_subdev_id_t subdev_id,
                                 int dr_0_3,
@@ -62,6 +69,10 @@ int lld_subdev_push_wb(bf_dev_id_t dev_id,
                        uint64_t dest,
                        uint64_t msg_id);
 
+int lld_subdev_push_wb_burst(bf_dev_id_t dev_id,
+                             bf_subdev_id_t subdev_id,
+                             const lld_wb_desc_t *wbs,
+                             int n_descs);
 int lld_subdev_push_wb_mcast(bf_dev_id_t dev_id,
                              bf_subdev_id_t subdev_id,
                              int entry_sz,
@@ -99,6 +110,10 @@ int lld_subdev_push_rb(bf_dev_id_t dev_id,
                        uint64_t source,
                        bf_dma_addr_t dest,
                        uint64_t msg_id);
+int lld_subdev_push_rb_burst(bf_dev_id_t dev_id,
+                             bf_subdev_id_t subdev_id,
+                             const lld_rb_desc_t *rbs,
+                             int n_descs);
 int lld_subdev_push_que_rb(bf_dev_id_t dev_id,
                            bf_subdev_id_t subdev_id,
                            int dr_0_1,
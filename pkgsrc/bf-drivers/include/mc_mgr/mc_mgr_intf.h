@@ -680,6 +680,29 @@ bf_status_t bf_mc_dissociate_node(bf_mc_session_hdl_t shdl,
                                   bf_dev_id_t dev,
                                   bf_mc_mgrp_hdl_t mgrp_hdl,
                                   bf_mc_node_hdl_t node_hdl);
+/**
+ * Apply a list of node to group associations and dissociations as one update.
+ * The operations are applied in order with the same rules as
+ * @ref bf_mc_associate_node and @ref bf_mc_dissociate_node but the hardware
+ * writes of all of them are collected in a single write list which is pushed
+ * once at the end, and the PVT/TVT of each affected group is evaluated once.
+ * This is intended for bulk changes such as moving a port in or out of
+ * thousands of groups when a LAG member goes down or comes back.
+ * Processing stops at the first operation which fails; the operations before
+ * it remain applied and are pushed to hardware.
+ * @param shdl Session handle.
+ * @param dev The ASIC id.
+ * @param ops Array of @a count membership changes.
+ * @param count Number of entries in @a ops.
+ * @param processed Optional pointer which will be set to the number of
+ *        operations applied successfully.
+ * @return Status of the API call.
+ */
+bf_status_t bf_mc_mbr_batch_update(bf_mc_session_hdl_t shdl,
+                                   bf_dev_id_t dev,
+                                   const bf_mc_mbr_op_t *ops,
+                                   uint32_t count,
+                                   uint32_t *processed);
 
 /**
  * Associate an ECMP group with a multicast group.  Unlike individual nodes
@@ -1246,6 +1269,56 @@ bf_status_t bf_mc_node_garbage_collection_scheduler_mode(
  */
 bf_status_t bf_mc_do_node_garbage_collection(bf_mc_session_hdl_t shdl);
 
+/**
+ * Configure the background compaction of hardware node memory.  When enabled
+ * the compactor periodically relocates L1 nodes and L2 chains out of sparsely
+ * used RDM blocks so that fragmented space can be reused.  Relocation is
+ * hitless, old node memory is reclaimed through garbage collection.
+ * @param shdl Session handle.
+ * @param dev The ASIC id.
+ * @param cfg The compactor configuration.
+ * @return Status of the API call.
+ */
+bf_status_t bf_mc_rdm_defrag_cfg_set(bf_mc_session_hdl_t shdl,
+                                     bf_dev_id_t dev,
+                                     const bf_mc_rdm_defrag_cfg_t *cfg);
+/**
+ * Get the configuration of the background compaction of hardware node memory.
+ * @param shdl Session handle.
+ * @param dev The ASIC id.
+ * @param cfg Pointer to a struct where the configuration will be stored.
+ * @return Status of the API call.
+ */
+bf_status_t bf_mc_rdm_defrag_cfg_get(bf_mc_session_hdl_t shdl,
+                                     bf_dev_id_t dev,
+                                     bf_mc_rdm_defrag_cfg_t *cfg);
+/**
+ * Run one compaction step on hardware node memory, regardless of whether the
+ * background compactor is enabled.
+ * @param shdl Session handle.
+ * @param dev The ASIC id.
+ * @param max_moves Maximum number of L1 nodes or L2 chains to relocate.
+ * @param moves Optional pointer which will be set to the number of
+ *        relocations done.
+ * @return Status of the API call.
+ */
+bf_status_t bf_mc_rdm_defrag_run(bf_mc_session_hdl_t shdl,
+                                 bf_dev_id_t dev,
+                                 uint32_t max_moves,
+                                 uint32_t *moves);
+/**
+ * Get the usage and fragmentation of hardware node memory of a pipe.
+ * @param shdl Session handle.
+ * @param dev The ASIC id.
+ * @param pipe The pipeline id.
+ * @param stats Pointer to a struct where the statistics will be stored.
+ * @return Status of the API call.
+ */
+bf_status_t bf_mc_rdm_frag_stats_get(bf_mc_session_hdl_t shdl,
+                                     bf_dev_id_t dev,
+                                     bf_dev_pipe_t pipe,
+                                     bf_mc_rdm_frag_stats_t *stats);
+
 /* @} */
 
 /* Used by TM API to set copy-to-cpu port */
@@ -161,6 +161,21 @@ typedef uint8_t bf_mc_lag_id_t;
     v = ((*_MC_pm)[_MC_i] >> _MC_j) & 1; \
   } while (0);
 
+/** Kind of change described by a @ref bf_mc_mbr_op_t. */
+typedef enum bf_mc_mbr_op_type_e {
+  BF_MC_MBR_OP_ASSOCIATE, /**< Add the node to the group. */
+  BF_MC_MBR_OP_DISSOCIATE /**< Remove the node from the group. */
+} bf_mc_mbr_op_type_e;
+
+/** One group membership change applied by @ref bf_mc_mbr_batch_update. */
+typedef struct bf_mc_mbr_op_t {
+  bf_mc_mbr_op_type_e op;    /**< Add or remove. */
+  bf_mc_mgrp_hdl_t mgrp_hdl; /**< The multicast group. */
+  bf_mc_node_hdl_t node_hdl; /**< The L1 node. */
+  bool xid_valid;            /**< Associate only, is @a xid used. */
+  bf_mc_l1_xid_t xid;        /**< Associate only, L1 exclusion id. */
+} bf_mc_mbr_op_t;
+
 /* @} */
 
 /**
@@ -237,6 +252,44 @@ typedef struct bf_mc_debug_int_fifo_credit_t {
 
 /* @} */
 
+/**
+ * @addtogroup mc_mgr-schd
+ * @{
+ */
+
+/** Configuration of the background RDM compactor. */
+typedef struct bf_mc_rdm_defrag_cfg_t {
+  bool enable;          /**< Run the compactor periodically. */
+  uint32_t interval_ms; /**< Time between two compaction steps. */
+  uint32_t max_moves;   /**< Maximum number of L1 nodes or L2 chains
+                             relocated by one compaction step. */
+  uint32_t threshold;   /**< Fragmentation, in percent, above which a pipe
+                             is compacted. */
+} bf_mc_rdm_defrag_cfg_t;
+
+/** RDM usage and fragmentation of one pipe.  Arrays are indexed by node
+ *  level, zero for L1 and one for L2 blocks. */
+typedef struct bf_mc_rdm_frag_stats_t {
+  uint32_t free_blocks;       /**< Blocks not assigned to any pipe. */
+  uint32_t used_blocks[2];    /**< Blocks assigned to the pipe. */
+  uint32_t used_entries[2];   /**< Entries allocated in those blocks. */
+  uint32_t free_entries[2];   /**< Unallocated entries in those blocks. */
+  uint32_t reclaimable[2];    /**< Blocks which would be freed if the used
+                                   entries were packed densely. */
+  uint32_t fragmentation[2];  /**< Percentage of the assigned blocks which
+                                   are reclaimable. */
+  uint64_t steps;             /**< Compaction steps run on the device. */
+  uint64_t l1_moves;          /**< L1 nodes relocated on the device. */
+  uint64_t l2_moves;          /**< L2 chains relocated on the device. */
+  uint64_t move_failures;     /**< Relocations abandoned on the device. */
+  uint64_t alloc_reclaim;     /**< Allocations which failed while
+                                   released RDM on the device was still
+                                   being reclaimed. */
+  uint64_t alloc_failures;    /**< Allocations which failed on the device. */
+} bf_mc_rdm_frag_stats_t;
+
+/* @} */
+
 typedef bf_mc_ecmp_hdl_t mc_l1_ecmp_hdl_t;
 typedef bf_mc_node_hdl_t mc_l1_node_hdl_t;
 typedef bf_mc_node_hdl_t mc_l2_node_hdl_t;
@@ -29,7 +29,8 @@
 #include "p4/config/v1/p4info.pb.h"
 #include "p4/v1/p4runtime.pb.h"
 
-// This PIMPL interface is taken from p4lang/PI. Do not modify.
+// This PIMPL interface is taken from p4lang/PI. Do not modify, apart from
+// the P4RT_BFRT_ENABLED additions, which PI's DeviceMgr does not provide.
 
 namespace pi {
 
@@ -70,6 +71,18 @@ class DeviceMgr {
   Status read_one(const p4::v1::Entity &entity,
                   p4::v1::ReadResponse *response) const;
 
+#ifdef P4RT_BFRT_ENABLED
+  // Returns false when the response can no longer be delivered.
+  using ReadChunkCb = std::function<bool(const p4::v1::ReadResponse &)>;
+
+  // Hands the response to cb each time it holds chunk_size entities and
+  // once more at the end, so that a wildcard read is never built as one
+  // message.
+  Status read(const p4::v1::ReadRequest &request,
+              size_t chunk_size,
+              const ReadChunkCb &cb) const;
+#endif
+
   Status stream_message_request_handle(
       const p4::v1::StreamMessageRequest &request);
 
@@ -0,0 +1,82 @@
+/*******************************************************************************
+ *  Copyright (C) 2024 Intel Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing,
+ *  software distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions
+ *  and limitations under the License.
+ *
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+
+/*!
+ * @file perf_ctx_json_intf.h
+ * @date
+ *
+ * Performance Context JSON loading definitions.
+ */
+
+#ifndef _PERF_CTX_JSON_INTF_H
+#define _PERF_CTX_JSON_INTF_H
+
+extern struct test_description ctx_json_load_test;
+
+enum ctx_json_load_int_res { RES_CTX_JSON_SIZE_KB, RES_CTX_JSON_ITERATIONS };
+enum ctx_json_load_double_res {
+  RES_CTX_JSON_PARSE_MS,
+  RES_CTX_JSON_CACHED_MS,
+  RES_CTX_JSON_SPEEDUP
+};
+
+/**
+ * @brief Run performance test that will measure how long it takes to load a
+ * Context JSON file by parsing its text and by rebuilding it from the binary
+ * cache.
+ *
+ * @param dev_id device id
+ * @param path path to the Context JSON file
+ * @param iterations number of loads measured for each method
+ * @return test_results
+ */
+struct test_results ctx_json_load(bf_dev_id_t dev_id,
+                                  const char *path,
+                                  int iterations);
+
+extern struct test_description ctx_json_parse_test;
+
+enum ctx_json_parse_int_res {
+  RES_CTX_JSON_PARSE_SIZE_KB,
+  RES_CTX_JSON_PARSE_CJSON_KB,
+  RES_CTX_JSON_PARSE_READER_KB
+};
+enum ctx_json_parse_double_res {
+  RES_CTX_JSON_PARSE_CJSON_MS,
+  RES_CTX_JSON_PARSE_READER_MS,
+  RES_CTX_JSON_PARSE_CJSON_LOOKUP_MS,
+  RES_CTX_JSON_PARSE_READER_LOOKUP_MS
+};
+
+/**
+ * @brief Run performance test that will compare the parse time, the memory
+ * used and the key lookup time of a JSON file parsed with cJSON and with the
+ * Context JSON reader.
+ *
+ * @param dev_id device id
+ * @param path path to the JSON file
+ * @param iterations number of parses measured for each parser
+ * @return test_results
+ */
+struct test_results ctx_json_parse(bf_dev_id_t dev_id,
+                                   const char *path,
+                                   int iterations);
+
+#endif
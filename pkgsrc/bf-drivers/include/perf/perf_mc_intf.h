@@ -0,0 +1,51 @@
+/*******************************************************************************
+ *  Copyright (C) 2024 Intel Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing,
+ *  software distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions
+ *  and limitations under the License.
+ *
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+
+/*!
+ * @file perf_mc_intf.h
+ * @date
+ *
+ * Performance multicast handling definitions.
+ */
+
+#ifndef _PERF_MC_INTF_H
+#define _PERF_MC_INTF_H
+
+extern struct test_description mc_lag_flap_test;
+
+enum mc_lag_flap_int_res { RES_MC_GROUPS, RES_MC_OPS };
+enum mc_lag_flap_double_res {
+  RES_MC_PER_CALL_MS,
+  RES_MC_BATCH_MS,
+  RES_MC_SPEEDUP
+};
+
+/**
+ * @brief Run performance test that will measure how long it takes for a LAG
+ * member change to converge across many multicast groups, once with one API
+ * call per group and once with a single batch membership update.
+ *
+ * @param dev_id device id
+ * @param groups number of multicast groups
+ * @return test_results
+ */
+struct test_results mc_lag_flap(bf_dev_id_t dev_id, int groups);
+
+#endif
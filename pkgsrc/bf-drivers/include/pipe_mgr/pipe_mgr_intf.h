@@ -310,8 +310,21 @@ typedef struct pipe_tbl_ha_reconc_report {
   uint32_t num_entries_deleted;
   /*!< Number of entries that were modified after delta compute */
   uint32_t num_entries_modified;
+  /*!< Number of entries that were replayed unchanged */
+  uint32_t num_entries_matched;
 } pipe_tbl_ha_reconc_report_t;
 
+/* Outcome of fitting a weighted selector membership in a group */
+typedef struct pipe_sel_grp_weight_report {
+  /*!< Sum of the requested member weights */
+  uint64_t requested_total;
+  /*!< Sum of the programmed member weights, i.e. group slots used */
+  uint32_t achieved_total;
+  /*!< Largest difference between a member's programmed and requested share
+   * of the group, in parts per million */
+  uint32_t max_share_error_ppm;
+} pipe_sel_grp_weight_report_t;
+
 /* Profile of number groups sizes of a certain size in a selection table */
 typedef struct pipe_sel_grp_profile {
   uint16_t grp_size; /* Max members in a grp <2..4K> */
@@ -1959,6 +1972,29 @@ pipe_status_t pipe_mgr_sel_grp_mbrs_set(pipe_sess_hdl_t sess_hdl,
                                         bool *enable,
                                         uint32_t pipe_api_flags);
 
+/*!
+ * API function to set a weighted membership of a group
+ *
+ * Each member takes weights[i] slots of the group. When the weights do not
+ * fit in max_slots, or in the group size when max_slots is zero, they are
+ * reduced keeping every member and the shares as close as possible to the
+ * requested ones. Only the difference with the current membership is written
+ * to hardware. The achieved distribution is returned in report, which may be
+ * NULL.
+ */
+pipe_status_t pipe_mgr_sel_grp_mbrs_set_with_weights(
+    pipe_sess_hdl_t sess_hdl,
+    bf_dev_id_t device_id,
+    pipe_sel_tbl_hdl_t sel_tbl_hdl,
+    pipe_sel_grp_hdl_t sel_grp_hdl,
+    uint32_t num_mbrs,
+    pipe_adt_ent_hdl_t *mbrs,
+    uint32_t *weights,
+    bool *enable,
+    uint32_t max_slots,
+    pipe_sel_grp_weight_report_t *report,
+    uint32_t pipe_api_flags);
+
 /*!
  * API function to get membership of a group
  */
@@ -1993,6 +2029,38 @@ pipe_status_t pipe_mgr_sel_grp_mbr_enable(pipe_sess_hdl_t sess_hdl,
                                           pipe_adt_ent_hdl_t adt_ent_hdl,
                                           uint32_t pipe_api_flags);
 
+/*!
+ * API function to tag a member of the action profile used by a selection
+ * table, for example with the port or nexthop it forwards to.  A member has
+ * at most one tag, setting a new one replaces the previous one.
+ */
+pipe_status_t pipe_mgr_sel_mbr_tag_set(pipe_sess_hdl_t sess_hdl,
+                                       bf_dev_id_t device_id,
+                                       pipe_sel_tbl_hdl_t sel_tbl_hdl,
+                                       pipe_adt_ent_hdl_t adt_ent_hdl,
+                                       uint32_t tag);
+
+/* API function to remove the tag of a member */
+pipe_status_t pipe_mgr_sel_mbr_tag_clear(pipe_sess_hdl_t sess_hdl,
+                                         bf_dev_id_t device_id,
+                                         pipe_sel_tbl_hdl_t sel_tbl_hdl,
+                                         pipe_adt_ent_hdl_t adt_ent_hdl);
+
+/*!
+ * API function to disable, or re-enable, the members with a tag in every
+ * group of a selection table, e.g. on a port down or up event.  All the
+ * updates are pushed to hardware as a single instruction list.
+ *
+ * @param num_updated Number of (group, member) pairs updated, may be NULL.
+ */
+pipe_status_t pipe_mgr_sel_tag_mbrs_state_set(pipe_sess_hdl_t sess_hdl,
+                                              bf_dev_id_t device_id,
+                                              pipe_sel_tbl_hdl_t sel_tbl_hdl,
+                                              uint32_t tag,
+                                              bool enable,
+                                              uint32_t *num_updated,
+                                              uint32_t pipe_api_flags);
+
 /* API function to get the current state of a selection member */
 pipe_status_t pipe_mgr_sel_grp_mbr_state_get(
     pipe_sess_hdl_t sess_hdl,
@@ -2276,6 +2344,43 @@ pipe_status_t pipe_mgr_wred_ent_set(pipe_sess_hdl_t sess_hdl,
                                     pipe_wred_spec_t *wred_spec,
                                     uint32_t pipe_api_flags);
 
+/*************************************
+ * API FOR RANGE UPDATES OF METER, LPF AND WRED TABLES
+ *************************************/
+
+/* APIs to update num_entries consecutive entries of a table, starting at
+ * first_idx, in one call.  The specs array holds either a single spec, which
+ * is applied to the whole range, or num_entries specs, one per index.
+ * Consecutive entries sharing a spec are converted to the hardware format
+ * once, so provisioning many entries with a few distinct profiles is much
+ * cheaper than one ent_set call per index. */
+pipe_status_t pipe_mgr_meter_ent_set_range(pipe_sess_hdl_t sess_hdl,
+                                           dev_target_t dev_tgt,
+                                           pipe_meter_tbl_hdl_t meter_tbl_hdl,
+                                           pipe_meter_idx_t first_idx,
+                                           uint32_t num_entries,
+                                           pipe_meter_spec_t *meter_specs,
+                                           uint32_t num_specs,
+                                           uint32_t pipe_api_flags);
+
+pipe_status_t pipe_mgr_lpf_ent_set_range(pipe_sess_hdl_t sess_hdl,
+                                         dev_target_t dev_tgt,
+                                         pipe_lpf_tbl_hdl_t lpf_tbl_hdl,
+                                         pipe_lpf_idx_t first_idx,
+                                         uint32_t num_entries,
+                                         pipe_lpf_spec_t *lpf_specs,
+                                         uint32_t num_specs,
+                                         uint32_t pipe_api_flags);
+
+pipe_status_t pipe_mgr_wred_ent_set_range(pipe_sess_hdl_t sess_hdl,
+                                          dev_target_t dev_tgt,
+                                          pipe_wred_tbl_hdl_t wred_tbl_hdl,
+                                          pipe_wred_idx_t first_idx,
+                                          uint32_t num_entries,
+                                          pipe_wred_spec_t *wred_specs,
+                                          uint32_t num_specs,
+                                          uint32_t pipe_api_flags);
+
 /* API to set the time that the model sees, purely for testing purposes. */
 pipe_status_t pipe_mgr_model_time_advance(pipe_sess_hdl_t sess_hdl,
                                           bf_dev_id_t device_id,
@@ -2508,6 +2613,65 @@ pipe_status_t pipe_stful_ent_query_range(pipe_sess_hdl_t sess_hdl,
                                          uint32_t *num_indices_read,
                                          uint32_t pipe_api_flags);
 
+/* Change tracking export of an indirect stateful table.  An export keeps a
+ * baseline copy of the table for each pipe it covers.  Each poll syncs the
+ * table from hardware, compares it against the baseline and reports only the
+ * cells which changed since the previous poll, or per pipe totals of all
+ * cells.  Reports are delivered asynchronously once the sync completes and any
+ * number of exports may poll the same table concurrently. */
+typedef struct pipe_stful_export_s pipe_stful_export_t;
+
+typedef enum pipe_stful_export_mode_e {
+  PIPE_STFUL_EXPORT_CHANGES = 0, /* Report changed (index, value) pairs. */
+  PIPE_STFUL_EXPORT_SUMS = 1,    /* Report per pipe totals of all cells. */
+} pipe_stful_export_mode_e;
+
+typedef struct pipe_stful_export_change_t {
+  pipe_stful_mem_idx_t index;
+  pipe_stful_mem_spec_t value;
+} pipe_stful_export_change_t;
+
+typedef struct pipe_stful_export_report_t {
+  bf_dev_pipe_t pipe;
+  /* Number of cells in the pipe which changed since the previous poll.  In
+   * PIPE_STFUL_EXPORT_CHANGES mode they are listed in "changes"; a large set
+   * of changes is split over several reports and only the final report for
+   * the pipe has "last" set. */
+  uint32_t num_changes;
+  const pipe_stful_export_change_t *changes;
+  bool last;
+  /* PIPE_STFUL_EXPORT_SUMS mode only, totals of the low (or only) and high
+   * halves of every cell in the pipe. */
+  uint64_t sum_lo;
+  uint64_t sum_hi;
+} pipe_stful_export_report_t;
+
+typedef void (*pipe_stful_export_cback_fn)(
+    bf_dev_id_t device_id,
+    const pipe_stful_export_report_t *report,
+    void *cookie);
+
+/* Create an export for the pipes selected by dev_tgt, using the same pipe
+ * selection as pipe_stful_database_sync.  The first poll reports every cell
+ * which is non-zero. */
+pipe_status_t pipe_stful_export_create(pipe_sess_hdl_t sess_hdl,
+                                       dev_target_t dev_tgt,
+                                       pipe_stful_tbl_hdl_t stful_tbl_hdl,
+                                       pipe_stful_export_mode_e mode,
+                                       pipe_stful_export_cback_fn cback_fn,
+                                       void *cookie,
+                                       pipe_stful_export_t **export_p);
+
+/* Start one export cycle, returns PIPE_ALREADY_EXISTS if the previous poll of
+ * this export has not completed yet. */
+pipe_status_t pipe_stful_export_poll(pipe_sess_hdl_t sess_hdl,
+                                     pipe_stful_export_t *exp);
+
+/* Release an export, if a poll is outstanding the export is released once it
+ * completes and no further reports are delivered.  May be called from the
+ * export's own report callback. */
+pipe_status_t pipe_stful_export_destroy(pipe_stful_export_t *exp);
+
 pipe_status_t pipe_stful_param_set(pipe_sess_hdl_t sess_hdl,
                                    dev_target_t dev_tgt,
                                    pipe_tbl_hdl_t stful_tbl_hdl,
@@ -178,6 +178,7 @@ typedef struct ${p4_pd_prefix}ha_reconc_report_t {
   uint32_t num_entries_added;
   uint32_t num_entries_deleted;
   uint32_t num_entries_modified;
+  uint32_t num_entries_matched;
 } ${p4_pd_prefix}ha_reconc_report_t;
 //:: #endif
 
@@ -794,6 +795,42 @@ ${name}
  ${param_str}
 );
 
+//::   params = ["p4_pd_sess_hdl_t sess_hdl",
+//::             "bf_dev_id_t dev_id",
+//::             "p4_pd_mbr_hdl_t mbr_hdl",
+//::             "uint32_t tag"]
+//::   param_str = ",\n ".join(params)
+//::   name = p4_pd_prefix + act_prof + "_member_tag_set"
+p4_pd_status_t
+${name}
+(
+ ${param_str}
+);
+
+//::   params = ["p4_pd_sess_hdl_t sess_hdl",
+//::             "bf_dev_id_t dev_id",
+//::             "p4_pd_mbr_hdl_t mbr_hdl"]
+//::   param_str = ",\n ".join(params)
+//::   name = p4_pd_prefix + act_prof + "_member_tag_clear"
+p4_pd_status_t
+${name}
+(
+ ${param_str}
+);
+
+//::   params = ["p4_pd_sess_hdl_t sess_hdl",
+//::             "bf_dev_id_t dev_id",
+//::             "uint32_t tag",
+//::             "enum p4_pd_grp_mbr_state_e mbr_state",
+//::             "uint32_t *num_updated"]
+//::   param_str = ",\n ".join(params)
+//::   name = p4_pd_prefix + act_prof + "_tag_members_state_set"
+p4_pd_status_t
+${name}
+(
+ ${param_str}
+);
+
 //::   params = ["p4_pd_sess_hdl_t sess_hdl",
 //::             "bf_dev_id_t dev_id",
 //::             "p4_pd_grp_hdl_t grp_hdl",
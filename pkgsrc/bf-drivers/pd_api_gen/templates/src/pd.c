@@ -2657,6 +2657,61 @@ ${name}
   return status;
 }
 
+//::   params = ["p4_pd_sess_hdl_t sess_hdl",
+//::             "bf_dev_id_t dev_id",
+//::             "p4_pd_mbr_hdl_t mbr_hdl",
+//::             "uint32_t tag"]
+//::   param_str = ",\n ".join(params)
+//::   name = p4_pd_prefix + act_prof + "_member_tag_set"
+p4_pd_status_t
+${name}
+(
+ ${param_str}
+)
+{
+  return pipe_mgr_sel_mbr_tag_set(sess_hdl, dev_id,
+				  ${select_hdl},
+				  mbr_hdl,
+				  tag);
+}
+
+//::   params = ["p4_pd_sess_hdl_t sess_hdl",
+//::             "bf_dev_id_t dev_id",
+//::             "p4_pd_mbr_hdl_t mbr_hdl"]
+//::   param_str = ",\n ".join(params)
+//::   name = p4_pd_prefix + act_prof + "_member_tag_clear"
+p4_pd_status_t
+${name}
+(
+ ${param_str}
+)
+{
+  return pipe_mgr_sel_mbr_tag_clear(sess_hdl, dev_id,
+				    ${select_hdl},
+				    mbr_hdl);
+}
+
+//::   params = ["p4_pd_sess_hdl_t sess_hdl",
+//::             "bf_dev_id_t dev_id",
+//::             "uint32_t tag",
+//::             "enum p4_pd_grp_mbr_state_e mbr_state",
+//::             "uint32_t *num_updated"]
+//::   param_str = ",\n ".join(params)
+//::   name = p4_pd_prefix + act_prof + "_tag_members_state_set"
+p4_pd_status_t
+${name}
+(
+ ${param_str}
+)
+{
+  return pipe_mgr_sel_tag_mbrs_state_set(sess_hdl, dev_id,
+					 ${select_hdl},
+					 tag,
+					 mbr_state == P4_PD_GRP_MBR_STATE_ACTIVE,
+					 num_updated,
+					 0 /* TODO */);
+}
+
 //::   params = ["p4_pd_sess_hdl_t sess_hdl",
 //::             "bf_dev_id_t dev_id",
 //::             "p4_pd_grp_hdl_t grp_hdl",
@@ -6679,6 +6734,7 @@ static inline void unbuild_ha_reconc_report
   ha_report->num_entries_added = pipe_ha_report->num_entries_added;
   ha_report->num_entries_deleted = pipe_ha_report->num_entries_deleted;
   ha_report->num_entries_modified = pipe_ha_report->num_entries_modified;
+  ha_report->num_entries_matched = pipe_ha_report->num_entries_matched;
 }
 
 //::   for table, t_info in table_info.items():
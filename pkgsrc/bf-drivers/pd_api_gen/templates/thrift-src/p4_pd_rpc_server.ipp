@@ -1913,6 +1913,7 @@ public:
       ha_report.num_entries_added = pd_ha_report.num_entries_added; 
       ha_report.num_entries_deleted = pd_ha_report.num_entries_deleted;
       ha_report.num_entries_modified = pd_ha_report.num_entries_modified; 
+      ha_report.num_entries_matched = pd_ha_report.num_entries_matched;
     }
 //::   #endfor 
 //:: #endif
@@ -2878,6 +2879,57 @@ public:
         return (${api_prefix}grp_mbr_state::type)mbr_state;
     }
 
+//::   params = ["const SessionHandle_t sess_hdl",
+//::             "const int8_t dev_id",
+//::             "const MemberHandle_t mbr",
+//::             "const int32_t tag"]
+//::   param_str = ", ".join(params)
+//::   name = act_prof + "_member_tag_set"
+//::   pd_name = pd_prefix + name
+    void ${name}(${param_str}) {
+        int status = ${pd_name}(sess_hdl, dev_id, mbr, tag);
+        if(status != 0) {
+          InvalidTableOperation iop;
+          iop.code = status;
+          throw iop;
+        }
+    }
+
+//::   params = ["const SessionHandle_t sess_hdl",
+//::             "const int8_t dev_id",
+//::             "const MemberHandle_t mbr"]
+//::   param_str = ", ".join(params)
+//::   name = act_prof + "_member_tag_clear"
+//::   pd_name = pd_prefix + name
+    void ${name}(${param_str}) {
+        int status = ${pd_name}(sess_hdl, dev_id, mbr);
+        if(status != 0) {
+          InvalidTableOperation iop;
+          iop.code = status;
+          throw iop;
+        }
+    }
+
+//::   params = ["const SessionHandle_t sess_hdl",
+//::             "const int8_t dev_id",
+//::             "const int32_t tag",
+//::             "const " + api_prefix + "grp_mbr_state::type mbr_state"]
+//::   param_str = ", ".join(params)
+//::   name = act_prof + "_tag_members_state_set"
+//::   pd_name = pd_prefix + name
+    int32_t ${name}(${param_str}) {
+        enum p4_pd_grp_mbr_state_e pd_mbr_state;
+        uint32_t num_updated = 0;
+        pd_mbr_state = (enum p4_pd_grp_mbr_state_e) mbr_state;
+        int status = ${pd_name}(sess_hdl, dev_id, tag, pd_mbr_state, &num_updated);
+        if(status != 0) {
+          InvalidTableOperation iop;
+          iop.code = status;
+          throw iop;
+        }
+        return num_updated;
+    }
+
 //::   params = ["const SessionHandle_t sess_hdl",
 //::             "const int8_t dev_id",
 //::             "const GroupHandle_t grp",
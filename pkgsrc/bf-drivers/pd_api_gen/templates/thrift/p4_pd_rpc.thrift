@@ -623,6 +623,7 @@ struct ${api_prefix}ha_reconc_report_t {
   1: required i32 num_entries_added;
   2: required i32 num_entries_deleted;
   3: required i32 num_entries_modified;
+  4: required i32 num_entries_matched;
 }
 //:: #endif
 
@@ -1401,6 +1402,32 @@ service ${p4_prefix} {
 //::   name = act_prof + "_group_member_state_get"
     ${api_prefix}grp_mbr_state ${name}(${param_str}) throws (1:InvalidTableOperation ouch),
 
+//::   params = ["res.SessionHandle_t sess_hdl",
+//::             "byte dev_id",
+//::             "MemberHandle_t mbr",
+//::             "i32 tag"]
+//::   param_list = [str(count + 1) + ":" + p for count, p in enumerate(params)]
+//::   param_str = ", ".join(param_list)
+//::   name = act_prof + "_member_tag_set"
+    void ${name}(${param_str}) throws (1:InvalidTableOperation ouch),
+
+//::   params = ["res.SessionHandle_t sess_hdl",
+//::             "byte dev_id",
+//::             "MemberHandle_t mbr"]
+//::   param_list = [str(count + 1) + ":" + p for count, p in enumerate(params)]
+//::   param_str = ", ".join(param_list)
+//::   name = act_prof + "_member_tag_clear"
+    void ${name}(${param_str}) throws (1:InvalidTableOperation ouch),
+
+//::   params = ["res.SessionHandle_t sess_hdl",
+//::             "byte dev_id",
+//::             "i32 tag",
+//::             api_prefix + "grp_mbr_state mbr_state"]
+//::   param_list = [str(count + 1) + ":" + p for count, p in enumerate(params)]
+//::   param_str = ", ".join(param_list)
+//::   name = act_prof + "_tag_members_state_set"
+    i32 ${name}(${param_str}) throws (1:InvalidTableOperation ouch),
+
 //::   params = ["res.SessionHandle_t sess_hdl",
 //::             "byte dev_id",
 //::             "GroupHandle_t grp",
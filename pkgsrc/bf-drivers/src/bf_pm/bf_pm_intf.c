@@ -10186,6 +10186,13 @@ bf_status_t bf_pm_tasklet_scheduler() {
   return BF_SUCCESS;
 }
 
+bf_status_t bf_pm_tasklet_workers_set(uint32_t num_workers) {
+  if (num_workers > PM_TASKLET_MAX_WORKERS) return BF_INVALID_ARG;
+  if (pm_tasklet_workers_set(num_workers)) return BF_NO_SYS_RESOURCES;
+
+  return BF_SUCCESS;
+}
+
 bf_status_t bf_pm_interrupt_based_link_monitoring_set(bf_dev_id_t dev_id,
                                                       bool en) {
   PM_TRACE("%d:%d(en)", dev_id, en);
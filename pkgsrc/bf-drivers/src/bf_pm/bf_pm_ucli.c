@@ -53,6 +53,7 @@
 #include "bf_pm.h"
 #include "pm_log.h"
 #include "bf_pm_tof3_ucli.h"
+#include "pm_task.h"
 
 bf_status_t port_mgr_tof2_map_dev_port_to_all(bf_dev_id_t dev_id,
                                               bf_dev_port_t dev_port,
@@ -4474,6 +4475,73 @@ static ucli_status_t bf_pm_ucli_ucli__fsm_step__(ucli_context_t *uc) {
   return 0;
 }
 
+static ucli_status_t bf_pm_ucli_ucli__fsm_workers__(ucli_context_t *uc) {
+  UCLI_COMMAND_INFO(uc, "fsm-workers", 1, "<count>");
+  uint32_t count;
+
+  count = strtoul(uc->pargs->args[0], NULL, 10);
+  if (count > PM_TASKLET_MAX_WORKERS) {
+    aim_printf(
+        &uc->pvs, "At most %d FSM workers supported\n", PM_TASKLET_MAX_WORKERS);
+    return 0;
+  }
+  if (pm_tasklet_workers_set(count)) {
+    aim_printf(&uc->pvs, "Failed to set FSM workers to %u\n", count);
+  }
+  aim_printf(&uc->pvs, "FSM workers: %u\n", pm_tasklet_workers_get());
+  return 0;
+}
+
+static ucli_status_t bf_pm_ucli_ucli__fsm_sched_stats__(ucli_context_t *uc) {
+  UCLI_COMMAND_INFO(uc, "fsm-sched-stats", 0, "");
+  pm_tasklet_stats_t st;
+  int pri;
+
+  aim_printf(&uc->pvs, "FSM workers: %u\n", pm_tasklet_workers_get());
+  aim_printf(&uc->pvs,
+             "%-4s %10s %6s %12s %12s %12s %12s %10s\n",
+             "Pri",
+             "Runs",
+             "Queued",
+             "AvgLate(us)",
+             "MaxLate(us)",
+             "AvgRun(us)",
+             "MaxRun(us)",
+             "Serialized");
+  for (pri = HI_PRI; pri >= LO_PRI; pri--) {
+    pm_tasklet_stats_get(pri, &st);
+    aim_printf(&uc->pvs,
+               "%-4s %10" PRIu64 " %6u %12" PRIu64 " %12" PRIu64 " %12" PRIu64
+               " %12" PRIu64 " %10" PRIu64 "\n",
+               pri == HI_PRI ? "Hi" : "Lo",
+               st.runs,
+               st.queued,
+               st.runs ? st.lateness_total_us / st.runs : 0,
+               st.lateness_max_us,
+               st.runs ? st.run_time_total_us / st.runs : 0,
+               st.run_time_max_us,
+               st.serialized);
+  }
+  return 0;
+}
+
+static ucli_status_t bf_pm_ucli_ucli__fsm_sched_stats_clear__(
+    ucli_context_t *uc) {
+  UCLI_COMMAND_INFO(uc, "fsm-sched-stats-clear", 0, "");
+
+  pm_tasklet_stats_clear();
+  return 0;
+}
+
+static ucli_status_t bf_pm_ucli_ucli__fsm_sched_test__(ucli_context_t *uc) {
+  UCLI_COMMAND_INFO(uc, "fsm-sched-test", 0, "");
+
+  aim_printf(&uc->pvs,
+             "FSM scheduler test %s\n",
+             tasklet_unit_test() ? "FAILED" : "passed");
+  return 0;
+}
+
 static void pm_ucli_update_stats_all_ports(bf_dev_id_t dev_id) {
   bf_status_t sts;
   bf_pal_front_port_handle_t iter_port_hdl, next_iter_port_hdl;
@@ -14373,6 +14441,10 @@ static ucli_command_handler_f bf_pm_ucli_ucli_handlers__[] = {
     bf_pm_ucli_ucli__fsm_stop__,
     bf_pm_ucli_ucli__fsm_go__,
     bf_pm_ucli_ucli__fsm_step__,
+    bf_pm_ucli_ucli__fsm_workers__,
+    bf_pm_ucli_ucli__fsm_sched_stats__,
+    bf_pm_ucli_ucli__fsm_sched_stats_clear__,
+    bf_pm_ucli_ucli__fsm_sched_test__,
     bf_pm_ucli_ucli__port_fsm__,
     bf_pm_ucli_ucli__sku__,
     bf_pm_ucli_ucli__recirc__ports_show,
@@ -23,27 +23,60 @@
 #include <stdbool.h>
 #include <time.h>
 #include <string.h>
+#include <unistd.h>
 #include <target-sys/bf_sal/bf_sys_intf.h>
 #include "pm_task.h"
 #include "pm_log.h"
 
+#define PM_TASKLET_MAX 1024
+
 bf_sys_cmp_and_swp_t run_q_lock[MAX_PRI];
 typedef struct tcb_t {
-  struct tcb_t *next;
+  struct tcb_t *next; /* free_q and dispatch queue link */
   void *context;
   tasklet_fn fn;
   tasklet_pri_t priority;
   tasklet_state_t state;
   struct timespec next_run_time;
+  uint64_t seq;  /* Keeps tasklets due at the same time in FIFO order */
+  int heap_idx;  /* Position in run_q, -1 while running or free */
 } tcb_t;
 
+/* Each priority's run queue is a binary min-heap ordered by next_run_time so
+ * rescheduling a tasklet is O(log n) rather than a walk of a sorted list. */
+typedef struct pm_run_q_t {
+  tcb_t *heap[PM_TASKLET_MAX];
+  int count;
+} pm_run_q_t;
+
 // fwd ref
 static void requeue_2_run_q(tcb_t *tcb);
 
-tcb_t empty_tcb[1024] = {{0}};
+tcb_t empty_tcb[PM_TASKLET_MAX] = {{0}};
 
 tcb_t *free_q = NULL;
-tcb_t *run_q[MAX_PRI] = {NULL, NULL};
+static pm_run_q_t run_q[MAX_PRI];
+static uint64_t run_q_seq = 0;
+
+/* Tasklets handed to the scheduler thread or a worker and not yet returned.
+ * A context is never in here twice, which serializes each port's FSM.  Up to
+ * PM_TASKLET_QUEUE_DEPTH tasklets per worker may be waiting for a worker. */
+#define PM_TASKLET_QUEUE_DEPTH 4
+static tcb_t *inflight[PM_TASKLET_MAX_WORKERS * PM_TASKLET_QUEUE_DEPTH];
+static int num_inflight = 0;
+
+static pm_tasklet_stats_t sched_stats[MAX_PRI];
+
+/* Worker pool.  With no workers the scheduler thread runs the tasklets
+ * itself, one at a time. */
+static bf_sys_mutex_t worker_mtx;
+static bf_sys_cond_t worker_cond;
+static bool worker_pool_init = false;
+static uint32_t num_workers = 0;
+static bf_sys_thread_t workers[PM_TASKLET_MAX_WORKERS];
+static uint32_t num_worker_threads = 0;
+static tcb_t *dispatch_q_head = NULL;
+static tcb_t *dispatch_q_tail = NULL;
 
 static void pm_task_runq_lock_init() {
   int i;
@@ -57,8 +90,11 @@ static void pm_task_runq_init() {
   int i;
 
   for (i = 0; i < MAX_PRI; i++) {
-    run_q[i] = NULL;
+    run_q[i].count = 0;
   }
+  run_q_seq = 0;
+  num_inflight = 0;
+  memset(sched_stats, 0, sizeof(sched_stats));
 }
 
 static void pm_task_runq_lock_acquire(int prio) {
@@ -89,6 +125,7 @@ static void tasklet_init_free_q(void) {
   bf_sys_assert((free_q == NULL));
 
   for (t = 0; t < sizeof(empty_tcb) / sizeof(empty_tcb[0]); t++) {
+    empty_tcb[t].heap_idx = -1;
     empty_tcb[t].next = free_q;
     free_q = &empty_tcb[t];
   }
@@ -96,6 +133,7 @@ static void tasklet_init_free_q(void) {
 
 static void enqueue_2_free_q(tcb_t *tcb) {
   tcb->state = STATE_DEFAULT;
+  tcb->heap_idx = -1;
   tcb->next = free_q;
   free_q = tcb;
 }
@@ -123,6 +161,16 @@ void pm_tasklet_new(tasklet_fn fn, void *context, tasklet_pri_t priority) {
   requeue_2_run_q(tcb);
   pm_task_runq_lock_release(priority);
 }
+
+static int inflight_find(void *context) {
+  int i;
+
+  for (i = 0; i < num_inflight; i++) {
+    if ((uintptr_t)context == (uintptr_t)(inflight[i]->context)) return i;
+  }
+  return -1;
+}
+
 /* This function is always used from the context of handler execution.
    Before invoking the handler, this function can be used to ensure the tcb
    under processed is valid and it is not marked for deletion. Return value of
@@ -130,73 +178,106 @@ void pm_tasklet_new(tasklet_fn fn, void *context, tasklet_pri_t priority) {
    Return value of true means tcb is valid i.e. proceed with the fsm handler
    execution */
 bool pm_is_current_tasklet_valid(void *context) {
-  tcb_t *tcb = NULL;
-  int priority;
-  // Iterate over all the head of runqueue and verify if the current tcb is
-  // marked as remove by other thread
-  for (priority = HI_PRI; priority >= LO_PRI; priority--) {
-    pm_task_runq_lock_acquire(priority);
-    if (run_q[priority] != NULL) {
-      /* tcb for which handler is currently running is always remains on top of
-         linked list as we mark the tv_sec and tv_nsec to 0 before invoking
-         handler in function pm_tasklet_run */
-      tcb = run_q[priority];
-      if ((uintptr_t)context == (uintptr_t)(tcb->context)) {
-        /* We have to verify head of all link list
-           so we are not adding else statement here */
-        if (tcb->state == STATE_REMOVE) {
-          pm_task_runq_lock_release(priority);
-          return false;
-        }
-      }
-    }
-    pm_task_runq_lock_release(priority);
+  bool valid = true;
+  int i;
+
+  pm_task_runq_lock_acquire(HI_PRI);
+  /* Only one tasklet per context can be running, so the in-flight entry for
+     the context is the tcb whose handler is calling us */
+  i = inflight_find(context);
+  if (i >= 0 && inflight[i]->state == STATE_REMOVE) valid = false;
+  pm_task_runq_lock_release(HI_PRI);
+  return valid;
+}
+
+static int t1_less_than_or_eq_t2(struct timespec *t1, struct timespec *t2) {
+  if (t1->tv_sec < t2->tv_sec) return 1;
+  if ((t1->tv_sec == t2->tv_sec) && (t1->tv_nsec <= t2->tv_nsec)) return 1;
+  return 0;
+}
+
+static bool tcb_before(tcb_t *a, tcb_t *b) {
+  if (a->next_run_time.tv_sec != b->next_run_time.tv_sec)
+    return a->next_run_time.tv_sec < b->next_run_time.tv_sec;
+  if (a->next_run_time.tv_nsec != b->next_run_time.tv_nsec)
+    return a->next_run_time.tv_nsec < b->next_run_time.tv_nsec;
+  return a->seq < b->seq;
+}
+
+static void run_q_set(pm_run_q_t *q, int i, tcb_t *tcb) {
+  q->heap[i] = tcb;
+  tcb->heap_idx = i;
+}
+
+static void run_q_sift_up(pm_run_q_t *q, int i) {
+  tcb_t *tcb = q->heap[i];
+
+  while (i > 0) {
+    int parent = (i - 1) / 2;
+    if (!tcb_before(tcb, q->heap[parent])) break;
+    run_q_set(q, i, q->heap[parent]);
+    i = parent;
   }
-  return true;
+  run_q_set(q, i, tcb);
 }
 
-void pm_tasklet_rmv(void *context) {
-  tcb_t *tcb, *tcb_next, *tcb_prev = NULL;
-  int priority;
+static void run_q_sift_down(pm_run_q_t *q, int i) {
+  tcb_t *tcb = q->heap[i];
+
+  for (;;) {
+    int child = 2 * i + 1;
+    if (child >= q->count) break;
+    if (child + 1 < q->count && tcb_before(q->heap[child + 1], q->heap[child]))
+      child++;
+    if (!tcb_before(q->heap[child], tcb)) break;
+    run_q_set(q, i, q->heap[child]);
+    i = child;
+  }
+  run_q_set(q, i, tcb);
+}
+
+static void run_q_remove(tcb_t *tcb) {
+  pm_run_q_t *q = &run_q[tcb->priority];
+  int i = tcb->heap_idx;
+  tcb_t *moved;
+
+  tcb->heap_idx = -1;
+  q->count--;
+  if (i == q->count) return;
+  /* Fill the hole with the last element and restore the heap around it. */
+  moved = q->heap[q->count];
+  run_q_set(q, i, moved);
+  run_q_sift_down(q, i);
+  run_q_sift_up(q, moved->heap_idx);
+}
 
-  // Iterate over all the tasklets in the runqueue and remove the tasklet
-  // corresponding to the context passed in
+void pm_tasklet_rmv(void *context) {
+  int priority, i;
+
+  // Remove the tasklet corresponding to the context passed in.  A tasklet
+  // which is running is only marked, it is freed once its handler returns.
+  pm_task_runq_lock_acquire(HI_PRI);
+  i = inflight_find(context);
+  if (i >= 0) {
+    if (inflight[i]->state == STATE_REMOVE) {
+      PM_TRACE("%s:%d TCB is already in remove state !!!!", __func__, __LINE__);
+    }
+    inflight[i]->state = STATE_REMOVE;
+    pm_task_runq_lock_release(HI_PRI);
+    return;
+  }
   for (priority = HI_PRI; priority >= LO_PRI; priority--) {
-    pm_task_runq_lock_acquire(priority);
-    if (run_q[priority] != NULL) {
-      tcb = run_q[priority];
-      tcb_prev = NULL;
-      while (tcb) {
-        tcb_next = tcb->next;
-        if ((uintptr_t)context == (uintptr_t)(tcb->context)) {
-          // delink from the run_q
-          if ((tcb->state == STATE_RUNNING) || (tcb->state == STATE_REMOVE)) {
-            if (tcb->state == STATE_REMOVE) {
-              PM_TRACE("%s:%d TCB is already in remove state !!!!",
-                       __func__,
-                       __LINE__);
-            }
-            tcb->state = STATE_REMOVE;
-            pm_task_runq_lock_release(priority);
-            return;
-          }
-          if (run_q[priority] == tcb) {
-            // First tcb in the run queue is getting dequeued
-            run_q[priority] = tcb_next;
-          } else {
-            if (tcb_prev) tcb_prev->next = tcb_next;
-          }
-          enqueue_2_free_q(tcb);
-          pm_task_runq_lock_release(priority);
-          return;
-        } else {
-          tcb_prev = tcb;
-        }
-        tcb = tcb_next;
+    for (i = 0; i < run_q[priority].count; i++) {
+      tcb_t *tcb = run_q[priority].heap[i];
+      if ((uintptr_t)context == (uintptr_t)(tcb->context)) {
+        run_q_remove(tcb);
+        enqueue_2_free_q(tcb);
+        pm_task_runq_lock_release(HI_PRI);
+        return;
       }
     }
-    pm_task_runq_lock_release(priority);
   }
+  pm_task_runq_lock_release(HI_PRI);
   return;
 }
 
@@ -208,12 +289,6 @@ uint32_t tasklet_run(tcb_t *tcb) {
   return delay_time_us;
 }
 
-static int t1_less_than_or_eq_t2(struct timespec *t1, struct timespec *t2) {
-  if (t1->tv_sec < t2->tv_sec) return 1;
-  if ((t1->tv_sec == t2->tv_sec) && (t1->tv_nsec <= t2->tv_nsec)) return 1;
-  return 0;
-}
-
 static int tasklet_ready(tcb_t *tcb, struct timespec *ts) {
   if (t1_less_than_or_eq_t2(&tcb->next_run_time, ts)) {
     return 1;
@@ -221,108 +296,228 @@ static int tasklet_ready(tcb_t *tcb, struct timespec *ts) {
   return 0;
 }
 
+static uint64_t ts_diff_us(struct timespec *later, struct timespec *earlier) {
+  int64_t us = (int64_t)(later->tv_sec - earlier->tv_sec) * 1000000 +
+               (later->tv_nsec - earlier->tv_nsec) / 1000;
+  return us > 0 ? (uint64_t)us : 0;
+}
+
 static void requeue_2_run_q(tcb_t *tcb) {
-  tcb_t *prev = NULL, *cur;
+  pm_run_q_t *q = &run_q[tcb->priority];
 
-  cur = run_q[tcb->priority];
-  if (cur == NULL) {
-    run_q[tcb->priority] = tcb;
-    tcb->next = NULL;
-    return;
+  bf_sys_assert(q->count < PM_TASKLET_MAX);
+  tcb->seq = run_q_seq++;
+  tcb->next = NULL;
+  run_q_set(q, q->count, tcb);
+  q->count++;
+  run_q_sift_up(q, tcb->heap_idx);
+}
+
+/* Run one dispatched tasklet and put it back on its run queue, or free it if
+ * it is done or was removed while running.  Called without the run_q lock,
+ * from the scheduler thread or a worker. */
+static void tasklet_exec(tcb_t *tcb) {
+  struct timespec start, end;
+  uint32_t delay_time_us;
+  pm_tasklet_stats_t *st = &sched_stats[tcb->priority];
+  int i;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  delay_time_us = tasklet_run(tcb);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  pm_task_runq_lock_acquire(tcb->priority);
+  uint64_t run_us = ts_diff_us(&end, &start);
+  st->run_time_total_us += run_us;
+  if (run_us > st->run_time_max_us) st->run_time_max_us = run_us;
+
+  i = inflight_find(tcb->context);
+  bf_sys_assert(i >= 0);
+  inflight[i] = inflight[--num_inflight];
+
+  if (tcb->state == STATE_REMOVE || delay_time_us == TASK_DONE) {
+    /* Put removed tcbs straight on the free_q rather than waiting for the
+       remove thread, otherwise the tcb could get scheduled once again before
+       the remove thread gets a chance to remove it */
+    enqueue_2_free_q(tcb);
+  } else {
+    tcb->state = STATE_DEFAULT;
+    tcb->next_run_time.tv_sec = end.tv_sec + delay_time_us / 1000000;
+    tcb->next_run_time.tv_nsec =
+        end.tv_nsec + ((delay_time_us * 1000ull) % 1000000000);
+    if (tcb->next_run_time.tv_nsec >= 1000000000) {
+      tcb->next_run_time.tv_sec++;
+      tcb->next_run_time.tv_nsec -= 1000000000;
+    }
+    requeue_2_run_q(tcb);
   }
-  while (cur &&
-         t1_less_than_or_eq_t2(&cur->next_run_time, &tcb->next_run_time)) {
-    prev = cur;
-    cur = cur->next;
+  pm_task_runq_lock_release(tcb->priority);
+}
+
+static void *tasklet_worker(void *arg) {
+  uint32_t id = (uint32_t)(uintptr_t)arg;
+  tcb_t *tcb;
+
+  for (;;) {
+    bf_sys_mutex_lock(&worker_mtx);
+    while (!dispatch_q_head && id < num_workers) {
+      bf_sys_cond_wait(&worker_cond, &worker_mtx);
+    }
+    /* Drain the dispatch queue before honouring a smaller pool size. */
+    if (!dispatch_q_head) {
+      bf_sys_mutex_unlock(&worker_mtx);
+      break;
+    }
+    tcb = dispatch_q_head;
+    dispatch_q_head = tcb->next;
+    if (!dispatch_q_head) dispatch_q_tail = NULL;
+    bf_sys_mutex_unlock(&worker_mtx);
+
+    tasklet_exec(tcb);
+  }
+  return NULL;
+}
+
+/* Hand a tasklet to the worker pool.  Returns false if there are no workers,
+ * in which case the caller runs it. */
+static bool tasklet_dispatch(tcb_t *tcb) {
+  if (!worker_pool_init) return false;
+  bf_sys_mutex_lock(&worker_mtx);
+  if (!num_workers) {
+    bf_sys_mutex_unlock(&worker_mtx);
+    return false;
   }
-  if (prev == NULL) {  // insert before first elt on run_q
-    tcb->next = cur;
-    run_q[tcb->priority] = tcb;
+  tcb->next = NULL;
+  if (dispatch_q_tail) {
+    dispatch_q_tail->next = tcb;
   } else {
-    tcb->next = prev->next;
-    prev->next = tcb;
+    dispatch_q_head = tcb;
   }
+  dispatch_q_tail = tcb;
+  bf_sys_cond_wake(&worker_cond);
+  bf_sys_mutex_unlock(&worker_mtx);
+  return true;
 }
 
 void tasklet_scheduler(void) {
   tcb_t *tcb;
-  int ran_something = 0;
+  tcb_t *held = NULL;
   int priority;
+  int max_inflight;
   struct timespec now;
-  struct timespec now2;
-  uint32_t delay_time_us = 0;
+
+  /* With a worker pool a few tasklets per worker may be in flight, otherwise
+   * tasklets run one at a time on this thread. */
+  max_inflight = worker_pool_init && num_workers
+                     ? (int)num_workers * PM_TASKLET_QUEUE_DEPTH
+                     : 1;
 
   clock_gettime(CLOCK_MONOTONIC, &now);
   /* run any hi-pri tasks first */
   for (priority = HI_PRI; priority >= LO_PRI; priority--) {
-    if (run_q[priority] != NULL) {
-      pm_task_runq_lock_acquire(priority);
-      tcb = run_q[priority];
-      while (pm_tasklet_free_run_get() && tcb && (tasklet_ready(tcb, &now))) {
-        if (!ran_something) {
-          ran_something = 1;
-        }
-        /* Do not remove fromm run_q, pm_tasklet_rmv may try to remove
-           the TCN while running tasklet_run below */
-        /* Set state of tcb to STATE_RUNNING to indicate other thread
-           that current tcb is under process */
-        // run_q[priority] = tcb->next;
-        tcb->state = STATE_RUNNING;
-        /* Update the time to zero, so that it remains at the top while
-         * tasklet_run is running */
-        /* Even when another thread tries to add a new tcb to run_q, current tcb
-         * will be at the head of list */
-        tcb->next_run_time.tv_sec = 0;
-        tcb->next_run_time.tv_nsec = 0;
-
-        pm_task_runq_lock_release(priority);
-
-        delay_time_us = tasklet_run(tcb);
-
-        pm_task_runq_lock_acquire(priority);
-
-        if (tcb->state == STATE_REMOVE) {
-          /* Remove the entry from run_q and put it into free_q
-             We have to remove the tcb here instead of waiting for the remove
-             thread. It may lead to a scenario where the tcb will get scheduled
-             once again before remove thread gets a chance to remove it */
-          tcb->state = STATE_DEFAULT;
-          run_q[priority] = tcb->next;
-          enqueue_2_free_q(tcb);
-        } else {
-          tcb->state = STATE_DEFAULT;
-          if (delay_time_us == TASK_DONE) {
-            tcb->next_run_time.tv_sec = 0;
-            tcb->next_run_time.tv_nsec = 0;
-          } else {
-            // gettimeofday(&now, NULL);
-            clock_gettime(CLOCK_MONOTONIC, &now2);
-            tcb->next_run_time.tv_sec = now2.tv_sec + delay_time_us / 1000000;
-            tcb->next_run_time.tv_nsec =
-                now2.tv_nsec + ((delay_time_us * 1000) % 1000000000);
-            if (tcb->next_run_time.tv_nsec >= 1000000000) {
-              tcb->next_run_time.tv_sec++;
-              tcb->next_run_time.tv_nsec -= 1000000000;
-            }
-          }
-          /* This will be put to freeq as the tcb is added for
-           * delete in pm_tasklet_rmv*/
-          /* if not done, return to run_q */
-          /* First remove the head of the list (i.e. current tcb)
-             Then requeue/free current tcb */
-          run_q[priority] = tcb->next;
-          if ((tcb->next_run_time.tv_sec != 0) ||
-              (tcb->next_run_time.tv_nsec != 0)) {
-            requeue_2_run_q(tcb);
-          } else {  // if done, release to free_q
-            enqueue_2_free_q(tcb);
-          }
-        }
-        tcb = run_q[priority];
+    pm_task_runq_lock_acquire(priority);
+    while (pm_tasklet_free_run_get() && run_q[priority].count &&
+           num_inflight < max_inflight) {
+      tcb = run_q[priority].heap[0];
+      if (!tasklet_ready(tcb, &now)) break;
+      run_q_remove(tcb);
+      if (inflight_find(tcb->context) >= 0) {
+        /* The port's FSM is still running elsewhere, hold this one back and
+           put it back on the run_q once the ready ones have been handed out */
+        sched_stats[priority].serialized++;
+        tcb->next = held;
+        held = tcb;
+        continue;
       }
+      uint64_t late_us = ts_diff_us(&now, &tcb->next_run_time);
+      sched_stats[priority].runs++;
+      sched_stats[priority].lateness_total_us += late_us;
+      if (late_us > sched_stats[priority].lateness_max_us)
+        sched_stats[priority].lateness_max_us = late_us;
+      /* Set state of tcb to STATE_RUNNING to indicate other threads that the
+         tcb is under process; pm_tasklet_rmv only marks it from now on */
+      tcb->state = STATE_RUNNING;
+      inflight[num_inflight++] = tcb;
+
       pm_task_runq_lock_release(priority);
+      if (!tasklet_dispatch(tcb)) tasklet_exec(tcb);
+      pm_task_runq_lock_acquire(priority);
+    }
+    while (held) {
+      tcb = held;
+      held = tcb->next;
+      requeue_2_run_q(tcb);
+    }
+    pm_task_runq_lock_release(priority);
+  }
+}
+
+/* pm_tasklet_workers_set
+ *
+ * Run port FSM tasklets on a pool of worker threads.  Tasklets for different
+ * contexts (ports) then execute in parallel while each context still runs
+ * one tasklet at a time.  Zero, the default, runs every tasklet on the thread
+ * calling pm_tasklet_scheduler.
+ */
+int pm_tasklet_workers_set(uint32_t count) {
+  uint32_t i;
+
+  if (count > PM_TASKLET_MAX_WORKERS) return -1;
+  if (!worker_pool_init) {
+    if (bf_sys_mutex_init(&worker_mtx)) return -1;
+    if (bf_sys_cond_init(&worker_cond)) {
+      bf_sys_mutex_del(&worker_mtx);
+      return -1;
     }
+    worker_pool_init = true;
   }
+
+  bf_sys_mutex_lock(&worker_mtx);
+  num_workers = count;
+  bf_sys_cond_broadcast(&worker_cond);
+  bf_sys_mutex_unlock(&worker_mtx);
+
+  /* Shrinking, wait for the surplus workers to drain the queue and exit. */
+  while (num_worker_threads > count) {
+    bf_sys_thread_join(workers[--num_worker_threads], NULL);
+  }
+  for (i = num_worker_threads; i < count; i++) {
+    if (bf_sys_thread_create(
+            &workers[i], tasklet_worker, (void *)(uintptr_t)i, 0)) {
+      PM_ERROR("%s:%d Failed to start FSM worker %u, continuing with %u",
+               __func__,
+               __LINE__,
+               i,
+               num_worker_threads);
+      bf_sys_mutex_lock(&worker_mtx);
+      num_workers = num_worker_threads;
+      bf_sys_cond_broadcast(&worker_cond);
+      bf_sys_mutex_unlock(&worker_mtx);
+      return -1;
+    }
+    bf_sys_thread_set_name(workers[i], "bf_pm_fsm");
+    num_worker_threads++;
+  }
+  PM_TRACE("%s:%d FSM tasklets running on %u worker(s)",
+           __func__,
+           __LINE__,
+           num_worker_threads);
+  return 0;
+}
+
+uint32_t pm_tasklet_workers_get(void) { return num_worker_threads; }
+
+void pm_tasklet_stats_get(tasklet_pri_t priority, pm_tasklet_stats_t *stats) {
+  pm_task_runq_lock_acquire(priority);
+  *stats = sched_stats[priority];
+  stats->queued = run_q[priority].count;
+  pm_task_runq_lock_release(priority);
+}
+
+void pm_tasklet_stats_clear(void) {
+  pm_task_runq_lock_acquire(HI_PRI);
+  memset(sched_stats, 0, sizeof(sched_stats));
+  pm_task_runq_lock_release(HI_PRI);
 }
 
 // FSM debug facility
@@ -360,30 +555,112 @@ void pm_tasklet_scheduler(void) {
   fsm_single_step = false;
 }
 
+/* Simulated tasklets for tasklet_unit_test.  Pairs of tasklets share a
+ * context the way a stale and a fresh tcb of one port can, the scheduler must
+ * never run both at once. */
 typedef struct tasklet_test_ctx_t {
   int loops;
   int delay;
   char id;
+  int runs;
+  bf_sys_cmp_and_swp_t active;
+  bool overlap;
 } tasklet_test_ctx_t;
 
-tasklet_test_ctx_t tctx[26] = {{0}};
+#define TASKLET_TEST_CTX 26
+#define TASKLET_TEST_SHARED 8
+
+tasklet_test_ctx_t tctx[TASKLET_TEST_CTX] = {{0}};
 
 uint32_t tasklet_test(void *context) {
   tasklet_test_ctx_t *ctx = (tasklet_test_ctx_t *)context;
+  uint32_t ret;
 
-  if (--ctx->loops == 0) {
+  if (bf_sys_compare_and_swap(&ctx->active, 0, 1) == 0) {
+    ctx->overlap = true;
     return TASK_DONE;
   }
-  return ctx->delay;
+  /* Stand in for a slow serdes or AN poll. */
+  if (ctx->id == 'a') usleep(2000);
+  ret = ++ctx->runs >= ctx->loops ? TASK_DONE : (uint32_t)ctx->delay;
+  bf_sys_compare_and_swap(&ctx->active, 1, 0);
+  return ret;
 }
 
-void tasklet_unit_test(void) {
-  int i;
+/* True while a tasklet for the context is queued or running. */
+static bool tasklet_context_scheduled(void *context) {
+  bool found = false;
+  int priority, i;
 
-  for (i = 0; i < 26; i++) {
+  pm_task_runq_lock_acquire(HI_PRI);
+  found = inflight_find(context) >= 0;
+  for (priority = HI_PRI; !found && priority >= LO_PRI; priority--) {
+    for (i = 0; !found && i < run_q[priority].count; i++) {
+      found = run_q[priority].heap[i]->context == context;
+    }
+  }
+  pm_task_runq_lock_release(HI_PRI);
+  return found;
+}
+
+/* tasklet_unit_test
+ *
+ * Queue simulated tasklets on the live scheduler, drive it until they have
+ * all finished and check each ran to completion without its context ever
+ * running twice at once.  Returns 0 on success.
+ */
+int tasklet_unit_test(void) {
+  struct timespec start, now;
+  pm_tasklet_stats_t before, after;
+  int i, done, fail;
+
+  pm_tasklet_stats_get(HI_PRI, &before);
+  for (i = 0; i < TASKLET_TEST_CTX; i++) {
     tctx[i].loops = 2 * (i + 1);
     tctx[i].delay = 100 * (i + 1);
     tctx[i].id = 'a' + i;
+    tctx[i].runs = 0;
+    tctx[i].active = 0;
+    tctx[i].overlap = false;
+  }
+  for (i = 0; i < TASKLET_TEST_CTX; i++) {
     pm_tasklet_new(tasklet_test, &tctx[i], HI_PRI);
+    if (i < TASKLET_TEST_SHARED) {
+      pm_tasklet_new(tasklet_test, &tctx[i], HI_PRI);
+    }
   }
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  do {
+    pm_tasklet_scheduler();
+    usleep(100);
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    for (done = 0, i = 0; i < TASKLET_TEST_CTX; i++) {
+      if (!tasklet_context_scheduled(&tctx[i])) done++;
+    }
+  } while (done < TASKLET_TEST_CTX && ts_diff_us(&now, &start) < 10000000);
+
+  for (fail = 0, i = 0; i < TASKLET_TEST_CTX; i++) {
+    if (tctx[i].overlap || tctx[i].runs < tctx[i].loops) {
+      PM_ERROR("%s:%d Tasklet %c ran %d of %d times%s",
+               __func__,
+               __LINE__,
+               tctx[i].id,
+               tctx[i].runs,
+               tctx[i].loops,
+               tctx[i].overlap ? ", overlapping itself" : "");
+      /* Leave nothing behind on the run_q. */
+      pm_tasklet_rmv(&tctx[i]);
+      if (i < TASKLET_TEST_SHARED) pm_tasklet_rmv(&tctx[i]);
+      fail = 1;
+    }
+  }
+  if (fail) return -1;
+  pm_tasklet_stats_get(HI_PRI, &after);
+  PM_TRACE("%s:%d Passed, %llu runs, max lateness %llu us",
+           __func__,
+           __LINE__,
+           (unsigned long long)(after.runs - before.runs),
+           (unsigned long long)after.lateness_max_us);
+  return 0;
 }
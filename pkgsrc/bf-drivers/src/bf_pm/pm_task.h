@@ -29,6 +29,24 @@ typedef enum { LO_PRI = 0, HI_PRI, MAX_PRI } tasklet_pri_t;
 
 typedef enum { STATE_RUNNING = 0, STATE_REMOVE, STATE_DEFAULT } tasklet_state_t;
 
+/* Upper bound on the worker pool size, see pm_tasklet_workers_set. */
+#define PM_TASKLET_MAX_WORKERS 16
+
+/* Scheduler statistics, kept per priority. */
+typedef struct pm_tasklet_stats_t {
+  uint64_t runs;
+  /* Time from a tasklet becoming due until it was dispatched. */
+  uint64_t lateness_total_us;
+  uint64_t lateness_max_us;
+  /* Time spent in the tasklet functions. */
+  uint64_t run_time_total_us;
+  uint64_t run_time_max_us;
+  /* Due tasklets held back because their context was already running. */
+  uint64_t serialized;
+  /* Tasklets currently waiting on the run queue. */
+  uint32_t queued;
+} pm_tasklet_stats_t;
+
 void pm_fsm_queues_init();
 void pm_tasklet_scheduler(void);
 void pm_tasklet_new(tasklet_fn fn, void *context, tasklet_pri_t priority);
@@ -40,4 +58,10 @@ void pm_tasklet_free_run_set(bool st);
 bool pm_tasklet_free_run_get(void);
 void pm_tasklet_single_step_set(void);
 
+int pm_tasklet_workers_set(uint32_t count);
+uint32_t pm_tasklet_workers_get(void);
+void pm_tasklet_stats_get(tasklet_pri_t priority, pm_tasklet_stats_t *stats);
+void pm_tasklet_stats_clear(void);
+int tasklet_unit_test(void);
+
 #endif /* __PM_TASK_H__ */
@@ -34,6 +34,7 @@ extern "C" {
 #ifdef __cplusplus
 }
 #endif
+#include <ctx_json/ctx_json_reader.h>
 #include "bf_rt_cjson.hpp"
 
 #include <target-sys/bf_sal/bf_sys_mem.h>
@@ -41,15 +42,17 @@ extern "C" {
 namespace bfrt {
 
 CjsonObjHandler::CjsonObjHandler(const std::string &fileContent) {
-  this->root = cJSON_Parse(fileContent.c_str());
-  if (!this->root) {
-    std::string error(cJSON_GetErrorPtr());
-  }
+  this->root = ctx_json_reader_parse(fileContent.data(), fileContent.size());
 }
-CjsonObjHandler::~CjsonObjHandler() { cJSON_Delete(this->root); }
+CjsonObjHandler::~CjsonObjHandler() { ctx_json_reader_free(this->root); }
 
 Cjson::Cjson(const Cjson &parent, const std::string &key) {
-  root = cJSON_GetObjectItem(parent.root, key.c_str());
+  root = ctx_json_object_get(parent.root, key.c_str());
+  this->cjson_mem_tracker = parent.cjson_mem_tracker;
+}
+
+Cjson::Cjson(const Cjson &parent, cJSON *node) {
+  root = node;
   this->cjson_mem_tracker = parent.cjson_mem_tracker;
 }
 
@@ -94,11 +97,9 @@ std::string Cjson::getCjsonKey() const {
 std::vector<std::shared_ptr<Cjson>> Cjson::getCjsonChildVec() const {
   std::vector<std::shared_ptr<Cjson>> ret_vec;
   if (root) {
-    int count = cJSON_GetArraySize(root);
-    if (count != 0) {
-      for (int i = 0; i < count; i++) {
-        ret_vec.push_back(std::make_shared<Cjson>(*this, i));
-      }
+    // Walk the children once instead of looking each one up by index
+    for (cJSON *child = root->child; child; child = child->next) {
+      ret_vec.push_back(std::shared_ptr<Cjson>(new Cjson(*this, child)));
     }
   }
   return ret_vec;
@@ -106,11 +107,8 @@ std::vector<std::shared_ptr<Cjson>> Cjson::getCjsonChildVec() const {
 std::vector<std::string> Cjson::getCjsonChildStringVec() const {
   std::vector<std::string> ret_vec;
   if (root) {
-    int count = cJSON_GetArraySize(root);
-    if (count != 0) {
-      for (int i = 0; i < count; i++) {
-        ret_vec.push_back(std::string(Cjson(*this, i)));
-      }
+    for (cJSON *child = root->child; child; child = child->next) {
+      ret_vec.push_back(std::string(Cjson(*this, child)));
     }
   }
   return ret_vec;
@@ -205,9 +203,17 @@ Cjson &Cjson::operator+=(const Cjson &other) {
 }
 
 void Cjson::updateChildNode(const std::string &key, const std::string &val) {
-  // remove key from this object(ex "name")
-  cJSON_DeleteItemFromObject(this->root, key.c_str());
-  // Now add a string object to this object with same key ("name")
+  cJSON *item = ctx_json_object_get(this->root, key.c_str());
+  if (item) {
+    // Nodes of a parsed file cannot be deleted one by one, replace the value
+    // of the existing item (ex "name") in place
+    if (ctx_json_reader_set_string(item, val.c_str()) != 0 &&
+        item->type == cJSON_String) {
+      // Added after parsing, owned by cJSON
+      cJSON_SetValuestring(item, val.c_str());
+    }
+    return;
+  }
   cJSON_AddStringToObject(this->root, key.c_str(), val.c_str());
 }
 
@@ -80,6 +80,7 @@ class Cjson {
  private:
   static void createCjsonFromFileInternal(const std::string &fileContent,
                                           Cjson &obj);
+  Cjson(const Cjson &parent, cJSON *node);
   cJSON *root = nullptr;
   std::shared_ptr<CjsonObjHandler> cjson_mem_tracker = nullptr;
 };
@@ -128,6 +128,8 @@ DataFieldType getDataFieldTypeFrmName(std::string data_name,
     return DataFieldType::SELECTOR_GROUP_ID;
   } else if (data_name == "ACTION_MEMBER_STATUS") {
     return DataFieldType::ACTION_MEMBER_STATUS;
+  } else if (data_name == "ACTION_MEMBER_WEIGHT") {
+    return DataFieldType::ACTION_MEMBER_WEIGHT;
   } else if (data_name == "MAX_GROUP_SIZE") {
     return DataFieldType::MAX_GROUP_SIZE;
   } else if (data_name == "ADT_OFFSET") {
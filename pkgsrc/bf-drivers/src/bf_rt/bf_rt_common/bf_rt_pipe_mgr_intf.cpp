@@ -518,6 +518,31 @@ pipe_status_t PipeMgrIntf::pipeMgrSelGrpMbrsSet(pipe_sess_hdl_t sess_hdl,
                                    pipe_api_flags);
 }
 
+pipe_status_t PipeMgrIntf::pipeMgrSelGrpMbrsSetWeighted(
+    pipe_sess_hdl_t sess_hdl,
+    bf_dev_id_t device_id,
+    pipe_sel_tbl_hdl_t sel_tbl_hdl,
+    pipe_sel_grp_hdl_t sel_grp_hdl,
+    uint32_t num_mbrs,
+    pipe_adt_ent_hdl_t *mbrs,
+    uint32_t *weights,
+    bool *enable,
+    uint32_t max_slots,
+    pipe_sel_grp_weight_report_t *report,
+    uint32_t pipe_api_flags) {
+  return pipe_mgr_sel_grp_mbrs_set_with_weights(sess_hdl,
+                                                device_id,
+                                                sel_tbl_hdl,
+                                                sel_grp_hdl,
+                                                num_mbrs,
+                                                mbrs,
+                                                weights,
+                                                enable,
+                                                max_slots,
+                                                report,
+                                                pipe_api_flags);
+}
+
 pipe_status_t PipeMgrIntf::pipeMgrSelGrpMbrsGet(pipe_sess_hdl_t sess_hdl,
                                                 bf_dev_id_t device_id,
                                                 pipe_sel_tbl_hdl_t sel_tbl_hdl,
@@ -823,6 +848,25 @@ pipe_status_t PipeMgrIntf::pipeMgrMeterEntSet(
       sess_hdl, dev_tgt, meter_tbl_hdl, meter_idx, meter_spec, pipe_api_flags);
 }
 
+pipe_status_t PipeMgrIntf::pipeMgrMeterEntSetRange(
+    pipe_sess_hdl_t sess_hdl,
+    dev_target_t dev_tgt,
+    pipe_meter_tbl_hdl_t meter_tbl_hdl,
+    pipe_meter_idx_t first_idx,
+    uint32_t num_entries,
+    pipe_meter_spec_t *meter_specs,
+    uint32_t num_specs,
+    uint32_t pipe_api_flags) {
+  return pipe_mgr_meter_ent_set_range(sess_hdl,
+                                      dev_tgt,
+                                      meter_tbl_hdl,
+                                      first_idx,
+                                      num_entries,
+                                      meter_specs,
+                                      num_specs,
+                                      pipe_api_flags);
+}
+
 pipe_status_t PipeMgrIntf::pipeMgrMeterByteCountSet(
     pipe_sess_hdl_t sess_hdl,
     dev_target_t dev_tgt,
@@ -899,6 +943,24 @@ pipe_status_t PipeMgrIntf::pipeMgrLpfEntSet(pipe_sess_hdl_t sess_hdl,
       sess_hdl, dev_tgt, meter_tbl_hdl, lpf_idx, lpf_spec, pipe_api_flags);
 }
 
+pipe_status_t PipeMgrIntf::pipeMgrLpfEntSetRange(pipe_sess_hdl_t sess_hdl,
+                                                 dev_target_t dev_tgt,
+                                                 pipe_lpf_tbl_hdl_t lpf_tbl_hdl,
+                                                 pipe_lpf_idx_t first_idx,
+                                                 uint32_t num_entries,
+                                                 pipe_lpf_spec_t *lpf_specs,
+                                                 uint32_t num_specs,
+                                                 uint32_t pipe_api_flags) {
+  return pipe_mgr_lpf_ent_set_range(sess_hdl,
+                                    dev_tgt,
+                                    lpf_tbl_hdl,
+                                    first_idx,
+                                    num_entries,
+                                    lpf_specs,
+                                    num_specs,
+                                    pipe_api_flags);
+}
+
 pipe_status_t PipeMgrIntf::pipeMgrLpfReadEntryIdx(
     pipe_sess_hdl_t sess_hdl,
     dev_target_t dev_tgt,
@@ -928,6 +990,25 @@ pipe_status_t PipeMgrIntf::pipeMgrWredEntSet(pipe_sess_hdl_t sess_hdl,
       sess_hdl, dev_tgt, meter_tbl_hdl, red_idx, wred_spec, pipe_api_flags);
 }
 
+pipe_status_t PipeMgrIntf::pipeMgrWredEntSetRange(
+    pipe_sess_hdl_t sess_hdl,
+    dev_target_t dev_tgt,
+    pipe_wred_tbl_hdl_t wred_tbl_hdl,
+    pipe_wred_idx_t first_idx,
+    uint32_t num_entries,
+    pipe_wred_spec_t *wred_specs,
+    uint32_t num_specs,
+    uint32_t pipe_api_flags) {
+  return pipe_mgr_wred_ent_set_range(sess_hdl,
+                                     dev_tgt,
+                                     wred_tbl_hdl,
+                                     first_idx,
+                                     num_entries,
+                                     wred_specs,
+                                     num_specs,
+                                     pipe_api_flags);
+}
+
 pipe_status_t PipeMgrIntf::pipeMgrWredReadEntry(pipe_sess_hdl_t sess_hdl,
                                                 dev_target_t dev_tgt,
                                                 pipe_mat_tbl_hdl_t mat_tbl_hdl,
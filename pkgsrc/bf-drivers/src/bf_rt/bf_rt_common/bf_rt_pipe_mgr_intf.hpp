@@ -325,6 +325,19 @@ class IPipeMgrIntf {
                                              bool *enable,
                                              uint32_t pipe_api_flags) = 0;
 
+  virtual pipe_status_t pipeMgrSelGrpMbrsSetWeighted(
+      pipe_sess_hdl_t sess_hdl,
+      bf_dev_id_t device_id,
+      pipe_sel_tbl_hdl_t sel_tbl_hdl,
+      pipe_sel_grp_hdl_t sel_grp_hdl,
+      uint32_t num_mbrs,
+      pipe_adt_ent_hdl_t *mbrs,
+      uint32_t *weights,
+      bool *enable,
+      uint32_t max_slots,
+      pipe_sel_grp_weight_report_t *report,
+      uint32_t pipe_api_flags) = 0;
+
   virtual pipe_status_t pipeMgrSelGrpMbrsGet(pipe_sess_hdl_t sess_hdl,
                                              bf_dev_id_t device_id,
                                              pipe_sel_tbl_hdl_t sel_tbl_hdl,
@@ -532,6 +545,16 @@ class IPipeMgrIntf {
                                            pipe_meter_spec_t *meter_spec,
                                            uint32_t pipe_api_flags) = 0;
 
+  virtual pipe_status_t pipeMgrMeterEntSetRange(
+      pipe_sess_hdl_t sess_hdl,
+      dev_target_t dev_tgt,
+      pipe_meter_tbl_hdl_t meter_tbl_hdl,
+      pipe_meter_idx_t first_idx,
+      uint32_t num_entries,
+      pipe_meter_spec_t *meter_specs,
+      uint32_t num_specs,
+      uint32_t pipe_api_flags) = 0;
+
   virtual pipe_status_t pipeMgrModelTimeAdvance(pipe_sess_hdl_t sess_hdl,
                                                 bf_dev_id_t device_id,
                                                 uint64_t tick_time) = 0;
@@ -581,6 +604,16 @@ class IPipeMgrIntf {
                                          pipe_lpf_spec_t *lpf_spec,
                                          uint32_t pipe_api_flags) = 0;
 
+  virtual pipe_status_t pipeMgrLpfEntSetRange(
+      pipe_sess_hdl_t sess_hdl,
+      dev_target_t dev_tgt,
+      pipe_lpf_tbl_hdl_t lpf_tbl_hdl,
+      pipe_lpf_idx_t first_idx,
+      uint32_t num_entries,
+      pipe_lpf_spec_t *lpf_specs,
+      uint32_t num_specs,
+      uint32_t pipe_api_flags) = 0;
+
   virtual pipe_status_t pipeMgrLpfReadEntryIdx(pipe_sess_hdl_t sess_hdl,
                                                dev_target_t dev_tgt,
                                                pipe_lpf_tbl_hdl_t lpf_tbl_hdl,
@@ -612,6 +645,16 @@ class IPipeMgrIntf {
                                           pipe_wred_spec_t *wred_spec,
                                           uint32_t pipe_api_flags) = 0;
 
+  virtual pipe_status_t pipeMgrWredEntSetRange(
+      pipe_sess_hdl_t sess_hdl,
+      dev_target_t dev_tgt,
+      pipe_wred_tbl_hdl_t wred_tbl_hdl,
+      pipe_wred_idx_t first_idx,
+      uint32_t num_entries,
+      pipe_wred_spec_t *wred_specs,
+      uint32_t num_specs,
+      uint32_t pipe_api_flags) = 0;
+
   virtual pipe_status_t pipeMgrWredReadEntryIdx(
       pipe_sess_hdl_t sess_hdl,
       dev_target_t dev_tgt,
@@ -1848,6 +1891,19 @@ class PipeMgrIntf : public IPipeMgrIntf {
                                      bool *enable,
                                      uint32_t pipe_api_flags);
 
+  pipe_status_t pipeMgrSelGrpMbrsSetWeighted(
+      pipe_sess_hdl_t sess_hdl,
+      bf_dev_id_t device_id,
+      pipe_sel_tbl_hdl_t sel_tbl_hdl,
+      pipe_sel_grp_hdl_t sel_grp_hdl,
+      uint32_t num_mbrs,
+      pipe_adt_ent_hdl_t *mbrs,
+      uint32_t *weights,
+      bool *enable,
+      uint32_t max_slots,
+      pipe_sel_grp_weight_report_t *report,
+      uint32_t pipe_api_flags);
+
   pipe_status_t pipeMgrSelGrpMbrsGet(pipe_sess_hdl_t sess_hdl,
                                      bf_dev_id_t device_id,
                                      pipe_sel_tbl_hdl_t sel_tbl_hdl,
@@ -2042,6 +2098,15 @@ class PipeMgrIntf : public IPipeMgrIntf {
                                    pipe_meter_spec_t *meter_spec,
                                    uint32_t pipe_api_flags);
 
+  pipe_status_t pipeMgrMeterEntSetRange(pipe_sess_hdl_t sess_hdl,
+                                        dev_target_t dev_tgt,
+                                        pipe_meter_tbl_hdl_t meter_tbl_hdl,
+                                        pipe_meter_idx_t first_idx,
+                                        uint32_t num_entries,
+                                        pipe_meter_spec_t *meter_specs,
+                                        uint32_t num_specs,
+                                        uint32_t pipe_api_flags);
+
   pipe_status_t pipeMgrModelTimeAdvance(pipe_sess_hdl_t sess_hdl,
                                         bf_dev_id_t device_id,
                                         uint64_t tick_time);
@@ -2087,6 +2152,15 @@ class PipeMgrIntf : public IPipeMgrIntf {
                                  pipe_lpf_spec_t *lpf_spec,
                                  uint32_t pipe_api_flags);
 
+  pipe_status_t pipeMgrLpfEntSetRange(pipe_sess_hdl_t sess_hdl,
+                                      dev_target_t dev_tgt,
+                                      pipe_lpf_tbl_hdl_t lpf_tbl_hdl,
+                                      pipe_lpf_idx_t first_idx,
+                                      uint32_t num_entries,
+                                      pipe_lpf_spec_t *lpf_specs,
+                                      uint32_t num_specs,
+                                      uint32_t pipe_api_flags);
+
   pipe_status_t pipeMgrLpfReadEntryIdx(pipe_sess_hdl_t sess_hdl,
                                        dev_target_t dev_tgt,
                                        pipe_lpf_tbl_hdl_t lpf_tbl_hdl,
@@ -2119,6 +2193,15 @@ class PipeMgrIntf : public IPipeMgrIntf {
                                   pipe_wred_spec_t *wred_spec,
                                   uint32_t pipe_api_flags);
 
+  pipe_status_t pipeMgrWredEntSetRange(pipe_sess_hdl_t sess_hdl,
+                                       dev_target_t dev_tgt,
+                                       pipe_wred_tbl_hdl_t wred_tbl_hdl,
+                                       pipe_wred_idx_t first_idx,
+                                       uint32_t num_entries,
+                                       pipe_wred_spec_t *wred_specs,
+                                       uint32_t num_specs,
+                                       uint32_t pipe_api_flags);
+
   pipe_status_t pipeMgrWredReadEntryIdx(pipe_sess_hdl_t sess_hdl,
                                         dev_target_t dev_tgt,
                                         pipe_wred_tbl_hdl_t wred_tbl_hdl,
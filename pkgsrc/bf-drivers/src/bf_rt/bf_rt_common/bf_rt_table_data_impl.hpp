@@ -64,6 +64,7 @@ enum DataFieldType {
   SELECTOR_GROUP_ID,
   SELECTOR_MEMBERS,
   ACTION_MEMBER_STATUS,
+  ACTION_MEMBER_WEIGHT,
   MAX_GROUP_SIZE,
   ADT_OFFSET,
   TTL,
@@ -381,7 +382,7 @@ class BfRtTableDataObj : public BfRtTableData {
   void addToActiveFields(const bf_rt_id_t &field_id) {
     this->active_fields_.insert(field_id);
   }
-  void removeActiveFields(const std::set<bf_rt_id_t> fields) {
+  void removeActiveFields(const std::set<bf_rt_id_t> &fields) {
     for (const auto &field_id : fields) {
       this->active_fields_.erase(field_id);
     }
@@ -536,6 +536,26 @@ bf_status_t BfRtTableObj::tableEntryModInc(
   return BF_NOT_SUPPORTED;
 }
 
+bf_status_t BfRtTableObj::tableEntryModMulti(
+    const BfRtSession &session,
+    const bf_rt_target_t &dev_tgt,
+    const uint64_t &flags,
+    const constKeyDataPairs &key_data_pairs) const {
+  for (const auto &key_data : key_data_pairs) {
+    if (key_data.first == nullptr || key_data.second == nullptr) {
+      LOG_ERROR("%s:%d %s ERROR : Null key or data passed",
+                __func__,
+                __LINE__,
+                table_name_get().c_str());
+      return BF_INVALID_ARG;
+    }
+    auto status = this->tableEntryMod(
+        session, dev_tgt, flags, *key_data.first, *key_data.second);
+    if (status != BF_SUCCESS) return status;
+  }
+  return BF_SUCCESS;
+}
+
 bf_status_t BfRtTableObj::tableEntryAddOrMod(const BfRtSession & /*session*/,
                                              const bf_rt_target_t & /*dev_tgt*/,
                                              const uint64_t & /*flags*/,
@@ -1938,6 +1958,39 @@ bf_status_t BfRtTableObj::getDataField(
   return BF_OBJECT_NOT_FOUND;
 }
 
+bf_status_t BfRtTableObj::dataFieldReadInfoGet(
+    const bf_rt_id_t &action_id,
+    const std::vector<DataFieldReadInfo> **info) const {
+  std::lock_guard<std::mutex> lock(read_info_lock);
+  auto it = read_info_map.find(action_id);
+  if (it != read_info_map.end()) {
+    *info = &it->second;
+    return BF_SUCCESS;
+  }
+  std::vector<bf_rt_id_t> id_vec;
+  auto status = this->dataFieldIdListGet(action_id, &id_vec);
+  if (status != BF_SUCCESS) {
+    return status;
+  }
+  std::vector<DataFieldReadInfo> fields;
+  fields.reserve(id_vec.size());
+  for (const auto &field_id : id_vec) {
+    const BfRtTableDataField *field = nullptr;
+    status = this->getDataField(field_id, action_id, &field);
+    if (status != BF_SUCCESS) {
+      return status;
+    }
+    fields.push_back(
+        {field_id,
+         field,
+         BfRtTableDataField::getDataFieldDestination(field->getTypes())});
+  }
+  auto &entry = read_info_map[action_id];
+  entry = std::move(fields);
+  *info = &entry;
+  return BF_SUCCESS;
+}
+
 const BfRtTableDataField *BfRtTableObj::getDataFieldHelper(
     const bf_rt_id_t &field_id,
     const std::vector<bf_rt_id_t> &container_id_vec,
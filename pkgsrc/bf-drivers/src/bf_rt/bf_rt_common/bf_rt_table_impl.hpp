@@ -220,6 +220,12 @@ class BfRtTableObj : public BfRtTable {
       const BfRtTableKey &key,
       const BfRtTableData &data) const override;
 
+  virtual bf_status_t tableEntryModMulti(
+      const BfRtSession &session,
+      const bf_rt_target_t &dev_tgt,
+      const uint64_t &flags,
+      const constKeyDataPairs &key_data_pairs) const override;
+
   virtual bf_status_t tableEntryAddOrMod(const BfRtSession &session,
                                          const bf_rt_target_t &dev_tgt,
                                          const uint64_t &flags,
@@ -637,6 +643,21 @@ class BfRtTableObj : public BfRtTable {
                            const bf_rt_id_t &action_id,
                            const BfRtTableDataField **field) const;
 
+  // What an entry read needs to know about a data field: the field itself
+  // and where its value is fetched from.
+  struct DataFieldReadInfo {
+    bf_rt_id_t id;
+    const BfRtTableDataField *field;
+    fieldDestination destination;
+  };
+  // dataFieldReadInfoGet() returns the data fields of an action, common
+  // fields included, sorted by field ID. The list is built on first use and
+  // lives as long as the table, so that reading many entries does not look
+  // up the same fields again for every entry.
+  bf_status_t dataFieldReadInfoGet(
+      const bf_rt_id_t &action_id,
+      const std::vector<DataFieldReadInfo> **info) const;
+
   // getDataField() takes in a vector
   // container field IDs instead of a single container field.
   // This is because since this function is on a table, we need to
@@ -822,6 +843,9 @@ class BfRtTableObj : public BfRtTable {
   std::map<bf_rt_id_t, std::unique_ptr<BfRtTableDataField>> common_data_fields;
   // Map of common data-fields like TTL/Counter etc with names
   std::map<std::string, BfRtTableDataField *> common_data_fields_names;
+  // Map of action ID -> data field read info, see dataFieldReadInfoGet()
+  mutable std::map<bf_rt_id_t, std::vector<DataFieldReadInfo>> read_info_map;
+  mutable std::mutex read_info_lock;
 
   std::set<TableOperationsType> operations_type_set;
   std::set<TableAttributesType> attributes_type_set;
@@ -2697,7 +2697,11 @@ bf_status_t BfRtSelectorTableData::setValue(
     return BF_NOT_SUPPORTED;
   }
 
-  members_ = arr;
+  if (tableDataField->getTypes().count(DataFieldType::ACTION_MEMBER_WEIGHT)) {
+    weights_ = arr;
+  } else {
+    members_ = arr;
+  }
   return BF_SUCCESS;
 }
 
@@ -2795,9 +2799,14 @@ bf_status_t BfRtSelectorTableData::getValue(
         tableDataField->isIntArr()) {
       *arr = members_;
       status = BF_SUCCESS;
+    } else if (fieldType == DataFieldType::ACTION_MEMBER_WEIGHT &&
+               tableDataField->isIntArr()) {
+      *arr = weights_;
+      status = BF_SUCCESS;
     } else {
       LOG_ERROR(
-          "%s:%d %s Field type other than SELECTOR_MEMBERS"
+          "%s:%d %s Field type other than SELECTOR_MEMBERS or "
+          "ACTION_MEMBER_WEIGHT"
           " Not supported. Field type received %d",
           __func__,
           __LINE__,
@@ -2848,6 +2857,7 @@ bf_status_t BfRtSelectorTableData::reset() {
   act_fn_hdl_ = 0;
   members_.clear();
   member_status_.clear();
+  weights_.clear();
   max_grp_size_ = 0;
   return BF_SUCCESS;
 }
@@ -860,11 +860,13 @@ class BfRtSelectorTableData : public BfRtTableDataObj {
 
   const std::vector<uint32_t> &getMembers() const { return members_; }
   const std::vector<bool> &getMemberStatus() const { return member_status_; }
+  const std::vector<uint32_t> &getMemberWeights() const { return weights_; }
 
   void setMembers(std::vector<uint32_t> &members) { members_ = members; }
   void setMemberStatus(std::vector<bool> &member_status) {
     member_status_ = member_status;
   }
+  void setMemberWeights(std::vector<uint32_t> &weights) { weights_ = weights; }
   void setMaxGrpSize(const uint32_t &max_size) { max_grp_size_ = max_size; }
   void setAdtOffset(const uint32_t &adt_offset) { adt_offset_ = adt_offset; }
 
@@ -884,6 +886,8 @@ class BfRtSelectorTableData : public BfRtTableDataObj {
   pipe_act_fn_hdl_t act_fn_hdl_;
   std::vector<uint32_t> members_;
   std::vector<bool> member_status_;
+  // Empty unless $ACTION_MEMBER_WEIGHT was set, one weight per member
+  std::vector<uint32_t> weights_;
   uint32_t max_grp_size_{0};
   uint32_t adt_offset_{0xdeadbeef};
 };
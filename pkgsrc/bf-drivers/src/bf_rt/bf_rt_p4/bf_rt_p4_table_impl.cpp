@@ -18,6 +18,7 @@
  ******************************************************************************/
 
 
+#include <algorithm>
 #include <unordered_set>
 
 #include <bf_rt_common/bf_rt_init_impl.hpp>
@@ -77,6 +78,101 @@ bf_status_t getActionSpec(const BfRtSession &session,
   return status;
 }
 
+// Find the read info of a field in the list of an action, which is sorted by
+// field ID. Returns nullptr if the action has no such field.
+const BfRtTableObj::DataFieldReadInfo *findDataFieldReadInfo(
+    const std::vector<BfRtTableObj::DataFieldReadInfo> &read_info,
+    const bf_rt_id_t &field_id) {
+  auto it = std::lower_bound(
+      read_info.begin(),
+      read_info.end(),
+      field_id,
+      [](const BfRtTableObj::DataFieldReadInfo &info, const bf_rt_id_t &id) {
+        return info.id < id;
+      });
+  if (it == read_info.end() || it->id != field_id) {
+    return nullptr;
+  }
+  return &(*it);
+}
+
+// Whether setActiveFields() with an empty vector would leave the data object
+// unchanged, i.e. all fields of the action are already active.
+bool activeFieldsAreAll(
+    const BfRtTableObj &table,
+    const BfRtTableDataObj &data,
+    const bf_rt_id_t &action_id,
+    const std::vector<BfRtTableObj::DataFieldReadInfo> &read_info) {
+  // With no action ID the active fields are reset to an empty set.
+  if (action_id == 0 && table.actionIdApplicable()) {
+    return false;
+  }
+  const auto &active_fields = data.getActiveFields();
+  if (!data.allFieldsSet() || active_fields.size() != read_info.size()) {
+    return false;
+  }
+  auto it = active_fields.begin();
+  for (const auto &field_info : read_info) {
+    if (*it++ != field_info.id) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Pipe Mgr resources to fetch in order to read the given fields of an action.
+uint32_t resGetFlagsForFields(
+    const std::vector<BfRtTableObj::DataFieldReadInfo> &read_info,
+    const std::set<bf_rt_id_t> &fields) {
+  uint32_t res_get_flags = 0;
+  for (const auto &dataFieldId : fields) {
+    auto field_info = findDataFieldReadInfo(read_info, dataFieldId);
+    BF_RT_ASSERT(field_info != nullptr);
+    switch (field_info->destination) {
+      case fieldDestination::DIRECT_LPF:
+      case fieldDestination::DIRECT_METER:
+      case fieldDestination::DIRECT_WRED:
+        res_get_flags |= PIPE_RES_GET_FLAG_METER;
+        break;
+      case fieldDestination::DIRECT_REGISTER:
+        res_get_flags |= PIPE_RES_GET_FLAG_STFUL;
+        break;
+      case fieldDestination::ACTION_SPEC:
+        res_get_flags |= PIPE_RES_GET_FLAG_ENTRY;
+        break;
+      case fieldDestination::DIRECT_COUNTER:
+        res_get_flags |= PIPE_RES_GET_FLAG_CNTR;
+        break;
+      case fieldDestination::ENTRY_HIT_STATE:
+      case fieldDestination::TTL:
+        res_get_flags |= PIPE_RES_GET_FLAG_IDLE;
+        break;
+      default:
+        break;
+    }
+  }
+  return res_get_flags;
+}
+
+// Arrays passed to Pipe Mgr by get_next_n_entries(). They are kept per
+// thread and only ever grow, so that iterating over a table in batches does
+// not allocate them again for every batch.
+struct GetNextNContext {
+  std::vector<pipe_action_spec_t *> pipe_action_specs;
+  std::vector<pipe_tbl_match_spec_t> pipe_match_specs;
+  std::vector<uint32_t> res_get_flags;
+  std::vector<pipe_act_fn_hdl_t> act_fn_hdls;
+  std::vector<pipe_res_get_data_t> res_data;
+
+  void reset(const uint32_t &n) {
+    pipe_action_specs.assign(n, nullptr);
+    pipe_match_specs.assign(n, {0});
+    res_get_flags.assign(n, 0);
+    act_fn_hdls.assign(n, 0);
+    res_data.assign(n, {0});
+  }
+};
+
 static bf_status_t populate_data_fields(const BfRtTableObj &table,
                                         const BfRtSession &session,
                                         const bf_rt_target_t &dev_tgt,
@@ -92,7 +188,6 @@ static bf_status_t populate_data_fields(const BfRtTableObj &table,
 
   BfRtMatchActionTableData *match_data =
       static_cast<BfRtMatchActionTableData *>(data);
-  std::vector<bf_rt_id_t> dataFields;
 
   bool all_fields_set = match_data->allFieldsSet();
   bf_rt_id_t req_action_id = 0;
@@ -121,38 +216,50 @@ static bf_status_t populate_data_fields(const BfRtTableObj &table,
 
   match_data->actionIdSet(action_id);
   // Get the list of dataFields for action_id.
-  if (all_fields_set) {
-    status = table.dataFieldIdListGet(action_id, &dataFields);
-    if (status != BF_SUCCESS) {
-      LOG_TRACE("%s:%d %s ERROR in getting data Fields, err %d",
-                __func__,
-                __LINE__,
-                table.table_name_get().c_str(),
-                status);
-      // Must free stful related memory
-      if (res_data.stful.data != nullptr) {
-        bf_sys_free(res_data.stful.data);
-      }
-      return status;
+  const std::vector<BfRtTableObj::DataFieldReadInfo> *read_info = nullptr;
+  status = table.dataFieldReadInfoGet(action_id, &read_info);
+  if (status != BF_SUCCESS) {
+    LOG_TRACE("%s:%d %s ERROR in getting data Fields, err %d",
+              __func__,
+              __LINE__,
+              table.table_name_get().c_str(),
+              status);
+    // Must free stful related memory
+    if (res_data.stful.data != nullptr) {
+      bf_sys_free(res_data.stful.data);
     }
+    return status;
+  }
+  // The fields are collected first since populating them may remove oneof
+  // siblings from the active fields. The list is reused between calls.
+  static thread_local std::vector<const BfRtTableObj::DataFieldReadInfo *>
+      dataFields;
+  dataFields.clear();
+  if (all_fields_set) {
     // Reset object with proper action id, but empty vector so all action
-    // related fields will be marked as active.
-    std::vector<bf_rt_id_t> empty;
-    match_data->setActiveFields(empty);
+    // related fields will be marked as active. A data object reused across
+    // reads of the same action already has them all active.
+    if (!activeFieldsAreAll(table, *match_data, action_id, *read_info)) {
+      std::vector<bf_rt_id_t> empty;
+      match_data->setActiveFields(empty);
+    }
+    for (const auto &field_info : *read_info) {
+      dataFields.push_back(&field_info);
+    }
   } else {
     // Set action id to proper value, but use data fields already present,
     // so only data fields requested will be returned.
-    dataFields.assign(match_data->getActiveFields().begin(),
-                      match_data->getActiveFields().end());
+    for (const auto &dataFieldId : match_data->getActiveFields()) {
+      auto field_info = findDataFieldReadInfo(*read_info, dataFieldId);
+      BF_RT_ASSERT(field_info != nullptr);
+      dataFields.push_back(field_info);
+    }
   }
 
-  for (const auto &dataFieldId : dataFields) {
-    const BfRtTableDataField *tableDataField = nullptr;
-    status = table.getDataField(dataFieldId, action_id, &tableDataField);
-    BF_RT_ASSERT(status == BF_SUCCESS);
-    auto fieldTypes = tableDataField->getTypes();
-    fieldDestination field_destination =
-        BfRtTableDataField::getDataFieldDestination(fieldTypes);
+  for (const auto field_info : dataFields) {
+    const bf_rt_id_t &dataFieldId = field_info->id;
+    const auto &fieldTypes = field_info->field->getTypes();
+    fieldDestination field_destination = field_info->destination;
     switch (field_destination) {
       case fieldDestination::DIRECT_LPF:
         if (res_data.has_lpf) {
@@ -228,10 +335,7 @@ static bf_status_t populate_data_fields(const BfRtTableObj &table,
             static_cast<BfRtMatchActionIndirectTableData *>(match_data);
         pipe_action_spec_t *pipe_action_spec =
             match_indir_data->get_pipe_action_spec();
-        std::set<bf_rt_id_t> oneof_siblings;
-        status =
-            ind_tbl->dataFieldOneofSiblingsGet(dataFieldId, &oneof_siblings);
-        BF_RT_ASSERT(status == BF_SUCCESS);
+        const auto &oneof_siblings = field_info->field->oneofSiblings();
 
         if (fieldTypes.find(DataFieldType::ACTION_MEMBER_ID) !=
             fieldTypes.end()) {
@@ -291,10 +395,10 @@ static bf_status_t populate_data_fields(const BfRtTableObj &table,
   // After going over all the data fields, check whether either one
   // of entry_ttl or hit_state was set, remove if not.
   if (!res_data.has_ttl) {
-    match_data->removeActiveFields({ttl_field_id});
+    match_data->removeActiveField(ttl_field_id);
   }
   if (!res_data.has_hit_state) {
-    match_data->removeActiveFields({hs_field_id});
+    match_data->removeActiveField(hs_field_id);
   }
   return BF_SUCCESS;
 }
@@ -360,9 +464,15 @@ bf_status_t get_next_n_entries(const BfRtTableObj &table,
     return status;
   }
 
-  std::vector<pipe_action_spec_t *> pipe_action_specs(n, nullptr);
-  std::vector<pipe_tbl_match_spec_t> pipe_match_specs(n, {0});
-  std::vector<uint32_t> res_get_flags(n, 0);
+  static thread_local GetNextNContext ctx;
+  ctx.reset(n);
+  auto &pipe_match_specs = ctx.pipe_match_specs;
+  auto &res_get_flags = ctx.res_get_flags;
+  // Entries read in one batch usually share their action and requested
+  // fields, so the resources to fetch are only worked out when they change.
+  const BfRtMatchActionTableData *prev_data = nullptr;
+  bf_rt_id_t prev_action_id = 0;
+  uint32_t prev_res_get_flags = 0;
   // Validate data array
   unsigned i = 0;
   BfRtMatchActionKey *this_key = nullptr;
@@ -391,48 +501,30 @@ bf_status_t get_next_n_entries(const BfRtTableObj &table,
     } else {
       bf_rt_id_t req_action_id;
       status = this_data->actionIdGet(&req_action_id);
-      for (const auto &dataFieldId : this_data->getActiveFields()) {
-        const BfRtTableDataField *tableDataField = nullptr;
-        status =
-            table.getDataField(dataFieldId, req_action_id, &tableDataField);
+      if (prev_data && prev_action_id == req_action_id &&
+          prev_data->getActiveFields() == this_data->getActiveFields()) {
+        res_get_flags[i] = prev_res_get_flags;
+      } else {
+        const std::vector<BfRtTableObj::DataFieldReadInfo> *read_info;
+        status = table.dataFieldReadInfoGet(req_action_id, &read_info);
         BF_RT_ASSERT(status == BF_SUCCESS);
-        auto fieldTypes = tableDataField->getTypes();
-        fieldDestination field_destination =
-            BfRtTableDataField::getDataFieldDestination(fieldTypes);
-        switch (field_destination) {
-          case fieldDestination::DIRECT_LPF:
-          case fieldDestination::DIRECT_METER:
-          case fieldDestination::DIRECT_WRED:
-            res_get_flags[i] |= PIPE_RES_GET_FLAG_METER;
-            break;
-          case fieldDestination::DIRECT_REGISTER:
-            res_get_flags[i] |= PIPE_RES_GET_FLAG_STFUL;
-            break;
-          case fieldDestination::ACTION_SPEC:
-            res_get_flags[i] |= PIPE_RES_GET_FLAG_ENTRY;
-            break;
-          case fieldDestination::DIRECT_COUNTER:
-            res_get_flags[i] |= PIPE_RES_GET_FLAG_CNTR;
-            break;
-          case fieldDestination::ENTRY_HIT_STATE:
-          case fieldDestination::TTL:
-            res_get_flags[i] |= PIPE_RES_GET_FLAG_IDLE;
-            break;
-          default:
-            break;
-        }
+        res_get_flags[i] =
+            resGetFlagsForFields(*read_info, this_data->getActiveFields());
       }
+      prev_data = this_data;
+      prev_action_id = req_action_id;
+      prev_res_get_flags = res_get_flags[i];
     }
     // Use table data object spec to save memory
-    pipe_action_specs[i] = this_data->get_pipe_action_spec();
+    ctx.pipe_action_specs[i] = this_data->get_pipe_action_spec();
     // Initialize match spec fields, actual data will get overwritten
     // later by pipe_mgr
     this_key->populate_match_spec(&pipe_match_specs[i]);
   }
 
-  std::vector<pipe_act_fn_hdl_t> act_fn_hdls(n, 0);
-  std::vector<pipe_res_get_data_t> res_data(n, {0});
-  pipe_action_spec_t **aspecs = pipe_action_specs.data();
+  auto &act_fn_hdls = ctx.act_fn_hdls;
+  auto &res_data = ctx.res_data;
+  pipe_action_spec_t **aspecs = ctx.pipe_action_specs.data();
   pipe_mat_ent_hdl_t last_ent_hdl = 0;
 
   status =
@@ -5458,6 +5550,59 @@ bf_status_t BfRtSelectorTable::getActMbrIdFromHndl(
   return actTbl->getMbrIdFromHndl(session, dev_tgt, adt_ent_hdl, act_mbr_id);
 }
 
+namespace {
+// Sets the membership of a selector group. With $ACTION_MEMBER_WEIGHT each
+// member takes weights[i] slots, pipe-mgr reduces the weights to fit in
+// max_slots, or in the group size when max_slots is 0.
+bf_status_t selGrpMbrsSet(const BfRtSession &session,
+                          const std::string &table_name,
+                          const bf_dev_id_t &dev_id,
+                          const pipe_sel_tbl_hdl_t &pipe_tbl_hdl,
+                          const pipe_sel_grp_hdl_t &sel_grp_hdl,
+                          std::vector<pipe_adt_ent_hdl_t> *action_entry_hdls,
+                          std::vector<char> *pipe_member_status,
+                          std::vector<uint32_t> *weights,
+                          const uint32_t &max_slots) {
+  auto *pipeMgr = PipeMgrIntf::getInstance(session);
+  if (weights->empty()) {
+    return pipeMgr->pipeMgrSelGrpMbrsSet(
+        session.sessHandleGet(),
+        dev_id,
+        pipe_tbl_hdl,
+        sel_grp_hdl,
+        action_entry_hdls->size(),
+        action_entry_hdls->data(),
+        (bool *)(pipe_member_status->data()),
+        0 /* Pipe API flags */);
+  }
+  pipe_sel_grp_weight_report_t report = {};
+  bf_status_t status = pipeMgr->pipeMgrSelGrpMbrsSetWeighted(
+      session.sessHandleGet(),
+      dev_id,
+      pipe_tbl_hdl,
+      sel_grp_hdl,
+      action_entry_hdls->size(),
+      action_entry_hdls->data(),
+      weights->data(),
+      (bool *)(pipe_member_status->data()),
+      max_slots,
+      &report,
+      0 /* Pipe API flags */);
+  if (status == BF_SUCCESS && report.max_share_error_ppm) {
+    LOG_DBG("%s:%d %s Weights of grp hdl %d reduced from %" PRIu64
+            " to %d slots, max share error %d ppm",
+            __func__,
+            __LINE__,
+            table_name.c_str(),
+            sel_grp_hdl,
+            report.requested_total,
+            report.achieved_total,
+            report.max_share_error_ppm);
+  }
+  return status;
+}
+}  // namespace
+
 bf_status_t BfRtSelectorTable::tableEntryAdd(const BfRtSession &session,
                                              const bf_rt_target_t &dev_tgt,
                                              const uint64_t & /*flags*/,
@@ -5490,6 +5635,15 @@ bf_status_t BfRtSelectorTable::tableEntryAdd(const BfRtSession &session,
               member_status.size());
     return BF_INVALID_ARG;
   }
+  std::vector<uint32_t> weights = sel_data.getMemberWeights();
+  if (!weights.empty() && members.size() != weights.size()) {
+    LOG_TRACE("%s:%d MemberId size %zu and member weight size %zu do not match",
+              __func__,
+              __LINE__,
+              members.size(),
+              weights.size());
+    return BF_INVALID_ARG;
+  }
 
   // Before we add the group, we first check the validity of the members to be
   // added if any and build up a vector of action entry handles and action
@@ -5544,14 +5698,15 @@ bf_status_t BfRtSelectorTable::tableEntryAdd(const BfRtSession &session,
   }
 
   // Set the membership of the group
-  status = pipeMgr->pipeMgrSelGrpMbrsSet(session.sessHandleGet(),
-                                         pipe_dev_tgt.device_id,
-                                         pipe_tbl_hdl,
-                                         sel_grp_hdl,
-                                         members.size(),
-                                         action_entry_hdls.data(),
-                                         (bool *)(pipe_member_status.data()),
-                                         0 /* Pipe API flags */);
+  status = selGrpMbrsSet(session,
+                         table_name_get(),
+                         pipe_dev_tgt.device_id,
+                         pipe_tbl_hdl,
+                         sel_grp_hdl,
+                         &action_entry_hdls,
+                         &pipe_member_status,
+                         &weights,
+                         0);
   if (status != BF_SUCCESS) {
     LOG_TRACE(
         "%s:%d %s : Error in setting membership for group id %d pipe %x, err "
@@ -5597,6 +5752,15 @@ bf_status_t BfRtSelectorTable::tableEntryMod(const BfRtSession &session,
               member_status.size());
     return BF_INVALID_ARG;
   }
+  std::vector<uint32_t> weights = sel_data.getMemberWeights();
+  if (!weights.empty() && members.size() != weights.size()) {
+    LOG_TRACE("%s:%d MemberId size %zu and member weight size %zu do not match",
+              __func__,
+              __LINE__,
+              members.size(),
+              weights.size());
+    return BF_INVALID_ARG;
+  }
 
   // Get the mapping from selector group id to selector group handle
 
@@ -5661,17 +5825,23 @@ bf_status_t BfRtSelectorTable::tableEntryMod(const BfRtSession &session,
   }
 
   bool membrs_set = false;
+  const auto max_grp_size = sel_data.get_max_grp_size();
   // If new members will fit current size, set members first to support
-  // downsizing of the group.
-  if (curr_size >= members.size()) {
-    status = pipeMgr->pipeMgrSelGrpMbrsSet(session.sessHandleGet(),
-                                           pipe_dev_tgt.device_id,
-                                           pipe_tbl_hdl,
-                                           sel_grp_hdl,
-                                           members.size(),
-                                           action_entry_hdls.data(),
-                                           (bool *)(pipe_member_status.data()),
-                                           0 /* Pipe API flags */);
+  // downsizing of the group. Weighted members always fit once reduced, to
+  // the new size if the group shrinks.
+  bool fits_curr_size = weights.empty()
+                            ? curr_size >= members.size()
+                            : max_grp_size == 0 || max_grp_size <= curr_size;
+  if (fits_curr_size) {
+    status = selGrpMbrsSet(session,
+                           table_name_get(),
+                           pipe_dev_tgt.device_id,
+                           pipe_tbl_hdl,
+                           sel_grp_hdl,
+                           &action_entry_hdls,
+                           &pipe_member_status,
+                           &weights,
+                           max_grp_size);
     if (status != BF_SUCCESS) {
       LOG_TRACE(
           "%s:%d %s Error in setting membership for group id %d pipe %x, err "
@@ -5686,7 +5856,6 @@ bf_status_t BfRtSelectorTable::tableEntryMod(const BfRtSession &session,
     }
     membrs_set = true;
   }
-  const auto max_grp_size = sel_data.get_max_grp_size();
   bool size_changed = false;
   // Size of 0 is ignored, means no change in size.
   if (max_grp_size != 0 && curr_size != max_grp_size) {
@@ -5709,14 +5878,15 @@ bf_status_t BfRtSelectorTable::tableEntryMod(const BfRtSession &session,
     size_changed = true;
   }
   if (membrs_set == false) {
-    status = pipeMgr->pipeMgrSelGrpMbrsSet(session.sessHandleGet(),
-                                           pipe_dev_tgt.device_id,
-                                           pipe_tbl_hdl,
-                                           sel_grp_hdl,
-                                           members.size(),
-                                           action_entry_hdls.data(),
-                                           (bool *)(pipe_member_status.data()),
-                                           0 /* Pipe API flags */);
+    status = selGrpMbrsSet(session,
+                           table_name_get(),
+                           pipe_dev_tgt.device_id,
+                           pipe_tbl_hdl,
+                           sel_grp_hdl,
+                           &action_entry_hdls,
+                           &pipe_member_status,
+                           &weights,
+                           0);
     if (status != BF_SUCCESS) {
       if (size_changed) {
         // Restore group size
@@ -5957,6 +6127,29 @@ bf_status_t BfRtSelectorTable::tableEntryGet_internal(
     member_ids.push_back(member_id);
     member_id_status.push_back(pipe_member_status[i]);
   }
+  bf_rt_id_t weight_field_id;
+  if (dataFieldIdGet("$ACTION_MEMBER_WEIGHT", &weight_field_id) ==
+      BF_SUCCESS) {
+    // Pipe-mgr repeats a member once per slot, report it once with a weight
+    std::vector<bf_rt_id_t> weighted_ids;
+    std::vector<bool> weighted_status;
+    std::vector<uint32_t> weights;
+    std::map<bf_rt_id_t, size_t> id_pos;
+    for (unsigned i = 0; i < member_ids.size(); i++) {
+      auto it = id_pos.find(member_ids[i]);
+      if (it != id_pos.end()) {
+        weights[it->second]++;
+        continue;
+      }
+      id_pos[member_ids[i]] = weighted_ids.size();
+      weighted_ids.push_back(member_ids[i]);
+      weighted_status.push_back(member_id_status[i]);
+      weights.push_back(1);
+    }
+    member_ids.swap(weighted_ids);
+    member_id_status.swap(weighted_status);
+    sel_tbl_data->setMemberWeights(weights);
+  }
   sel_tbl_data->setMembers(member_ids);
   sel_tbl_data->setMemberStatus(member_id_status);
   sel_tbl_data->setMaxGrpSize(max_grp_size);
@@ -6800,6 +6993,81 @@ bf_status_t BfRtCounterTable::dataReset(BfRtTableData *data) const {
 
 // METER TABLE
 
+namespace {
+// Programs the entries of an index based resource table (Meter, LPF, WRED)
+// given as key/data pairs. The entries are sorted by index and every run of
+// consecutive indices is passed to pipe-mgr as one range update, so a spec
+// shared by many entries is only converted to the hardware format once. When
+// an index is given more than once the last data wins.
+template <class Key, class Data, class Spec, class SpecGet, class RangeSet>
+bf_status_t idxTableEntryModMulti(
+    const BfRtSession &session,
+    const bf_rt_target_t &dev_tgt,
+    const BfRtTableObj &table,
+    const BfRtTable::constKeyDataPairs &key_data_pairs,
+    SpecGet spec_get,
+    RangeSet range_set) {
+  std::vector<std::pair<uint32_t, const Spec *>> entries;
+  entries.reserve(key_data_pairs.size());
+  for (const auto &key_data : key_data_pairs) {
+    if (key_data.first == nullptr || key_data.second == nullptr) {
+      LOG_ERROR("%s:%d %s ERROR : Null key or data passed",
+                __func__,
+                __LINE__,
+                table.table_name_get().c_str());
+      return BF_INVALID_ARG;
+    }
+    uint32_t idx = static_cast<const Key *>(key_data.first)->getIdxKey();
+    if (!verify_key_for_idx_tbls(session, dev_tgt, table, idx)) {
+      return BF_INVALID_ARG;
+    }
+    entries.emplace_back(
+        idx, spec_get(*static_cast<const Data *>(key_data.second)));
+  }
+  // A stable sort keeps repeated indices in call order.
+  std::stable_sort(entries.begin(),
+                   entries.end(),
+                   [](const std::pair<uint32_t, const Spec *> &a,
+                      const std::pair<uint32_t, const Spec *> &b) {
+                     return a.first < b.first;
+                   });
+
+  dev_target_t pipe_dev_tgt;
+  pipe_dev_tgt.device_id = dev_tgt.dev_id;
+  pipe_dev_tgt.dev_pipe_id = dev_tgt.pipe_id;
+  std::vector<Spec> specs;
+  specs.reserve(entries.size());
+  size_t i = 0;
+  while (i < entries.size()) {
+    uint32_t first_idx = entries[i].first;
+    specs.clear();
+    for (; i < entries.size(); ++i) {
+      // Skip the entries overwritten by a later one for the same index.
+      if (i + 1 < entries.size() && entries[i + 1].first == entries[i].first) {
+        continue;
+      }
+      if (entries[i].first != first_idx + specs.size()) break;
+      specs.push_back(*entries[i].second);
+    }
+    bf_status_t status = range_set(pipe_dev_tgt,
+                                   first_idx,
+                                   static_cast<uint32_t>(specs.size()),
+                                   specs.data());
+    if (status != BF_SUCCESS) {
+      LOG_TRACE("%s:%d %s ERROR in programming %zd entries from idx %d, err %s",
+                __func__,
+                __LINE__,
+                table.table_name_get().c_str(),
+                specs.size(),
+                first_idx,
+                bf_err_str(status));
+      return status;
+    }
+  }
+  return BF_SUCCESS;
+}
+}  // namespace
+
 bf_status_t BfRtMeterTable::tableEntryAdd(const BfRtSession &session,
                                           const bf_rt_target_t &dev_tgt,
                                           const uint64_t & /*flags*/,
@@ -6838,6 +7106,37 @@ bf_status_t BfRtMeterTable::tableEntryMod(const BfRtSession &session,
   return tableEntryAdd(session, dev_tgt, flags, key, data);
 }
 
+bf_status_t BfRtMeterTable::tableEntryModMulti(
+    const BfRtSession &session,
+    const bf_rt_target_t &dev_tgt,
+    const uint64_t & /*flags*/,
+    const constKeyDataPairs &key_data_pairs) const {
+  auto *pipeMgr = PipeMgrIntf::getInstance(session);
+  return idxTableEntryModMulti<BfRtMeterTableKey,
+                               BfRtMeterTableData,
+                               pipe_meter_spec_t>(
+      session,
+      dev_tgt,
+      *this,
+      key_data_pairs,
+      [](const BfRtMeterTableData &data) {
+        return data.getMeterSpecObj().getPipeMeterSpec();
+      },
+      [&](const dev_target_t &pipe_dev_tgt,
+          uint32_t first_idx,
+          uint32_t num_entries,
+          pipe_meter_spec_t *specs) -> bf_status_t {
+        return pipeMgr->pipeMgrMeterEntSetRange(session.sessHandleGet(),
+                                                pipe_dev_tgt,
+                                                pipe_tbl_hdl,
+                                                first_idx,
+                                                num_entries,
+                                                specs,
+                                                num_entries,
+                                                0 /* Pipe API flags */);
+      });
+}
+
 bf_status_t BfRtMeterTable::tableEntryGet(const BfRtSession &session,
                                           const bf_rt_target_t &dev_tgt,
                                           const uint64_t &flags,
@@ -7182,6 +7481,37 @@ bf_status_t BfRtLPFTable::tableEntryMod(const BfRtSession &session,
   return tableEntryAdd(session, dev_tgt, flags, key, data);
 }
 
+bf_status_t BfRtLPFTable::tableEntryModMulti(
+    const BfRtSession &session,
+    const bf_rt_target_t &dev_tgt,
+    const uint64_t & /*flags*/,
+    const constKeyDataPairs &key_data_pairs) const {
+  auto *pipeMgr = PipeMgrIntf::getInstance(session);
+  return idxTableEntryModMulti<BfRtLPFTableKey,
+                               BfRtLPFTableData,
+                               pipe_lpf_spec_t>(
+      session,
+      dev_tgt,
+      *this,
+      key_data_pairs,
+      [](const BfRtLPFTableData &data) {
+        return data.getLPFSpecObj().getPipeLPFSpec();
+      },
+      [&](const dev_target_t &pipe_dev_tgt,
+          uint32_t first_idx,
+          uint32_t num_entries,
+          pipe_lpf_spec_t *specs) -> bf_status_t {
+        return pipeMgr->pipeMgrLpfEntSetRange(session.sessHandleGet(),
+                                              pipe_dev_tgt,
+                                              pipe_tbl_hdl,
+                                              first_idx,
+                                              num_entries,
+                                              specs,
+                                              num_entries,
+                                              0 /* Pipe API flags */);
+      });
+}
+
 bf_status_t BfRtLPFTable::tableEntryGet(const BfRtSession &session,
                                         const bf_rt_target_t &dev_tgt,
                                         const uint64_t &flags,
@@ -7402,6 +7732,37 @@ bf_status_t BfRtWREDTable::tableEntryMod(const BfRtSession &session,
   return tableEntryAdd(session, dev_tgt, flags, key, data);
 }
 
+bf_status_t BfRtWREDTable::tableEntryModMulti(
+    const BfRtSession &session,
+    const bf_rt_target_t &dev_tgt,
+    const uint64_t & /*flags*/,
+    const constKeyDataPairs &key_data_pairs) const {
+  auto *pipeMgr = PipeMgrIntf::getInstance(session);
+  return idxTableEntryModMulti<BfRtWREDTableKey,
+                               BfRtWREDTableData,
+                               pipe_wred_spec_t>(
+      session,
+      dev_tgt,
+      *this,
+      key_data_pairs,
+      [](const BfRtWREDTableData &data) {
+        return data.getWREDSpecObj().getPipeWREDSpec();
+      },
+      [&](const dev_target_t &pipe_dev_tgt,
+          uint32_t first_idx,
+          uint32_t num_entries,
+          pipe_wred_spec_t *specs) -> bf_status_t {
+        return pipeMgr->pipeMgrWredEntSetRange(session.sessHandleGet(),
+                                               pipe_dev_tgt,
+                                               pipe_tbl_hdl,
+                                               first_idx,
+                                               num_entries,
+                                               specs,
+                                               num_entries,
+                                               0 /* Pipe API flags */);
+      });
+}
+
 bf_status_t BfRtWREDTable::tableEntryGet(const BfRtSession &session,
                                          const bf_rt_target_t &dev_tgt,
                                          const uint64_t &flags,
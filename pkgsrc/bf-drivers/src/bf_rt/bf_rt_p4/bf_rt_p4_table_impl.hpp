@@ -1009,6 +1009,12 @@ class BfRtMeterTable : public BfRtTableObj {
                             const BfRtTableKey &key,
                             const BfRtTableData &data) const override;
 
+  bf_status_t tableEntryModMulti(
+      const BfRtSession &session,
+      const bf_rt_target_t &dev_tgt,
+      const uint64_t &flags,
+      const constKeyDataPairs &key_data_pairs) const override;
+
   bf_status_t tableEntryGet(const BfRtSession &session,
                             const bf_rt_target_t &dev_tgt,
                             const uint64_t &flags,
@@ -1121,6 +1127,12 @@ class BfRtLPFTable : public BfRtTableObj {
                             const BfRtTableKey &key,
                             const BfRtTableData &data) const override;
 
+  bf_status_t tableEntryModMulti(
+      const BfRtSession &session,
+      const bf_rt_target_t &dev_tgt,
+      const uint64_t &flags,
+      const constKeyDataPairs &key_data_pairs) const override;
+
   bf_status_t tableEntryGet(const BfRtSession &session,
                             const bf_rt_target_t &dev_tgt,
                             const uint64_t &flags,
@@ -1212,6 +1224,12 @@ class BfRtWREDTable : public BfRtTableObj {
                             const BfRtTableKey &key,
                             const BfRtTableData &data) const override;
 
+  bf_status_t tableEntryModMulti(
+      const BfRtSession &session,
+      const bf_rt_target_t &dev_tgt,
+      const uint64_t &flags,
+      const constKeyDataPairs &key_data_pairs) const override;
+
   bf_status_t tableEntryGet(const BfRtSession &session,
                             const bf_rt_target_t &dev_tgt,
                             const uint64_t &flags,
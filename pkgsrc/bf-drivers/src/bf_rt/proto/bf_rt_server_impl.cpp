@@ -49,6 +49,10 @@ inline bf_dev_id_t getDeviceIdFromCookie(const uint32_t &cookie) {
 // Bitmap signatrure of valid operation cookie object in memory.
 #define OP_COOKIE_FINGERPRINT 0xF146641F
 
+// Number of entries read per tableEntryGetNext_n call when reading a whole
+// table.
+#define GET_ALL_CHUNK_SIZE 1024U
+
 class OperationCookie {
  public:
   OperationCookie(const uint32_t &client_id, const bf_rt_id_t &table_id)
@@ -2467,89 +2471,144 @@ Status table_read_all(const BfRtInfo &info,
     return Status();
   }
   // 6 Prepare for get_all_entries
-  // Allocate data and key for the n
-  unsigned i = 0;
-  BfRtTable::keyDataPairs key_data_pairs;
-  std::vector<std::unique_ptr<BfRtTableKey>> keys(n - 1);
-  std::vector<std::unique_ptr<BfRtTableData>> data(n - 1);
-
-  // Make vector of pair of out params for tableEntryGetNext_n
-  for (i = 0; i < n - 1; i++) {
-    bf_status = table->keyAllocate(&keys[i]);
-    check_and_return(bf_status,
-                     "Key Allocate failed for table:%s",
-                     table_name_get(table).c_str());
+  // The remaining entries are read in chunks through a fixed pool of key and
+  // data objects which is reused for every chunk, rather than allocating a
+  // key and a data object per entry of the table. The slot holding the key
+  // a chunk starts from is left out of that chunk, and the pool starts with
+  // the key of the first entry.
+  const uint32_t remaining = n - 1;
+  const uint32_t chunk_size = std::min(remaining, GET_ALL_CHUNK_SIZE);
+  std::vector<std::unique_ptr<BfRtTableKey>> keys(chunk_size + 1);
+  std::vector<std::unique_ptr<BfRtTableData>> data(chunk_size + 1);
+  keys[0] = std::move(table_key);
+  for (size_t slot = 0; slot < keys.size(); slot++) {
+    if (!keys[slot]) {
+      bf_status = table->keyAllocate(&keys[slot]);
+      check_and_return(bf_status,
+                       "Key Allocate failed for table:%s",
+                       table_name_get(table).c_str());
+    }
     if (action_id == 0) {
       if (field_id_vec.size()) {
-        bf_status = table->dataAllocate(field_id_vec, &data[i]);
+        bf_status = table->dataAllocate(field_id_vec, &data[slot]);
       } else {
-        bf_status = table->dataAllocate(&data[i]);
+        bf_status = table->dataAllocate(&data[slot]);
       }
     } else {
       if (field_id_vec.size()) {
-        bf_status = table->dataAllocate(field_id_vec, action_id, &data[i]);
+        bf_status = table->dataAllocate(field_id_vec, action_id, &data[slot]);
       } else {
-        bf_status = table->dataAllocate(action_id, &data[i]);
+        bf_status = table->dataAllocate(action_id, &data[slot]);
       }
     }
     check_and_return(bf_status,
                      "Data Allocate failed for table:%s",
                      table_name_get(table).c_str());
-    key_data_pairs.push_back(std::make_pair(keys[i].get(), data[i].get()));
-  }
-
-  // 7 Get next n entries
-  uint32_t num_returned = 0;
-  bf_status = table->tableEntryGetNext_n(session,
-                                         target,
-                                         flags,
-                                         *table_key.get(),
-                                         n - 1,
-                                         &key_data_pairs,
-                                         &num_returned);
-
-  // BF_OBJECT_NOT_FOUND is not an error here, it is returned in case the
-  // function didn't find all 'n - 1' entries, which is possible and this
-  // is not an error. In such case we shall use num_returned as a number
-  // of entries really read from the table.
-  if (bf_status != BF_OBJECT_NOT_FOUND) {
-    check_and_return(bf_status,
-                     "Get last %d entries failed table:%s",
-                     n - 1,
-                     table_name_get(table).c_str());
   }
 
-  // 8 Formulate read response for all the n entries
-  for (i = 0; i < num_returned; i++) {
-    // Start constructing the proto response
-    auto response_table_entry = response->add_entities()->mutable_table_entry();
-    response_table_entry->set_table_id(table_entry.table_id());
+  BfRtTable::keyDataPairs key_data_pairs;
+  key_data_pairs.reserve(chunk_size);
+  size_t cursor = 0;
+  uint32_t total_returned = 0;
+  while (total_returned < remaining) {
+    const uint32_t count = std::min(chunk_size, remaining - total_returned);
+    // Make vector of pair of out params for tableEntryGetNext_n. Data
+    // objects filled by a previous chunk carry the action and active fields
+    // of the entry read into them, so they are reset first.
+    key_data_pairs.clear();
+    for (size_t slot = 0; key_data_pairs.size() < count; slot++) {
+      if (slot == cursor) {
+        continue;
+      }
+      if (total_returned) {
+        if (action_id == 0) {
+          if (field_id_vec.size()) {
+            bf_status = table->dataReset(field_id_vec, data[slot].get());
+          } else {
+            bf_status = table->dataReset(data[slot].get());
+          }
+        } else {
+          if (field_id_vec.size()) {
+            bf_status =
+                table->dataReset(field_id_vec, action_id, data[slot].get());
+          } else {
+            bf_status = table->dataReset(action_id, data[slot].get());
+          }
+        }
+        check_and_return(bf_status,
+                         "Data Reset failed for table:%s",
+                         table_name_get(table).c_str());
+      }
+      key_data_pairs.push_back(
+          std::make_pair(keys[slot].get(), data[slot].get()));
+    }
 
-    // Update entry_tgt in response only if the request has entry_tgt under
-    // table_entry
-    if (table_entry.has_entry_tgt()) {
-      response_table_entry->mutable_entry_tgt()->set_device_id(target.dev_id);
-      response_table_entry->mutable_entry_tgt()->set_direction(
-          target.direction);
-      response_table_entry->mutable_entry_tgt()->set_pipe_id(target.pipe_id);
-      response_table_entry->mutable_entry_tgt()->set_prsr_id(target.prsr_id);
+    // 7 Get next entries
+    uint32_t num_returned = 0;
+    bf_status = table->tableEntryGetNext_n(session,
+                                           target,
+                                           flags,
+                                           *keys[cursor],
+                                           count,
+                                           &key_data_pairs,
+                                           &num_returned);
+
+    // BF_OBJECT_NOT_FOUND is not an error here, it is returned in case the
+    // function didn't find all 'count' entries, which is possible and this
+    // is not an error. In such case we shall use num_returned as a number
+    // of entries really read from the table.
+    if (bf_status != BF_OBJECT_NOT_FOUND) {
+      check_and_return(bf_status,
+                       "Get last %d entries failed table:%s",
+                       count,
+                       table_name_get(table).c_str());
     }
 
-    if ((key_data_pairs[i].second) == nullptr) {
-      continue;
+    // 8 Formulate read response for the entries of this chunk
+    for (uint32_t i = 0; i < num_returned; i++) {
+      // Start constructing the proto response
+      auto response_table_entry =
+          response->add_entities()->mutable_table_entry();
+      response_table_entry->set_table_id(table_entry.table_id());
+
+      // Update entry_tgt in response only if the request has entry_tgt under
+      // table_entry
+      if (table_entry.has_entry_tgt()) {
+        response_table_entry->mutable_entry_tgt()->set_device_id(
+            target.dev_id);
+        response_table_entry->mutable_entry_tgt()->set_direction(
+            target.direction);
+        response_table_entry->mutable_entry_tgt()->set_pipe_id(
+            target.pipe_id);
+        response_table_entry->mutable_entry_tgt()->set_prsr_id(
+            target.prsr_id);
+      }
+
+      if ((key_data_pairs[i].second) == nullptr) {
+        continue;
+      }
+      grpc_status = formulateReadResponse(*table,
+                                          field_id_vec,
+                                          *(key_data_pairs[i].first),
+                                          *(key_data_pairs[i].second),
+                                          response_table_entry);
+      if (grpc_status.error_code() != grpc::OK) {
+        LOG_ERROR("%s:%d ERROR in forming read response for the %dth entry",
+                  __func__,
+                  __LINE__,
+                  total_returned + i + 2);
+        return grpc_status;
+      }
     }
-    grpc_status = formulateReadResponse(*table,
-                                        field_id_vec,
-                                        *(key_data_pairs[i].first),
-                                        *(key_data_pairs[i].second),
-                                        response_table_entry);
-    if (grpc_status.error_code() != grpc::OK) {
-      LOG_ERROR("%s:%d ERROR in forming read response for the %dth entry",
-                __func__,
-                __LINE__,
-                i + 2);
-      return grpc_status;
+
+    total_returned += num_returned;
+    if (bf_status == BF_OBJECT_NOT_FOUND || num_returned < count) {
+      break;
     }
+    // The next chunk starts after the last entry of this one. Pairs were
+    // built from the slots in order, skipping the cursor.
+    const size_t last = num_returned - 1;
+    cursor = last < cursor ? last : last + 1;
   }
 
   // 9 Debug log of returned values.
@@ -1050,6 +1050,54 @@ TEST_P(BfRtInfoTest, TestDataFieldCountIsCorrect) {
   }
 }
 
+// Testing the data field read info matches the data fields of each action
+TEST_P(BfRtInfoTest, TestDataFieldReadInfoIsCorrect) {
+  Cjson tables_cjson = (*bfrt_root_cjson)["tables"];
+
+  for (const auto &table_cjson : tables_cjson.getCjsonChildVec()) {
+    std::string table_name = (*table_cjson)["name"];
+    const BfRtTable *table_intf = nullptr;
+    auto status = bfrtInfo->bfrtTableFromNameGet(table_name, &table_intf);
+    if (status != BF_SUCCESS) {
+      continue;
+    }
+    const BfRtTableObj *table = dynamic_cast<const BfRtTableObj *>(table_intf);
+
+    std::vector<bf_rt_id_t> action_ids = {0};
+    for (auto const &action_spec :
+         (*table_cjson)["action_specs"].getCjsonChildVec()) {
+      action_ids.push_back((*action_spec)["id"]);
+    }
+    for (const auto &action_id : action_ids) {
+      std::vector<bf_rt_id_t> field_id_list;
+      status = table->dataFieldIdListGet(action_id, &field_id_list);
+      ASSERT_EQ(status, BF_SUCCESS) << "Check failed for table " << table_name;
+      const std::vector<BfRtTableObj::DataFieldReadInfo> *read_info = nullptr;
+      status = table->dataFieldReadInfoGet(action_id, &read_info);
+      ASSERT_EQ(status, BF_SUCCESS) << "Check failed for table " << table_name;
+      ASSERT_EQ(read_info->size(), field_id_list.size())
+          << "Check failed for table " << table_name;
+      for (size_t i = 0; i < field_id_list.size(); i++) {
+        const auto &info = (*read_info)[i];
+        EXPECT_EQ(info.id, field_id_list[i])
+            << "Check failed for table " << table_name;
+        const BfRtTableDataField *field = nullptr;
+        status = table->getDataField(info.id, action_id, &field);
+        EXPECT_EQ(status, BF_SUCCESS);
+        EXPECT_EQ(info.field, field);
+        EXPECT_EQ(info.destination,
+                  BfRtTableDataField::getDataFieldDestination(
+                      field->getTypes()));
+      }
+      // The read info is built once per action
+      const std::vector<BfRtTableObj::DataFieldReadInfo> *again = nullptr;
+      status = table->dataFieldReadInfoGet(action_id, &again);
+      EXPECT_EQ(status, BF_SUCCESS);
+      EXPECT_EQ(read_info, again);
+    }
+  }
+}
+
 // Testing for parsing correctness of table operations
 TEST_P(BfRtInfoTest, TestTableOperationsParsingIsCorrect) {
   std::vector<const BfRtTable *> vec;
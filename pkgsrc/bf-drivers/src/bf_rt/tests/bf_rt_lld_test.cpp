@@ -0,0 +1,221 @@
+/*******************************************************************************
+ *  Copyright (C) 2024 Intel Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing,
+ *  software distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions
+ *  and limitations under the License.
+ *
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <vector>
+
+// LLD burst pushes, run against a device whose DR views are backed by host
+// memory only so nothing is published to hardware.
+extern "C" {
+#include <target-sys/bf_sal/bf_sys_intf.h>
+#include <bf_types/bf_types.h>
+#include <lld/bf_dma_if.h>
+#include <lld/lld_err.h>
+#include <lld/lld_dr_if.h>
+#include <lld/lld_subdev_dr_if.h>
+#include <lld/lld_dr_descriptors.h>
+#include <lld/lld_dr_regs_tof2.h>
+#include "lld/lld.h"
+}
+
+namespace bfrt {
+namespace bfrt_test {
+
+namespace {
+constexpr bf_dev_id_t kDev = BF_MAX_DEV_COUNT - 1;
+constexpr int kEntries = 8;
+constexpr int kWords = 4;
+constexpr uint32_t kWrap = 1u << TOF2_DR_WRAP_BIT_POSITION;
+
+// Fields of the first word of a Tx descriptor, see format_dr_msg_tx_wd0.
+struct Wd0 {
+  uint64_t data_sz, attr, type, e, s;
+};
+
+Wd0 decode(uint64_t wd0) {
+  Wd0 d;
+  d.data_sz = wd0 >> 32;
+  d.attr = (wd0 >> 5) & 0x7FFFFFF;
+  d.type = (wd0 >> 2) & 0x7;
+  d.e = (wd0 >> 1) & 0x1;
+  d.s = wd0 & 0x1;
+  return d;
+}
+
+lld_wb_desc_t wbDesc(uint64_t msg_id, uint32_t mcast_vector) {
+  lld_wb_desc_t wb = {4, 1, 16, false, 0x1000, 0x80000, msg_id, mcast_vector};
+  return wb;
+}
+
+class LldDrBurstTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    dev_ = &lld_ctx->asic[kDev][0];
+    saved_ = *dev_;
+    std::memset(dev_, 0, sizeof *dev_);
+    dev_->dev_family = BF_DEV_FAMILY_TOFINO2;
+    dev_->assigned = 1;
+    dev_->ready = 1;
+    dev_->dev_id = kDev;
+    addView(lld_dr_tx_pipe_write_block);
+    addView(lld_dr_tx_pipe_inst_list_0);
+  }
+  void TearDown() override { *dev_ = saved_; }
+
+  void addView(bf_dma_dr_id_t dr) {
+    lld_dr_view_t *view = &dev_->dr_view[dr];
+    mem_[dr].assign(kEntries * kWords, 0);
+    view->base = reinterpret_cast<uintptr_t>(mem_[dr].data());
+    view->n_words_per_desc = kWords;
+    view->n_entries = kEntries;
+    view->producer = true;
+    view->dev_id = kDev;
+    view->dr_id = BF_DMA_NO_DR;  // Not in the DMA log.
+  }
+  lld_dr_view_t *view(bf_dma_dr_id_t dr) { return &dev_->dr_view[dr]; }
+  const dr_msg_tx_t *desc(bf_dma_dr_id_t dr, int entry) {
+    return reinterpret_cast<const dr_msg_tx_t *>(&mem_[dr][entry * kWords]);
+  }
+
+  lld_dev_t *dev_ = nullptr;
+  lld_dev_t saved_;
+  std::map<int, std::vector<uint64_t>> mem_;
+};
+}  // anonymous namespace
+
+TEST_F(LldDrBurstTest, WriteBlockDescriptors) {
+  const bf_dma_dr_id_t dr = lld_dr_tx_pipe_write_block;
+  lld_wb_desc_t wbs[3] = {wbDesc(1, 0), wbDesc(2, 0x5), wbDesc(3, 0xF)};
+  wbs[1].addr_inc = 4;
+  wbs[2].entry_sz = 8;
+  wbs[2].single_entry = true;
+
+  ASSERT_EQ(LLD_OK, lld_subdev_push_wb_burst(kDev, 0, wbs, 3));
+  EXPECT_EQ(3u, view(dr)->tail);
+  EXPECT_EQ(3u, view(dr)->n_descs);
+
+  // Unicast, 4B entries with an address step of 1.
+  Wd0 d = decode(desc(dr, 0)->wd0);
+  EXPECT_EQ(64u, d.data_sz);
+  EXPECT_EQ(0u, d.attr);
+  EXPECT_EQ(static_cast<uint64_t>(tx_m_type_wr_blk), d.type);
+  EXPECT_EQ(1u, d.e);
+  EXPECT_EQ(1u, d.s);
+  EXPECT_EQ(0x1000u, desc(dr, 0)->source_address);
+  EXPECT_EQ(0x80000u, desc(dr, 0)->destination_address);
+  EXPECT_EQ(1u, desc(dr, 0)->message_id);
+  // Multicast to pipes 0 and 2 with an address step of 4.
+  d = decode(desc(dr, 1)->wd0);
+  EXPECT_EQ((1u << 4) | (0x5u << 5) | (2u << 9), d.attr);
+  EXPECT_EQ(2u, desc(dr, 1)->message_id);
+  // Multicast of a single 8B entry to all pipes.
+  d = decode(desc(dr, 2)->wd0);
+  EXPECT_EQ(128u, d.data_sz);
+  EXPECT_EQ(1u | (1u << 3) | (1u << 4) | (0xFu << 5), d.attr);
+  EXPECT_EQ(3u, desc(dr, 2)->message_id);
+
+  // The single descriptor entry point encodes the same descriptor.
+  ASSERT_EQ(LLD_OK,
+            lld_subdev_push_wb_mcast(
+                kDev, 0, 4, 4, 16, false, 0x1000, 0x80000, 0x5, 2));
+  EXPECT_EQ(desc(dr, 1)->wd0, desc(dr, 3)->wd0);
+  EXPECT_EQ(4u, view(dr)->tail);
+}
+
+TEST_F(LldDrBurstTest, BurstWrapsAroundTheRing) {
+  const bf_dma_dr_id_t dr = lld_dr_tx_pipe_write_block;
+  view(dr)->head = view(dr)->tail = 6;
+  lld_wb_desc_t wbs[4];
+  for (int i = 0; i < 4; ++i) wbs[i] = wbDesc(10 + i, 0x1);
+
+  ASSERT_EQ(LLD_OK, lld_subdev_push_wb_burst(kDev, 0, wbs, 4));
+  EXPECT_EQ(10u, desc(dr, 6)->message_id);
+  EXPECT_EQ(11u, desc(dr, 7)->message_id);
+  EXPECT_EQ(12u, desc(dr, 0)->message_id);
+  EXPECT_EQ(13u, desc(dr, 1)->message_id);
+  EXPECT_EQ(0u, desc(dr, 2)->wd0);
+  // The published tail is past the last descriptor, with the wrap bit set.
+  EXPECT_EQ(2u | kWrap, view(dr)->tail);
+  EXPECT_EQ(6u, view(dr)->head);
+}
+
+TEST_F(LldDrBurstTest, BurstIsAllOrNothing) {
+  const bf_dma_dr_id_t dr = lld_dr_tx_pipe_write_block;
+  view(dr)->head = 0;
+  view(dr)->tail = 5;
+  lld_wb_desc_t wbs[4];
+  for (int i = 0; i < 4; ++i) wbs[i] = wbDesc(20 + i, 0x1);
+
+  // Three entries are free, nothing of a burst of four is pushed.
+  EXPECT_EQ(LLD_ERR_DR_FULL, lld_subdev_push_wb_burst(kDev, 0, wbs, 4));
+  EXPECT_EQ(5u, view(dr)->tail);
+  EXPECT_EQ(0u, desc(dr, 5)->wd0);
+
+  // Nor is anything of a burst holding a bad descriptor.
+  wbs[1].source = 0x1004;
+  EXPECT_EQ(LLD_ERR_BAD_PARM, lld_subdev_push_wb_burst(kDev, 0, wbs, 3));
+  EXPECT_EQ(5u, view(dr)->tail);
+  EXPECT_EQ(0u, desc(dr, 5)->wd0);
+
+  // A burst of three fills the ring.
+  wbs[1].source = 0x1000;
+  ASSERT_EQ(LLD_OK, lld_subdev_push_wb_burst(kDev, 0, wbs, 3));
+  EXPECT_EQ(0u | kWrap, view(dr)->tail);
+  EXPECT_EQ(22u, desc(dr, 7)->message_id);
+  EXPECT_EQ(LLD_ERR_DR_FULL, lld_subdev_push_wb_burst(kDev, 0, wbs, 1));
+}
+
+TEST_F(LldDrBurstTest, InstructionListDescriptors) {
+  const bf_dma_dr_id_t dr = lld_dr_tx_pipe_inst_list_0;
+  lld_ilist_desc_t ils[2] = {{0x2000, 256, 16, false, 0x3000, 1, 0},
+                             {0x4000, 128, 0, false, 0, 2, 0x6}};
+
+  ASSERT_EQ(LLD_OK, lld_subdev_push_ilist_burst(kDev, 0, 0, ils, 2));
+  EXPECT_EQ(2u, view(dr)->tail);
+
+  // Unicast with 16B responses.
+  uint64_t wd0 = desc(dr, 0)->wd0;
+  EXPECT_EQ(256u, wd0 >> 32);
+  EXPECT_EQ(2u, (wd0 >> 6) & 0x3);  // response size
+  EXPECT_EQ(1u, (wd0 >> 5) & 0x1);  // list type
+  EXPECT_EQ(static_cast<uint64_t>(tx_m_type_il), (wd0 >> 2) & 0x7);
+  EXPECT_EQ(0x2000u, desc(dr, 0)->source_address);
+  EXPECT_EQ(0x3000u, desc(dr, 0)->destination_address);
+  // Multicast to pipes 1 and 2 without responses.
+  Wd0 d = decode(desc(dr, 1)->wd0);
+  EXPECT_EQ(128u, d.data_sz);
+  EXPECT_EQ((1u << 4) | (0x6u << 5), d.attr);
+  EXPECT_EQ(static_cast<uint64_t>(tx_m_type_il), d.type);
+  EXPECT_EQ(2u, desc(dr, 1)->message_id);
+
+  // Tofino has no multicast instruction lists.
+  dev_->dev_family = BF_DEV_FAMILY_TOFINO;
+  EXPECT_EQ(LLD_ERR_BAD_PARM, lld_subdev_push_ilist_burst(kDev, 0, 0, ils, 2));
+  EXPECT_EQ(LLD_OK, lld_subdev_push_ilist_burst(kDev, 0, 0, ils, 1));
+  EXPECT_EQ(3u, view(dr)->tail);
+}
+
+}  // namespace bfrt_test
+}  // namespace bfrt
@@ -0,0 +1,197 @@
+/*******************************************************************************
+ *  Copyright (C) 2024 Intel Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing,
+ *  software distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions
+ *  and limitations under the License.
+ *
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <vector>
+
+// Internal mc_mgr routines behind the RDM compactor, they need no device.
+extern "C" {
+#include <target-utils/map/map.h>
+
+typedef enum mc_mgr_rdm_owner_sts_e {
+  mc_mgr_rdm_owner_gone = 0,
+  mc_mgr_rdm_owner_moved,
+  mc_mgr_rdm_owner_skipped,
+  mc_mgr_rdm_owner_no_room,
+} mc_mgr_rdm_owner_sts_e;
+typedef mc_mgr_rdm_owner_sts_e (*mc_mgr_rdm_owner_fn)(unsigned long hdl,
+                                                      void *cookie);
+uint32_t mc_mgr_rdm_owners_walk(bf_map_t *owners,
+                                uint32_t budget,
+                                mc_mgr_rdm_owner_fn fn,
+                                void *cookie,
+                                bool *found);
+uint32_t mc_mgr_rdm_frag_pct(uint32_t blocks,
+                             uint32_t used,
+                             uint32_t blk_size,
+                             uint32_t *reclaimable);
+bool mc_mgr_rdm_defrag_due(uint32_t blocks,
+                           uint32_t reclaimable,
+                           uint32_t threshold,
+                           bool urgent);
+}
+
+namespace bfrt {
+namespace bfrt_test {
+
+namespace {
+// Stands in for the compactor's relocation of one owner of the victim block,
+// records the owners it was offered.
+struct OwnerMover {
+  std::function<mc_mgr_rdm_owner_sts_e(unsigned long)> decide;
+  std::vector<unsigned long> offered;
+
+  static mc_mgr_rdm_owner_sts_e cb(unsigned long hdl, void *cookie) {
+    auto *m = static_cast<OwnerMover *>(cookie);
+    m->offered.push_back(hdl);
+    return m->decide(hdl);
+  }
+};
+
+std::set<unsigned long> ownerSet(bf_map_t *owners) {
+  std::set<unsigned long> s;
+  unsigned long key = 0;
+  void *data = nullptr;
+  for (bf_map_sts_t r = bf_map_get_first(owners, &key, &data); r == BF_MAP_OK;
+       r = bf_map_get_next(owners, &key, &data))
+    s.insert(key);
+  return s;
+}
+
+bf_map_t makeOwners(unsigned long first, unsigned long last) {
+  bf_map_t owners;
+  bf_map_init(&owners);
+  for (unsigned long h = first; h <= last; ++h)
+    bf_map_add(&owners, h, nullptr);
+  return owners;
+}
+}  // anonymous namespace
+
+TEST(McMgrRdmDefragTest, FragmentationMetric) {
+  const uint32_t blk = 4096;
+  uint32_t reclaimable = 0;
+  // Four blocks holding just over one block of entries, two could go.
+  EXPECT_EQ(mc_mgr_rdm_frag_pct(4, blk + 1, blk, &reclaimable), 50u);
+  EXPECT_EQ(reclaimable, 2u);
+  // Packed blocks are not fragmented.
+  EXPECT_EQ(mc_mgr_rdm_frag_pct(2, 2 * blk, blk, &reclaimable), 0u);
+  EXPECT_EQ(reclaimable, 0u);
+  EXPECT_EQ(mc_mgr_rdm_frag_pct(3, 2 * blk + 1, blk, &reclaimable), 0u);
+  EXPECT_EQ(reclaimable, 0u);
+  // Blocks with nothing in them can all be reclaimed.
+  EXPECT_EQ(mc_mgr_rdm_frag_pct(3, 0, blk, &reclaimable), 100u);
+  EXPECT_EQ(reclaimable, 3u);
+  // A level without blocks.
+  EXPECT_EQ(mc_mgr_rdm_frag_pct(0, 0, blk, &reclaimable), 0u);
+  EXPECT_EQ(reclaimable, 0u);
+}
+
+TEST(McMgrRdmDefragTest, ThresholdAndUrgency) {
+  // Nothing to reclaim, even a failed allocation cannot be helped.
+  EXPECT_FALSE(mc_mgr_rdm_defrag_due(4, 0, 0, true));
+  // One of four blocks is 25% fragmentation.
+  EXPECT_TRUE(mc_mgr_rdm_defrag_due(4, 1, 25, false));
+  EXPECT_FALSE(mc_mgr_rdm_defrag_due(5, 1, 25, false));
+  // A failed allocation overrides the threshold.
+  EXPECT_TRUE(mc_mgr_rdm_defrag_due(5, 1, 25, true));
+  EXPECT_TRUE(mc_mgr_rdm_defrag_due(100, 1, 100, true));
+  EXPECT_TRUE(mc_mgr_rdm_defrag_due(100, 1, 0, false));
+}
+
+TEST(McMgrRdmDefragTest, StepsArePacedByTheMoveBudget) {
+  bf_map_t owners = makeOwners(1, 10);
+  OwnerMover m;
+  m.decide = [](unsigned long) { return mc_mgr_rdm_owner_moved; };
+
+  bool found = false;
+  EXPECT_EQ(mc_mgr_rdm_owners_walk(&owners, 3, OwnerMover::cb, &m, &found),
+            3u);
+  EXPECT_TRUE(found);
+  EXPECT_EQ(m.offered, std::vector<unsigned long>({1, 2, 3}));
+  EXPECT_EQ(ownerSet(&owners), std::set<unsigned long>({4, 5, 6, 7, 8, 9, 10}));
+
+  // The next step carries on where the last one stopped.
+  m.offered.clear();
+  EXPECT_EQ(mc_mgr_rdm_owners_walk(&owners, 64, OwnerMover::cb, &m, &found),
+            7u);
+  EXPECT_EQ(m.offered.size(), 7u);
+  EXPECT_EQ(bf_map_count(&owners), 0u);
+
+  // An emptied block has nothing left to offer.
+  m.offered.clear();
+  EXPECT_EQ(mc_mgr_rdm_owners_walk(&owners, 64, OwnerMover::cb, &m, &found),
+            0u);
+  EXPECT_FALSE(found);
+  EXPECT_TRUE(m.offered.empty());
+  bf_map_destroy(&owners);
+}
+
+TEST(McMgrRdmDefragTest, RelocationPrunesStaleOwners) {
+  bf_map_t owners = makeOwners(1, 6);
+  OwnerMover m;
+  // Even handles were deleted or moved elsewhere since they were recorded,
+  // handle 3 cannot be moved right now and the rest move.
+  m.decide = [](unsigned long h) {
+    if (!(h & 1)) return mc_mgr_rdm_owner_gone;
+    if (h == 3) return mc_mgr_rdm_owner_skipped;
+    return mc_mgr_rdm_owner_moved;
+  };
+
+  bool found = false;
+  EXPECT_EQ(mc_mgr_rdm_owners_walk(&owners, 64, OwnerMover::cb, &m, &found),
+            2u);
+  EXPECT_TRUE(found);
+  EXPECT_EQ(m.offered.size(), 6u);
+  // Stale and moved owners are dropped, only the one left behind stays.
+  EXPECT_EQ(ownerSet(&owners), std::set<unsigned long>({3}));
+
+  // Once it goes as well the block is done.
+  m.decide = [](unsigned long) { return mc_mgr_rdm_owner_gone; };
+  EXPECT_EQ(mc_mgr_rdm_owners_walk(&owners, 64, OwnerMover::cb, &m, &found),
+            0u);
+  EXPECT_FALSE(found);
+  EXPECT_EQ(bf_map_count(&owners), 0u);
+  bf_map_destroy(&owners);
+}
+
+TEST(McMgrRdmDefragTest, RelocationStopsWhenOutOfRoom) {
+  bf_map_t owners = makeOwners(1, 4);
+  OwnerMover m;
+  m.decide = [](unsigned long h) {
+    return h < 2 ? mc_mgr_rdm_owner_moved : mc_mgr_rdm_owner_no_room;
+  };
+
+  bool found = false;
+  EXPECT_EQ(mc_mgr_rdm_owners_walk(&owners, 64, OwnerMover::cb, &m, &found),
+            1u);
+  // The block still has nodes to move so it stays the victim.
+  EXPECT_TRUE(found);
+  EXPECT_EQ(m.offered, std::vector<unsigned long>({1, 2}));
+  EXPECT_EQ(ownerSet(&owners), std::set<unsigned long>({2, 3, 4}));
+  bf_map_destroy(&owners);
+}
+
+}  // namespace bfrt_test
+}  // namespace bfrt
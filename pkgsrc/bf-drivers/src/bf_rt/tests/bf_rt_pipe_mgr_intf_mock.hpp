@@ -934,6 +934,15 @@ class MockIPipeMgrIntf : public IPipeMgrIntf {
                              pipe_meter_idx_t meter_idx,
                              pipe_meter_spec_t *meter_spec,
                              uint32_t pipe_api_flags));
+  MOCK_METHOD8(pipeMgrMeterEntSetRange,
+               pipe_status_t(pipe_sess_hdl_t sess_hdl,
+                             dev_target_t dev_tgt,
+                             pipe_meter_tbl_hdl_t meter_tbl_hdl,
+                             pipe_meter_idx_t first_idx,
+                             uint32_t num_entries,
+                             pipe_meter_spec_t *meter_specs,
+                             uint32_t num_specs,
+                             uint32_t pipe_api_flags));
   MOCK_METHOD3(pipeMgrModelTimeAdvance,
                pipe_status_t(pipe_sess_hdl_t sess_hdl,
                              bf_dev_id_t device_id,
@@ -973,6 +982,15 @@ class MockIPipeMgrIntf : public IPipeMgrIntf {
                              pipe_lpf_idx_t lpf_idx,
                              pipe_lpf_spec_t *lpf_spec,
                              uint32_t pipe_api_flags));
+  MOCK_METHOD8(pipeMgrLpfEntSetRange,
+               pipe_status_t(pipe_sess_hdl_t sess_hdl,
+                             dev_target_t dev_tgt,
+                             pipe_lpf_tbl_hdl_t lpf_tbl_hdl,
+                             pipe_lpf_idx_t first_idx,
+                             uint32_t num_entries,
+                             pipe_lpf_spec_t *lpf_specs,
+                             uint32_t num_specs,
+                             uint32_t pipe_api_flags));
   MOCK_METHOD6(pipeMgrWredEntSet,
                pipe_status_t(pipe_sess_hdl_t sess_hdl,
                              dev_target_t dev_tgt,
@@ -980,6 +998,15 @@ class MockIPipeMgrIntf : public IPipeMgrIntf {
                              pipe_wred_idx_t red_idx,
                              pipe_wred_spec_t *wred_spec,
                              uint32_t pipe_api_flags));
+  MOCK_METHOD8(pipeMgrWredEntSetRange,
+               pipe_status_t(pipe_sess_hdl_t sess_hdl,
+                             dev_target_t dev_tgt,
+                             pipe_wred_tbl_hdl_t wred_tbl_hdl,
+                             pipe_wred_idx_t first_idx,
+                             uint32_t num_entries,
+                             pipe_wred_spec_t *wred_specs,
+                             uint32_t num_specs,
+                             uint32_t pipe_api_flags));
   MOCK_METHOD4(pipeMgrExmEntryActivate,
                pipe_status_t(pipe_sess_hdl_t sess_hdl,
                              bf_dev_id_t device_id,
@@ -1941,6 +1968,22 @@ class MockIPipeMgrIntf : public IPipeMgrIntf {
                bf_status_t(bf_dev_id_t dev_id,
                            bf_dev_port_t port_id,
                            uint32_t threshold));
+  GMOCK_INTERNAL_MOCK_METHODN(
+      ,
+      ,
+      pipeMgrSelGrpMbrsSetWeighted,
+      11,
+      pipe_status_t(pipe_sess_hdl_t sess_hdl,
+                    bf_dev_id_t device_id,
+                    pipe_sel_tbl_hdl_t sel_tbl_hdl,
+                    pipe_sel_grp_hdl_t sel_grp_hdl,
+                    uint32_t num_mbrs,
+                    pipe_adt_ent_hdl_t *mbrs,
+                    uint32_t *weights,
+                    bool *enable,
+                    uint32_t max_slots,
+                    pipe_sel_grp_weight_report_t *report,
+                    uint32_t pipe_api_flags));
   GMOCK_INTERNAL_MOCK_METHODN(
       ,
       ,
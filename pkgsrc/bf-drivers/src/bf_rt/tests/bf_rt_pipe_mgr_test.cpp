@@ -0,0 +1,490 @@
+/*******************************************************************************
+ *  Copyright (C) 2024 Intel Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing,
+ *  software distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions
+ *  and limitations under the License.
+ *
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include <pipe_mgr/pipe_mgr_intf.h>
+
+// Internal pipe_mgr routines exercised directly, they need no device.
+extern "C" {
+pipe_status_t pipe_mgr_sel_weights_reduce(uint32_t num_mbrs,
+                                          const uint32_t *weights,
+                                          uint32_t max_slots,
+                                          uint32_t *out_weights,
+                                          pipe_sel_grp_weight_report_t *rpt);
+uint32_t pipe_mgr_meter_range_run_len(const void *specs,
+                                      size_t spec_sz,
+                                      uint32_t num_specs,
+                                      uint32_t num_entries,
+                                      uint32_t i,
+                                      uint32_t stage_room);
+struct pipe_mgr_stful_sync_waiter;
+void pipe_mgr_stful_sync_complete(bf_dev_id_t dev,
+                                  pipe_stful_tbl_sync_cback_fn cb,
+                                  void *cookie,
+                                  struct pipe_mgr_stful_sync_waiter *waiters);
+pipe_status_t pipe_mgr_stful_sync_waiter_add(
+    struct pipe_mgr_stful_sync_waiter **waiters,
+    pipe_stful_tbl_sync_cback_fn cb,
+    void *cookie);
+pipe_status_t pipe_mgr_stful_export_alloc(dev_target_t dev_tgt,
+                                         pipe_stful_tbl_hdl_t hdl,
+                                         pipe_stful_export_mode_e mode,
+                                         pipe_stful_export_cback_fn cb,
+                                         void *cookie,
+                                         int width,
+                                         bool dbl_width,
+                                         int num_stages,
+                                         const uint32_t *num_entries,
+                                         const uint32_t *db_sz,
+                                         int num_pipes,
+                                         uint32_t pipe_msk,
+                                         pipe_stful_export_t **exp_p);
+bool pipe_mgr_stful_export_pipe_diff(pipe_stful_export_t *exp,
+                                     bf_dev_pipe_t pipe,
+                                     uint8_t *const *images);
+pipe_status_t pipe_mgr_stful_export_destroy(pipe_stful_export_t *exp);
+}
+
+namespace bfrt {
+namespace bfrt_test {
+
+namespace {
+pipe_status_t weightsReduce(const std::vector<uint32_t> &weights,
+                            uint32_t max_slots,
+                            std::vector<uint32_t> *out,
+                            pipe_sel_grp_weight_report_t *rpt) {
+  out->assign(weights.size(), 0);
+  return pipe_mgr_sel_weights_reduce(
+      weights.size(), weights.data(), max_slots, out->data(), rpt);
+}
+
+// Splits a range of a meter table, whose stages hold stage_sizes entries, into
+// the (first index, count) runs which pipe_mgr programs with one operation
+// each.
+std::vector<std::pair<uint32_t, uint32_t>> meterRangeRuns(
+    const std::vector<uint32_t> &stage_sizes,
+    uint32_t first_idx,
+    uint32_t num_entries,
+    const std::vector<pipe_meter_spec_t> &specs) {
+  std::vector<std::pair<uint32_t, uint32_t>> runs;
+  uint32_t n = 0;
+  for (uint32_t i = 0; i < num_entries; i += n) {
+    uint32_t idx = first_idx + i, stage_end = 0;
+    for (auto size : stage_sizes) {
+      stage_end += size;
+      if (idx < stage_end) break;
+    }
+    n = pipe_mgr_meter_range_run_len(specs.data(),
+                                     sizeof(pipe_meter_spec_t),
+                                     specs.size(),
+                                     num_entries,
+                                     i,
+                                     stage_end - idx);
+    runs.emplace_back(idx, n);
+  }
+  return runs;
+}
+
+pipe_meter_spec_t meterSpec(uint64_t cir_kbps) {
+  pipe_meter_spec_t spec = {};
+  spec.meter_type = METER_TYPE_COLOR_UNAWARE;
+  spec.cir.type = METER_RATE_TYPE_KBPS;
+  spec.cir.value.kbps = cir_kbps;
+  spec.pir = spec.cir;
+  spec.cburst = spec.pburst = 100;
+  return spec;
+}
+
+// Reports handed to a stateful export callback, with their changes copied
+// out of the export's buffer.
+struct ExportReport {
+  bf_dev_pipe_t pipe;
+  bool last;
+  uint64_t sum_lo;
+  std::vector<std::pair<uint32_t, uint32_t>> changes;  // (index, word)
+};
+
+void exportCb(bf_dev_id_t,
+              const pipe_stful_export_report_t *r,
+              void *cookie) {
+  auto *reports = static_cast<std::vector<ExportReport> *>(cookie);
+  ExportReport x = {r->pipe, r->last, r->sum_lo, {}};
+  // Sums mode only counts the changes.
+  for (uint32_t i = 0; r->changes && i < r->num_changes; ++i)
+    x.changes.emplace_back(r->changes[i].index, r->changes[i].value.word);
+  if (!r->changes) x.changes.resize(r->num_changes);
+  reports->push_back(x);
+}
+
+// A stage's synced data for a table of 32 bit cells, four cells to a line.
+struct StageImage {
+  explicit StageImage(uint32_t entries) : bytes(entries * 4) {}
+  void set(uint32_t idx, uint32_t v) { std::memcpy(&bytes[idx * 4], &v, 4); }
+  uint32_t size() const { return bytes.size(); }
+  std::vector<uint8_t> bytes;
+};
+
+std::vector<ExportReport> exportDiff(pipe_stful_export_t *exp,
+                                     std::vector<ExportReport> *reports,
+                                     bf_dev_pipe_t pipe,
+                                     std::vector<StageImage *> stages) {
+  std::vector<uint8_t *> images;
+  for (auto *s : stages) images.push_back(s ? s->bytes.data() : nullptr);
+  reports->clear();
+  EXPECT_TRUE(pipe_mgr_stful_export_pipe_diff(exp, pipe, images.data()));
+  return *reports;
+}
+
+std::vector<int> sync_order;
+void syncCb(bf_dev_id_t, void *cookie) {
+  sync_order.push_back(static_cast<int>(reinterpret_cast<intptr_t>(cookie)));
+}
+}  // anonymous namespace
+
+TEST(PipeMgrSelWeightsTest, FitsWithoutReduction) {
+  std::vector<uint32_t> out;
+  pipe_sel_grp_weight_report_t rpt = {};
+
+  // Only the common divisor is taken out, shares are exact.
+  ASSERT_EQ(weightsReduce({2, 4, 6}, 16, &out, &rpt), PIPE_SUCCESS);
+  EXPECT_EQ(out, std::vector<uint32_t>({1, 2, 3}));
+  EXPECT_EQ(rpt.requested_total, 12u);
+  EXPECT_EQ(rpt.achieved_total, 6u);
+  EXPECT_EQ(rpt.max_share_error_ppm, 0u);
+
+  // A total equal to the group size is kept as is.
+  ASSERT_EQ(weightsReduce({3, 5}, 8, &out, &rpt), PIPE_SUCCESS);
+  EXPECT_EQ(out, std::vector<uint32_t>({3, 5}));
+  EXPECT_EQ(rpt.achieved_total, 8u);
+  EXPECT_EQ(rpt.max_share_error_ppm, 0u);
+}
+
+TEST(PipeMgrSelWeightsTest, ForcedReduction) {
+  std::vector<uint32_t> out;
+  pipe_sel_grp_weight_report_t rpt = {};
+
+  // 5:3:2 in 7 slots, the spare slot goes to the largest remainder.
+  ASSERT_EQ(weightsReduce({50, 30, 20}, 7, &out, &rpt), PIPE_SUCCESS);
+  EXPECT_EQ(out, std::vector<uint32_t>({4, 2, 1}));
+  EXPECT_EQ(rpt.requested_total, 100u);
+  EXPECT_EQ(rpt.achieved_total, 7u);
+  // 4/7 against 1/2 is the largest error, within one slot.
+  EXPECT_EQ(rpt.max_share_error_ppm, 71429u);
+  EXPECT_LE(rpt.max_share_error_ppm, 1000000u / 7);
+}
+
+TEST(PipeMgrSelWeightsTest, ZeroWeightAndTooManyMembers) {
+  std::vector<uint32_t> out;
+
+  EXPECT_EQ(weightsReduce({1, 0, 2}, 16, &out, nullptr), PIPE_INVALID_ARG);
+  EXPECT_EQ(weightsReduce({1, 1, 1}, 2, &out, nullptr), PIPE_NO_SPACE);
+  // An empty membership is valid and uses no slots.
+  pipe_sel_grp_weight_report_t rpt = {};
+  EXPECT_EQ(weightsReduce({}, 4, &out, &rpt), PIPE_SUCCESS);
+  EXPECT_EQ(rpt.achieved_total, 0u);
+}
+
+TEST(PipeMgrSelWeightsTest, MemberRoundedToZeroKeepsOneSlot) {
+  std::vector<uint32_t> out;
+  pipe_sel_grp_weight_report_t rpt = {};
+
+  ASSERT_EQ(weightsReduce({1000, 1}, 10, &out, &rpt), PIPE_SUCCESS);
+  EXPECT_EQ(out, std::vector<uint32_t>({9, 1}));
+  EXPECT_EQ(rpt.achieved_total, 10u);
+
+  // The minimum slots overcommit the group and are taken back from the
+  // heavy member.
+  ASSERT_EQ(weightsReduce({1, 1, 1, 100}, 4, &out, &rpt), PIPE_SUCCESS);
+  EXPECT_EQ(out, std::vector<uint32_t>({1, 1, 1, 1}));
+  EXPECT_EQ(rpt.achieved_total, 4u);
+}
+
+TEST(PipeMgrSelWeightsTest, TiesGoToTheLowerIndex) {
+  std::vector<uint32_t> out;
+  pipe_sel_grp_weight_report_t rpt = {};
+
+  // 4:4:4:1 in 8 slots, the three equal remainders compete for one slot.
+  ASSERT_EQ(weightsReduce({4, 4, 4, 1}, 8, &out, &rpt), PIPE_SUCCESS);
+  EXPECT_EQ(out, std::vector<uint32_t>({3, 2, 2, 1}));
+  EXPECT_EQ(rpt.achieved_total, 8u);
+
+  // Ties are broken by member position, not by weight order.
+  ASSERT_EQ(weightsReduce({1, 4, 4, 4}, 8, &out, &rpt), PIPE_SUCCESS);
+  EXPECT_EQ(out, std::vector<uint32_t>({1, 3, 2, 2}));
+}
+
+using MeterRuns = std::vector<std::pair<uint32_t, uint32_t>>;
+
+TEST(PipeMgrMeterRangeTest, SharedSpecIsOneRunPerStage) {
+  std::vector<pipe_meter_spec_t> one = {meterSpec(1000)};
+
+  EXPECT_EQ(meterRangeRuns({1024}, 0, 1024, one), MeterRuns({{0, 1024}}));
+  EXPECT_EQ(meterRangeRuns({1024}, 10, 5, one), MeterRuns({{10, 5}}));
+  // A range crossing into the next stage is split at the stage boundary.
+  EXPECT_EQ(meterRangeRuns({100, 100}, 90, 20, one),
+            MeterRuns({{90, 10}, {100, 10}}));
+  EXPECT_EQ(meterRangeRuns({4, 4, 4}, 2, 8, one),
+            MeterRuns({{2, 2}, {4, 4}, {8, 2}}));
+}
+
+TEST(PipeMgrMeterRangeTest, PerEntrySpecsMergeEqualNeighbours) {
+  auto a = meterSpec(1000), b = meterSpec(2000);
+
+  EXPECT_EQ(meterRangeRuns({1024}, 0, 6, {a, a, b, b, b, a}),
+            MeterRuns({{0, 2}, {2, 3}, {5, 1}}));
+  // Equal specs which are not neighbours are separate runs.
+  EXPECT_EQ(meterRangeRuns({1024}, 7, 4, {a, b, a, b}),
+            MeterRuns({{7, 1}, {8, 1}, {9, 1}, {10, 1}}));
+  // Equal specs given for every entry are a single run.
+  EXPECT_EQ(meterRangeRuns({1024}, 0, 3, {b, b, b}), MeterRuns({{0, 3}}));
+  // The stage boundary still splits a run of equal specs.
+  EXPECT_EQ(meterRangeRuns({3, 3}, 1, 4, {a, a, a, a}),
+            MeterRuns({{1, 2}, {3, 2}}));
+}
+
+TEST(PipeMgrMeterRangeTest, RunLengthBounds) {
+  auto a = meterSpec(1000);
+  std::vector<pipe_meter_spec_t> specs(8, a);
+
+  // The last entry of a range is a run of its own.
+  EXPECT_EQ(pipe_mgr_meter_range_run_len(
+                specs.data(), sizeof(a), specs.size(), 8, 7, 100),
+            1u);
+  // A run never goes past the room left in the stage.
+  EXPECT_EQ(pipe_mgr_meter_range_run_len(
+                specs.data(), sizeof(a), specs.size(), 8, 0, 3),
+            3u);
+  EXPECT_EQ(
+      pipe_mgr_meter_range_run_len(specs.data(), sizeof(a), 1, 8, 2, 100),
+      6u);
+}
+
+using ExportChanges = std::vector<std::pair<uint32_t, uint32_t>>;
+
+TEST(PipeMgrStfulExportTest, ReportsOnlyChangedCells) {
+  std::vector<ExportReport> reports;
+  StageImage s0(16), s1(8);
+  std::vector<uint32_t> entries = {16, 8}, db_sz = {s0.size(), s1.size()};
+  pipe_stful_export_t *exp = nullptr;
+  dev_target_t tgt = {0, BF_DEV_PIPE_ALL};
+  // Only pipe 1 of two is exported.
+  ASSERT_EQ(pipe_mgr_stful_export_alloc(tgt,
+                                        1,
+                                        PIPE_STFUL_EXPORT_CHANGES,
+                                        exportCb,
+                                        &reports,
+                                        32,
+                                        false,
+                                        2,
+                                        entries.data(),
+                                        db_sz.data(),
+                                        2,
+                                        1u << 1,
+                                        &exp),
+            PIPE_SUCCESS);
+
+  // A table of zeros matches the initial baseline.
+  auto r = exportDiff(exp, &reports, 1, {&s0, &s1});
+  ASSERT_EQ(r.size(), 1u);
+  EXPECT_TRUE(r[0].last);
+  EXPECT_EQ(r[0].pipe, 1u);
+  EXPECT_TRUE(r[0].changes.empty());
+
+  // Indices of later stages follow on from the earlier stages.
+  s0.set(3, 7);
+  s1.set(2, 9);
+  r = exportDiff(exp, &reports, 1, {&s0, &s1});
+  ASSERT_EQ(r.size(), 1u);
+  EXPECT_EQ(r[0].changes, ExportChanges({{3, 7}, {18, 9}}));
+
+  // The baseline moved on, an unchanged table reports nothing.
+  r = exportDiff(exp, &reports, 1, {&s0, &s1});
+  ASSERT_EQ(r.size(), 1u);
+  EXPECT_TRUE(r[0].changes.empty());
+
+  // A cell changed back is reported, other cells in its line are not.
+  s0.set(3, 0);
+  s0.set(15, 1);
+  r = exportDiff(exp, &reports, 1, {&s0, &s1});
+  ASSERT_EQ(r.size(), 1u);
+  EXPECT_EQ(r[0].changes, ExportChanges({{3, 0}, {15, 1}}));
+
+  // A stage which was not read is skipped and keeps its baseline.
+  s1.set(7, 5);
+  r = exportDiff(exp, &reports, 1, {&s0, nullptr});
+  EXPECT_TRUE(r[0].changes.empty());
+  r = exportDiff(exp, &reports, 1, {&s0, &s1});
+  EXPECT_EQ(r[0].changes, ExportChanges({{23, 5}}));
+
+  EXPECT_EQ(pipe_mgr_stful_export_destroy(exp), PIPE_SUCCESS);
+}
+
+TEST(PipeMgrStfulExportTest, LargeDiffsAreChunked) {
+  std::vector<ExportReport> reports;
+  const uint32_t n = 1200;
+  StageImage s0(n);
+  std::vector<uint32_t> entries = {n}, db_sz = {s0.size()};
+  pipe_stful_export_t *exp = nullptr;
+  dev_target_t tgt = {0, 0};
+  ASSERT_EQ(pipe_mgr_stful_export_alloc(tgt,
+                                        1,
+                                        PIPE_STFUL_EXPORT_CHANGES,
+                                        exportCb,
+                                        &reports,
+                                        32,
+                                        false,
+                                        1,
+                                        entries.data(),
+                                        db_sz.data(),
+                                        1,
+                                        1,
+                                        &exp),
+            PIPE_SUCCESS);
+  for (uint32_t i = 0; i < n; ++i) s0.set(i, i + 1);
+
+  auto r = exportDiff(exp, &reports, 0, {&s0});
+  ASSERT_EQ(r.size(), 2u);
+  EXPECT_FALSE(r[0].last);
+  EXPECT_EQ(r[0].changes.size(), 1024u);
+  EXPECT_TRUE(r[1].last);
+  EXPECT_EQ(r[1].changes.size(), n - 1024);
+  // Every cell is reported once, in index order.
+  uint32_t next = 0;
+  for (auto &x : r) {
+    for (auto &c : x.changes) {
+      EXPECT_EQ(c.first, next);
+      EXPECT_EQ(c.second, next + 1);
+      ++next;
+    }
+  }
+  EXPECT_EQ(next, n);
+
+  EXPECT_EQ(pipe_mgr_stful_export_destroy(exp), PIPE_SUCCESS);
+}
+
+TEST(PipeMgrStfulExportTest, SumsModeKeepsRunningTotals) {
+  std::vector<ExportReport> reports;
+  StageImage s0(8);
+  std::vector<uint32_t> entries = {8}, db_sz = {s0.size()};
+  pipe_stful_export_t *exp = nullptr;
+  dev_target_t tgt = {0, 0};
+  ASSERT_EQ(pipe_mgr_stful_export_alloc(tgt,
+                                        1,
+                                        PIPE_STFUL_EXPORT_SUMS,
+                                        exportCb,
+                                        &reports,
+                                        32,
+                                        false,
+                                        1,
+                                        entries.data(),
+                                        db_sz.data(),
+                                        1,
+                                        1,
+                                        &exp),
+            PIPE_SUCCESS);
+
+  s0.set(0, 10);
+  s0.set(5, 5);
+  auto r = exportDiff(exp, &reports, 0, {&s0});
+  ASSERT_EQ(r.size(), 1u);
+  EXPECT_EQ(r[0].sum_lo, 15u);
+  EXPECT_EQ(r[0].changes.size(), 2u);
+
+  // Only the delta of the changed cell is applied.
+  s0.set(0, 4);
+  r = exportDiff(exp, &reports, 0, {&s0});
+  ASSERT_EQ(r.size(), 1u);
+  EXPECT_EQ(r[0].sum_lo, 9u);
+  EXPECT_EQ(r[0].changes.size(), 1u);
+
+  EXPECT_EQ(pipe_mgr_stful_export_destroy(exp), PIPE_SUCCESS);
+}
+
+TEST(PipeMgrStfulExportTest, BadArguments) {
+  std::vector<uint32_t> entries = {8}, db_sz = {32};
+  pipe_stful_export_t *exp = nullptr;
+  dev_target_t tgt = {0, 0};
+  EXPECT_EQ(pipe_mgr_stful_export_alloc(tgt,
+                                        1,
+                                        PIPE_STFUL_EXPORT_SUMS,
+                                        nullptr,
+                                        nullptr,
+                                        32,
+                                        false,
+                                        1,
+                                        entries.data(),
+                                        db_sz.data(),
+                                        1,
+                                        1,
+                                        &exp),
+            PIPE_INVALID_ARG);
+  auto bad_mode = static_cast<pipe_stful_export_mode_e>(7);
+  EXPECT_EQ(pipe_mgr_stful_export_alloc(tgt,
+                                        1,
+                                        bad_mode,
+                                        exportCb,
+                                        nullptr,
+                                        32,
+                                        false,
+                                        1,
+                                        entries.data(),
+                                        db_sz.data(),
+                                        1,
+                                        1,
+                                        &exp),
+            PIPE_INVALID_ARG);
+}
+
+TEST(PipeMgrStfulSyncTest, JoinedWaitersFollowTheRequester) {
+  struct pipe_mgr_stful_sync_waiter *waiters = nullptr;
+  EXPECT_EQ(pipe_mgr_stful_sync_waiter_add(&waiters, nullptr, nullptr),
+            PIPE_INVALID_ARG);
+  EXPECT_EQ(waiters, nullptr);
+  for (intptr_t i = 1; i <= 3; ++i) {
+    ASSERT_EQ(pipe_mgr_stful_sync_waiter_add(
+                  &waiters, syncCb, reinterpret_cast<void *>(i)),
+              PIPE_SUCCESS);
+  }
+
+  // The request which started the sync completes first, then the waiters in
+  // the order they joined.
+  sync_order.clear();
+  pipe_mgr_stful_sync_complete(0, syncCb, reinterpret_cast<void *>(0), waiters);
+  EXPECT_EQ(sync_order, std::vector<int>({0, 1, 2, 3}));
+
+  // A sync with no asynchronous requester, or one abandoned by a table
+  // delete, still releases its waiters.
+  waiters = nullptr;
+  ASSERT_EQ(pipe_mgr_stful_sync_waiter_add(
+                &waiters, syncCb, reinterpret_cast<void *>(4)),
+            PIPE_SUCCESS);
+  sync_order.clear();
+  pipe_mgr_stful_sync_complete(0, nullptr, nullptr, waiters);
+  EXPECT_EQ(sync_order, std::vector<int>({4}));
+}
+
+}  // namespace bfrt_test
+}  // namespace bfrt
@@ -49,6 +49,7 @@ using ::testing::_;
 using ::testing::AtLeast;
 using ::testing::DoAll;
 using ::testing::Invoke;
+using ::testing::InSequence;
 using ::testing::InvokeWithoutArgs;
 using ::testing::WithArgs;
 
@@ -2815,5 +2816,99 @@ TEST_P(BfRtPREMulticastNodeTableTest, EntryAllocateGet) {
   }
 }
 
+void BfRtMeterTableTest::meterEntryForm(const BfRtTable &table,
+                                        const uint32_t &idx,
+                                        const uint64_t &cir_kbps,
+                                        std::unique_ptr<BfRtTableKey> *key,
+                                        std::unique_ptr<BfRtTableData> *data) {
+  bf_rt_id_t field_id;
+  ASSERT_SUCCESS(table.keyAllocate(key));
+  ASSERT_SUCCESS(table.dataAllocate(data));
+  ASSERT_SUCCESS(table.keyFieldIdGet("$METER_INDEX", &field_id));
+  ASSERT_SUCCESS((*key)->setValue(field_id, static_cast<uint64_t>(idx)));
+  ASSERT_SUCCESS(table.dataFieldIdGet("$METER_SPEC_CIR_KBPS", &field_id));
+  ASSERT_SUCCESS((*data)->setValue(field_id, cir_kbps));
+  ASSERT_SUCCESS(table.dataFieldIdGet("$METER_SPEC_PIR_KBPS", &field_id));
+  ASSERT_SUCCESS((*data)->setValue(field_id, cir_kbps));
+  ASSERT_SUCCESS(table.dataFieldIdGet("$METER_SPEC_CBS_KBITS", &field_id));
+  ASSERT_SUCCESS((*data)->setValue(field_id, static_cast<uint64_t>(100)));
+  ASSERT_SUCCESS(table.dataFieldIdGet("$METER_SPEC_PBS_KBITS", &field_id));
+  ASSERT_SUCCESS((*data)->setValue(field_id, static_cast<uint64_t>(100)));
+}
+
+TEST_P(BfRtMeterTableTest, EntryModMulti) {
+  for (const auto *table_p : this->d_tables) {
+    const auto &table = *table_p;
+    std::string table_name;
+    EXPECT_SUCCESS(table.tableNameGet(&table_name));
+    std::cout << ">>>>> Testing "
+              << "Entry Mod Multi"
+              << " for Table " << table_name << " <<<<<<\n";
+
+    // Index 4 is given twice and the later data wins, the other indices
+    // form the runs 3-5 and 9-10. Entry i has a CIR of 1000 + i.
+    const std::vector<uint32_t> idxs = {5, 3, 4, 9, 4, 10};
+    std::vector<std::unique_ptr<BfRtTableKey>> keys(idxs.size());
+    std::vector<std::unique_ptr<BfRtTableData>> datas(idxs.size());
+    BfRtTable::constKeyDataPairs pairs;
+    for (uint32_t i = 0; i < idxs.size(); i++) {
+      meterEntryForm(table, idxs[i], 1000 + i, &keys[i], &datas[i]);
+      pairs.emplace_back(keys[i].get(), datas[i].get());
+    }
+
+    auto expect_run = [this](uint32_t first_idx,
+                             const std::vector<uint64_t> &cirs,
+                             pipe_status_t sts) {
+      EXPECT_CALL(*pipe_mgr_obj,
+                  pipeMgrMeterEntSetRange(
+                      _, _, _, first_idx, cirs.size(), _, cirs.size(), _))
+          .WillOnce(WithArgs<5>(Invoke([cirs, sts](pipe_meter_spec_t *specs) {
+            for (uint32_t i = 0; i < cirs.size(); i++) {
+              EXPECT_EQ(specs[i].cir.type, METER_RATE_TYPE_KBPS);
+              EXPECT_EQ(specs[i].cir.value.kbps, cirs[i]);
+              EXPECT_EQ(specs[i].cburst, 100u);
+            }
+            return sts;
+          })));
+    };
+    EXPECT_CALL(*pipe_mgr_obj, pipeMgrMeterEntSet(_, _, _, _, _, _)).Times(0);
+    {
+      InSequence seq;
+      expect_run(3, {1001, 1004, 1000}, PIPE_SUCCESS);
+      expect_run(9, {1003, 1005}, PIPE_SUCCESS);
+    }
+    EXPECT_SUCCESS(table.tableEntryModMulti(
+        getDefaultSession(), getDefaultBfRtTarget(), 0, pairs));
+    Mock::VerifyAndClearExpectations(pipe_mgr_obj);
+
+    // A failed run stops the update, the later runs are not programmed.
+    {
+      InSequence seq;
+      expect_run(3, {1001, 1004, 1000}, PIPE_NO_SYS_RESOURCES);
+    }
+    EXPECT_EQ(table.tableEntryModMulti(
+                  getDefaultSession(), getDefaultBfRtTarget(), 0, pairs),
+              BF_NO_SYS_RESOURCES);
+    Mock::VerifyAndClearExpectations(pipe_mgr_obj);
+
+    // An index past the end of the table fails the whole call before
+    // anything is programmed.
+    size_t table_size = 0;
+    EXPECT_SUCCESS(table.tableSizeGet(
+        getDefaultSession(), getDefaultBfRtTarget(), 0, &table_size));
+    std::unique_ptr<BfRtTableKey> bad_key;
+    std::unique_ptr<BfRtTableData> bad_data;
+    meterEntryForm(table, table_size, 2000, &bad_key, &bad_data);
+    pairs.emplace_back(bad_key.get(), bad_data.get());
+    EXPECT_CALL(*pipe_mgr_obj,
+                pipeMgrMeterEntSetRange(_, _, _, _, _, _, _, _))
+        .Times(0);
+    EXPECT_EQ(table.tableEntryModMulti(
+                  getDefaultSession(), getDefaultBfRtTarget(), 0, pairs),
+              BF_INVALID_ARG);
+    Mock::VerifyAndClearExpectations(pipe_mgr_obj);
+  }
+}
+
 }  // namespace bfrt_test
 }  // namespace bfrt
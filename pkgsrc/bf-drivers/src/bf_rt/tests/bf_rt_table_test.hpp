@@ -1030,6 +1030,37 @@ INSTANTIATE_TEST_CASE_P(PREMulticastNodeTableTestSuite,
                             NUM_ENTRIES,
                             "tna_multicast")));
 
+class BfRtMeterTableTest : public BfRtTableTest {
+ protected:
+  BfRtMeterTableTest() {}
+  void SetUp() override {
+    // Call SetUp of the parent
+    BfRtTableTest::SetUp();
+    // Get all the indirect meter tables
+    getTablesOfAType(BfRtTable::TableType::METER, &d_tables);
+    // Set the table type
+    table_type = BfRtTable::TableType::METER;
+  }
+
+  // Allocates a key and data object for a meter entry at idx whose CIR and
+  // PIR are cir_kbps.
+  void meterEntryForm(const BfRtTable &table,
+                      const uint32_t &idx,
+                      const uint64_t &cir_kbps,
+                      std::unique_ptr<BfRtTableKey> *key,
+                      std::unique_ptr<BfRtTableData> *data);
+
+  std::vector<BfRtTable *> d_tables;
+};  // BfRtMeterTableTest
+
+INSTANTIATE_TEST_CASE_P(MeterTableTNAMeterLpfWredTestSuite,
+                        BfRtMeterTableTest,
+                        ::testing::Values(std::make_tuple(
+                            "bf-rt.json",
+                            std::vector<std::string>{"pipe/context.json"},
+                            NUM_ENTRIES,
+                            "tna_meter_lpf_wred")));
+
 // This class is mainly concerned with doing some initial setup for running
 // any test on a particular table. In the destructor of this class, we focibly
 // verify expectations on the mock object for that table.
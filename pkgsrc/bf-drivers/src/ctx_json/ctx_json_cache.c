@@ -0,0 +1,477 @@
+/*******************************************************************************
+ *  Copyright (C) 2024 Intel Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing,
+ *  software distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions
+ *  and limitations under the License.
+ *
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+
+/**
+ * @file ctx_json_cache.c
+ *
+ * Binary cache of parsed Context JSON trees.
+ *
+ * Cache file layout, all integers in host byte order:
+ *   ctx_json_cache_hdr_t
+ *   ctx_json_cache_node_t[num_nodes]  (pre-order, node 0 is the root)
+ *   char strings[strings_size]        (NUL terminated, keys deduplicated)
+ *
+ * Nodes refer to each other and to strings by index/offset plus one, zero
+ * meaning none, so the file can be used from any address. Pre-order
+ * numbering means a valid child or sibling always has a larger index than
+ * the node referring to it, which rules out cycles in a damaged file.
+ *
+ * Value strings are never shared: parsers such as PIPE_MGR_PARSE_CFG_NAME
+ * tokenize them in place, so every tree gets a writable copy of the string
+ * table and every value its own bytes in it.
+ */
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <bf_types/bf_types.h>
+#include <target-sys/bf_sal/bf_sys_intf.h>
+#include <target-utils/third-party/xxHash/xxhash.h>
+
+#include <ctx_json/ctx_json_cache.h>
+#include <ctx_json/ctx_json_reader.h>
+#include "ctx_json_log.h"
+
+/* Reads as "CBXJ"; a cache from a host of the other byte order mismatches. */
+#define CTX_JSON_CACHE_MAGIC 0x4a584243u
+#define CTX_JSON_CACHE_INIT_SLOTS 4096
+
+typedef struct ctx_json_cache_hdr_s {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t json_hash;
+  uint64_t json_size;
+  uint64_t payload_hash;
+  uint32_t num_nodes;
+  uint32_t strings_size;
+} ctx_json_cache_hdr_t;
+
+typedef struct ctx_json_cache_node_s {
+  double valuedouble;
+  int32_t type;
+  int32_t valueint;
+  uint32_t child;
+  uint32_t next;
+  uint32_t string;
+  uint32_t valuestring;
+} ctx_json_cache_node_t;
+
+struct ctx_json_file_s {
+  cJSON *root;
+  bool from_cache;
+  size_t json_size;
+  /* Only set for trees rebuilt from a cache. */
+  cJSON *nodes;
+  char *strings;
+};
+
+typedef struct ctx_json_cache_writer_s {
+  ctx_json_cache_node_t *nodes;
+  uint32_t num_nodes;
+  uint32_t max_nodes;
+  char *strings;
+  size_t strings_size;
+  size_t max_strings_size;
+  /* Open addressing table of string offsets + 1 used to deduplicate keys. */
+  uint32_t *slots;
+  uint32_t num_slots;
+  uint32_t used_slots;
+} ctx_json_cache_writer_t;
+
+static char ctx_json_cache_dir[PATH_MAX];
+
+void ctx_json_cache_dir_set(const char *dir) {
+  if (dir == NULL) {
+    ctx_json_cache_dir[0] = '\0';
+    return;
+  }
+  snprintf(ctx_json_cache_dir, sizeof(ctx_json_cache_dir), "%s", dir);
+}
+
+const char *ctx_json_cache_dir_get(void) {
+  return ctx_json_cache_dir[0] ? ctx_json_cache_dir : NULL;
+}
+
+static const void *ctx_json_map_file(const char *path, size_t *size) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) return NULL;
+  struct stat stat_b;
+  if (fstat(fd, &stat_b) || stat_b.st_size == 0) {
+    close(fd);
+    return NULL;
+  }
+  void *map = mmap(NULL, stat_b.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) return NULL;
+  *size = stat_b.st_size;
+  return map;
+}
+
+static void ctx_json_cache_path(uint64_t json_hash, char *buf, size_t len) {
+  snprintf(buf,
+           len,
+           "%s/ctx_json_%016" PRIx64 ".cache",
+           ctx_json_cache_dir,
+           json_hash);
+}
+
+/* Rebuilds the tree from a mapped cache file. Returns NULL if the file does
+ * not exist or does not match the Context JSON it is looked up for. */
+static cJSON *ctx_json_cache_read(const char *cache_path,
+                                  uint64_t json_hash,
+                                  size_t json_size,
+                                  ctx_json_file_t *file) {
+  size_t size;
+  const uint8_t *map = ctx_json_map_file(cache_path, &size);
+  if (map == NULL) return NULL;
+
+  const ctx_json_cache_hdr_t *hdr = (const ctx_json_cache_hdr_t *)map;
+  if (size < sizeof(*hdr) || hdr->magic != CTX_JSON_CACHE_MAGIC ||
+      hdr->version != CTX_JSON_CACHE_VERSION ||
+      hdr->json_hash != json_hash || hdr->json_size != json_size) {
+    goto invalid;
+  }
+  uint64_t nodes_size =
+      (uint64_t)hdr->num_nodes * sizeof(ctx_json_cache_node_t);
+  if (hdr->num_nodes == 0 || hdr->strings_size == 0 ||
+      sizeof(*hdr) + nodes_size + hdr->strings_size != size) {
+    goto invalid;
+  }
+  const ctx_json_cache_node_t *recs =
+      (const ctx_json_cache_node_t *)(map + sizeof(*hdr));
+  const char *map_strings = (const char *)(recs + hdr->num_nodes);
+  if (map_strings[hdr->strings_size - 1] != '\0' ||
+      XXH64(recs, nodes_size + hdr->strings_size, 0) != hdr->payload_hash) {
+    goto invalid;
+  }
+
+  uint32_t num_nodes = hdr->num_nodes;
+  cJSON *nodes = bf_sys_calloc(num_nodes, sizeof(cJSON));
+  char *strings = bf_sys_malloc(hdr->strings_size);
+  if (nodes == NULL || strings == NULL) {
+    if (nodes) bf_sys_free(nodes);
+    if (strings) bf_sys_free(strings);
+    munmap((void *)map, size);
+    return NULL;
+  }
+  memcpy(strings, map_strings, hdr->strings_size);
+  for (uint32_t i = 0; i < num_nodes; i++) {
+    const ctx_json_cache_node_t *rec = &recs[i];
+    cJSON *node = &nodes[i];
+    if ((rec->child && (rec->child <= i + 1 || rec->child > num_nodes)) ||
+        (rec->next && (rec->next <= i + 1 || rec->next > num_nodes)) ||
+        rec->string > hdr->strings_size ||
+        rec->valuestring > hdr->strings_size) {
+      bf_sys_free(nodes);
+      bf_sys_free(strings);
+      goto invalid;
+    }
+    node->type = rec->type;
+    node->valueint = rec->valueint;
+    node->valuedouble = rec->valuedouble;
+    node->child = rec->child ? &nodes[rec->child - 1] : NULL;
+    node->next = rec->next ? &nodes[rec->next - 1] : NULL;
+    node->string = rec->string ? strings + rec->string - 1 : NULL;
+    node->valuestring =
+        rec->valuestring ? strings + rec->valuestring - 1 : NULL;
+  }
+  /* cJSON links siblings both ways and the first child's prev points to the
+   * last child. */
+  for (uint32_t i = 0; i < num_nodes; i++) {
+    cJSON *child = nodes[i].child;
+    if (child == NULL) continue;
+    cJSON *last = child;
+    while (last->next) {
+      last->next->prev = last;
+      last = last->next;
+    }
+    child->prev = last;
+  }
+  munmap((void *)map, size);
+  if (ctx_json_reader_attach(nodes, num_nodes)) {
+    bf_sys_free(nodes);
+    bf_sys_free(strings);
+    return NULL;
+  }
+
+  file->nodes = nodes;
+  file->strings = strings;
+  return &nodes[0];
+
+invalid:
+  LOG_DBG("%s: Ignoring stale Context JSON cache %s", __func__, cache_path);
+  munmap((void *)map, size);
+  return NULL;
+}
+
+static bool ctx_json_cache_slots_grow(ctx_json_cache_writer_t *w) {
+  uint32_t num_slots = w->num_slots ? w->num_slots * 2
+                                    : CTX_JSON_CACHE_INIT_SLOTS;
+  uint32_t *slots = bf_sys_calloc(num_slots, sizeof(uint32_t));
+  if (slots == NULL) return false;
+  for (uint32_t i = 0; i < w->num_slots; i++) {
+    if (w->slots[i] == 0) continue;
+    const char *s = w->strings + w->slots[i] - 1;
+    uint32_t idx = XXH64(s, strlen(s), 0) & (num_slots - 1);
+    while (slots[idx]) idx = (idx + 1) & (num_slots - 1);
+    slots[idx] = w->slots[i];
+  }
+  if (w->slots) bf_sys_free(w->slots);
+  w->slots = slots;
+  w->num_slots = num_slots;
+  return true;
+}
+
+/* Returns the string table offset + 1 of s, 0 for NULL or on error. Only
+ * keys are deduplicated, values may be modified by their readers. */
+static uint32_t ctx_json_cache_string_add(ctx_json_cache_writer_t *w,
+                                          const char *s,
+                                          bool dedup,
+                                          bool *ok) {
+  if (s == NULL) return 0;
+  if (dedup && 2 * (w->used_slots + 1) > w->num_slots &&
+      !ctx_json_cache_slots_grow(w)) {
+    *ok = false;
+    return 0;
+  }
+  size_t len = strlen(s);
+  uint32_t idx = 0;
+  if (dedup) {
+    idx = XXH64(s, len, 0) & (w->num_slots - 1);
+    while (w->slots[idx]) {
+      if (!strcmp(w->strings + w->slots[idx] - 1, s)) return w->slots[idx];
+      idx = (idx + 1) & (w->num_slots - 1);
+    }
+  }
+  if (w->strings_size + len + 1 >= UINT32_MAX) {
+    *ok = false;
+    return 0;
+  }
+  if (w->strings_size + len + 1 > w->max_strings_size) {
+    size_t max = w->max_strings_size ? w->max_strings_size * 2 : 1 << 16;
+    while (max < w->strings_size + len + 1) max *= 2;
+    char *strings = bf_sys_realloc(w->strings, max);
+    if (strings == NULL) {
+      *ok = false;
+      return 0;
+    }
+    w->strings = strings;
+    w->max_strings_size = max;
+  }
+  uint32_t off = w->strings_size + 1;
+  memcpy(w->strings + w->strings_size, s, len + 1);
+  w->strings_size += len + 1;
+  if (dedup) {
+    w->slots[idx] = off;
+    w->used_slots++;
+  }
+  return off;
+}
+
+/* Appends item and its subtree in pre-order. */
+static bool ctx_json_cache_node_add(ctx_json_cache_writer_t *w,
+                                    const cJSON *item,
+                                    uint32_t *index) {
+  if (w->num_nodes == w->max_nodes) {
+    if (w->max_nodes >= UINT32_MAX / 2) return false;
+    uint32_t max = w->max_nodes ? w->max_nodes * 2 : 1 << 12;
+    ctx_json_cache_node_t *nodes =
+        bf_sys_realloc(w->nodes, max * sizeof(ctx_json_cache_node_t));
+    if (nodes == NULL) return false;
+    w->nodes = nodes;
+    w->max_nodes = max;
+  }
+  uint32_t i = w->num_nodes++;
+  bool ok = true;
+  memset(&w->nodes[i], 0, sizeof(w->nodes[i]));
+  w->nodes[i].type = item->type;
+  w->nodes[i].valueint = item->valueint;
+  w->nodes[i].valuedouble = item->valuedouble;
+  w->nodes[i].string = ctx_json_cache_string_add(w, item->string, true, &ok);
+  w->nodes[i].valuestring =
+      ctx_json_cache_string_add(w, item->valuestring, false, &ok);
+  if (!ok) return false;
+
+  /* Indices rather than pointers, the node array moves as it grows. */
+  uint32_t prev = UINT32_MAX;
+  for (const cJSON *c = item->child; c; c = c->next) {
+    uint32_t ci;
+    if (!ctx_json_cache_node_add(w, c, &ci)) return false;
+    if (prev == UINT32_MAX) {
+      w->nodes[i].child = ci + 1;
+    } else {
+      w->nodes[prev].next = ci + 1;
+    }
+    prev = ci;
+  }
+  *index = i;
+  return true;
+}
+
+static bool ctx_json_write_all(int fd, const void *buf, size_t len) {
+  const char *p = buf;
+  while (len) {
+    ssize_t written = write(fd, p, len);
+    if (written < 0) return false;
+    p += written;
+    len -= written;
+  }
+  return true;
+}
+
+static void ctx_json_cache_write(const char *cache_path,
+                                 uint64_t json_hash,
+                                 size_t json_size,
+                                 const cJSON *root) {
+  ctx_json_cache_writer_t w;
+  memset(&w, 0, sizeof(w));
+  uint32_t root_index;
+  char tmp_path[PATH_MAX + 8];
+
+  if (!ctx_json_cache_node_add(&w, root, &root_index)) goto done;
+
+  ctx_json_cache_hdr_t hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.magic = CTX_JSON_CACHE_MAGIC;
+  hdr.version = CTX_JSON_CACHE_VERSION;
+  hdr.json_hash = json_hash;
+  hdr.json_size = json_size;
+  hdr.num_nodes = w.num_nodes;
+  hdr.strings_size = w.strings_size;
+  /* Strings directly follow the nodes, hash them as one region. */
+  XXH64_state_t *state = XXH64_createState();
+  if (state == NULL) goto done;
+  XXH64_reset(state, 0);
+  XXH64_update(state, w.nodes, w.num_nodes * sizeof(ctx_json_cache_node_t));
+  XXH64_update(state, w.strings, w.strings_size);
+  hdr.payload_hash = XXH64_digest(state);
+  XXH64_freeState(state);
+
+  /* Write a private file and rename it so that concurrent loads never see
+   * a partial cache. */
+  snprintf(tmp_path, sizeof(tmp_path), "%s.XXXXXX", cache_path);
+  int fd = mkstemp(tmp_path);
+  if (fd < 0) {
+    LOG_DBG("%s: Cannot create Context JSON cache %s", __func__, cache_path);
+    goto done;
+  }
+  fchmod(fd, 0644);
+  bool written =
+      ctx_json_write_all(fd, &hdr, sizeof(hdr)) &&
+      ctx_json_write_all(
+          fd, w.nodes, w.num_nodes * sizeof(ctx_json_cache_node_t)) &&
+      ctx_json_write_all(fd, w.strings, w.strings_size);
+  if (close(fd)) written = false;
+  if (!written || rename(tmp_path, cache_path)) {
+    LOG_DBG("%s: Cannot write Context JSON cache %s", __func__, cache_path);
+    unlink(tmp_path);
+    goto done;
+  }
+  LOG_TRACE("Saved Context JSON cache %s: %u nodes, %zu bytes of strings",
+            cache_path,
+            w.num_nodes,
+            w.strings_size);
+
+done:
+  if (w.nodes) bf_sys_free(w.nodes);
+  if (w.strings) bf_sys_free(w.strings);
+  if (w.slots) bf_sys_free(w.slots);
+}
+
+ctx_json_file_t *ctx_json_file_load(const char *path, bool use_cache) {
+  ctx_json_file_t *file = bf_sys_calloc(1, sizeof(ctx_json_file_t));
+  if (file == NULL) {
+    LOG_ERROR("%s:%d: Could not allocate memory for Context JSON file.",
+              __func__,
+              __LINE__);
+    return NULL;
+  }
+
+  size_t json_size;
+  const char *json = ctx_json_map_file(path, &json_size);
+  if (json == NULL) {
+    LOG_ERROR("%s:%d: Could not open configuration file: %s.",
+              __func__,
+              __LINE__,
+              path);
+    bf_sys_free(file);
+    return NULL;
+  }
+  file->json_size = json_size;
+
+  /* Caching is opt-in, nothing is written unless a directory was set. */
+  if (ctx_json_cache_dir[0] == '\0') use_cache = false;
+  uint64_t json_hash = 0;
+  char cache_path[PATH_MAX];
+  if (use_cache) {
+    json_hash = XXH64(json, json_size, 0);
+    ctx_json_cache_path(json_hash, cache_path, sizeof(cache_path));
+    file->root = ctx_json_cache_read(cache_path, json_hash, json_size, file);
+    if (file->root) {
+      LOG_TRACE("Loaded %s from Context JSON cache %s", path, cache_path);
+      file->from_cache = true;
+      munmap((void *)json, json_size);
+      return file;
+    }
+  }
+
+  file->root = ctx_json_reader_parse(json, json_size);
+  munmap((void *)json, json_size);
+  if (file->root == NULL) {
+    LOG_ERROR("%s:%d: Could not parse configuration file: %s.",
+              __func__,
+              __LINE__,
+              path);
+    bf_sys_free(file);
+    return NULL;
+  }
+  if (use_cache) {
+    ctx_json_cache_write(cache_path, json_hash, json_size, file->root);
+  }
+  return file;
+}
+
+cJSON *ctx_json_file_root(const ctx_json_file_t *file) { return file->root; }
+
+bool ctx_json_file_from_cache(const ctx_json_file_t *file) {
+  return file->from_cache;
+}
+
+size_t ctx_json_file_size(const ctx_json_file_t *file) {
+  return file->json_size;
+}
+
+void ctx_json_file_free(ctx_json_file_t *file) {
+  if (file == NULL) return;
+  ctx_json_reader_free(file->root);
+  if (file->from_cache) {
+    bf_sys_free(file->nodes);
+    bf_sys_free(file->strings);
+  }
+  bf_sys_free(file);
+}
@@ -0,0 +1,646 @@
+/*******************************************************************************
+ *  Copyright (C) 2024 Intel Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing,
+ *  software distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions
+ *  and limitations under the License.
+ *
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+
+/**
+ * @file ctx_json_reader.c
+ *
+ * Two pass JSON reader building cJSON trees in a single node array.
+ *
+ * Both passes run the same recursive descent parser. The first one checks
+ * the structure of the text and counts the nodes and the bytes of the
+ * decoded strings; the second one, run once both areas are allocated with
+ * their exact size, converts the numbers and fills them. Nodes are numbered
+ * in pre-order.
+ *
+ * Every tree is described by a document registered in a global list, which
+ * lets ctx_json_object_get go from any node back to the index of its tree.
+ */
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <bf_types/bf_types.h>
+#include <target-sys/bf_sal/bf_sys_intf.h>
+#include <target-utils/third-party/xxHash/xxhash.h>
+
+#include <ctx_json/ctx_json_reader.h>
+#include "ctx_json_log.h"
+
+/* Longest number literal accepted, in characters. */
+#define CTX_JSON_READER_NUMBER_MAX 128
+
+typedef struct ctx_json_slot_s {
+  /* Node indexes plus one, a zero object marks an empty slot. */
+  uint32_t object;
+  uint32_t member;
+} ctx_json_slot_t;
+
+typedef struct ctx_json_str_s {
+  struct ctx_json_str_s *next;
+  char value[];
+} ctx_json_str_t;
+
+typedef struct ctx_json_doc_s {
+  struct ctx_json_doc_s *next;
+  cJSON *nodes;
+  uint32_t num_nodes;
+  bool owns_nodes;
+  char *strings;
+  size_t strings_size;
+  /* Members of all indexed objects, open addressing with linear probing. */
+  ctx_json_slot_t *slots;
+  uint32_t num_slots;
+  /* One bit per node, set for indexed objects. */
+  uint8_t *indexed;
+  /* Values replaced with ctx_json_reader_set_string. */
+  ctx_json_str_t *set_strings;
+} ctx_json_doc_t;
+
+typedef struct ctx_json_parser_s {
+  const char *p;
+  const char *end;
+  /* NULL during the sizing pass. */
+  cJSON *nodes;
+  char *strings;
+  uint32_t num_nodes;
+  size_t strings_size;
+} ctx_json_parser_t;
+
+static ctx_json_doc_t *ctx_json_docs;
+static pthread_rwlock_t ctx_json_docs_lock = PTHREAD_RWLOCK_INITIALIZER;
+
+static bool ctx_json_parse_value(ctx_json_parser_t *ps,
+                                 int depth,
+                                 uint32_t *index);
+
+static void ctx_json_skip_ws(ctx_json_parser_t *ps) {
+  while (ps->p < ps->end && (*ps->p == ' ' || *ps->p == '\t' ||
+                             *ps->p == '\n' || *ps->p == '\r')) {
+    ps->p++;
+  }
+}
+
+static bool ctx_json_hex4(const char *p, const char *end, uint32_t *ret) {
+  if (end - p < 4) return false;
+  uint32_t v = 0;
+  for (int i = 0; i < 4; i++) {
+    char c = p[i];
+    v <<= 4;
+    if (c >= '0' && c <= '9') {
+      v |= c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      v |= c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      v |= c - 'A' + 10;
+    } else {
+      return false;
+    }
+  }
+  *ret = v;
+  return true;
+}
+
+/* Encodes a code point as UTF-8 into dst, if not NULL, and returns the
+ * number of bytes it takes. */
+static size_t ctx_json_utf8(uint32_t cp, char *dst) {
+  if (cp < 0x80) {
+    if (dst) dst[0] = cp;
+    return 1;
+  }
+  if (cp < 0x800) {
+    if (dst) {
+      dst[0] = 0xc0 | (cp >> 6);
+      dst[1] = 0x80 | (cp & 0x3f);
+    }
+    return 2;
+  }
+  if (cp < 0x10000) {
+    if (dst) {
+      dst[0] = 0xe0 | (cp >> 12);
+      dst[1] = 0x80 | ((cp >> 6) & 0x3f);
+      dst[2] = 0x80 | (cp & 0x3f);
+    }
+    return 3;
+  }
+  if (dst) {
+    dst[0] = 0xf0 | (cp >> 18);
+    dst[1] = 0x80 | ((cp >> 12) & 0x3f);
+    dst[2] = 0x80 | ((cp >> 6) & 0x3f);
+    dst[3] = 0x80 | (cp & 0x3f);
+  }
+  return 4;
+}
+
+static bool ctx_json_parse_string(ctx_json_parser_t *ps, char **ret) {
+  const char *p = ps->p + 1;
+  char *dst = ps->strings ? ps->strings + ps->strings_size : NULL;
+  size_t n = 0;
+
+  for (;;) {
+    if (p >= ps->end) return false;
+    char c = *p++;
+    if (c == '"') break;
+    if (c != '\\') {
+      if (dst) dst[n] = c;
+      n++;
+      continue;
+    }
+    if (p >= ps->end) return false;
+    c = *p++;
+    switch (c) {
+      case '"':
+      case '\\':
+      case '/':
+        break;
+      case 'b':
+        c = '\b';
+        break;
+      case 'f':
+        c = '\f';
+        break;
+      case 'n':
+        c = '\n';
+        break;
+      case 'r':
+        c = '\r';
+        break;
+      case 't':
+        c = '\t';
+        break;
+      case 'u': {
+        uint32_t cp, lo;
+        if (!ctx_json_hex4(p, ps->end, &cp)) return false;
+        p += 4;
+        if (cp >= 0xdc00 && cp <= 0xdfff) return false;
+        if (cp >= 0xd800 && cp <= 0xdbff) {
+          /* A high surrogate must be followed by a low one. */
+          if (ps->end - p < 6 || p[0] != '\\' || p[1] != 'u' ||
+              !ctx_json_hex4(p + 2, ps->end, &lo) || lo < 0xdc00 ||
+              lo > 0xdfff) {
+            return false;
+          }
+          p += 6;
+          cp = 0x10000 + ((cp - 0xd800) << 10) + (lo - 0xdc00);
+        }
+        n += ctx_json_utf8(cp, dst ? dst + n : NULL);
+        continue;
+      }
+      default:
+        return false;
+    }
+    if (dst) dst[n] = c;
+    n++;
+  }
+
+  if (dst) {
+    dst[n] = '\0';
+    *ret = dst;
+  }
+  ps->strings_size += n + 1;
+  ps->p = p;
+  return true;
+}
+
+static bool ctx_json_parse_number(ctx_json_parser_t *ps, cJSON *node) {
+  char buf[CTX_JSON_READER_NUMBER_MAX];
+  size_t n = 0;
+  const char *p = ps->p;
+
+  while (p < ps->end && ((*p >= '0' && *p <= '9') || *p == '-' || *p == '+' ||
+                         *p == '.' || *p == 'e' || *p == 'E')) {
+    if (n == sizeof(buf) - 1) return false;
+    buf[n++] = *p++;
+  }
+  if (n == 0) return false;
+  ps->p = p;
+  /* The sizing pass only needs to know where the number ends. */
+  if (node == NULL) return true;
+
+  buf[n] = '\0';
+  char *endptr;
+  double d = strtod(buf, &endptr);
+  if (endptr != buf + n) return false;
+
+  node->type = cJSON_Number;
+  node->valuedouble = d;
+  /* Saturate the same way cJSON does. */
+  if (d >= INT_MAX) {
+    node->valueint = INT_MAX;
+  } else if (d <= (double)INT_MIN) {
+    node->valueint = INT_MIN;
+  } else {
+    node->valueint = (int)d;
+  }
+  return true;
+}
+
+static bool ctx_json_parse_literal(ctx_json_parser_t *ps,
+                                   const char *literal,
+                                   int type,
+                                   cJSON *node) {
+  size_t len = strlen(literal);
+  if ((size_t)(ps->end - ps->p) < len || memcmp(ps->p, literal, len)) {
+    return false;
+  }
+  if (node) {
+    node->type = type;
+    node->valueint = type == cJSON_True;
+  }
+  ps->p += len;
+  return true;
+}
+
+static bool ctx_json_parse_container(ctx_json_parser_t *ps,
+                                     int depth,
+                                     cJSON *node,
+                                     bool object) {
+  char close = object ? '}' : ']';
+  cJSON *first = NULL, *last = NULL;
+
+  ps->p++;
+  if (node) node->type = object ? cJSON_Object : cJSON_Array;
+  ctx_json_skip_ws(ps);
+  if (ps->p < ps->end && *ps->p == close) {
+    ps->p++;
+    return true;
+  }
+
+  for (;;) {
+    char *key = NULL;
+    if (object) {
+      ctx_json_skip_ws(ps);
+      if (ps->p >= ps->end || *ps->p != '"') return false;
+      if (!ctx_json_parse_string(ps, &key)) return false;
+      ctx_json_skip_ws(ps);
+      if (ps->p >= ps->end || *ps->p != ':') return false;
+      ps->p++;
+    }
+    uint32_t child_index;
+    if (!ctx_json_parse_value(ps, depth + 1, &child_index)) return false;
+    if (node) {
+      cJSON *child = &ps->nodes[child_index];
+      child->string = key;
+      if (last) {
+        last->next = child;
+        child->prev = last;
+      } else {
+        first = child;
+      }
+      last = child;
+    }
+    ctx_json_skip_ws(ps);
+    if (ps->p >= ps->end) return false;
+    if (*ps->p == ',') {
+      ps->p++;
+      continue;
+    }
+    if (*ps->p != close) return false;
+    ps->p++;
+    break;
+  }
+
+  if (node) {
+    /* As in cJSON the first child's prev points to the last child. */
+    node->child = first;
+    first->prev = last;
+  }
+  return true;
+}
+
+static bool ctx_json_parse_value(ctx_json_parser_t *ps,
+                                 int depth,
+                                 uint32_t *index) {
+  if (depth > CJSON_NESTING_LIMIT) return false;
+  ctx_json_skip_ws(ps);
+  if (ps->p >= ps->end || ps->num_nodes == UINT32_MAX) return false;
+
+  *index = ps->num_nodes++;
+  cJSON *node = ps->nodes ? &ps->nodes[*index] : NULL;
+  switch (*ps->p) {
+    case '{':
+      return ctx_json_parse_container(ps, depth, node, true);
+    case '[':
+      return ctx_json_parse_container(ps, depth, node, false);
+    case '"': {
+      char *value = NULL;
+      if (!ctx_json_parse_string(ps, &value)) return false;
+      if (node) {
+        node->type = cJSON_String;
+        node->valuestring = value;
+      }
+      return true;
+    }
+    case 't':
+      return ctx_json_parse_literal(ps, "true", cJSON_True, node);
+    case 'f':
+      return ctx_json_parse_literal(ps, "false", cJSON_False, node);
+    case 'n':
+      return ctx_json_parse_literal(ps, "null", cJSON_NULL, node);
+    default:
+      return ctx_json_parse_number(ps, node);
+  }
+}
+
+static bool ctx_json_parse_text(ctx_json_parser_t *ps) {
+  uint32_t root;
+  if (!ctx_json_parse_value(ps, 0, &root)) return false;
+  ctx_json_skip_ws(ps);
+  return ps->p == ps->end || *ps->p == '\0';
+}
+
+static bool ctx_json_doc_has(const ctx_json_doc_t *doc, const cJSON *node) {
+  return (uintptr_t)node >= (uintptr_t)doc->nodes &&
+         (uintptr_t)node < (uintptr_t)(doc->nodes + doc->num_nodes);
+}
+
+/* Must be called with ctx_json_docs_lock held. */
+static ctx_json_doc_t *ctx_json_doc_find(const cJSON *node) {
+  for (ctx_json_doc_t *doc = ctx_json_docs; doc; doc = doc->next) {
+    if (ctx_json_doc_has(doc, node)) return doc;
+  }
+  return NULL;
+}
+
+static uint32_t ctx_json_key_hash(uint32_t object, const char *key) {
+  return (uint32_t)XXH3_64bits_withSeed(key, strlen(key), object);
+}
+
+static uint32_t ctx_json_num_members(const cJSON *object) {
+  uint32_t n = 0;
+  for (const cJSON *c = object->child; c; c = c->next) n++;
+  return n;
+}
+
+static bool ctx_json_is_indexed(const ctx_json_doc_t *doc, uint32_t i) {
+  return doc->indexed && (doc->indexed[i / 8] & (1u << (i % 8)));
+}
+
+static const ctx_json_slot_t *ctx_json_doc_lookup(const ctx_json_doc_t *doc,
+                                                  uint32_t object,
+                                                  const char *key) {
+  uint32_t hash = ctx_json_key_hash(object, key);
+  uint32_t mask = doc->num_slots - 1;
+  for (uint32_t s = hash & mask;; s = (s + 1) & mask) {
+    const ctx_json_slot_t *slot = &doc->slots[s];
+    if (slot->object == 0) return slot;
+    if (slot->object == object + 1 &&
+        !strcmp(doc->nodes[slot->member - 1].string, key)) {
+      return slot;
+    }
+  }
+}
+
+static int ctx_json_doc_index(ctx_json_doc_t *doc) {
+  uint64_t members = 0;
+  for (uint32_t i = 0; i < doc->num_nodes; i++) {
+    if (doc->nodes[i].type != cJSON_Object) continue;
+    uint32_t n = ctx_json_num_members(&doc->nodes[i]);
+    if (n >= CTX_JSON_READER_INDEX_MIN_MEMBERS) members += n;
+  }
+  if (members == 0) return 0;
+  if (members > UINT32_MAX / 4) return -1;
+
+  /* Keep the table at most two thirds full. */
+  uint32_t num_slots = 1;
+  while (num_slots < members + members / 2) num_slots <<= 1;
+  doc->slots = bf_sys_calloc(num_slots, sizeof(ctx_json_slot_t));
+  doc->indexed = bf_sys_calloc((doc->num_nodes + 7) / 8, 1);
+  if (doc->slots == NULL || doc->indexed == NULL) return -1;
+  doc->num_slots = num_slots;
+
+  for (uint32_t i = 0; i < doc->num_nodes; i++) {
+    cJSON *object = &doc->nodes[i];
+    if (object->type != cJSON_Object ||
+        ctx_json_num_members(object) < CTX_JSON_READER_INDEX_MIN_MEMBERS) {
+      continue;
+    }
+    for (cJSON *c = object->child; c; c = c->next) {
+      if (c->string == NULL || !ctx_json_doc_has(doc, c)) return -1;
+      ctx_json_slot_t *slot =
+          (ctx_json_slot_t *)ctx_json_doc_lookup(doc, i, c->string);
+      /* Keep the first of duplicate keys, as cJSON_GetObjectItem does. */
+      if (slot->object) continue;
+      slot->object = i + 1;
+      slot->member = c - doc->nodes + 1;
+    }
+    doc->indexed[i / 8] |= 1u << (i % 8);
+  }
+  return 0;
+}
+
+static void ctx_json_doc_destroy(ctx_json_doc_t *doc) {
+  if (doc->slots) bf_sys_free(doc->slots);
+  if (doc->indexed) bf_sys_free(doc->indexed);
+  while (doc->set_strings) {
+    ctx_json_str_t *s = doc->set_strings;
+    doc->set_strings = s->next;
+    bf_sys_free(s);
+  }
+  if (doc->owns_nodes) {
+    if (doc->nodes) bf_sys_free(doc->nodes);
+    if (doc->strings) bf_sys_free(doc->strings);
+  }
+  bf_sys_free(doc);
+}
+
+static void ctx_json_doc_register(ctx_json_doc_t *doc) {
+  pthread_rwlock_wrlock(&ctx_json_docs_lock);
+  doc->next = ctx_json_docs;
+  ctx_json_docs = doc;
+  pthread_rwlock_unlock(&ctx_json_docs_lock);
+}
+
+cJSON *ctx_json_reader_parse(const char *json, size_t len) {
+  ctx_json_parser_t ps;
+  memset(&ps, 0, sizeof(ps));
+  ps.p = json;
+  ps.end = json + len;
+  if (json == NULL || !ctx_json_parse_text(&ps)) {
+    LOG_ERROR("%s:%d: JSON syntax error at offset %zu",
+              __func__,
+              __LINE__,
+              json ? (size_t)(ps.p - json) : 0);
+    return NULL;
+  }
+
+  ctx_json_doc_t *doc = bf_sys_calloc(1, sizeof(ctx_json_doc_t));
+  if (doc == NULL) goto alloc_err;
+  doc->owns_nodes = true;
+  doc->num_nodes = ps.num_nodes;
+  doc->strings_size = ps.strings_size;
+  doc->nodes = bf_sys_calloc(ps.num_nodes, sizeof(cJSON));
+  doc->strings = bf_sys_malloc(ps.strings_size ? ps.strings_size : 1);
+  if (doc->nodes == NULL || doc->strings == NULL) goto alloc_err;
+
+  memset(&ps, 0, sizeof(ps));
+  ps.p = json;
+  ps.end = json + len;
+  ps.nodes = doc->nodes;
+  ps.strings = doc->strings;
+  if (!ctx_json_parse_text(&ps) || ps.num_nodes != doc->num_nodes ||
+      ps.strings_size != doc->strings_size) {
+    LOG_ERROR("%s:%d: JSON syntax error at offset %zu",
+              __func__,
+              __LINE__,
+              (size_t)(ps.p - json));
+    ctx_json_doc_destroy(doc);
+    return NULL;
+  }
+  if (ctx_json_doc_index(doc)) goto alloc_err;
+
+  ctx_json_doc_register(doc);
+  return doc->nodes;
+
+alloc_err:
+  LOG_ERROR("%s:%d: Could not allocate memory for a JSON tree of %u nodes",
+            __func__,
+            __LINE__,
+            ps.num_nodes);
+  if (doc) ctx_json_doc_destroy(doc);
+  return NULL;
+}
+
+int ctx_json_reader_attach(cJSON *nodes, uint32_t num_nodes) {
+  if (nodes == NULL || num_nodes == 0) return -1;
+  ctx_json_doc_t *doc = bf_sys_calloc(1, sizeof(ctx_json_doc_t));
+  if (doc == NULL) return -1;
+  doc->nodes = nodes;
+  doc->num_nodes = num_nodes;
+  if (ctx_json_doc_index(doc)) {
+    LOG_ERROR("%s:%d: Could not index a JSON tree of %u nodes",
+              __func__,
+              __LINE__,
+              num_nodes);
+    ctx_json_doc_destroy(doc);
+    return -1;
+  }
+  ctx_json_doc_register(doc);
+  return 0;
+}
+
+void ctx_json_reader_free(cJSON *root) {
+  if (root == NULL) return;
+
+  ctx_json_doc_t *doc = NULL;
+  pthread_rwlock_wrlock(&ctx_json_docs_lock);
+  for (ctx_json_doc_t **d = &ctx_json_docs; *d; d = &(*d)->next) {
+    if ((*d)->nodes == root) {
+      doc = *d;
+      *d = doc->next;
+      break;
+    }
+  }
+  pthread_rwlock_unlock(&ctx_json_docs_lock);
+  if (doc == NULL) {
+    LOG_ERROR("%s:%d: Not a JSON tree built by the reader", __func__, __LINE__);
+    return;
+  }
+
+  /* Items added after parsing are appended to a child or sibling list and
+   * are the only nodes outside the array; cJSON_Delete releases each such
+   * chain from its first node. */
+  for (uint32_t i = 0; i < doc->num_nodes; i++) {
+    cJSON *node = &doc->nodes[i];
+    if (node->child && !ctx_json_doc_has(doc, node->child)) {
+      cJSON_Delete(node->child);
+    }
+    if (node->next && !ctx_json_doc_has(doc, node->next)) {
+      cJSON_Delete(node->next);
+    }
+  }
+  ctx_json_doc_destroy(doc);
+}
+
+cJSON *ctx_json_object_get(const cJSON *object, const char *key) {
+  if (object == NULL || key == NULL) return NULL;
+
+  /* Scan up to the size from which objects are indexed, so that small
+   * objects never pay for finding their tree. */
+  uint32_t n = 0;
+  cJSON *c;
+  for (c = object->child; c && n < CTX_JSON_READER_INDEX_MIN_MEMBERS;
+       c = c->next, n++) {
+    if (c->string && !strcmp(c->string, key)) return c;
+  }
+  if (c == NULL) return NULL;
+
+  bool indexed = false, appended = false;
+  cJSON *ret = NULL;
+  pthread_rwlock_rdlock(&ctx_json_docs_lock);
+  const ctx_json_doc_t *doc = ctx_json_doc_find(object);
+  if (doc) {
+    uint32_t i = object - doc->nodes;
+    indexed = ctx_json_is_indexed(doc, i);
+    if (indexed) {
+      const ctx_json_slot_t *slot = ctx_json_doc_lookup(doc, i, key);
+      if (slot->object) ret = &doc->nodes[slot->member - 1];
+      /* The last member is outside the array if any was added later. */
+      appended = !ctx_json_doc_has(doc, object->child->prev);
+    }
+  }
+  pthread_rwlock_unlock(&ctx_json_docs_lock);
+
+  if (indexed && (ret || !appended)) return ret;
+  for (; c; c = c->next) {
+    if (c->string && !strcmp(c->string, key)) return c;
+  }
+  return NULL;
+}
+
+int ctx_json_reader_set_string(cJSON *item, const char *value) {
+  if (item == NULL || value == NULL || item->child != NULL) return -1;
+  size_t len = strlen(value);
+  ctx_json_str_t *s = bf_sys_malloc(sizeof(ctx_json_str_t) + len + 1);
+  if (s == NULL) return -1;
+  memcpy(s->value, value, len + 1);
+
+  pthread_rwlock_wrlock(&ctx_json_docs_lock);
+  ctx_json_doc_t *doc = ctx_json_doc_find(item);
+  if (doc) {
+    s->next = doc->set_strings;
+    doc->set_strings = s;
+    item->type = cJSON_String;
+    item->valuestring = s->value;
+  }
+  pthread_rwlock_unlock(&ctx_json_docs_lock);
+  if (doc == NULL) {
+    bf_sys_free(s);
+    return -1;
+  }
+  return 0;
+}
+
+size_t ctx_json_reader_mem_size(const cJSON *root) {
+  size_t size = 0;
+  pthread_rwlock_rdlock(&ctx_json_docs_lock);
+  const ctx_json_doc_t *doc = ctx_json_doc_find(root);
+  if (doc) {
+    size = sizeof(*doc) + doc->num_slots * sizeof(ctx_json_slot_t);
+    if (doc->indexed) size += (doc->num_nodes + 7) / 8;
+    if (doc->owns_nodes) {
+      size += doc->num_nodes * sizeof(cJSON) + doc->strings_size;
+    }
+  }
+  pthread_rwlock_unlock(&ctx_json_docs_lock);
+  return size;
+}
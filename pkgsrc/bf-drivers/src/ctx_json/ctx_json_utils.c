@@ -31,6 +31,7 @@
 #include <string.h>
 
 #include <ctx_json/ctx_json_utils.h>
+#include <ctx_json/ctx_json_reader.h>
 #include "ctx_json_log.h"
 
 #define PAD_TO_BYTE(x) (8 * (((x) + 7) / 8))
@@ -50,7 +51,7 @@
   CHECK_ERR_INTERNAL(err, label, __FILE__, __LINE__, __func__)
 
 int bf_cjson_get_string_dup(cJSON *cjson, char *property, char **ret) {
-  cJSON *tmp = cJSON_GetObjectItem(cjson, property);
+  cJSON *tmp = ctx_json_object_get(cjson, property);
   if (tmp == NULL) {
     LOG_ERROR(
         "%s:%d: Invalid ContextJSON format: could not find cJSON property "
@@ -80,7 +81,7 @@ int bf_cjson_get_string_dup(cJSON *cjson, char *property, char **ret) {
  * @return 0 if successful, -1 on error.
  */
 int bf_cjson_get_string(cJSON *cjson, char *property, char **ret) {
-  cJSON *tmp = cJSON_GetObjectItem(cjson, property);
+  cJSON *tmp = ctx_json_object_get(cjson, property);
   if (tmp == NULL) {
     LOG_ERROR(
         "%s:%d: Invalid ContextJSON format: could not find cJSON property "
@@ -116,7 +117,7 @@ int bf_cjson_get_string(cJSON *cjson, char *property, char **ret) {
  * @return 0, it always succeeds.
  */
 int bf_cjson_try_get_string(cJSON *cjson, char *property, char **ret) {
-  cJSON *tmp = cJSON_GetObjectItem(cjson, property);
+  cJSON *tmp = ctx_json_object_get(cjson, property);
   if (tmp != NULL && tmp->type == cJSON_String) {
     *ret = tmp->valuestring;
   }
@@ -136,7 +137,7 @@ int bf_cjson_try_get_string(cJSON *cjson, char *property, char **ret) {
  * @return 0, it always succeeds.
  */
 int bf_cjson_try_get_string_dup(cJSON *cjson, char *property, char **ret) {
-  cJSON *tmp = cJSON_GetObjectItem(cjson, property);
+  cJSON *tmp = ctx_json_object_get(cjson, property);
   if (tmp != NULL && tmp->type == cJSON_String) {
     *ret = bf_sys_strdup(tmp->valuestring);
   }
@@ -178,7 +179,7 @@ void ctx_json_hex_to_stream(char *hex, uint8_t *stream, uint8_t len) {
  * @return 0 if successful, -1 on error.
  */
 int bf_cjson_get_hex(cJSON *cjson, char *property, uint8_t *ret, uint8_t len) {
-  cJSON *tmp = cJSON_GetObjectItem(cjson, property);
+  cJSON *tmp = ctx_json_object_get(cjson, property);
   if (tmp == NULL) {
     LOG_ERROR(
         "%s:%d: Invalid ContextJSON format: could not find cJSON property "
@@ -217,7 +218,7 @@ int bf_cjson_try_get_hex(cJSON *cjson,
                          char *property,
                          uint8_t *ret,
                          uint8_t len) {
-  cJSON *tmp = cJSON_GetObjectItem(cjson, property);
+  cJSON *tmp = ctx_json_object_get(cjson, property);
   if (tmp && tmp->type == cJSON_String) {
     ctx_json_hex_to_stream(tmp->valuestring, ret, len);
   }
@@ -233,7 +234,7 @@ int bf_cjson_try_get_hex(cJSON *cjson,
  * @return true if present, otherwise false.
  */
 int bf_cjson_has_hex(cJSON *cjson, char *property) {
-  cJSON *tmp = cJSON_GetObjectItem(cjson, property);
+  cJSON *tmp = ctx_json_object_get(cjson, property);
   return tmp && tmp->type == cJSON_String;
 }
 
@@ -251,7 +252,7 @@ int bf_cjson_has_hex(cJSON *cjson, char *property) {
  * @return 0 if successful, -1 on error.
  */
 int bf_cjson_get_int(cJSON *cjson, char *property, int *ret) {
-  cJSON *tmp = cJSON_GetObjectItem(cjson, property);
+  cJSON *tmp = ctx_json_object_get(cjson, property);
   if (tmp == NULL) {
     LOG_ERROR(
         "%s:%d: Invalid ContextJSON format: could not find cJSON property "
@@ -287,7 +288,7 @@ int bf_cjson_get_int(cJSON *cjson, char *property, int *ret) {
  * @return 0, it always succeeds.
  */
 int bf_cjson_try_get_int(cJSON *cjson, char *property, int *ret) {
-  cJSON *tmp = cJSON_GetObjectItem(cjson, property);
+  cJSON *tmp = ctx_json_object_get(cjson, property);
   if (tmp != NULL && tmp->type == cJSON_Number) {
     *ret = tmp->valueint;
   }
@@ -303,7 +304,7 @@ int bf_cjson_try_get_int(cJSON *cjson, char *property, int *ret) {
  * @return true if found, otherwise false.
  */
 bool bf_cjson_has_int(cJSON *cjson, const char *property) {
-  cJSON *tmp = cJSON_GetObjectItem(cjson, property);
+  cJSON *tmp = ctx_json_object_get(cjson, property);
   return tmp != NULL && tmp->type == cJSON_Number;
 }
 
@@ -319,7 +320,7 @@ bool bf_cjson_has_int(cJSON *cjson, const char *property) {
  * @return 0 if successful, -1 on error.
  */
 int bf_cjson_get_double(cJSON *cjson, char *property, double *ret) {
-  cJSON *tmp = cJSON_GetObjectItem(cjson, property);
+  cJSON *tmp = ctx_json_object_get(cjson, property);
   if (tmp == NULL) {
     LOG_ERROR(
         "%s:%d: Invalid ContextJSON format: could not find cJSON property "
@@ -355,7 +356,7 @@ int bf_cjson_get_double(cJSON *cjson, char *property, double *ret) {
  * @return 0, it always succeeds.
  */
 int bf_cjson_try_get_double(cJSON *cjson, char *property, double *ret) {
-  cJSON *tmp = cJSON_GetObjectItem(cjson, property);
+  cJSON *tmp = ctx_json_object_get(cjson, property);
   if (tmp != NULL && tmp->type == cJSON_Number) {
     *ret = tmp->valuedouble;
   }
@@ -374,7 +375,7 @@ int bf_cjson_try_get_double(cJSON *cjson, char *property, double *ret) {
  * @return 0 if successful, -1 on error.
  */
 int bf_cjson_get_bool(cJSON *cjson, char *property, bool *ret) {
-  cJSON *tmp = cJSON_GetObjectItem(cjson, property);
+  cJSON *tmp = ctx_json_object_get(cjson, property);
   if (tmp == NULL) {
     LOG_ERROR(
         "%s:%d: Invalid ContextJSON format: could not find cJSON property "
@@ -414,7 +415,7 @@ int bf_cjson_get_bool(cJSON *cjson, char *property, bool *ret) {
  * @return 0, it always succeeds.
  */
 int bf_cjson_try_get_bool(cJSON *cjson, char *property, bool *ret) {
-  cJSON *tmp = cJSON_GetObjectItem(cjson, property);
+  cJSON *tmp = ctx_json_object_get(cjson, property);
   if (tmp == NULL) {
     return 0;
   }
@@ -540,7 +541,7 @@ int bf_cjson_get_array_item(cJSON *cjson, int i, cJSON **ret) {
  * @return 0 if successful, -1 on error.
  */
 int bf_cjson_get_object(cJSON *cjson, char *property, cJSON **ret) {
-  cJSON *tmp = cJSON_GetObjectItem(cjson, property);
+  cJSON *tmp = ctx_json_object_get(cjson, property);
   if (tmp == NULL || tmp->type == cJSON_NULL) {
     LOG_ERROR(
         "%s:%d: Invalid ContextJSON format: could not find cJSON property "
@@ -568,7 +569,7 @@ int bf_cjson_get_object(cJSON *cjson, char *property, cJSON **ret) {
  * @return 0, it always succeeds.
  */
 int bf_cjson_try_get_object(cJSON *cjson, char *property, cJSON **ret) {
-  cJSON *tmp = cJSON_GetObjectItem(cjson, property);
+  cJSON *tmp = ctx_json_object_get(cjson, property);
   if (tmp != NULL && tmp->type != cJSON_NULL) {
     *ret = tmp;
   }
@@ -599,7 +600,7 @@ int bf_cjson_get_handle(bf_dev_id_t devid,
                         int *ret) {
   pipe_tbl_hdl_t ret_handle = 0;
   int rc = 0;
-  cJSON *tmp = cJSON_GetObjectItem(cjson, property);
+  cJSON *tmp = ctx_json_object_get(cjson, property);
   if (tmp == NULL) {
     LOG_ERROR(
         "%s:%d: Invalid ContextJSON format: could not find cJSON property "
@@ -644,7 +645,7 @@ int bf_cjson_try_get_handle(bf_dev_id_t devid,
                             cJSON *cjson,
                             char *property,
                             int *ret) {
-  cJSON *tmp = cJSON_GetObjectItem(cjson, property);
+  cJSON *tmp = ctx_json_object_get(cjson, property);
   if (tmp != NULL && tmp->type == cJSON_Number) {
     pipe_tbl_hdl_t ret_handle = 0;
     int rc = 0;
@@ -610,6 +610,11 @@ bf_status_t bf_drv_init() {
   return BF_SUCCESS;
 }
 
+/****************************************************************
+ * bf_drv_cleanup
+ ****************************************************************/
+void bf_drv_cleanup(void) { dvm_port_evt_cleanup(); }
+
 /**
  * Add a new device to the pktmgr on the device. After this call, the device is
  * ready for
@@ -940,6 +945,9 @@ bf_status_t bf_device_remove(bf_dev_id_t dev_id) {
     return BF_OBJECT_NOT_FOUND;
   }
 
+  // drop port events still queued for the device
+  dvm_port_evt_dev_del(dev_id);
+
   // notify clients
   status = bf_drv_notify_clients_dev_del(dev_id, true);
   if (status != BF_SUCCESS) {
@@ -182,6 +182,17 @@ void bf_drv_notify_clients_port_status_chg(bf_dev_id_t dev_id,
                                            bf_dev_port_t port_id,
                                            port_mgr_port_event_t event,
                                            void *userdata);
+
+/* Port event bus, see dvm_port_evt.c */
+void dvm_port_evt_init(void);
+bool dvm_port_evt_client_is_async(bf_drv_client_handle_t client_handle);
+void dvm_port_evt_post(bf_dev_id_t dev_id,
+                       bf_dev_port_t port_id,
+                       bool status_event,
+                       bool port_up,
+                       bool speed_event);
+void dvm_port_evt_dev_del(bf_dev_id_t dev_id);
+void dvm_port_evt_cleanup(void);
 bf_status_t bf_drv_notify_clients_port_serdes_upgrade(
     bf_dev_id_t dev_id,
     bf_dev_port_t port_id,
@@ -46,6 +46,7 @@ void bf_driver_client_db_init() {
   memset(&bf_drv_hdl_info, 0, sizeof(bf_drv_hdl_info));
   memset(&bf_driver_client_db, 0, sizeof(bf_driver_client_db));
   memset(&bf_app_client_db, 0, sizeof(bf_app_client_db));
+  dvm_port_evt_init();
 }
 
 /* allocate an id for the client */
@@ -95,6 +96,10 @@ bf_status_t bf_drv_deregister(bf_drv_client_handle_t client_handle) {
   bf_sys_assert(client_handle >= 0);
   bf_sys_assert(client_handle < BF_DRV_MAX_CLIENTS);
 
+  /* Flush and stop the client's port event thread, if any.  When called from
+   * that thread's own callback the thread stops once the callback returns. */
+  bf_drv_client_port_events_async_set(client_handle, false);
+
   memset(&bf_drv_hdl_info[client_handle],
          0,
          sizeof(bf_drv_hdl_info[client_handle]));
@@ -926,7 +931,6 @@ void bf_drv_notify_clients_port_status_chg(bf_dev_id_t dev_id,
   bf_status_t client_status = BF_SUCCESS;
   bool status_event = false, speed_event = false;
   bool port_up = false;
-  bf_port_speed_t speed = 0;
 
   (void)userdata;
   if (event == PORT_MGR_PORT_EVT_UP) {
@@ -937,8 +941,6 @@ void bf_drv_notify_clients_port_status_chg(bf_dev_id_t dev_id,
     port_up = false;
   } else if (event == PORT_MGR_PORT_EVT_SPEED_SET) {
     speed_event = true;
-    /* Get the speed from LLD */
-    speed = 0;
   }
 
   for (id = BF_DRV_MAX_CLIENTS - 1; id >= 0; id--) {
@@ -946,6 +948,10 @@ void bf_drv_notify_clients_port_status_chg(bf_dev_id_t dev_id,
     if (db_ptr->valid == false) {
       continue;
     }
+    /* Delivered from the client's own thread by the port event bus */
+    if (dvm_port_evt_client_is_async(db_ptr->client_handle)) {
+      continue;
+    }
     if ((status_event) && (db_ptr->callbacks.port_status)) {
       client_status = db_ptr->callbacks.port_status(dev_id, port_id, port_up);
       if (client_status != BF_SUCCESS) {
@@ -974,15 +980,8 @@ void bf_drv_notify_clients_port_status_chg(bf_dev_id_t dev_id,
     }
   }
 
-  /* Notify app also */
-  if ((status_event) && (bf_app_client_db.port_status)) {
-    bf_app_client_db.port_status(
-        dev_id, port_id, port_up, bf_app_client_db.port_status_cookie);
-  }
-  if ((speed_event) && (bf_app_client_db.port_speed)) {
-    bf_app_client_db.port_speed(
-        dev_id, port_id, speed, bf_app_client_db.port_speed_cookie);
-  }
+  /* Notify app and the clients on the port event bus also */
+  dvm_port_evt_post(dev_id, port_id, status_event, port_up, speed_event);
 
   return;
 }
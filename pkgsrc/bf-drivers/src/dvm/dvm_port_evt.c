@@ -0,0 +1,1007 @@
+/*******************************************************************************
+ *  Copyright (C) 2024 Intel Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing,
+ *  software distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions
+ *  and limitations under the License.
+ *
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+
+/*
+ * Port event bus.
+ *
+ * Link and speed events from port manager are handed synchronously to the
+ * driver clients which did not opt in to the bus, exactly as before.  Every
+ * other consumer (driver clients which called
+ * bf_drv_client_port_events_async_set and, once
+ * bf_port_client_port_events_async_set is enabled, the application) has a
+ * queue and a thread of its own.  A queue holds at most one record per port;
+ * a newer event for a port overwrites the pending one, and a link state which
+ * ends up equal to the one last delivered to that consumer is dropped.  The
+ * thread drains the queue in batches, so a slow consumer only delays itself.
+ * An application which is not on the bus is called inline, in the order the
+ * events of each port were decided but without any bus lock held.  While no
+ * consumer is asynchronous and no dampening is in effect events go straight
+ * to the application, as before the bus.
+ *
+ * Dampening works on link down events as in RFC 2439: each one adds a penalty
+ * to the port's figure of merit which halves every half-life.  Past the
+ * suppress threshold the port is reported down to the bus consumers and
+ * further flaps are withheld until the merit decays below the reuse
+ * threshold, at which point the current state is reported if it changed.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <target-sys/bf_sal/bf_sys_intf.h>
+#include <target-utils/map/map.h>
+#include <dvm/bf_drv_intf.h>
+#include "dvm.h"
+#include <dvm/dvm_log.h>
+
+/* Queue of the application callbacks, driver clients use their handle. */
+#define DVM_PORT_EVT_APP_Q BF_DRV_MAX_CLIENTS
+#define DVM_PORT_EVT_NUM_Q (BF_DRV_MAX_CLIENTS + 1)
+/* Number of events a client thread delivers per queue lock. */
+#define DVM_PORT_EVT_BATCH 64
+/* Interval at which suppressed ports are checked for reuse. */
+#define DVM_PORT_DAMP_POLL_US 100000
+
+#define DVM_PORT_DAMP_DEF_PENALTY 1000
+#define DVM_PORT_DAMP_DEF_SUPPRESS 2000
+#define DVM_PORT_DAMP_DEF_REUSE 1000
+#define DVM_PORT_DAMP_DEF_HALF_LIFE_MS 5000
+#define DVM_PORT_DAMP_DEF_MAX_SUPPRESS_MS 20000
+
+#define DVM_PORT_EVT_KEY(dev_id, port_id) \
+  (((unsigned long)(dev_id) << 32) | (uint32_t)(port_id))
+
+extern bf_drv_client_t bf_driver_client_db[BF_DRV_MAX_CLIENTS];
+extern bf_drv_app_t bf_app_client_db;
+extern bf_drv_hdl_info_t bf_drv_hdl_info[BF_DRV_MAX_CLIENTS];
+
+/* Pending and last delivered state of one port for one consumer */
+typedef struct dvm_port_evt_rec_s {
+  struct dvm_port_evt_rec_s *next;
+  bf_dev_id_t dev_id;
+  bf_dev_port_t port_id;
+  bool queued;
+  bool status_pending;
+  bool port_up;
+  bool speed_pending;
+  bool delivered_valid;
+  bool delivered_up;
+} dvm_port_evt_rec_t;
+
+/* One entry of a batch being delivered, copied out of the queue */
+typedef struct dvm_port_evt_s {
+  bf_dev_id_t dev_id;
+  bf_dev_port_t port_id;
+  bool status;
+  bool port_up;
+  bool speed;
+} dvm_port_evt_t;
+
+/* One event waiting for a port's inline delivery */
+typedef struct dvm_port_evt_node_s {
+  struct dvm_port_evt_node_s *next;
+  dvm_port_evt_t evt;
+} dvm_port_evt_node_t;
+
+/* Inline delivery state of a port.  Events decided while another thread is
+ * calling the application for the port wait on the list, that thread delivers
+ * them once its callback returns. */
+typedef struct dvm_port_inline_s {
+  bool busy;
+  bool orphan; /* Dropped from the map while busy, freed when done */
+  dvm_port_evt_node_t *head;
+  dvm_port_evt_node_t *tail;
+} dvm_port_inline_t;
+
+typedef struct dvm_port_evt_q_s {
+  bool async;
+  bool stop;
+  bool running; /* The thread exists and still owns recs */
+  bf_sys_mutex_t mtx;
+  bf_sys_cond_t cond;
+  bf_sys_thread_t thread;
+  bf_map_t recs;
+  dvm_port_evt_rec_t *head;
+  dvm_port_evt_rec_t *tail;
+  uint64_t queued[BF_MAX_DEV_COUNT];
+  uint64_t coalesced[BF_MAX_DEV_COUNT];
+  uint64_t delivered[BF_MAX_DEV_COUNT];
+} dvm_port_evt_q_t;
+
+/* Dampening state of a port */
+typedef struct dvm_port_damp_s {
+  uint32_t merit;    /* Figure of merit at time stamp_ms */
+  uint64_t stamp_ms; /* Time of the last penalty */
+  bool suppressed;
+  bool port_up;         /* Actual link state */
+  bool reported_valid;  /* A link state was reported to the bus consumers */
+  bool reported_up;     /* Link state last reported to the bus consumers */
+} dvm_port_damp_t;
+
+static bool dvm_pevt_init_done = false;
+static dvm_port_evt_q_t dvm_pevt_q[DVM_PORT_EVT_NUM_Q];
+
+/* Serializes the dampening decision with the hand off of the resulting event
+ * to the queues and inline lists, so consumers see the link states of a port
+ * in the order they were decided.  No callback is invoked with it held.  Also
+ * protects the dampening configuration, state and counters below. */
+static bf_sys_mutex_t dvm_pevt_lock;
+static bf_sys_cond_t dvm_pevt_damp_cond;
+static bool dvm_pevt_damp_thread_running = false;
+static bool dvm_pevt_damp_stop = false;
+static bf_sys_thread_t dvm_pevt_damp_thread;
+static uint32_t dvm_pevt_num_suppressed = 0;
+/* Number of asynchronous consumers */
+static int dvm_pevt_num_async = 0;
+/* dvm_port_inline_t of each port the application was called inline for */
+static bf_map_t dvm_pevt_inline;
+static bf_drv_port_dampening_cfg_t dvm_pevt_damp_cfg[BF_MAX_DEV_COUNT];
+static uint32_t dvm_pevt_damp_ceiling[BF_MAX_DEV_COUNT];
+static dvm_port_damp_t *dvm_pevt_damp[BF_MAX_DEV_COUNT];
+static bf_drv_port_event_stats_t dvm_pevt_stats[BF_MAX_DEV_COUNT];
+
+void dvm_port_evt_init(void) {
+  int i;
+
+  if (dvm_pevt_init_done) return;
+
+  memset(dvm_pevt_q, 0, sizeof(dvm_pevt_q));
+  for (i = 0; i < DVM_PORT_EVT_NUM_Q; i++) {
+    bf_sys_mutex_init(&dvm_pevt_q[i].mtx);
+    bf_sys_cond_init(&dvm_pevt_q[i].cond);
+  }
+  bf_sys_mutex_init(&dvm_pevt_lock);
+  bf_sys_cond_init(&dvm_pevt_damp_cond);
+  bf_map_init(&dvm_pevt_inline);
+  memset(dvm_pevt_damp_cfg, 0, sizeof(dvm_pevt_damp_cfg));
+  memset(dvm_pevt_damp, 0, sizeof(dvm_pevt_damp));
+  memset(dvm_pevt_stats, 0, sizeof(dvm_pevt_stats));
+  dvm_pevt_init_done = true;
+}
+
+static uint64_t dvm_port_evt_now_ms(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+/* Invoke one consumer's callbacks for one event. */
+static void dvm_port_evt_deliver(int qid, const dvm_port_evt_t *evt) {
+  bf_drv_client_t *db_ptr = NULL;
+  bf_status_t client_status;
+  int id;
+
+  if (qid == DVM_PORT_EVT_APP_Q) {
+    if (evt->status && bf_app_client_db.port_status) {
+      bf_app_client_db.port_status(evt->dev_id,
+                                   evt->port_id,
+                                   evt->port_up,
+                                   bf_app_client_db.port_status_cookie);
+    }
+    if (evt->speed && bf_app_client_db.port_speed) {
+      bf_app_client_db.port_speed(
+          evt->dev_id, evt->port_id, 0, bf_app_client_db.port_speed_cookie);
+    }
+    return;
+  }
+
+  for (id = 0; id < BF_DRV_MAX_CLIENTS; id++) {
+    if (bf_driver_client_db[id].valid &&
+        bf_driver_client_db[id].client_handle == qid) {
+      db_ptr = &bf_driver_client_db[id];
+      break;
+    }
+  }
+  if (!db_ptr) return;
+
+  if (evt->status && db_ptr->callbacks.port_status) {
+    client_status =
+        db_ptr->callbacks.port_status(evt->dev_id, evt->port_id, evt->port_up);
+    if (client_status != BF_SUCCESS) {
+      LOG_ERROR(
+          "Port status handing failed for dev %d, port %d,"
+          " sts %s (%d), Client %s ",
+          evt->dev_id,
+          evt->port_id,
+          bf_err_str(client_status),
+          client_status,
+          db_ptr->client_name);
+    }
+  }
+  if (evt->speed && db_ptr->callbacks.port_speed) {
+    client_status = db_ptr->callbacks.port_speed(evt->dev_id, evt->port_id);
+    if (client_status != BF_SUCCESS) {
+      LOG_ERROR(
+          "Port speed handing failed for dev %d, port %d,"
+          " sts %s (%d), Client %s ",
+          evt->dev_id,
+          evt->port_id,
+          bf_err_str(client_status),
+          client_status,
+          db_ptr->client_name);
+    }
+  }
+}
+
+static void *dvm_port_evt_worker(void *arg) {
+  dvm_port_evt_q_t *q = arg;
+  int qid = (int)(q - dvm_pevt_q);
+  dvm_port_evt_t batch[DVM_PORT_EVT_BATCH];
+  dvm_port_evt_rec_t *rec;
+  dvm_port_evt_t *evt;
+  unsigned long key;
+  int i, n;
+
+  bf_sys_mutex_lock(&q->mtx);
+  for (;;) {
+    while (!q->head && !q->stop) {
+      bf_sys_cond_wait(&q->cond, &q->mtx);
+    }
+    /* Pending events are still delivered when asked to stop. */
+    if (!q->head) break;
+
+    n = 0;
+    while (q->head && n < DVM_PORT_EVT_BATCH) {
+      rec = q->head;
+      q->head = rec->next;
+      if (!q->head) q->tail = NULL;
+      rec->next = NULL;
+      rec->queued = false;
+
+      evt = &batch[n];
+      evt->dev_id = rec->dev_id;
+      evt->port_id = rec->port_id;
+      evt->status = false;
+      evt->port_up = rec->port_up;
+      evt->speed = rec->speed_pending;
+      rec->speed_pending = false;
+      if (rec->status_pending) {
+        rec->status_pending = false;
+        if (rec->delivered_valid && rec->delivered_up == rec->port_up) {
+          q->coalesced[rec->dev_id]++;
+        } else {
+          evt->status = true;
+          rec->delivered_valid = true;
+          rec->delivered_up = rec->port_up;
+        }
+      }
+      if (evt->status || evt->speed) n++;
+    }
+    bf_sys_mutex_unlock(&q->mtx);
+
+    for (i = 0; i < n; i++) {
+      dvm_port_evt_deliver(qid, &batch[i]);
+    }
+
+    bf_sys_mutex_lock(&q->mtx);
+    for (i = 0; i < n; i++) {
+      q->delivered[batch[i].dev_id] += batch[i].status + batch[i].speed;
+    }
+  }
+
+  /* Drained, release the records.  The thread does it itself as it is not
+   * joined when it was stopped from one of its own callbacks. */
+  while (bf_map_get_first_rmv(&q->recs, &key, (void **)&rec) == BF_MAP_OK) {
+    bf_sys_free(rec);
+  }
+  bf_map_destroy(&q->recs);
+  q->head = q->tail = NULL;
+  q->running = false;
+  bf_sys_cond_broadcast(&q->cond);
+  bf_sys_mutex_unlock(&q->mtx);
+  return NULL;
+}
+
+static void dvm_port_evt_enqueue(dvm_port_evt_q_t *q,
+                                 bf_dev_id_t dev_id,
+                                 bf_dev_port_t port_id,
+                                 bool status_event,
+                                 bool port_up,
+                                 bool speed_event) {
+  unsigned long key = DVM_PORT_EVT_KEY(dev_id, port_id);
+  dvm_port_evt_rec_t *rec = NULL;
+  bf_map_sts_t msts;
+
+  bf_sys_mutex_lock(&q->mtx);
+  if (!q->async) {
+    bf_sys_mutex_unlock(&q->mtx);
+    return;
+  }
+
+  msts = bf_map_get(&q->recs, key, (void **)&rec);
+  if (msts != BF_MAP_OK) {
+    rec = bf_sys_calloc(1, sizeof *rec);
+    if (!rec || bf_map_add(&q->recs, key, rec) != BF_MAP_OK) {
+      bf_sys_mutex_unlock(&q->mtx);
+      if (rec) bf_sys_free(rec);
+      LOG_ERROR("Port event for dev %d, port %d dropped, no memory",
+                dev_id,
+                port_id);
+      return;
+    }
+    rec->dev_id = dev_id;
+    rec->port_id = port_id;
+  }
+
+  if (status_event) {
+    if (rec->status_pending) q->coalesced[dev_id]++;
+    rec->status_pending = true;
+    rec->port_up = port_up;
+    q->queued[dev_id]++;
+  }
+  if (speed_event) {
+    if (rec->speed_pending) q->coalesced[dev_id]++;
+    rec->speed_pending = true;
+    q->queued[dev_id]++;
+  }
+  if (!rec->queued) {
+    rec->queued = true;
+    if (q->tail) {
+      q->tail->next = rec;
+    } else {
+      q->head = rec;
+    }
+    q->tail = rec;
+    bf_sys_cond_wake(&q->cond);
+  }
+  bf_sys_mutex_unlock(&q->mtx);
+}
+
+/* Hand an event to every consumer on the bus, called with dvm_pevt_lock.
+ * An application which is not asynchronous gets the event on the port's inline
+ * list.  If no other thread is calling it for the port the caller must do so:
+ * the port is returned and *evt is the event to deliver first, see
+ * dvm_port_evt_inline_drain. */
+static dvm_port_inline_t *dvm_port_evt_fanout(bf_dev_id_t dev_id,
+                                              bf_dev_port_t port_id,
+                                              bool status_event,
+                                              bool port_up,
+                                              bool speed_event,
+                                              dvm_port_evt_t *evt) {
+  unsigned long key = DVM_PORT_EVT_KEY(dev_id, port_id);
+  dvm_port_inline_t *pi = NULL;
+  dvm_port_evt_node_t *node;
+  int qid;
+
+  if (!status_event && !speed_event) return NULL;
+
+  for (qid = 0; qid < DVM_PORT_EVT_NUM_Q; qid++) {
+    if (!dvm_pevt_q[qid].async) continue;
+    dvm_port_evt_enqueue(
+        &dvm_pevt_q[qid], dev_id, port_id, status_event, port_up, speed_event);
+  }
+
+  if (dvm_pevt_q[DVM_PORT_EVT_APP_Q].async) return NULL;
+  evt->dev_id = dev_id;
+  evt->port_id = port_id;
+  evt->status = status_event;
+  evt->port_up = port_up;
+  evt->speed = speed_event;
+
+  if (bf_map_get(&dvm_pevt_inline, key, (void **)&pi) != BF_MAP_OK) {
+    pi = bf_sys_calloc(1, sizeof *pi);
+    if (!pi || bf_map_add(&dvm_pevt_inline, key, pi) != BF_MAP_OK) {
+      if (pi) bf_sys_free(pi);
+      LOG_ERROR("Port event for dev %d, port %d dropped, no memory",
+                dev_id,
+                port_id);
+      return NULL;
+    }
+  }
+  if (!pi->busy) {
+    pi->busy = true;
+    return pi;
+  }
+
+  node = bf_sys_calloc(1, sizeof *node);
+  if (!node) {
+    LOG_ERROR(
+        "Port event for dev %d, port %d dropped, no memory", dev_id, port_id);
+    return NULL;
+  }
+  node->evt = *evt;
+  if (pi->tail) {
+    pi->tail->next = node;
+  } else {
+    pi->head = node;
+  }
+  pi->tail = node;
+  return NULL;
+}
+
+/* Call the application for evt and then for every event which was added to
+ * the port's inline list meanwhile, including those posted from the callback
+ * itself. */
+static void dvm_port_evt_inline_drain(dvm_port_inline_t *pi,
+                                      dvm_port_evt_t *evt) {
+  dvm_port_evt_node_t *node;
+
+  for (;;) {
+    dvm_port_evt_deliver(DVM_PORT_EVT_APP_Q, evt);
+
+    bf_sys_mutex_lock(&dvm_pevt_lock);
+    node = pi->head;
+    if (!node) {
+      pi->busy = false;
+      if (pi->orphan) bf_sys_free(pi);
+      bf_sys_mutex_unlock(&dvm_pevt_lock);
+      return;
+    }
+    pi->head = node->next;
+    if (!pi->head) pi->tail = NULL;
+    bf_sys_mutex_unlock(&dvm_pevt_lock);
+
+    *evt = node->evt;
+    bf_sys_free(node);
+  }
+}
+
+/* Drop a port's inline list after removing it from the map, called with
+ * dvm_pevt_lock.  A thread still delivering for the port frees it when done. */
+static void dvm_port_inline_free(dvm_port_inline_t *pi) {
+  dvm_port_evt_node_t *node;
+
+  while ((node = pi->head)) {
+    pi->head = node->next;
+    bf_sys_free(node);
+  }
+  pi->tail = NULL;
+  if (pi->busy) {
+    pi->orphan = true;
+  } else {
+    bf_sys_free(pi);
+  }
+}
+
+/* Figure of merit of a port at time now_ms.  Whole half-lives halve it, the
+ * remainder is interpolated linearly which keeps the error within 6%. */
+static uint32_t dvm_port_damp_merit(const dvm_port_damp_t *d,
+                                    uint32_t half_life_ms,
+                                    uint64_t now_ms) {
+  uint64_t elapsed, halvings, merit;
+
+  if (!d->merit) return 0;
+  elapsed = now_ms > d->stamp_ms ? now_ms - d->stamp_ms : 0;
+  halvings = elapsed / half_life_ms;
+  if (halvings >= 32) return 0;
+  merit = d->merit >> halvings;
+  merit -= merit * (elapsed % half_life_ms) / (2 * (uint64_t)half_life_ms);
+  return (uint32_t)merit;
+}
+
+static void dvm_port_damp_release(bf_dev_id_t dev_id, dvm_port_damp_t *d) {
+  d->suppressed = false;
+  dvm_pevt_num_suppressed--;
+  dvm_pevt_stats[dev_id].ports_suppressed--;
+  dvm_pevt_stats[dev_id].reused++;
+}
+
+/* Apply dampening to a link event, called with dvm_pevt_lock held.  Returns
+ * false if the event is to be withheld from the bus consumers. */
+static bool dvm_port_damp_event(bf_dev_id_t dev_id,
+                                bf_dev_port_t port_id,
+                                bool port_up) {
+  bf_drv_port_dampening_cfg_t *cfg = &dvm_pevt_damp_cfg[dev_id];
+  int idx = DEV_PORT_TO_BIT_IDX(port_id);
+  dvm_port_damp_t *d;
+  uint64_t now_ms, merit;
+
+  if (!BIT_IDX_VALIDATE(idx)) return true;
+  if (!dvm_pevt_damp[dev_id]) {
+    if (!cfg->enable) return true;
+    dvm_pevt_damp[dev_id] =
+        bf_sys_calloc(BF_PORT_COUNT, sizeof *dvm_pevt_damp[dev_id]);
+    if (!dvm_pevt_damp[dev_id]) return true;
+  }
+  d = &dvm_pevt_damp[dev_id][idx];
+  d->port_up = port_up;
+
+  if (!cfg->enable) {
+    /* Dampening was turned off while this port was held down. */
+    if (d->suppressed) dvm_port_damp_release(dev_id, d);
+    d->reported_valid = false;
+    return true;
+  }
+
+  if (!port_up) {
+    now_ms = dvm_port_evt_now_ms();
+    merit = dvm_port_damp_merit(d, cfg->half_life_ms, now_ms);
+    merit += cfg->penalty;
+    if (merit > dvm_pevt_damp_ceiling[dev_id]) {
+      merit = dvm_pevt_damp_ceiling[dev_id];
+    }
+    d->merit = (uint32_t)merit;
+    d->stamp_ms = now_ms;
+    if (!d->suppressed && d->merit >= cfg->suppress_threshold) {
+      d->suppressed = true;
+      dvm_pevt_num_suppressed++;
+      dvm_pevt_stats[dev_id].ports_suppressed++;
+      bf_sys_cond_wake(&dvm_pevt_damp_cond);
+      LOG_TRACE("Dev %d port %d link flaps suppressed", dev_id, port_id);
+    }
+  }
+
+  if (d->suppressed) {
+    /* The flap which crossed the threshold still reports the port down. */
+    if (!port_up && (!d->reported_valid || d->reported_up)) {
+      d->reported_valid = true;
+      d->reported_up = false;
+      return true;
+    }
+    dvm_pevt_stats[dev_id].suppressed++;
+    return false;
+  }
+
+  d->reported_valid = true;
+  d->reported_up = port_up;
+  return true;
+}
+
+static void *dvm_port_damp_worker(void *arg) {
+  dvm_port_evt_t reuse[DVM_PORT_EVT_BATCH];
+  dvm_port_inline_t *pi[DVM_PORT_EVT_BATCH];
+  dvm_port_damp_t *d;
+  uint64_t now_ms;
+  bf_dev_id_t dev_id;
+  int idx, i, n;
+
+  (void)arg;
+  bf_sys_mutex_lock(&dvm_pevt_lock);
+  for (;;) {
+    while (!dvm_pevt_num_suppressed && !dvm_pevt_damp_stop) {
+      bf_sys_cond_wait(&dvm_pevt_damp_cond, &dvm_pevt_lock);
+    }
+    if (dvm_pevt_damp_stop) break;
+    bf_sys_mutex_unlock(&dvm_pevt_lock);
+
+    bf_sys_usleep(DVM_PORT_DAMP_POLL_US);
+
+    bf_sys_mutex_lock(&dvm_pevt_lock);
+    if (dvm_pevt_damp_stop) break;
+    now_ms = dvm_port_evt_now_ms();
+    n = 0;
+    for (dev_id = 0; dev_id < BF_MAX_DEV_COUNT; dev_id++) {
+      if (!dvm_pevt_damp[dev_id] || !dvm_pevt_stats[dev_id].ports_suppressed) {
+        continue;
+      }
+      for (idx = 0; idx < BF_PORT_COUNT && n < DVM_PORT_EVT_BATCH; idx++) {
+        d = &dvm_pevt_damp[dev_id][idx];
+        if (!d->suppressed) continue;
+        if (dvm_pevt_damp_cfg[dev_id].enable &&
+            dvm_port_damp_merit(
+                d, dvm_pevt_damp_cfg[dev_id].half_life_ms, now_ms) >=
+                dvm_pevt_damp_cfg[dev_id].reuse_threshold) {
+          continue;
+        }
+        dvm_port_damp_release(dev_id, d);
+        if (d->reported_valid && d->reported_up == d->port_up) continue;
+        d->reported_valid = true;
+        d->reported_up = d->port_up;
+        LOG_TRACE("Dev %d port %d link flaps no longer suppressed, link %s",
+                  dev_id,
+                  BIT_IDX_TO_DEV_PORT(idx),
+                  d->port_up ? "up" : "down");
+        pi[n] = dvm_port_evt_fanout(dev_id,
+                                    BIT_IDX_TO_DEV_PORT(idx),
+                                    true,
+                                    d->port_up,
+                                    false,
+                                    &reuse[n]);
+        n++;
+      }
+    }
+    bf_sys_mutex_unlock(&dvm_pevt_lock);
+
+    for (i = 0; i < n; i++) {
+      if (pi[i]) dvm_port_evt_inline_drain(pi[i], &reuse[i]);
+    }
+    bf_sys_mutex_lock(&dvm_pevt_lock);
+  }
+  dvm_pevt_damp_thread_running = false;
+  bf_sys_mutex_unlock(&dvm_pevt_lock);
+  return NULL;
+}
+
+/* True if the device's events need neither the dampening decision nor a
+ * queue.  Read without dvm_pevt_lock, a consumer or dampening being enabled
+ * concurrently applies from the next event on. */
+static bool dvm_port_evt_bus_idle(bf_dev_id_t dev_id) {
+  return !dvm_pevt_num_async && !dvm_pevt_damp_cfg[dev_id].enable &&
+         !dvm_pevt_stats[dev_id].ports_suppressed;
+}
+
+/* Entry point from bf_drv_notify_clients_port_status_chg */
+void dvm_port_evt_post(bf_dev_id_t dev_id,
+                       bf_dev_port_t port_id,
+                       bool status_event,
+                       bool port_up,
+                       bool speed_event) {
+  dvm_port_inline_t *pi;
+  dvm_port_evt_t evt;
+
+  if (dev_id < 0 || dev_id >= BF_MAX_DEV_COUNT) return;
+  if (!status_event && !speed_event) return;
+  if (!dvm_pevt_init_done || dvm_port_evt_bus_idle(dev_id)) {
+    /* Only the application can be listening, call it directly. */
+    evt.dev_id = dev_id;
+    evt.port_id = port_id;
+    evt.status = status_event;
+    evt.port_up = port_up;
+    evt.speed = speed_event;
+    dvm_port_evt_deliver(DVM_PORT_EVT_APP_Q, &evt);
+    return;
+  }
+
+  bf_sys_mutex_lock(&dvm_pevt_lock);
+  dvm_pevt_stats[dev_id].events += status_event + speed_event;
+  if (status_event && !dvm_port_damp_event(dev_id, port_id, port_up)) {
+    status_event = false;
+  }
+  pi = dvm_port_evt_fanout(
+      dev_id, port_id, status_event, port_up, speed_event, &evt);
+  bf_sys_mutex_unlock(&dvm_pevt_lock);
+
+  if (pi) dvm_port_evt_inline_drain(pi, &evt);
+}
+
+/* Forget queued events and dampening state of a device being removed. */
+void dvm_port_evt_dev_del(bf_dev_id_t dev_id) {
+  dvm_port_evt_rec_t *rec, **prev;
+  dvm_port_inline_t *pi;
+  dvm_port_evt_q_t *q;
+  dvm_port_damp_t *damp;
+  unsigned long key;
+  int qid, idx;
+
+  if (!dvm_pevt_init_done) return;
+  if (dev_id < 0 || dev_id >= BF_MAX_DEV_COUNT) return;
+
+  bf_sys_mutex_lock(&dvm_pevt_lock);
+  for (qid = 0; qid < DVM_PORT_EVT_NUM_Q; qid++) {
+    q = &dvm_pevt_q[qid];
+    bf_sys_mutex_lock(&q->mtx);
+    if (!q->async) {
+      bf_sys_mutex_unlock(&q->mtx);
+      continue;
+    }
+    prev = &q->head;
+    q->tail = NULL;
+    while ((rec = *prev)) {
+      if (rec->dev_id == dev_id) {
+        *prev = rec->next;
+      } else {
+        q->tail = rec;
+        prev = &rec->next;
+      }
+    }
+    for (idx = 0; idx < BF_PORT_COUNT; idx++) {
+      key = DVM_PORT_EVT_KEY(dev_id, BIT_IDX_TO_DEV_PORT(idx));
+      if (bf_map_get_rmv(&q->recs, key, (void **)&rec) == BF_MAP_OK) {
+        bf_sys_free(rec);
+      }
+    }
+    bf_sys_mutex_unlock(&q->mtx);
+  }
+
+  for (idx = 0; idx < BF_PORT_COUNT; idx++) {
+    key = DVM_PORT_EVT_KEY(dev_id, BIT_IDX_TO_DEV_PORT(idx));
+    if (bf_map_get_rmv(&dvm_pevt_inline, key, (void **)&pi) == BF_MAP_OK) {
+      dvm_port_inline_free(pi);
+    }
+  }
+
+  damp = dvm_pevt_damp[dev_id];
+  dvm_pevt_damp[dev_id] = NULL;
+  if (damp) {
+    for (idx = 0; idx < BF_PORT_COUNT; idx++) {
+      if (damp[idx].suppressed) dvm_pevt_num_suppressed--;
+    }
+  }
+  dvm_pevt_stats[dev_id].ports_suppressed = 0;
+  bf_sys_mutex_unlock(&dvm_pevt_lock);
+
+  if (damp) bf_sys_free(damp);
+}
+
+static void dvm_port_evt_num_async_add(int n) {
+  bf_sys_mutex_lock(&dvm_pevt_lock);
+  dvm_pevt_num_async += n;
+  bf_sys_mutex_unlock(&dvm_pevt_lock);
+}
+
+static bf_status_t dvm_port_evt_q_async_set(int qid, bool async) {
+  dvm_port_evt_q_t *q = &dvm_pevt_q[qid];
+  bf_sys_thread_t thread;
+  bool self;
+  char name[16];
+
+  /* Count the consumer before it can be seen as asynchronous, otherwise a
+   * concurrent post finding the bus idle would deliver inline to it.  The
+   * count cannot be taken with q->mtx held, dvm_pevt_lock is taken first. */
+  if (async) dvm_port_evt_num_async_add(1);
+  bf_sys_mutex_lock(&q->mtx);
+  if (q->async == async) {
+    bf_sys_mutex_unlock(&q->mtx);
+    if (async) dvm_port_evt_num_async_add(-1);
+    return BF_SUCCESS;
+  }
+  self = q->running && q->thread == bf_sys_thread_self();
+
+  if (async) {
+    /* A thread stopped from its own callback may still be draining. */
+    if (self) {
+      bf_sys_mutex_unlock(&q->mtx);
+      dvm_port_evt_num_async_add(-1);
+      return BF_IN_USE;
+    }
+    while (q->running) bf_sys_cond_wait(&q->cond, &q->mtx);
+    bf_map_init(&q->recs);
+    q->head = q->tail = NULL;
+    q->stop = false;
+    if (bf_sys_thread_create(&q->thread, dvm_port_evt_worker, q, 0)) {
+      bf_map_destroy(&q->recs);
+      bf_sys_mutex_unlock(&q->mtx);
+      dvm_port_evt_num_async_add(-1);
+      LOG_ERROR("Failed to start port event thread for client %d", qid);
+      return BF_NO_SYS_RESOURCES;
+    }
+    snprintf(name, sizeof name, "bf_port_evt_%d", qid);
+    bf_sys_thread_set_name(q->thread, name);
+    q->running = true;
+    q->async = true;
+    bf_sys_mutex_unlock(&q->mtx);
+    return BF_SUCCESS;
+  }
+
+  /* Stop taking events and let the thread drain what is already queued. */
+  q->async = false;
+  q->stop = true;
+  thread = q->thread;
+  bf_sys_cond_broadcast(&q->cond);
+  bf_sys_mutex_unlock(&q->mtx);
+  dvm_port_evt_num_async_add(-1);
+  if (self) {
+    /* Called from one of the thread's own callbacks, e.g. a client which
+     * deregisters on a port event.  It cannot join itself, it finishes once
+     * the callback returns. */
+    bf_sys_thread_detach(thread);
+  } else {
+    bf_sys_thread_join(thread, NULL);
+  }
+  return BF_SUCCESS;
+}
+
+/* Stop the port event threads at driver teardown.  Events already queued are
+ * delivered, dampening is turned off and its state dropped. */
+void dvm_port_evt_cleanup(void) {
+  dvm_port_damp_t *damp[BF_MAX_DEV_COUNT];
+  dvm_port_inline_t *pi;
+  bf_sys_thread_t thread = NULL;
+  bool stop_damp, self = false;
+  unsigned long key;
+  bf_dev_id_t dev_id;
+  int qid;
+
+  if (!dvm_pevt_init_done) return;
+
+  for (qid = 0; qid < DVM_PORT_EVT_NUM_Q; qid++) {
+    dvm_port_evt_q_async_set(qid, false);
+  }
+
+  bf_sys_mutex_lock(&dvm_pevt_lock);
+  stop_damp = dvm_pevt_damp_thread_running;
+  if (stop_damp) {
+    dvm_pevt_damp_stop = true;
+    thread = dvm_pevt_damp_thread;
+    self = thread == bf_sys_thread_self();
+    bf_sys_cond_broadcast(&dvm_pevt_damp_cond);
+  }
+  for (dev_id = 0; dev_id < BF_MAX_DEV_COUNT; dev_id++) {
+    damp[dev_id] = dvm_pevt_damp[dev_id];
+    dvm_pevt_damp[dev_id] = NULL;
+    dvm_pevt_damp_cfg[dev_id].enable = false;
+    dvm_pevt_stats[dev_id].ports_suppressed = 0;
+  }
+  dvm_pevt_num_suppressed = 0;
+  while (bf_map_get_first_rmv(&dvm_pevt_inline, &key, (void **)&pi) ==
+         BF_MAP_OK) {
+    dvm_port_inline_free(pi);
+  }
+  bf_sys_mutex_unlock(&dvm_pevt_lock);
+
+  if (stop_damp) {
+    /* From an application callback run by the dampening thread, see
+     * dvm_port_evt_q_async_set. */
+    if (self) {
+      bf_sys_thread_detach(thread);
+    } else {
+      bf_sys_thread_join(thread, NULL);
+    }
+  }
+  for (dev_id = 0; dev_id < BF_MAX_DEV_COUNT; dev_id++) {
+    if (damp[dev_id]) bf_sys_free(damp[dev_id]);
+  }
+}
+
+bool dvm_port_evt_client_is_async(bf_drv_client_handle_t client_handle) {
+  if (client_handle < 0 || client_handle >= BF_DRV_MAX_CLIENTS) return false;
+  return dvm_pevt_q[client_handle].async;
+}
+
+bf_status_t bf_drv_client_port_events_async_set(
+    bf_drv_client_handle_t client_handle, bool async) {
+  if (!dvm_pevt_init_done) return BF_NOT_READY;
+  if (client_handle < 0 || client_handle >= BF_DRV_MAX_CLIENTS) {
+    return BF_INVALID_ARG;
+  }
+  if (async && !bf_drv_hdl_info[client_handle].allocated) {
+    return BF_INVALID_ARG;
+  }
+  return dvm_port_evt_q_async_set(client_handle, async);
+}
+
+bf_status_t bf_port_client_port_events_async_set(bool async) {
+  if (!dvm_pevt_init_done) return BF_NOT_READY;
+  return dvm_port_evt_q_async_set(DVM_PORT_EVT_APP_Q, async);
+}
+
+bf_status_t bf_drv_port_event_dampening_set(
+    bf_dev_id_t dev_id, const bf_drv_port_dampening_cfg_t *cfg) {
+  bf_drv_port_dampening_cfg_t new_cfg;
+  dvm_port_damp_t *damp;
+  uint64_t ceiling;
+  uint32_t i;
+  int idx;
+
+  if (!dvm_pevt_init_done) return BF_NOT_READY;
+  if (dev_id < 0 || dev_id >= BF_MAX_DEV_COUNT || !cfg) {
+    return BF_INVALID_ARG;
+  }
+
+  new_cfg = *cfg;
+  if (new_cfg.enable) {
+    if (!new_cfg.penalty) new_cfg.penalty = DVM_PORT_DAMP_DEF_PENALTY;
+    if (!new_cfg.suppress_threshold) {
+      new_cfg.suppress_threshold = DVM_PORT_DAMP_DEF_SUPPRESS;
+    }
+    if (!new_cfg.reuse_threshold) {
+      new_cfg.reuse_threshold = DVM_PORT_DAMP_DEF_REUSE;
+    }
+    if (!new_cfg.half_life_ms) {
+      new_cfg.half_life_ms = DVM_PORT_DAMP_DEF_HALF_LIFE_MS;
+    }
+    if (!new_cfg.max_suppress_ms) {
+      new_cfg.max_suppress_ms = DVM_PORT_DAMP_DEF_MAX_SUPPRESS_MS;
+    }
+    if (new_cfg.reuse_threshold >= new_cfg.suppress_threshold ||
+        new_cfg.max_suppress_ms < new_cfg.half_life_ms) {
+      return BF_INVALID_ARG;
+    }
+  }
+
+  /* Highest merit which still decays to the reuse threshold within the
+   * maximum suppress time. */
+  ceiling = new_cfg.reuse_threshold;
+  if (new_cfg.enable) {
+    for (i = new_cfg.max_suppress_ms / new_cfg.half_life_ms;
+         i && ceiling < UINT32_MAX;
+         i--) {
+      ceiling <<= 1;
+    }
+    if (ceiling > UINT32_MAX) ceiling = UINT32_MAX;
+    /* Ports could never be suppressed with these parameters. */
+    if (ceiling < new_cfg.suppress_threshold) return BF_INVALID_ARG;
+  }
+
+  bf_sys_mutex_lock(&dvm_pevt_lock);
+  damp = dvm_pevt_damp[dev_id];
+  if (new_cfg.enable && !dvm_pevt_damp_cfg[dev_id].enable && damp) {
+    /* State tracked before dampening was last disabled is stale. */
+    for (idx = 0; idx < BF_PORT_COUNT; idx++) {
+      if (damp[idx].suppressed) continue;
+      damp[idx].merit = 0;
+      damp[idx].reported_valid = false;
+    }
+  }
+  dvm_pevt_damp_cfg[dev_id] = new_cfg;
+  dvm_pevt_damp_ceiling[dev_id] = (uint32_t)ceiling;
+  if (new_cfg.enable && !dvm_pevt_damp_thread_running) {
+    dvm_pevt_damp_stop = false;
+    if (bf_sys_thread_create(
+            &dvm_pevt_damp_thread, dvm_port_damp_worker, NULL, 0)) {
+      dvm_pevt_damp_cfg[dev_id].enable = false;
+      bf_sys_mutex_unlock(&dvm_pevt_lock);
+      LOG_ERROR("Failed to start port dampening thread");
+      return BF_NO_SYS_RESOURCES;
+    }
+    bf_sys_thread_set_name(dvm_pevt_damp_thread, "bf_port_damp");
+    dvm_pevt_damp_thread_running = true;
+  }
+  /* Ports still held down are released by the dampening thread. */
+  bf_sys_cond_wake(&dvm_pevt_damp_cond);
+  bf_sys_mutex_unlock(&dvm_pevt_lock);
+  return BF_SUCCESS;
+}
+
+bf_status_t bf_drv_port_event_dampening_get(bf_dev_id_t dev_id,
+                                            bf_drv_port_dampening_cfg_t *cfg) {
+  if (!dvm_pevt_init_done) return BF_NOT_READY;
+  if (dev_id < 0 || dev_id >= BF_MAX_DEV_COUNT || !cfg) {
+    return BF_INVALID_ARG;
+  }
+
+  bf_sys_mutex_lock(&dvm_pevt_lock);
+  *cfg = dvm_pevt_damp_cfg[dev_id];
+  bf_sys_mutex_unlock(&dvm_pevt_lock);
+  return BF_SUCCESS;
+}
+
+bf_status_t bf_drv_port_event_stats_get(bf_dev_id_t dev_id,
+                                        bf_drv_port_event_stats_t *stats) {
+  dvm_port_evt_q_t *q;
+  int qid;
+
+  if (!dvm_pevt_init_done) return BF_NOT_READY;
+  if (dev_id < 0 || dev_id >= BF_MAX_DEV_COUNT || !stats) {
+    return BF_INVALID_ARG;
+  }
+
+  bf_sys_mutex_lock(&dvm_pevt_lock);
+  *stats = dvm_pevt_stats[dev_id];
+  bf_sys_mutex_unlock(&dvm_pevt_lock);
+
+  for (qid = 0; qid < DVM_PORT_EVT_NUM_Q; qid++) {
+    q = &dvm_pevt_q[qid];
+    bf_sys_mutex_lock(&q->mtx);
+    stats->queued += q->queued[dev_id];
+    stats->coalesced += q->coalesced[dev_id];
+    stats->delivered += q->delivered[dev_id];
+    bf_sys_mutex_unlock(&q->mtx);
+  }
+  return BF_SUCCESS;
+}
+
+bf_status_t bf_drv_port_event_stats_clear(bf_dev_id_t dev_id) {
+  dvm_port_evt_q_t *q;
+  uint32_t ports_suppressed;
+  int qid;
+
+  if (!dvm_pevt_init_done) return BF_NOT_READY;
+  if (dev_id < 0 || dev_id >= BF_MAX_DEV_COUNT) return BF_INVALID_ARG;
+
+  bf_sys_mutex_lock(&dvm_pevt_lock);
+  /* Not a counter, keep tracking the ports held down. */
+  ports_suppressed = dvm_pevt_stats[dev_id].ports_suppressed;
+  memset(&dvm_pevt_stats[dev_id], 0, sizeof dvm_pevt_stats[dev_id]);
+  dvm_pevt_stats[dev_id].ports_suppressed = ports_suppressed;
+  bf_sys_mutex_unlock(&dvm_pevt_lock);
+
+  for (qid = 0; qid < DVM_PORT_EVT_NUM_Q; qid++) {
+    q = &dvm_pevt_q[qid];
+    bf_sys_mutex_lock(&q->mtx);
+    q->queued[dev_id] = 0;
+    q->coalesced[dev_id] = 0;
+    q->delivered[dev_id] = 0;
+    bf_sys_mutex_unlock(&q->mtx);
+  }
+  return BF_SUCCESS;
+}
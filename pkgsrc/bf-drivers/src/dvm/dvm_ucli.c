@@ -22,6 +22,7 @@
 
 #if DVM_CONFIG_INCLUDE_UCLI == 1
 
+#include <inttypes.h>
 #include <target-utils/uCli/ucli.h>
 #include <target-utils/uCli/ucli_argparse.h>
 #include <target-utils/uCli/ucli_handler_macros.h>
@@ -364,6 +365,166 @@ static ucli_status_t dvm_ucli_ucli__port_ct__(ucli_context_t *uc) {
   return 0;
 }
 
+static ucli_status_t dvm_ucli_ucli__port_evt__(ucli_context_t *uc) {
+  bf_dev_id_t asic;
+  bf_drv_port_dampening_cfg_t cfg;
+  bf_drv_port_event_stats_t stats;
+  bf_status_t rc;
+
+  UCLI_COMMAND_INFO(
+      uc, "port-evt", 1, "port-evt <asic> Show port event bus counters");
+
+  asic = atoi(uc->pargs->args[0]);
+
+  if (asic >= BF_MAX_DEV_COUNT) {
+    aim_printf(&uc->pvs,
+               "Only %d chips defined. Correct command or update "
+               "lldif/inc/lldif/sdk_bsp.h\n",
+               BF_MAX_DEV_COUNT);
+    return 0;
+  }
+
+  rc = bf_drv_port_event_dampening_get(asic, &cfg);
+  if (rc == BF_SUCCESS) rc = bf_drv_port_event_stats_get(asic, &stats);
+  if (rc != BF_SUCCESS) {
+    aim_printf(&uc->pvs, "DVM:: port-evt Status=%s\n", bf_err_str(rc));
+    return 0;
+  }
+
+  if (cfg.enable) {
+    aim_printf(&uc->pvs,
+               "Dampening: penalty %u suppress %u reuse %u half-life %ums "
+               "max-suppress %ums\n",
+               cfg.penalty,
+               cfg.suppress_threshold,
+               cfg.reuse_threshold,
+               cfg.half_life_ms,
+               cfg.max_suppress_ms);
+  } else {
+    aim_printf(&uc->pvs, "Dampening: disabled\n");
+  }
+  aim_printf(&uc->pvs, "%-18s %" PRIu64 "\n", "Events", stats.events);
+  aim_printf(&uc->pvs, "%-18s %" PRIu64 "\n", "Queued", stats.queued);
+  aim_printf(&uc->pvs, "%-18s %" PRIu64 "\n", "Coalesced", stats.coalesced);
+  aim_printf(&uc->pvs, "%-18s %" PRIu64 "\n", "Delivered", stats.delivered);
+  aim_printf(&uc->pvs, "%-18s %" PRIu64 "\n", "Suppressed", stats.suppressed);
+  aim_printf(&uc->pvs, "%-18s %" PRIu64 "\n", "Reused", stats.reused);
+  aim_printf(
+      &uc->pvs, "%-18s %u\n", "Ports suppressed", stats.ports_suppressed);
+
+  return 0;
+}
+
+static ucli_status_t dvm_ucli_ucli__port_evt_clear__(ucli_context_t *uc) {
+  bf_dev_id_t asic;
+  bf_status_t rc;
+
+  UCLI_COMMAND_INFO(uc,
+                    "port-evt-clear",
+                    1,
+                    "port-evt-clear <asic> Clear port event bus counters");
+
+  asic = atoi(uc->pargs->args[0]);
+
+  if (asic >= BF_MAX_DEV_COUNT) {
+    aim_printf(&uc->pvs,
+               "Only %d chips defined. Correct command or update "
+               "lldif/inc/lldif/sdk_bsp.h\n",
+               BF_MAX_DEV_COUNT);
+    return 0;
+  }
+
+  rc = bf_drv_port_event_stats_clear(asic);
+  aim_printf(&uc->pvs,
+             "DVM:: port-evt-clear <asic=%d> Status=%s\n",
+             asic,
+             bf_err_str(rc));
+  return 0;
+}
+
+static ucli_status_t dvm_ucli_ucli__port_evt_damp__(ucli_context_t *uc) {
+  bf_drv_port_dampening_cfg_t cfg;
+  bf_dev_id_t asic;
+  bf_status_t rc;
+
+  UCLI_COMMAND_INFO(uc,
+                    "port-evt-damp",
+                    -1,
+                    "port-evt-damp <asic> <0/1> [<penalty> <suppress> "
+                    "<reuse> <half-life-ms> <max-suppress-ms>]");
+
+  if (uc->pargs->count != 2 && uc->pargs->count != 7) {
+    aim_printf(&uc->pvs,
+               "Usage: port-evt-damp <asic> <0/1> [<penalty> <suppress> "
+               "<reuse> <half-life-ms> <max-suppress-ms>]\n");
+    return 0;
+  }
+
+  asic = atoi(uc->pargs->args[0]);
+
+  if (asic >= BF_MAX_DEV_COUNT) {
+    aim_printf(&uc->pvs,
+               "Only %d chips defined. Correct command or update "
+               "lldif/inc/lldif/sdk_bsp.h\n",
+               BF_MAX_DEV_COUNT);
+    return 0;
+  }
+
+  memset(&cfg, 0, sizeof cfg);
+  cfg.enable = atoi(uc->pargs->args[1]) != 0;
+  if (uc->pargs->count == 7) {
+    cfg.penalty = strtoul(uc->pargs->args[2], NULL, 0);
+    cfg.suppress_threshold = strtoul(uc->pargs->args[3], NULL, 0);
+    cfg.reuse_threshold = strtoul(uc->pargs->args[4], NULL, 0);
+    cfg.half_life_ms = strtoul(uc->pargs->args[5], NULL, 0);
+    cfg.max_suppress_ms = strtoul(uc->pargs->args[6], NULL, 0);
+  }
+
+  rc = bf_drv_port_event_dampening_set(asic, &cfg);
+  aim_printf(&uc->pvs,
+             "DVM:: port-evt-damp <asic=%d> <enable=%d> Status=%s\n",
+             asic,
+             cfg.enable,
+             bf_err_str(rc));
+  return 0;
+}
+
+static ucli_status_t dvm_ucli_ucli__port_evt_async__(ucli_context_t *uc) {
+  bf_drv_client_handle_t client;
+  bool async;
+  bf_status_t rc;
+
+  UCLI_COMMAND_INFO(uc,
+                    "port-evt-async",
+                    -1,
+                    "port-evt-async <0/1> [<client-handle>] Deliver the "
+                    "application's or a client's port events from a thread");
+
+  if (uc->pargs->count != 1 && uc->pargs->count != 2) {
+    aim_printf(&uc->pvs, "Usage: port-evt-async <0/1> [<client-handle>]\n");
+    return 0;
+  }
+
+  async = atoi(uc->pargs->args[0]) != 0;
+  if (uc->pargs->count == 1) {
+    rc = bf_port_client_port_events_async_set(async);
+    aim_printf(&uc->pvs,
+               "DVM:: port-evt-async <async=%d> Status=%s\n",
+               async,
+               bf_err_str(rc));
+    return 0;
+  }
+
+  client = atoi(uc->pargs->args[1]);
+  rc = bf_drv_client_port_events_async_set(client, async);
+  aim_printf(&uc->pvs,
+             "DVM:: port-evt-async <async=%d> <client=%d> Status=%s\n",
+             async,
+             client,
+             bf_err_str(rc));
+  return 0;
+}
+
 static ucli_status_t dvm_ucli_ucli__cfg__(ucli_context_t *uc) {
   UCLI_COMMAND_INFO(uc, "cfg", 0, "cfg");
 
@@ -383,6 +544,10 @@ static ucli_command_handler_f dvm_ucli_ucli_handlers__[] = {
     dvm_ucli_ucli__ena_port__,
     dvm_ucli_ucli__dis_port__,
     dvm_ucli_ucli__port_ct__,
+    dvm_ucli_ucli__port_evt__,
+    dvm_ucli_ucli__port_evt_clear__,
+    dvm_ucli_ucli__port_evt_damp__,
+    dvm_ucli_ucli__port_evt_async__,
     dvm_ucli_ucli__cfg__,
     NULL};
 
@@ -138,6 +138,8 @@ typedef struct lld_dma_log_t {
 
 bf_sys_mutex_t lld_dma_log_mtx;  // lock for log
 lld_dma_log_t lld_dma_log;
+/* Whether descriptor pushes and pulls are recorded in the DMA log. */
+static bool lld_dma_log_en = true;
 
 void lld_dma_log_init(void) {
   int x;
@@ -148,21 +150,12 @@ void lld_dma_log_init(void) {
   }
 }
 
-/* 0=push
- * 1=pull
- * 2=start
- * 3=service
- * 4=DMA Wr
- * 5=DMA Rd
- */
-void lld_log_dma(int dir,
-                 bf_dev_id_t dev_id,
-                 bf_subdev_id_t subdev_id,
-                 uint32_t dr,
-                 uint64_t *data,
-                 int n_wds,
-                 uint64_t head,
-                 uint64_t tail) {
+void lld_dma_log_enable_set(bool en) { lld_dma_log_en = en; }
+
+bool lld_dma_log_enabled(void) { return lld_dma_log_en; }
+
+/* Reserve n consecutive entries in the log, returns the first one. */
+static int lld_dma_log_reserve(int n) {
   int e;
   int x;
   // lock entry determination
@@ -171,17 +164,26 @@ void lld_log_dma(int dir,
     lld_log_error("Error: DMA Log lock acquire failed: <%d>", x);
   }
 
-  e = lld_dma_log.next++;
-  if (lld_dma_log.next == LLD_DMA_LOG_SZ) {
-    lld_dma_log.next = 0;
-  }
+  e = lld_dma_log.next;
+  lld_dma_log.next = (lld_dma_log.next + n) % LLD_DMA_LOG_SZ;
   x = bf_sys_mutex_unlock(&lld_dma_log_mtx);
   if (x) {
     lld_log_error("Error: DMA Log lock release failed: <%d>", x);
   }
+  return e;
+}
 
-  gettimeofday(&lld_dma_log.entry[e].tm, NULL);
-
+static void lld_dma_log_fill(int e,
+                             int dir,
+                             bf_dev_id_t dev_id,
+                             bf_subdev_id_t subdev_id,
+                             uint32_t dr,
+                             uint64_t *data,
+                             int n_wds,
+                             uint64_t head,
+                             uint64_t tail,
+                             struct timeval *tm) {
+  lld_dma_log.entry[e].tm = *tm;
   lld_dma_log.entry[e].dir = dir;
   lld_dma_log.entry[e].dev_id = dev_id;
   lld_dma_log.entry[e].subdev_id = subdev_id;
@@ -201,6 +203,67 @@ void lld_log_dma(int dir,
   }
 }
 
+/* 0=push
+ * 1=pull
+ * 2=start
+ * 3=service
+ * 4=DMA Wr
+ * 5=DMA Rd
+ */
+void lld_log_dma(int dir,
+                 bf_dev_id_t dev_id,
+                 bf_subdev_id_t subdev_id,
+                 uint32_t dr,
+                 uint64_t *data,
+                 int n_wds,
+                 uint64_t head,
+                 uint64_t tail) {
+  struct timeval tm;
+  int e = lld_dma_log_reserve(1);
+
+  gettimeofday(&tm, NULL);
+  lld_dma_log_fill(
+      e, dir, dev_id, subdev_id, dr, data, n_wds, head, tail, &tm);
+}
+
+/* Log a burst of n_descs descriptors of n_wds words each, laid out back to
+ * back in data. The entries are reserved at once and share the timestamp
+ * and the head/tail pointers of the end of the burst. Only the last
+ * LLD_DMA_LOG_SZ descriptors of a larger burst are kept.
+ */
+void lld_log_dma_n(int dir,
+                   bf_dev_id_t dev_id,
+                   bf_subdev_id_t subdev_id,
+                   uint32_t dr,
+                   uint64_t *data,
+                   int n_wds,
+                   int n_descs,
+                   uint64_t head,
+                   uint64_t tail) {
+  struct timeval tm;
+  int e, i;
+
+  if (n_descs <= 0) return;
+  if (n_descs > LLD_DMA_LOG_SZ) {
+    data += (n_descs - LLD_DMA_LOG_SZ) * n_wds;
+    n_descs = LLD_DMA_LOG_SZ;
+  }
+  e = lld_dma_log_reserve(n_descs);
+  gettimeofday(&tm, NULL);
+  for (i = 0; i < n_descs; i++) {
+    lld_dma_log_fill((e + i) % LLD_DMA_LOG_SZ,
+                     dir,
+                     dev_id,
+                     subdev_id,
+                     dr,
+                     data + (i * n_wds),
+                     n_wds,
+                     head,
+                     tail,
+                     &tm);
+  }
+}
+
 // TBD need to pass subdev_id, work with dru_sim on this
 void lld_log_dma_op(bf_dev_id_t dev_id, int is_wr, int len, uint64_t addr) {
   uint64_t tmp[4];
@@ -530,6 +530,12 @@ static inline int get_dr_pos(bf_dev_id_t dev_id,
   return LLD_OK;
 }
 
+/* Views not backed by a device DR, such as the scratch view of the ucli
+ * "dr_push_perf" command, use BF_DMA_NO_DR and are never logged. */
+static inline bool dr_push_logged(lld_dr_view_t *view) {
+  return view->dr_id != BF_DMA_NO_DR && lld_dma_log_enabled();
+}
+
 /***********************************************************
  * dr_push_1
  *
@@ -559,6 +565,7 @@ int dr_push_1(struct lld_dr_view_s *view, uint64_t *desc) {
                  &dr_wrap_bit_pos,
                  &tail_ptr,
                  &tail_wrap_bit)) {
+    lld_dr_unlock(view, LLD_DR_LOCK_RING);
     return LLD_ERR_BAD_PARM;
   }
   dr_desc_addr = (uint64_t *)(uintptr_t)(
@@ -577,14 +584,16 @@ int dr_push_1(struct lld_dr_view_s *view, uint64_t *desc) {
     view->tail = (view->tail + 1) | (tail_wrap_bit << dr_wrap_bit_pos);
   }
 
-  lld_log_dma(0 /*push*/,
-              view->dev_id,
-              view->subdev_id,
-              view->dr_id,
-              desc,
-              1,
-              view->head,
-              view->tail);
+  if (dr_push_logged(view)) {
+    lld_log_dma(0 /*push*/,
+                view->dev_id,
+                view->subdev_id,
+                view->dr_id,
+                desc,
+                1,
+                view->head,
+                view->tail);
+  }
   view->n_descs++;
   lld_dr_unlock(view, LLD_DR_LOCK_RING);
 
@@ -620,6 +629,7 @@ int dr_push_2(struct lld_dr_view_s *view, uint64_t *desc) {
                  &dr_wrap_bit_pos,
                  &tail_ptr,
                  &tail_wrap_bit)) {
+    lld_dr_unlock(view, LLD_DR_LOCK_RING);
     return LLD_ERR_BAD_PARM;
   }
   dr_desc_addr = (uint64_t *)(uintptr_t)(
@@ -639,14 +649,16 @@ int dr_push_2(struct lld_dr_view_s *view, uint64_t *desc) {
     view->tail = (view->tail + 1) | (tail_wrap_bit << dr_wrap_bit_pos);
   }
 
-  lld_log_dma(0 /*push*/,
-              view->dev_id,
-              view->subdev_id,
-              view->dr_id,
-              desc,
-              2,
-              view->head,
-              view->tail);
+  if (dr_push_logged(view)) {
+    lld_log_dma(0 /*push*/,
+                view->dev_id,
+                view->subdev_id,
+                view->dr_id,
+                desc,
+                2,
+                view->head,
+                view->tail);
+  }
   view->n_descs++;
   lld_dr_unlock(view, LLD_DR_LOCK_RING);
 
@@ -682,6 +694,7 @@ int dr_push_4(struct lld_dr_view_s *view, uint64_t *desc) {
                  &dr_wrap_bit_pos,
                  &tail_ptr,
                  &tail_wrap_bit)) {
+    lld_dr_unlock(view, LLD_DR_LOCK_RING);
     return LLD_ERR_BAD_PARM;
   }
   dr_desc_addr = (uint64_t *)(uintptr_t)(
@@ -706,20 +719,97 @@ int dr_push_4(struct lld_dr_view_s *view, uint64_t *desc) {
     view->tail = (view->tail + 1) | (tail_wrap_bit << dr_wrap_bit_pos);
   }
 
-  lld_log_dma(0 /*push*/,
-              view->dev_id,
-              view->subdev_id,
-              view->dr_id,
-              desc,
-              4,
-              view->head,
-              view->tail);
+  if (dr_push_logged(view)) {
+    lld_log_dma(0 /*push*/,
+                view->dev_id,
+                view->subdev_id,
+                view->dr_id,
+                desc,
+                4,
+                view->head,
+                view->tail);
+  }
   view->n_descs++;
   lld_dr_unlock(view, LLD_DR_LOCK_RING);
 
   return LLD_OK;
 }
 
+/***********************************************************
+ * dr_push_n
+ *
+ * Push a burst of DR descriptors into DMA'able memory and
+ * update the tail pointer in the DR view once for the whole
+ * burst.
+ *
+ * The descriptors are laid out back to back in desc, each one
+ * n_words_per_desc 64b words long. The ring lock is taken once
+ * and either all n_descs descriptors are pushed or, if the DR
+ * does not have room for all of them, none is. The DMA log, if
+ * enabled, records the burst with a single lock acquisition.
+ ***********************************************************/
+int dr_push_n(struct lld_dr_view_s *view, uint64_t *desc, int n_descs) {
+  int lock_failed;
+  uint32_t tail_ptr, tail_wrap_bit;
+  uint64_t volatile *dr_desc_addr;
+  int dr_wrap_bit_pos;
+  int n_wds = view->n_words_per_desc;
+  int i, w;
+
+  if (n_descs <= 0) return LLD_ERR_BAD_PARM;
+  lock_failed = lld_dr_lock(view, LLD_DR_LOCK_RING);
+  if (lock_failed) {
+    return LLD_ERR_LOCK_FAILED;
+  }
+  if (dr_space(view) < n_descs) {
+    lld_dr_unlock(view, LLD_DR_LOCK_RING);
+    return LLD_ERR_DR_FULL;
+  }
+  if (get_dr_pos(view->dev_id,
+                 view->tail,
+                 &dr_wrap_bit_pos,
+                 &tail_ptr,
+                 &tail_wrap_bit)) {
+    lld_dr_unlock(view, LLD_DR_LOCK_RING);
+    return LLD_ERR_BAD_PARM;
+  }
+
+  for (i = 0; i < n_descs; i++) {
+    dr_desc_addr =
+        (uint64_t *)(uintptr_t)(view->base + (tail_ptr * n_wds * 8));
+    for (w = 0; w < n_wds; w++) {
+#if __BYTE_ORDER == __ORDER_LITTLE_ENDIAN__
+      *(dr_desc_addr + w) = *(desc + (i * n_wds) + w);
+#else
+      *(dr_desc_addr + w) = htole64(*(desc + (i * n_wds) + w));
+#endif
+    }
+    if (tail_ptr == ((uint32_t)view->n_entries - 1)) {  // wrap
+      tail_ptr = 0;
+      tail_wrap_bit ^= 0x1;  // toggle wrap bit
+    } else {
+      tail_ptr++;
+    }
+  }
+  view->tail = tail_ptr | (tail_wrap_bit << dr_wrap_bit_pos);
+
+  if (dr_push_logged(view)) {
+    lld_log_dma_n(0 /*push*/,
+                  view->dev_id,
+                  view->subdev_id,
+                  view->dr_id,
+                  desc,
+                  n_wds,
+                  n_descs,
+                  view->head,
+                  view->tail);
+  }
+  view->n_descs += n_descs;
+  lld_dr_unlock(view, LLD_DR_LOCK_RING);
+
+  return LLD_OK;
+}
+
 /***********************************************************
  * dr_pull
  *
@@ -135,6 +135,10 @@ int lld_dr_service(bf_dev_id_t dev_id,
                    int n);
 
 int dr_evaluate(lld_dr_view_t *view);
+int dr_push_1(lld_dr_view_t *view, uint64_t *desc);
+int dr_push_2(lld_dr_view_t *view, uint64_t *desc);
+int dr_push_4(lld_dr_view_t *view, uint64_t *desc);
+int dr_push_n(lld_dr_view_t *view, uint64_t *desc, int n_descs);
 int dr_full(lld_dr_view_t *dr);
 int dr_space(lld_dr_view_t *dr);
 int dr_used(lld_dr_view_t *dr);
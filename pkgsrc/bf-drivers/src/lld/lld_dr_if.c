@@ -86,60 +86,9 @@ int lld_subdev_push_ilist(bf_dev_id_t dev_id,
                           bool s_f,
                           bf_dma_addr_t ack_ptr,
                           uint64_t msg_id) {
-  lld_dr_view_t *view;
-  bf_dma_dr_id_t dr_id;
-  int push_failed;
-  uint64_t desc[4];
-  dr_msg_tx_t *msg = (dr_msg_tx_t *)&desc[0];
-  uint64_t entry_sz = 0ull, list_typ = 0ull;
-  (void)subdev_id;
-
-  if (list == 0) return LLD_ERR_BAD_PARM;  // invalid list ptr
-  if (lld_dr_buf_misaligned(list, 64))
-    return LLD_ERR_BAD_PARM;                               // invalid list ptr
-  if (list_len <= 0) return LLD_ERR_BAD_PARM;              // invalid list len
-  if (list_len > LLD_MAX_DMA_SZ) return LLD_ERR_BAD_PARM;  // invalid list len
-  if (dr_0_3 > 3) return LLD_ERR_BAD_PARM;  // invalid inst-list DR index
-  if ((ack_ptr != 0) && ((rsp_sz != 4) && (rsp_sz != 8) && (rsp_sz != 16)))
-    return LLD_ERR_BAD_PARM;  // invalid combo
-  if (!lld_dev_ready(dev_id, subdev_id))
-    return LLD_ERR_NOT_READY;  // chip not ready to use
-
-  dr_id = lld_dr_tx_pipe_inst_list_0 + dr_0_3;
-  view = lld_map_subdev_id_and_dr_to_view(dev_id, subdev_id, dr_id);
-  if (view == NULL) return LLD_ERR_BAD_PARM;  // invalid chip
-  if (dr_full(view)) return LLD_ERR_DR_FULL;  // no space in DR
-
-  if (ack_ptr != 0) {
-    entry_sz = (rsp_sz == 4) ? 0 : (rsp_sz == 8) ? 1 : (rsp_sz == 16) ? 2 : 0;
-    list_typ = 1ull;
-  }
-  if (s_f == 1) {
-    if (lld_dev_is_tof2(dev_id) || lld_dev_is_tof3(dev_id)) {
-      if ((list_len > LLD_MAX_DMA_SZ_SF) || (list_typ != 1))
-        return LLD_ERR_BAD_PARM;
-      entry_sz |= (s_f << 8);
-    }
-
-
-
-
+  lld_ilist_desc_t ilist = {list, list_len, rsp_sz, s_f, ack_ptr, msg_id, 0};
 
-
-
-
-  }
-  format_dr_msg_tx_ilist_wd0(
-      desc[0], list_len, list_typ, entry_sz, tx_m_type_il, 1, 1);
-  msg->source_address = list;
-  msg->destination_address = ack_ptr;
-  msg->message_id = msg_id;
-
-  push_failed = view->push(view, desc);
-  if (push_failed) {
-    return push_failed;
-  }
-  return LLD_OK;
+  return lld_subdev_push_ilist_burst(dev_id, subdev_id, dr_0_3, &ilist, 1);
 }
 
 /** \brief lld_push_ilist:
@@ -178,6 +127,127 @@ int lld_push_ilist(bf_dev_id_t dev_id,
       dev_id, 0, dr_0_3, list, list_len, rsp_sz, s_f, ack_ptr, msg_id));
 }
 
+/** \brief lld_subdev_push_ilist_burst:
+ *         Push a burst of instruction list descriptors
+ *         into the specified ILIST DR (0-3)
+ *
+ * The descriptors are validated first, then pushed with a single
+ * reservation of the DR. Either all of them are pushed or none is.
+ * As for single descriptors, the DR has to be started with
+ * lld_dr_start() for the device to see them. Descriptors with a
+ * non-zero mcast_vector are multicast, see lld_subdev_push_ilist_mcast.
+ *
+ * \param dev_id  : dev_id #
+ * \param subdev_id: subdev_id #
+ * \param dr_0_3  : which of the 4 inst-list DRs to use
+ * \param ilists  : descriptors to push, see lld_subdev_push_ilist
+ * \param n_descs : number of descriptors, 1 to LLD_DR_PUSH_BURST_MAX
+ *
+ * \return LLD_OK (0)
+ * \return LLD_ERR_BAD_PARM : invaid chip or subdev_id
+ * \return LLD_ERR_BAD_PARM : invalid dr specifier (0-3)
+ * \return LLD_ERR_BAD_PARM : invalid number of descriptors
+ * \return LLD_ERR_BAD_PARM : invalid descriptor
+ * \return LLD_ERR_BAD_PARM : multicast descriptor on Tofino
+ * \return LLD_ERR_NOT_READY: chip_add in still progress
+ * \return LLD_ERR_DR_FULL  : no space in DR for all the descriptors
+ *
+ */
+int lld_subdev_push_ilist_burst(bf_dev_id_t dev_id,
+                                bf_subdev_id_t subdev_id,
+                                int dr_0_3,
+                                const lld_ilist_desc_t *ilists,
+                                int n_descs) {
+  lld_dr_view_t *view;
+  bf_dma_dr_id_t dr_id;
+  uint64_t desc[LLD_DR_PUSH_BURST_MAX * 4];
+  bool is_tof2_tof3;
+  int i;
+
+  if (ilists == NULL) return LLD_ERR_BAD_PARM;
+  if ((n_descs <= 0) || (n_descs > LLD_DR_PUSH_BURST_MAX))
+    return LLD_ERR_BAD_PARM;
+  if (dr_0_3 > 3) return LLD_ERR_BAD_PARM;  // invalid inst-list DR index
+  if (!lld_dev_ready(dev_id, subdev_id))
+    return LLD_ERR_NOT_READY;  // chip not ready to use
+
+  dr_id = lld_dr_tx_pipe_inst_list_0 + dr_0_3;
+  view = lld_map_subdev_id_and_dr_to_view(dev_id, subdev_id, dr_id);
+  if (view == NULL) return LLD_ERR_BAD_PARM;  // invalid chip
+  if (dr_full(view)) return LLD_ERR_DR_FULL;  // no space in DR
+
+  is_tof2_tof3 = lld_dev_is_tof2(dev_id) || lld_dev_is_tof3(dev_id);
+  for (i = 0; i < n_descs; i++) {
+    const lld_ilist_desc_t *il = &ilists[i];
+    dr_msg_tx_t *msg = (dr_msg_tx_t *)&desc[i * 4];
+    uint64_t entry_sz = 0ull, list_typ = 0ull;
+
+    if (il->list == 0) return LLD_ERR_BAD_PARM;  // invalid list ptr
+    if (lld_dr_buf_misaligned(il->list, 64))
+      return LLD_ERR_BAD_PARM;  // invalid list ptr
+    if (il->list_len <= 0) return LLD_ERR_BAD_PARM;  // invalid list len
+    if (il->list_len > LLD_MAX_DMA_SZ)
+      return LLD_ERR_BAD_PARM;  // invalid list len
+    if ((il->ack_ptr != 0) &&
+        ((il->rsp_sz != 4) && (il->rsp_sz != 8) && (il->rsp_sz != 16)))
+      return LLD_ERR_BAD_PARM;  // invalid combo
+
+    if (il->ack_ptr != 0) {
+      entry_sz = (il->rsp_sz == 4)    ? 0
+                 : (il->rsp_sz == 8)  ? 1
+                 : (il->rsp_sz == 16) ? 2
+                                      : 0;
+      list_typ = 1ull;
+    }
+    if (il->mcast_vector != 0) {
+      uint32_t attr = list_typ | (entry_sz << 1);
+
+      if (!is_tof2_tof3) return LLD_ERR_BAD_PARM;  // no mcast on Tofino
+      if (lld_dr_buf_misaligned(il->ack_ptr, 64))
+        return LLD_ERR_BAD_PARM;  // bad  address
+      if (il->mcast_vector > 0xF)
+        return LLD_ERR_BAD_PARM;  // bad multicast vector
+      attr |= (1 << 4);           // mcast enable
+      attr |= (il->mcast_vector << 5);
+      if (il->s_f == 1) {
+        if ((il->list_len > LLD_MAX_DMA_SZ_SF) || (list_typ != 0))
+          return LLD_ERR_BAD_PARM;
+        attr |= il->s_f << 9;
+      }
+      format_dr_msg_tx_wd0(
+          desc[i * 4], il->list_len, attr, tx_m_type_il, 1, 1);
+    } else {
+      if (il->s_f == 1) {
+        if (is_tof2_tof3) {
+          if ((il->list_len > LLD_MAX_DMA_SZ_SF) || (list_typ != 1))
+            return LLD_ERR_BAD_PARM;
+          entry_sz |= ((uint64_t)il->s_f << 8);
+        }
+      }
+      format_dr_msg_tx_ilist_wd0(
+          desc[i * 4], il->list_len, list_typ, entry_sz, tx_m_type_il, 1, 1);
+    }
+    msg->source_address = il->list;
+    msg->destination_address = il->ack_ptr;
+    msg->message_id = il->msg_id;
+  }
+
+  return dr_push_n(view, desc, n_descs);
+}
+
+/** \brief lld_push_ilist_burst:
+ *         Push a burst of instruction list descriptors
+ *         into the specified ILIST DR (0-3)
+ *
+ * See lld_subdev_push_ilist_burst.
+ */
+int lld_push_ilist_burst(bf_dev_id_t dev_id,
+                         int dr_0_3,
+                         const lld_ilist_desc_t *ilists,
+                         int n_descs) {
+  return (lld_subdev_push_ilist_burst(dev_id, 0, dr_0_3, ilists, n_descs));
+}
+
 /** \brief lld_subdev_push_ilist_mcast:
  *         Push a multicast Instruction List descriptor
  *         into the IL DR, only for Tof2
@@ -216,71 +286,13 @@ int lld_subdev_push_ilist_mcast(bf_dev_id_t dev_id,
                                 uint32_t mcast_vector,
                                 bf_dma_addr_t ack_ptr,
                                 uint64_t msg_id) {
-  lld_dr_view_t *view;
-  bf_dma_dr_id_t dr_id;
-  int push_failed;
-  uint32_t attr;
-  uint64_t desc[4];
-  dr_msg_tx_t *msg = (dr_msg_tx_t *)&desc[0];
-  uint64_t entry_sz = 0ull, list_typ = 0ull;
+  lld_ilist_desc_t ilist = {
+      list, list_len, rsp_sz, s_f, ack_ptr, msg_id, mcast_vector};
 
   if ((!lld_dev_is_tof2(dev_id)) && (!lld_dev_is_tof3(dev_id)))
-
-      return LLD_ERR_BAD_PARM;    // invalid chip
-  if (!lld_dev_ready(dev_id, subdev_id))
-    return LLD_ERR_NOT_READY;  // chip not ready to use
-
-  if (dr_0_3 > 3) return LLD_ERR_BAD_PARM;  // invalid inst-list DR index
-  dr_id = lld_dr_tx_pipe_inst_list_0 + dr_0_3;
-  view = lld_map_subdev_id_and_dr_to_view(dev_id, subdev_id, dr_id);
-  if (view == NULL) return LLD_ERR_BAD_PARM;  // invalid chip
-  if (dr_full(view)) return LLD_ERR_DR_FULL;  // no space in DR
-
-  if (ack_ptr != 0) {
-    entry_sz = (rsp_sz == 4) ? 0 : (rsp_sz == 8) ? 1 : (rsp_sz == 16) ? 2 : 0;
-    list_typ = 1ull;
-  }
-  attr = list_typ;
-  attr |= (entry_sz << 1);
-  if (attr > 5) return LLD_ERR_BAD_PARM;                     // bad entry sz
-  if (list_len <= 0) return LLD_ERR_BAD_PARM;                // bad DMA len
-  if ((list_len) > LLD_MAX_DMA_SZ) return LLD_ERR_BAD_PARM;  // invalid DMA len
-  if (list == 0) return LLD_ERR_BAD_PARM;                    // bad buffer ptr
-  if (lld_dr_buf_misaligned(list, 64))
-    return LLD_ERR_BAD_PARM;  // bad buffer ptr
-  if (lld_dr_buf_misaligned(ack_ptr, 64))
-    return LLD_ERR_BAD_PARM;                        // bad  address
-  if (mcast_vector <= 0) return LLD_ERR_BAD_PARM;   // bad multicast vector
-  if (mcast_vector > 0xF) return LLD_ERR_BAD_PARM;  // bad multicast vector
-
-  attr |= (1 << 4);  // mcast enable
-  attr |= (mcast_vector << 5);
-  if (s_f == 1) {
-    if (lld_dev_is_tof2(dev_id) || lld_dev_is_tof3(dev_id)) {
-      if ((list_len > LLD_MAX_DMA_SZ_SF) || (list_typ != 0))
-        return LLD_ERR_BAD_PARM;
-      attr |= s_f << 9;
-    }
-
-
-
-
-
-
-
-
-  }
-  format_dr_msg_tx_wd0(desc[0], list_len, attr, tx_m_type_il, 1, 1);
-
-  msg->source_address = list;
-  msg->destination_address = ack_ptr;
-  msg->message_id = msg_id;
-
-  push_failed = view->push(view, desc);
-  if (push_failed) {
-    return push_failed;
-  }
-  return LLD_OK;
+    return LLD_ERR_BAD_PARM;                       // invalid chip
+  if (mcast_vector == 0) return LLD_ERR_BAD_PARM;  // bad multicast vector
+  return lld_subdev_push_ilist_burst(dev_id, subdev_id, dr_0_3, &ilist, 1);
 }
 
 /** \brief lld_push_ilist_mcast:
@@ -362,76 +374,10 @@ int lld_subdev_push_wb(bf_dev_id_t dev_id,
                        bf_dma_addr_t source,
                        uint64_t dest,
                        uint64_t msg_id) {
-  bf_dev_family_t dev_fam;
-  lld_dr_view_t *view;
-  int push_failed;
-  uint32_t attr;
-  uint64_t desc[4];
-  dr_msg_tx_t *msg = (dr_msg_tx_t *)&desc[0];
-  (void)subdev_id;
-
-  if (!lld_dev_ready(dev_id, subdev_id))
-    return LLD_ERR_NOT_READY;  // chip not ready to use
-
-  view = lld_map_subdev_id_and_dr_to_view(
-      dev_id, subdev_id, lld_dr_tx_pipe_write_block);
-  if (view == NULL) return LLD_ERR_BAD_PARM;  // invalid chip
-  if (dr_full(view)) return LLD_ERR_DR_FULL;  // no space in DR
-
-  attr = (entry_sz == 4) ? 0 : (entry_sz == 8) ? 1 : (entry_sz == 16) ? 2 : -1;
-  if (attr > 2) return LLD_ERR_BAD_PARM;      // bad entry sz
-  if (data_sz <= 0) return LLD_ERR_BAD_PARM;  // bad DMA len
-  if ((data_sz * entry_sz) > LLD_MAX_DMA_SZ)
-    return LLD_ERR_BAD_PARM;                 // invalid DMA len
-  if (source == 0) return LLD_ERR_BAD_PARM;  // bad buffer ptr
-  if (lld_dr_buf_misaligned(source, 64))
-    return LLD_ERR_BAD_PARM;               // bad buffer ptr
-  if (dest == 0) return LLD_ERR_BAD_PARM;  // bad tofino address
-
-  dev_fam = lld_dev_family_get(dev_id);
-  switch (dev_fam) {
-    case BF_DEV_FAMILY_TOFINO:
-      if (addr_inc != 1 && addr_inc != 4) return LLD_ERR_BAD_PARM;
-      /* Increment of 1 is encoded as a 1, increment of 4 is encoded as a 0. */
-      attr |= (addr_inc == 1 ? 1 : 0) << 3;
-      (void)single_entry;
-      break;
-    case BF_DEV_FAMILY_TOFINO2:
-
-    case BF_DEV_FAMILY_TOFINO3:
-      attr |= (single_entry << 3);
-      if (addr_inc == 1) {
-        attr |= (0 << 9);
-      } else if (addr_inc == 2) {
-        attr |= (1 << 9);
-      } else if (addr_inc == 4) {
-        attr |= (2 << 9);
-      } else if (addr_inc == 8) {
-        attr |= (3 << 9);
-      } else if (addr_inc == 16) {
-        attr |= (4 << 9);
-      } else if (addr_inc == 32) {
-        attr |= (5 << 9);
-      } else {
-        return LLD_ERR_BAD_PARM;
-      }
-      break;
-    default:
-      return LLD_ERR_BAD_PARM;  // bad chip
-  }
-
-  format_dr_msg_tx_wd0(
-      desc[0], (data_sz * entry_sz), attr, tx_m_type_wr_blk, 1, 1);
+  lld_wb_desc_t wb = {
+      entry_sz, addr_inc, data_sz, single_entry, source, dest, msg_id, 0};
 
-  msg->source_address = source;
-  msg->destination_address = dest;
-  msg->message_id = msg_id;
-
-  push_failed = view->push(view, desc);
-  if (push_failed) {
-    return push_failed;
-  }
-  return LLD_OK;
+  return lld_subdev_push_wb_burst(dev_id, subdev_id, &wb, 1);
 }
 
 /** \brief lld_push_wb:
@@ -474,6 +420,126 @@ int lld_push_wb(bf_dev_id_t dev_id,
                              msg_id));
 }
 
+/** \brief lld_subdev_push_wb_burst:
+ *         Push a burst of write-block descriptors
+ *         into the WB DR
+ *
+ * The descriptors are validated first, then pushed with a single
+ * reservation of the DR. Either all of them are pushed or none is.
+ * Descriptors with a non-zero mcast_vector are multicast, see
+ * lld_subdev_push_wb_mcast.
+ *
+ * \param dev_id   : dev_id #
+ * \param subdev_id: subdev_id #
+ * \param wbs      : descriptors to push, see lld_subdev_push_wb
+ * \param n_descs  : number of descriptors, 1 to LLD_DR_PUSH_BURST_MAX
+ *
+ * \return LLD_OK (0)
+ * \return LLD_ERR_BAD_PARM : bad chip
+ * \return LLD_ERR_BAD_PARM : invalid number of descriptors
+ * \return LLD_ERR_BAD_PARM : invalid descriptor
+ * \return LLD_ERR_NOT_READY: chip_add in still progress
+ * \return LLD_ERR_DR_FULL  : no space in DR for all the descriptors
+ */
+int lld_subdev_push_wb_burst(bf_dev_id_t dev_id,
+                             bf_subdev_id_t subdev_id,
+                             const lld_wb_desc_t *wbs,
+                             int n_descs) {
+  bf_dev_family_t dev_fam;
+  lld_dr_view_t *view;
+  uint64_t desc[LLD_DR_PUSH_BURST_MAX * 4];
+  int i;
+
+  if (wbs == NULL) return LLD_ERR_BAD_PARM;
+  if ((n_descs <= 0) || (n_descs > LLD_DR_PUSH_BURST_MAX))
+    return LLD_ERR_BAD_PARM;
+  if (!lld_dev_ready(dev_id, subdev_id))
+    return LLD_ERR_NOT_READY;  // chip not ready to use
+
+  view = lld_map_subdev_id_and_dr_to_view(
+      dev_id, subdev_id, lld_dr_tx_pipe_write_block);
+  if (view == NULL) return LLD_ERR_BAD_PARM;  // invalid chip
+  if (dr_full(view)) return LLD_ERR_DR_FULL;  // no space in DR
+
+  dev_fam = lld_dev_family_get(dev_id);
+  for (i = 0; i < n_descs; i++) {
+    const lld_wb_desc_t *wb = &wbs[i];
+    dr_msg_tx_t *msg = (dr_msg_tx_t *)&desc[i * 4];
+    int entry_sz = wb->entry_sz;
+    uint32_t attr;
+
+    attr = (entry_sz == 4)    ? 0
+           : (entry_sz == 8)  ? 1
+           : (entry_sz == 16) ? 2
+                              : -1;
+    if (attr > 2) return LLD_ERR_BAD_PARM;          // bad entry sz
+    if (wb->data_sz <= 0) return LLD_ERR_BAD_PARM;  // bad DMA len
+    if ((!wb->mcast_vector || !wb->single_entry) &&
+        (wb->data_sz * entry_sz) > LLD_MAX_DMA_SZ)
+      return LLD_ERR_BAD_PARM;                     // invalid DMA len
+    if (wb->source == 0) return LLD_ERR_BAD_PARM;  // bad buffer ptr
+    if (lld_dr_buf_misaligned(wb->source, 64))
+      return LLD_ERR_BAD_PARM;                   // bad buffer ptr
+    if (wb->dest == 0) return LLD_ERR_BAD_PARM;  // bad tofino address
+    if (wb->mcast_vector > 0xF)
+      return LLD_ERR_BAD_PARM;  // bad multicast vector
+
+    switch (dev_fam) {
+      case BF_DEV_FAMILY_TOFINO:
+        if (wb->addr_inc != 1 && wb->addr_inc != 4) return LLD_ERR_BAD_PARM;
+        /* Increment of 1 is encoded as a 1, increment of 4 is encoded as a
+         * 0. */
+        attr |= (wb->addr_inc == 1 ? 1 : 0) << 3;
+        break;
+      case BF_DEV_FAMILY_TOFINO2:
+      case BF_DEV_FAMILY_TOFINO3:
+        attr |= (wb->single_entry << 3);
+        if (wb->addr_inc == 1) {
+          attr |= (0 << 9);
+        } else if (wb->addr_inc == 2) {
+          attr |= (1 << 9);
+        } else if (wb->addr_inc == 4) {
+          attr |= (2 << 9);
+        } else if (wb->addr_inc == 8) {
+          attr |= (3 << 9);
+        } else if (wb->addr_inc == 16) {
+          attr |= (4 << 9);
+        } else if (wb->addr_inc == 32) {
+          attr |= (5 << 9);
+        } else {
+          return LLD_ERR_BAD_PARM;
+        }
+        break;
+      default:
+        return LLD_ERR_BAD_PARM;  // bad chip
+    }
+    if (wb->mcast_vector != 0) {
+      attr |= (1 << 4);  // mcast enable
+      attr |= (wb->mcast_vector << 5);
+    }
+
+    format_dr_msg_tx_wd0(
+        desc[i * 4], (wb->data_sz * entry_sz), attr, tx_m_type_wr_blk, 1, 1);
+    msg->source_address = wb->source;
+    msg->destination_address = wb->dest;
+    msg->message_id = wb->msg_id;
+  }
+
+  return dr_push_n(view, desc, n_descs);
+}
+
+/** \brief lld_push_wb_burst:
+ *         Push a burst of write-block descriptors
+ *         into the WB DR
+ *
+ * See lld_subdev_push_wb_burst.
+ */
+int lld_push_wb_burst(bf_dev_id_t dev_id,
+                      const lld_wb_desc_t *wbs,
+                      int n_descs) {
+  return (lld_subdev_push_wb_burst(dev_id, 0, wbs, n_descs));
+}
+
 /** \brief lld_subdev_push_wb_mcast:
  *         Push a multicast write-block descriptor
  *         into the WB DR
@@ -509,81 +575,17 @@ int lld_subdev_push_wb_mcast(bf_dev_id_t dev_id,
                              uint64_t dest,
                              uint32_t mcast_vector,
                              uint64_t msg_id) {
-  bf_dev_family_t dev_fam;
-  lld_dr_view_t *view;
-  int push_failed;
-  uint32_t attr;
-  uint64_t desc[4];
-  dr_msg_tx_t *msg = (dr_msg_tx_t *)&desc[0];
-
-  if (!lld_dev_ready(dev_id, subdev_id))
-    return LLD_ERR_NOT_READY;  // chip not ready to use
-
-  view = lld_map_subdev_id_and_dr_to_view(
-      dev_id, subdev_id, lld_dr_tx_pipe_write_block);
-  if (view == NULL) return LLD_ERR_BAD_PARM;  // invalid chip
-  if (dr_full(view)) return LLD_ERR_DR_FULL;  // no space in DR
-
-  attr = (entry_sz == 4) ? 0 : (entry_sz == 8) ? 1 : (entry_sz == 16) ? 2 : -1;
-  if (attr > 2) return LLD_ERR_BAD_PARM;      // bad entry sz
-  if (data_sz <= 0) return LLD_ERR_BAD_PARM;  // bad DMA len
-  if (!single_entry && (data_sz * entry_sz) > LLD_MAX_DMA_SZ)
-    return LLD_ERR_BAD_PARM;                 // invalid DMA len
-  if (source == 0) return LLD_ERR_BAD_PARM;  // bad buffer ptr
-  if (lld_dr_buf_misaligned(source, 64))
-    return LLD_ERR_BAD_PARM;                        // bad buffer ptr
-  if (dest == 0) return LLD_ERR_BAD_PARM;           // bad tofino address
-  if (mcast_vector <= 0) return LLD_ERR_BAD_PARM;   // bad multicast vector
-  if (mcast_vector > 0xF) return LLD_ERR_BAD_PARM;  // bad multicast vector
-
-  dev_fam = lld_dev_family_get(dev_id);
-  switch (dev_fam) {
-    case BF_DEV_FAMILY_TOFINO:
-      if (addr_inc != 1 && addr_inc != 4) return LLD_ERR_BAD_PARM;
-      /* Increment of 1 is encoded as a 1, increment of 4 is encoded as a 0. */
-      attr |= (addr_inc == 1 ? 1 : 0) << 3;
-      attr |= (1 << 4);  // mcast enable
-      attr |= (mcast_vector << 5);
-      (void)single_entry;
-      break;
-    case BF_DEV_FAMILY_TOFINO2:
-
-    case BF_DEV_FAMILY_TOFINO3: {
-      int stride = -1;
-      if (addr_inc == 1)
-        stride = 0;
-      else if (addr_inc == 2)
-        stride = 1;
-      else if (addr_inc == 4)
-        stride = 2;
-      else if (addr_inc == 8)
-        stride = 3;
-      else if (addr_inc == 16)
-        stride = 4;
-      else if (addr_inc == 32)
-        stride = 5;
-      if (stride == -1) return LLD_ERR_BAD_PARM;
-      attr |= (single_entry << 3);  // Single-Mode
-      attr |= (1 << 4);             // mcast enable
-      attr |= (mcast_vector << 5);
-      attr |= stride << 9;
-      break;
-    }
-    default:
-      return LLD_ERR_BAD_PARM;  // bad chip
-  }
-  format_dr_msg_tx_wd0(
-      desc[0], (data_sz * entry_sz), attr, tx_m_type_wr_blk, 1, 1);
-
-  msg->source_address = source;
-  msg->destination_address = dest;
-  msg->message_id = msg_id;
-
-  push_failed = view->push(view, desc);
-  if (push_failed) {
-    return push_failed;
-  }
-  return LLD_OK;
+  lld_wb_desc_t wb = {entry_sz,
+                      addr_inc,
+                      data_sz,
+                      single_entry,
+                      source,
+                      dest,
+                      msg_id,
+                      mcast_vector};
+
+  if (mcast_vector == 0) return LLD_ERR_BAD_PARM;  // bad multicast vector
+  return lld_subdev_push_wb_burst(dev_id, subdev_id, &wb, 1);
 }
 
 /** \brief lld_push_wb_mcast:
@@ -939,72 +941,9 @@ int lld_subdev_push_rb(bf_dev_id_t dev_id,
                        uint64_t source,
                        bf_dma_addr_t dest,
                        uint64_t msg_id) {
-  bf_dev_family_t dev_fam;
-  lld_dr_view_t *view;
-  int push_failed;
-  uint32_t attr;
-  uint64_t desc[4];
-  dr_msg_tx_t *msg = (dr_msg_tx_t *)&desc[0];
-  (void)subdev_id;
-
-  if (!lld_dev_ready(dev_id, subdev_id))
-    return LLD_ERR_NOT_READY;  // chip not ready to use
-
-  view = lld_map_subdev_id_and_dr_to_view(
-      dev_id, subdev_id, lld_dr_tx_pipe_read_block);
-  if (view == NULL) return LLD_ERR_BAD_PARM;  // bad chip
-  if (dr_full(view)) return LLD_ERR_DR_FULL;  // no space in DR
-
-  attr = (entry_sz == 4) ? 0 : (entry_sz == 8) ? 1 : (entry_sz == 16) ? 2 : -1;
-  if (attr > 2) return LLD_ERR_BAD_PARM;      // bad entry sz
-  if (data_sz <= 0) return LLD_ERR_BAD_PARM;  // bad DMA len
-  if ((data_sz * entry_sz) > LLD_MAX_DMA_SZ)
-    return LLD_ERR_BAD_PARM;                 // bad DMA len
-  if (source == 0) return LLD_ERR_BAD_PARM;  // bad tofino address
-  if (dest == 0) return LLD_ERR_BAD_PARM;    // bad buffer pointer
-  if (lld_dr_buf_misaligned(dest, 64))
-    return LLD_ERR_BAD_PARM;  // bad buffer ptr
-
-  dev_fam = lld_dev_family_get(dev_id);
-  switch (dev_fam) {
-    case BF_DEV_FAMILY_TOFINO:
-      if (addr_inc != 1 && addr_inc != 4) return LLD_ERR_BAD_PARM;
-      /* Increment of 1 is encoded as a 1, increment of 4 is encoded as a 0. */
-      attr |= (addr_inc == 1 ? 1 : 0) << 3;
-      break;
-    case BF_DEV_FAMILY_TOFINO2:
-
-    case BF_DEV_FAMILY_TOFINO3:
-      if (addr_inc == 1) {
-        attr |= (0 << 3);
-      } else if (addr_inc == 2) {
-        attr |= (1 << 3);
-      } else if (addr_inc == 4) {
-        attr |= (2 << 3);
-      } else if (addr_inc == 8) {
-        attr |= (3 << 3);
-      } else if (addr_inc == 16) {
-        attr |= (4 << 3);
-      } else if (addr_inc == 32) {
-        attr |= (5 << 3);
-      } else {
-        return LLD_ERR_BAD_PARM;
-      }
-      break;
-    default:
-      return LLD_ERR_BAD_PARM;  // bad chip
-  }
-
-  format_dr_msg_tx_wd0(desc[0], data_sz, attr, tx_m_type_rd_blk, 1, 1);
-  msg->source_address = source;
-  msg->destination_address = dest;
-  msg->message_id = msg_id;
+  lld_rb_desc_t rb = {entry_sz, addr_inc, data_sz, source, dest, msg_id};
 
-  push_failed = view->push(view, desc);
-  if (push_failed) {
-    return push_failed;
-  }
-  return LLD_OK;
+  return lld_subdev_push_rb_burst(dev_id, subdev_id, &rb, 1);
 }
 
 /** \brief lld_push_rb:
@@ -1039,6 +978,116 @@ int lld_push_rb(bf_dev_id_t dev_id,
       dev_id, 0, entry_sz, addr_inc, data_sz, source, dest, msg_id));
 }
 
+/** \brief lld_subdev_push_rb_burst:
+ *         Push a burst of read-block descriptors
+ *         into the RB DR
+ *
+ * The descriptors are validated first, then pushed with a single
+ * reservation of the DR. Either all of them are pushed or none is.
+ *
+ * \param dev_id   : dev_id #
+ * \param subdev_id: subdev_id #
+ * \param rbs      : descriptors to push, see lld_subdev_push_rb
+ * \param n_descs  : number of descriptors, 1 to LLD_DR_PUSH_BURST_MAX
+ *
+ * \return LLD_OK (0)
+ * \return LLD_ERR_BAD_PARM : bad chip
+ * \return LLD_ERR_BAD_PARM : invalid number of descriptors
+ * \return LLD_ERR_BAD_PARM : invalid descriptor
+ * \return LLD_ERR_NOT_READY: chip_add in still progress
+ * \return LLD_ERR_DR_FULL  : no space in DR for all the descriptors
+ */
+int lld_subdev_push_rb_burst(bf_dev_id_t dev_id,
+                             bf_subdev_id_t subdev_id,
+                             const lld_rb_desc_t *rbs,
+                             int n_descs) {
+  bf_dev_family_t dev_fam;
+  lld_dr_view_t *view;
+  uint64_t desc[LLD_DR_PUSH_BURST_MAX * 4];
+  int i;
+
+  if (rbs == NULL) return LLD_ERR_BAD_PARM;
+  if ((n_descs <= 0) || (n_descs > LLD_DR_PUSH_BURST_MAX))
+    return LLD_ERR_BAD_PARM;
+  if (!lld_dev_ready(dev_id, subdev_id))
+    return LLD_ERR_NOT_READY;  // chip not ready to use
+
+  view = lld_map_subdev_id_and_dr_to_view(
+      dev_id, subdev_id, lld_dr_tx_pipe_read_block);
+  if (view == NULL) return LLD_ERR_BAD_PARM;  // bad chip
+  if (dr_full(view)) return LLD_ERR_DR_FULL;  // no space in DR
+
+  dev_fam = lld_dev_family_get(dev_id);
+  for (i = 0; i < n_descs; i++) {
+    const lld_rb_desc_t *rb = &rbs[i];
+    dr_msg_tx_t *msg = (dr_msg_tx_t *)&desc[i * 4];
+    int entry_sz = rb->entry_sz;
+    uint32_t attr;
+
+    attr = (entry_sz == 4)    ? 0
+           : (entry_sz == 8)  ? 1
+           : (entry_sz == 16) ? 2
+                              : -1;
+    if (attr > 2) return LLD_ERR_BAD_PARM;          // bad entry sz
+    if (rb->data_sz <= 0) return LLD_ERR_BAD_PARM;  // bad DMA len
+    if ((rb->data_sz * entry_sz) > LLD_MAX_DMA_SZ)
+      return LLD_ERR_BAD_PARM;                     // bad DMA len
+    if (rb->source == 0) return LLD_ERR_BAD_PARM;  // bad tofino address
+    if (rb->dest == 0) return LLD_ERR_BAD_PARM;    // bad buffer pointer
+    if (lld_dr_buf_misaligned(rb->dest, 64))
+      return LLD_ERR_BAD_PARM;  // bad buffer ptr
+
+    switch (dev_fam) {
+      case BF_DEV_FAMILY_TOFINO:
+        if (rb->addr_inc != 1 && rb->addr_inc != 4) return LLD_ERR_BAD_PARM;
+        /* Increment of 1 is encoded as a 1, increment of 4 is encoded as a
+         * 0. */
+        attr |= (rb->addr_inc == 1 ? 1 : 0) << 3;
+        break;
+      case BF_DEV_FAMILY_TOFINO2:
+      case BF_DEV_FAMILY_TOFINO3:
+        if (rb->addr_inc == 1) {
+          attr |= (0 << 3);
+        } else if (rb->addr_inc == 2) {
+          attr |= (1 << 3);
+        } else if (rb->addr_inc == 4) {
+          attr |= (2 << 3);
+        } else if (rb->addr_inc == 8) {
+          attr |= (3 << 3);
+        } else if (rb->addr_inc == 16) {
+          attr |= (4 << 3);
+        } else if (rb->addr_inc == 32) {
+          attr |= (5 << 3);
+        } else {
+          return LLD_ERR_BAD_PARM;
+        }
+        break;
+      default:
+        return LLD_ERR_BAD_PARM;  // bad chip
+    }
+
+    format_dr_msg_tx_wd0(
+        desc[i * 4], rb->data_sz, attr, tx_m_type_rd_blk, 1, 1);
+    msg->source_address = rb->source;
+    msg->destination_address = rb->dest;
+    msg->message_id = rb->msg_id;
+  }
+
+  return dr_push_n(view, desc, n_descs);
+}
+
+/** \brief lld_push_rb_burst:
+ *         Push a burst of read-block descriptors
+ *         into the RB DR
+ *
+ * See lld_subdev_push_rb_burst.
+ */
+int lld_push_rb_burst(bf_dev_id_t dev_id,
+                      const lld_rb_desc_t *rbs,
+                      int n_descs) {
+  return (lld_subdev_push_rb_burst(dev_id, 0, rbs, n_descs));
+}
+
 /** \brief lld_subdev_push_que_rb:
  *         Push a que read-block to the RB DR, only for Tof2
  *
@@ -57,7 +57,18 @@ void lld_log_dma(int dir,
                  int n_wds,
                  uint64_t head,
                  uint64_t tail);
+void lld_log_dma_n(int dir,
+                   bf_dev_id_t dev_id,
+                   bf_subdev_id_t subdev_id,
+                   uint32_t dr,
+                   uint64_t *data,
+                   int n_wds,
+                   int n_descs,
+                   uint64_t head,
+                   uint64_t tail);
 void lld_dma_log_init(void);
+void lld_dma_log_enable_set(bool en);
+bool lld_dma_log_enabled(void);
 char *get_full_reg_path_name(bf_dev_id_t dev_id, uint32_t offset);
 char *lld_reg_parse_get_full_reg_path_name(bf_dev_family_t dev_family,
                                            uint32_t offset);
@@ -23,6 +23,7 @@
 #include <stdint.h>
 #include <inttypes.h>
 #include <limits.h>
+#include <time.h>
 #include <target-sys/bf_sal/bf_sys_intf.h>
 #include <lld/lldlib_config.h>
 
@@ -1004,6 +1005,125 @@ static ucli_status_t lld_ucli_ucli__dma_log__(ucli_context_t *uc) {
   return 0;
 }
 
+static ucli_status_t lld_ucli_ucli__dma_log_en__(ucli_context_t *uc) {
+  UCLI_COMMAND_INFO(
+      uc, "dma_log_en", 1, "Log DR pushes and pulls in the DMA log <0|1>");
+
+  lld_dma_log_enable_set(atoi(uc->pargs->args[0]) != 0);
+  aim_printf(&uc->pvs,
+             "DMA log %s\n",
+             lld_dma_log_enabled() ? "enabled" : "disabled");
+  return 0;
+}
+
+static double lld_ucli_elapsed_sec(struct timespec *start,
+                                   struct timespec *end) {
+  return (double)(end->tv_sec - start->tv_sec) +
+         (double)(end->tv_nsec - start->tv_nsec) / 1000000000.0;
+}
+
+/* Push n_descs write-block descriptors into a scratch DR view, bursts of
+ * burst descriptors at a time, a burst of 1 using the single descriptor push.
+ * The ring is drained whenever it fills up, as the device would.
+ */
+static int lld_ucli_dr_push_run(lld_dr_view_t *view,
+                                uint64_t *desc,
+                                int burst,
+                                int n_descs) {
+  int pushed = 0;
+  int rc;
+
+  while (pushed < n_descs) {
+    int n = (n_descs - pushed < burst) ? n_descs - pushed : burst;
+    if (burst == 1) {
+      rc = dr_push_4(view, desc);
+    } else {
+      rc = dr_push_n(view, desc, n);
+    }
+    if (rc == LLD_ERR_DR_FULL) {
+      view->head = view->tail;
+      continue;
+    }
+    if (rc != LLD_OK) return rc;
+    pushed += n;
+  }
+  return LLD_OK;
+}
+
+static ucli_status_t lld_ucli_ucli__dr_push_perf__(ucli_context_t *uc) {
+  UCLI_COMMAND_INFO(uc,
+                    "dr_push_perf",
+                    3,
+                    "Measure the DR descriptor push rate over scratch DMA "
+                    "memory <dev_id> <n_descs> <burst>");
+
+  bf_dev_id_t dev_id = atoi(uc->pargs->args[0]);
+  int n_descs = atoi(uc->pargs->args[1]);
+  int burst = atoi(uc->pargs->args[2]);
+  uint64_t desc[LLD_DR_PUSH_BURST_MAX * 4];
+  struct timespec start, end;
+  lld_dr_view_t view;
+  void *dr_mem;
+  double sec;
+  int i, rc;
+
+  if (lld_map_dev_id_to_dev_p(dev_id) == NULL) {
+    aim_printf(&uc->pvs, "Error: Invalid dev_id\n");
+    return 0;
+  }
+  if (n_descs <= 0 || burst <= 0 || burst > LLD_DR_PUSH_BURST_MAX) {
+    aim_printf(&uc->pvs,
+               "Error: n_descs must be positive and burst 1 to %d\n",
+               LLD_DR_PUSH_BURST_MAX);
+    return 0;
+  }
+
+  /* The scratch view mirrors the WB DR but is backed by host memory only, so
+   * nothing is published to the device. It has no DR id of its own and is
+   * not recorded in the DMA log. */
+  memset(&view, 0, sizeof view);
+  view.dev_id = dev_id;
+  view.subdev_id = 0;
+  view.dr_id = BF_DMA_NO_DR;
+  view.n_words_per_desc = 4;
+  view.n_entries = 1024;
+  view.producer = true;
+  view.lock_reqd = true;
+  dr_mem = bf_sys_malloc(view.n_entries * view.n_words_per_desc * 8);
+  if (dr_mem == NULL) {
+    aim_printf(&uc->pvs, "Error: Unable to allocate DR memory\n");
+    return 0;
+  }
+  view.base = (uint64_t)(uintptr_t)dr_mem;
+  for (i = 0; i < 2; i++) {
+    bf_sys_mutex_init(&view.mtx[i]);
+  }
+  for (i = 0; i < LLD_DR_PUSH_BURST_MAX * 4; i++) {
+    desc[i] = (uint64_t)i;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  rc = lld_ucli_dr_push_run(&view, desc, burst, n_descs);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  sec = lld_ucli_elapsed_sec(&start, &end);
+  if (rc != LLD_OK) {
+    aim_printf(&uc->pvs, "Error: push failed <%d>\n", rc);
+  } else {
+    aim_printf(&uc->pvs,
+               "%d descriptors, burst %d: %.3f sec, %.0f descriptors/sec\n",
+               n_descs,
+               burst,
+               sec,
+               sec > 0 ? n_descs / sec : 0.0);
+  }
+
+  for (i = 0; i < 2; i++) {
+    bf_sys_mutex_del(&view.mtx[i]);
+  }
+  bf_sys_free(dr_mem);
+  return 0;
+}
+
 int wl_dma_count = 0;
 int wl_entry_sz = 0;
 int wl_entries = 0;
@@ -6125,9 +6245,11 @@ static ucli_command_handler_f lld_ucli_ucli_handlers__[] = {
     // displaying or configuring internal logs or data
     lld_ucli_ucli__lgset__,
     lld_ucli_ucli__dma_log__,
+    lld_ucli_ucli__dma_log_en__,
     lld_ucli_ucli__dump__,
     lld_ucli_ucli__dr_dump__,
     // diagnostic commands
+    lld_ucli_ucli__dr_push_perf__,
     lld_ucli_ucli__cfg_diags__,
     lld_ucli_ucli__wl__,
     lld_ucli_ucli__wb__,
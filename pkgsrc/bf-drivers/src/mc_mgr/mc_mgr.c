@@ -2335,6 +2335,7 @@ bf_status_t mc_mgr_set_backup_port(int sid,
         uint32_t new_lag_rdm_addr = 0;
         mc_mgr_rdm_addr_pop(&to_write_lags, &new_lag_rdm_addr);
         mc_mgr_rdm_write_lag(sid, dev, new_lag_rdm_addr, lag_id, l2_head_rdm);
+        mc_mgr_rdm_blk_owner_add(dev, new_lag_rdm_addr, node->handle);
         l2_head_rdm = new_lag_rdm_addr;
       }
 
@@ -658,6 +658,7 @@ static void get_new_l1(mc_l1_node_t *node, int pipe, uint32_t rdm_addr) {
   n->next = NULL;
   n->sw_node = node;
   n->rdm_addr = rdm_addr;
+  mc_mgr_rdm_blk_owner_add(node->dev, rdm_addr, node->handle);
 }
 static inline void link_l1(mc_l1_hw_node_t *n,
                            bf_dev_id_t dev,
@@ -1114,6 +1115,7 @@ int mc_mgr_write_l2_port_node(int sid,
                               uint8_t mask) {
   bf_dev_id_t dev = node->dev;
 
+  mc_mgr_rdm_blk_owner_add(dev, rdm_addr, node->handle);
   int node_count = 0;
   int x, y = 0;
   for (x = 0; x < (int)mc_mgr_ctx_num_max_pipes(dev); ++x) {
@@ -1249,6 +1251,7 @@ static bf_status_t write_l2_chain(int sid,
         return BF_NO_SYS_RESOURCES;
       }
       mc_mgr_rdm_write_lag(sid, dev, cur_node_addr, lag_id, prev_node_addr);
+      mc_mgr_rdm_blk_owner_add(dev, cur_node_addr, node->handle);
       prev_node_addr = cur_node_addr;
       cur_node_addr = 0;
       ++l2_length;
@@ -2791,6 +2794,7 @@ bf_status_t mc_mgr_set_backup_ecmps(int sid,
         uint32_t new_lag_rdm_addr = 0;
         mc_mgr_rdm_addr_pop(&to_write_lags, &new_lag_rdm_addr);
         mc_mgr_rdm_write_lag(sid, dev, new_lag_rdm_addr, lag_id, l2_head_rdm);
+        mc_mgr_rdm_blk_owner_add(dev, new_lag_rdm_addr, node->handle);
         l2_head_rdm = new_lag_rdm_addr;
       }
 
@@ -3737,6 +3741,147 @@ not_enough_memory_to_write:
   return BF_NO_SYS_RESOURCES;
 }
 
+/* Move the L1 node of the tree in the given pipe to a new RDM address outside
+ * of avoid_blk.  A copy of the node is written first and then linked in place
+ * of the original (through the MIT if it is the head of the tree or through
+ * its predecessor otherwise) so packets see either copy.  The old address is
+ * released through the normal RDM change sequence. */
+bf_status_t mc_mgr_l1_relocate(int sid,
+                               mc_l1_node_t *node,
+                               int pipe,
+                               int avoid_blk) {
+  bf_dev_id_t dev = node->dev;
+  int mgid = node->mgid;
+  mc_l1_hw_node_t *n = &node->hw_nodes[pipe];
+
+  /* ECMP member nodes are referenced from vector nodes, leave them alone. */
+  if (ecmp_associated(node) || !mgid_associated(node) || !n->rdm_addr) {
+    return BF_INVALID_ARG;
+  }
+
+  mc_mgr_rdm_t *rdm_map = mc_mgr_ctx_rdm_map(dev);
+  uint32_t old_addr = n->rdm_addr;
+  uint32_t new_addr = mc_mgr_rdm_map_get_compact(
+      sid, dev, pipe, mc_mgr_rdm_node_type_rid, 1, avoid_blk);
+  if (!new_addr) return BF_NO_SYS_RESOURCES;
+
+  mc_mgr_rdm_write_l1(sid,
+                      dev,
+                      new_addr,
+                      mc_mgr_rdm_next_l1(rdm_map, old_addr),
+                      mc_mgr_rdm_l1_node_get_l2_ptr(rdm_map, old_addr),
+                      node->rid,
+                      node->xid,
+                      node->xid_valid);
+  n->rdm_addr = new_addr;
+  mc_mgr_rdm_blk_owner_add(dev, new_addr, node->handle);
+  if (mc_mgr_ctx_tree(dev, pipe, mgid) == n) {
+    (void)mc_mgr_set_mit_wrl(sid, dev, pipe, mgid);
+  } else {
+    mc_mgr_rdm_update_next_l1(sid, dev, n->prev->rdm_addr, new_addr);
+  }
+  mc_mgr_rdm_map_enqueue_free(sid, dev, old_addr);
+
+  LOG_TRACE("Dev %d pipe %d mgid %#x node %#x moved L1 from %#x to %#x",
+            dev,
+            pipe,
+            mgid,
+            node->handle,
+            old_addr,
+            new_addr);
+  return BF_SUCCESS;
+}
+
+/* Rewrite the L2 chain of the L1 node in the given pipe at new RDM addresses
+ * outside of avoid_blk, point the L1 node at the new chain and release the
+ * old chain.  The chain length does not change so the tree's tail is not
+ * touched. */
+bf_status_t mc_mgr_l2_chain_relocate(int sid,
+                                     mc_l1_node_t *node,
+                                     int pipe,
+                                     int avoid_blk) {
+  bf_dev_id_t dev = node->dev;
+  uint32_t l1_addr = node->hw_nodes[pipe].rdm_addr;
+  mc_mgr_rdm_addr_list_t *port_addrs = NULL;
+  mc_mgr_rdm_addr_list_t *lag_addrs = NULL;
+  mc_mgr_rdm_addr_list_t *to_clean = NULL;
+  int port_sz = 0;
+  int lag_cnt = 0;
+  int i;
+
+  if (ecmp_associated(node) || !mgid_associated(node) || !l1_addr) {
+    return BF_INVALID_ARG;
+  }
+
+  /* Only move chains which match the node's software state, a chain waiting
+   * on a membership update is rewritten by that update anyway. */
+  mc_mgr_get_l2_chain_sz(pipe, node, &port_sz, &lag_cnt);
+  if ((uint32_t)(port_sz + lag_cnt) != node->l2_count[pipe]) {
+    return BF_INVALID_ARG;
+  }
+  if (!port_sz && !lag_cnt) return BF_SUCCESS;
+
+  if (port_sz) {
+    uint32_t x = mc_mgr_rdm_map_get_compact(
+        sid, dev, pipe, mc_mgr_rdm_node_type_port72, port_sz, avoid_blk);
+    if (!x) goto not_enough_nodes;
+    mc_mgr_rdm_addr_append(&port_addrs, x);
+  }
+  for (i = 0; i < lag_cnt; ++i) {
+    uint32_t x = mc_mgr_rdm_map_get_compact(
+        sid, dev, pipe, mc_mgr_rdm_node_type_lag, 1, avoid_blk);
+    if (!x) goto not_enough_nodes;
+    mc_mgr_rdm_addr_append(&lag_addrs, x);
+  }
+
+  uint32_t l2_rdm_ptr = 0;
+  bf_status_t sts =
+      write_l2_chain(sid, pipe, node, &lag_addrs, &port_addrs, &l2_rdm_ptr);
+  if (BF_SUCCESS != sts) {
+    /* The new nodes may already be in the write list, let them go through
+     * the RDM change sequence rather than reusing them right away. */
+    while (port_addrs) {
+      uint32_t x = 0;
+      mc_mgr_rdm_addr_pop(&port_addrs, &x);
+      mc_mgr_rdm_map_enqueue_free(sid, dev, x);
+    }
+    while (lag_addrs) {
+      uint32_t x = 0;
+      mc_mgr_rdm_addr_pop(&lag_addrs, &x);
+      mc_mgr_rdm_map_enqueue_free(sid, dev, x);
+    }
+    return sts;
+  }
+
+  mc_mgr_collect_l1s_l2_chain_addrs(dev, l1_addr, &to_clean);
+  mc_mgr_rdm_update_next_l2(sid, dev, l1_addr, l2_rdm_ptr);
+  while (to_clean) {
+    uint32_t x = 0;
+    mc_mgr_rdm_addr_pop(&to_clean, &x);
+    mc_mgr_rdm_map_enqueue_free(sid, dev, x);
+  }
+
+  LOG_TRACE("Dev %d pipe %d node %#x moved L2 chain to %#x",
+            dev,
+            pipe,
+            node->handle,
+            l2_rdm_ptr);
+  return BF_SUCCESS;
+
+not_enough_nodes:
+  while (port_addrs) {
+    uint32_t x = 0;
+    mc_mgr_rdm_addr_pop(&port_addrs, &x);
+    mc_mgr_rdm_map_return(dev, x);
+  }
+  while (lag_addrs) {
+    uint32_t x = 0;
+    mc_mgr_rdm_addr_pop(&lag_addrs, &x);
+    mc_mgr_rdm_map_return(dev, x);
+  }
+  return BF_NO_SYS_RESOURCES;
+}
+
 static void write_vector(int sid,
                          bf_dev_id_t dev,
                          mc_ecmp_grp_t *g,
@@ -82,6 +82,14 @@ int mc_mgr_write_l2_port_node(int sid,
 bf_status_t mc_mgr_l1_write(int sid, mc_l1_node_t *node);
 bf_status_t mc_mgr_ecmp_l1_write(int sid, mc_l1_node_t *node);
 bf_status_t mc_mgr_l1_remove(int sid, mc_l1_node_t *node);
+bf_status_t mc_mgr_l1_relocate(int sid,
+                               mc_l1_node_t *node,
+                               int pipe,
+                               int avoid_blk);
+bf_status_t mc_mgr_l2_chain_relocate(int sid,
+                                     mc_l1_node_t *node,
+                                     int pipe,
+                                     int avoid_blk);
 
 void mc_mgr_collect_l1s_l2_chain_addrs(bf_dev_id_t dev,
                                        uint32_t l1_rdm_addr,
@@ -623,6 +623,51 @@ int mc_mgr_drv_wrl_append(bf_dev_id_t dev,
   return 0;
 }
 
+/* If the most recent entry of the session's write list on every subdevice is
+ * a write of the same width to the same address, replace its data in place
+ * and return true.  Nothing was queued between the two writes so hardware
+ * can never depend on seeing the first one; two updates of the two nodes
+ * sharing one RDM line then cost a single DMA entry. */
+bool mc_mgr_drv_wrl_update_last(bf_dev_id_t dev,
+                                int sid,
+                                int width,
+                                uint64_t addr,
+                                uint64_t hi,
+                                uint64_t lo) {
+  if (0 > sid || MC_MGR_NUM_SESSIONS <= sid) return false;
+  if (0 > dev || MC_MGR_NUM_DEVICES <= dev) return false;
+  if (16 != width) return false;
+  if (mc_mgr_is_device_locked(dev) || mc_mgr_ctx_syncing(dev)) return false;
+
+  addr >>= 4;
+  uint32_t entry_sz = 8 + width;
+  bf_subdev_id_t subdev;
+  bf_subdev_id_t num_subdev = (bf_subdev_id_t)mc_mgr_ctx_num_subdevices(dev);
+  /* Check all lists first so they are either all updated or none are. */
+  for (subdev = 0; subdev < num_subdev; subdev++) {
+    mc_mgr_drv_wr_list_t *wl = mc_mgr_ctx_wl(dev, subdev, sid);
+    if (!wl || !wl->count) return false;
+    mc_mgr_drv_buf_t *b = NULL;
+    BF_LIST_DLL_LAST(wl->bufList, b, next, prev);
+    if (!b || b->buf_pushed || !b->count || b->wr_list_size != width ||
+        b->used < entry_sz)
+      return false;
+    uint8_t *e = b->addr + b->used - entry_sz;
+    uint64_t last_addr = 0;
+    for (int i = 7; i >= 0; --i) last_addr = (last_addr << 8) | e[i];
+    if (last_addr != addr) return false;
+  }
+  for (subdev = 0; subdev < num_subdev; subdev++) {
+    mc_mgr_drv_wr_list_t *wl = mc_mgr_ctx_wl(dev, subdev, sid);
+    mc_mgr_drv_buf_t *b = NULL;
+    BF_LIST_DLL_LAST(wl->bufList, b, next, prev);
+    uint8_t *e = b->addr + b->used - entry_sz + 8;
+    for (int i = 0; i < 8; ++i) e[i] = (lo >> (8 * i)) & 0xFF;
+    for (int i = 0; i < 8; ++i) e[8 + i] = (hi >> (8 * i)) & 0xFF;
+  }
+  return true;
+}
+
 int mc_mgr_drv_wrl_append_reg(bf_dev_id_t dev,
                               int sid,
                               uint32_t addr,
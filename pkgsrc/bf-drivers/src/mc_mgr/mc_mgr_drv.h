@@ -78,6 +78,12 @@ int mc_mgr_drv_wrl_append(int dev,
                           uint64_t lo,
                           const char *where,
                           const int line);
+bool mc_mgr_drv_wrl_update_last(bf_dev_id_t dev,
+                                int sid,
+                                int width,
+                                uint64_t addr,
+                                uint64_t hi,
+                                uint64_t lo);
 int mc_mgr_drv_wrl_append_reg(int dev,
                               int sid,
                               uint32_t addr,
@@ -922,10 +922,13 @@ static bf_status_t migrate_state(bf_dev_id_t dev_id,
   }
 
   /* Replace the RDM management structures with what we have read back from the
-   * hardware. */
+   * hardware.  The compactor configuration is carried over to the new
+   * structures. */
+  bf_mc_rdm_defrag_cfg_t defrag_cfg = mc_mgr_ctx_rdm_map(d)->defrag.cfg;
   mc_mgr_rdm_map_cleanup(&mc_mgr_ctx_dev(dev_id)->rdm_map);
   mc_mgr_ctx_dev(dev_id)->rdm_map = st->rdm_map;
   st->rdm_map = NULL;
+  mc_mgr_rdm_defrag_cfg_set(d, &defrag_cfg);
 
   /* Replace the ECMP HW Id allocator. */
   bf_id_allocator_destroy(mc_mgr_ctx_ecmp_hw_id_gen(d));
@@ -2312,6 +2312,106 @@ done:
   return sts;
 }
 
+bf_status_t bf_mc_mbr_batch_update(bf_mc_session_hdl_t shdl,
+                                   bf_dev_id_t dev,
+                                   const bf_mc_mbr_op_t *ops,
+                                   uint32_t count,
+                                   uint32_t *processed) {
+  if (!mc_mgr_ready()) return BF_NOT_READY;
+
+  bf_status_t sts = BF_SUCCESS;
+  /* Validate the session. */
+  int sid = -1;
+  if (-1 == (sid = mc_mgr_validate_session(shdl, __func__, __LINE__))) {
+    return BF_INVALID_ARG;
+  }
+  if (!mc_mgr_validate_dev(dev, __func__, __LINE__)) {
+    return BF_INVALID_ARG;
+  }
+  if (!ops && count) return BF_INVALID_ARG;
+  if (processed) *processed = 0;
+  if (!count) return BF_SUCCESS;
+
+  /* Groups touched by the batch, their PVT/TVT is evaluated once at the end
+   * rather than after every operation. */
+  bf_bitset_t grps;
+  uint64_t *grps_ =
+      MC_MGR_CALLOC(BF_BITSET_ARRAY_SIZE(BF_MGID_COUNT), sizeof(uint64_t));
+  if (!grps_) return BF_NO_SYS_RESOURCES;
+  bf_bs_init(&grps, BF_MGID_COUNT, grps_);
+
+  mc_mgr_one_at_a_time_begin();
+
+  /* Hold back the write list until all operations have been queued.  If the
+   * caller already has a batch open it will be pushed when that ends. */
+  bool in_batch = mc_mgr_in_batch(sid);
+  mc_mgr_ctx_in_batch_set(sid, true);
+
+  uint32_t i;
+  for (i = 0; i < count; ++i) {
+    const bf_mc_mbr_op_t *op = &ops[i];
+    bf_mc_grp_id_t grp;
+    if (!mc_mgr_decode_mgrp_hdl(op->mgrp_hdl, &grp, __func__, __LINE__) ||
+        !mc_mgr_decode_l1_node_hdl(op->node_hdl, NULL, __func__, __LINE__)) {
+      sts = BF_INVALID_ARG;
+      break;
+    }
+    mc_l1_node_t *node =
+        mc_mgr_lookup_l1_node(dev, op->node_hdl, __func__, __LINE__);
+    if (!node) {
+      sts = BF_INVALID_ARG;
+      break;
+    }
+
+    if (BF_MC_MBR_OP_ASSOCIATE == op->op) {
+      sts = mc_mgr_l1_associate(sid, node, grp, dev, op->xid, op->xid_valid);
+    } else if (BF_MC_MBR_OP_DISSOCIATE == op->op) {
+      sts = mc_mgr_l1_dissociate(sid, node, grp);
+    } else {
+      sts = BF_INVALID_ARG;
+    }
+    if (BF_SUCCESS != sts) {
+      LOG_ERROR(
+          "Session %#x batch op %u (%s node %#x group %#x) failed on dev %d "
+          "(%s)",
+          shdl,
+          i,
+          BF_MC_MBR_OP_ASSOCIATE == op->op ? "associate" : "dissociate",
+          op->node_hdl,
+          op->mgrp_hdl,
+          dev,
+          bf_err_str(sts));
+      break;
+    }
+    bf_bs_set(&grps, grp, 1);
+  }
+
+  mc_mgr_ctx_in_batch_set(sid, in_batch);
+
+  /* Push everything which was applied, even if a later operation failed. */
+  bf_status_t wrl_sts = mc_mgr_drv_wrl_send(sid, true);
+  if (BF_SUCCESS == wrl_sts) {
+    int grp = -1;
+    while (-1 != (grp = bf_bs_first_set(&grps, grp))) {
+      wrl_sts |= mc_mgr_update_pvt(sid, dev, grp, false, __func__, __LINE__);
+      wrl_sts |= mc_mgr_update_tvt(sid, dev, grp, false, __func__, __LINE__);
+    }
+  }
+  if (BF_SUCCESS == sts) sts = wrl_sts;
+
+  mc_mgr_one_at_a_time_end();
+  MC_MGR_FREE(grps_);
+
+  if (processed) *processed = i;
+  LOG_TRACE("Session %#x batch membership update on dev %d, %u of %u ops (%s)",
+            shdl,
+            dev,
+            i,
+            count,
+            bf_err_str(sts));
+  return sts;
+}
+
 bf_status_t bf_mc_associate_ecmp(bf_mc_session_hdl_t shdl,
                                  bf_dev_id_t dev,
                                  bf_mc_mgrp_hdl_t ghdl,
@@ -4067,6 +4167,94 @@ bf_status_t bf_mc_do_node_garbage_collection(bf_mc_session_hdl_t shdl) {
   return BF_SUCCESS;
 }
 
+bf_status_t bf_mc_rdm_defrag_cfg_set(bf_mc_session_hdl_t shdl,
+                                     bf_dev_id_t dev,
+                                     const bf_mc_rdm_defrag_cfg_t *cfg) {
+  if (!mc_mgr_ready()) return BF_NOT_READY;
+
+  if (-1 == mc_mgr_validate_session(shdl, __func__, __LINE__)) {
+    return BF_INVALID_ARG;
+  }
+  if (!mc_mgr_validate_dev(dev, __func__, __LINE__)) {
+    return BF_INVALID_ARG;
+  }
+  if (!cfg) return BF_INVALID_ARG;
+
+  mc_mgr_one_at_a_time_begin();
+  bf_status_t sts = mc_mgr_rdm_defrag_cfg_set(dev, cfg);
+  mc_mgr_one_at_a_time_end();
+  return sts;
+}
+
+bf_status_t bf_mc_rdm_defrag_cfg_get(bf_mc_session_hdl_t shdl,
+                                     bf_dev_id_t dev,
+                                     bf_mc_rdm_defrag_cfg_t *cfg) {
+  if (!mc_mgr_ready()) return BF_NOT_READY;
+
+  if (-1 == mc_mgr_validate_session(shdl, __func__, __LINE__)) {
+    return BF_INVALID_ARG;
+  }
+  if (!mc_mgr_validate_dev(dev, __func__, __LINE__)) {
+    return BF_INVALID_ARG;
+  }
+  if (!cfg) return BF_INVALID_ARG;
+
+  mc_mgr_one_at_a_time_begin();
+  *cfg = mc_mgr_ctx_rdm_map(dev)->defrag.cfg;
+  mc_mgr_one_at_a_time_end();
+  return BF_SUCCESS;
+}
+
+bf_status_t bf_mc_rdm_defrag_run(bf_mc_session_hdl_t shdl,
+                                 bf_dev_id_t dev,
+                                 uint32_t max_moves,
+                                 uint32_t *moves) {
+  if (!mc_mgr_ready()) return BF_NOT_READY;
+
+  int sid = -1;
+  if (-1 == (sid = mc_mgr_validate_session(shdl, __func__, __LINE__))) {
+    return BF_INVALID_ARG;
+  }
+  if (!mc_mgr_validate_dev(dev, __func__, __LINE__)) {
+    return BF_INVALID_ARG;
+  }
+
+  mc_mgr_one_at_a_time_begin();
+  int n = mc_mgr_rdm_defrag_step(sid, dev, max_moves);
+  mc_mgr_one_at_a_time_end();
+  if (moves) *moves = n;
+  return BF_SUCCESS;
+}
+
+bf_status_t bf_mc_rdm_frag_stats_get(bf_mc_session_hdl_t shdl,
+                                     bf_dev_id_t dev,
+                                     bf_dev_pipe_t pipe,
+                                     bf_mc_rdm_frag_stats_t *stats) {
+  if (!mc_mgr_ready()) return BF_NOT_READY;
+
+  if (-1 == mc_mgr_validate_session(shdl, __func__, __LINE__)) {
+    return BF_INVALID_ARG;
+  }
+  if (!mc_mgr_validate_dev(dev, __func__, __LINE__)) {
+    return BF_INVALID_ARG;
+  }
+  if (mc_mgr_ctx_num_max_pipes(dev) <= pipe) {
+    LOG_ERROR("Invalid pipe %d (session %#x, dev %d) at %s:%d",
+              pipe,
+              shdl,
+              dev,
+              __func__,
+              __LINE__);
+    return BF_INVALID_ARG;
+  }
+  if (!stats) return BF_INVALID_ARG;
+
+  mc_mgr_one_at_a_time_begin();
+  mc_mgr_rdm_frag_stats_get(dev, pipe, stats);
+  mc_mgr_one_at_a_time_end();
+  return BF_SUCCESS;
+}
+
 bf_status_t bf_mc_rdm_change_intr_cb(bf_mc_session_hdl_t shdl,
                                      bf_dev_id_t dev,
                                      bf_dev_pipe_t pipe) {
@@ -1463,6 +1463,11 @@ bf_status_t mc_mgr_set_rdm_wrl(
     default:
       MC_MGR_DBGCHK(0);
   }
+  /* Back to back writes of the same line (e.g. the two LAG or L1 nodes
+   * sharing it) collapse into one write list entry. */
+  if (mc_mgr_drv_wrl_update_last(dev, sid, 16, addr, hi, lo)) {
+    return BF_SUCCESS;
+  }
   bf_status_t sts = mc_mgr_drv_wrl_append(
       dev, MC_MGR_DRV_SUBDEV_ID_ALL, sid, 16, addr, hi, lo, __func__, __LINE__);
   /*  LOG_TRACE(
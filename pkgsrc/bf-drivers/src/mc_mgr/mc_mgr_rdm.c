@@ -132,6 +132,7 @@ void mc_mgr_rdm_map_init(mc_mgr_rdm_t **rdm_map_p,
     rdm_map->blocks[i].id = i;
     rdm_map->blocks[i].rdm = rdm_map;
     rdm_map->blocks[i].pipe = -1;
+    bf_map_init(&rdm_map->blocks[i].owners);
     bf_bs_init(&rdm_map->blocks[i].free_entries[0],
                rdm_blk_size,
                rdm_map->blocks[i].free_entries_[0]);
@@ -147,6 +148,17 @@ void mc_mgr_rdm_map_init(mc_mgr_rdm_t **rdm_map_p,
   /* Mark address zero of block zero as used since it is not valid. */
   int x = power2_allocator_reserve(rdm_map->blocks[0].p2a, 0, 1);
   MC_MGR_DBGCHK(!x);
+  rdm_map->blocks[0].used = 1;
+
+  /* The compactor is disabled by default. */
+  rdm_map->defrag.cfg.enable = false;
+  rdm_map->defrag.cfg.interval_ms = MC_MGR_RDM_DEFRAG_DEF_INTERVAL_MS;
+  rdm_map->defrag.cfg.max_moves = MC_MGR_RDM_DEFRAG_DEF_MAX_MOVES;
+  rdm_map->defrag.cfg.threshold = MC_MGR_RDM_DEFRAG_DEF_THRESHOLD;
+  for (i = 0; i < MC_MGR_NUM_PIPES; ++i) {
+    rdm_map->defrag.victim[i][0] = -1;
+    rdm_map->defrag.victim[i][1] = -1;
+  }
 
   MC_MGR_LOCK_INIT(rdm_map->rdm_change_list_mtx);
 }
@@ -154,9 +166,15 @@ void mc_mgr_rdm_map_init(mc_mgr_rdm_t **rdm_map_p,
 void mc_mgr_rdm_map_cleanup(mc_mgr_rdm_t **rdm_map) {
   int i, j, rdm_blk_count;
   rdm_blk_count = (*rdm_map)->rdm_blk_count;
+  if ((*rdm_map)->defrag.timer_running) {
+    bf_sys_timer_stop(&(*rdm_map)->defrag.timer);
+    bf_sys_timer_del(&(*rdm_map)->defrag.timer);
+    (*rdm_map)->defrag.timer_running = false;
+  }
   MC_MGR_LOCK_DEL((*rdm_map)->rdm_change_list_mtx);
   for (i = 0; i < rdm_blk_count; ++i) {
     power2_allocator_destroy((*rdm_map)->blocks[i].p2a);
+    bf_map_destroy(&(*rdm_map)->blocks[i].owners);
   }
   MC_MGR_FREE((*rdm_map)->free_blocks_);
   MC_MGR_FREE((*rdm_map)->blk_ids);
@@ -458,6 +476,7 @@ void mc_mgr_rdm_map_return(bf_dev_id_t dev, uint32_t addr) {
     MC_MGR_DBGCHK(size > 0);
     return;
   }
+  rdm_map->blocks[blk].used -= size;
 
   /* If the block is now empty, return it to the free list. */
   int count = power2_allocator_alloc_count(rdm_map->blocks[blk].p2a);
@@ -476,6 +495,8 @@ void mc_mgr_rdm_map_return(bf_dev_id_t dev, uint32_t addr) {
     /* Add to free block list. */
     bf_bs_set(&rdm_map->free_blocks, blk, 1);
     rdm_map->blocks[blk].pipe = -1;
+    rdm_map->blocks[blk].defrag_done = false;
+    bf_map_destroy(&rdm_map->blocks[blk].owners);
     if (rdm_map->blk_id_width == TOF3_MC_MGR_RDM_BLK_ID_BITWIDTH) {
       rdm_map->blk_ids[blk / 8] &= ~(0xf << (4 * (blk & 0x7)));
       rdm_map->blk_ids_other_die[blk / 8] &= ~(0xf << (4 * (blk & 0x7)));
@@ -494,39 +515,133 @@ void mc_mgr_rdm_map_return(bf_dev_id_t dev, uint32_t addr) {
   }
 }
 
+static int rdm_blk_size_get(bf_dev_id_t dev) {
+  if (mc_mgr_ctx_dev_family(dev) == BF_DEV_FAMILY_TOFINO) {
+    return TOF_MC_MGR_RDM_BLK_SIZE;
+  } else if (mc_mgr_ctx_dev_family(dev) == BF_DEV_FAMILY_TOFINO2) {
+    return TOF2_MC_MGR_RDM_BLK_SIZE;
+  } else if (mc_mgr_ctx_dev_family(dev) == BF_DEV_FAMILY_TOFINO3) {
+    return TOF3_MC_MGR_RDM_BLK_SIZE;
+  }
+  return 0;
+}
+
+int mc_mgr_rdm_addr_to_blk(bf_dev_id_t dev, uint32_t addr) {
+  if (mc_mgr_ctx_dev_family(dev) == BF_DEV_FAMILY_TOFINO) {
+    return tof_rdm_addr_to_blk(dev, addr);
+  } else if (mc_mgr_ctx_dev_family(dev) == BF_DEV_FAMILY_TOFINO2) {
+    return tof2_rdm_addr_to_blk(dev, addr);
+  } else if (mc_mgr_ctx_dev_family(dev) == BF_DEV_FAMILY_TOFINO3) {
+    return tof3_rdm_addr_to_blk(dev, addr);
+  }
+  return -1;
+}
+
+/* Allocate from one of the blocks already owned by the pipe.  Normally the
+ * first block with room is used but the block the compactor is currently
+ * emptying is only used if no other block has room.  In compact mode the
+ * fullest block with room is used, the compactor's victim and avoid_blk are
+ * never used. */
+static int rdm_map_get_owned(mc_mgr_rdm_t *rdm_map,
+                             int pipe,
+                             bool l1_l2,
+                             int sz,
+                             bool compact,
+                             int avoid_blk,
+                             int *addr) {
+  bf_bitset_t *owned = &rdm_map->used_blocks[pipe][l1_l2];
+  int victim = rdm_map->defrag.victim[pipe][l1_l2];
+  int blk = -1;
+
+  if (!compact) {
+    while (-1 != (blk = bf_bs_first_set(owned, blk))) {
+      if (blk == victim) continue;
+      *addr = power2_allocator_alloc(rdm_map->blocks[blk].p2a, sz);
+      if (-1 != *addr) return blk;
+    }
+    if (-1 != victim && bf_bs_get(owned, victim)) {
+      *addr = power2_allocator_alloc(rdm_map->blocks[victim].p2a, sz);
+      if (-1 != *addr) return victim;
+    }
+    return -1;
+  }
+
+  /* Visit the candidate blocks from most to least used. */
+  bf_bitset_t tried;
+  uint64_t tried_[BF_BITSET_ARRAY_SIZE(TOF2_MC_MGR_RDM_BLK_COUNT)] = {0};
+  bf_bs_init(&tried, rdm_map->rdm_blk_count, tried_);
+  for (;;) {
+    int best = -1;
+    blk = -1;
+    while (-1 != (blk = bf_bs_first_set(owned, blk))) {
+      if (blk == victim || blk == avoid_blk || bf_bs_get(&tried, blk)) continue;
+      if (-1 == best || rdm_map->blocks[blk].used > rdm_map->blocks[best].used)
+        best = blk;
+    }
+    if (-1 == best) return -1;
+    bf_bs_set(&tried, best, 1);
+    *addr = power2_allocator_alloc(rdm_map->blocks[best].p2a, sz);
+    if (-1 != *addr) return best;
+  }
+}
+
+/* Returns true if addresses belonging to the pipe are on their way back to
+ * the allocator, that is, servicing the DMA rings and completing RDM changes
+ * may make space available. */
+static bool rdm_reclaim_pending(bf_dev_id_t dev,
+                                mc_mgr_rdm_t *rdm_map,
+                                int pipe) {
+  if (mc_mgr_ctx_rdm_pending_get(dev, pipe)) return true;
+  for (int i = 0; i < 2; ++i) {
+    int blk = -1;
+    while (-1 != (blk = bf_bs_first_set(&rdm_map->used_blocks[pipe][i], blk))) {
+      if (!bf_bs_all_0s(rdm_map->blocks[blk].queued_free_entries) ||
+          !bf_bs_all_0s(rdm_map->blocks[blk].waiting_free_entries))
+        return true;
+    }
+  }
+  for (int s = 0; s < MC_MGR_NUM_SESSIONS; ++s) {
+    if (bf_map_count(mc_mgr_ctx_rdm_free_addrs(s, dev))) return true;
+  }
+  return false;
+}
+
 static uint32_t rdm_map_get(int sid,
                             bf_dev_id_t dev,
                             int pipe,
                             mc_mgr_rdm_node_type_e type,
                             int count,
-                            int n_tries) {
+                            bool compact,
+                            int avoid_blk) {
   mc_mgr_rdm_t *rdm_map = mc_mgr_ctx_rdm_map(dev);
-  int addr;
+  int addr = -1;
   int width = node_width(type);
   bool l1_l2 = !node_is_l1(type);
   bool is_tof3 =
       (rdm_map->blk_id_width == TOF3_MC_MGR_RDM_BLK_ID_BITWIDTH) ? true : false;
+  int rdm_blk_size = rdm_blk_size_get(dev);
+  if (!rdm_blk_size) return 0;
+
   /* First check blocks owned by the pipe for a free entry. */
-  int blk = -1;
-  while (-1 !=
-         (blk = bf_bs_first_set(&rdm_map->used_blocks[pipe][l1_l2], blk))) {
-    if (-1 != (addr = power2_allocator_alloc(rdm_map->blocks[blk].p2a,
-                                             width * count))) {
-      break;
-    }
-  }
+  int blk = rdm_map_get_owned(
+      rdm_map, pipe, l1_l2, width * count, compact, avoid_blk, &addr);
   if (-1 == blk) {
+    /* The compactor only moves nodes into blocks the pipe already owns. */
+    if (compact) return 0;
+
     /* No free entries in the owned blocks.  Allocate a new block. */
     blk = bf_bs_first_set(&rdm_map->free_blocks, -1);
     if (-1 == blk) {
-      /* No free blocks either.  Out of RDM space (or compaction is required).
-       * Run garbage collection now (which also requires DR servicing) to try
-       * and recover nodes. */
-      if (!mc_mgr_is_device_locked(dev) && n_tries > 0) {
-        mc_mgr_drv_service_dr(dev);
-        bf_mc_do_node_garbage_collection(mc_mgr_ctx_int_sess());
-        return rdm_map_get(sid, dev, pipe, type, count, n_tries - 1);
+      /* No free blocks either.  Out of RDM space (or compaction is
+       * required).  Fail right away rather than collecting garbage here, the
+       * compactor looks at this pipe on its next step regardless of the
+       * fragmentation threshold and also reclaims any addresses still on
+       * their way back to the allocator. */
+      rdm_map->defrag.urgent[pipe] = true;
+      if (rdm_reclaim_pending(dev, rdm_map, pipe)) {
+        ++rdm_map->defrag.alloc_reclaim;
       }
+      ++rdm_map->defrag.alloc_failures;
       LOG_ERROR(
           "Out of RDM resources, session %#x cannot allocate %d %s nodes on "
           "dev %d pipe %d",
@@ -548,27 +663,15 @@ static uint32_t rdm_map_get(int sid,
     /* Assign the block to the pipe. */
     mc_mgr_set_rdm_blk_id_grp_wrl(sid, dev, is_tof3 ? (blk / 8) : (blk / 16));
   }
-  int rdm_blk_size;
-  if (mc_mgr_ctx_dev_family(dev) == BF_DEV_FAMILY_TOFINO) {
-    rdm_blk_size = TOF_MC_MGR_RDM_BLK_SIZE;
-  } else if (mc_mgr_ctx_dev_family(dev) == BF_DEV_FAMILY_TOFINO2) {
-    rdm_blk_size = TOF2_MC_MGR_RDM_BLK_SIZE;
-  } else if (mc_mgr_ctx_dev_family(dev) == BF_DEV_FAMILY_TOFINO3) {
-    rdm_blk_size = TOF3_MC_MGR_RDM_BLK_SIZE;
-  } else {
+  rdm_map->blocks[blk].used += width * count;
+
+  if (addr < 0 || addr >= rdm_blk_size) {
+    MC_MGR_DBGCHK(0);
     return 0;
   }
-  if (-1 == addr) {
-    MC_MGR_DBGCHK(-1 != addr);
-  } else {
-    if (addr < 0 || addr >= rdm_blk_size) {
-      MC_MGR_DBGCHK(0);
-      return 0;
-    }
-    if (addr + width * count - 1 >= rdm_blk_size) {
-      MC_MGR_DBGCHK(0);
-      return 0;
-    }
+  if (addr + width * count - 1 >= rdm_blk_size) {
+    MC_MGR_DBGCHK(0);
+    return 0;
   }
 
   uint32_t rdm_address = addr + blk * rdm_blk_size;
@@ -586,8 +689,16 @@ uint32_t mc_mgr_rdm_map_get(int sid,
                             int pipe,
                             mc_mgr_rdm_node_type_e type,
                             int count) {
-  int n_tries = 8;
-  return rdm_map_get(sid, dev, pipe, type, count, n_tries);
+  return rdm_map_get(sid, dev, pipe, type, count, false, -1);
+}
+
+uint32_t mc_mgr_rdm_map_get_compact(int sid,
+                                    bf_dev_id_t dev,
+                                    int pipe,
+                                    mc_mgr_rdm_node_type_e type,
+                                    int count,
+                                    int avoid_blk) {
+  return rdm_map_get(sid, dev, pipe, type, count, true, avoid_blk);
 }
 
 bool mc_mgr_mark_addr_used(mc_mgr_rdm_t *rdm_map,
@@ -611,6 +722,7 @@ bool mc_mgr_mark_addr_used(mc_mgr_rdm_t *rdm_map,
   if (rdm_map->blocks[blk].pipe == -1) {
     int x = power2_allocator_reserve(rdm_map->blocks[blk].p2a, blk_addr, sz);
     if (x) return false;
+    rdm_map->blocks[blk].used += sz;
     mark_block_used(rdm_map, pipe, blk, is_l2_node);
     return true;
   }
@@ -620,6 +732,7 @@ bool mc_mgr_mark_addr_used(mc_mgr_rdm_t *rdm_map,
       bf_bs_get(&rdm_map->used_blocks[pipe][is_l2_node], blk)) {
     int x = power2_allocator_reserve(rdm_map->blocks[blk].p2a, blk_addr, sz);
     if (x) return false;
+    rdm_map->blocks[blk].used += sz;
     return true;
   }
   return false;
@@ -642,8 +755,11 @@ bool mc_mgr_rdm_mark_addr_free(mc_mgr_rdm_t *rdm_map,
   /* Block must be assigned to this pipe. */
   if (rdm_map->blocks[blk].pipe != pipe) return false;
 
+  uint32_t sz =
+      power2_allocator_get_index_size(rdm_map->blocks[blk].p2a, blk_addr);
   int x = power2_allocator_release(rdm_map->blocks[blk].p2a, blk_addr);
   if (x) return false;
+  rdm_map->blocks[blk].used -= sz;
   set_node_invalid(dev, rdm_map, addr);
   /* If this emptied the block mark it as free. */
   uint32_t c = power2_allocator_alloc_count(rdm_map->blocks[blk].p2a);
@@ -693,6 +809,7 @@ static void mc_mgr_rdm_map_free_now(int sid,
     MC_MGR_DBGCHK(size > 0);
     return;
   }
+  rdm_map->blocks[blk].used -= size;
   /* If the block is now empty, return it to the free list. */
   int count = power2_allocator_alloc_count(rdm_map->blocks[blk].p2a);
 
@@ -719,6 +836,8 @@ static void mc_mgr_rdm_map_free_now(int sid,
     /* Add to free block list. */
     bf_bs_set(&rdm_map->free_blocks, blk, 1);
     rdm_map->blocks[blk].pipe = -1;
+    rdm_map->blocks[blk].defrag_done = false;
+    bf_map_destroy(&rdm_map->blocks[blk].owners);
     if (rdm_map->blk_id_width == TOF3_MC_MGR_RDM_BLK_ID_BITWIDTH) {
       rdm_map->blk_ids[blk / 8] &= ~(0xf << (4 * (blk & 0x7)));
       rdm_map->blk_ids_other_die[blk / 8] &= ~(0xf << (4 * (blk & 0x7)));
@@ -777,6 +896,403 @@ void mc_mgr_rdm_map_free(bf_dev_id_t dev, uint32_t addr) {
   MC_MGR_UNLOCK(&rdm_map->rdm_change_list_mtx);
 }
 
+/* Sums the allocation state of the blocks a pipe owns for one node level. */
+/* Fragmentation of a level which has used entries spread over blocks of
+ * blk_size entries: the percentage of its blocks which would be released if
+ * the entries were packed.  The number of such blocks is returned through
+ * reclaimable. */
+uint32_t mc_mgr_rdm_frag_pct(uint32_t blocks,
+                             uint32_t used,
+                             uint32_t blk_size,
+                             uint32_t *reclaimable) {
+  uint32_t needed = blk_size ? (used + blk_size - 1) / blk_size : blocks;
+  *reclaimable = blocks > needed ? blocks - needed : 0;
+  return blocks ? 100 * *reclaimable / blocks : 0;
+}
+
+/* Returns true if a level should be compacted on this step, that is, blocks
+ * can be reclaimed and either an allocation failed or the fragmentation is
+ * at or above the threshold. */
+bool mc_mgr_rdm_defrag_due(uint32_t blocks,
+                           uint32_t reclaimable,
+                           uint32_t threshold,
+                           bool urgent) {
+  if (!reclaimable) return false;
+  return urgent || 100 * reclaimable >= threshold * blocks;
+}
+
+static void rdm_level_usage(mc_mgr_rdm_t *rdm_map,
+                            int pipe,
+                            int lvl,
+                            uint32_t blk_size,
+                            uint32_t *blocks,
+                            uint32_t *used,
+                            uint32_t *reclaimable) {
+  int blk = -1;
+  *blocks = 0;
+  *used = 0;
+  while (-1 != (blk = bf_bs_first_set(&rdm_map->used_blocks[pipe][lvl], blk))) {
+    ++*blocks;
+    *used += rdm_map->blocks[blk].used;
+  }
+  mc_mgr_rdm_frag_pct(*blocks, *used, blk_size, reclaimable);
+}
+
+void mc_mgr_rdm_frag_stats_get(bf_dev_id_t dev,
+                               int pipe,
+                               bf_mc_rdm_frag_stats_t *stats) {
+  mc_mgr_rdm_t *rdm_map = mc_mgr_ctx_rdm_map(dev);
+  uint32_t blk_size = rdm_blk_size_get(dev);
+
+  memset(stats, 0, sizeof *stats);
+  if (!rdm_map || !blk_size) return;
+
+  stats->free_blocks = bf_bs_pop_count(&rdm_map->free_blocks);
+  for (int lvl = 0; lvl < 2; ++lvl) {
+    uint32_t blocks, used, reclaimable;
+    rdm_level_usage(
+        rdm_map, pipe, lvl, blk_size, &blocks, &used, &reclaimable);
+    stats->used_blocks[lvl] = blocks;
+    stats->used_entries[lvl] = used;
+    stats->free_entries[lvl] = blocks * blk_size - used;
+    stats->reclaimable[lvl] = reclaimable;
+    stats->fragmentation[lvl] = blocks ? 100 * reclaimable / blocks : 0;
+  }
+  stats->steps = rdm_map->defrag.steps;
+  stats->l1_moves = rdm_map->defrag.l1_moves;
+  stats->l2_moves = rdm_map->defrag.l2_moves;
+  stats->move_failures = rdm_map->defrag.move_failures;
+  stats->alloc_reclaim = rdm_map->defrag.alloc_reclaim;
+  stats->alloc_failures = rdm_map->defrag.alloc_failures;
+}
+
+void mc_mgr_rdm_blk_owner_add(bf_dev_id_t dev, uint32_t addr, uint32_t hdl) {
+  mc_mgr_rdm_t *rdm_map = mc_mgr_ctx_rdm_map(dev);
+  int blk = mc_mgr_rdm_addr_to_blk(dev, addr);
+  if (!rdm_map || !addr || blk < 0 || blk >= (int)rdm_map->rdm_blk_count) {
+    return;
+  }
+  bf_map_sts_t s = bf_map_add(&rdm_map->blocks[blk].owners, hdl, NULL);
+  MC_MGR_DBGCHK(BF_MAP_OK == s || BF_MAP_KEY_EXISTS == s);
+}
+
+/* Rebuild the owner sets of all blocks from the node database.  Only needed
+ * once the RDM has been restored from hardware since those nodes were not
+ * written through the usual paths. */
+static void rdm_blk_owners_rebuild(bf_dev_id_t dev, mc_mgr_rdm_t *rdm_map) {
+  bf_map_t *db = mc_mgr_ctx_db_l1(dev);
+  unsigned long key = 0;
+  void *data = NULL;
+  bf_map_sts_t s;
+
+  for (uint32_t blk = 0; blk < rdm_map->rdm_blk_count; ++blk) {
+    bf_map_destroy(&rdm_map->blocks[blk].owners);
+  }
+  for (s = bf_map_get_first(db, &key, &data); BF_MAP_OK == s;
+       s = bf_map_get_next(db, &key, &data)) {
+    mc_l1_node_t *node = data;
+    if (ecmp_associated(node) || !mgid_associated(node)) continue;
+    for (int pipe = 0; pipe < (int)mc_mgr_ctx_num_max_pipes(dev); ++pipe) {
+      uint32_t l1 = node->hw_nodes[pipe].rdm_addr;
+      if (!l1) continue;
+      mc_mgr_rdm_blk_owner_add(dev, l1, node->handle);
+      uint32_t l2 = mc_mgr_rdm_l1_node_get_l2_ptr(rdm_map, l1);
+      for (; l2; l2 = mc_mgr_rdm_next_l2(rdm_map, l2, true)) {
+        mc_mgr_rdm_blk_owner_add(dev, l2, node->handle);
+      }
+    }
+  }
+  rdm_map->defrag.owners_valid = true;
+}
+
+/* Offer the owners of a block to fn, at most until budget of them have been
+ * moved.  Owners which have been moved out of the block or which no longer
+ * have entries in it are dropped from the set.  Sets *found if any owner
+ * still had entries in the block.  Returns the number of owners moved. */
+uint32_t mc_mgr_rdm_owners_walk(bf_map_t *owners,
+                                uint32_t budget,
+                                mc_mgr_rdm_owner_fn fn,
+                                void *cookie,
+                                bool *found) {
+  unsigned long key = 0;
+  void *data = NULL;
+  uint32_t moves = 0;
+
+  *found = false;
+  bf_map_sts_t s = bf_map_get_first(owners, &key, &data);
+  while (BF_MAP_OK == s && moves < budget) {
+    unsigned long hdl = key;
+    mc_mgr_rdm_owner_sts_e sts = fn(hdl, cookie);
+    s = bf_map_get_next(owners, &key, &data);
+    switch (sts) {
+      case mc_mgr_rdm_owner_moved:
+        ++moves;
+        *found = true;
+        bf_map_rmv(owners, hdl);
+        break;
+      case mc_mgr_rdm_owner_gone:
+        bf_map_rmv(owners, hdl);
+        break;
+      case mc_mgr_rdm_owner_skipped:
+        *found = true;
+        break;
+      case mc_mgr_rdm_owner_no_room:
+        *found = true;
+        return moves;
+    }
+  }
+  return moves;
+}
+
+/* Pick the least used block of the level which has not been visited in the
+ * current compaction round and whose entries fit in the free space of the
+ * pipe's other blocks.  Blocks holding the tail nodes are never picked since
+ * the tails cannot move. */
+static int defrag_pick_victim(bf_dev_id_t dev,
+                              mc_mgr_rdm_t *rdm_map,
+                              int pipe,
+                              int lvl,
+                              uint32_t blk_size) {
+  struct mc_mgr_tail_info *ti = mc_mgr_ctx_tail_info(dev);
+  bf_bitset_t *owned = &rdm_map->used_blocks[pipe][lvl];
+  int tail_blk = -1;
+  uint32_t total_free = 0;
+  int blk = -1;
+  int best = -1;
+
+  if (!lvl && ti->tail_base[pipe]) {
+    tail_blk = mc_mgr_rdm_addr_to_blk(dev, ti->tail_base[pipe]);
+  } else if (lvl && ti->tail_l2_addr[pipe]) {
+    tail_blk = mc_mgr_rdm_addr_to_blk(dev, ti->tail_l2_addr[pipe]);
+  }
+
+  while (-1 != (blk = bf_bs_first_set(owned, blk))) {
+    total_free += blk_size - rdm_map->blocks[blk].used;
+  }
+  while (-1 != (blk = bf_bs_first_set(owned, blk))) {
+    mc_mgr_rdm_block_t *b = &rdm_map->blocks[blk];
+    if (blk == tail_blk || b->defrag_done) continue;
+    if (total_free - (blk_size - b->used) < b->used) continue;
+    if (-1 == best || b->used < rdm_map->blocks[best].used) best = blk;
+  }
+  return best;
+}
+
+struct defrag_victim_ctx {
+  int sid;
+  bf_dev_id_t dev;
+  mc_mgr_rdm_t *rdm_map;
+  int pipe;
+  int lvl;
+  int victim;
+};
+
+/* Move one owner of the victim block, an L1 node for the L1 level or an L2
+ * chain for the L2 level, out of the block. */
+static mc_mgr_rdm_owner_sts_e defrag_owner_move(unsigned long hdl,
+                                                void *cookie) {
+  struct defrag_victim_ctx *c = cookie;
+  mc_mgr_rdm_t *rdm_map = c->rdm_map;
+  mc_l1_node_t *node = NULL;
+
+  if (BF_MAP_OK != bf_map_get(mc_mgr_ctx_db_l1(c->dev), hdl, (void **)&node)) {
+    return mc_mgr_rdm_owner_gone;
+  }
+  uint32_t l1_addr = node->hw_nodes[c->pipe].rdm_addr;
+  if (!l1_addr || ecmp_associated(node) || !mgid_associated(node)) {
+    return mc_mgr_rdm_owner_gone;
+  }
+
+  bool in_victim = false;
+  if (!c->lvl) {
+    in_victim = mc_mgr_rdm_addr_to_blk(c->dev, l1_addr) == c->victim;
+  } else {
+    uint32_t l2 = mc_mgr_rdm_l1_node_get_l2_ptr(rdm_map, l1_addr);
+    for (; l2 && !in_victim; l2 = mc_mgr_rdm_next_l2(rdm_map, l2, true)) {
+      in_victim = mc_mgr_rdm_addr_to_blk(c->dev, l2) == c->victim;
+    }
+  }
+  if (!in_victim) return mc_mgr_rdm_owner_gone;
+
+  bf_status_t sts =
+      !c->lvl ? mc_mgr_l1_relocate(c->sid, node, c->pipe, c->victim)
+              : mc_mgr_l2_chain_relocate(c->sid, node, c->pipe, c->victim);
+  if (BF_SUCCESS != sts) {
+    ++rdm_map->defrag.move_failures;
+    /* Nowhere to put the nodes, stop working on this block. */
+    return BF_NO_SYS_RESOURCES == sts ? mc_mgr_rdm_owner_no_room
+                                      : mc_mgr_rdm_owner_skipped;
+  }
+  if (!c->lvl) {
+    ++rdm_map->defrag.l1_moves;
+  } else {
+    ++rdm_map->defrag.l2_moves;
+  }
+  return mc_mgr_rdm_owner_moved;
+}
+
+/* Move nodes of one level out of the victim block, at most budget of them.
+ * Only the owners recorded against the block are visited.  Sets *found if
+ * any node in the victim block was seen. */
+static uint32_t defrag_victim(int sid,
+                              bf_dev_id_t dev,
+                              mc_mgr_rdm_t *rdm_map,
+                              int pipe,
+                              int lvl,
+                              int victim,
+                              uint32_t budget,
+                              bool *found) {
+  struct defrag_victim_ctx c = {sid, dev, rdm_map, pipe, lvl, victim};
+  return mc_mgr_rdm_owners_walk(&rdm_map->blocks[victim].owners,
+                                budget,
+                                defrag_owner_move,
+                                &c,
+                                found);
+}
+
+int mc_mgr_rdm_defrag_step(int sid, bf_dev_id_t dev, uint32_t max_moves) {
+  mc_mgr_rdm_t *rdm_map = mc_mgr_ctx_rdm_map(dev);
+  uint32_t blk_size = rdm_blk_size_get(dev);
+  uint32_t moves = 0;
+
+  if (!rdm_map || !blk_size) return 0;
+  if (mc_mgr_is_device_locked(dev) || mc_mgr_ctx_syncing(dev) ||
+      mc_mgr_ctx_rebuilding(dev)) {
+    /* The RDM may be restored from hardware, rebuild the owner sets once it
+     * is done. */
+    rdm_map->defrag.owners_valid = false;
+    return 0;
+  }
+
+  ++rdm_map->defrag.steps;
+  /* Allocations do not wait for released addresses to come back, collect
+   * them here on behalf of any pipe which ran out. */
+  for (int pipe = 0; pipe < (int)mc_mgr_ctx_num_max_pipes(dev); ++pipe) {
+    if (rdm_map->defrag.urgent[pipe] &&
+        rdm_reclaim_pending(dev, rdm_map, pipe)) {
+      mc_mgr_drv_service_dr(dev);
+      bf_mc_do_node_garbage_collection(mc_mgr_ctx_int_sess());
+      break;
+    }
+  }
+  if (!rdm_map->defrag.owners_valid) rdm_blk_owners_rebuild(dev, rdm_map);
+
+  for (int pipe = 0; pipe < (int)mc_mgr_ctx_num_max_pipes(dev); ++pipe) {
+    for (int lvl = 0; lvl < 2 && moves < max_moves; ++lvl) {
+      int *victim = &rdm_map->defrag.victim[pipe][lvl];
+      uint32_t blocks, used, reclaimable;
+      rdm_level_usage(
+          rdm_map, pipe, lvl, blk_size, &blocks, &used, &reclaimable);
+      if (!mc_mgr_rdm_defrag_due(blocks,
+                                 reclaimable,
+                                 rdm_map->defrag.cfg.threshold,
+                                 rdm_map->defrag.urgent[pipe])) {
+        *victim = -1;
+        continue;
+      }
+
+      /* Keep working on the current victim until it has been emptied. */
+      if (-1 == *victim ||
+          !bf_bs_get(&rdm_map->used_blocks[pipe][lvl], *victim)) {
+        *victim = defrag_pick_victim(dev, rdm_map, pipe, lvl, blk_size);
+      }
+      if (-1 == *victim) {
+        /* Every block has been visited, start a new round on the next
+         * step. */
+        int blk = -1;
+        while (-1 !=
+               (blk = bf_bs_first_set(&rdm_map->used_blocks[pipe][lvl], blk))) {
+          rdm_map->blocks[blk].defrag_done = false;
+        }
+        continue;
+      }
+
+      bool found = false;
+      moves += defrag_victim(
+          sid, dev, rdm_map, pipe, lvl, *victim, max_moves - moves, &found);
+      if (!found) {
+        /* Whatever is left in the block cannot be moved (or is already on
+         * its way out), pick another victim next time. */
+        rdm_map->blocks[*victim].defrag_done = true;
+        *victim = -1;
+      }
+    }
+    rdm_map->defrag.urgent[pipe] = false;
+  }
+
+  if (moves) {
+    bf_status_t sts = mc_mgr_drv_wrl_send(sid, true);
+    if (BF_SUCCESS != sts) {
+      LOG_ERROR("Dev %d, failed to push RDM compaction writes, sts %s",
+                dev,
+                bf_err_str(sts));
+      MC_MGR_DBGCHK(BF_SUCCESS == sts);
+    }
+    LOG_TRACE("Dev %d RDM compaction moved %u nodes", dev, moves);
+  }
+  return moves;
+}
+
+static void mc_mgr_rdm_defrag_timer_cb(bf_sys_timer_t *timer, void *data) {
+  bf_dev_id_t dev = (bf_dev_id_t)(uintptr_t)data;
+  (void)timer;
+
+  /* Never hold off API callers, try again on the next tick. */
+  if (BF_SUCCESS != mc_mgr_one_at_a_time_begin_try()) return;
+  mc_mgr_rdm_t *rdm_map = mc_mgr_ctx_rdm_map(dev);
+  int sid = 0;
+  if (rdm_map && rdm_map->defrag.cfg.enable &&
+      mc_mgr_decode_sess_hdl(mc_mgr_ctx_int_sess(), &sid)) {
+    mc_mgr_rdm_defrag_step(sid, dev, rdm_map->defrag.cfg.max_moves);
+  }
+  mc_mgr_one_at_a_time_end();
+}
+
+bf_status_t mc_mgr_rdm_defrag_cfg_set(bf_dev_id_t dev,
+                                      const bf_mc_rdm_defrag_cfg_t *cfg) {
+  mc_mgr_rdm_t *rdm_map = mc_mgr_ctx_rdm_map(dev);
+  if (!rdm_map) return BF_INVALID_ARG;
+  if (cfg->threshold > 100) return BF_INVALID_ARG;
+  if (cfg->enable && (!cfg->interval_ms || !cfg->max_moves)) {
+    return BF_INVALID_ARG;
+  }
+
+  struct mc_mgr_rdm_defrag_t *d = &rdm_map->defrag;
+  if (d->timer_running) {
+    bf_sys_timer_stop(&d->timer);
+    bf_sys_timer_del(&d->timer);
+    d->timer_running = false;
+  }
+  d->cfg = *cfg;
+  d->owners_valid = false;
+  for (int i = 0; i < MC_MGR_NUM_PIPES; ++i) {
+    d->victim[i][0] = -1;
+    d->victim[i][1] = -1;
+  }
+  if (!cfg->enable) return BF_SUCCESS;
+
+  bf_sys_timer_status_t rc =
+      bf_sys_timer_create(&d->timer,
+                          cfg->interval_ms,
+                          cfg->interval_ms,
+                          mc_mgr_rdm_defrag_timer_cb,
+                          (void *)(uintptr_t)dev);
+  if (BF_SYS_TIMER_OK != rc) {
+    LOG_ERROR("Dev %d, failed to create RDM compaction timer (%d)", dev, rc);
+    d->cfg.enable = false;
+    return BF_NO_SYS_RESOURCES;
+  }
+  rc = bf_sys_timer_start(&d->timer);
+  if (BF_SYS_TIMER_OK != rc) {
+    LOG_ERROR("Dev %d, failed to start RDM compaction timer (%d)", dev, rc);
+    bf_sys_timer_del(&d->timer);
+    d->cfg.enable = false;
+    return BF_NO_SYS_RESOURCES;
+  }
+  d->timer_running = true;
+  return BF_SUCCESS;
+}
+
 inline static bool line_is_shareable(mc_mgr_rdm_line_t *line) {
   if (!line) {
     MC_MGR_DBGCHK(0);
@@ -22,8 +22,10 @@
 #define __MC_MGR_RDM_H__
 
 #include <target-utils/bitset/bitset.h>
+#include <target-utils/map/map.h>
 #include <target-utils/power2_allocator/power2_allocator.h>
 #include <mc_mgr/mc_mgr_config.h>
+#include <mc_mgr/mc_mgr_types.h>
 #include <lld/lld_sku.h>
 
 /* BLK_SIZE is describing the number of 40b nodes in one RDM block */
@@ -72,6 +74,18 @@ struct mc_mgr_rdm_block_t {
 
   /* Which pipe this block is assigned to, -1 when free. */
   int pipe;
+
+  /* Number of RDM addresses currently allocated from this block. */
+  uint32_t used;
+  /* Set once the compactor has relocated everything it can out of this block
+   * in the current compaction round. */
+  bool defrag_done;
+  /* Handles of the L1 nodes which wrote their L1 node or part of their L2
+   * chain into this block, so the compactor can find the nodes to move
+   * without walking every node on the device.  Handles are added as nodes are
+   * written and only removed by the compactor or when the block is freed so
+   * some of them may be stale. */
+  bf_map_t owners;
 };
 
 /* RDM Nodes. */
@@ -224,6 +238,37 @@ struct mc_mgr_rdm_line_t {
   } u;
 };
 
+#define MC_MGR_RDM_DEFRAG_DEF_INTERVAL_MS 1000
+#define MC_MGR_RDM_DEFRAG_DEF_MAX_MOVES 64
+#define MC_MGR_RDM_DEFRAG_DEF_THRESHOLD 25
+
+/* State of the background RDM compactor.  The compactor relocates L1 nodes
+ * and L2 chains out of sparsely used blocks into denser blocks owned by the
+ * same pipe so that the sparse blocks can be returned to the free pool.  Each
+ * move writes the node at its new address, relinks its parent and then frees
+ * the old address through the usual RDM change sequence so it is hitless. */
+struct mc_mgr_rdm_defrag_t {
+  bf_mc_rdm_defrag_cfg_t cfg;
+  bf_sys_timer_t timer;
+  bool timer_running;
+  /* Block currently being emptied per pipe and node level (L1/L2), -1 when
+   * no block is selected. */
+  int victim[MC_MGR_NUM_PIPES][2];
+  /* Set when an allocation in the pipe failed, forces compaction of the pipe
+   * regardless of the configured threshold. */
+  bool urgent[MC_MGR_NUM_PIPES];
+  /* False until the per block owner sets have been built from the node
+   * database, they are rebuilt after the RDM is restored from hardware. */
+  bool owners_valid;
+  /* Counters. */
+  uint64_t steps;
+  uint64_t l1_moves;
+  uint64_t l2_moves;
+  uint64_t move_failures;
+  uint64_t alloc_reclaim;
+  uint64_t alloc_failures;
+};
+
 struct mc_mgr_mgid_list_t {
   struct mc_mgr_mgid_list_t *next;
   int mgid;
@@ -259,6 +304,8 @@ struct mc_mgr_rdm_t {
   mc_mutex_t rdm_change_list_mtx;
   /* The device id the RDM belongs to. */
   bf_dev_id_t dev;
+  /* Background compaction state. */
+  struct mc_mgr_rdm_defrag_t defrag;
 };
 
 static inline mc_mgr_rdm_line_t *get_rdm_line(mc_mgr_rdm_t *r, int line) {
@@ -433,6 +480,8 @@ static inline void mark_block_free(mc_mgr_rdm_t *rdm_map, int pipe, int blk) {
   /* Add to the free block list. */
   bf_bs_set(&rdm_map->free_blocks, blk, 1);
   rdm_map->blocks[blk].pipe = -1;
+  rdm_map->blocks[blk].defrag_done = false;
+  bf_map_destroy(&rdm_map->blocks[blk].owners);
   if (rdm_map->blk_id_width == TOF3_MC_MGR_RDM_BLK_ID_BITWIDTH) {
     rdm_map->blk_ids[blk / 8] &= ~(0xf << (4 * (blk & 0x7)));
     rdm_map->blk_ids_other_die[blk / 8] &= ~(0xf << (4 * (blk & 0x7)));
@@ -680,4 +729,46 @@ void mc_mgr_enqueue_mgid_tail_update(bf_dev_id_t dev,
                                      int length);
 bf_status_t mc_mgr_rdm_reserve_tails(int sid, bf_dev_id_t dev, int pipe);
 uint32_t mc_mgr_rdm_get_l2_lagid(bf_dev_id_t dev, uint32_t addr);
+int mc_mgr_rdm_addr_to_blk(bf_dev_id_t dev, uint32_t addr);
+uint32_t mc_mgr_rdm_map_get_compact(int sid,
+                                    bf_dev_id_t dev,
+                                    int pipe,
+                                    mc_mgr_rdm_node_type_e type,
+                                    int count,
+                                    int avoid_blk);
+void mc_mgr_rdm_frag_stats_get(bf_dev_id_t dev,
+                               int pipe,
+                               bf_mc_rdm_frag_stats_t *stats);
+bf_status_t mc_mgr_rdm_defrag_cfg_set(bf_dev_id_t dev,
+                                      const bf_mc_rdm_defrag_cfg_t *cfg);
+int mc_mgr_rdm_defrag_step(int sid, bf_dev_id_t dev, uint32_t max_moves);
+void mc_mgr_rdm_blk_owner_add(bf_dev_id_t dev, uint32_t addr, uint32_t hdl);
+
+/* Result of offering one owner of the compactor's victim block to the
+ * relocation callback. */
+typedef enum mc_mgr_rdm_owner_sts_e {
+  /* The node no longer has (movable) entries in the block. */
+  mc_mgr_rdm_owner_gone = 0,
+  /* The node's entries were moved out of the block. */
+  mc_mgr_rdm_owner_moved,
+  /* The node's entries could not be moved this time. */
+  mc_mgr_rdm_owner_skipped,
+  /* There is no room left to move entries into, stop. */
+  mc_mgr_rdm_owner_no_room,
+} mc_mgr_rdm_owner_sts_e;
+typedef mc_mgr_rdm_owner_sts_e (*mc_mgr_rdm_owner_fn)(unsigned long hdl,
+                                                      void *cookie);
+uint32_t mc_mgr_rdm_owners_walk(bf_map_t *owners,
+                                uint32_t budget,
+                                mc_mgr_rdm_owner_fn fn,
+                                void *cookie,
+                                bool *found);
+uint32_t mc_mgr_rdm_frag_pct(uint32_t blocks,
+                             uint32_t used,
+                             uint32_t blk_size,
+                             uint32_t *reclaimable);
+bool mc_mgr_rdm_defrag_due(uint32_t blocks,
+                           uint32_t reclaimable,
+                           uint32_t threshold,
+                           bool urgent);
 #endif
@@ -18,16 +18,50 @@
  ******************************************************************************/
 
 
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "google/rpc/code.pb.h"
 #include "google/rpc/status.pb.h"
+#include "p4/config/v1/p4info.pb.h"
+#include "p4/v1/p4runtime.pb.h"
 
 #include "p4_rt/device_mgr.h"
 
+#include <bf_rt/bf_rt_info.hpp>
+#include <bf_rt/bf_rt_init.hpp>
+#include <bf_rt/bf_rt_learn.hpp>
+#include <bf_rt/bf_rt_session.hpp>
+#include <bf_rt/bf_rt_table.hpp>
+#include <bf_rt/bf_rt_table_data.hpp>
+#include <bf_rt/bf_rt_table_key.hpp>
+#include <pipe_mgr/pipe_mgr_intf.h>
+#include <pkt_mgr/bf_pkt.h>
+#include <pkt_mgr/pkt_mgr_intf.h>
+extern "C" {
+#include <dvm/bf_drv_profile.h>
+#include <tofino/bf_pal/dev_intf.h>
+}
+
 #include "report_error.h"
 
 using Code = ::google::rpc::Code;
 using device_id_t = ::pi::fe::proto::DeviceMgr::device_id_t;
 using p4_id_t = ::pi::fe::proto::DeviceMgr::p4_id_t;
+using ReadChunkCb = ::pi::fe::proto::DeviceMgr::ReadChunkCb;
 using Status = ::pi::fe::proto::DeviceMgr::Status;
 using StreamMessageResponseCb =
     ::pi::fe::proto::DeviceMgr::StreamMessageResponseCb;
@@ -39,55 +73,1604 @@ namespace bf {
 
 namespace p4rt {
 
-// TODO: implement with BFRT
+namespace {
+
+// P4Runtime priorities grow with precedence, pipe_mgr priorities shrink.
+constexpr uint64_t kMaxPriority = (1 << 24) - 1;
+// Number of key/data objects reused across tableEntryGetNext_n calls, this
+// bounds the memory a wildcard read allocates regardless of table size.
+constexpr uint32_t kReadChunkSize = 256;
+constexpr size_t kMaxProgNameSize = 100;
+// A driver learn buffer stays pinned until the controller acked every digest
+// list built from it. Past this many the oldest one is acked on the
+// controller's behalf.
+constexpr size_t kMaxPendingDigestAcks = 1024;
+const char kMatchPriorityField[] = "$MATCH_PRIORITY";
+
+size_t bits_to_bytes(size_t bits) { return (bits + 7) / 8; }
+
+Status bf_error_status(bf_status_t sts) {
+  Code code;
+  switch (sts) {
+    case BF_ALREADY_EXISTS:
+      code = Code::ALREADY_EXISTS;
+      break;
+    case BF_OBJECT_NOT_FOUND:
+      code = Code::NOT_FOUND;
+      break;
+    case BF_INVALID_ARG:
+      code = Code::INVALID_ARGUMENT;
+      break;
+    case BF_NO_SYS_RESOURCES:
+    case BF_NO_SPACE:
+      code = Code::RESOURCE_EXHAUSTED;
+      break;
+    case BF_NOT_SUPPORTED:
+    case BF_NOT_IMPLEMENTED:
+      code = Code::UNIMPLEMENTED;
+      break;
+    case BF_IN_USE:
+    case BF_NOT_READY:
+      code = Code::FAILED_PRECONDITION;
+      break;
+    default:
+      code = Code::INTERNAL;
+      break;
+  }
+  RETURN_ERROR_STATUS(code, std::string(bf_err_str(sts)));
+}
+
+#define RETURN_IF_BF_ERROR(sts)                            \
+  do {                                                     \
+    bf_status_t sts_ = (sts);                              \
+    if (sts_ != BF_SUCCESS) return bf_error_status(sts_);  \
+  } while (false)
+
+// Converts a P4Runtime bytestring to a big-endian buffer of exactly the
+// BF-RT field width. Leading zeros are accepted, values wider than the field
+// are not.
+Status bytes_to_field(const std::string &in, size_t bits, std::string *out) {
+  size_t nbytes = bits_to_bytes(bits);
+  size_t first = in.find_first_not_of('\0');
+  if (first == std::string::npos) {
+    out->assign(nbytes, '\0');
+    RETURN_OK_STATUS();
+  }
+  size_t len = in.size() - first;
+  if (len > nbytes) {
+    RETURN_ERROR_STATUS(Code::OUT_OF_RANGE, "Bytestring exceeds field width");
+  }
+  if (len == nbytes && bits % 8 != 0 &&
+      (static_cast<uint8_t>(in[first]) >> (bits % 8)) != 0) {
+    RETURN_ERROR_STATUS(Code::OUT_OF_RANGE, "Bytestring exceeds field width");
+  }
+  out->assign(nbytes - len, '\0');
+  out->append(in, first, len);
+  RETURN_OK_STATUS();
+}
+
+// Canonical P4Runtime bytestring: no leading zeros, at least one byte.
+std::string field_to_bytes(const uint8_t *buf, size_t nbytes) {
+  size_t first = 0;
+  while (first + 1 < nbytes && buf[first] == 0) first++;
+  return std::string(reinterpret_cast<const char *>(buf + first),
+                     nbytes - first);
+}
+
+bool all_bits_set(const uint8_t *buf, size_t bits) {
+  size_t nbytes = bits_to_bytes(bits);
+  for (size_t i = 0; i < nbytes; i++) {
+    uint8_t expected = 0xff;
+    if (i == 0 && bits % 8 != 0) expected >>= 8 - bits % 8;
+    if (buf[i] != expected) return false;
+  }
+  return true;
+}
+
+bool all_bits_clear(const uint8_t *buf, size_t nbytes) {
+  for (size_t i = 0; i < nbytes; i++) {
+    if (buf[i] != 0) return false;
+  }
+  return true;
+}
+
+// Packet IO headers are packed MSB first, fields are not byte aligned.
+void bits_write(uint8_t *buf, size_t offset, const std::string &value,
+                size_t bits) {
+  for (size_t i = 0; i < bits; i++) {
+    size_t src_bit = value.size() * 8 - bits + i;
+    uint8_t byte = static_cast<uint8_t>(value[src_bit / 8]);
+    if (byte & (0x80 >> (src_bit % 8))) {
+      buf[(offset + i) / 8] |= 0x80 >> ((offset + i) % 8);
+    }
+  }
+}
+
+std::string bits_read(const uint8_t *buf, size_t offset, size_t bits) {
+  std::vector<uint8_t> out(bits_to_bytes(bits), 0);
+  size_t pad = out.size() * 8 - bits;
+  for (size_t i = 0; i < bits; i++) {
+    if (buf[(offset + i) / 8] & (0x80 >> ((offset + i) % 8))) {
+      out[(pad + i) / 8] |= 0x80 >> ((pad + i) % 8);
+    }
+  }
+  return field_to_bytes(out.data(), out.size());
+}
+
+// Tofino device config as packed by p4runtime-shell and update_config.py:
+// a sequence of (little-endian uint32 length, bytes) chunks.
+struct DeviceConfig {
+  std::string prog_name;
+  std::string binary;
+  std::string context;
+  std::string pipeline_name;
+  std::string bfrt;
+};
+
+Status device_config_parse(const std::string &blob, DeviceConfig *config) {
+  size_t pos = 0;
+  auto chunk = [&blob, &pos](std::string *out) {
+    if (blob.size() - pos < 4) return false;
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(blob.data() + pos);
+    uint32_t size = p[0] | (p[1] << 8) | (p[2] << 16) |
+                    (static_cast<uint32_t>(p[3]) << 24);
+    pos += 4;
+    if (blob.size() - pos < size) return false;
+    out->assign(blob, pos, size);
+    pos += size;
+    return true;
+  };
+  if (!chunk(&config->prog_name) || !chunk(&config->binary) ||
+      !chunk(&config->context) || !chunk(&config->pipeline_name)) {
+    RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT, "Truncated device config");
+  }
+  if (config->prog_name.empty() ||
+      config->prog_name.size() > kMaxProgNameSize ||
+      config->pipeline_name.size() > kMaxProgNameSize) {
+    RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT, "Invalid program name");
+  }
+  // BF-RT is the only programming interface, so its schema is mandatory.
+  if (config->pipeline_name.empty() || !chunk(&config->bfrt)) {
+    RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT,
+                        "Device config does not include bf-rt.json");
+  }
+  RETURN_OK_STATUS();
+}
+
+bool temp_file_write(const std::string &prefix,
+                     const std::string &data,
+                     std::string *path) {
+  std::string name = prefix + ".XXXXXX";
+  int fd = mkstemp(&name[0]);
+  if (fd == -1) return false;
+  *path = name;
+  size_t done = 0;
+  while (done < data.size()) {
+    ssize_t written = ::write(fd, data.data() + done, data.size() - done);
+    if (written == -1) break;
+    done += written;
+  }
+  close(fd);
+  return done == data.size();
+}
+
+// Matches a P4Info name against a BF-RT name which may carry an extra
+// pipeline prefix ("pipe.SwitchIngress.t" vs "SwitchIngress.t").
+bool name_matches(const std::string &bfrt_name, const std::string &p4_name) {
+  if (bfrt_name == p4_name) return true;
+  return bfrt_name.size() > p4_name.size() &&
+         bfrt_name.compare(bfrt_name.size() - p4_name.size(),
+                           p4_name.size(),
+                           p4_name) == 0 &&
+         bfrt_name[bfrt_name.size() - p4_name.size() - 1] == '.';
+}
+
+// Collects the entities of a read. With a chunk callback the response is
+// handed over and cleared every chunk_size entities, a chunk_size of 0 never
+// splits it.
+class ReadWriter {
+ public:
+  explicit ReadWriter(p4v1::ReadResponse *response,
+                      size_t chunk_size = 0,
+                      const ReadChunkCb *cb = nullptr)
+      : response_(response), chunk_size_(chunk_size), cb_(cb) {}
+
+  p4v1::Entity *add() { return response_->add_entities(); }
+
+  // Called once the entity returned by add() is filled in.
+  Status added() {
+    if (cb_ == nullptr || chunk_size_ == 0 ||
+        static_cast<size_t>(response_->entities_size()) < chunk_size_) {
+      RETURN_OK_STATUS();
+    }
+    return send();
+  }
+
+  // Sends what is left, or an empty response if nothing was sent yet.
+  Status finish() {
+    if (cb_ == nullptr || (sent_ && response_->entities_size() == 0)) {
+      RETURN_OK_STATUS();
+    }
+    return send();
+  }
+
+ private:
+  Status send() {
+    if (!(*cb_)(*response_)) {
+      RETURN_ERROR_STATUS(Code::CANCELLED, "Read response stream closed");
+    }
+    response_->Clear();
+    sent_ = true;
+    RETURN_OK_STATUS();
+  }
+
+  p4v1::ReadResponse *response_;
+  size_t chunk_size_;
+  const ReadChunkCb *cb_;
+  bool sent_ = false;
+};
+
+}  // namespace
+
 class DeviceMgrImp {
  public:
-  explicit DeviceMgrImp(device_id_t device_id) : device_id(device_id) {}
+  explicit DeviceMgrImp(device_id_t dev_id)
+      : device_id(dev_id),
+        dev(static_cast<bf_dev_id_t>(dev_id)),
+        gate(dev_id < BF_MAX_DEV_COUNT ? &gates[dev_id] : nullptr) {
+    if (gate == nullptr) return;
+    std::lock_guard<std::mutex> lock(gate->mutex);
+    gate->mgr = this;
+  }
 
-  ~DeviceMgrImp() {}
+  // Driver callbacks may still run after they are deregistered, so the gate
+  // is closed and drained first. This must not hold mutex, callbacks take
+  // it.
+  ~DeviceMgrImp() {
+    if (gate != nullptr) {
+      std::unique_lock<std::mutex> lock(gate->mutex);
+      if (gate->mgr == this) gate->mgr = nullptr;
+      gate->idle.wait(lock, [this] { return gate->active == 0; });
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    unbind();
+    if (rx_registered) {
+      for (int ring = BF_PKT_RX_RING_0; ring < BF_PKT_RX_RING_MAX; ring++) {
+        bf_pkt_rx_deregister(dev, static_cast<bf_pkt_rx_ring_t>(ring));
+      }
+      bf_pkt_tx_done_notif_deregister(dev, BF_PKT_TX_RING_0);
+    }
+  }
 
   Status pipeline_config_set(
-      p4v1::SetForwardingPipelineConfigRequest::Action /*action*/,
-      const p4v1::ForwardingPipelineConfig & /*config*/) {
-    RETURN_ERROR_STATUS(Code::UNIMPLEMENTED);
+      p4v1::SetForwardingPipelineConfigRequest::Action action,
+      const p4v1::ForwardingPipelineConfig &config) {
+    using Action = p4v1::SetForwardingPipelineConfigRequest;
+    std::lock_guard<std::mutex> lock(mutex);
+    DeviceConfig device_config;
+    bool push = !config.p4_device_config().empty();
+    switch (action) {
+      case Action::VERIFY:
+        if (push) {
+          RETURN_IF_ERROR(
+              device_config_parse(config.p4_device_config(), &device_config));
+        }
+        RETURN_OK_STATUS();
+      case Action::VERIFY_AND_SAVE:
+      case Action::VERIFY_AND_COMMIT:
+        if (push) {
+          RETURN_IF_ERROR(
+              device_config_parse(config.p4_device_config(), &device_config));
+          RETURN_IF_ERROR(device_config_push(device_config));
+        }
+        saved_config = config;
+        saved_prog_name = device_config.prog_name;
+        has_saved_config = true;
+        if (action == Action::VERIFY_AND_SAVE) RETURN_OK_STATUS();
+        return commit();
+      case Action::COMMIT:
+        return commit();
+      default:
+        RETURN_ERROR_STATUS(Code::UNIMPLEMENTED);
+    }
   }
 
   Status pipeline_config_get(
-      p4v1::GetForwardingPipelineConfigRequest::ResponseType /*response_type*/,
-      p4v1::ForwardingPipelineConfig * /*config*/) {
-    RETURN_ERROR_STATUS(Code::UNIMPLEMENTED);
+      p4v1::GetForwardingPipelineConfigRequest::ResponseType response_type,
+      p4v1::ForwardingPipelineConfig *config) {
+    using Request = p4v1::GetForwardingPipelineConfigRequest;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (info == nullptr) RETURN_OK_STATUS();
+    switch (response_type) {
+      case Request::ALL:
+        *config = committed_config;
+        break;
+      case Request::COOKIE_ONLY:
+        config->mutable_cookie()->CopyFrom(committed_config.cookie());
+        break;
+      case Request::P4INFO_AND_COOKIE:
+        config->mutable_p4info()->CopyFrom(committed_config.p4info());
+        config->mutable_cookie()->CopyFrom(committed_config.cookie());
+        break;
+      case Request::DEVICE_CONFIG_AND_COOKIE:
+        config->set_p4_device_config(committed_config.p4_device_config());
+        config->mutable_cookie()->CopyFrom(committed_config.cookie());
+        break;
+      default:
+        RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT);
+    }
+    RETURN_OK_STATUS();
   }
 
-  Status write(const p4v1::WriteRequest & /*request*/) {
-    RETURN_ERROR_STATUS(Code::UNIMPLEMENTED);
+  // All updates of a request are pushed to the driver as a single BF-RT
+  // batch, errors are reported per update in the status details.
+  Status write(const p4v1::WriteRequest &request) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (info == nullptr) {
+      RETURN_ERROR_STATUS(Code::FAILED_PRECONDITION,
+                          "No forwarding pipeline config");
+    }
+    if (request.atomicity() != p4v1::WriteRequest::CONTINUE_ON_ERROR) {
+      RETURN_ERROR_STATUS(Code::UNIMPLEMENTED);
+    }
+    std::vector<Status> results;
+    results.reserve(request.updates_size());
+    bool has_error = false;
+    bf_status_t sts = session->beginBatch();
+    if (sts != BF_SUCCESS) return bf_error_status(sts);
+    for (const auto &update : request.updates()) {
+      results.push_back(write_update(update));
+      if (IS_ERROR(results.back())) has_error = true;
+    }
+    sts = session->endBatch(true);
+    if (sts != BF_SUCCESS) return bf_error_status(sts);
+    if (!has_error) RETURN_OK_STATUS();
+
+    Status status;
+    status.set_code(Code::UNKNOWN);
+    for (const auto &result : results) {
+      p4v1::Error error;
+      error.set_canonical_code(result.code());
+      error.set_message(result.message());
+      error.set_space("ALL-bf-rt");
+      status.add_details()->PackFrom(error);
+    }
+    return status;
+  }
+
+  Status read(const p4v1::ReadRequest &request,
+              p4v1::ReadResponse *response) const {
+    ReadWriter writer(response);
+    for (const auto &entity : request.entities()) {
+      RETURN_IF_ERROR(read_entity(entity, &writer));
+    }
+    RETURN_OK_STATUS();
   }
 
-  Status read(const p4v1::ReadRequest & /*request*/,
-              p4v1::ReadResponse * /*response*/) const {
-    RETURN_ERROR_STATUS(Code::UNIMPLEMENTED);
+  Status read(const p4v1::ReadRequest &request,
+              size_t chunk_size,
+              const ReadChunkCb &cb) const {
+    p4v1::ReadResponse response;
+    ReadWriter writer(&response, chunk_size, &cb);
+    for (const auto &entity : request.entities()) {
+      RETURN_IF_ERROR(read_entity(entity, &writer));
+    }
+    return writer.finish();
   }
 
-  Status read_one(const p4v1::Entity & /*entity*/,
-                  p4v1::ReadResponse * /*response*/) const {
-    RETURN_ERROR_STATUS(Code::UNIMPLEMENTED);
+  Status read_one(const p4v1::Entity &entity,
+                  p4v1::ReadResponse *response) const {
+    ReadWriter writer(response);
+    return read_entity(entity, &writer);
   }
 
   Status stream_message_request_handle(
-      const p4::v1::StreamMessageRequest & /*request*/) {
-    RETURN_ERROR_STATUS(Code::UNIMPLEMENTED);
+      const p4::v1::StreamMessageRequest &request) {
+    switch (request.update_case()) {
+      case p4v1::StreamMessageRequest::kPacket: {
+        std::lock_guard<std::mutex> lock(mutex);
+        return packet_out(request.packet());
+      }
+      case p4v1::StreamMessageRequest::kDigestAck:
+        return digest_ack(request.digest_ack());
+      default:
+        RETURN_ERROR_STATUS(Code::UNIMPLEMENTED);
+    }
   }
 
-  void stream_message_response_register_cb(StreamMessageResponseCb /*cb*/,
-                                           void * /*cookie*/) {}
+  void stream_message_response_register_cb(StreamMessageResponseCb cb,
+                                           void *cookie) {
+    std::lock_guard<std::mutex> lock(cb_mutex);
+    stream_cb = std::move(cb);
+    stream_cb_cookie = cookie;
+  }
 
   static void init(size_t /*max_devices*/) {}
 
   static void destroy() {}
 
  private:
+  struct KeyField {
+    bf_rt_id_t id;
+    size_t bits;
+    bfrt::KeyFieldType type;
+    p4_id_t p4_id;
+  };
+
+  struct Param {
+    bf_rt_id_t id;
+    size_t bits;
+    p4_id_t p4_id;
+  };
+
+  struct ActionInfo {
+    bf_rt_id_t id;
+    p4_id_t p4_id;
+    std::vector<Param> params;
+  };
+
+  // Resolved once per pipeline so that writes never look anything up by
+  // name. The key and data objects are reused by every write.
+  struct TableInfo {
+    const bfrt::BfRtTable *table;
+    p4_id_t p4_id;
+    std::vector<KeyField> keys;
+    std::unordered_map<p4_id_t, size_t> key_index;
+    bool has_priority;
+    bf_rt_id_t priority_id;
+    std::unordered_map<p4_id_t, ActionInfo> actions;
+    std::unordered_map<bf_rt_id_t, const ActionInfo *> actions_by_id;
+    std::unique_ptr<bfrt::BfRtTableKey> key;
+    std::unordered_map<bf_rt_id_t, std::unique_ptr<bfrt::BfRtTableData>> data;
+  };
+
+  struct DigestInfo {
+    const bfrt::BfRtLearn *learn;
+    p4_id_t p4_id;
+    std::vector<std::pair<bf_rt_id_t, size_t>> fields;
+    bool enabled;
+    p4v1::DigestEntry::Config config;
+  };
+
+  struct PacketMetadata {
+    uint32_t id;
+    size_t bits;
+  };
+
+  // What the learn callback of an enabled digest needs, guarded by
+  // digest_mutex. Callbacks of an earlier registration carry another
+  // generation.
+  struct DigestState {
+    const bfrt::BfRtLearn *learn;
+    std::vector<std::pair<bf_rt_id_t, size_t>> fields;
+    uint64_t generation;
+    size_t max_list_size;
+  };
+
+  struct PendingAck {
+    p4_id_t digest_id;
+    uint64_t msg_id;
+  };
+
+  // A driver learn message, split into the num_lists digest lists starting
+  // at its msg_id. Acked with the session of the callback that delivered
+  // it, learn_session is only valid under mutex.
+  struct PendingMsg {
+    const bfrt::BfRtLearn *learn;
+    std::shared_ptr<bfrt::BfRtSession> session;
+    bf_rt_learn_msg_hdl *hdl;
+    size_t num_lists;
+    size_t lists_left;
+  };
+
+  // pkt_mgr and the learn path call back without a lock of their own, so a
+  // callback can still be running, or about to start, once deregistration
+  // returns. Callbacks reach the manager through the gate of their device,
+  // which outlives it.
+  struct CallbackGate {
+    std::mutex mutex;
+    std::condition_variable idle;
+    DeviceMgrImp *mgr = nullptr;
+    size_t active = 0;
+  };
+
+  // Keeps the gate open for one callback, mgr() is null once it is closed.
+  class GateEntry {
+   public:
+    explicit GateEntry(CallbackGate *gate) : gate_(gate) {
+      std::lock_guard<std::mutex> lock(gate_->mutex);
+      mgr_ = gate_->mgr;
+      if (mgr_ != nullptr) gate_->active++;
+    }
+
+    ~GateEntry() {
+      if (mgr_ == nullptr) return;
+      std::lock_guard<std::mutex> lock(gate_->mutex);
+      if (--gate_->active == 0) gate_->idle.notify_all();
+    }
+
+    DeviceMgrImp *mgr() const { return mgr_; }
+
+   private:
+    CallbackGate *gate_;
+    DeviceMgrImp *mgr_;
+  };
+
+  // Chunks are written to the stream with mutex held, so a stalled reader
+  // holds up every other request to the device.
+  Status read_entity(const p4v1::Entity &entity, ReadWriter *writer) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (info == nullptr) {
+      RETURN_ERROR_STATUS(Code::FAILED_PRECONDITION,
+                          "No forwarding pipeline config");
+    }
+    switch (entity.entity_case()) {
+      case p4v1::Entity::kTableEntry:
+        return table_read(entity.table_entry(), writer);
+      case p4v1::Entity::kDigestEntry:
+        return digest_read(entity.digest_entry(), writer);
+      default:
+        RETURN_ERROR_STATUS(Code::UNIMPLEMENTED);
+    }
+  }
+
+  bf_rt_target_t target() const {
+    bf_rt_target_t tgt;
+    tgt.dev_id = dev;
+    tgt.pipe_id = BF_DEV_PIPE_ALL;
+    tgt.direction = BF_DEV_DIR_ALL;
+    tgt.prsr_id = BF_DEV_PIPE_PARSER_ALL;
+    return tgt;
+  }
+
+  Status device_config_push(const DeviceConfig &config) {
+    RETURN_IF_BF_ERROR(bf_pal_device_warm_init_begin(
+        dev, BF_DEV_WARM_INIT_FAST_RECFG, BF_DEV_SERDES_UPD_NONE, true));
+    std::string cfg_file, ctx_file, bfrt_file;
+    bool written =
+        temp_file_write(config.prog_name + "-cfg.bin", config.binary,
+                        &cfg_file) &&
+        temp_file_write(config.prog_name + "-ctx.json", config.context,
+                        &ctx_file) &&
+        temp_file_write(config.prog_name + "-bf-rt.json", config.bfrt,
+                        &bfrt_file);
+    bf_status_t sts = BF_NO_SYS_RESOURCES;
+    if (written) {
+      auto profile = std::make_unique<bf_device_profile_t>();
+      std::memset(profile.get(), 0, sizeof(*profile));
+      profile->num_p4_programs = 1;
+      bf_p4_program_t *program = &profile->p4_programs[0];
+      snprintf(program->prog_name, PROG_NAME_LEN, "%s",
+               config.prog_name.c_str());
+      program->bfrt_json_file = &bfrt_file[0];
+      program->num_p4_pipelines = 1;
+      bf_p4_pipeline_t *pipeline = &program->p4_pipelines[0];
+      snprintf(pipeline->p4_pipeline_name, PROG_NAME_LEN, "%s",
+               config.pipeline_name.c_str());
+      pipeline->cfg_file = &cfg_file[0];
+      pipeline->runtime_context_file = &ctx_file[0];
+      pipeline->pi_config_file = nullptr;
+      pipeline->num_pipes_in_scope = 0;
+      sts = bf_pal_device_add(dev, profile.get());
+    }
+    for (const auto *file : {&cfg_file, &ctx_file, &bfrt_file}) {
+      if (!file->empty()) unlink(file->c_str());
+    }
+    if (!written) {
+      RETURN_ERROR_STATUS(Code::INTERNAL, "Cannot write device config files");
+    }
+    RETURN_IF_BF_ERROR(sts);
+    pending_warm_init = true;
+    RETURN_OK_STATUS();
+  }
+
+  Status commit() {
+    if (!has_saved_config) {
+      RETURN_ERROR_STATUS(Code::FAILED_PRECONDITION,
+                          "No saved forwarding pipeline config");
+    }
+    if (pending_warm_init) {
+      pending_warm_init = false;
+      unbind();
+      RETURN_IF_BF_ERROR(bf_pal_device_warm_init_end(dev));
+    }
+    has_saved_config = false;
+    return bind(saved_prog_name, saved_config);
+  }
+
+  const bfrt::BfRtInfo *program_info(const std::string &prog_name,
+                                     const p4configv1::P4Info &p4info) {
+    auto &dev_mgr = bfrt::BfRtDevMgr::getInstance();
+    const bfrt::BfRtInfo *prog_info = nullptr;
+    for (const auto &name : {prog_name, p4info.pkg_info().name()}) {
+      if (name.empty()) continue;
+      if (dev_mgr.bfRtInfoGet(dev, name, &prog_info) == BF_SUCCESS) {
+        return prog_info;
+      }
+    }
+    // The pipeline was loaded by bf_switchd and P4Info does not name it.
+    std::vector<std::reference_wrapper<const std::string>> names;
+    if (dev_mgr.bfRtInfoP4NamesGet(dev, names) != BF_SUCCESS ||
+        names.empty()) {
+      return nullptr;
+    }
+    if (dev_mgr.bfRtInfoGet(dev, names[0].get(), &prog_info) != BF_SUCCESS) {
+      return nullptr;
+    }
+    return prog_info;
+  }
+
+  Status table_bind(const p4configv1::Table &p4_table,
+                    const std::vector<const bfrt::BfRtTable *> &bfrt_tables,
+                    const std::unordered_map<p4_id_t,
+                                             const p4configv1::Action *>
+                        &p4_actions) {
+    const std::string &p4_name = p4_table.preamble().name();
+    TableInfo table_info;
+    table_info.table = nullptr;
+    table_info.p4_id = p4_table.preamble().id();
+    for (const auto *t : bfrt_tables) {
+      std::string name;
+      t->tableNameGet(&name);
+      if (name_matches(name, p4_name)) {
+        table_info.table = t;
+        break;
+      }
+    }
+    if (table_info.table == nullptr) {
+      info->bfrtTableFromIdGet(table_info.p4_id, &table_info.table);
+    }
+    if (table_info.table == nullptr) {
+      RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT,
+                          "Table " + p4_name + " not found in BF-RT");
+    }
+    const bfrt::BfRtTable *table = table_info.table;
+
+    for (const auto &mf : p4_table.match_fields()) {
+      KeyField field;
+      field.p4_id = mf.id();
+      if (table->keyFieldIdGet(mf.name(), &field.id) != BF_SUCCESS ||
+          table->keyFieldSizeGet(field.id, &field.bits) != BF_SUCCESS ||
+          table->keyFieldTypeGet(field.id, &field.type) != BF_SUCCESS) {
+        RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT,
+                            "Key field " + mf.name() + " of " + p4_name +
+                                " not found in BF-RT");
+      }
+      table_info.key_index[field.p4_id] = table_info.keys.size();
+      table_info.keys.push_back(field);
+    }
+    table_info.has_priority =
+        table->keyFieldIdGet(kMatchPriorityField, &table_info.priority_id) ==
+        BF_SUCCESS;
+
+    std::vector<bf_rt_id_t> bfrt_action_ids;
+    table->actionIdListGet(&bfrt_action_ids);
+    for (const auto &ref : p4_table.action_refs()) {
+      auto it = p4_actions.find(ref.id());
+      if (it == p4_actions.end()) continue;
+      const p4configv1::Action &p4_action = *it->second;
+      ActionInfo action;
+      action.p4_id = ref.id();
+      bool found = false;
+      for (auto id : bfrt_action_ids) {
+        std::string name;
+        table->actionNameGet(id, &name);
+        if (name_matches(name, p4_action.preamble().name())) {
+          action.id = id;
+          found = true;
+          break;
+        }
+      }
+      if (!found) {
+        RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT,
+                            "Action " + p4_action.preamble().name() +
+                                " of " + p4_name + " not found in BF-RT");
+      }
+      for (const auto &p4_param : p4_action.params()) {
+        Param param;
+        param.p4_id = p4_param.id();
+        if (table->dataFieldIdGet(p4_param.name(), action.id, &param.id) !=
+                BF_SUCCESS ||
+            table->dataFieldSizeGet(param.id, action.id, &param.bits) !=
+                BF_SUCCESS) {
+          RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT,
+                              "Parameter " + p4_param.name() + " of " +
+                                  p4_action.preamble().name() +
+                                  " not found in BF-RT");
+        }
+        action.params.push_back(param);
+      }
+      table_info.actions.emplace(action.p4_id, std::move(action));
+    }
+    for (const auto &action : table_info.actions) {
+      table_info.actions_by_id[action.second.id] = &action.second;
+    }
+    RETURN_IF_BF_ERROR(table->keyAllocate(&table_info.key));
+    tables.emplace(table_info.p4_id, std::move(table_info));
+    RETURN_OK_STATUS();
+  }
+
+  Status digest_bind(const p4configv1::Digest &p4_digest,
+                     const p4configv1::P4TypeInfo &type_info) {
+    const std::string &p4_name = p4_digest.preamble().name();
+    DigestInfo digest;
+    digest.learn = nullptr;
+    digest.p4_id = p4_digest.preamble().id();
+    digest.enabled = false;
+    if (info->bfrtLearnFromNameGet(p4_name, &digest.learn) != BF_SUCCESS) {
+      std::vector<const bfrt::BfRtLearn *> learns;
+      info->bfrtInfoGetLearns(&learns);
+      for (const auto *learn : learns) {
+        std::string name;
+        learn->learnNameGet(&name);
+        if (name_matches(name, p4_name)) {
+          digest.learn = learn;
+          break;
+        }
+      }
+    }
+    if (digest.learn == nullptr) {
+      RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT,
+                          "Digest " + p4_name + " not found in BF-RT");
+    }
+    if (!p4_digest.type_spec().has_struct_()) {
+      RETURN_ERROR_STATUS(Code::UNIMPLEMENTED,
+                          "Digest " + p4_name + " is not a struct");
+    }
+    auto it = type_info.structs().find(p4_digest.type_spec().struct_().name());
+    if (it == type_info.structs().end()) {
+      RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT,
+                          "Type of digest " + p4_name + " not in P4Info");
+    }
+    for (const auto &member : it->second.members()) {
+      bf_rt_id_t id;
+      size_t bits;
+      if (digest.learn->learnFieldIdGet(member.name(), &id) != BF_SUCCESS ||
+          digest.learn->learnFieldSizeGet(id, &bits) != BF_SUCCESS) {
+        RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT,
+                            "Field " + member.name() + " of " + p4_name +
+                                " not found in BF-RT");
+      }
+      digest.fields.emplace_back(id, bits);
+    }
+    digests.emplace(digest.p4_id, std::move(digest));
+    RETURN_OK_STATUS();
+  }
+
+  // Resolves every P4Info object to its BF-RT counterpart.
+  Status bind(const std::string &prog_name,
+              const p4v1::ForwardingPipelineConfig &config) {
+    unbind();
+    if (gate == nullptr) {
+      RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT, "Device id out of range");
+    }
+    const p4configv1::P4Info &p4info = config.p4info();
+    info = program_info(prog_name, p4info);
+    if (info == nullptr) {
+      RETURN_ERROR_STATUS(Code::FAILED_PRECONDITION,
+                          "No P4 program loaded on the device");
+    }
+    std::vector<const bfrt::BfRtTable *> bfrt_tables;
+    info->bfrtInfoGetTables(&bfrt_tables);
+    std::unordered_map<p4_id_t, const p4configv1::Action *> p4_actions;
+    for (const auto &action : p4info.actions()) {
+      p4_actions[action.preamble().id()] = &action;
+    }
+    Status status = OK_STATUS();
+    for (const auto &table : p4info.tables()) {
+      status = table_bind(table, bfrt_tables, p4_actions);
+      if (IS_ERROR(status)) break;
+    }
+    for (int i = 0; IS_OK(status) && i < p4info.digests_size(); i++) {
+      status = digest_bind(p4info.digests(i), p4info.type_info());
+    }
+    if (IS_ERROR(status)) {
+      unbind();
+      return status;
+    }
+    for (const auto &header : p4info.controller_packet_metadata()) {
+      std::vector<PacketMetadata> *metadata;
+      if (header.preamble().name() == "packet_out") {
+        metadata = &packet_out_metadata;
+      } else if (header.preamble().name() == "packet_in") {
+        metadata = &packet_in_metadata;
+      } else {
+        continue;
+      }
+      for (const auto &m : header.metadata()) {
+        metadata->push_back({m.id(), static_cast<size_t>(m.bitwidth())});
+      }
+    }
+    session = bfrt::BfRtSession::sessionCreate();
+    learn_session = bfrt::BfRtSession::sessionCreate();
+    if (session == nullptr || learn_session == nullptr) {
+      unbind();
+      RETURN_ERROR_STATUS(Code::RESOURCE_EXHAUSTED, "Cannot create session");
+    }
+    if (!rx_registered) {
+      for (int ring = BF_PKT_RX_RING_0; ring < BF_PKT_RX_RING_MAX; ring++) {
+        bf_pkt_rx_register(
+            dev, packet_in_cb, static_cast<bf_pkt_rx_ring_t>(ring), gate);
+      }
+      bf_pkt_tx_done_notif_register(dev, packet_tx_done_cb, BF_PKT_TX_RING_0);
+      rx_registered = true;
+    }
+    committed_config = config;
+    RETURN_OK_STATUS();
+  }
+
+  void unbind() {
+    if (info != nullptr) {
+      for (auto &digest : digests) {
+        if (!digest.second.enabled) continue;
+        digest.second.learn->bfRtLearnCallbackDeregister(learn_session,
+                                                         target());
+      }
+    }
+    {
+      std::lock_guard<std::mutex> lock(digest_mutex);
+      while (!pending_msgs.empty()) digest_msg_release(pending_msgs.begin());
+      digest_states.clear();
+    }
+    tables.clear();
+    digests.clear();
+    packet_in_metadata.clear();
+    packet_out_metadata.clear();
+    if (session != nullptr) session->sessionDestroy();
+    if (learn_session != nullptr) learn_session->sessionDestroy();
+    session.reset();
+    learn_session.reset();
+    info = nullptr;
+  }
+
+  Status key_build(const TableInfo &table_info,
+                   const p4v1::TableEntry &entry,
+                   bfrt::BfRtTableKey *key) const {
+    const bfrt::BfRtTable *table = table_info.table;
+    RETURN_IF_BF_ERROR(table->keyReset(key));
+    std::vector<bool> is_set(table_info.keys.size(), false);
+    std::string value, mask;
+    for (const auto &match : entry.match()) {
+      auto it = table_info.key_index.find(match.field_id());
+      if (it == table_info.key_index.end()) {
+        RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT, "Unknown match field");
+      }
+      const KeyField &field = table_info.keys[it->second];
+      size_t nbytes = bits_to_bytes(field.bits);
+      const uint8_t *v = nullptr;
+      const uint8_t *m = nullptr;
+      bf_status_t sts = BF_INVALID_ARG;
+      is_set[it->second] = true;
+      switch (match.field_match_type_case()) {
+        case p4v1::FieldMatch::kExact:
+          if (field.type != bfrt::KeyFieldType::EXACT) break;
+          RETURN_IF_ERROR(
+              bytes_to_field(match.exact().value(), field.bits, &value));
+          v = reinterpret_cast<const uint8_t *>(value.data());
+          sts = key->setValue(field.id, v, nbytes);
+          break;
+        case p4v1::FieldMatch::kTernary:
+          if (field.type != bfrt::KeyFieldType::TERNARY) break;
+          RETURN_IF_ERROR(
+              bytes_to_field(match.ternary().value(), field.bits, &value));
+          RETURN_IF_ERROR(
+              bytes_to_field(match.ternary().mask(), field.bits, &mask));
+          v = reinterpret_cast<const uint8_t *>(value.data());
+          m = reinterpret_cast<const uint8_t *>(mask.data());
+          sts = key->setValueandMask(field.id, v, m, nbytes);
+          break;
+        case p4v1::FieldMatch::kLpm:
+          if (field.type != bfrt::KeyFieldType::LPM) break;
+          if (match.lpm().prefix_len() < 0 ||
+              static_cast<size_t>(match.lpm().prefix_len()) > field.bits) {
+            RETURN_ERROR_STATUS(Code::OUT_OF_RANGE, "Invalid prefix length");
+          }
+          RETURN_IF_ERROR(
+              bytes_to_field(match.lpm().value(), field.bits, &value));
+          v = reinterpret_cast<const uint8_t *>(value.data());
+          sts = key->setValueLpm(field.id, v,
+                                 static_cast<uint16_t>(
+                                     match.lpm().prefix_len()),
+                                 nbytes);
+          break;
+        case p4v1::FieldMatch::kRange:
+          if (field.type != bfrt::KeyFieldType::RANGE) break;
+          RETURN_IF_ERROR(
+              bytes_to_field(match.range().low(), field.bits, &value));
+          RETURN_IF_ERROR(
+              bytes_to_field(match.range().high(), field.bits, &mask));
+          v = reinterpret_cast<const uint8_t *>(value.data());
+          m = reinterpret_cast<const uint8_t *>(mask.data());
+          sts = key->setValueRange(field.id, v, m, nbytes);
+          break;
+        default:
+          break;
+      }
+      if (v == nullptr) {
+        RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT, "Invalid match type");
+      }
+      RETURN_IF_BF_ERROR(sts);
+    }
+    // Omitted fields are don't care, which is not all-zeros for every type.
+    for (size_t i = 0; i < is_set.size(); i++) {
+      if (is_set[i]) continue;
+      const KeyField &field = table_info.keys[i];
+      size_t nbytes = bits_to_bytes(field.bits);
+      std::vector<uint8_t> zero(nbytes, 0), ones(nbytes, 0xff);
+      if (field.bits % 8 != 0) ones[0] >>= 8 - field.bits % 8;
+      switch (field.type) {
+        case bfrt::KeyFieldType::EXACT:
+          RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT,
+                              "Missing exact match field");
+        case bfrt::KeyFieldType::TERNARY:
+          RETURN_IF_BF_ERROR(key->setValueandMask(
+              field.id, zero.data(), zero.data(), nbytes));
+          break;
+        case bfrt::KeyFieldType::LPM:
+          RETURN_IF_BF_ERROR(
+              key->setValueLpm(field.id, zero.data(), 0, nbytes));
+          break;
+        case bfrt::KeyFieldType::RANGE:
+          RETURN_IF_BF_ERROR(
+              key->setValueRange(field.id, zero.data(), ones.data(), nbytes));
+          break;
+        case bfrt::KeyFieldType::OPTIONAL:
+          RETURN_IF_BF_ERROR(
+              key->setValueOptional(field.id, zero.data(), false, nbytes));
+          break;
+        default:
+          break;
+      }
+    }
+    if (table_info.has_priority) {
+      if (entry.priority() <= 0 ||
+          static_cast<uint64_t>(entry.priority()) > kMaxPriority) {
+        RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT, "Invalid priority");
+      }
+      RETURN_IF_BF_ERROR(key->setValue(
+          table_info.priority_id,
+          kMaxPriority - static_cast<uint64_t>(entry.priority())));
+    } else if (entry.priority() != 0) {
+      RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT,
+                          "Priority set for a table without priorities");
+    }
+    RETURN_OK_STATUS();
+  }
+
+  Status data_build(TableInfo *table_info,
+                    const p4v1::TableAction &table_action,
+                    bfrt::BfRtTableData **data) {
+    if (table_action.type_case() != p4v1::TableAction::kAction) {
+      RETURN_ERROR_STATUS(Code::UNIMPLEMENTED,
+                          "Only direct actions are supported");
+    }
+    const p4v1::Action &p4_action = table_action.action();
+    auto it = table_info->actions.find(p4_action.action_id());
+    if (it == table_info->actions.end()) {
+      RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT, "Invalid action for table");
+    }
+    const ActionInfo &action = it->second;
+    if (static_cast<size_t>(p4_action.params_size()) != action.params.size()) {
+      RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT,
+                          "Wrong number of action parameters");
+    }
+    const bfrt::BfRtTable *table = table_info->table;
+    auto &cached = table_info->data[action.id];
+    if (cached == nullptr) {
+      RETURN_IF_BF_ERROR(table->dataAllocate(action.id, &cached));
+    } else {
+      RETURN_IF_BF_ERROR(table->dataReset(action.id, cached.get()));
+    }
+    std::string value;
+    for (const auto &p4_param : p4_action.params()) {
+      const Param *param = nullptr;
+      for (const auto &p : action.params) {
+        if (p.p4_id == p4_param.param_id()) param = &p;
+      }
+      if (param == nullptr) {
+        RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT, "Unknown parameter");
+      }
+      RETURN_IF_ERROR(bytes_to_field(p4_param.value(), param->bits, &value));
+      RETURN_IF_BF_ERROR(
+          cached->setValue(param->id,
+                           reinterpret_cast<const uint8_t *>(value.data()),
+                           bits_to_bytes(param->bits)));
+    }
+    *data = cached.get();
+    RETURN_OK_STATUS();
+  }
+
+  Status table_write(p4v1::Update::Type type, const p4v1::TableEntry &entry) {
+    auto it = tables.find(entry.table_id());
+    if (it == tables.end()) {
+      RETURN_ERROR_STATUS(Code::NOT_FOUND, "Unknown table");
+    }
+    TableInfo *table_info = &it->second;
+    const bfrt::BfRtTable *table = table_info->table;
+    const bf_rt_target_t tgt = target();
+    bfrt::BfRtTableData *data = nullptr;
+
+    if (entry.is_default_action()) {
+      if (type != p4v1::Update::MODIFY || entry.match_size() != 0) {
+        RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT,
+                            "Default entries can only be modified");
+      }
+      if (!entry.has_action()) {
+        RETURN_IF_BF_ERROR(table->tableDefaultEntryReset(*session, tgt, 0));
+        RETURN_OK_STATUS();
+      }
+      RETURN_IF_ERROR(data_build(table_info, entry.action(), &data));
+      RETURN_IF_BF_ERROR(
+          table->tableDefaultEntrySet(*session, tgt, 0, *data));
+      RETURN_OK_STATUS();
+    }
+
+    RETURN_IF_ERROR(key_build(*table_info, entry, table_info->key.get()));
+    const bfrt::BfRtTableKey &key = *table_info->key;
+    switch (type) {
+      case p4v1::Update::INSERT:
+        RETURN_IF_ERROR(data_build(table_info, entry.action(), &data));
+        RETURN_IF_BF_ERROR(table->tableEntryAdd(*session, tgt, 0, key, *data));
+        break;
+      case p4v1::Update::MODIFY:
+        RETURN_IF_ERROR(data_build(table_info, entry.action(), &data));
+        RETURN_IF_BF_ERROR(table->tableEntryMod(*session, tgt, 0, key, *data));
+        break;
+      case p4v1::Update::DELETE:
+        RETURN_IF_BF_ERROR(table->tableEntryDel(*session, tgt, 0, key));
+        break;
+      default:
+        RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT, "Invalid update type");
+    }
+    RETURN_OK_STATUS();
+  }
+
+  Status digest_write(p4v1::Update::Type type,
+                      const p4v1::DigestEntry &entry) {
+    auto it = digests.find(entry.digest_id());
+    if (it == digests.end()) {
+      RETURN_ERROR_STATUS(Code::NOT_FOUND, "Unknown digest");
+    }
+    DigestInfo &digest = it->second;
+    p4_id_t digest_id = digest.p4_id;
+    switch (type) {
+      case p4v1::Update::INSERT: {
+        if (digest.enabled) RETURN_ERROR_STATUS(Code::ALREADY_EXISTS);
+        RETURN_IF_ERROR(digest_config_check(entry.config()));
+        const bfrt::BfRtLearn *learn = digest.learn;
+        uint64_t generation;
+        {
+          // In place before the first callback can look for it.
+          std::lock_guard<std::mutex> lock(digest_mutex);
+          generation = ++digest_generation;
+          digest_states[digest_id] = {
+              learn,
+              digest.fields,
+              generation,
+              static_cast<size_t>(entry.config().max_list_size())};
+        }
+        CallbackGate *cb_gate = gate;
+        bfrt::bfRtCbFunction cb =
+            [cb_gate, digest_id, generation, learn](
+                const bf_rt_target_t &,
+                const std::shared_ptr<bfrt::BfRtSession> cb_session,
+                std::vector<std::unique_ptr<bfrt::BfRtLearnData>> learn_data,
+                bf_rt_learn_msg_hdl *const hdl,
+                const void *) {
+              GateEntry gate_entry(cb_gate);
+              if (gate_entry.mgr() == nullptr) {
+                return learn->bfRtLearnNotifyAck(cb_session, hdl);
+              }
+              return gate_entry.mgr()->digest_cb(
+                  digest_id, generation, learn, cb_session, learn_data, hdl);
+            };
+        bf_status_t sts = digest.learn->bfRtLearnCallbackRegister(
+            learn_session, target(), cb, nullptr);
+        if (sts != BF_SUCCESS) {
+          std::lock_guard<std::mutex> lock(digest_mutex);
+          digest_states.erase(digest_id);
+          return bf_error_status(sts);
+        }
+        digest.enabled = true;
+        digest.config = entry.config();
+        break;
+      }
+      case p4v1::Update::MODIFY: {
+        if (!digest.enabled) RETURN_ERROR_STATUS(Code::NOT_FOUND);
+        RETURN_IF_ERROR(digest_config_check(entry.config()));
+        {
+          std::lock_guard<std::mutex> lock(digest_mutex);
+          digest_states[digest_id].max_list_size =
+              static_cast<size_t>(entry.config().max_list_size());
+        }
+        digest.config = entry.config();
+        break;
+      }
+      case p4v1::Update::DELETE: {
+        if (!digest.enabled) RETURN_ERROR_STATUS(Code::NOT_FOUND);
+        RETURN_IF_BF_ERROR(digest.learn->bfRtLearnCallbackDeregister(
+            learn_session, target()));
+        // Lists already sent stay pending until acked or unbind().
+        std::lock_guard<std::mutex> lock(digest_mutex);
+        digest_states.erase(digest_id);
+        digest.enabled = false;
+        break;
+      }
+      default:
+        RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT, "Invalid update type");
+    }
+    RETURN_OK_STATUS();
+  }
+
+  // Lists are sent as soon as the driver hands over a learn message, which
+  // it does at the latest after the device-wide learn timeout. Bounds below
+  // it would change the timeout of every other digest, and unacked lists are
+  // not resent.
+  Status digest_config_check(const p4v1::DigestEntry::Config &config) const {
+    if (config.max_list_size() < 0) {
+      RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT, "Negative max_list_size");
+    }
+    if (config.ack_timeout_ns() != 0) {
+      RETURN_ERROR_STATUS(Code::UNIMPLEMENTED,
+                          "Resending unacked digest lists is not supported");
+    }
+    if (config.max_timeout_ns() == 0) RETURN_OK_STATUS();
+    uint32_t usecs = 0;
+    RETURN_IF_BF_ERROR(pipe_mgr_flow_lrn_get_timeout(dev, &usecs));
+    if (config.max_timeout_ns() < static_cast<int64_t>(usecs) * 1000) {
+      RETURN_ERROR_STATUS(Code::UNIMPLEMENTED,
+                          "max_timeout_ns is below the device learn timeout "
+                          "of " + std::to_string(usecs) + "us");
+    }
+    RETURN_OK_STATUS();
+  }
+
+  Status write_update(const p4v1::Update &update) {
+    const p4v1::Entity &entity = update.entity();
+    switch (entity.entity_case()) {
+      case p4v1::Entity::kTableEntry:
+        return table_write(update.type(), entity.table_entry());
+      case p4v1::Entity::kDigestEntry:
+        return digest_write(update.type(), entity.digest_entry());
+      default:
+        RETURN_ERROR_STATUS(Code::UNIMPLEMENTED);
+    }
+  }
+
+  Status key_to_entry(const TableInfo &table_info,
+                      const bfrt::BfRtTableKey &key,
+                      p4v1::TableEntry *entry) const {
+    std::vector<uint8_t> v, m;
+    for (const auto &field : table_info.keys) {
+      size_t nbytes = bits_to_bytes(field.bits);
+      v.assign(nbytes, 0);
+      m.assign(nbytes, 0);
+      switch (field.type) {
+        case bfrt::KeyFieldType::EXACT: {
+          RETURN_IF_BF_ERROR(key.getValue(field.id, nbytes, v.data()));
+          auto *match = entry->add_match();
+          match->set_field_id(field.p4_id);
+          match->mutable_exact()->set_value(field_to_bytes(v.data(), nbytes));
+          break;
+        }
+        case bfrt::KeyFieldType::TERNARY: {
+          RETURN_IF_BF_ERROR(
+              key.getValueandMask(field.id, nbytes, v.data(), m.data()));
+          if (all_bits_clear(m.data(), nbytes)) break;
+          auto *match = entry->add_match();
+          match->set_field_id(field.p4_id);
+          for (size_t i = 0; i < nbytes; i++) v[i] &= m[i];
+          match->mutable_ternary()->set_value(field_to_bytes(v.data(), nbytes));
+          match->mutable_ternary()->set_mask(field_to_bytes(m.data(), nbytes));
+          break;
+        }
+        case bfrt::KeyFieldType::LPM: {
+          uint16_t prefix_len = 0;
+          RETURN_IF_BF_ERROR(
+              key.getValueLpm(field.id, nbytes, v.data(), &prefix_len));
+          if (prefix_len == 0) break;
+          auto *match = entry->add_match();
+          match->set_field_id(field.p4_id);
+          match->mutable_lpm()->set_value(field_to_bytes(v.data(), nbytes));
+          match->mutable_lpm()->set_prefix_len(prefix_len);
+          break;
+        }
+        case bfrt::KeyFieldType::RANGE: {
+          RETURN_IF_BF_ERROR(
+              key.getValueRange(field.id, nbytes, v.data(), m.data()));
+          if (all_bits_clear(v.data(), nbytes) &&
+              all_bits_set(m.data(), field.bits)) {
+            break;
+          }
+          auto *match = entry->add_match();
+          match->set_field_id(field.p4_id);
+          match->mutable_range()->set_low(field_to_bytes(v.data(), nbytes));
+          match->mutable_range()->set_high(field_to_bytes(m.data(), nbytes));
+          break;
+        }
+        default:
+          break;
+      }
+    }
+    if (table_info.has_priority) {
+      uint64_t priority = 0;
+      RETURN_IF_BF_ERROR(key.getValue(table_info.priority_id, &priority));
+      entry->set_priority(static_cast<int32_t>(kMaxPriority - priority));
+    }
+    RETURN_OK_STATUS();
+  }
+
+  Status data_to_entry(const TableInfo &table_info,
+                       const bfrt::BfRtTableData &data,
+                       p4v1::TableEntry *entry) const {
+    bf_rt_id_t action_id;
+    RETURN_IF_BF_ERROR(data.actionIdGet(&action_id));
+    auto it = table_info.actions_by_id.find(action_id);
+    if (it == table_info.actions_by_id.end()) RETURN_OK_STATUS();
+    const ActionInfo &action = *it->second;
+    auto *p4_action = entry->mutable_action()->mutable_action();
+    p4_action->set_action_id(action.p4_id);
+    std::vector<uint8_t> v;
+    for (const auto &param : action.params) {
+      size_t nbytes = bits_to_bytes(param.bits);
+      v.assign(nbytes, 0);
+      RETURN_IF_BF_ERROR(data.getValue(param.id, nbytes, v.data()));
+      auto *p4_param = p4_action->add_params();
+      p4_param->set_param_id(param.p4_id);
+      p4_param->set_value(field_to_bytes(v.data(), nbytes));
+    }
+    RETURN_OK_STATUS();
+  }
+
+  Status table_entry_emit(const TableInfo &table_info,
+                          const bfrt::BfRtTableKey *key,
+                          const bfrt::BfRtTableData &data,
+                          ReadWriter *writer) const {
+    auto *entry = writer->add()->mutable_table_entry();
+    entry->set_table_id(table_info.p4_id);
+    if (key == nullptr) {
+      entry->set_is_default_action(true);
+    } else {
+      RETURN_IF_ERROR(key_to_entry(table_info, *key, entry));
+    }
+    RETURN_IF_ERROR(data_to_entry(table_info, data, entry));
+    return writer->added();
+  }
+
+  // Walks the table in chunks of kReadChunkSize entries. The entry used as
+  // the cursor for the next chunk is excluded from the objects handed to
+  // the driver so that its key is not overwritten while being read. Data
+  // objects keep the action of the entry last read into them, so they are
+  // reset before being reused.
+  Status table_read_all(const TableInfo &table_info,
+                        ReadWriter *writer) const {
+    const bfrt::BfRtTable *table = table_info.table;
+    const bf_rt_target_t tgt = target();
+    std::vector<std::unique_ptr<bfrt::BfRtTableKey>> keys(kReadChunkSize + 1);
+    std::vector<std::unique_ptr<bfrt::BfRtTableData>> datas(kReadChunkSize +
+                                                            1);
+    RETURN_IF_BF_ERROR(table->keyAllocate(&keys[0]));
+    RETURN_IF_BF_ERROR(table->dataAllocate(&datas[0]));
+    bf_status_t sts =
+        table->tableEntryGetFirst(*session, tgt, 0, keys[0].get(),
+                                  datas[0].get());
+    if (sts == BF_OBJECT_NOT_FOUND) RETURN_OK_STATUS();
+    RETURN_IF_BF_ERROR(sts);
+    RETURN_IF_ERROR(
+        table_entry_emit(table_info, keys[0].get(), *datas[0], writer));
+
+    for (uint32_t i = 1; i <= kReadChunkSize; i++) {
+      RETURN_IF_BF_ERROR(table->keyAllocate(&keys[i]));
+      RETURN_IF_BF_ERROR(table->dataAllocate(&datas[i]));
+    }
+    std::unordered_map<const bfrt::BfRtTableKey *, size_t> slot_of;
+    for (size_t i = 0; i < keys.size(); i++) slot_of[keys[i].get()] = i;
+    bfrt::BfRtTable::keyDataPairs pairs;
+    pairs.reserve(kReadChunkSize);
+    size_t cursor = 0;
+    uint32_t num_returned = kReadChunkSize;
+    while (num_returned == kReadChunkSize) {
+      pairs.clear();
+      for (size_t i = 0; i < keys.size(); i++) {
+        if (i == cursor) continue;
+        RETURN_IF_BF_ERROR(table->dataReset(datas[i].get()));
+        pairs.emplace_back(keys[i].get(), datas[i].get());
+      }
+      num_returned = 0;
+      sts = table->tableEntryGetNext_n(*session, tgt, 0, *keys[cursor],
+                                       kReadChunkSize, &pairs, &num_returned);
+      if (sts == BF_OBJECT_NOT_FOUND) break;
+      RETURN_IF_BF_ERROR(sts);
+      for (uint32_t i = 0; i < num_returned; i++) {
+        // Entries the driver could not read back are returned as nullptr.
+        if (pairs[i].second == nullptr) continue;
+        RETURN_IF_ERROR(table_entry_emit(
+            table_info, pairs[i].first, *pairs[i].second, writer));
+      }
+      if (num_returned > 0) cursor = slot_of[pairs[num_returned - 1].first];
+    }
+    RETURN_OK_STATUS();
+  }
+
+  Status table_read_one(const TableInfo &table_info,
+                        const p4v1::TableEntry &entry,
+                        ReadWriter *writer) const {
+    const bfrt::BfRtTable *table = table_info.table;
+    const bf_rt_target_t tgt = target();
+    std::unique_ptr<bfrt::BfRtTableData> data;
+    RETURN_IF_BF_ERROR(table->dataAllocate(&data));
+    if (entry.is_default_action()) {
+      RETURN_IF_BF_ERROR(
+          table->tableDefaultEntryGet(*session, tgt, 0, data.get()));
+      return table_entry_emit(table_info, nullptr, *data, writer);
+    }
+    if (entry.match_size() == 0 && entry.priority() == 0) {
+      return table_read_all(table_info, writer);
+    }
+    std::unique_ptr<bfrt::BfRtTableKey> key;
+    RETURN_IF_BF_ERROR(table->keyAllocate(&key));
+    RETURN_IF_ERROR(key_build(table_info, entry, key.get()));
+    RETURN_IF_BF_ERROR(
+        table->tableEntryGet(*session, tgt, 0, *key, data.get()));
+    return table_entry_emit(table_info, key.get(), *data, writer);
+  }
+
+  Status table_read(const p4v1::TableEntry &entry,
+                    ReadWriter *writer) const {
+    if (entry.table_id() == 0) {
+      for (const auto &table : tables) {
+        RETURN_IF_ERROR(table_read_all(table.second, writer));
+      }
+      RETURN_OK_STATUS();
+    }
+    auto it = tables.find(entry.table_id());
+    if (it == tables.end()) {
+      RETURN_ERROR_STATUS(Code::NOT_FOUND, "Unknown table");
+    }
+    return table_read_one(it->second, entry, writer);
+  }
+
+  Status digest_read(const p4v1::DigestEntry &entry,
+                     ReadWriter *writer) const {
+    for (const auto &digest : digests) {
+      if (entry.digest_id() != 0 && entry.digest_id() != digest.first) {
+        continue;
+      }
+      if (!digest.second.enabled) continue;
+      auto *out = writer->add()->mutable_digest_entry();
+      out->set_digest_id(digest.first);
+      out->mutable_config()->CopyFrom(digest.second.config);
+      RETURN_IF_ERROR(writer->added());
+    }
+    RETURN_OK_STATUS();
+  }
+
+  Status packet_out(const p4v1::PacketOut &packet) {
+    if (info == nullptr) {
+      RETURN_ERROR_STATUS(Code::FAILED_PRECONDITION,
+                          "No forwarding pipeline config");
+    }
+    size_t header_bits = 0;
+    for (const auto &m : packet_out_metadata) header_bits += m.bits;
+    std::vector<uint8_t> buf(bits_to_bytes(header_bits), 0);
+    size_t offset = 0;
+    std::string value;
+    for (const auto &m : packet_out_metadata) {
+      const p4v1::PacketMetadata *found = nullptr;
+      for (const auto &pm : packet.metadata()) {
+        if (pm.metadata_id() == m.id) found = &pm;
+      }
+      if (found == nullptr) {
+        RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT, "Missing packet metadata");
+      }
+      RETURN_IF_ERROR(bytes_to_field(found->value(), m.bits, &value));
+      bits_write(buf.data(), offset, value, m.bits);
+      offset += m.bits;
+    }
+    buf.insert(buf.end(), packet.payload().begin(), packet.payload().end());
+    if (buf.size() > UINT16_MAX) {
+      RETURN_ERROR_STATUS(Code::INVALID_ARGUMENT, "Packet too large");
+    }
+
+    bf_pkt *pkt = nullptr;
+    if (bf_pkt_alloc(dev, &pkt, buf.size(), BF_DMA_CPU_PKT_TRANSMIT_0) != 0) {
+      RETURN_ERROR_STATUS(Code::RESOURCE_EXHAUSTED, "Cannot allocate packet");
+    }
+    if (bf_pkt_data_copy(pkt, buf.data(), static_cast<uint16_t>(buf.size())) !=
+        0) {
+      bf_pkt_free(dev, pkt);
+      RETURN_ERROR_STATUS(Code::INTERNAL, "Cannot copy packet data");
+    }
+    bf_status_t sts = bf_pkt_tx(dev, pkt, BF_PKT_TX_RING_0, pkt);
+    if (sts != BF_SUCCESS) {
+      bf_pkt_free(dev, pkt);
+      return bf_error_status(sts);
+    }
+    RETURN_OK_STATUS();
+  }
+
+  static bf_status_t packet_tx_done_cb(bf_dev_id_t dev_id,
+                                       bf_pkt_tx_ring_t /*tx_ring*/,
+                                       uint64_t tx_cookie,
+                                       uint32_t /*status*/) {
+    bf_pkt_free(dev_id, reinterpret_cast<bf_pkt *>(tx_cookie));
+    return BF_SUCCESS;
+  }
+
+  static bf_status_t packet_in_cb(bf_dev_id_t dev_id,
+                                  bf_pkt *pkt,
+                                  void *cookie,
+                                  bf_pkt_rx_ring_t /*rx_ring*/) {
+    std::string data;
+    for (bf_pkt *seg = pkt; seg != nullptr; seg = bf_pkt_get_nextseg(seg)) {
+      data.append(reinterpret_cast<const char *>(bf_pkt_get_pkt_data(seg)),
+                  bf_pkt_get_pkt_size(seg));
+    }
+    bf_pkt_free(dev_id, pkt);
+    GateEntry entry(static_cast<CallbackGate *>(cookie));
+    if (entry.mgr() != nullptr) entry.mgr()->packet_in(data);
+    return BF_SUCCESS;
+  }
+
+  void packet_in(const std::string &data) {
+    p4v1::StreamMessageResponse msg;
+    auto *packet = msg.mutable_packet();
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      size_t header_bits = 0;
+      for (const auto &m : packet_in_metadata) header_bits += m.bits;
+      size_t header_bytes = bits_to_bytes(header_bits);
+      if (data.size() < header_bytes) return;
+      const uint8_t *buf = reinterpret_cast<const uint8_t *>(data.data());
+      size_t offset = 0;
+      for (const auto &m : packet_in_metadata) {
+        auto *metadata = packet->add_metadata();
+        metadata->set_metadata_id(m.id);
+        metadata->set_value(bits_read(buf, offset, m.bits));
+        offset += m.bits;
+      }
+      packet->set_payload(data.substr(header_bytes));
+    }
+    stream_message_send(&msg);
+  }
+
+  // Splits the learn message into lists of at most max_list_size entries.
+  // The driver buffer is acked once the controller acked all of them.
+  bf_status_t digest_cb(
+      p4_id_t digest_id,
+      uint64_t generation,
+      const bfrt::BfRtLearn *learn,
+      const std::shared_ptr<bfrt::BfRtSession> &cb_session,
+      const std::vector<std::unique_ptr<bfrt::BfRtLearnData>> &learn_data,
+      bf_rt_learn_msg_hdl *hdl) {
+    std::vector<p4v1::StreamMessageResponse> msgs;
+    {
+      // The driver keeps the learn buffer until the controller acks it.
+      std::lock_guard<std::mutex> lock(digest_mutex);
+      auto it = digest_states.find(digest_id);
+      if (it == digest_states.end() || it->second.generation != generation ||
+          learn_data.empty()) {
+        // Nothing to send, or deregistered while the driver called us.
+        return learn->bfRtLearnNotifyAck(cb_session, hdl);
+      }
+      const DigestState &state = it->second;
+      size_t list_size = state.max_list_size;
+      if (list_size == 0) list_size = learn_data.size();
+      const int64_t timestamp =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now().time_since_epoch())
+              .count();
+      const uint64_t msg_id = digest_list_id + 1;
+      std::vector<uint8_t> v;
+      for (size_t i = 0; i < learn_data.size(); i++) {
+        if (i % list_size == 0) {
+          msgs.emplace_back();
+          auto *digest_list = msgs.back().mutable_digest();
+          digest_list->set_digest_id(digest_id);
+          digest_list->set_list_id(++digest_list_id);
+          digest_list->set_timestamp(timestamp);
+          pending_acks[digest_list_id] = {digest_id, msg_id};
+        }
+        auto *members =
+            msgs.back().mutable_digest()->add_data()->mutable_struct_();
+        for (const auto &field : state.fields) {
+          size_t nbytes = bits_to_bytes(field.second);
+          v.assign(nbytes, 0);
+          learn_data[i]->getValue(field.first, nbytes, v.data());
+          members->add_members()->set_bitstring(
+              field_to_bytes(v.data(), nbytes));
+        }
+      }
+      pending_msgs[msg_id] = {learn, cb_session, hdl, msgs.size(),
+                              msgs.size()};
+      if (pending_msgs.size() > kMaxPendingDigestAcks) {
+        // Ids only grow, the first message is the oldest.
+        digest_msg_release(pending_msgs.begin());
+      }
+    }
+    for (auto &msg : msgs) stream_message_send(&msg);
+    return BF_SUCCESS;
+  }
+
+  Status digest_ack(const p4v1::DigestListAck &ack) {
+    std::lock_guard<std::mutex> lock(digest_mutex);
+    auto it = pending_acks.find(ack.list_id());
+    if (it == pending_acks.end() || it->second.digest_id != ack.digest_id()) {
+      RETURN_ERROR_STATUS(Code::NOT_FOUND, "Unknown digest list");
+    }
+    auto msg = pending_msgs.find(it->second.msg_id);
+    pending_acks.erase(it);
+    if (--msg->second.lists_left > 0) RETURN_OK_STATUS();
+    RETURN_IF_BF_ERROR(digest_msg_release(msg));
+    RETURN_OK_STATUS();
+  }
+
+  // Hands the learn buffer back to the driver and forgets the lists built
+  // from it. Called with digest_mutex held.
+  bf_status_t digest_msg_release(
+      std::map<uint64_t, PendingMsg>::iterator msg) {
+    for (uint64_t id = msg->first; id < msg->first + msg->second.num_lists;
+         id++) {
+      pending_acks.erase(id);
+    }
+    bf_status_t sts =
+        msg->second.learn->bfRtLearnNotifyAck(msg->second.session,
+                                              msg->second.hdl);
+    pending_msgs.erase(msg);
+    return sts;
+  }
+
+  // The server holds its own lock while calling into us and while sending,
+  // so the callback must never run with one of our locks held.
+  void stream_message_send(p4v1::StreamMessageResponse *msg) {
+    StreamMessageResponseCb cb;
+    void *cookie;
+    {
+      std::lock_guard<std::mutex> lock(cb_mutex);
+      cb = stream_cb;
+      cookie = stream_cb_cookie;
+    }
+    if (cb) cb(device_id, msg, cookie);
+  }
+
+  static CallbackGate gates[BF_MAX_DEV_COUNT];
+
   device_id_t device_id;
+  bf_dev_id_t dev;
+  CallbackGate *gate;
+
+  // Guards everything below down to the packet IO metadata.
+  mutable std::mutex mutex;
+  p4v1::ForwardingPipelineConfig saved_config;
+  std::string saved_prog_name;
+  bool has_saved_config = false;
+  bool pending_warm_init = false;
+  p4v1::ForwardingPipelineConfig committed_config;
+  const bfrt::BfRtInfo *info = nullptr;
+  std::shared_ptr<bfrt::BfRtSession> session;
+  std::shared_ptr<bfrt::BfRtSession> learn_session;
+  std::unordered_map<p4_id_t, TableInfo> tables;
+  std::unordered_map<p4_id_t, DigestInfo> digests;
+  std::vector<PacketMetadata> packet_in_metadata;
+  std::vector<PacketMetadata> packet_out_metadata;
+  bool rx_registered = false;
+
+  // Taken after mutex when both are needed.
+  std::mutex digest_mutex;
+  std::unordered_map<p4_id_t, DigestState> digest_states;
+  uint64_t digest_generation = 0;
+  uint64_t digest_list_id = 0;
+  std::unordered_map<uint64_t, PendingAck> pending_acks;
+  // Keyed by the id of their first list, so the oldest one comes first.
+  std::map<uint64_t, PendingMsg> pending_msgs;
+
+  std::mutex cb_mutex;
+  StreamMessageResponseCb stream_cb;
+  void *stream_cb_cookie = nullptr;
 };
 
+DeviceMgrImp::CallbackGate DeviceMgrImp::gates[BF_MAX_DEV_COUNT];
+
 }  // namespace p4rt
 
 }  // namespace bf
@@ -141,6 +1724,12 @@ Status DeviceMgr::read_one(const p4v1::Entity &entity,
   return pimp->read_one(entity, response);
 }
 
+Status DeviceMgr::read(const p4v1::ReadRequest &request,
+                       size_t chunk_size,
+                       const ReadChunkCb &cb) const {
+  return pimp->read(request, chunk_size, cb);
+}
+
 Status DeviceMgr::stream_message_request_handle(
     const p4::v1::StreamMessageRequest &request) {
   return pimp->stream_message_request_handle(request);
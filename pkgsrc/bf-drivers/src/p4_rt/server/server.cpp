@@ -55,6 +55,11 @@ namespace server {
 
 namespace {
 
+#ifdef P4RT_BFRT_ENABLED
+// Entities per ReadResponse of a streamed read.
+constexpr size_t kReadChunkEntities = 1024;
+#endif
+
 // Copied from
 // https://github.com/grpc/grpc/blob/master/src/cpp/util/error_details.cc
 // Cannot use libgrpc++_error_details, as the library includes
@@ -371,11 +376,19 @@ class P4RuntimeServiceImpl : public p4v1::P4Runtime::Service {
   Status Read(ServerContext * /*context*/,
               const p4v1::ReadRequest *request,
               ServerWriter<p4v1::ReadResponse> *writer) override {
-    p4v1::ReadResponse response;
     auto device_mgr = Devices::get(request->device_id())->get_p4_mgr();
     if (device_mgr == nullptr) return no_pipeline_config_status();
+#ifdef P4RT_BFRT_ENABLED
+    auto status = device_mgr->read(
+        *request, kReadChunkEntities,
+        [writer](const p4v1::ReadResponse &response) {
+          return writer->Write(response);
+        });
+#else
+    p4v1::ReadResponse response;
     auto status = device_mgr->read(*request, &response);
     writer->Write(response);
+#endif
     return to_grpc_status(status);
   }
 
@@ -33,6 +33,8 @@
 #include <perf/perf_mem_intf.h>
 #include <perf/perf_int_intf.h>
 #include <perf/perf_reg_intf.h>
+#include <perf/perf_mc_intf.h>
+#include <perf/perf_ctx_json_intf.h>
 #include "perf_util.h"
 
 char *bus_type_name[PERF_INT_BUS_T_MAX] = {"Pbus", "Mbus", "Cbus", "HostIf"};
@@ -42,6 +44,9 @@ struct test_description *tests_list[] = {&sram_dma_test,
                                          &interrupts_test,
                                          &reg_indir_test,
                                          &reg_dir_test,
+                                         &mc_lag_flap_test,
+                                         &ctx_json_load_test,
+                                         &ctx_json_parse_test,
                                          NULL};
 
 struct enum_description enum_list[] = {
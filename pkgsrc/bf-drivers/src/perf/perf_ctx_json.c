@@ -0,0 +1,535 @@
+/*******************************************************************************
+ *  Copyright (C) 2024 Intel Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing,
+ *  software distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions
+ *  and limitations under the License.
+ *
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+
+#include <errno.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <target-utils/uCli/ucli.h>
+#include <dvm/bf_drv_intf.h>
+#include <pipe_mgr/pipe_mgr_drv.h>
+#include <ctx_json/ctx_json_cache.h>
+#include <ctx_json/ctx_json_reader.h>
+
+#include "perf_util.h"
+#include <perf/perf_common_intf.h>
+#include <perf/perf_ctx_json_intf.h>
+#include "perf_ctx_json.h"
+#include "perf_ucli.h"
+
+/**
+ * @brief Load and release a Context JSON file a number of times.
+ *
+ * @return Total time of all loads in ns, 0 on error.
+ */
+static uint64_t load_loop(const char *path,
+                          int iterations,
+                          bool use_cache,
+                          size_t *size) {
+  struct timespec start, stop;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < iterations; i++) {
+    ctx_json_file_t *file = ctx_json_file_load(path, use_cache);
+    if (file == NULL) return 0;
+    if (use_cache && !ctx_json_file_from_cache(file)) {
+      LOG_ERROR("%s:%d: Context JSON cache of %s not used\n",
+                __func__,
+                __LINE__,
+                path);
+      ctx_json_file_free(file);
+      return 0;
+    }
+    *size = ctx_json_file_size(file);
+    ctx_json_file_free(file);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &stop);
+  return time_delta_ns(start, stop);
+}
+
+/**
+ * @brief Run performance test that will measure the load time of a Context
+ * JSON file.
+ *
+ * @param path path to the Context JSON file
+ * @param iterations number of loads measured for each method
+ * @param result pointer to struct with results
+ * @return bf_status_t
+ */
+bf_status_t run_ctx_json_load_test(const char *path,
+                                   int iterations,
+                                   struct ctx_json_load_result *result) {
+  size_t size = 0;
+
+  if (!result) {
+    LOG_ERROR("%s:%d: No allocated memory for results\n", __func__, __LINE__);
+    bf_sys_dbgchk(0);
+    return BF_UNEXPECTED;
+  }
+  memset(result, 0, sizeof(*result));
+  result->iterations = iterations;
+
+  if (!path || iterations <= 0 || iterations > PERF_CTX_JSON_ITERATIONS_MAX) {
+    LOG_ERROR("%s:%d: Invalid parameters\n", __func__, __LINE__);
+    return BF_INVALID_ARG;
+  }
+
+  uint64_t parse_ns = load_loop(path, iterations, false, &size);
+  if (parse_ns == 0) return BF_INVALID_ARG;
+
+  /* Caching is opt-in, use a temporary directory when it is disabled. */
+  bool cache_dir_set = ctx_json_cache_dir_get() != NULL;
+  if (!cache_dir_set) ctx_json_cache_dir_set(P_tmpdir);
+
+  /* Make sure the cache exists, writing it is not measured. */
+  uint64_t cached_ns = 0;
+  ctx_json_file_t *file = ctx_json_file_load(path, true);
+  if (file != NULL) {
+    ctx_json_file_free(file);
+    cached_ns = load_loop(path, iterations, true, &size);
+  }
+  if (!cache_dir_set) ctx_json_cache_dir_set(NULL);
+  if (file == NULL) return BF_INVALID_ARG;
+  if (cached_ns == 0) return BF_UNEXPECTED;
+
+  result->size_kb = size / 1024;
+  result->parse_ms = parse_ns / iterations / 1e6;
+  result->cached_ms = cached_ns / iterations / 1e6;
+  result->speedup = (double)parse_ns / cached_ns;
+  result->status = true;
+  return BF_SUCCESS;
+}
+
+struct test_description ctx_json_load_test = {
+    .test_name = "ctx_json_load",
+    .description =
+        "The Context JSON Load test measures how long it takes to load a\n"
+        "Context JSON file into a cJSON tree.\n"
+        "The file is first loaded with the binary cache disabled, every load\n"
+        "reading and parsing the JSON text. The same file is then loaded\n"
+        "from its binary cache, which is written before the measurement to\n"
+        "the configured cache directory, or to " P_tmpdir " if none is set.\n"
+        "The test uses the CLOCK_MONOTONIC POSIX clock for all measurements.\n"
+        "The reported test result values are the average time of a single\n"
+        "load, including the release of the tree, for both methods.\n",
+    .params = {{.name = "path", .type = "string", .defaults = "context.json"},
+               {.name = "iterations", .type = "int", .defaults = "5"},
+               // last element
+               {.name = ""}},
+    .results = {{.header = "size", .unit = "[kB]", .type = "int"},
+                {.header = "iterations", .unit = "[-]", .type = "int"},
+                {.header = "parse", .unit = "[ms]", .type = "double"},
+                {.header = "cached", .unit = "[ms]", .type = "double"},
+                {.header = "speedup", .unit = "[-]", .type = "double"},
+                // last element
+                {.header = ""}}};
+
+/**
+ * @brief Run performance test that will measure the load time of a Context
+ * JSON file.
+ *
+ * @param dev_id device id
+ * @param path path to the Context JSON file
+ * @param iterations number of loads measured for each method
+ * @return test_results
+ */
+struct test_results ctx_json_load(bf_dev_id_t dev_id,
+                                  const char *path,
+                                  int iterations) {
+  struct ctx_json_load_result result;
+  struct test_results p_results;
+  (void)dev_id;
+  memset(&result, 0, sizeof(result));
+  memset(&p_results, 0, sizeof(p_results));
+
+  run_ctx_json_load_test(path, iterations, &result);
+
+  p_results.status = result.status;
+  p_results.res_int[RES_CTX_JSON_SIZE_KB] = result.size_kb;
+  p_results.res_int[RES_CTX_JSON_ITERATIONS] = result.iterations;
+  p_results.res_double[RES_CTX_JSON_PARSE_MS] = result.parse_ms;
+  p_results.res_double[RES_CTX_JSON_CACHED_MS] = result.cached_ms;
+  p_results.res_double[RES_CTX_JSON_SPEEDUP] = result.speedup;
+
+  return p_results;
+}
+
+/**
+ * @brief Run performance test that will measure the load time of a Context
+ * JSON file.
+ *
+ * @param uc ucli context pointer
+ * @param path path to the Context JSON file
+ * @return ucli_status_t
+ */
+ucli_status_t run_ctx_json_load(ucli_context_t *uc, const char *path) {
+  enum ctx_json_hdr {
+    size_hdr,
+    parse_hdr,
+    cached_hdr,
+    speedup_hdr,
+    CTX_JSON_RESULTS
+  };
+  char *result_hdr[CTX_JSON_RESULTS] = {"Size", "Parse", "Cached", "Speedup"};
+  char *unit_hdr[CTX_JSON_RESULTS] = {"[kB]", "[ms]", "[ms]", "[-]"};
+  double results[1][CTX_JSON_RESULTS] = {{0}};
+  struct ctx_json_load_result result;
+
+  banner(uc, "CONTEXT JSON LOAD");
+
+  bf_status_t sts =
+      run_ctx_json_load_test(path, PERF_CTX_JSON_ITERATIONS, &result);
+  if (sts != BF_SUCCESS || !result.status) {
+    aim_printf(&uc->pvs,
+               "%s:%d: Context JSON load test failed (%s)\n",
+               __func__,
+               __LINE__,
+               bf_err_str(sts));
+    return UCLI_STATUS_E_ERROR;
+  }
+
+  results[0][size_hdr] = result.size_kb;
+  results[0][parse_hdr] = result.parse_ms;
+  results[0][cached_hdr] = result.cached_ms;
+  results[0][speedup_hdr] = result.speedup;
+
+  for (int i = 0; i < CTX_JSON_RESULTS; i++) {
+    aim_printf(&uc->pvs, "%15s ", result_hdr[i]);
+  }
+  aim_printf(&uc->pvs, "\n");
+  for (int i = 0; i < CTX_JSON_RESULTS; i++) {
+    aim_printf(&uc->pvs, "%15s ", unit_hdr[i]);
+  }
+  aim_printf(&uc->pvs, "\n");
+  aim_printf(&uc->pvs,
+             "%15.0f %15.2f %15.2f %15.2f\n",
+             results[0][size_hdr],
+             results[0][parse_hdr],
+             results[0][cached_hdr],
+             results[0][speedup_hdr]);
+
+  save_results_file(uc,
+                    "perf_ctx_json_load.csv",
+                    CTX_JSON_RESULTS,
+                    1,
+                    result_hdr,
+                    unit_hdr,
+                    results);
+  return UCLI_STATUS_OK;
+}
+
+/* Key looked up in every object to measure misses, as for optional keys. */
+#define PERF_CTX_JSON_ABSENT_KEY "perf_absent_key"
+
+/**
+ * @brief Read a whole file into a NUL terminated buffer.
+ */
+static char *read_json(const char *path, size_t *size) {
+  FILE *file = fopen(path, "r");
+  if (file == NULL) return NULL;
+  char *buf = NULL;
+  if (fseek(file, 0, SEEK_END) == 0) {
+    long len = ftell(file);
+    if (len > 0 && fseek(file, 0, SEEK_SET) == 0) {
+      buf = bf_sys_malloc(len + 1);
+      if (buf && fread(buf, 1, len, file) == (size_t)len) {
+        buf[len] = '\0';
+        *size = len;
+      } else if (buf) {
+        bf_sys_free(buf);
+        buf = NULL;
+      }
+    }
+  }
+  fclose(file);
+  return buf;
+}
+
+/**
+ * @brief Heap memory taken by a tree built by cJSON.
+ */
+static size_t cjson_mem_size(const cJSON *node) {
+  size_t size = 0;
+  for (; node; node = node->next) {
+    size += malloc_usable_size((void *)node);
+    if (node->string) size += malloc_usable_size(node->string);
+    if (node->valuestring) size += malloc_usable_size(node->valuestring);
+    size += cjson_mem_size(node->child);
+  }
+  return size;
+}
+
+/**
+ * @brief Look up every member of every object of a tree by key, and one
+ * absent key per object.
+ *
+ * @return Number of lookups that found their member.
+ */
+static int lookup_all(const cJSON *node, bool reader) {
+  int found = 0;
+  for (const cJSON *c = node->child; c; c = c->next) {
+    if (node->type == cJSON_Object && c->string) {
+      found += (reader ? ctx_json_object_get(node, c->string)
+                       : cJSON_GetObjectItemCaseSensitive(node, c->string)) ==
+               c;
+      found += (reader ? ctx_json_object_get(node, PERF_CTX_JSON_ABSENT_KEY)
+                       : cJSON_GetObjectItemCaseSensitive(
+                             node, PERF_CTX_JSON_ABSENT_KEY)) != NULL;
+    }
+    found += lookup_all(c, reader);
+  }
+  return found;
+}
+
+/**
+ * @brief Run performance test that will compare cJSON and the Context JSON
+ * reader on a JSON file.
+ *
+ * @param path path to the JSON file
+ * @param iterations number of parses measured for each parser
+ * @param result pointer to struct with results
+ * @return bf_status_t
+ */
+bf_status_t run_ctx_json_parse_test(const char *path,
+                                    int iterations,
+                                    struct ctx_json_parse_result *result) {
+  struct timespec start, stop;
+  bf_status_t sts = BF_SUCCESS;
+  size_t size = 0;
+  cJSON *cjson_root = NULL, *reader_root = NULL;
+
+  if (!result) {
+    LOG_ERROR("%s:%d: No allocated memory for results\n", __func__, __LINE__);
+    bf_sys_dbgchk(0);
+    return BF_UNEXPECTED;
+  }
+  memset(result, 0, sizeof(*result));
+
+  if (!path || iterations <= 0 || iterations > PERF_CTX_JSON_ITERATIONS_MAX) {
+    LOG_ERROR("%s:%d: Invalid parameters\n", __func__, __LINE__);
+    return BF_INVALID_ARG;
+  }
+  char *json = read_json(path, &size);
+  if (json == NULL) {
+    LOG_ERROR("%s:%d: Cannot read %s\n", __func__, __LINE__, path);
+    return BF_INVALID_ARG;
+  }
+  result->size_kb = size / 1024;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < iterations; i++) {
+    cJSON *root = cJSON_Parse(json);
+    if (root == NULL) {
+      sts = BF_INVALID_ARG;
+      goto cleanup;
+    }
+    cJSON_Delete(root);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &stop);
+  result->cjson_ms = time_delta_ns(start, stop) / iterations / 1e6;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < iterations; i++) {
+    cJSON *root = ctx_json_reader_parse(json, size);
+    if (root == NULL) {
+      sts = BF_INVALID_ARG;
+      goto cleanup;
+    }
+    ctx_json_reader_free(root);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &stop);
+  result->reader_ms = time_delta_ns(start, stop) / iterations / 1e6;
+
+  cjson_root = cJSON_Parse(json);
+  reader_root = ctx_json_reader_parse(json, size);
+  if (cjson_root == NULL || reader_root == NULL) {
+    sts = BF_NO_SYS_RESOURCES;
+    goto cleanup;
+  }
+  result->cjson_kb = cjson_mem_size(cjson_root) / 1024;
+  result->reader_kb = ctx_json_reader_mem_size(reader_root) / 1024;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  int cjson_found = lookup_all(cjson_root, false);
+  clock_gettime(CLOCK_MONOTONIC, &stop);
+  result->cjson_lookup_ms = time_delta_ns(start, stop) / 1e6;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  int reader_found = lookup_all(reader_root, true);
+  clock_gettime(CLOCK_MONOTONIC, &stop);
+  result->reader_lookup_ms = time_delta_ns(start, stop) / 1e6;
+
+  if (cjson_found != reader_found) {
+    LOG_ERROR("%s:%d: Lookups differ, cJSON found %d members, reader %d\n",
+              __func__,
+              __LINE__,
+              cjson_found,
+              reader_found);
+    sts = BF_UNEXPECTED;
+    goto cleanup;
+  }
+  result->status = true;
+
+cleanup:
+  if (reader_root) ctx_json_reader_free(reader_root);
+  if (cjson_root) cJSON_Delete(cjson_root);
+  bf_sys_free(json);
+  return sts;
+}
+
+struct test_description ctx_json_parse_test = {
+    .test_name = "ctx_json_parse",
+    .description =
+        "The Context JSON Parse test compares cJSON and the Context JSON\n"
+        "reader on a JSON file, typically a context.json or a bf-rt.json.\n"
+        "The file is read once; the reported parse time is the average time\n"
+        "to parse the text and release the tree. The memory is the heap\n"
+        "taken by one tree, including the key index of the reader.\n"
+        "The lookup time is the time to look up every member of every object\n"
+        "by its key plus one absent key per object.\n"
+        "The test uses the CLOCK_MONOTONIC POSIX clock for all measurements.\n",
+    .params = {{.name = "path", .type = "string", .defaults = "context.json"},
+               {.name = "iterations", .type = "int", .defaults = "5"},
+               // last element
+               {.name = ""}},
+    .results = {{.header = "size", .unit = "[kB]", .type = "int"},
+                {.header = "cjson_mem", .unit = "[kB]", .type = "int"},
+                {.header = "reader_mem", .unit = "[kB]", .type = "int"},
+                {.header = "cjson_parse", .unit = "[ms]", .type = "double"},
+                {.header = "reader_parse", .unit = "[ms]", .type = "double"},
+                {.header = "cjson_lookup", .unit = "[ms]", .type = "double"},
+                {.header = "reader_lookup", .unit = "[ms]", .type = "double"},
+                // last element
+                {.header = ""}}};
+
+/**
+ * @brief Run performance test that will compare cJSON and the Context JSON
+ * reader on a JSON file.
+ *
+ * @param dev_id device id
+ * @param path path to the JSON file
+ * @param iterations number of parses measured for each parser
+ * @return test_results
+ */
+struct test_results ctx_json_parse(bf_dev_id_t dev_id,
+                                   const char *path,
+                                   int iterations) {
+  struct ctx_json_parse_result result;
+  struct test_results p_results;
+  (void)dev_id;
+  memset(&result, 0, sizeof(result));
+  memset(&p_results, 0, sizeof(p_results));
+
+  run_ctx_json_parse_test(path, iterations, &result);
+
+  p_results.status = result.status;
+  p_results.res_int[RES_CTX_JSON_PARSE_SIZE_KB] = result.size_kb;
+  p_results.res_int[RES_CTX_JSON_PARSE_CJSON_KB] = result.cjson_kb;
+  p_results.res_int[RES_CTX_JSON_PARSE_READER_KB] = result.reader_kb;
+  p_results.res_double[RES_CTX_JSON_PARSE_CJSON_MS] = result.cjson_ms;
+  p_results.res_double[RES_CTX_JSON_PARSE_READER_MS] = result.reader_ms;
+  p_results.res_double[RES_CTX_JSON_PARSE_CJSON_LOOKUP_MS] =
+      result.cjson_lookup_ms;
+  p_results.res_double[RES_CTX_JSON_PARSE_READER_LOOKUP_MS] =
+      result.reader_lookup_ms;
+
+  return p_results;
+}
+
+/**
+ * @brief Run performance test that will compare cJSON and the Context JSON
+ * reader on a JSON file.
+ *
+ * @param uc ucli context pointer
+ * @param path path to the JSON file
+ * @return ucli_status_t
+ */
+ucli_status_t run_ctx_json_parse(ucli_context_t *uc, const char *path) {
+  enum ctx_json_parse_hdr {
+    size_hdr,
+    cjson_mem_hdr,
+    reader_mem_hdr,
+    cjson_parse_hdr,
+    reader_parse_hdr,
+    cjson_lookup_hdr,
+    reader_lookup_hdr,
+    CTX_JSON_PARSE_RESULTS
+  };
+  char *result_hdr[CTX_JSON_PARSE_RESULTS] = {"Size",
+                                              "cJSON mem",
+                                              "Reader mem",
+                                              "cJSON parse",
+                                              "Reader parse",
+                                              "cJSON lookup",
+                                              "Reader lookup"};
+  char *unit_hdr[CTX_JSON_PARSE_RESULTS] = {
+      "[kB]", "[kB]", "[kB]", "[ms]", "[ms]", "[ms]", "[ms]"};
+  double results[1][CTX_JSON_PARSE_RESULTS] = {{0}};
+  struct ctx_json_parse_result result;
+
+  banner(uc, "CONTEXT JSON PARSE");
+
+  bf_status_t sts =
+      run_ctx_json_parse_test(path, PERF_CTX_JSON_ITERATIONS, &result);
+  if (sts != BF_SUCCESS || !result.status) {
+    aim_printf(&uc->pvs,
+               "%s:%d: Context JSON parse test failed (%s)\n",
+               __func__,
+               __LINE__,
+               bf_err_str(sts));
+    return UCLI_STATUS_E_ERROR;
+  }
+
+  results[0][size_hdr] = result.size_kb;
+  results[0][cjson_mem_hdr] = result.cjson_kb;
+  results[0][reader_mem_hdr] = result.reader_kb;
+  results[0][cjson_parse_hdr] = result.cjson_ms;
+  results[0][reader_parse_hdr] = result.reader_ms;
+  results[0][cjson_lookup_hdr] = result.cjson_lookup_ms;
+  results[0][reader_lookup_hdr] = result.reader_lookup_ms;
+
+  for (int i = 0; i < CTX_JSON_PARSE_RESULTS; i++) {
+    aim_printf(&uc->pvs, "%15s ", result_hdr[i]);
+  }
+  aim_printf(&uc->pvs, "\n");
+  for (int i = 0; i < CTX_JSON_PARSE_RESULTS; i++) {
+    aim_printf(&uc->pvs, "%15s ", unit_hdr[i]);
+  }
+  aim_printf(&uc->pvs, "\n");
+  aim_printf(&uc->pvs,
+             "%15.0f %15.0f %15.0f %15.2f %15.2f %15.2f %15.2f\n",
+             results[0][size_hdr],
+             results[0][cjson_mem_hdr],
+             results[0][reader_mem_hdr],
+             results[0][cjson_parse_hdr],
+             results[0][reader_parse_hdr],
+             results[0][cjson_lookup_hdr],
+             results[0][reader_lookup_hdr]);
+
+  save_results_file(uc,
+                    "perf_ctx_json_parse.csv",
+                    CTX_JSON_PARSE_RESULTS,
+                    1,
+                    result_hdr,
+                    unit_hdr,
+                    results);
+  return UCLI_STATUS_OK;
+}
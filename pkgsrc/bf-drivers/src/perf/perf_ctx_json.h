@@ -0,0 +1,103 @@
+/*******************************************************************************
+ *  Copyright (C) 2024 Intel Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing,
+ *  software distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions
+ *  and limitations under the License.
+ *
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+
+/*!
+ * @file perf_ctx_json.h
+ * @date
+ *
+ * Performance Context JSON loading common definitions.
+ */
+
+#ifndef _PERF_CTX_JSON_H
+#define _PERF_CTX_JSON_H
+
+#define PERF_CTX_JSON_ITERATIONS 5
+#define PERF_CTX_JSON_ITERATIONS_MAX 1000
+
+struct ctx_json_load_result {
+  bool status;
+  int size_kb;
+  int iterations;
+  double parse_ms;
+  double cached_ms;
+  double speedup;
+};
+
+/**
+ * @brief Run performance test that will measure the load time of a Context
+ * JSON file.  The file is loaded repeatedly with the binary cache disabled
+ * and then, once the cache has been written, from the cache.
+ *
+ * @param path path to the Context JSON file
+ * @param iterations number of loads measured for each method
+ * @param result pointer to struct with results
+ * @return bf_status_t
+ */
+bf_status_t run_ctx_json_load_test(const char *path,
+                                   int iterations,
+                                   struct ctx_json_load_result *result);
+
+/**
+ * @brief Run performance test that will measure the load time of a Context
+ * JSON file.
+ *
+ * @param uc ucli context pointer
+ * @param path path to the Context JSON file
+ * @return ucli_status_t
+ */
+ucli_status_t run_ctx_json_load(ucli_context_t *uc, const char *path);
+
+struct ctx_json_parse_result {
+  bool status;
+  int size_kb;
+  int cjson_kb;
+  int reader_kb;
+  double cjson_ms;
+  double reader_ms;
+  double cjson_lookup_ms;
+  double reader_lookup_ms;
+};
+
+/**
+ * @brief Run performance test that will compare cJSON and the Context JSON
+ * reader on a JSON file: the time to parse and release the tree, the heap
+ * memory taken by the tree and the time to look up every member of every
+ * object by key.
+ *
+ * @param path path to the JSON file
+ * @param iterations number of parses measured for each parser
+ * @param result pointer to struct with results
+ * @return bf_status_t
+ */
+bf_status_t run_ctx_json_parse_test(const char *path,
+                                    int iterations,
+                                    struct ctx_json_parse_result *result);
+
+/**
+ * @brief Run performance test that will compare cJSON and the Context JSON
+ * reader on a JSON file.
+ *
+ * @param uc ucli context pointer
+ * @param path path to the JSON file
+ * @return ucli_status_t
+ */
+ucli_status_t run_ctx_json_parse(ucli_context_t *uc, const char *path);
+
+#endif
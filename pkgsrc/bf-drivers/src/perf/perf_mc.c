@@ -0,0 +1,323 @@
+/*******************************************************************************
+ *  Copyright (C) 2024 Intel Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing,
+ *  software distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions
+ *  and limitations under the License.
+ *
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+
+#include <errno.h>
+#include <time.h>
+
+#include <target-utils/uCli/ucli.h>
+#include <dvm/bf_drv_intf.h>
+#include <lld/lld_dev.h>
+#include <pipe_mgr/pipe_mgr_drv.h>
+#include <mc_mgr/mc_mgr_intf.h>
+
+#include "perf_util.h"
+#include <perf/perf_common_intf.h>
+#include <perf/perf_mc_intf.h>
+#include "perf_mc.h"
+#include "perf_ucli.h"
+
+/* The two LAG member ports; every group replicates to both when the LAG is
+ * fully up and only to the first one while the second member is down. */
+#define PERF_MC_PORT_A 0
+#define PERF_MC_PORT_B 1
+
+/**
+ * @brief Swap the node of every group from one set of nodes to the other
+ * with one dissociate and one associate call per group.
+ */
+static bf_status_t swap_per_call(bf_mc_session_hdl_t shdl,
+                                 bf_dev_id_t dev_id,
+                                 int groups,
+                                 bf_mc_mgrp_hdl_t *mgrp,
+                                 bf_mc_node_hdl_t *from,
+                                 bf_mc_node_hdl_t *to) {
+  bf_status_t sts = BF_SUCCESS;
+  for (int i = 0; i < groups && sts == BF_SUCCESS; i++) {
+    sts = bf_mc_dissociate_node(shdl, dev_id, mgrp[i], from[i]);
+    if (sts == BF_SUCCESS) {
+      sts = bf_mc_associate_node(shdl, dev_id, mgrp[i], to[i], false, 0);
+    }
+  }
+  if (sts == BF_SUCCESS) sts = bf_mc_complete_operations(shdl);
+  return sts;
+}
+
+/**
+ * @brief Swap the node of every group from one set of nodes to the other
+ * with a single batch membership update.
+ */
+static bf_status_t swap_batch(bf_mc_session_hdl_t shdl,
+                              bf_dev_id_t dev_id,
+                              int groups,
+                              bf_mc_mgrp_hdl_t *mgrp,
+                              bf_mc_node_hdl_t *from,
+                              bf_mc_node_hdl_t *to,
+                              bf_mc_mbr_op_t *ops) {
+  for (int i = 0; i < groups; i++) {
+    ops[2 * i].op = BF_MC_MBR_OP_DISSOCIATE;
+    ops[2 * i].mgrp_hdl = mgrp[i];
+    ops[2 * i].node_hdl = from[i];
+    ops[2 * i].xid_valid = false;
+    ops[2 * i].xid = 0;
+    ops[2 * i + 1].op = BF_MC_MBR_OP_ASSOCIATE;
+    ops[2 * i + 1].mgrp_hdl = mgrp[i];
+    ops[2 * i + 1].node_hdl = to[i];
+    ops[2 * i + 1].xid_valid = false;
+    ops[2 * i + 1].xid = 0;
+  }
+  bf_status_t sts =
+      bf_mc_mbr_batch_update(shdl, dev_id, ops, 2 * groups, NULL);
+  if (sts == BF_SUCCESS) sts = bf_mc_complete_operations(shdl);
+  return sts;
+}
+
+/**
+ * @brief Run performance test that will measure the convergence time of a
+ * LAG member change across multicast groups.
+ *
+ * @param dev_id device id
+ * @param groups number of multicast groups
+ * @param result pointer to struct with results
+ * @return bf_status_t
+ */
+bf_status_t run_mc_lag_flap_test(bf_dev_id_t dev_id,
+                                 int groups,
+                                 struct mc_lag_flap_result *result) {
+  struct timespec start, stop;
+  uint64_t per_call_ns = 0, batch_ns = 0;
+
+  if (!result) {
+    LOG_ERROR("%s:%d: No allocated memory for results\n", __func__, __LINE__);
+    bf_sys_dbgchk(0);
+    return BF_UNEXPECTED;
+  }
+  memset(result, 0, sizeof(*result));
+  result->groups = groups;
+  result->ops = 2 * groups;
+
+  if (groups <= 0 || groups > PERF_MC_GROUPS_MAX) {
+    LOG_ERROR("%s:%d: Invalid number of groups %d\n", __func__, __LINE__, groups);
+    return BF_INVALID_ARG;
+  }
+
+  bf_mc_session_hdl_t shdl;
+  bf_status_t sts = bf_mc_create_session(&shdl);
+  if (sts != BF_SUCCESS) {
+    LOG_ERROR("%s:%d: Cannot create multicast session (%s)\n",
+              __func__,
+              __LINE__,
+              bf_err_str(sts));
+    return sts;
+  }
+
+  bf_mc_mgrp_hdl_t *mgrp = bf_sys_calloc(groups, sizeof *mgrp);
+  bf_mc_node_hdl_t *both = bf_sys_calloc(groups, sizeof *both);
+  bf_mc_node_hdl_t *one = bf_sys_calloc(groups, sizeof *one);
+  bf_mc_mbr_op_t *ops = bf_sys_calloc(2 * groups, sizeof *ops);
+  if (!mgrp || !both || !one || !ops) {
+    sts = BF_NO_SYS_RESOURCES;
+    goto cleanup;
+  }
+
+  bf_mc_port_map_t pm_both, pm_one;
+  bf_mc_lag_map_t lm;
+  BF_MC_PORT_MAP_INIT(pm_both);
+  BF_MC_PORT_MAP_INIT(pm_one);
+  BF_MC_LAG_MAP_INIT(lm);
+  BF_MC_PORT_MAP_SET(pm_both, PERF_MC_PORT_A);
+  BF_MC_PORT_MAP_SET(pm_both, PERF_MC_PORT_B);
+  BF_MC_PORT_MAP_SET(pm_one, PERF_MC_PORT_A);
+
+  /* Setup is not measured, batch it. */
+  bf_mc_begin_batch(shdl);
+  for (int i = 0; i < groups && sts == BF_SUCCESS; i++) {
+    sts = bf_mc_mgrp_create(shdl, dev_id, PERF_MC_MGID_BASE + i, &mgrp[i]);
+    if (sts == BF_SUCCESS) {
+      sts = bf_mc_node_create(shdl, dev_id, i, pm_both, lm, &both[i]);
+    }
+    if (sts == BF_SUCCESS) {
+      sts = bf_mc_node_create(shdl, dev_id, i, pm_one, lm, &one[i]);
+    }
+    if (sts == BF_SUCCESS) {
+      sts = bf_mc_associate_node(shdl, dev_id, mgrp[i], both[i], false, 0);
+    }
+  }
+  bf_mc_end_batch(shdl, true);
+  if (sts != BF_SUCCESS) {
+    LOG_ERROR("%s:%d: Cannot create %d multicast groups (%s)\n",
+              __func__,
+              __LINE__,
+              groups,
+              bf_err_str(sts));
+    goto cleanup;
+  }
+
+  /* Member down and back up, one call per group. */
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  sts = swap_per_call(shdl, dev_id, groups, mgrp, both, one);
+  if (sts == BF_SUCCESS) {
+    sts = swap_per_call(shdl, dev_id, groups, mgrp, one, both);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &stop);
+  if (sts != BF_SUCCESS) goto cleanup;
+  per_call_ns = time_delta_ns(start, stop);
+
+  /* Member down and back up, one batch each. */
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  sts = swap_batch(shdl, dev_id, groups, mgrp, both, one, ops);
+  if (sts == BF_SUCCESS) {
+    sts = swap_batch(shdl, dev_id, groups, mgrp, one, both, ops);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &stop);
+  if (sts != BF_SUCCESS) goto cleanup;
+  batch_ns = time_delta_ns(start, stop);
+
+  /* Report the time of a single member change. */
+  result->per_call_ms = per_call_ns / 2 / 1e6;
+  result->batch_ms = batch_ns / 2 / 1e6;
+  result->speedup = batch_ns ? (double)per_call_ns / batch_ns : 0;
+  result->status = true;
+
+cleanup:
+  if (mgrp && both && one) {
+    bf_mc_begin_batch(shdl);
+    for (int i = 0; i < groups; i++) {
+      if (mgrp[i]) bf_mc_mgrp_destroy(shdl, dev_id, mgrp[i]);
+      if (both[i]) bf_mc_node_destroy(shdl, dev_id, both[i]);
+      if (one[i]) bf_mc_node_destroy(shdl, dev_id, one[i]);
+    }
+    bf_mc_end_batch(shdl, true);
+  }
+  if (ops) bf_sys_free(ops);
+  if (one) bf_sys_free(one);
+  if (both) bf_sys_free(both);
+  if (mgrp) bf_sys_free(mgrp);
+  bf_mc_destroy_session(shdl);
+  return sts;
+}
+
+struct test_description mc_lag_flap_test = {
+    .test_name = "mc_lag_flap",
+    .description =
+        "The Multicast LAG Flap test measures how long a LAG member change\n"
+        "takes to converge across many multicast groups.\n"
+        "Every group replicates to both ports of a two member LAG through one\n"
+        "L1 node. The member going down replaces that node in every group\n"
+        "with a node holding only the remaining port; the member coming back\n"
+        "restores the original node.\n"
+        "The change is applied once with one dissociate and one associate\n"
+        "call per group and once with a single batch membership update, each\n"
+        "measured until the hardware writes complete.\n"
+        "The test uses the CLOCK_MONOTONIC POSIX clock for all measurements.\n"
+        "The reported test result values are the average time of a single\n"
+        "member change for both methods.\n",
+    .params = {{.name = "groups", .type = "int", .defaults = "4096"},
+               // last element
+               {.name = ""}},
+    .results = {{.header = "groups", .unit = "[-]", .type = "int"},
+                {.header = "ops", .unit = "[-]", .type = "int"},
+                {.header = "per_call", .unit = "[ms]", .type = "double"},
+                {.header = "batch", .unit = "[ms]", .type = "double"},
+                {.header = "speedup", .unit = "[-]", .type = "double"},
+                // last element
+                {.header = ""}}};
+
+/**
+ * @brief Run performance test that will measure the convergence time of a
+ * LAG member change across multicast groups.
+ *
+ * @param dev_id device id
+ * @param groups number of multicast groups
+ * @return test_results
+ */
+struct test_results mc_lag_flap(bf_dev_id_t dev_id, int groups) {
+  struct mc_lag_flap_result result;
+  struct test_results p_results;
+  memset(&result, 0, sizeof(result));
+  memset(&p_results, 0, sizeof(p_results));
+
+  run_mc_lag_flap_test(dev_id, groups, &result);
+
+  p_results.status = result.status;
+  p_results.res_int[RES_MC_GROUPS] = result.groups;
+  p_results.res_int[RES_MC_OPS] = result.ops;
+  p_results.res_double[RES_MC_PER_CALL_MS] = result.per_call_ms;
+  p_results.res_double[RES_MC_BATCH_MS] = result.batch_ms;
+  p_results.res_double[RES_MC_SPEEDUP] = result.speedup;
+
+  return p_results;
+}
+
+/**
+ * @brief Run performance test that will measure the convergence time of a
+ * LAG member change across multicast groups.
+ *
+ * @param uc ucli context pointer
+ * @param dev_id device id
+ * @return ucli_status_t
+ */
+ucli_status_t run_mc_lag_flap(ucli_context_t *uc, bf_dev_id_t dev_id) {
+  enum mc_hdr { groups_hdr, per_call_hdr, batch_hdr, speedup_hdr, MC_RESULTS };
+  char *result_hdr[MC_RESULTS] = {"Groups", "Per call", "Batch", "Speedup"};
+  char *unit_hdr[MC_RESULTS] = {"[-]", "[ms]", "[ms]", "[-]"};
+  double results[1][MC_RESULTS] = {{0}};
+  struct mc_lag_flap_result result;
+
+  banner(uc, "MULTICAST LAG FLAP");
+
+  bf_status_t sts = run_mc_lag_flap_test(dev_id, PERF_MC_GROUPS, &result);
+  if (sts != BF_SUCCESS || !result.status) {
+    aim_printf(&uc->pvs,
+               "%s:%d: Multicast LAG flap test failed (%s)\n",
+               __func__,
+               __LINE__,
+               bf_err_str(sts));
+    return UCLI_STATUS_E_ERROR;
+  }
+
+  results[0][groups_hdr] = result.groups;
+  results[0][per_call_hdr] = result.per_call_ms;
+  results[0][batch_hdr] = result.batch_ms;
+  results[0][speedup_hdr] = result.speedup;
+
+  for (int i = 0; i < MC_RESULTS; i++) {
+    aim_printf(&uc->pvs, "%15s ", result_hdr[i]);
+  }
+  aim_printf(&uc->pvs, "\n");
+  for (int i = 0; i < MC_RESULTS; i++) {
+    aim_printf(&uc->pvs, "%15s ", unit_hdr[i]);
+  }
+  aim_printf(&uc->pvs, "\n");
+  aim_printf(&uc->pvs,
+             "%15.0f %15.2f %15.2f %15.2f\n",
+             results[0][groups_hdr],
+             results[0][per_call_hdr],
+             results[0][batch_hdr],
+             results[0][speedup_hdr]);
+
+  save_results_file(uc,
+                    "perf_mc_lag_flap.csv",
+                    MC_RESULTS,
+                    1,
+                    result_hdr,
+                    unit_hdr,
+                    results);
+  return UCLI_STATUS_OK;
+}
@@ -0,0 +1,71 @@
+/*******************************************************************************
+ *  Copyright (C) 2024 Intel Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing,
+ *  software distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions
+ *  and limitations under the License.
+ *
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+
+/*!
+ * @file perf_mc.h
+ * @date
+ *
+ * Performance multicast handling common definitions.
+ */
+
+#ifndef _PERF_MC_H
+#define _PERF_MC_H
+
+#define PERF_MC_GROUPS 4096
+/* Groups are created from this id upwards so they do not collide with the
+ * low group ids typically used by applications. */
+#define PERF_MC_MGID_BASE 0x8000
+#define PERF_MC_GROUPS_MAX (BF_MGID_COUNT - PERF_MC_MGID_BASE)
+
+struct mc_lag_flap_result {
+  bool status;
+  int groups;
+  int ops;
+  double per_call_ms;
+  double batch_ms;
+  double speedup;
+};
+
+/**
+ * @brief Run performance test that will measure the convergence time of a
+ * LAG member change across multicast groups.  Every group holds one node
+ * with both member ports; the member going down replaces it with a node
+ * holding only the remaining port and the member coming back restores it.
+ *
+ * @param dev_id device id
+ * @param groups number of multicast groups
+ * @param result pointer to struct with results
+ * @return bf_status_t
+ */
+bf_status_t run_mc_lag_flap_test(bf_dev_id_t dev_id,
+                                 int groups,
+                                 struct mc_lag_flap_result *result);
+
+/**
+ * @brief Run performance test that will measure the convergence time of a
+ * LAG member change across multicast groups.
+ *
+ * @param uc ucli context pointer
+ * @param dev_id device id
+ * @return ucli_status_t
+ */
+ucli_status_t run_mc_lag_flap(ucli_context_t *uc, bf_dev_id_t dev_id);
+
+#endif
@@ -43,6 +43,10 @@
 #include "perf_mem.h"
 #include <perf/perf_int_intf.h>
 #include "perf_int.h"
+#include <perf/perf_mc_intf.h>
+#include "perf_mc.h"
+#include <perf/perf_ctx_json_intf.h>
+#include "perf_ctx_json.h"
 #include "perf_ucli.h"
 
 /**
@@ -216,6 +220,7 @@ static ucli_status_t perf_ucli__all__(ucli_context_t *uc) {
   run_sram_dma(uc, dev_id);
   run_tcam_dma(uc, dev_id);
   run_interrupts(uc, dev_id);
+  run_mc_lag_flap(uc, dev_id);
   return UCLI_STATUS_OK;
 }
 
@@ -359,6 +364,58 @@ static ucli_status_t perf_ucli__sram_dma__(ucli_context_t *uc) {
   return UCLI_STATUS_OK;
 }
 
+/**
+ * @brief Handler for multicast LAG flap perf testing command
+ *
+ * @param uc ucli context pointer
+ * @return ucli_status_t
+ */
+static ucli_status_t perf_ucli__mc_lag_flap__(ucli_context_t *uc) {
+  UCLI_COMMAND_INFO(
+      uc, "mc_lag_flap", 1, "test multicast LAG member change <dev_id>");
+  bf_dev_id_t dev_id;
+  char *endptr;
+  const char *str = uc->pargs->args[0];
+
+  errno = 0;
+  dev_id = strtol(str, &endptr, 10);
+  if (errno != 0 || endptr == str) {
+    aim_printf(&uc->pvs, "Incorrect device-id parameter format\n");
+    return UCLI_STATUS_E_PARAM;
+  }
+
+  run_mc_lag_flap(uc, dev_id);
+  return UCLI_STATUS_OK;
+}
+
+/**
+ * @brief Handler for Context JSON load perf testing command
+ *
+ * @param uc ucli context pointer
+ * @return ucli_status_t
+ */
+static ucli_status_t perf_ucli__ctx_json_load__(ucli_context_t *uc) {
+  UCLI_COMMAND_INFO(
+      uc, "ctx_json_load", 1, "test Context JSON load time <path>");
+
+  run_ctx_json_load(uc, uc->pargs->args[0]);
+  return UCLI_STATUS_OK;
+}
+
+/**
+ * @brief Handler for JSON parser perf testing command
+ *
+ * @param uc ucli context pointer
+ * @return ucli_status_t
+ */
+static ucli_status_t perf_ucli__ctx_json_parse__(ucli_context_t *uc) {
+  UCLI_COMMAND_INFO(
+      uc, "ctx_json_parse", 1, "compare cJSON and Context JSON reader <path>");
+
+  run_ctx_json_parse(uc, uc->pargs->args[0]);
+  return UCLI_STATUS_OK;
+}
+
 /**
  * @brief Array of handlers to ucli functions
  *
@@ -371,6 +428,9 @@ static ucli_command_handler_f perf_ucli_ucli_handlers__[] = {
     perf_ucli__interrupts__,
     perf_ucli__registers_direct__,
     perf_ucli__registers_indirect__,
+    perf_ucli__mc_lag_flap__,
+    perf_ucli__ctx_json_load__,
+    perf_ucli__ctx_json_parse__,
     NULL};
 
 /**
@@ -59,3 +59,6 @@ if __name__ == "__main__":
     perf.reg_indir.run(bus='MBUS')
     perf.reg_indir.run(bus='CBUS')
     perf.reg_indir.run(bus='HOSTIF')
+
+    # run mc_lag_flap test
+    perf.mc_lag_flap.run(groups=4096)
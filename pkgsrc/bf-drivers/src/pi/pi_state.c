@@ -29,6 +29,7 @@
 #include "pi_log.h"
 #include "pi_state.h"
 #include "ctx_json/ctx_json_utils.h"
+#include "ctx_json/ctx_json_cache.h"
 
 #include <inttypes.h>
 #include <stdio.h>
@@ -84,37 +85,6 @@ static void handles_map_destroy(handles_map_t *map) {
   bf_map_destroy(&map->rev_map);
 }
 
-static char *read_file(const char *path) {
-  char *source = NULL;
-  FILE *fp = fopen(path, "r");
-  if (fp != NULL) {
-    /* Go to the end of the file. */
-    if (fseek(fp, 0L, SEEK_END) == 0) {
-      /* Get the size of the file. */
-      long bufsize = ftell(fp);
-      if (bufsize == -1) { /* Error */
-      }
-
-      /* Allocate our buffer to that size. */
-      source = bf_sys_malloc(sizeof(char) * (bufsize + 1));
-
-      /* Go back to the start of the file. */
-      if (fseek(fp, 0L, SEEK_SET) != 0) { /* Error */
-      }
-
-      /* Read the entire file into memory. */
-      size_t newLen = fread(source, sizeof(char), bufsize, fp);
-      if (newLen == 0) {
-        fputs("Error reading file", stderr);
-      } else {
-        source[newLen++] = '\0'; /* Just to be safe. */
-      }
-    }
-    fclose(fp);
-  }
-  return source;
-}
-
 typedef struct {
   pipe_tbl_hdl_t handle;
   handles_map_t action_handles;
@@ -529,14 +499,15 @@ static int add_digests_from_json(pi_dev_id_t dev_id,
 int pi_state_assign_device(pi_dev_id_t dev_id,
                            const pi_p4info_t *p4info,
                            const char *context_json_path) {
-  char *json_data = read_file(context_json_path);
-  if (!json_data) {
+  /* Shares the binary cache written when pipe_mgr loaded the same file. */
+  ctx_json_file_t *json_file = ctx_json_file_load(context_json_path, true);
+  if (!json_file) {
     LOG_CRIT(
         "%s: context JSON path '%s' is not valid", __func__, context_json_path);
     return 1;
   }
 
-  cJSON *root = cJSON_Parse(json_data);
+  cJSON *root = ctx_json_file_root(json_file);
 
   int status = 0;
   cJSON *tables_cjson = NULL, *digests_cjson = NULL;
@@ -556,8 +527,7 @@ int pi_state_assign_device(pi_dev_id_t dev_id,
       dev_id);
   status |= add_digests_from_json(dev_id, p4info, digests_cjson);
 
-  cJSON_Delete(root);
-  bf_sys_free(json_data);
+  ctx_json_file_free(json_file);
 
   return status;
 }
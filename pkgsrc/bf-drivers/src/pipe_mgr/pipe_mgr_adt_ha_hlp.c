@@ -346,7 +346,9 @@ void pipe_mgr_adt_cleanup_hlp_ha_state(bf_dev_id_t device_id,
   unsigned tbl_idx = 0;
   for (tbl_idx = 0; tbl_idx < adt->num_tbls; tbl_idx++) {
     pipe_mgr_adt_data_t *adt_tbl_data = &adt->adt_tbl_data[tbl_idx];
-    if (adt_tbl_data->ha_hlp_info) {
+    pipe_mgr_adt_pipe_ha_hlp_info_t *ha_hlp_info = adt_tbl_data->ha_hlp_info;
+    if (ha_hlp_info) {
+      pipe_mgr_hitless_ha_delete_spec_map(&ha_hlp_info->spec_map);
       PIPE_MGR_FREE(adt_tbl_data->ha_hlp_info);
       adt_tbl_data->ha_hlp_info = NULL;
     }
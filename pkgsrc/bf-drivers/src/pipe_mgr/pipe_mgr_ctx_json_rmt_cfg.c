@@ -30,6 +30,8 @@
 #include "pipe_mgr_db.h"
 #include "pipe_mgr_rmt_cfg.h"
 #include <bfutils/dynamic_hash/bfn_hash_algorithm.h>
+#include <ctx_json/ctx_json_cache.h>
+#include <ctx_json/ctx_json_reader.h>
 
 #define PIPE_MGR_PARSE_CFG_NAME(cfg_name, out, out_max)                    \
   {                                                                        \
@@ -2748,7 +2750,7 @@ static pipe_status_t ctx_json_parse_driver_options(
   CHECK_ERR(err, rc, cleanup);
   options->hash_parity_enabled = hash_parity;
 
-  cJSON *prsr_multi_threading_val = cJSON_GetObjectItem(
+  cJSON *prsr_multi_threading_val = ctx_json_object_get(
       driver_options_cjson, CTX_JSON_DRIVER_OPTIONS_PRSR_MULTI_THREADING);
 
   if (prsr_multi_threading_val) {
@@ -6876,62 +6878,17 @@ rmt_dev_tbl_info_t *pipe_mgr_ctx_json_parse(rmt_dev_info_t *dev_info,
     goto table_info_alloc_err;
   }
 
-  /* Open context json file. */
-  FILE *file = fopen(config_file_path, "r");
+  /* Load the context json, reusing a cached parse of identical contents
+   * when one is available. */
+  ctx_json_file_t *file = ctx_json_file_load(config_file_path, true);
   if (file == NULL) {
-    LOG_ERROR("%s:%d: Could not open configuration file: %s.\n",
+    LOG_ERROR("%s:%d: Could not load configuration file: %s.",
               __func__,
               __LINE__,
               config_file_path);
-    goto config_file_fopen_err;
-  }
-
-  /* Get size of json file. */
-  int fd = fileno(file);
-  struct stat stat_b;
-  if (fstat(fd, &stat_b)) {
-    LOG_ERROR("%s:%d: Could not get config file information %s",
-              __func__,
-              __LINE__,
-              config_file_path);
-    goto config_file_buffer_alloc_err;
-  }
-  size_t to_allocate = stat_b.st_size + 1;
-
-  /* Allocate buffer to hold entire file. */
-  char *config_file_buffer = PIPE_MGR_CALLOC(1, to_allocate);
-  if (config_file_buffer == NULL) {
-    LOG_ERROR("%s:%d: Could not allocate memory for configuration file buffer.",
-              __func__,
-              __LINE__);
-    goto config_file_buffer_alloc_err;
-  }
-
-  /* Read file into buffer. */
-  size_t num_items = fread(config_file_buffer, stat_b.st_size, 1, file);
-  if (num_items != 1) {
-    if (ferror(file)) {
-      LOG_ERROR(
-          "%s:%d: An error occurred while reading configuration file buffer.",
-          __func__,
-          __LINE__);
-      goto config_file_fread_err;
-    }
-
-    PIPE_MGR_ASSERT(feof(file));
-    LOG_DBG("%s:%d: End of file reached before expected. Continuing.",
-            __func__,
-            __LINE__);
-  }
-
-  /* Create JSON parse object. */
-  cJSON *root = cJSON_Parse(config_file_buffer);
-  if (root == NULL) {
-    LOG_ERROR("%s:%d: cJSON error while parsing configuration file.",
-              __func__,
-              __LINE__);
-    goto cjson_parse_err;
+    goto config_file_load_err;
   }
+  cJSON *root = ctx_json_file_root(file);
 
   /* Validate the chip type in the context.json against the type of chip it is
    * being loaded against. */
@@ -7056,9 +7013,7 @@ rmt_dev_tbl_info_t *pipe_mgr_ctx_json_parse(rmt_dev_info_t *dev_info,
 
   LOG_TRACE("Successfully parsed table configuration file.");
 
-  fclose(file);
-  PIPE_MGR_FREE(config_file_buffer);
-  cJSON_Delete(root);
+  ctx_json_file_free(file);
   return g_table_info;
 
 parse_cc_err:
@@ -7069,13 +7024,8 @@ parse_hash_bits_err:
 ctx_json_parse_rmt_cfg_tables_err:
 version_parse_err:
 target_parse_err:
-  cJSON_Delete(root);
-cjson_parse_err:
-config_file_fread_err:
-  PIPE_MGR_FREE(config_file_buffer);
-config_file_buffer_alloc_err:
-  fclose(file);
-config_file_fopen_err:
+  ctx_json_file_free(file);
+config_file_load_err:
   PIPE_MGR_FREE(g_table_info);
 table_info_alloc_err:
   return NULL;
@@ -29,6 +29,7 @@
 /* Module header files */
 #include <sys/types.h>
 #include <sched.h>
+#include <time.h>
 #include <dvm/bf_drv_intf.h>
 #include <lld/bf_dma_if.h>
 #include <lld/lld_reg_if.h>
@@ -127,26 +128,238 @@ pipe_sess_hdl_t pipe_mgr_get_int_sess_hdl(void) {
   return pipe_mgr_ctx->int_ses_hndl;
 }
 
+static pipe_status_t service_subdev_dr(bf_dev_id_t dev_id,
+                                       bf_subdev_id_t subdev_id,
+                                       bf_dma_dr_id_t dr) {
+  /* LLD will ensure that it takes locks while pulling from the DR */
+  int ret = lld_dr_service(dev_id, subdev_id, dr, 10000);
+  if (ret < LLD_OK) {
+    LOG_ERROR("%s:%d Error %d pulling DRs from hw on dev %d subdev %d, dr %d",
+              __func__,
+              __LINE__,
+              ret,
+              dev_id,
+              subdev_id,
+              dr);
+    return PIPE_LLD_FAILED;
+  }
+  return PIPE_SUCCESS;
+}
+
 static pipe_status_t service_dr(bf_dev_id_t dev_id, bf_dma_dr_id_t dr) {
   bf_subdev_id_t subdev_id = 0;
   uint32_t num_subdevices = pipe_mgr_get_num_active_subdevices(dev_id);
   for (subdev_id = 0; subdev_id < (int)num_subdevices; subdev_id++) {
-    /* LLD will ensure that it takes locks while pulling from the DR */
-    int ret = lld_dr_service(dev_id, subdev_id, dr, 10000);
-    if (ret < LLD_OK) {
-      LOG_ERROR("%s:%d Error %d pulling DRs from hw on dev %d subdev %d, dr %d",
-                __func__,
-                __LINE__,
-                ret,
-                dev_id,
-                subdev_id,
-                dr);
-      return PIPE_LLD_FAILED;
+    pipe_status_t sts = service_subdev_dr(dev_id, subdev_id, dr);
+    if (sts != PIPE_SUCCESS) return sts;
+  }
+  return PIPE_SUCCESS;
+}
+
+static uint64_t drv_time_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+/* Decide which DRs of a tracked ring must be serviced.  The completion DR is
+ * only serviced while descriptors are pending and the Tx DR until it has been
+ * serviced once with nothing pending, after which all its descriptors are
+ * reclaimed.  Every sweep interval both are serviced regardless, this picks up
+ * descriptors pushed outside of the driver such as from the debug CLI. */
+static void ring_service_check(bf_dev_id_t dev_id,
+                               bf_subdev_id_t subdev_id,
+                               pipe_mgr_drv_ring_e r,
+                               bool *tx,
+                               bool *rx) {
+  struct pipe_mgr_drv_ctx_t *ctx = pipe_mgr_drv_ctx();
+  pipe_mgr_drv_ring_t *ring = &ctx->ring[dev_id][subdev_id][r];
+  bool want_tx = *tx;
+  bool sweep = false;
+
+  PIPE_MGR_LOCK(&ctx->drv_ctx_mtx);
+  if (ctx->poll_cfg.sweep_us) {
+    uint64_t now = drv_time_us();
+    if (now - ring->last_sweep_us >= ctx->poll_cfg.sweep_us) {
+      ring->last_sweep_us = now;
+      sweep = true;
+    }
+  } else {
+    sweep = true;
+  }
+  *tx = want_tx && (sweep || ring->tx_dirty);
+  *rx = *rx && (sweep || ring->pending);
+  if (*tx && !ring->pending) ring->tx_dirty = false;
+  if (*tx || *rx) {
+    ++ring->polls;
+    ring->occupancy_sum += ring->pending;
+  } else {
+    ++ring->skips;
+  }
+  PIPE_MGR_UNLOCK(&ctx->drv_ctx_mtx);
+}
+
+/* Service the Tx and completion DRs of a tracked ring on all subdevices,
+ * skipping the ones without outstanding work. */
+static pipe_status_t service_ring(bf_dev_id_t dev_id,
+                                  pipe_mgr_drv_ring_e r,
+                                  bf_dma_dr_id_t tx_dr,
+                                  bf_dma_dr_id_t rx_dr,
+                                  bool tx,
+                                  bool rx) {
+  pipe_status_t sts = PIPE_SUCCESS;
+  bf_subdev_id_t subdev_id = 0;
+  uint32_t num_subdevices = pipe_mgr_get_num_active_subdevices(dev_id);
+  for (subdev_id = 0; subdev_id < (int)num_subdevices; subdev_id++) {
+    bool do_tx = tx, do_rx = rx;
+    ring_service_check(dev_id, subdev_id, r, &do_tx, &do_rx);
+    if (do_tx) {
+      sts = service_subdev_dr(dev_id, subdev_id, tx_dr);
+      if (sts != PIPE_SUCCESS) return sts;
+    }
+    if (do_rx) {
+      sts = service_subdev_dr(dev_id, subdev_id, rx_dr);
+      if (sts != PIPE_SUCCESS) return sts;
     }
   }
   return PIPE_SUCCESS;
 }
 
+/* Account for n descriptors pushed on a tracked ring.  Since another thread
+ * may start the DR and process their completions as soon as they are in it,
+ * call this before the push and ring_pending_unpush if the push fails. */
+static void ring_pending_add(bf_dev_id_t dev,
+                             bf_subdev_id_t subdev,
+                             pipe_mgr_drv_ring_e r,
+                             int n) {
+  struct pipe_mgr_drv_ctx_t *ctx = pipe_mgr_drv_ctx();
+  pipe_mgr_drv_ring_t *ring = &ctx->ring[dev][subdev][r];
+  PIPE_MGR_LOCK(&ctx->drv_ctx_mtx);
+  if (!ring->pending) ring->busy_start_us = drv_time_us();
+  ring->pending += n;
+  ring->pushed += n;
+  ring->tx_dirty = true;
+  if (ring->pending > ring->occupancy_max) {
+    ring->occupancy_max = ring->pending;
+  }
+  PIPE_MGR_UNLOCK(&ctx->drv_ctx_mtx);
+  PIPE_MGR_DBGCHK(ring->pending > 0);
+}
+static void ring_pending_inc(bf_dev_id_t dev,
+                             bf_subdev_id_t subdev,
+                             pipe_mgr_drv_ring_e r) {
+  ring_pending_add(dev, subdev, r, 1);
+}
+
+/* Take back n descriptors accounted for by ring_pending_add which the DR did
+ * not accept.  They never complete, so this is not counted as a completion. */
+static void ring_pending_unpush(bf_dev_id_t dev,
+                                bf_subdev_id_t subdev,
+                                pipe_mgr_drv_ring_e r,
+                                int n) {
+  struct pipe_mgr_drv_ctx_t *ctx = pipe_mgr_drv_ctx();
+  pipe_mgr_drv_ring_t *ring = &ctx->ring[dev][subdev][r];
+  PIPE_MGR_LOCK(&ctx->drv_ctx_mtx);
+  ring->pending -= n;
+  ring->pushed -= n;
+  PIPE_MGR_UNLOCK(&ctx->drv_ctx_mtx);
+  PIPE_MGR_DBGCHK(ring->pending >= 0);
+}
+
+/* Account for a completion received on a tracked ring. */
+static void ring_pending_dec(bf_dev_id_t dev,
+                             bf_subdev_id_t subdev,
+                             pipe_mgr_drv_ring_e r) {
+  struct pipe_mgr_drv_ctx_t *ctx = pipe_mgr_drv_ctx();
+  pipe_mgr_drv_ring_t *ring = &ctx->ring[dev][subdev][r];
+  PIPE_MGR_LOCK(&ctx->drv_ctx_mtx);
+  --ring->pending;
+  ++ring->completed;
+  ++ctx->ring_cmplt_cnt;
+  if (!ring->pending) {
+    uint64_t busy_us = drv_time_us() - ring->busy_start_us;
+    ++ring->busy_cnt;
+    ring->busy_total_us += busy_us;
+    if (busy_us > ring->busy_max_us) ring->busy_max_us = busy_us;
+  }
+  PIPE_MGR_UNLOCK(&ctx->drv_ctx_mtx);
+  PIPE_MGR_DBGCHK(ring->pending >= 0);
+}
+
+/* State of a caller waiting for completions, see drv_poll_backoff. */
+typedef struct drv_poll_state_t {
+  uint64_t cmplt_cnt;
+  uint32_t idle_polls;
+} drv_poll_state_t;
+
+/* Called by a waiter after each poll of the completion DRs.  While
+ * completions keep arriving the waiter busy-polls, once spin_cnt polls found
+ * nothing it sleeps between polls, doubling the sleep up to sleep_max_us. */
+static void drv_poll_backoff(drv_poll_state_t *p) {
+  struct pipe_mgr_drv_ctx_t *ctx = pipe_mgr_drv_ctx();
+  uint64_t cmplt_cnt;
+  uint32_t spin_cnt, sleep_max_us, sleep_us, shift;
+
+  PIPE_MGR_LOCK(&ctx->drv_ctx_mtx);
+  cmplt_cnt = ctx->ring_cmplt_cnt;
+  spin_cnt = ctx->poll_cfg.spin_cnt;
+  sleep_max_us = ctx->poll_cfg.sleep_max_us;
+  PIPE_MGR_UNLOCK(&ctx->drv_ctx_mtx);
+
+  if (cmplt_cnt != p->cmplt_cnt) {
+    p->cmplt_cnt = cmplt_cnt;
+    p->idle_polls = 0;
+    return;
+  }
+  if (++p->idle_polls <= spin_cnt || !sleep_max_us) return;
+
+  shift = p->idle_polls - spin_cnt - 1;
+  sleep_us = shift < 31 ? 1u << shift : sleep_max_us;
+  if (sleep_us > sleep_max_us) sleep_us = sleep_max_us;
+  bf_sys_usleep(sleep_us);
+}
+
+void pipe_mgr_drv_poll_cfg_set(const pipe_mgr_drv_poll_cfg_t *cfg) {
+  PIPE_MGR_LOCK(&pipe_mgr_drv_ctx()->drv_ctx_mtx);
+  pipe_mgr_drv_ctx()->poll_cfg = *cfg;
+  PIPE_MGR_UNLOCK(&pipe_mgr_drv_ctx()->drv_ctx_mtx);
+}
+
+void pipe_mgr_drv_poll_cfg_get(pipe_mgr_drv_poll_cfg_t *cfg) {
+  PIPE_MGR_LOCK(&pipe_mgr_drv_ctx()->drv_ctx_mtx);
+  *cfg = pipe_mgr_drv_ctx()->poll_cfg;
+  PIPE_MGR_UNLOCK(&pipe_mgr_drv_ctx()->drv_ctx_mtx);
+}
+
+void pipe_mgr_drv_ring_stats_get(bf_dev_id_t dev_id,
+                                 bf_subdev_id_t subdev_id,
+                                 pipe_mgr_drv_ring_e ring,
+                                 pipe_mgr_drv_ring_t *stats) {
+  PIPE_MGR_LOCK(&pipe_mgr_drv_ctx()->drv_ctx_mtx);
+  *stats = pipe_mgr_drv_ctx()->ring[dev_id][subdev_id][ring];
+  PIPE_MGR_UNLOCK(&pipe_mgr_drv_ctx()->drv_ctx_mtx);
+}
+
+void pipe_mgr_drv_ring_stats_clear(bf_dev_id_t dev_id) {
+  unsigned i, j;
+  PIPE_MGR_LOCK(&pipe_mgr_drv_ctx()->drv_ctx_mtx);
+  for (i = 0; i < BF_MAX_SUBDEV_COUNT; ++i) {
+    for (j = 0; j < PIPE_MGR_DRV_RING_CNT; ++j) {
+      pipe_mgr_drv_ring_t *ring = &pipe_mgr_drv_ctx()->ring[dev_id][i][j];
+      ring->pushed = 0;
+      ring->completed = 0;
+      ring->polls = 0;
+      ring->skips = 0;
+      ring->occupancy_sum = 0;
+      ring->occupancy_max = ring->pending;
+      ring->busy_cnt = 0;
+      ring->busy_total_us = 0;
+      ring->busy_max_us = 0;
+    }
+  }
+  PIPE_MGR_UNLOCK(&pipe_mgr_drv_ctx()->drv_ctx_mtx);
+}
+
 static pipe_status_t push_dr(bf_dev_id_t dev_id, bf_dma_dr_id_t dr) {
   int ret;
   bf_subdev_id_t subdev_id = 0;
@@ -227,20 +440,16 @@ pipe_status_t pipe_mgr_drv_service_ilist_drs(bf_dev_id_t dev_id) {
       return PIPE_INVALID_ARG;
   }
 
+  PIPE_MGR_DBGCHK(tx_end - lld_dr_tx_pipe_inst_list_0 ==
+                  rx_end - lld_dr_cmp_pipe_inst_list_0);
   for (dr = lld_dr_tx_pipe_inst_list_0; dr <= tx_end; dr++) {
-    ret = service_dr(dev_id, dr);
-    if (ret != PIPE_SUCCESS) {
-      LOG_ERROR("%s:%d Error 0x%x pulling ilist DRs from hw on dev %d dr %d",
-                __func__,
-                __LINE__,
-                ret,
-                dev_id,
-                dr);
-      return PIPE_COMM_FAIL;
-    }
-  }
-  for (dr = lld_dr_cmp_pipe_inst_list_0; dr <= rx_end; dr++) {
-    ret = service_dr(dev_id, dr);
+    int i = dr - lld_dr_tx_pipe_inst_list_0;
+    ret = service_ring(dev_id,
+                       PIPE_MGR_DRV_RING_IL_0 + i,
+                       dr,
+                       lld_dr_cmp_pipe_inst_list_0 + i,
+                       true,
+                       true);
     if (ret != PIPE_SUCCESS) {
       LOG_ERROR("%s:%d Error 0x%x pulling ilist DRs from hw on dev %d dr %d",
                 __func__,
@@ -452,29 +661,19 @@ pipe_status_t pipe_mgr_drv_push_idle_time_drs(bf_dev_id_t dev_id) {
 
 pipe_status_t pipe_mgr_drv_service_read_blk_drs(bf_dev_id_t dev_id) {
   pipe_status_t ret = PIPE_SUCCESS;
-  bf_dma_dr_id_t dr = BF_DMA_NO_DR;
-
-  dr = lld_dr_tx_pipe_read_block;
-  ret = service_dr(dev_id, dr);
-  if (ret != PIPE_SUCCESS) {
-    LOG_ERROR("%s:%d Error 0x%x pulling read_blk DRs from hw on dev %d dr %d",
-              __func__,
-              __LINE__,
-              ret,
-              dev_id,
-              dr);
-    return PIPE_COMM_FAIL;
-  }
 
-  dr = lld_dr_cmp_pipe_read_blk;
-  ret = service_dr(dev_id, dr);
+  ret = service_ring(dev_id,
+                     PIPE_MGR_DRV_RING_RD_BLK,
+                     lld_dr_tx_pipe_read_block,
+                     lld_dr_cmp_pipe_read_blk,
+                     true,
+                     true);
   if (ret != PIPE_SUCCESS) {
-    LOG_ERROR("%s:%d Error 0x%x pulling read_blk DRs from hw on dev %d dr %d",
+    LOG_ERROR("%s:%d Error 0x%x pulling read_blk DRs from hw on dev %d",
               __func__,
               __LINE__,
               ret,
-              dev_id,
-              dr);
+              dev_id);
     return PIPE_COMM_FAIL;
   }
   return PIPE_SUCCESS;
@@ -502,36 +701,20 @@ pipe_status_t pipe_mgr_drv_service_write_blk_drs(bf_dev_id_t dev_id,
                                                  bool tx,
                                                  bool rx) {
   pipe_status_t ret = PIPE_SUCCESS;
-  bf_dma_dr_id_t dr = BF_DMA_NO_DR;
 
-  if (tx) {
-    dr = lld_dr_tx_pipe_write_block;
-    ret = service_dr(dev_id, dr);
-    if (ret != PIPE_SUCCESS) {
-      LOG_ERROR(
-          "%s:%d Error 0x%x pulling write_blk DRs from hw on dev %d dr %d",
-          __func__,
-          __LINE__,
-          ret,
-          dev_id,
-          dr);
-      return PIPE_COMM_FAIL;
-    }
-  }
-
-  if (rx) {
-    dr = lld_dr_cmp_pipe_write_blk;
-    ret = service_dr(dev_id, dr);
-    if (ret != PIPE_SUCCESS) {
-      LOG_ERROR(
-          "%s:%d Error 0x%x pulling write_blk DRs from hw on dev %d dr %d",
-          __func__,
-          __LINE__,
-          ret,
-          dev_id,
-          dr);
-      return PIPE_COMM_FAIL;
-    }
+  ret = service_ring(dev_id,
+                     PIPE_MGR_DRV_RING_WR_BLK,
+                     lld_dr_tx_pipe_write_block,
+                     lld_dr_cmp_pipe_write_blk,
+                     tx,
+                     rx);
+  if (ret != PIPE_SUCCESS) {
+    LOG_ERROR("%s:%d Error 0x%x pulling write_blk DRs from hw on dev %d",
+              __func__,
+              __LINE__,
+              ret,
+              dev_id);
+    return PIPE_COMM_FAIL;
   }
 
   return PIPE_SUCCESS;
@@ -571,18 +754,19 @@ void pipe_mgr_drv_service_drs(bf_dev_id_t dev_id) {
 static void ilist_pending_dec(bf_dev_id_t dev,
                               bf_subdev_id_t subdev,
                               uint8_t dr) {
-  PIPE_MGR_LOCK(&pipe_mgr_drv_ctx()->drv_ctx_mtx);
-  --pipe_mgr_drv_ctx()->ilist_pending_cnt[dev][subdev][dr];
-  PIPE_MGR_UNLOCK(&pipe_mgr_drv_ctx()->drv_ctx_mtx);
-  PIPE_MGR_DBGCHK(pipe_mgr_drv_ctx()->ilist_pending_cnt[dev][subdev][dr] >= 0);
+  ring_pending_dec(dev, subdev, PIPE_MGR_DRV_RING_IL_0 + dr);
 }
-static void ilist_pending_inc(bf_dev_id_t dev,
+static void ilist_pending_add(bf_dev_id_t dev,
                               bf_subdev_id_t subdev,
-                              uint8_t dr) {
-  PIPE_MGR_LOCK(&pipe_mgr_drv_ctx()->drv_ctx_mtx);
-  ++pipe_mgr_drv_ctx()->ilist_pending_cnt[dev][subdev][dr];
-  PIPE_MGR_UNLOCK(&pipe_mgr_drv_ctx()->drv_ctx_mtx);
-  PIPE_MGR_DBGCHK(pipe_mgr_drv_ctx()->ilist_pending_cnt[dev][subdev][dr] > 0);
+                              uint8_t dr,
+                              int n) {
+  ring_pending_add(dev, subdev, PIPE_MGR_DRV_RING_IL_0 + dr, n);
+}
+static void ilist_pending_unpush(bf_dev_id_t dev,
+                                 bf_subdev_id_t subdev,
+                                 uint8_t dr,
+                                 int n) {
+  ring_pending_unpush(dev, subdev, PIPE_MGR_DRV_RING_IL_0 + dr, n);
 }
 static bool ilist_pending_full(bf_dev_id_t dev) {
   /* Return true if any of the ilist Tx counts are greater than the size of
@@ -592,25 +776,25 @@ static bool ilist_pending_full(bf_dev_id_t dev) {
    * serviced. */
   bool x = false;
   PIPE_MGR_LOCK(&pipe_mgr_drv_ctx()->drv_ctx_mtx);
-  x = pipe_mgr_drv_ctx()->ilist_pending_cnt[dev][0][0] >
+  x = pipe_mgr_drv_ctx()->ring[dev][0][0].pending >
           pipe_mgr_drv_ctx()->ilist_dr_size[dev][0][0] ||
-      pipe_mgr_drv_ctx()->ilist_pending_cnt[dev][0][1] >
+      pipe_mgr_drv_ctx()->ring[dev][0][1].pending >
           pipe_mgr_drv_ctx()->ilist_dr_size[dev][0][1] ||
-      pipe_mgr_drv_ctx()->ilist_pending_cnt[dev][0][2] >
+      pipe_mgr_drv_ctx()->ring[dev][0][2].pending >
           pipe_mgr_drv_ctx()->ilist_dr_size[dev][0][2] ||
-      pipe_mgr_drv_ctx()->ilist_pending_cnt[dev][0][3] >
+      pipe_mgr_drv_ctx()->ring[dev][0][3].pending >
           pipe_mgr_drv_ctx()->ilist_dr_size[dev][0][3];
 
   uint32_t num_subdevices = pipe_mgr_get_num_active_subdevices(dev);
   if (num_subdevices > 1) {
     x = x ||
-        pipe_mgr_drv_ctx()->ilist_pending_cnt[dev][1][0] >
+        pipe_mgr_drv_ctx()->ring[dev][1][0].pending >
             pipe_mgr_drv_ctx()->ilist_dr_size[dev][1][0] ||
-        pipe_mgr_drv_ctx()->ilist_pending_cnt[dev][1][1] >
+        pipe_mgr_drv_ctx()->ring[dev][1][1].pending >
             pipe_mgr_drv_ctx()->ilist_dr_size[dev][1][1] ||
-        pipe_mgr_drv_ctx()->ilist_pending_cnt[dev][1][2] >
+        pipe_mgr_drv_ctx()->ring[dev][1][2].pending >
             pipe_mgr_drv_ctx()->ilist_dr_size[dev][1][2] ||
-        pipe_mgr_drv_ctx()->ilist_pending_cnt[dev][1][3] >
+        pipe_mgr_drv_ctx()->ring[dev][1][3].pending >
             pipe_mgr_drv_ctx()->ilist_dr_size[dev][1][3];
   }
   PIPE_MGR_UNLOCK(&pipe_mgr_drv_ctx()->drv_ctx_mtx);
@@ -891,6 +1075,10 @@ pipe_status_t pipe_mgr_drv_init() {
     }
   }
   PIPE_MGR_LOCK_INIT(pipe_mgr_drv_ctx()->drv_ctx_mtx);
+  pipe_mgr_drv_ctx()->poll_cfg.spin_cnt = PIPE_MGR_DRV_POLL_SPIN_CNT_DEF;
+  pipe_mgr_drv_ctx()->poll_cfg.sleep_max_us =
+      PIPE_MGR_DRV_POLL_SLEEP_MAX_US_DEF;
+  pipe_mgr_drv_ctx()->poll_cfg.sweep_us = PIPE_MGR_DRV_POLL_SWEEP_US_DEF;
   for (i = 0; i < PIPE_MGR_MAX_SESSIONS; ++i) {
     pipe_mgr_drv_ctx()->sesStates[i].sid = i;
   }
@@ -1131,7 +1319,8 @@ pipe_status_t pipe_mgr_drv_get_dr_size(bf_dev_id_t dev_id) {
         return PIPE_INVALID_ARG;
       }
       pipe_mgr_drv_ctx()->ilist_dr_size[dev_id][subdev_id][i] = x;
-      pipe_mgr_drv_ctx()->ilist_pending_cnt[dev_id][subdev_id][i] = 0;
+      pipe_mgr_drv_ctx()->ring[dev_id][subdev_id][PIPE_MGR_DRV_RING_IL_0 + i]
+          .pending = 0;
     }
   }
 
@@ -1384,9 +1573,9 @@ pipe_status_t pipe_mgr_drv_device_cleanup(bf_dev_id_t dev_id) {
   PIPE_MGR_MEMSET(&pipe_mgr_drv_ctx()->ilist_dr_size[dev_id],
                   0,
                   sizeof pipe_mgr_drv_ctx()->ilist_dr_size[dev_id]);
-  PIPE_MGR_MEMSET(&pipe_mgr_drv_ctx()->ilist_pending_cnt[dev_id],
+  PIPE_MGR_MEMSET(&pipe_mgr_drv_ctx()->ring[dev_id],
                   0,
-                  sizeof pipe_mgr_drv_ctx()->ilist_pending_cnt[dev_id]);
+                  sizeof pipe_mgr_drv_ctx()->ring[dev_id]);
 
   pipe_mgr_drv_ctx()->valid[dev_id] = false;
 
@@ -1894,6 +2083,7 @@ pipe_status_t pipe_mgr_drv_blk_rd(pipe_sess_hdl_t *sess,
 
     b->buf_pushed = true;
     ++st->cntrs.rdBlkReq;
+    ring_pending_inc(dev_id, 0, PIPE_MGR_DRV_RING_RD_BLK);
     PIPE_MGR_UNLOCK(&st->mtx_ses);
   }
 
@@ -1903,10 +2093,64 @@ pipe_status_t pipe_mgr_drv_blk_rd(pipe_sess_hdl_t *sess,
   return PIPE_SUCCESS;
 }
 
+/* Push the write block descriptors wbs[0..n) to the write block DR of a
+ * subdevice, in bursts which are halved while the DR has no room for them.
+ * When not even one descriptor fits the session lock is released while the DR
+ * drains and *unlocked is set.  The op of wbs[i], ops[idx[i]], is marked
+ * pushed and dropped from ops[] once it needs no other subdevice since its
+ * completion may free it from then on.  Called with the session lock held,
+ * returns the LLD status and the number of descriptors pushed in *pushed. */
+static int wr_blk_push_burst(pipe_mgr_drv_ses_state_t *st,
+                             bf_dev_id_t dev_id,
+                             bf_subdev_id_t subdev_id,
+                             const lld_wb_desc_t *wbs,
+                             const int *idx,
+                             int n,
+                             pipe_mgr_drv_wr_blk_op_t **ops,
+                             bool service,
+                             int *pushed,
+                             bool *unlocked) {
+  int ret = LLD_OK;
+  int burst = n;
+  int done = 0;
+
+  while (done < n) {
+    if (burst > n - done) burst = n - done;
+    ring_pending_add(dev_id, subdev_id, PIPE_MGR_DRV_RING_WR_BLK, burst);
+    ret = lld_subdev_push_wb_burst(dev_id, subdev_id, &wbs[done], burst);
+    if (ret) {
+      ring_pending_unpush(dev_id, subdev_id, PIPE_MGR_DRV_RING_WR_BLK, burst);
+    }
+    if (ret == LLD_ERR_DR_FULL) {
+      if (burst > 1) {
+        burst /= 2;
+        continue;
+      }
+      PIPE_MGR_UNLOCK(&st->mtx_ses);
+      push_write_blk_drs(dev_id);
+      if (service) pipe_mgr_drv_service_write_blk_drs(dev_id, true, true);
+      PIPE_MGR_LOCK(&st->mtx_ses);
+      *unlocked = true;
+      burst = n - done;
+      continue;
+    }
+    if (ret) break;
+    for (int i = done; i < done + burst; i++) {
+      pipe_mgr_drv_wr_blk_op_t *op = ops[idx[i]];
+      if (!(op->buf->pipeMask >> ((subdev_id + 1) * 4))) {
+        op->buf->buf_pushed = true;
+        ops[idx[i]] = NULL;
+      }
+    }
+    done += burst;
+  }
+  *pushed = done;
+  return ret;
+}
+
 pipe_status_t pipe_mgr_push_wr_blks_to_dr(pipe_sess_hdl_t *sess,
                                           bf_dev_id_t dev_id) {
   int ret = 0;
-  bf_dma_addr_t dma_addr;
   pipe_mgr_drv_buf_t *buf;
   pipe_mgr_drv_wr_blk_op_t *op;
   pipe_mgr_drv_ses_state_t *st =
@@ -1914,6 +2158,11 @@ pipe_status_t pipe_mgr_push_wr_blks_to_dr(pipe_sess_hdl_t *sess,
   if (NULL == st) {
     return PIPE_INVALID_ARG;
   }
+#ifdef PIPE_MGR_INLINE_DR_SERVICE
+  bool service = true;
+#else
+  bool service = false;
+#endif
 
   uint32_t num_subdevices = pipe_mgr_get_num_active_subdevices(dev_id);
 
@@ -1921,53 +2170,81 @@ pipe_status_t pipe_mgr_push_wr_blks_to_dr(pipe_sess_hdl_t *sess,
    * block states stored in the session. */
   PIPE_MGR_LOCK(&st->mtx_ses);
 
-  /* Search the list of pending operations for one matching this
-   * msgId. */
-  for (op = st->wrBlk; (op); op = op->next) {
-    buf = op->buf;
-    if (!buf) {
-      continue;
-    }
-    if (buf->buf_pushed) {
-      continue;
-    }
-    if (buf->devId != dev_id) {
-      continue;
-    }
-    /* Map the virtual address of the buffer to the DMA address before pushing
-       it to the DR */
-    if (bf_sys_dma_map(op->buf->pool,
-                       op->buf->addr,
-                       op->buf->phys_addr,
-                       op->buf->size,
-                       &dma_addr,
-                       BF_DMA_FROM_CPU) != 0) {
-      LOG_ERROR("Unable to map DMA buffer %p at %s:%d",
-                op->buf->addr,
-                __func__,
-                __LINE__);
-      return PIPE_COMM_FAIL;
+  /* Walk the list of pending operations, mapping a batch of the unpushed ones
+   * and pushing it to each subdevice in as few DR updates as possible. */
+  op = st->wrBlk;
+  while (op) {
+    pipe_mgr_drv_wr_blk_op_t *ops[LLD_DR_PUSH_BURST_MAX];
+    bf_dma_addr_t dma_addrs[LLD_DR_PUSH_BURST_MAX];
+    bool sent[LLD_DR_PUSH_BURST_MAX];
+    lld_wb_desc_t wbs[LLD_DR_PUSH_BURST_MAX];
+    int idx[LLD_DR_PUSH_BURST_MAX];
+    int n = 0, cnt = 0, pushed = 0, i;
+    bool unlocked = false;
+
+    for (; op && n < LLD_DR_PUSH_BURST_MAX; op = op->next) {
+      buf = op->buf;
+      if (!buf) {
+        continue;
+      }
+      if (buf->buf_pushed) {
+        continue;
+      }
+      if (buf->devId != dev_id) {
+        continue;
+      }
+      /* Map the virtual address of the buffer to the DMA address before
+         pushing it to the DR */
+      if (bf_sys_dma_map(buf->pool,
+                         buf->addr,
+                         buf->phys_addr,
+                         buf->size,
+                         &dma_addrs[n],
+                         BF_DMA_FROM_CPU) != 0) {
+        LOG_ERROR("Unable to map DMA buffer %p at %s:%d",
+                  buf->addr,
+                  __func__,
+                  __LINE__);
+        for (i = 0; i < n; i++) {
+          buf = ops[i]->buf;
+          bf_sys_dma_unmap(buf->pool, buf->addr, buf->size, BF_DMA_FROM_CPU);
+        }
+        PIPE_MGR_UNLOCK(&st->mtx_ses);
+        return PIPE_COMM_FAIL;
+      }
+      sent[n] = false;
+      ops[n++] = op;
     }
+
     bf_subdev_id_t subdev_id = 0;
     for (subdev_id = 0; subdev_id < (int)num_subdevices; subdev_id++) {
-      int phy_pipe_mask = (buf->pipeMask >> (subdev_id * 4)) & 0xF;
-      if (phy_pipe_mask == 0) continue;
-      while ((ret = lld_subdev_push_wb_mcast(buf->devId,
-                                             subdev_id,
-                                             op->entry_sz,
-                                             op->addr_step,
-                                             op->data_sz,
-                                             op->single_data,
-                                             dma_addr,
-                                             op->addr,
-                                             phy_pipe_mask,
-                                             op->msgId)) == LLD_ERR_DR_FULL) {
-        PIPE_MGR_UNLOCK(&st->mtx_ses);
-        push_write_blk_drs(dev_id);
-#ifdef PIPE_MGR_INLINE_DR_SERVICE
-        pipe_mgr_drv_service_write_blk_drs(dev_id, true, true);
-#endif
-        PIPE_MGR_LOCK(&st->mtx_ses);
+      for (cnt = 0, i = 0; i < n; i++) {
+        if (!ops[i]) continue;
+        int phy_pipe_mask = (ops[i]->buf->pipeMask >> (subdev_id * 4)) & 0xF;
+        if (phy_pipe_mask == 0) continue;
+        wbs[cnt].entry_sz = ops[i]->entry_sz;
+        wbs[cnt].addr_inc = ops[i]->addr_step;
+        wbs[cnt].data_sz = ops[i]->data_sz;
+        wbs[cnt].single_entry = ops[i]->single_data;
+        wbs[cnt].source = dma_addrs[i];
+        wbs[cnt].dest = ops[i]->addr;
+        wbs[cnt].msg_id = ops[i]->msgId;
+        wbs[cnt].mcast_vector = phy_pipe_mask;
+        idx[cnt++] = i;
+      }
+      if (!cnt) continue;
+      ret = wr_blk_push_burst(st,
+                              dev_id,
+                              subdev_id,
+                              wbs,
+                              idx,
+                              cnt,
+                              ops,
+                              service,
+                              &pushed,
+                              &unlocked);
+      for (i = 0; i < pushed; i++) {
+        sent[idx[i]] = true;
       }
       if (ret) {
         break;
@@ -1975,33 +2252,44 @@ pipe_status_t pipe_mgr_push_wr_blks_to_dr(pipe_sess_hdl_t *sess,
     }
 
     if (ret) {
-      /* Unmap the buffer */
-      if (bf_sys_dma_unmap(
-              op->buf->pool, op->buf->addr, op->buf->size, BF_DMA_FROM_CPU) !=
-          0) {
-        LOG_ERROR("Unable to unmap DMA buffer %p at %s:%d",
-                  op->buf->addr,
-                  __func__,
-                  __LINE__);
+      const lld_wb_desc_t *wb = &wbs[pushed];
+      /* Unmap the buffers which were not pushed to any subdevice */
+      for (i = 0; i < n; i++) {
+        if (!ops[i] || sent[i]) continue;
+        buf = ops[i]->buf;
+        if (bf_sys_dma_unmap(
+                buf->pool, buf->addr, buf->size, BF_DMA_FROM_CPU) != 0) {
+          LOG_ERROR("Unable to unmap DMA buffer %p at %s:%d",
+                    buf->addr,
+                    __func__,
+                    __LINE__);
+        }
       }
       LOG_ERROR(
           "%s Push write block fails (%d) dev %d width %d step %d size %d "
           "single %d src 0x%" PRIx64 " dst 0x%" PRIx64 " vec %x id 0x%" PRIx64,
           __func__,
           ret,
-          buf->devId,
-          op->entry_sz,
-          op->addr_step,
-          op->data_sz,
-          op->single_data,
-          dma_addr,
-          op->addr,
-          buf->pipeMask,
-          op->msgId);
+          dev_id,
+          wb->entry_sz,
+          wb->addr_inc,
+          wb->data_sz,
+          wb->single_entry,
+          wb->source,
+          wb->dest,
+          ops[idx[pushed]]->buf->pipeMask,
+          wb->msg_id);
       PIPE_MGR_UNLOCK(&st->mtx_ses);
       return PIPE_COMM_FAIL;
     }
-    op->buf->buf_pushed = true;
+    /* Ops still held target no active subdevice, nothing is in flight for
+     * them. */
+    for (i = 0; i < n; i++) {
+      if (ops[i]) ops[i]->buf->buf_pushed = true;
+    }
+    /* Ops after the batch may have completed and been freed while the lock
+     * was released, walk the list again from its head. */
+    if (unlocked) op = st->wrBlk;
   }
   PIPE_MGR_UNLOCK(&st->mtx_ses);
 
@@ -2088,28 +2376,35 @@ static pipe_status_t blk_wr_int(pipe_sess_hdl_t *sess,
       PIPE_MGR_UNLOCK(&st->mtx_ses);
       return PIPE_COMM_FAIL;
     }
+    /* wrBlk only joins the session's list below, the helper may drop this
+     * reference to it once it is pushed. */
+    pipe_mgr_drv_wr_blk_op_t *op = wrBlk;
+    lld_wb_desc_t wb = {entry_sz,
+                        addr_step,
+                        entryCount,
+                        single_data,
+                        dma_addr,
+                        addr,
+                        buf->msgId,
+                        0};
+    int idx = 0, pushed = 0;
+    bool unlocked = false;
     bf_subdev_id_t subdev_id = 0;
     uint32_t num_subdevices = pipe_mgr_get_num_active_subdevices(buf->devId);
     for (subdev_id = 0; subdev_id < (int)num_subdevices; subdev_id++) {
       int s_phy_pipe_mask = (buf->pipeMask >> (subdev_id * 4)) & 0xF;
       if (s_phy_pipe_mask == 0) continue;
-      while ((ret = lld_subdev_push_wb_mcast(buf->devId,
-                                             subdev_id,
-                                             entry_sz,
-                                             addr_step,
-                                             entryCount,
-                                             single_data,
-                                             dma_addr,
-                                             addr,
-                                             s_phy_pipe_mask,
-                                             buf->msgId)) == LLD_ERR_DR_FULL) {
-        // LOG_TRACE("Write list DR on dev %d full while pushing "
-        //          "at %s:%d", buf->devId, __func__, __LINE__);
-        PIPE_MGR_UNLOCK(&st->mtx_ses);
-        push_write_blk_drs(buf->devId);
-        pipe_mgr_drv_service_write_blk_drs(buf->devId, true, true);
-        PIPE_MGR_LOCK(&st->mtx_ses);
-      }
+      wb.mcast_vector = s_phy_pipe_mask;
+      ret = wr_blk_push_burst(st,
+                              buf->devId,
+                              subdev_id,
+                              &wb,
+                              &idx,
+                              1,
+                              &op,
+                              true,
+                              &pushed,
+                              &unlocked);
       if (ret) {
         break;
       }
@@ -3116,6 +3411,86 @@ pipe_status_t pipe_mgr_drv_ilist_rd_add(pipe_sess_hdl_t *sess,
   b->used += len;
   return PIPE_SUCCESS;
 }
+/* Unmap the command and response regions of read instruction list buffers
+ * which could not be pushed. */
+static void ilist_rd_unmap(pipe_mgr_drv_buf_t **bufs,
+                           int n,
+                           uint32_t rsp_offset) {
+  for (int i = 0; i < n; i++) {
+    pipe_mgr_drv_buf_t *b = bufs[i];
+    if (bf_sys_dma_unmap(b->pool, b->addr, rsp_offset, BF_DMA_FROM_CPU) != 0) {
+      LOG_ERROR("Unable to unmap DMA buffer %p at %s:%d",
+                b->addr,
+                __func__,
+                __LINE__);
+    }
+    if (bf_sys_dma_unmap(b->pool,
+                         b->addr + rsp_offset,
+                         b->size - rsp_offset,
+                         BF_DMA_TO_CPU) != 0) {
+      LOG_ERROR("Unable to unmap DMA buffer %p at %s:%d",
+                b->addr + rsp_offset,
+                __func__,
+                __LINE__);
+    }
+  }
+}
+
+/* Push the instruction list descriptors ils[0..n) to instruction list DR
+ * which_dr of a subdevice, in bursts which are halved while the DR has no room
+ * for them.  The buffer of ils[i], bufs[idx[i]], is marked pushed to the DR
+ * and dropped from bufs[] once it needs no other DR since its completion may
+ * free it whenever the session lock is released to drain the DR.  Called with
+ * the session lock held, returns the LLD status and the number of descriptors
+ * pushed in *pushed. */
+static int ilist_push_burst(pipe_mgr_drv_ses_state_t *st,
+                            rmt_dev_info_t *dev_info,
+                            bf_subdev_id_t subdev_id,
+                            int which_dr,
+                            const lld_ilist_desc_t *ils,
+                            const int *idx,
+                            int n,
+                            pipe_mgr_drv_buf_t **bufs,
+                            int *pushed) {
+  bf_dev_id_t dev_id = dev_info->dev_id;
+  int ret = LLD_OK;
+  int burst = n;
+  int done = 0;
+
+  while (done < n) {
+    if (burst > n - done) burst = n - done;
+    ilist_pending_add(dev_id, subdev_id, which_dr, burst);
+    ret = lld_subdev_push_ilist_burst(
+        dev_id, subdev_id, which_dr, &ils[done], burst);
+    if (ret) ilist_pending_unpush(dev_id, subdev_id, which_dr, burst);
+    if (ret == LLD_ERR_DR_FULL) {
+      if (burst > 1) {
+        burst /= 2;
+        continue;
+      }
+      push_ilist_drs(dev_info);
+      PIPE_MGR_UNLOCK(&st->mtx_ses);
+      service_ilist_drs(dev_id);
+      PIPE_MGR_LOCK(&st->mtx_ses);
+      burst = n - done;
+      continue;
+    }
+    if (ret) break;
+    for (int i = done; i < done + burst; i++) {
+      pipe_mgr_drv_buf_t *b = bufs[idx[i]];
+      b->buf_pushed |= (1 << which_dr);
+      /* Multicast descriptors reach all their pipes at once, on Tofino each
+       * pipe has its own DR. */
+      if (ils[i].mcast_vector || !(b->pipeMask & ~b->buf_pushed)) {
+        bufs[idx[i]] = NULL;
+      }
+    }
+    done += burst;
+  }
+  *pushed = done;
+  return ret;
+}
+
 pipe_status_t pipe_mgr_drv_ilist_rd_push(pipe_sess_hdl_t *sess,
                                          pipe_mgr_drv_rd_ilist_cb cb_func,
                                          void *usrData) {
@@ -3155,14 +3530,25 @@ pipe_status_t pipe_mgr_drv_ilist_rd_push(pipe_sess_hdl_t *sess,
       return (PIPE_INVALID_ARG);
     }
 
+    /* Tofino will use a DR per physical pipe, later chips will use the
+     * first DR but set the target pipe as the mcast destination. */
+    bool use_mcast = dev_info->dev_family != BF_DEV_FAMILY_TOFINO;
     for (j = 0; j < dev_info->dev_cfg.num_pipelines; ++j) {
-      pipe_mgr_drv_buf_t *b;
-      for (b = il->bufs[j]; b; b = b->next) {
-        if (!b->buf_pushed) {
+      bf_subdev_id_t subdev_id = j / 4;
+      int which_dr = use_mcast ? 0 : j % 4;
+      pipe_mgr_drv_buf_t *b = il->bufs[j];
+      /* The buffers of a pipeline share a DR, push them in batches. */
+      while (b) {
+        pipe_mgr_drv_buf_t *bufs[LLD_DR_PUSH_BURST_MAX];
+        lld_ilist_desc_t ils[LLD_DR_PUSH_BURST_MAX];
+        int idx[LLD_DR_PUSH_BURST_MAX];
+        int n = 0, pushed = 0, k, ret;
+
+        for (; b && n < LLD_DR_PUSH_BURST_MAX; b = b->next) {
+          if (b->buf_pushed) continue;
           b->msgId =
               pipe_mgr_drv_next_msgId(st, il->dev_id, i_list_rd_msgid_type);
 
-          int ret;
           /* Map the virtual address of the buffer to the DMA address */
           if (bf_sys_dma_map(b->pool,
                              b->addr,
@@ -3174,6 +3560,7 @@ pipe_status_t pipe_mgr_drv_ilist_rd_push(pipe_sess_hdl_t *sess,
                       b->addr,
                       __func__,
                       __LINE__);
+            ilist_rd_unmap(bufs, n, rsp_offset);
             PIPE_MGR_UNLOCK(&st->mtx_ses);
             return PIPE_COMM_FAIL;
           }
@@ -3187,96 +3574,46 @@ pipe_status_t pipe_mgr_drv_ilist_rd_push(pipe_sess_hdl_t *sess,
                       b->addr + rsp_offset,
                       __func__,
                       __LINE__);
+            bf_sys_dma_unmap(b->pool, b->addr, rsp_offset, BF_DMA_FROM_CPU);
+            ilist_rd_unmap(bufs, n, rsp_offset);
             PIPE_MGR_UNLOCK(&st->mtx_ses);
             return PIPE_COMM_FAIL;
           }
-
-          /* Tofino will use a DR per physical pipe, later chips will use the
-           * first DR but set the target pipe as the mcast destination. */
-          bool use_mcast = dev_info->dev_family != BF_DEV_FAMILY_TOFINO;
-          int which_dr = 0;
-          bf_subdev_id_t subdev_id = 0;
-          if (use_mcast) {
-            subdev_id = j / 4;
-            int phy_pipe_mask = (b->pipeMask >> (subdev_id * 4)) & 0xF;
-            while ((ret = lld_subdev_push_ilist_mcast(il->dev_id,
-                                                      subdev_id,
-                                                      which_dr,
-                                                      dma_addr_1,
-                                                      b->used,
-                                                      16,
-                                                      false,
-                                                      phy_pipe_mask,
-                                                      dma_addr_2,
-                                                      b->msgId)) ==
-                   LLD_ERR_DR_FULL) {
-              push_ilist_drs(dev_info);
-              PIPE_MGR_UNLOCK(&st->mtx_ses);
-              service_ilist_drs(il->dev_id);
-              PIPE_MGR_LOCK(&st->mtx_ses);
-            }
-            if (ret) {
-              break;
-            } else {
-              ilist_pending_inc(il->dev_id, subdev_id, which_dr);
-              b->buf_pushed |= (1 << which_dr);
-            }
-          } else {
-            which_dr = j % 4;
-            subdev_id = j / 4;
-            while ((ret = lld_subdev_push_ilist(il->dev_id,
-                                                subdev_id,
-                                                which_dr,
-                                                dma_addr_1,
-                                                b->used,
-                                                16,
-                                                false,
-                                                dma_addr_2,
-                                                b->msgId)) == LLD_ERR_DR_FULL) {
-              push_ilist_drs(dev_info);
-              PIPE_MGR_UNLOCK(&st->mtx_ses);
-              service_ilist_drs(il->dev_id);
-              PIPE_MGR_LOCK(&st->mtx_ses);
-            }
-            if (!ret) {
-              ilist_pending_inc(il->dev_id, subdev_id, which_dr);
-              b->buf_pushed |= (1 << which_dr);
-            }
-          }
-
-          if (ret) {
-            if (bf_sys_dma_unmap(
-                    b->pool, b->addr, rsp_offset, BF_DMA_FROM_CPU) != 0) {
-              LOG_ERROR("Unable to unmap DMA buffer %p at %s:%d",
-                        b->addr,
-                        __func__,
-                        __LINE__);
-            }
-            if (bf_sys_dma_unmap(b->pool,
-                                 b->addr + rsp_offset,
-                                 b->size - rsp_offset,
-                                 BF_DMA_TO_CPU) != 0) {
-              LOG_ERROR("Unable to unmap DMA buffer %p at %s:%d",
-                        b->addr + rsp_offset,
-                        __func__,
-                        __LINE__);
-            }
-            LOG_ERROR("%s Push ilist fails %d dev %d fifo %d src 0x%" PRIx64
-                      " size %d rsp size %d s/f %d rsp 0x%" PRIx64
-                      " id 0x%" PRIx64,
-                      __func__,
-                      ret,
-                      il->dev_id,
-                      which_dr,
-                      dma_addr_1,
-                      b->used,
-                      16,
-                      false,
-                      dma_addr_2,
-                      b->msgId);
-            PIPE_MGR_UNLOCK(&st->mtx_ses);
-            return PIPE_COMM_FAIL;
-          }
+          ils[n].list = dma_addr_1;
+          ils[n].list_len = b->used;
+          ils[n].rsp_sz = 16;
+          ils[n].s_f = false;
+          ils[n].ack_ptr = dma_addr_2;
+          ils[n].msg_id = b->msgId;
+          ils[n].mcast_vector =
+              use_mcast ? (b->pipeMask >> (subdev_id * 4)) & 0xF : 0;
+          bufs[n] = b;
+          idx[n] = n;
+          n++;
+        }
+        if (!n) break;
+
+        ret = ilist_push_burst(
+            st, dev_info, subdev_id, which_dr, ils, idx, n, bufs, &pushed);
+        if (ret) {
+          const lld_ilist_desc_t *d = &ils[pushed];
+          for (k = pushed; k < n; k++) bufs[k - pushed] = bufs[k];
+          ilist_rd_unmap(bufs, n - pushed, rsp_offset);
+          LOG_ERROR("%s Push ilist fails %d dev %d fifo %d src 0x%" PRIx64
+                    " size %d rsp size %d s/f %d rsp 0x%" PRIx64
+                    " id 0x%" PRIx64,
+                    __func__,
+                    ret,
+                    il->dev_id,
+                    which_dr,
+                    d->list,
+                    d->list_len,
+                    d->rsp_sz,
+                    d->s_f,
+                    d->ack_ptr,
+                    d->msg_id);
+          PIPE_MGR_UNLOCK(&st->mtx_ses);
+          return PIPE_COMM_FAIL;
         }
       }
     }
@@ -3295,7 +3632,11 @@ pipe_status_t pipe_mgr_drv_ilist_rd_push(pipe_sess_hdl_t *sess,
   for (i = 0; i < PIPE_MGR_NUM_DEVICES; ++i) {
     rmt_dev_info_t *d_info = pipe_mgr_get_dev_info(i);
     if (!d_info) continue;
-    while (ilist_pending_full(i)) service_ilist_drs(i);
+    drv_poll_state_t poll = {0, 0};
+    while (ilist_pending_full(i)) {
+      service_ilist_drs(i);
+      drv_poll_backoff(&poll);
+    }
   }
 
   return PIPE_SUCCESS;
@@ -3329,10 +3670,9 @@ static inline bf_dev_pipe_t phy_pipe_to_first_log_pipe(rmt_dev_info_t *dev_info,
   return first_log_pipe;
 }
 
-static inline pipe_status_t ilist_push(pipe_mgr_drv_ses_state_t *st,
-                                       rmt_dev_info_t *dev_info,
-                                       bf_subdev_id_t subdev_id,
-                                       pipe_mgr_drv_buf_t *b) {
+static void ilist_push_log(rmt_dev_info_t *dev_info,
+                           bf_subdev_id_t subdev_id,
+                           pipe_mgr_drv_buf_t *b) {
   bf_dev_id_t dev_id = dev_info->dev_id;
 
   /* Decode and log the instruction list if needed. */
@@ -3374,112 +3714,135 @@ static inline pipe_status_t ilist_push(pipe_mgr_drv_ses_state_t *st,
       msg_log_sz *= 2;
     } while (msg_log_sts == PIPE_NO_SYS_RESOURCES);
   }
+}
 
-  /* Map the virtual address of the buffer to the DMA address */
-  bf_dma_addr_t dma_addr;
-  if (bf_sys_dma_map(b->pool,
-                     b->addr,
-                     b->phys_addr,
-                     b->size,
-                     &dma_addr,
-                     BF_DMA_FROM_CPU) != 0) {
-    LOG_ERROR(
-        "Unable to map DMA buffer %p at %s:%d", b->addr, __func__, __LINE__);
-    return PIPE_COMM_FAIL;
-  }
-
+/* Push the chain of instruction list buffers starting at b to a subdevice.
+ * The buffers are mapped and pushed in batches, all the buffers of a batch
+ * going to a DR with as few DR updates as possible. */
+static pipe_status_t ilist_push(pipe_mgr_drv_ses_state_t *st,
+                                rmt_dev_info_t *dev_info,
+                                bf_subdev_id_t subdev_id,
+                                pipe_mgr_drv_buf_t *b) {
+  bf_dev_id_t dev_id = dev_info->dev_id;
   /* Tofino does not support multicast instruction lists. */
   bool use_mcast = dev_info->dev_family != BF_DEV_FAMILY_TOFINO;
-  int which_dr = 0;
-  int ret = 0;
-  if (use_mcast) {
-#if 0
-      LOG_ERROR(
-        "Pushing instruction list buffer "
-        "(Session %u msgId 0x%" PRIx64 ", dev %d, subdev %d, pipemask 0x%x, pushed %d)",
-        st->sid,
-        b->msgId,
-        dev_id,
-        subdev_id, b->pipeMask, b->buf_pushed);
-#endif
-    int phy_pipe_mask = b->pipeMask;
-    if (phy_pipe_mask != 0) {
-      while ((ret = lld_subdev_push_ilist_mcast(dev_id,
-                                                subdev_id,
-                                                which_dr,
-                                                dma_addr,
-                                                b->used,
-                                                0,
-                                                false,
-                                                phy_pipe_mask,
-                                                0,
-                                                b->msgId)) == LLD_ERR_DR_FULL) {
-        push_ilist_drs(dev_info);
-        PIPE_MGR_UNLOCK(&st->mtx_ses);
-        service_ilist_drs(dev_id);
-        PIPE_MGR_LOCK(&st->mtx_ses);
+
+  while (b) {
+    pipe_mgr_drv_buf_t *bufs[LLD_DR_PUSH_BURST_MAX];
+    bf_dma_addr_t dma_addrs[LLD_DR_PUSH_BURST_MAX];
+    uint8_t was_pushed[LLD_DR_PUSH_BURST_MAX];
+    lld_ilist_desc_t ils[LLD_DR_PUSH_BURST_MAX];
+    int idx[LLD_DR_PUSH_BURST_MAX];
+    int n = 0, cnt = 0, pushed = 0, which_dr = 0, i;
+    int ret = 0;
+
+    /* Once mapped, b is left on the first buffer of the next batch.  It is
+     * not pushed yet so it is not freed while the session lock is released
+     * to drain a DR. */
+    for (; b && n < LLD_DR_PUSH_BURST_MAX; b = b->next) {
+      if (!b->buf_pushed) {
+        b->msgId = pipe_mgr_drv_next_msgId(st, dev_id, i_list_msgid_type);
       }
-      if (ret) {
-        goto push_error;
+      ilist_push_log(dev_info, subdev_id, b);
+
+      /* Map the virtual address of the buffer to the DMA address */
+      if (bf_sys_dma_map(b->pool,
+                         b->addr,
+                         b->phys_addr,
+                         b->size,
+                         &dma_addrs[n],
+                         BF_DMA_FROM_CPU) != 0) {
+        LOG_ERROR("Unable to map DMA buffer %p at %s:%d",
+                  b->addr,
+                  __func__,
+                  __LINE__);
+        for (i = 0; i < n; i++) {
+          bf_sys_dma_unmap(
+              bufs[i]->pool, bufs[i]->addr, bufs[i]->size, BF_DMA_FROM_CPU);
+        }
+        return PIPE_COMM_FAIL;
       }
-      ilist_pending_inc(dev_id, subdev_id, which_dr);
-      b->buf_pushed |= (1 << which_dr);
+      was_pushed[n] = b->buf_pushed;
+      bufs[n++] = b;
     }
-  } else {
-    for (int phy_pipe = 0; phy_pipe < 4; phy_pipe++) {
-      /* If the buffer does not go to this physical pipe continue. */
-      if (!(b->pipeMask & (1 << phy_pipe))) continue;
-      /* If the buffer is already pushed to the physical pipe continue. */
-      if (b->buf_pushed & (1 << phy_pipe)) continue;
-      /* Select the DR based on the physical pipe. */
-      which_dr = phy_pipe;
 
-      while ((ret = lld_subdev_push_ilist(dev_id,
-                                          subdev_id,
-                                          which_dr,
-                                          dma_addr,
-                                          b->used,
-                                          0,
-                                          false,
-                                          0,
-                                          b->msgId)) == LLD_ERR_DR_FULL) {
-        push_ilist_drs(dev_info);
-        PIPE_MGR_UNLOCK(&st->mtx_ses);
-        service_ilist_drs(dev_id);
-        PIPE_MGR_LOCK(&st->mtx_ses);
+    if (use_mcast) {
+      for (i = 0; i < n; i++) {
+        if (bufs[i]->pipeMask == 0) continue;
+        ils[cnt].list = dma_addrs[i];
+        ils[cnt].list_len = bufs[i]->used;
+        ils[cnt].rsp_sz = 0;
+        ils[cnt].s_f = false;
+        ils[cnt].ack_ptr = 0;
+        ils[cnt].msg_id = bufs[i]->msgId;
+        ils[cnt].mcast_vector = bufs[i]->pipeMask;
+        idx[cnt++] = i;
       }
-
-      if (ret) {
-        goto push_error;
+      if (cnt) {
+        ret = ilist_push_burst(
+            st, dev_info, subdev_id, which_dr, ils, idx, cnt, bufs, &pushed);
       }
+    } else {
+      /* Select the DR based on the physical pipe. */
+      for (which_dr = 0; which_dr < 4; which_dr++) {
+        for (cnt = 0, i = 0; i < n; i++) {
+          if (!bufs[i]) continue;
+          /* If the buffer does not go to this physical pipe continue. */
+          if (!(bufs[i]->pipeMask & (1 << which_dr))) continue;
+          /* If the buffer is already pushed to the physical pipe continue. */
+          if (bufs[i]->buf_pushed & (1 << which_dr)) continue;
+          ils[cnt].list = dma_addrs[i];
+          ils[cnt].list_len = bufs[i]->used;
+          ils[cnt].rsp_sz = 0;
+          ils[cnt].s_f = false;
+          ils[cnt].ack_ptr = 0;
+          ils[cnt].msg_id = bufs[i]->msgId;
+          ils[cnt].mcast_vector = 0;
+          idx[cnt++] = i;
+        }
+        if (!cnt) continue;
+        ret = ilist_push_burst(
+            st, dev_info, subdev_id, which_dr, ils, idx, cnt, bufs, &pushed);
+        if (ret) break;
+      }
+    }
 
-      ilist_pending_inc(dev_id, subdev_id, phy_pipe);
-
-      b->buf_pushed |= (1 << phy_pipe);
+    if (ret) {
+      const lld_ilist_desc_t *d = &ils[pushed];
+      pipe_mgr_drv_buf_t *fb = bufs[idx[pushed]];
+      /* Unmap the failed buffer and those of the batch never pushed. */
+      for (i = 0; i < n; i++) {
+        if (!bufs[i]) continue;
+        if (i != idx[pushed] && bufs[i]->buf_pushed != was_pushed[i]) continue;
+        if (bf_sys_dma_unmap(bufs[i]->pool,
+                             bufs[i]->addr,
+                             bufs[i]->size,
+                             BF_DMA_FROM_CPU) != 0) {
+          LOG_ERROR("Unable to unmap DMA buffer %p at %s:%d",
+                    bufs[i]->addr,
+                    __func__,
+                    __LINE__);
+        }
+      }
+      LOG_ERROR(
+          "%s Push ilist fails %d dev %d subdev %d, mc %d msk %x fifo %d "
+          "src 0x%" PRIx64 " size %d s/f %d id 0x%" PRIx64,
+          __func__,
+          ret,
+          dev_id,
+          subdev_id,
+          use_mcast,
+          fb->pipeMask,
+          which_dr,
+          d->list,
+          d->list_len,
+          d->s_f,
+          d->msg_id);
+      return PIPE_COMM_FAIL;
     }
+    st->cntrs.iListPushBuf += n;
   }
   return PIPE_SUCCESS;
-
-push_error:
-  if (bf_sys_dma_unmap(b->pool, b->addr, b->size, BF_DMA_FROM_CPU) != 0) {
-    LOG_ERROR(
-        "Unable to unmap DMA buffer %p at %s:%d", b->addr, __func__, __LINE__);
-  }
-  LOG_ERROR(
-      "%s Push ilist fails %d dev %d subdev %d, mc %d msk %x fifo %d "
-      "src 0x%" PRIx64 " size %d s/f %d id 0x%" PRIx64,
-      __func__,
-      ret,
-      dev_id,
-      subdev_id,
-      use_mcast,
-      b->pipeMask,
-      which_dr,
-      dma_addr,
-      b->used,
-      false,
-      b->msgId);
-  return PIPE_COMM_FAIL;
 }
 
 /*
@@ -3514,19 +3877,11 @@ static pipe_status_t pipe_mgr_drv_ilist_push_int(pipe_mgr_drv_ses_state_t *st,
 
     num_subdevices = pipe_mgr_get_num_active_subdevices(i);
     for (subdev_id = 0; subdev_id < (int)num_subdevices; subdev_id++) {
-      pipe_mgr_drv_buf_t *b;
-      for (b = il->bufs[i][subdev_id]; b; b = b->next) {
-        if (!b->buf_pushed) {
-          b->msgId = pipe_mgr_drv_next_msgId(st, i, i_list_msgid_type);
-        }
-
-        pipe_status_t sts = ilist_push(st, dev_info, subdev_id, b);
-        if (sts != PIPE_SUCCESS) {
-          PIPE_MGR_UNLOCK(&st->mtx_ses);
-          return sts;
-        }
-
-        ++st->cntrs.iListPushBuf;
+      pipe_status_t sts =
+          ilist_push(st, dev_info, subdev_id, il->bufs[i][subdev_id]);
+      if (sts != PIPE_SUCCESS) {
+        PIPE_MGR_UNLOCK(&st->mtx_ses);
+        return sts;
       }
       /* If any buffers were pushed to the device start the DMA. */
       if (il->bufs[i][subdev_id]) {
@@ -3548,7 +3903,11 @@ static pipe_status_t pipe_mgr_drv_ilist_push_int(pipe_mgr_drv_ses_state_t *st,
   for (i = 0; i < PIPE_MGR_NUM_DEVICES; ++i) {
     rmt_dev_info_t *d_info = pipe_mgr_get_dev_info(i);
     if (!d_info) continue;
-    while (ilist_pending_full(i)) service_ilist_drs(i);
+    drv_poll_state_t poll = {0, 0};
+    while (ilist_pending_full(i)) {
+      service_ilist_drs(i);
+      drv_poll_backoff(&poll);
+    }
   }
 
   // LOG_TRACE("Exiting %s", __func__);
@@ -3987,8 +4346,11 @@ void pipe_mgr_drv_completion_cb(bf_dev_id_t logical_device,
   //
   if (lld_dr_cmp_pipe_read_blk == fifo) {
     rd_blk_cmplt(st, msgId, 0 != status);
+    /* Accounted after the session lock held while pushing was released. */
+    ring_pending_dec(dev_id, subdev_id, PIPE_MGR_DRV_RING_RD_BLK);
   } else if (lld_dr_cmp_pipe_write_blk == fifo) {
     wr_blk_cmplt(st, msgId, dev_id, subdev_id);
+    ring_pending_dec(dev_id, subdev_id, PIPE_MGR_DRV_RING_WR_BLK);
   } else if ((lld_dr_cmp_pipe_inst_list_0 == fifo ||
               lld_dr_cmp_pipe_inst_list_1 == fifo ||
               lld_dr_cmp_pipe_inst_list_2 == fifo ||
@@ -4099,6 +4461,7 @@ static void rd_blk_cmplt(pipe_mgr_drv_ses_state_t *st,
 pipe_status_t pipe_mgr_drv_rd_blk_cmplt_all(pipe_sess_hdl_t sess,
                                             bf_dev_id_t dev_id) {
   pipe_mgr_drv_rd_blk_op_t *op = NULL;
+  drv_poll_state_t poll = {0, 0};
   pipe_mgr_drv_ses_state_t *st =
       pipe_mgr_drv_get_ses_state(&sess, __func__, __LINE__);
   if (NULL == st) {
@@ -4129,6 +4492,7 @@ pipe_status_t pipe_mgr_drv_rd_blk_cmplt_all(pipe_sess_hdl_t sess,
        * completed. */
       PIPE_MGR_UNLOCK(&st->mtx_ses);
       pipe_mgr_drv_service_read_blk_drs(dev_id);
+      drv_poll_backoff(&poll);
     } else {
       /* No pending operations for this device, just unlock the session
        * and return. */
@@ -4323,6 +4687,7 @@ pipe_status_t pipe_mgr_drv_ilist_rd_cmplt_all(pipe_sess_hdl_t *sess) {
     return PIPE_INVALID_ARG;
   }
 
+  drv_poll_state_t poll = {0, 0};
   while (st->iListRd) {
     unsigned i;
     for (i = 0; i < PIPE_MGR_NUM_DEVICES; ++i) {
@@ -4330,6 +4695,7 @@ pipe_status_t pipe_mgr_drv_ilist_rd_cmplt_all(pipe_sess_hdl_t *sess) {
       if (!d_info) continue;
       service_ilist_drs(i);
     }
+    drv_poll_backoff(&poll);
   }
   return PIPE_SUCCESS;
 }
@@ -4347,6 +4713,7 @@ pipe_status_t pipe_mgr_drv_i_list_cmplt_all(pipe_sess_hdl_t *sess) {
   }
   pipe_mgr_drv_list_op_t *il;
   int ret;
+  drv_poll_state_t poll = {0, 0};
   while (st->iList) {
     /* Take a per-session mutex to ensure exclusive access to the list of
      * Instruction List states stored in the session. */
@@ -4404,6 +4771,7 @@ pipe_status_t pipe_mgr_drv_i_list_cmplt_all(pipe_sess_hdl_t *sess) {
         pipe_mgr_drv_service_idle_time_drs(i);
         service_ilist_drs(i);
       }
+      drv_poll_backoff(&poll);
     }
   }
   return PIPE_SUCCESS;
@@ -4772,20 +5140,12 @@ pipe_status_t pipe_mgr_drv_reconfig_ilist_push(pipe_sess_hdl_t *sess,
   /* For each buffer in the list, assign it a message id and push it onto the
    * LLD fifo. */
   i = dev_id;
-  pipe_mgr_drv_buf_t *b;
   for (int subdev_id = 0; subdev_id < (int)num_subdevices; subdev_id++) {
-    for (b = il->bufs[i][subdev_id]; b; b = b->next) {
-      if (!b->buf_pushed) {
-        b->msgId = pipe_mgr_drv_next_msgId(st, i, i_list_msgid_type);
-      }
-
-      pipe_status_t sts = ilist_push(st, dev_info, subdev_id, b);
-      if (sts != PIPE_SUCCESS) {
-        PIPE_MGR_UNLOCK(&st->mtx_ses);
-        return sts;
-      }
-
-      ++st->cntrs.iListPushBuf;
+    pipe_status_t sts =
+        ilist_push(st, dev_info, subdev_id, il->bufs[i][subdev_id]);
+    if (sts != PIPE_SUCCESS) {
+      PIPE_MGR_UNLOCK(&st->mtx_ses);
+      return sts;
     }
     /* If any buffers were pushed to the device start the DMA. */
     if (il->bufs[i][subdev_id]) {
@@ -4798,7 +5158,11 @@ pipe_status_t pipe_mgr_drv_reconfig_ilist_push(pipe_sess_hdl_t *sess,
   for (i = 0; i < PIPE_MGR_NUM_DEVICES; ++i) {
     rmt_dev_info_t *d_info = pipe_mgr_get_dev_info(i);
     if (!d_info) continue;
-    while (ilist_pending_full(i)) service_ilist_drs(i);
+    drv_poll_state_t poll = {0, 0};
+    while (ilist_pending_full(i)) {
+      service_ilist_drs(i);
+      drv_poll_backoff(&poll);
+    }
   }
 
   PIPE_MGR_UNLOCK(&st->mtx_ses);
@@ -278,6 +278,56 @@ typedef struct pipe_mgr_drv_ses_state_t {
   pipe_mgr_mutex_t mtx_ses;
 } pipe_mgr_drv_ses_state_t;
 
+/* Descriptor rings pushed by the driver whose completions are tracked so that
+ * a completion DR is only serviced while it has work outstanding. */
+typedef enum pipe_mgr_drv_ring_e {
+  PIPE_MGR_DRV_RING_IL_0 = 0,
+  PIPE_MGR_DRV_RING_IL_1,
+  PIPE_MGR_DRV_RING_IL_2,
+  PIPE_MGR_DRV_RING_IL_3,
+  PIPE_MGR_DRV_RING_RD_BLK,
+  PIPE_MGR_DRV_RING_WR_BLK,
+  PIPE_MGR_DRV_RING_CNT
+} pipe_mgr_drv_ring_e;
+
+typedef struct pipe_mgr_drv_ring_t {
+  /* Descriptors pushed on the Tx DR whose completion was not processed yet. */
+  int pending;
+  /* Set on every push, cleared once the Tx DR was serviced with nothing
+   * pending, meaning all its descriptors were reclaimed. */
+  bool tx_dirty;
+  /* Time, in micro seconds, at which pending last went from zero to one. */
+  uint64_t busy_start_us;
+  /* Time, in micro seconds, of the last service regardless of pending work. */
+  uint64_t last_sweep_us;
+  /* Statistics, cleared with pipe_mgr_drv_ring_stats_clear. */
+  uint64_t pushed;
+  uint64_t completed;
+  uint64_t polls;
+  uint64_t skips;
+  uint64_t occupancy_sum;
+  int occupancy_max;
+  uint64_t busy_cnt;
+  uint64_t busy_total_us;
+  uint64_t busy_max_us;
+} pipe_mgr_drv_ring_t;
+
+/* Tuning of the completion DR servicing. */
+typedef struct pipe_mgr_drv_poll_cfg_t {
+  /* Polls without progress a waiter busy-polls before it starts to sleep. */
+  uint32_t spin_cnt;
+  /* Upper bound of the sleep between two polls of a waiter, the sleep is
+   * doubled from one micro second up to this value.  Zero never sleeps. */
+  uint32_t sleep_max_us;
+  /* Interval at which all rings are serviced, pending or not, so that
+   * descriptors pushed outside of the driver are completed too. */
+  uint32_t sweep_us;
+} pipe_mgr_drv_poll_cfg_t;
+
+#define PIPE_MGR_DRV_POLL_SPIN_CNT_DEF 256
+#define PIPE_MGR_DRV_POLL_SLEEP_MAX_US_DEF 64
+#define PIPE_MGR_DRV_POLL_SWEEP_US_DEF 100000
+
 struct pipe_mgr_drv_ctx_t {
   pipe_mgr_drv_buf_pool_t gBufPool[PIPE_MGR_NUM_DEVICES][BF_MAX_SUBDEV_COUNT];
   pipe_mgr_drv_ses_state_t sesStates[PIPE_MGR_MAX_SESSIONS];
@@ -287,10 +337,12 @@ struct pipe_mgr_drv_ctx_t {
   pipe_mgr_mutex_t drv_ctx_mtx;
   int ilist_dr_size[PIPE_MGR_NUM_DEVICES][BF_MAX_SUBDEV_COUNT]
                    [4];  // One per ilistCmpltion DR
-  int ilist_pending_cnt[PIPE_MGR_NUM_DEVICES][BF_MAX_SUBDEV_COUNT][4];  // One
-                                                                        // per
-                                                                        // ilist
-                                                                        // DR
+  pipe_mgr_drv_ring_t ring[PIPE_MGR_NUM_DEVICES][BF_MAX_SUBDEV_COUNT]
+                          [PIPE_MGR_DRV_RING_CNT];
+  /* Total number of completions processed on all rings, used by waiters to
+   * detect progress. */
+  uint64_t ring_cmplt_cnt;
+  pipe_mgr_drv_poll_cfg_t poll_cfg;
 };
 
 struct pipe_mgr_drv_ctx_t *pipe_mgr_drv_ctx();
@@ -307,6 +359,14 @@ pipe_mgr_drv_ses_state_t *pipe_mgr_drv_get_ses_state(pipe_sess_hdl_t *sess_hdl,
 
 pipe_sess_hdl_t pipe_mgr_get_int_sess_hdl(void);
 
+void pipe_mgr_drv_poll_cfg_set(const pipe_mgr_drv_poll_cfg_t *cfg);
+void pipe_mgr_drv_poll_cfg_get(pipe_mgr_drv_poll_cfg_t *cfg);
+void pipe_mgr_drv_ring_stats_get(bf_dev_id_t dev_id,
+                                 bf_subdev_id_t subdev_id,
+                                 pipe_mgr_drv_ring_e ring,
+                                 pipe_mgr_drv_ring_t *stats);
+void pipe_mgr_drv_ring_stats_clear(bf_dev_id_t dev_id);
+
 uint32_t pipe_mgr_drv_ilist_locked_size_remaining(pipe_sess_hdl_t sess,
                                                   bf_dev_id_t dev_id);
 
@@ -502,6 +502,11 @@ static pipe_status_t pipe_mgr_exm_hash_action_hitless_ha_reconcile(
   ha_report->num_entries_added = 0;
   ha_report->num_entries_deleted = 0;
   ha_report->num_entries_modified = 0;
+  ha_report->num_entries_matched = 0;
+  for (pipe_mgr_ha_entry_t *entry = spec_map->full_match_list; entry;
+       entry = entry->np) {
+    ++ha_report->num_entries_matched;
+  }
 
   bool has_idle =
       pipe_mgr_mat_tbl_has_idle(exm_tbl->dev_id, exm_tbl->mat_tbl_hdl);
@@ -26,6 +26,10 @@
  */
 
 /* Module header files */
+#include <inttypes.h>
+#include <time.h>
+#include <unistd.h>
+#include <target-utils/third-party/xxHash/xxhash.h>
 #include <dvm/bf_drv_intf.h>
 #include <lld/bf_dma_if.h>
 #include <lld/lld_inst_list_fmt.h>
@@ -478,6 +482,356 @@ static pipe_status_t iterate_all_stat_tbls(rmt_dev_info_t *dev_info,
 }
 #endif
 
+/* Tables are restored in parallel by a pool of worker threads.  Restoring a
+ * table updates the state of the tables it references: a match table adds
+ * references to its action data, selector, stats, meter and stateful tables
+ * and a selector table to its action data table.  Tables sharing a
+ * referenced table are therefore put in the same group, the tables of a
+ * group are restored in order by a single worker while distinct groups run
+ * concurrently. */
+#define PIPE_MGR_HA_MAX_WORKERS 8
+
+/* Zero picks the number of online CPUs, capped at PIPE_MGR_HA_MAX_WORKERS. */
+static uint32_t ha_num_workers = 0;
+
+void pipe_mgr_hitless_ha_num_workers_set(uint32_t num_workers) {
+  ha_num_workers = num_workers;
+}
+
+uint32_t pipe_mgr_hitless_ha_num_workers_get(void) {
+  if (ha_num_workers) return ha_num_workers;
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  if (n < 1) return 1;
+  return n > PIPE_MGR_HA_MAX_WORKERS ? PIPE_MGR_HA_MAX_WORKERS : n;
+}
+
+typedef enum ha_job_type_e {
+  HA_JOB_MAT,
+  HA_JOB_ADT,
+  HA_JOB_SEL,
+} ha_job_type_e;
+
+typedef struct ha_job_s {
+  rmt_dev_profile_info_t *profile_info;
+  void *tbl_info;
+  pipe_tbl_hdl_t handle;
+  /* Union-find parent while grouping, the next job of the group after. */
+  uint32_t parent;
+  uint32_t next;
+} ha_job_t;
+
+typedef struct ha_par_ctx_s {
+  rmt_dev_info_t *dev_info;
+  ha_job_type_e type;
+  union {
+    mat_tbl_iter_func mat;
+    adt_tbl_iter_func adt;
+    sel_tbl_iter_func sel;
+  } iter_func;
+  void *iter_arg;
+  ha_job_t *jobs;
+  /* First job of each group, largest group first. */
+  uint32_t *groups;
+  uint32_t *group_sz;
+  uint32_t num_groups;
+  /* Next group to hand out and the first error seen, under mtx. */
+  uint32_t next_group;
+  pipe_status_t rc;
+  pipe_mgr_mutex_t mtx;
+  const char *where;
+  int line;
+} ha_par_ctx_t;
+
+static uint32_t ha_job_find(ha_job_t *jobs, uint32_t i) {
+  while (jobs[i].parent != i) {
+    jobs[i].parent = jobs[jobs[i].parent].parent;
+    i = jobs[i].parent;
+  }
+  return i;
+}
+
+/* Put job i in the group of the first job which used the table handle. */
+static void ha_job_link(bf_map_t *owners,
+                        ha_job_t *jobs,
+                        uint32_t i,
+                        pipe_tbl_hdl_t handle) {
+  void *owner = NULL;
+  if (!handle) return;
+  if (bf_map_get(owners, handle, &owner) != BF_MAP_OK) {
+    bf_map_add(owners, handle, (void *)(uintptr_t)i);
+    return;
+  }
+  uint32_t a = ha_job_find(jobs, i);
+  uint32_t b = ha_job_find(jobs, (uint32_t)(uintptr_t)owner);
+  if (a == b) return;
+  /* Keep the lowest index as root so groups keep the table order. */
+  if (a < b) {
+    jobs[b].parent = a;
+  } else {
+    jobs[a].parent = b;
+  }
+}
+
+static void ha_job_link_refs(bf_map_t *owners,
+                             ha_job_t *jobs,
+                             uint32_t i,
+                             pipe_tbl_ref_t *refs,
+                             uint32_t num_refs) {
+  uint32_t r;
+  for (r = 0; r < num_refs; ++r) {
+    ha_job_link(owners, jobs, i, refs[r].tbl_hdl);
+  }
+}
+
+static void ha_job_link_deps(bf_map_t *owners,
+                             ha_par_ctx_t *ctx,
+                             uint32_t i) {
+  ha_job_t *jobs = ctx->jobs;
+  ha_job_link(owners, jobs, i, jobs[i].handle);
+  if (ctx->type == HA_JOB_MAT) {
+    pipe_mat_tbl_info_t *t = jobs[i].tbl_info;
+    ha_job_link_refs(owners, jobs, i, t->adt_tbl_ref, t->num_adt_tbl_refs);
+    ha_job_link_refs(owners, jobs, i, t->sel_tbl_ref, t->num_sel_tbl_refs);
+    ha_job_link_refs(owners, jobs, i, t->stat_tbl_ref, t->num_stat_tbl_refs);
+    ha_job_link_refs(owners, jobs, i, t->meter_tbl_ref, t->num_meter_tbl_refs);
+    ha_job_link_refs(owners, jobs, i, t->stful_tbl_ref, t->num_stful_tbl_refs);
+    if (t->alpm_info) {
+      ha_job_link(owners, jobs, i, t->alpm_info->preclass_handle);
+      ha_job_link(owners, jobs, i, t->alpm_info->atcam_handle);
+    }
+  } else if (ctx->type == HA_JOB_SEL) {
+    pipe_select_tbl_info_t *t = jobs[i].tbl_info;
+    ha_job_link(owners, jobs, i, t->adt_tbl_hdl);
+    ha_job_link(owners, jobs, i, t->stful_tbl_hdl);
+  }
+}
+
+static pipe_status_t ha_job_run(ha_par_ctx_t *ctx, ha_job_t *job) {
+  switch (ctx->type) {
+    case HA_JOB_MAT:
+      return ctx->iter_func.mat(
+          ctx->dev_info, job->profile_info, job->tbl_info, ctx->iter_arg);
+    case HA_JOB_ADT:
+      return ctx->iter_func.adt(
+          ctx->dev_info, job->profile_info, job->tbl_info, ctx->iter_arg);
+    case HA_JOB_SEL:
+      return ctx->iter_func.sel(
+          ctx->dev_info, job->profile_info, job->tbl_info, ctx->iter_arg);
+  }
+  return PIPE_UNEXPECTED;
+}
+
+static void *ha_par_worker(void *arg) {
+  ha_par_ctx_t *ctx = arg;
+  while (true) {
+    uint32_t g;
+    PIPE_MGR_LOCK(&ctx->mtx);
+    if (ctx->rc != PIPE_SUCCESS || ctx->next_group == ctx->num_groups) {
+      PIPE_MGR_UNLOCK(&ctx->mtx);
+      break;
+    }
+    g = ctx->next_group++;
+    PIPE_MGR_UNLOCK(&ctx->mtx);
+
+    uint32_t i;
+    for (i = ctx->groups[g]; i != UINT32_MAX; i = ctx->jobs[i].next) {
+      pipe_status_t rc = ha_job_run(ctx, &ctx->jobs[i]);
+      if (rc != PIPE_SUCCESS) {
+        LOG_ERROR("Tbl 0x%x returned error 0x%x(%s) on device %d at %s:%d",
+                  ctx->jobs[i].handle,
+                  rc,
+                  pipe_str_err(rc),
+                  ctx->dev_info->dev_id,
+                  ctx->where,
+                  ctx->line);
+        PIPE_MGR_LOCK(&ctx->mtx);
+        if (ctx->rc == PIPE_SUCCESS) ctx->rc = rc;
+        PIPE_MGR_UNLOCK(&ctx->mtx);
+        break;
+      }
+    }
+  }
+  return NULL;
+}
+
+/* Run the iterator over all tables of one type using the worker pool.  Like
+ * the serial iterate_all_* functions, errors are logged and stop the
+ * iteration but are not returned. */
+static pipe_status_t iterate_all_tbls_par(ha_par_ctx_t *ctx) {
+  rmt_dev_info_t *dev_info = ctx->dev_info;
+  uint32_t num_jobs = 0, p, i, j;
+  bf_map_t owners;
+  bf_sys_thread_t threads[PIPE_MGR_HA_MAX_WORKERS];
+  uint32_t num_threads = 0;
+
+  for (p = 0; p < dev_info->num_pipeline_profiles; p++) {
+    rmt_dev_tbl_info_t *tl = &dev_info->profile_info[p]->tbl_info_list;
+    num_jobs += ctx->type == HA_JOB_MAT   ? tl->num_mat_tbls
+                : ctx->type == HA_JOB_ADT ? tl->num_adt_tbls
+                                          : tl->num_select_tbls;
+  }
+  if (!num_jobs) return PIPE_SUCCESS;
+
+  ctx->jobs = PIPE_MGR_CALLOC(num_jobs, sizeof *ctx->jobs);
+  ctx->groups = PIPE_MGR_CALLOC(num_jobs, sizeof *ctx->groups);
+  ctx->group_sz = PIPE_MGR_CALLOC(num_jobs, sizeof *ctx->group_sz);
+  if (!ctx->jobs || !ctx->groups || !ctx->group_sz) {
+    PIPE_MGR_FREE(ctx->jobs);
+    PIPE_MGR_FREE(ctx->groups);
+    PIPE_MGR_FREE(ctx->group_sz);
+    return PIPE_NO_SYS_RESOURCES;
+  }
+
+  num_jobs = 0;
+  for (p = 0; p < dev_info->num_pipeline_profiles; p++) {
+    rmt_dev_profile_info_t *profile_info = dev_info->profile_info[p];
+    rmt_dev_tbl_info_t *tl = &profile_info->tbl_info_list;
+    uint32_t n = ctx->type == HA_JOB_MAT   ? tl->num_mat_tbls
+                 : ctx->type == HA_JOB_ADT ? tl->num_adt_tbls
+                                           : tl->num_select_tbls;
+    for (i = 0; i < n; ++i, ++num_jobs) {
+      ha_job_t *job = &ctx->jobs[num_jobs];
+      job->profile_info = profile_info;
+      job->parent = num_jobs;
+      job->next = UINT32_MAX;
+      if (ctx->type == HA_JOB_MAT) {
+        job->tbl_info = &tl->mat_tbl_list[i];
+        job->handle = tl->mat_tbl_list[i].handle;
+      } else if (ctx->type == HA_JOB_ADT) {
+        job->tbl_info = &tl->adt_tbl_list[i];
+        job->handle = tl->adt_tbl_list[i].handle;
+      } else {
+        job->tbl_info = &tl->select_tbl_list[i];
+        job->handle = tl->select_tbl_list[i].handle;
+      }
+    }
+  }
+
+  bf_map_init(&owners);
+  for (i = 0; i < num_jobs; ++i) ha_job_link_deps(&owners, ctx, i);
+  bf_map_destroy(&owners);
+
+  /* Chain the jobs of each group in table order, walking backwards so each
+   * job is pushed in front of the later ones. */
+  for (i = num_jobs; i-- > 0;) {
+    uint32_t r = ha_job_find(ctx->jobs, i);
+    if (r == i) continue;
+    ctx->jobs[i].next = ctx->jobs[r].next;
+    ctx->jobs[r].next = i;
+  }
+  ctx->num_groups = 0;
+  for (i = 0; i < num_jobs; ++i) {
+    if (ha_job_find(ctx->jobs, i) != i) continue;
+    uint32_t sz = 0;
+    for (j = i; j != UINT32_MAX; j = ctx->jobs[j].next) ++sz;
+    ctx->groups[ctx->num_groups] = i;
+    ctx->group_sz[ctx->num_groups] = sz;
+    ++ctx->num_groups;
+  }
+  /* Hand out the largest groups first so they do not end up last on a
+   * worker.  Insertion sort, the number of groups is small. */
+  for (i = 1; i < ctx->num_groups; ++i) {
+    uint32_t g = ctx->groups[i];
+    uint32_t sz = ctx->group_sz[i];
+    for (j = i; j > 0 && ctx->group_sz[j - 1] < sz; --j) {
+      ctx->groups[j] = ctx->groups[j - 1];
+      ctx->group_sz[j] = ctx->group_sz[j - 1];
+    }
+    ctx->groups[j] = g;
+    ctx->group_sz[j] = sz;
+  }
+
+  ctx->next_group = 0;
+  ctx->rc = PIPE_SUCCESS;
+  PIPE_MGR_LOCK_INIT(ctx->mtx);
+
+  uint32_t num_workers = pipe_mgr_hitless_ha_num_workers_get();
+  if (num_workers > ctx->num_groups) num_workers = ctx->num_groups;
+  if (num_workers > PIPE_MGR_HA_MAX_WORKERS) {
+    num_workers = PIPE_MGR_HA_MAX_WORKERS;
+  }
+  /* The calling thread is one of the workers. */
+  for (i = 1; i < num_workers; ++i) {
+    if (bf_sys_thread_create(&threads[num_threads], ha_par_worker, ctx, 0)) {
+      LOG_WARN("%s:%d Dev %d failed to start HA worker %u, continuing with %u",
+               __func__,
+               __LINE__,
+               dev_info->dev_id,
+               i,
+               num_threads + 1);
+      break;
+    }
+    bf_sys_thread_set_name(threads[num_threads], "bf_ha_restore");
+    ++num_threads;
+  }
+  ha_par_worker(ctx);
+  for (i = 0; i < num_threads; ++i) bf_sys_thread_join(threads[i], NULL);
+
+  PIPE_MGR_LOCK_DESTROY(&ctx->mtx);
+  PIPE_MGR_FREE(ctx->jobs);
+  PIPE_MGR_FREE(ctx->groups);
+  PIPE_MGR_FREE(ctx->group_sz);
+  return PIPE_SUCCESS;
+}
+
+static pipe_status_t iterate_all_mat_tbls_par(rmt_dev_info_t *dev_info,
+                                              mat_tbl_iter_func iter_func,
+                                              void *iter_arg,
+                                              const char *where,
+                                              const int line) {
+  /* Saving move lists for the virtual device is not thread safe. */
+  if (pipe_mgr_is_device_virtual_dev_slave(dev_info->dev_id)) {
+    return iterate_all_mat_tbls(
+        dev_info, iter_func, NULL, iter_arg, where, line);
+  }
+  ha_par_ctx_t ctx = {0};
+  ctx.dev_info = dev_info;
+  ctx.type = HA_JOB_MAT;
+  ctx.iter_func.mat = iter_func;
+  ctx.iter_arg = iter_arg;
+  ctx.where = where;
+  ctx.line = line;
+  return iterate_all_tbls_par(&ctx);
+}
+
+static pipe_status_t iterate_all_adt_tbls_par(rmt_dev_info_t *dev_info,
+                                              adt_tbl_iter_func iter_func,
+                                              void *iter_arg,
+                                              const char *where,
+                                              const int line) {
+  if (pipe_mgr_is_device_virtual_dev_slave(dev_info->dev_id)) {
+    return iterate_all_adt_tbls(
+        dev_info, iter_func, NULL, iter_arg, where, line);
+  }
+  ha_par_ctx_t ctx = {0};
+  ctx.dev_info = dev_info;
+  ctx.type = HA_JOB_ADT;
+  ctx.iter_func.adt = iter_func;
+  ctx.iter_arg = iter_arg;
+  ctx.where = where;
+  ctx.line = line;
+  return iterate_all_tbls_par(&ctx);
+}
+
+static pipe_status_t iterate_all_sel_tbls_par(rmt_dev_info_t *dev_info,
+                                              sel_tbl_iter_func iter_func,
+                                              void *iter_arg,
+                                              const char *where,
+                                              const int line) {
+  if (pipe_mgr_is_device_virtual_dev_slave(dev_info->dev_id)) {
+    return iterate_all_sel_tbls(
+        dev_info, iter_func, NULL, iter_arg, where, line);
+  }
+  ha_par_ctx_t ctx = {0};
+  ctx.dev_info = dev_info;
+  ctx.type = HA_JOB_SEL;
+  ctx.iter_func.sel = iter_func;
+  ctx.iter_arg = iter_arg;
+  ctx.where = where;
+  ctx.line = line;
+  return iterate_all_tbls_par(&ctx);
+}
+
 static void phy_tbl_read_cb(pipe_mgr_drv_buf_t *b,
                             uint32_t offset,
                             uint32_t count,
@@ -1170,9 +1524,37 @@ static pipe_mgr_hitless_ha_ctx_t *get_ha_ctx(bf_dev_id_t device_id) {
   return &hitless_ha_ctx[device_id];
 }
 
+static uint64_t ha_time_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+/* Record the duration of a phase started at start_us and return the start of
+ * the next one. */
+static uint64_t ha_phase_done(bf_dev_id_t dev_id,
+                              pipe_mgr_hitless_ha_phase_e phase,
+                              uint64_t start_us) {
+  uint64_t now = ha_time_us();
+  get_ha_ctx(dev_id)->phase_us[phase] = now - start_us;
+  LOG_TRACE("Dev %d hitless HA phase %s took %" PRIu64 " us",
+            dev_id,
+            pipe_mgr_hitless_ha_phase_name(phase),
+            now - start_us);
+  return now;
+}
+
+uint64_t pipe_mgr_hitless_ha_phase_time_get(bf_dev_id_t dev_id,
+                                            pipe_mgr_hitless_ha_phase_e phase) {
+  if (dev_id < 0 || dev_id >= BF_MAX_DEV_COUNT) return 0;
+  if (phase >= PIPE_MGR_HA_PHASE_CNT) return 0;
+  return get_ha_ctx(dev_id)->phase_us[phase];
+}
+
 pipe_status_t pipe_mgr_hitless_ha_init(pipe_sess_hdl_t sess_hdl,
                                        bf_dev_id_t dev_id) {
   pipe_status_t rc = PIPE_SUCCESS;
+  uint64_t start_us = ha_time_us();
   rc = pipe_mgr_ha_update_symmetricity(sess_hdl, dev_id);
   if (rc != PIPE_SUCCESS) {
     LOG_CRIT(
@@ -1195,6 +1577,7 @@ pipe_status_t pipe_mgr_hitless_ha_init(pipe_sess_hdl_t sess_hdl,
              pipe_str_err(rc));
     return rc;
   }
+  ha_phase_done(dev_id, PIPE_MGR_HA_PHASE_HW_READ, start_us);
 
   return PIPE_SUCCESS;
 }
@@ -1548,6 +1931,7 @@ pipe_status_t pipe_mgr_hitless_ha_complete_hw_read(pipe_sess_hdl_t sess_hdl,
                                                    bf_dev_id_t dev_id) {
   rmt_dev_info_t *dev_info = NULL;
   pipe_status_t rc;
+  uint64_t start_us = ha_time_us();
 
   if (!(dev_info = pipe_mgr_get_dev_info(dev_id))) {
     return PIPE_OBJ_NOT_FOUND;
@@ -1571,6 +1955,7 @@ pipe_status_t pipe_mgr_hitless_ha_complete_hw_read(pipe_sess_hdl_t sess_hdl,
         pipe_str_err(rc));
     return rc;
   }
+  start_us = ha_phase_done(dev_id, PIPE_MGR_HA_PHASE_HW_READ_CMPLT, start_us);
 
   /*
    * LLP state restore from hardware must be done in the order
@@ -1578,9 +1963,11 @@ pipe_status_t pipe_mgr_hitless_ha_complete_hw_read(pipe_sess_hdl_t sess_hdl,
    * action and selector virtual addresses, which are needed to find the
    * location of the action entry or selector in hardware. Similarly,
    * the selector itself holds the location of its action members.
+   * Within each step the tables are restored in parallel, tables sharing a
+   * referenced table are restored by the same worker.
    */
-  rc = iterate_all_mat_tbls(
-      dev_info, mat_tbl_llp_restore_state, NULL, NULL, __func__, __LINE__);
+  rc = iterate_all_mat_tbls_par(
+      dev_info, mat_tbl_llp_restore_state, NULL, __func__, __LINE__);
   if (rc != PIPE_SUCCESS) {
     LOG_CRIT(
         "%s:%d Error restoring match table llp state for dev %d rc 0x%x(%s)",
@@ -1592,8 +1979,8 @@ pipe_status_t pipe_mgr_hitless_ha_complete_hw_read(pipe_sess_hdl_t sess_hdl,
     return rc;
   }
 
-  rc = iterate_all_sel_tbls(
-      dev_info, sel_tbl_llp_restore_state, NULL, NULL, __func__, __LINE__);
+  rc = iterate_all_sel_tbls_par(
+      dev_info, sel_tbl_llp_restore_state, NULL, __func__, __LINE__);
   if (rc != PIPE_SUCCESS) {
     LOG_CRIT(
         "%s:%d Error restoring selector table llp state for dev %d rc 0x%x(%s)",
@@ -1605,8 +1992,8 @@ pipe_status_t pipe_mgr_hitless_ha_complete_hw_read(pipe_sess_hdl_t sess_hdl,
     return rc;
   }
 
-  rc = iterate_all_adt_tbls(
-      dev_info, adt_tbl_llp_restore_state, NULL, NULL, __func__, __LINE__);
+  rc = iterate_all_adt_tbls_par(
+      dev_info, adt_tbl_llp_restore_state, NULL, __func__, __LINE__);
   if (rc != PIPE_SUCCESS) {
     LOG_CRIT(
         "%s:%d Error restoring action table llp state for dev %d rc 0x%x(%s)",
@@ -1617,6 +2004,7 @@ pipe_status_t pipe_mgr_hitless_ha_complete_hw_read(pipe_sess_hdl_t sess_hdl,
         pipe_str_err(rc));
     return rc;
   }
+  start_us = ha_phase_done(dev_id, PIPE_MGR_HA_PHASE_LLP_RESTORE, start_us);
 
   /*
    * HLP state restore should only happen in single-process mode.
@@ -1626,8 +2014,8 @@ pipe_status_t pipe_mgr_hitless_ha_complete_hw_read(pipe_sess_hdl_t sess_hdl,
    */
   bool hlp_with_llp = !pipe_mgr_is_device_virtual_dev_slave(dev_info->dev_id);
   if (hlp_with_llp) {
-    rc = iterate_all_adt_tbls(
-        dev_info, adt_tbl_hlp_restore_state, NULL, NULL, __func__, __LINE__);
+    rc = iterate_all_adt_tbls_par(
+        dev_info, adt_tbl_hlp_restore_state, NULL, __func__, __LINE__);
     if (rc != PIPE_SUCCESS) {
       LOG_CRIT(
           "%s:%d Error restoring action table hlp state for dev %d rc 0x%x(%s)",
@@ -1639,8 +2027,8 @@ pipe_status_t pipe_mgr_hitless_ha_complete_hw_read(pipe_sess_hdl_t sess_hdl,
       return rc;
     }
 
-    rc = iterate_all_sel_tbls(
-        dev_info, sel_tbl_hlp_restore_state, NULL, NULL, __func__, __LINE__);
+    rc = iterate_all_sel_tbls_par(
+        dev_info, sel_tbl_hlp_restore_state, NULL, __func__, __LINE__);
     if (rc != PIPE_SUCCESS) {
       LOG_CRIT(
           "%s:%d Error restoring selector table hlp state for dev %d rc "
@@ -1653,8 +2041,8 @@ pipe_status_t pipe_mgr_hitless_ha_complete_hw_read(pipe_sess_hdl_t sess_hdl,
       return rc;
     }
 
-    rc = iterate_all_mat_tbls(
-        dev_info, mat_tbl_hlp_restore_state, NULL, NULL, __func__, __LINE__);
+    rc = iterate_all_mat_tbls_par(
+        dev_info, mat_tbl_hlp_restore_state, NULL, __func__, __LINE__);
     if (rc != PIPE_SUCCESS) {
       LOG_CRIT(
           "%s:%d Error restoring match table hlp state for dev %d rc 0x%x(%s)",
@@ -1666,6 +2054,7 @@ pipe_status_t pipe_mgr_hitless_ha_complete_hw_read(pipe_sess_hdl_t sess_hdl,
       return rc;
     }
   }
+  ha_phase_done(dev_id, PIPE_MGR_HA_PHASE_HLP_RESTORE, start_us);
 
   return PIPE_SUCCESS;
 }
@@ -2060,6 +2449,7 @@ pipe_status_t pipe_mgr_hitless_ha_compute_delta_changes(
   UNUSED(dev_id);
   rmt_dev_info_t *dev_info = NULL;
   pipe_status_t rc;
+  uint64_t start_us = ha_time_us();
 
   if (!(dev_info = pipe_mgr_get_dev_info(dev_id))) {
     return PIPE_OBJ_NOT_FOUND;
@@ -2144,6 +2534,7 @@ pipe_status_t pipe_mgr_hitless_ha_compute_delta_changes(
         pipe_str_err(rc));
     return rc;
   }
+  ha_phase_done(dev_id, PIPE_MGR_HA_PHASE_COMPUTE_DELTA, start_us);
 
   return PIPE_SUCCESS;
 }
@@ -2152,6 +2543,7 @@ pipe_status_t pipe_mgr_hitless_ha_push_delta_changes(pipe_sess_hdl_t sess_hdl,
                                                      bf_dev_id_t dev_id) {
   rmt_dev_info_t *dev_info = pipe_mgr_get_dev_info(dev_id);
   if (!dev_info) return PIPE_INVALID_ARG;
+  uint64_t start_us = ha_time_us();
 
   /* Get out of HA so we can write config. */
   pipe_mgr_init_mode_reset(dev_id);
@@ -2201,62 +2593,55 @@ pipe_status_t pipe_mgr_hitless_ha_push_delta_changes(pipe_sess_hdl_t sess_hdl,
   }
 
   pipe_mgr_complete_operations(sess_hdl);
+  ha_phase_done(dev_id, PIPE_MGR_HA_PHASE_PUSH_DELTA, start_us);
 
   return PIPE_SUCCESS;
 }
 
-static inline size_t key_sz_f(pipe_tbl_match_spec_t *match_spec) {
-  size_t hash_key_sz =
-      sizeof(pipe_tbl_match_spec_t) + (match_spec->num_match_bytes << 1);
-  return hash_key_sz ? hash_key_sz : 1;
-}
-
-static uint8_t *form_hash_key(uint8_t *hash_key,
-                              pipe_tbl_match_spec_t *match_spec) {
-  pipe_tbl_match_spec_t *ms_hash = (pipe_tbl_match_spec_t *)hash_key;
-
-  if (!ms_hash) {
-    size_t hash_key_sz = key_sz_f(match_spec);
-    ms_hash = (pipe_tbl_match_spec_t *)PIPE_MGR_CALLOC(1, hash_key_sz);
-    if (!ms_hash) return NULL;
-  }
-
-  ms_hash->match_value_bits = (uint8_t *)(ms_hash + 1);
-  ms_hash->match_mask_bits =
-      ms_hash->match_value_bits + match_spec->num_match_bytes;
-  ms_hash = pipe_mgr_tbl_copy_match_spec(ms_hash, match_spec);
-  if (!ms_hash) return NULL;
-
-  // Zero out the priority for the hash key
-  ms_hash->priority = 0;
-  // Internal - zero out
-  ms_hash->version_bits = 0;
-  /* Set the pointers to zero so they do not affect the hash value.  The
-   * match_value_bits and match_mask_bits arrays are still in memory immediately
-   * after the match_spec struct. */
-  ms_hash->match_value_bits = NULL;
-  ms_hash->match_mask_bits = NULL;
-
-  return (uint8_t *)ms_hash;
-}
-
-static void form_adt_hash_key(uint8_t *hash_key,
-                              pipe_action_data_spec_t *act_data_spec,
-                              pipe_act_fn_hdl_t act_fn_hdl,
-                              bool sharable) {
-  PIPE_MGR_MEMCPY(hash_key,
-                  act_data_spec->action_data_bits,
-                  sizeof(uint8_t) * act_data_spec->num_action_data_bytes);
-  PIPE_MGR_MEMCPY(hash_key + act_data_spec->num_action_data_bytes,
-                  &act_fn_hdl,
-                  sizeof(pipe_act_fn_hdl_t));
-  hash_key += sizeof(uint8_t) * act_data_spec->num_action_data_bytes;
-  hash_key += sizeof(pipe_act_fn_hdl_t);
-  *hash_key = sharable ? 1 : 0;
-  return;
+/* Entries read back from hardware are indexed by a 64 bit fingerprint of
+ * their match spec, or of their action data for action tables, which is
+ * computed once when the entry is added.  Each fingerprint maps to a list of
+ * the entries sharing it, headed by a dummy entry.  A replayed spec is
+ * fingerprinted once and only compared against the entries on its list. */
+static uint64_t match_spec_fp(pipe_tbl_match_spec_t *match_spec) {
+  /* The priority and version bits are left out, the priority of most tables
+   * cannot be restored from the hardware. */
+  uint64_t h = ((uint64_t)match_spec->partition_index << 16) |
+               match_spec->num_valid_match_bits;
+  h = XXH3_64bits_withSeed(
+      match_spec->match_value_bits, match_spec->num_match_bytes, h);
+  if (match_spec->match_mask_bits) {
+    h = XXH3_64bits_withSeed(
+        match_spec->match_mask_bits, match_spec->num_match_bytes, h);
+  }
+  return h;
+}
+
+static bool match_spec_equal(pipe_tbl_match_spec_t *m1,
+                             pipe_tbl_match_spec_t *m2) {
+  if (m1->num_match_bytes != m2->num_match_bytes ||
+      m1->num_valid_match_bits != m2->num_valid_match_bits ||
+      m1->partition_index != m2->partition_index) {
+    return false;
+  }
+  if (memcmp(m1->match_value_bits, m2->match_value_bits, m1->num_match_bytes))
+    return false;
+  if (!m1->match_mask_bits || !m2->match_mask_bits)
+    return m1->match_mask_bits == m2->match_mask_bits;
+  return !memcmp(m1->match_mask_bits, m2->match_mask_bits, m1->num_match_bytes);
 }
 
-void destroy_hash_key(uint8_t *hash_key) { PIPE_MGR_FREE(hash_key); }
+/* Sharable entries are first to be replayed.  Non-sharable entries can be
+ * reconciled later even if there is an adt handle mismatch, so sharing is
+ * part of the fingerprint. */
+static uint64_t adt_spec_fp(pipe_action_data_spec_t *act_data_spec,
+                            pipe_act_fn_hdl_t act_fn_hdl,
+                            bool sharable) {
+  uint64_t seed = ((uint64_t)act_fn_hdl << 1) | (sharable ? 1 : 0);
+  return XXH3_64bits_withSeed(act_data_spec->action_data_bits,
+                              act_data_spec->num_action_data_bytes,
+                              seed);
+}
 
 static pipe_mgr_ha_entry_t *form_entry(pipe_ent_hdl_t entry_hdl,
                                        pipe_tbl_match_spec_t *match_spec,
@@ -2296,113 +2681,53 @@ static void destroy_entry(pipe_mgr_ha_entry_t **entry_p) {
   *entry_p = NULL;
 }
 
-static int spec_cmp_fn(const void *k1, const void *k2) {
-  pipe_mgr_ha_entry_t *matching_entries_head =
-      (pipe_mgr_ha_entry_t *)bf_hashtbl_get_cmp_data(k2);
-
-  /* Always skip the dummy entry at the head. */
-  pipe_mgr_ha_entry_t *entry = matching_entries_head->n;
-  /* After entry gets replayed once it gets removed from the list.
-   * It is possible there are no entries in the list, hence need to check */
-  if (!entry) return 1;
-  pipe_tbl_match_spec_t *compare_spec = (pipe_tbl_match_spec_t *)k1;
-
-  compare_spec->match_value_bits = (uint8_t *)(compare_spec + 1);
-  compare_spec->match_mask_bits =
-      compare_spec->match_value_bits + compare_spec->num_match_bytes;
-
-  /* Compare the match specs k1 and entry */
-  pipe_tbl_match_spec_t *ms =
-      entry->mn ? unpack_mat_ent_data_ms(entry->mn->data) : entry->match_spec;
-
-  int d = pipe_mgr_tbl_compare_match_specs(compare_spec, ms);
-
-  compare_spec->match_value_bits = NULL;
-  compare_spec->match_mask_bits = NULL;
-
-  return d;
-}
-
-int adt_spec_cmp_fn(const void *k1, const void *k2) {
-  int ret = 0;
-  pipe_mgr_ha_entry_t *ha_entry =
-      (pipe_mgr_ha_entry_t *)bf_hashtbl_get_cmp_data(k2);
-  uint16_t num_action_data_bytes =
-      ha_entry->action_spec->act_data.num_action_data_bytes;
-  uint8_t *compare_spec = (uint8_t *)k1;
-  pipe_act_fn_hdl_t compare_act_fn_hdl =
-      *(pipe_act_fn_hdl_t *)((uint8_t *)k1 + num_action_data_bytes);
-  ret = memcmp(compare_spec,
-               ha_entry->action_spec->act_data.action_data_bits,
-               num_action_data_bytes);
-  if (ret) {
-    return ret;
-  }
-  if (compare_act_fn_hdl != ha_entry->act_fn_hdl) {
-    return -1;
-  }
-  return 0;
-}
-
-static pipe_status_t spec_map_init(pipe_mgr_spec_map_t *spec_map,
-                                   size_t key_sz) {
-  uint32_t seed = 0xba2ef007;
-
-  spec_map->spec_htbl =
-      (bf_hashtable_t *)PIPE_MGR_CALLOC(1, sizeof(bf_hashtable_t));
-
-  bf_hashtbl_sts_t sts;
-  sts = bf_hashtbl_init(spec_map->spec_htbl,
-                        spec_cmp_fn,
-                        NULL,
-                        key_sz,
-                        sizeof(pipe_mgr_ha_entry_t),
-                        seed);
-  if (sts != BF_HASHTBL_OK) {
-    LOG_ERROR("%s:%d Error initializing spec map hash table sts=0x%x",
-              __func__,
-              __LINE__,
-              sts);
-    return PIPE_UNEXPECTED;
-  }
-  return PIPE_SUCCESS;
-}
-
-static pipe_status_t adt_spec_map_init(pipe_mgr_spec_map_t *spec_map,
-                                       size_t key_sz) {
-  uint32_t seed = 0xba2ef007;
-
-  spec_map->spec_htbl =
-      (bf_hashtable_t *)PIPE_MGR_CALLOC(1, sizeof(bf_hashtable_t));
-
-  bf_hashtbl_sts_t sts;
-  sts = bf_hashtbl_init(spec_map->spec_htbl,
-                        adt_spec_cmp_fn,
-                        NULL,
-                        key_sz,
-                        sizeof(pipe_mgr_ha_entry_t),
-                        seed);
-  if (sts != BF_HASHTBL_OK) {
-    LOG_ERROR("%s:%d Error initializing spec map hash table sts=0x%x",
-              __func__,
-              __LINE__,
-              sts);
-    return PIPE_UNEXPECTED;
-  }
-  return PIPE_SUCCESS;
+/* Return the list of entries with the given fingerprint, optionally creating
+ * it. */
+static pipe_mgr_ha_entry_t *spec_fp_list_get(pipe_mgr_spec_map_t *spec_map,
+                                             uint64_t fp,
+                                             bool create) {
+  void *head = NULL;
+  if (bf_map_get(&spec_map->spec_fp_map, fp, &head) == BF_MAP_OK) return head;
+  if (!create) return NULL;
+
+  pipe_mgr_ha_entry_t *dummy_entry = form_entry(0, NULL, 0, NULL, NULL, 0);
+  if (!dummy_entry) return NULL;
+  dummy_entry->p = dummy_entry;
+  if (bf_map_add(&spec_map->spec_fp_map, fp, dummy_entry) != BF_MAP_OK) {
+    destroy_entry(&dummy_entry);
+    return NULL;
+  }
+  return dummy_entry;
 }
 
 void pipe_mgr_hitless_ha_delete_spec_map(pipe_mgr_spec_map_t *spec_map) {
-  bf_hashtbl_delete(spec_map->spec_htbl);
-  PIPE_MGR_FREE(spec_map->spec_htbl);
   pipe_mgr_ha_entry_t *entry;
+  unsigned long fp;
+  void *head;
+
+  /* Entries still on one of the lists below are released with the list,
+   * the others are only referenced by their fingerprint list. */
+  while (bf_map_get_first_rmv(&spec_map->spec_fp_map, &fp, &head) ==
+         BF_MAP_OK) {
+    pipe_mgr_ha_entry_t *dummy_entry = head;
+    while ((entry = dummy_entry->n)) {
+      BF_LIST_DLL_REM(dummy_entry, entry, n, p);
+      if (entry->pp) continue;
+      if (entry->mn) {
+        free_one_move_list_node_and_data(&entry->mn, true);
+      }
+      destroy_entry(&entry);
+    }
+    destroy_entry(&dummy_entry);
+  }
+  bf_map_destroy(&spec_map->spec_fp_map);
+
   while (spec_map->full_match_list) {
     entry = spec_map->full_match_list;
     BF_LIST_DLL_REM(spec_map->full_match_list, entry, np, pp);
     if (entry->mn) {
       free_one_move_list_node_and_data(&entry->mn, true);
     }
-    destroy_entry(&entry->p);
     destroy_entry(&entry);
   }
   while (spec_map->to_delete_list) {
@@ -2411,7 +2736,6 @@ void pipe_mgr_hitless_ha_delete_spec_map(pipe_mgr_spec_map_t *spec_map) {
     if (entry->mn) {
       free_one_move_list_node_and_data(&entry->mn, true);
     }
-    destroy_entry(&entry->p);
     destroy_entry(&entry);
   }
   while (spec_map->to_modify_list) {
@@ -2420,7 +2744,6 @@ void pipe_mgr_hitless_ha_delete_spec_map(pipe_mgr_spec_map_t *spec_map) {
     if (entry->mn) {
       free_one_move_list_node_and_data(&entry->mn, true);
     }
-    destroy_entry(&entry->p);
     destroy_entry(&entry);
   }
   while (spec_map->to_add_list) {
@@ -2429,7 +2752,6 @@ void pipe_mgr_hitless_ha_delete_spec_map(pipe_mgr_spec_map_t *spec_map) {
     if (entry->mn) {
       free_one_move_list_node_and_data(&entry->mn, true);
     }
-    destroy_entry(&entry->p);
     destroy_entry(&entry);
   }
 }
@@ -2438,12 +2760,11 @@ void pipe_mgr_hitless_ha_delete_spec_map(pipe_mgr_spec_map_t *spec_map) {
  */
 pipe_status_t pipe_mgr_hitless_ha_new_spec(pipe_mgr_spec_map_t *spec_map,
                                            pipe_mgr_move_list_t *move_node) {
-  /* Compute a hash and check if it is already present in the spec_map.
-   * If present, append the entry hdl
+  /* Fingerprint the match spec and append the entry to the list of entries
+   * with the same fingerprint.
    */
   pipe_tbl_match_spec_t *match_spec;
   pipe_mat_ent_hdl_t entry_hdl;
-  pipe_status_t rc = PIPE_SUCCESS;
 
   if (!spec_map || !move_node) {
     LOG_ERROR("%s:%d Bad args spec_map=%p move_node=%p",
@@ -2458,95 +2779,55 @@ pipe_status_t pipe_mgr_hitless_ha_new_spec(pipe_mgr_spec_map_t *spec_map,
   match_spec = unpack_mat_ent_data_ms(move_node->data);
   entry_hdl = move_node->entry_hdl;
 
-  if (!spec_map->spec_htbl) {
-    rc = spec_map_init(spec_map, key_sz_f(match_spec));
-    if (rc != PIPE_SUCCESS) {
-      return rc;
-    }
-  }
-
-  uint8_t hash_key[key_sz_f(match_spec)];
-  PIPE_MGR_MEMSET(hash_key, 0, key_sz_f(match_spec));
-  form_hash_key(hash_key, match_spec);
-
-  pipe_mgr_ha_entry_t *matching_entries_head;
-
-  /* hash_key derived out of match-spec */
-  /* entry_state derived out of act_fn_hdl and action_spec */
-  matching_entries_head = bf_hashtbl_search(spec_map->spec_htbl, hash_key);
-  if (!matching_entries_head) {
-    pipe_mgr_ha_entry_t *dummy_entry = form_entry(0, NULL, 0, NULL, NULL, 0);
-    if (!dummy_entry) {
-      LOG_ERROR("%s:%d Malloc error", __func__, __LINE__);
-      rc = PIPE_NO_SYS_RESOURCES;
-      goto cleanup;
-    }
-    BF_LIST_DLL_AP(matching_entries_head, dummy_entry, n, p);
-
-    bf_hashtbl_sts_t sts;
-    sts =
-        bf_hashtbl_insert(spec_map->spec_htbl, matching_entries_head, hash_key);
-    if (sts != BF_HASHTBL_OK) {
-      LOG_ERROR("%s:%d Error adding entry 0x%x to spec-map sts 0x%x",
-                __func__,
-                __LINE__,
-                entry_hdl,
-                sts);
-      rc = PIPE_UNEXPECTED;
-      goto cleanup;
-    }
+  uint64_t fp = match_spec_fp(match_spec);
+  pipe_mgr_ha_entry_t *matching_entries_head =
+      spec_fp_list_get(spec_map, fp, true);
+  pipe_mgr_ha_entry_t *entry =
+      form_entry(entry_hdl, NULL, 0, NULL, move_node, 0);
+  if (!matching_entries_head || !entry) {
+    LOG_ERROR("%s:%d Error adding entry 0x%x to spec-map, malloc failure",
+              __func__,
+              __LINE__,
+              entry_hdl);
+    destroy_entry(&entry);
+    return PIPE_NO_SYS_RESOURCES;
   }
-
-  pipe_mgr_ha_entry_t *entry;
-  entry = form_entry(entry_hdl, NULL, 0, NULL, move_node, 0);
+  entry->fp = fp;
   BF_LIST_DLL_AP(matching_entries_head, entry, n, p);
   BF_LIST_DLL_AP(spec_map->to_delete_list, entry, np, pp);
 
-cleanup:
-  return rc;
+  return PIPE_SUCCESS;
 }
 
 pipe_status_t pipe_mgr_hitless_ha_new_adt_spec(
     pipe_mgr_spec_map_t *spec_map,
     pipe_mgr_adt_move_list_t *move_node,
     uint8_t key_sz) {
-  pipe_status_t rc = PIPE_SUCCESS;
-  bf_hashtbl_sts_t sts = BF_HASHTBL_OK;
+  UNUSED(key_sz);
   pipe_action_data_spec_t *act_data_spec =
       unpack_adt_ent_data_ad(move_node->data);
   pipe_act_fn_hdl_t act_fn_hdl = unpack_adt_ent_data_afun_hdl(move_node->data);
 
-  if (!spec_map->spec_htbl) {
-    /* Last byte is to store the information if the entry was sharable.
-     * Sharable entries are first to be replayed.
-     * Non-sharable entries can be reconciled later even if there is an adt
-     * handle mismatch.
-     */
-    rc = adt_spec_map_init(spec_map, key_sz + sizeof(pipe_act_fn_hdl_t) + 1);
-    if (rc != PIPE_SUCCESS) {
-      return rc;
-    }
-  }
-  uint8_t hash_key[key_sz + sizeof(pipe_act_fn_hdl_t) + 1];
-  PIPE_MGR_MEMSET(hash_key, 0, key_sz + sizeof(pipe_act_fn_hdl_t) + 1);
-  form_adt_hash_key(hash_key, act_data_spec, act_fn_hdl, move_node->sharable);
+  uint64_t fp = adt_spec_fp(act_data_spec, act_fn_hdl, move_node->sharable);
+  pipe_mgr_ha_entry_t *matching_entries_head =
+      spec_fp_list_get(spec_map, fp, true);
   pipe_action_spec_t action_spec = {0};
   action_spec.act_data = *act_data_spec;
   pipe_mgr_ha_entry_t *ha_entry =
       form_entry(move_node->entry_hdl, NULL, act_fn_hdl, &action_spec, NULL, 0);
-  sts = bf_hashtbl_insert(spec_map->spec_htbl, ha_entry, hash_key);
-  if (sts != BF_HASHTBL_OK) {
-    LOG_ERROR("%s:%d Error adding adt entry hdl 0x%x to spec map sts 0x%x",
+  if (!matching_entries_head || !ha_entry) {
+    LOG_ERROR("%s:%d Error adding adt entry hdl 0x%x to spec map",
               __func__,
               __LINE__,
-              move_node->entry_hdl,
-              sts);
-    rc = PIPE_UNEXPECTED;
-    goto cleanup;
+              move_node->entry_hdl);
+    destroy_entry(&ha_entry);
+    return PIPE_NO_SYS_RESOURCES;
   }
+  ha_entry->fp = fp;
+  ha_entry->sharable = move_node->sharable;
+  BF_LIST_DLL_AP(matching_entries_head, ha_entry, n, p);
 
-cleanup:
-  return rc;
+  return PIPE_SUCCESS;
 }
 
 static bool compare_resources(pipe_action_spec_t *action_spec1,
@@ -2671,7 +2952,7 @@ struct dump_spec_map_arg {
 };
 void dump_spec_map(void *arg, void *obj) {
   if (!arg || !obj) return;
-  pipe_mgr_ha_entry_t *entry = bf_hashtbl_get_cmp_data(obj);
+  pipe_mgr_ha_entry_t *entry = obj;
   struct dump_spec_map_arg *a = arg;
   if (!entry) return;
   LOG_ERROR("Spec Map Node Start");
@@ -2710,7 +2991,14 @@ static void log_spec_map(pipe_mgr_spec_map_t *spec_map) {
             spec_map->dev_tgt.device_id,
             spec_map->dev_tgt.dev_pipe_id,
             spec_map->mat_tbl_hdl);
-  bf_hashtbl_foreach_fn(spec_map->spec_htbl, dump_spec_map, &arg);
+  unsigned long fp;
+  void *head;
+  bf_map_sts_t msts;
+  for (msts = bf_map_get_first(&spec_map->spec_fp_map, &fp, &head);
+       msts == BF_MAP_OK;
+       msts = bf_map_get_next(&spec_map->spec_fp_map, &fp, &head)) {
+    dump_spec_map(&arg, head);
+  }
 }
 #endif
 /* Lookup a spec and return matching entry handle - caller has to compare the
@@ -2727,14 +3015,8 @@ pipe_status_t pipe_mgr_hitless_ha_lookup_spec(pipe_mgr_spec_map_t *spec_map,
   pipe_mgr_hitless_ent_state_e ha_state = INVALID_MATCH;
 
   if (!match_spec) return PIPE_INVALID_ARG;
-  {
-    uint8_t hash_key[key_sz_f(match_spec)];
-
-    PIPE_MGR_MEMSET(hash_key, 0, key_sz_f(match_spec));
-    form_hash_key(hash_key, match_spec);
-
-    matching_entries_head = bf_hashtbl_search(spec_map->spec_htbl, hash_key);
-  }
+  matching_entries_head =
+      spec_fp_list_get(spec_map, match_spec_fp(match_spec), false);
   /* There is always a dummy node at the head of the list, skip it if we found a
    * match. */
   if (matching_entries_head) {
@@ -2763,6 +3045,12 @@ pipe_status_t pipe_mgr_hitless_ha_lookup_spec(pipe_mgr_spec_map_t *spec_map,
       continue;
     }
 
+    /* Entries with different specs may share the fingerprint. */
+    if (!match_spec_equal(match_spec,
+                          unpack_mat_ent_data_ms(entry->mn->data))) {
+      continue;
+    }
+
     /* At least the action function handle should match */
     if (unpack_mat_ent_data_afun_hdl(entry->mn->data) != act_fn_hdl) {
       l_ha_state = ACTION_DATA_MISS;
@@ -2928,6 +3216,32 @@ dump_spec_on_error : {
 }
 }
 
+/* Remove an entry with the given action data from the spec map. */
+static pipe_mgr_ha_entry_t *adt_spec_get_remove(
+    pipe_mgr_spec_map_t *spec_map,
+    pipe_action_data_spec_t *act_data_spec,
+    pipe_act_fn_hdl_t act_fn_hdl,
+    bool sharable) {
+  pipe_mgr_ha_entry_t *head = spec_fp_list_get(
+      spec_map, adt_spec_fp(act_data_spec, act_fn_hdl, sharable), false);
+  if (!head) return NULL;
+
+  pipe_mgr_ha_entry_t *entry;
+  for (entry = head->n; entry; entry = entry->n) {
+    pipe_action_data_spec_t *ad = &entry->action_spec->act_data;
+    if (entry->sharable != sharable || entry->act_fn_hdl != act_fn_hdl ||
+        ad->num_action_data_bytes != act_data_spec->num_action_data_bytes ||
+        memcmp(ad->action_data_bits,
+               act_data_spec->action_data_bits,
+               ad->num_action_data_bytes)) {
+      continue;
+    }
+    BF_LIST_DLL_REM(head, entry, n, p);
+    return entry;
+  }
+  return NULL;
+}
+
 pipe_status_t pipe_mgr_hitless_ha_lookup_adt_spec(
     pipe_mgr_spec_map_t *spec_map,
     pipe_action_data_spec_t *act_data_spec,
@@ -2935,17 +3249,13 @@ pipe_status_t pipe_mgr_hitless_ha_lookup_adt_spec(
     pipe_ent_hdl_t new_entry_hdl,
     pipe_ent_hdl_t *entry_hdl_p,
     uint32_t key_sz) {
+  UNUSED(key_sz);
   pipe_mgr_ha_entry_t *ha_entry = NULL;
-  uint8_t hash_key[key_sz + sizeof(pipe_act_fn_hdl_t) + 1];
-  PIPE_MGR_MEMSET(
-      hash_key, 0, sizeof(uint8_t) * (key_sz + sizeof(pipe_act_fn_hdl_t)));
 
   /* First try to remove sharable entry. */
-  form_adt_hash_key(hash_key, act_data_spec, act_fn_hdl, true);
-  ha_entry = bf_hashtbl_get_remove(spec_map->spec_htbl, hash_key);
+  ha_entry = adt_spec_get_remove(spec_map, act_data_spec, act_fn_hdl, true);
   if (ha_entry) goto cleanup;
-  form_adt_hash_key(hash_key, act_data_spec, act_fn_hdl, false);
-  ha_entry = bf_hashtbl_get_remove(spec_map->spec_htbl, hash_key);
+  ha_entry = adt_spec_get_remove(spec_map, act_data_spec, act_fn_hdl, false);
   if (!ha_entry) {
     pipe_action_spec_t action_spec = {0};
     action_spec.act_data = *act_data_spec;
@@ -2986,6 +3296,7 @@ static void generate_ha_reconc_report(pipe_mgr_spec_map_t *spec_map,
   ha_report->num_entries_added = 0;
   ha_report->num_entries_deleted = 0;
   ha_report->num_entries_modified = 0;
+  ha_report->num_entries_matched = 0;
 
   count = 0;
   for (entry = spec_map->to_add_list; entry; entry = entry->np) {
@@ -3004,6 +3315,22 @@ static void generate_ha_reconc_report(pipe_mgr_spec_map_t *spec_map,
     count++;
   }
   ha_report->num_entries_modified = count;
+
+  count = 0;
+  for (entry = spec_map->full_match_list; entry; entry = entry->np) {
+    count++;
+  }
+  ha_report->num_entries_matched = count;
+
+  LOG_DBG("Dev %d pipe %x tbl 0x%x HA reconcile matched %u added %u "
+          "deleted %u modified %u",
+          spec_map->dev_tgt.device_id,
+          spec_map->dev_tgt.dev_pipe_id,
+          spec_map->mat_tbl_hdl,
+          ha_report->num_entries_matched,
+          ha_report->num_entries_added,
+          ha_report->num_entries_deleted,
+          ha_report->num_entries_modified);
 }
 
 /* VK Need routines to iterate over the remaining entries */
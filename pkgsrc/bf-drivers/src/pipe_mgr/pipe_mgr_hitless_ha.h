@@ -77,6 +77,10 @@ typedef struct pipe_mgr_hitless_entry_s {
   struct pipe_mgr_hitless_entry_s *np;
   struct pipe_mgr_hitless_entry_s *pp;
   pipe_mgr_hitless_ent_state_e ha_state;
+  /* Fingerprint of the spec, see match_spec_fp and adt_spec_fp. */
+  uint64_t fp;
+  /* Action table entries only, whether the entry was sharable. */
+  bool sharable;
   pipe_mgr_move_list_t *mn;
   /* If mn is NULL, the parameters will be stored in the below variables */
   pipe_ent_hdl_t entry_hdl;
@@ -86,10 +90,52 @@ typedef struct pipe_mgr_hitless_entry_s {
   uint32_t ttl;
 } pipe_mgr_ha_entry_t;
 
+/* Phases of a hitless HA restart, timed per device. */
+typedef enum pipe_mgr_hitless_ha_phase_e {
+  PIPE_MGR_HA_PHASE_HW_READ,       // Issue the read back of all tables
+  PIPE_MGR_HA_PHASE_HW_READ_CMPLT, // Wait for the read back to complete
+  PIPE_MGR_HA_PHASE_LLP_RESTORE,   // Restore LLP state from hardware
+  PIPE_MGR_HA_PHASE_HLP_RESTORE,   // Restore HLP state from the LLP
+  PIPE_MGR_HA_PHASE_COMPUTE_DELTA, // Reconcile the replayed config
+  PIPE_MGR_HA_PHASE_PUSH_DELTA,    // Push the delta changes
+  PIPE_MGR_HA_PHASE_CNT
+} pipe_mgr_hitless_ha_phase_e;
+
+static inline const char *pipe_mgr_hitless_ha_phase_name(
+    pipe_mgr_hitless_ha_phase_e e) {
+  switch (e) {
+    case PIPE_MGR_HA_PHASE_HW_READ:
+      return "hw_read";
+    case PIPE_MGR_HA_PHASE_HW_READ_CMPLT:
+      return "hw_read_cmplt";
+    case PIPE_MGR_HA_PHASE_LLP_RESTORE:
+      return "llp_restore";
+    case PIPE_MGR_HA_PHASE_HLP_RESTORE:
+      return "hlp_restore";
+    case PIPE_MGR_HA_PHASE_COMPUTE_DELTA:
+      return "compute_delta";
+    case PIPE_MGR_HA_PHASE_PUSH_DELTA:
+      return "push_delta";
+    case PIPE_MGR_HA_PHASE_CNT:
+      break;
+  }
+  return "Unknown";
+}
+
 typedef struct pipe_mgr_hitless_ha_ctx_ {
   bf_map_t saved_ml;
+  /* Duration of each phase of the last hitless restart, in microseconds. */
+  uint64_t phase_us[PIPE_MGR_HA_PHASE_CNT];
 } pipe_mgr_hitless_ha_ctx_t;
 
+/* Number of threads restoring table state in parallel, zero to use one per
+ * online CPU (up to 8). */
+void pipe_mgr_hitless_ha_num_workers_set(uint32_t num_workers);
+uint32_t pipe_mgr_hitless_ha_num_workers_get(void);
+
+uint64_t pipe_mgr_hitless_ha_phase_time_get(bf_dev_id_t dev_id,
+                                            pipe_mgr_hitless_ha_phase_e phase);
+
 typedef pipe_status_t (*pipe_mgr_entry_place_with_hdl_fn)(
     dev_target_t dev_tgt,
     pipe_mat_tbl_hdl_t mat_tbl_hdl,
@@ -124,9 +170,9 @@ typedef pipe_status_t (*pipe_mgr_entry_update_fn)(
     pipe_mgr_move_list_t *move_list_node,
     pipe_mgr_move_list_t **move_head_p);
 
-/* Hash tables for storing the spec-entry handles */
+/* Entries read back from hardware keyed by the fingerprint of their spec */
 typedef struct pipe_mgr_spec_map_s {
-  bf_hashtable_t *spec_htbl;
+  bf_map_t spec_fp_map;
   pipe_mgr_ha_entry_t *full_match_list;
   pipe_mgr_ha_entry_t *to_add_list;
   pipe_mgr_ha_entry_t *to_modify_list;
@@ -5851,6 +5851,57 @@ pipe_status_t pipe_mgr_sel_grp_mbrs_set(pipe_sess_hdl_t sess_hdl,
   return ret;
 }
 
+/*!
+ * API function to set a weighted membership of a group
+ */
+pipe_status_t pipe_mgr_sel_grp_mbrs_set_with_weights(
+    pipe_sess_hdl_t sess_hdl,
+    bf_dev_id_t device_id,
+    pipe_sel_tbl_hdl_t sel_tbl_hdl,
+    pipe_sel_grp_hdl_t sel_grp_hdl,
+    uint32_t num_mbrs,
+    pipe_adt_ent_hdl_t *mbrs,
+    uint32_t *weights,
+    bool *enable,
+    uint32_t max_slots,
+    pipe_sel_grp_weight_report_t *report,
+    uint32_t pipe_api_flags) {
+  dev_target_t dev_tgt;
+
+  dev_tgt.device_id = device_id;
+  dev_tgt.dev_pipe_id = num_mbrs ? PIPE_GET_HDL_PIPE(mbrs[0]) : 0;
+
+  pipe_status_t ret = ml_api_prologue_v2(sess_hdl, dev_tgt, sel_tbl_hdl);
+  if (PIPE_SUCCESS != ret) return ret;
+
+  /* Prepare flags for the table manager. */
+  uint32_t flags = pipe_mgr_sess_in_txn(sess_hdl) ? PIPE_MGR_TBL_API_TXN : 0;
+  flags |= pipe_mgr_sess_in_atomic_txn(sess_hdl) ? PIPE_MGR_TBL_API_ATOM : 0;
+
+  /* Issue the placement function. */
+  pipe_mgr_sel_move_list_t *move_list = NULL;
+  ret = rmt_sel_grp_mbrs_set_weighted(sess_hdl,
+                                      device_id,
+                                      sel_tbl_hdl,
+                                      sel_grp_hdl,
+                                      num_mbrs,
+                                      mbrs,
+                                      weights,
+                                      enable,
+                                      max_slots,
+                                      report,
+                                      flags,
+                                      &move_list);
+
+  ret = ml_api_fin(sess_hdl,
+                   ret,
+                   pipe_api_flags,
+                   device_id,
+                   sel_tbl_hdl,
+                   (pipe_mgr_move_list_t *)move_list);
+  return ret;
+}
+
 /*!
  * API function to get membership of a group
  */
@@ -5968,6 +6019,69 @@ pipe_status_t pipe_mgr_sel_grp_mbr_enable(pipe_sess_hdl_t sess_hdl,
   return ret;
 }
 
+/*!
+ * API function to tag a member of the action profile used by a selection
+ * table.
+ */
+pipe_status_t pipe_mgr_sel_mbr_tag_set(pipe_sess_hdl_t sess_hdl,
+                                       bf_dev_id_t device_id,
+                                       pipe_sel_tbl_hdl_t sel_tbl_hdl,
+                                       pipe_adt_ent_hdl_t adt_ent_hdl,
+                                       uint32_t tag) {
+  RMT_API(
+      sess_hdl,
+      0,
+      pipe_mgr_verify_tbl_access(sess_hdl, device_id, sel_tbl_hdl, true),
+      rmt_sel_mbr_tag_set(sess_hdl, device_id, sel_tbl_hdl, adt_ent_hdl, tag));
+}
+
+/* API function to remove the tag of a member */
+pipe_status_t pipe_mgr_sel_mbr_tag_clear(pipe_sess_hdl_t sess_hdl,
+                                         bf_dev_id_t device_id,
+                                         pipe_sel_tbl_hdl_t sel_tbl_hdl,
+                                         pipe_adt_ent_hdl_t adt_ent_hdl) {
+  RMT_API(sess_hdl,
+          0,
+          pipe_mgr_verify_tbl_access(sess_hdl, device_id, sel_tbl_hdl, true),
+          rmt_sel_mbr_tag_clear(sess_hdl, device_id, sel_tbl_hdl, adt_ent_hdl));
+}
+
+/* API function to disable or re-enable the members with a tag in all the
+ * groups of a selection table */
+pipe_status_t pipe_mgr_sel_tag_mbrs_state_set(pipe_sess_hdl_t sess_hdl,
+                                              bf_dev_id_t device_id,
+                                              pipe_sel_tbl_hdl_t sel_tbl_hdl,
+                                              uint32_t tag,
+                                              bool enable,
+                                              uint32_t *num_updated,
+                                              uint32_t pipe_api_flags) {
+  pipe_status_t ret = ml_api_prologue(sess_hdl, device_id, sel_tbl_hdl);
+  if (PIPE_SUCCESS != ret) return ret;
+
+  /* Prepare flags for the table manager. */
+  uint32_t flags = pipe_mgr_sess_in_txn(sess_hdl) ? PIPE_MGR_TBL_API_TXN : 0;
+  flags |= pipe_mgr_sess_in_atomic_txn(sess_hdl) ? PIPE_MGR_TBL_API_ATOM : 0;
+
+  /* Issue the placement function, one move list covers all the groups. */
+  pipe_mgr_sel_move_list_t *move_list = NULL;
+  ret = rmt_sel_tag_mbrs_state_set(sess_hdl,
+                                   device_id,
+                                   sel_tbl_hdl,
+                                   tag,
+                                   enable,
+                                   flags,
+                                   num_updated,
+                                   &move_list);
+
+  ret = ml_api_fin(sess_hdl,
+                   ret,
+                   pipe_api_flags,
+                   device_id,
+                   sel_tbl_hdl,
+                   (pipe_mgr_move_list_t *)move_list);
+  return ret;
+}
+
 /* API function to get the current state of a selection member */
 pipe_status_t pipe_mgr_sel_grp_mbr_state_get(
     pipe_sess_hdl_t sess_hdl,
@@ -6317,6 +6431,9 @@ pipe_status_t pipe_mgr_adt_ent_del(pipe_sess_hdl_t sess_hdl,
   pipe_mgr_adt_move_list_t *move_list = NULL;
   ret = pipe_mgr_adt_mgr_ent_del(
       device_id, adt_tbl_hdl, adt_ent_hdl, flags, &move_list);
+  /* A deleted member loses its selector tags, its handle can be reused. */
+  if (ret == PIPE_SUCCESS)
+    rmt_sel_adt_ent_del_tag_clear(device_id, adt_tbl_hdl, adt_ent_hdl);
 
   ret = ml_api_fin(sess_hdl,
                    ret,
@@ -7157,6 +7274,83 @@ pipe_status_t pipe_mgr_wred_ent_set(pipe_sess_hdl_t sess_hdl,
   return ret;
 }
 
+/* API to update a range of meter entries */
+pipe_status_t pipe_mgr_meter_ent_set_range(pipe_sess_hdl_t sess_hdl,
+                                           dev_target_t dev_tgt,
+                                           pipe_meter_tbl_hdl_t meter_tbl_hdl,
+                                           pipe_meter_idx_t first_idx,
+                                           uint32_t num_entries,
+                                           pipe_meter_spec_t *meter_specs,
+                                           uint32_t num_specs,
+                                           uint32_t pipe_api_flags) {
+  pipe_status_t ret = ml_api_prologue_v2(sess_hdl, dev_tgt, meter_tbl_hdl);
+  if (PIPE_SUCCESS != ret) return ret;
+
+  struct pipe_mgr_meter_op_list_t *l = NULL;
+  ret = pipe_mgr_meter_mgr_meter_ent_set_range(dev_tgt,
+                                               meter_tbl_hdl,
+                                               first_idx,
+                                               num_entries,
+                                               meter_specs,
+                                               num_specs,
+                                               &l);
+  ret = ml_api_fin(sess_hdl,
+                   ret,
+                   pipe_api_flags,
+                   dev_tgt.device_id,
+                   meter_tbl_hdl,
+                   (pipe_mgr_move_list_t *)l);
+  return ret;
+}
+
+/* API to update a range of LPF entries */
+pipe_status_t pipe_mgr_lpf_ent_set_range(pipe_sess_hdl_t sess_hdl,
+                                         dev_target_t dev_tgt,
+                                         pipe_lpf_tbl_hdl_t lpf_tbl_hdl,
+                                         pipe_lpf_idx_t first_idx,
+                                         uint32_t num_entries,
+                                         pipe_lpf_spec_t *lpf_specs,
+                                         uint32_t num_specs,
+                                         uint32_t pipe_api_flags) {
+  pipe_status_t ret = ml_api_prologue_v2(sess_hdl, dev_tgt, lpf_tbl_hdl);
+  if (PIPE_SUCCESS != ret) return ret;
+
+  struct pipe_mgr_meter_op_list_t *l = NULL;
+  ret = pipe_mgr_meter_mgr_lpf_ent_set_range(
+      dev_tgt, lpf_tbl_hdl, first_idx, num_entries, lpf_specs, num_specs, &l);
+  ret = ml_api_fin(sess_hdl,
+                   ret,
+                   pipe_api_flags,
+                   dev_tgt.device_id,
+                   lpf_tbl_hdl,
+                   (pipe_mgr_move_list_t *)l);
+  return ret;
+}
+
+/* API to update a range of RED entries */
+pipe_status_t pipe_mgr_wred_ent_set_range(pipe_sess_hdl_t sess_hdl,
+                                          dev_target_t dev_tgt,
+                                          pipe_wred_tbl_hdl_t wred_tbl_hdl,
+                                          pipe_wred_idx_t first_idx,
+                                          uint32_t num_entries,
+                                          pipe_wred_spec_t *wred_specs,
+                                          uint32_t num_specs,
+                                          uint32_t pipe_api_flags) {
+  pipe_status_t ret = ml_api_prologue_v2(sess_hdl, dev_tgt, wred_tbl_hdl);
+  if (PIPE_SUCCESS != ret) return ret;
+
+  struct pipe_mgr_meter_op_list_t *l = NULL;
+  ret = pipe_mgr_meter_mgr_wred_ent_set_range(
+      dev_tgt, wred_tbl_hdl, first_idx, num_entries, wred_specs, num_specs, &l);
+  ret = ml_api_fin(sess_hdl,
+                   ret,
+                   pipe_api_flags,
+                   dev_tgt.device_id,
+                   wred_tbl_hdl,
+                   (pipe_mgr_move_list_t *)l);
+  return ret;
+}
+
 /* API to set the time that the model sees, purely for testing purposes. */
 pipe_status_t pipe_mgr_model_time_advance(pipe_sess_hdl_t sess_hdl,
                                           bf_dev_id_t device_id,
@@ -8501,6 +8695,47 @@ pipe_status_t pipe_stful_database_sync(pipe_sess_hdl_t sess_hdl,
           sess_hdl, dev_tgt, stful_tbl_hdl, cback_fn, cookie));
 }
 
+pipe_status_t pipe_stful_export_create(pipe_sess_hdl_t sess_hdl,
+                                       dev_target_t dev_tgt,
+                                       pipe_stful_tbl_hdl_t stful_tbl_hdl,
+                                       pipe_stful_export_mode_e mode,
+                                       pipe_stful_export_cback_fn cback_fn,
+                                       void *cookie,
+                                       pipe_stful_export_t **export_p) {
+  uint32_t pipe_api_flags = 0;
+  dev_target_t tmp_tgt = {dev_tgt.device_id, BF_DEV_PIPE_ALL};
+
+  RMT_API(
+      sess_hdl,
+      pipe_api_flags,
+      pipe_mgr_verify_pipe_tbl_access(sess_hdl, tmp_tgt, stful_tbl_hdl, true),
+      pipe_mgr_stful_export_create(
+          dev_tgt, stful_tbl_hdl, mode, cback_fn, cookie, export_p));
+}
+
+pipe_status_t pipe_stful_export_poll(pipe_sess_hdl_t sess_hdl,
+                                     pipe_stful_export_t *exp) {
+  uint32_t pipe_api_flags = 0;
+  if (!exp) return PIPE_INVALID_ARG;
+
+  /* Polling syncs the whole table so take the same table level lock as
+   * pipe_stful_database_sync. */
+  dev_target_t tmp_tgt = {exp->dev_tgt.device_id, BF_DEV_PIPE_ALL};
+
+  RMT_API(sess_hdl,
+          pipe_api_flags,
+          pipe_mgr_verify_pipe_tbl_access(sess_hdl, tmp_tgt, exp->hdl, true),
+          pipe_mgr_stful_export_poll(sess_hdl, exp));
+}
+
+pipe_status_t pipe_stful_export_destroy(pipe_stful_export_t *exp) {
+  if (!exp) return PIPE_INVALID_ARG;
+  /* No API or table lock is taken, a destroy may come from the export's own
+   * report callback which runs under them.  The export's mutex serializes it
+   * with the completion of a poll instead. */
+  return pipe_mgr_stful_export_destroy(exp);
+}
+
 pipe_status_t pipe_stful_direct_database_sync(
     pipe_sess_hdl_t sess_hdl,
     dev_target_t dev_tgt,
@@ -60,6 +60,22 @@ static void get_color_ram_init_data(pipe_meter_stage_idx_t meter_stage_idx,
   return;
 }
 
+/* Same as get_color_ram_init_data but covers num_subwords consecutive color
+ * entries of one MAP RAM line, starting at the entry of meter_stage_idx. */
+static void get_color_ram_range_data(pipe_meter_stage_idx_t meter_stage_idx,
+                                     uint32_t num_subwords,
+                                     uint32_t *color_ram_data,
+                                     uint32_t color_val) {
+  uint8_t subword = meter_stage_idx % 4;
+  uint32_t write_mask = 0xffff;
+  uint16_t data = 0;
+  for (uint32_t i = 0; i < num_subwords && subword + i < 4; ++i) {
+    write_mask &= ~(0x3 << ((subword + i) * 2));
+    data |= color_val << ((subword + i) * 2);
+  }
+  *color_ram_data = (write_mask << TOF_MAP_RAM_UNIT_WIDTH) | data;
+}
+
 static void is_max_rate_spec(pipe_mgr_meter_tbl_t *meter_tbl,
                              pipe_meter_spec_t *spec,
                              bool *c_all_green,
@@ -823,6 +839,226 @@ pipe_status_t pipe_mgr_wred_spec_update_drv_workflow(
   return PIPE_SUCCESS;
 }
 
+static size_t meter_spec_size(pipe_meter_impl_type_e type) {
+  switch (type) {
+    case PIPE_METER_TYPE_STANDARD:
+      return sizeof(pipe_meter_spec_t);
+    case PIPE_METER_TYPE_LPF:
+      return sizeof(pipe_lpf_spec_t);
+    case PIPE_METER_TYPE_WRED:
+      return sizeof(pipe_wred_spec_t);
+  }
+  return 0;
+}
+
+/* Encode a meter, LPF or WRED spec, reusing the result of an earlier call
+ * when the same spec is found in the cache. */
+static pipe_status_t meter_encode_cached(bf_dev_id_t device_id,
+                                         pipe_mgr_meter_tbl_t *meter_tbl,
+                                         pipe_meter_impl_type_e type,
+                                         void *spec,
+                                         pipe_mgr_meter_encode_cache_t *cache,
+                                         rmt_ram_line_t *ram_line) {
+  pipe_status_t status = PIPE_SUCCESS;
+  size_t spec_sz = meter_spec_size(type);
+  if (!spec_sz) return PIPE_INVALID_ARG;
+
+  if (cache) {
+    for (uint32_t i = 0; i < cache->num_valid; ++i) {
+      if (cache->ent[i].type != type) continue;
+      if (PIPE_MGR_MEMCMP(&cache->ent[i].spec, spec, spec_sz)) continue;
+      PIPE_MGR_MEMCPY(*ram_line, cache->ent[i].ram_line, sizeof *ram_line);
+      return PIPE_SUCCESS;
+    }
+  }
+
+  PIPE_MGR_MEMSET(*ram_line, 0, sizeof *ram_line);
+  switch (type) {
+    case PIPE_METER_TYPE_STANDARD:
+      status = pipe_mgr_meter_tof_encode_meter_spec(
+          device_id, meter_tbl, (pipe_meter_spec_t *)spec, ram_line);
+      break;
+    case PIPE_METER_TYPE_LPF:
+      status = pipe_mgr_meter_tof_encode_lpf_spec(
+          device_id, (pipe_lpf_spec_t *)spec, ram_line);
+      break;
+    case PIPE_METER_TYPE_WRED:
+      status = pipe_mgr_meter_tof_encode_wred_spec(
+          device_id, (pipe_wred_spec_t *)spec, ram_line);
+      break;
+  }
+  if (status != PIPE_SUCCESS) {
+    LOG_ERROR("%s:%d Error in encoding %s spec for tbl 0x%x. Error %s",
+              __func__,
+              __LINE__,
+              type == PIPE_METER_TYPE_STANDARD
+                  ? "meter"
+                  : (type == PIPE_METER_TYPE_LPF ? "LPF" : "WRED"),
+              meter_tbl->meter_tbl_hdl,
+              pipe_str_err(status));
+    return status;
+  }
+
+  if (cache) {
+    /* Replace the oldest entry once the cache is full. */
+    pipe_mgr_meter_encode_cache_ent_t *e = &cache->ent[cache->next];
+    cache->next = (cache->next + 1) % PIPE_MGR_METER_ENCODE_CACHE_SIZE;
+    if (cache->num_valid < PIPE_MGR_METER_ENCODE_CACHE_SIZE) cache->num_valid++;
+    PIPE_MGR_MEMSET(&e->spec, 0, sizeof e->spec);
+    PIPE_MGR_MEMCPY(&e->spec, spec, spec_sz);
+    e->type = type;
+    PIPE_MGR_MEMCPY(e->ram_line, *ram_line, sizeof e->ram_line);
+  }
+  return PIPE_SUCCESS;
+}
+
+pipe_status_t pipe_mgr_meter_range_update_drv_workflow(
+    pipe_sess_hdl_t sess_hdl,
+    bf_dev_id_t device_id,
+    pipe_mgr_meter_tbl_t *meter_tbl,
+    pipe_bitmap_t pipe_bmp,
+    pipe_mgr_meter_tbl_stage_info_t *meter_tbl_stage_info,
+    pipe_meter_impl_type_e type,
+    void *spec,
+    pipe_meter_stage_idx_t meter_stage_idx,
+    uint32_t count,
+    pipe_mgr_meter_encode_cache_t *cache) {
+  pipe_status_t status = PIPE_SUCCESS;
+  pipe_mgr_meter_ram_alloc_info_t *ram_alloc_info =
+      meter_tbl_stage_info->ram_alloc_info;
+  uint8_t ltbl_id = meter_tbl_stage_info->stage_table_handle;
+  uint8_t stage_id = meter_tbl_stage_info->stage_id;
+  rmt_ram_line_t ram_line;
+  bf_dev_pipe_t pipe_id;
+  uint32_t i;
+
+  if (!count) return PIPE_SUCCESS;
+  if (meter_stage_idx + count > meter_tbl_stage_info->num_entries) {
+    LOG_ERROR("%s:%d Meter tbl 0x%x stage %d range %d+%d exceeds %d entries",
+              __func__,
+              __LINE__,
+              meter_tbl->meter_tbl_hdl,
+              stage_id,
+              meter_stage_idx,
+              count,
+              meter_tbl_stage_info->num_entries);
+    return PIPE_INVALID_ARG;
+  }
+
+  /* The whole range shares one spec, encode it once. */
+  status = meter_encode_cached(
+      device_id, meter_tbl, type, spec, cache, &ram_line);
+  if (status != PIPE_SUCCESS) return status;
+
+  if (type == PIPE_METER_TYPE_STANDARD) {
+    /* Initialize the color MAP RAM, there are four color entries per MAP RAM
+     * line so a single masked write covers up to four meters of the range. */
+    bool c_all_red, p_all_red;
+    is_zero_rate_spec((pipe_meter_spec_t *)spec, &c_all_red, &p_all_red);
+    uint32_t color = c_all_red ? (p_all_red ? 3 : 1) : 0;
+    uint32_t n = 0;
+    for (i = 0; i < count; i += n) {
+      pipe_meter_stage_idx_t idx = meter_stage_idx + i;
+      pipe_instr_set_memdata_i_only_t p_instr;
+      uint32_t color_map_ram_data = 0;
+      n = 4 - (idx % 4);
+      if (n > count - i) n = count - i;
+      get_color_ram_range_data(idx, n, &color_map_ram_data, color);
+
+      uint32_t map_ram_line = (idx / 4) % TOF_MAP_RAM_UNIT_DEPTH;
+      uint32_t blk_idx = idx / (4 * TOF_MAP_RAM_UNIT_DEPTH);
+      mem_id_t mem_id = ram_alloc_info->color_tbl_word_blk[blk_idx].mem_id[0];
+      construct_instr_set_memdata_no_data(device_id,
+                                          &p_instr,
+                                          4,
+                                          mem_id,
+                                          meter_tbl->direction,
+                                          stage_id,
+                                          map_ram_line,
+                                          pipe_mem_type_map_ram);
+      status = pipe_mgr_drv_ilist_add_2(&sess_hdl,
+                                        meter_tbl->dev_info,
+                                        &pipe_bmp,
+                                        stage_id,
+                                        (uint8_t *)&p_instr,
+                                        sizeof(pipe_instr_set_memdata_i_only_t),
+                                        (uint8_t *)&color_map_ram_data,
+                                        4);
+      if (status != PIPE_SUCCESS) {
+        LOG_ERROR("%s:%d Error in ilist add, err %s",
+                  __func__,
+                  __LINE__,
+                  pipe_str_err(status));
+        return status;
+      }
+    }
+  }
+
+  if (meter_tbl->symmetric) {
+    pipe_id = meter_tbl->lowest_pipe_id;
+  } else {
+    pipe_id = PIPE_BITMAP_GET_FIRST_SET(&pipe_bmp);
+  }
+
+  for (i = 0; i < count; ++i) {
+    pipe_meter_stage_idx_t idx = meter_stage_idx + i;
+    uint32_t blk_idx = idx / TOF_SRAM_UNIT_DEPTH;
+    uint32_t ram_line_num = idx % TOF_SRAM_UNIT_DEPTH;
+    vpn_id_t vpn = ram_alloc_info->tbl_word_blk[blk_idx].vpn_id[0];
+    mem_id_t ram_id = ram_alloc_info->tbl_word_blk[blk_idx].mem_id[0];
+    pipe_instr_set_memdata_v_t instr;
+
+    /* Meter RAM lines are written through their virtual address so that the
+     * update is serialized with the meter ALU, which keeps rewriting the
+     * bucket levels of live entries. */
+    construct_instr_set_v_memdata(
+        device_id,
+        &instr,
+        (uint8_t *)ram_line,
+        sizeof(rmt_ram_line_t),
+        ltbl_id,
+        pipe_virt_mem_type_meter,
+        pipe_mgr_meter_compute_ent_virt_addr(vpn, ram_line_num));
+    status = pipe_mgr_drv_ilist_add(&sess_hdl,
+                                    meter_tbl->dev_info,
+                                    &pipe_bmp,
+                                    stage_id,
+                                    (uint8_t *)&instr,
+                                    sizeof(pipe_instr_set_memdata_v_t));
+    if (status != PIPE_SUCCESS) {
+      LOG_ERROR("%s:%d Error in ilist add, err %s",
+                __func__,
+                __LINE__,
+                pipe_str_err(status));
+      return status;
+    }
+
+    /* Update the shadow memory with the encoded spec */
+    status = pipe_mgr_phy_mem_map_write(device_id,
+                                        meter_tbl->direction,
+                                        pipe_id,
+                                        stage_id,
+                                        pipe_mem_type_unit_ram,
+                                        ram_id,
+                                        ram_line_num,
+                                        (uint8_t *)ram_line,
+                                        NULL);
+    if (status != PIPE_SUCCESS) {
+      LOG_ERROR(
+          "%s:%d Error in updating shadow memory for meter spec for ram id %d"
+          " stage id %d, err %s",
+          __func__,
+          __LINE__,
+          ram_id,
+          stage_id,
+          pipe_str_err(status));
+      return status;
+    }
+  }
+
+  return PIPE_SUCCESS;
+}
+
 pipe_status_t pipe_mgr_meter_max_meter_spec_workflow(
     pipe_sess_hdl_t sess_hdl,
     pipe_mgr_meter_tbl_t *meter_tbl,
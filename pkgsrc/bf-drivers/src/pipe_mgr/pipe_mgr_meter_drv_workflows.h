@@ -168,6 +168,41 @@ pipe_status_t pipe_mgr_wred_spec_update_drv_workflow(
     uint32_t ram_line_num,
     pipe_wred_spec_t *wred_spec);
 
+/* Encoded RAM lines of recently programmed specs, so that operations sharing
+ * a few profiles convert each of them to the hardware format only once. */
+#define PIPE_MGR_METER_ENCODE_CACHE_SIZE 8
+
+typedef struct pipe_mgr_meter_encode_cache_ent_t {
+  pipe_meter_impl_type_e type;
+  union {
+    pipe_meter_spec_t meter_spec;
+    pipe_lpf_spec_t lpf_spec;
+    pipe_wred_spec_t wred_spec;
+  } spec;
+  rmt_ram_line_t ram_line;
+} pipe_mgr_meter_encode_cache_ent_t;
+
+typedef struct pipe_mgr_meter_encode_cache_t {
+  uint32_t num_valid;
+  uint32_t next;
+  pipe_mgr_meter_encode_cache_ent_t ent[PIPE_MGR_METER_ENCODE_CACHE_SIZE];
+} pipe_mgr_meter_encode_cache_t;
+
+/* Program count consecutive entries of one stage, starting at
+ * meter_stage_idx, with the same meter, LPF or WRED spec.  The spec is looked
+ * up in the optional cache before being encoded. */
+pipe_status_t pipe_mgr_meter_range_update_drv_workflow(
+    pipe_sess_hdl_t sess_hdl,
+    bf_dev_id_t device_id,
+    pipe_mgr_meter_tbl_t *meter_tbl,
+    pipe_bitmap_t pipe_bmp,
+    pipe_mgr_meter_tbl_stage_info_t *meter_tbl_stage_info,
+    pipe_meter_impl_type_e type,
+    void *spec,
+    pipe_meter_stage_idx_t meter_stage_idx,
+    uint32_t count,
+    pipe_mgr_meter_encode_cache_t *cache);
+
 pipe_status_t pipe_mgr_meter_max_meter_spec_workflow(
     pipe_sess_hdl_t sess_hdl,
     pipe_mgr_meter_tbl_t *meter_tbl,
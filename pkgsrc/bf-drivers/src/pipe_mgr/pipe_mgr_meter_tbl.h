@@ -97,6 +97,46 @@ pipe_status_t pipe_mgr_meter_mgr_wred_ent_set(
     pipe_wred_spec_t *wred_spec,
     struct pipe_mgr_meter_op_list_t **head_p);
 
+/* APIs to update num_entries consecutive entries starting at first_idx.  The
+ * specs array holds either one spec, used for every entry of the range, or
+ * num_entries specs. */
+pipe_status_t pipe_mgr_meter_mgr_meter_ent_set_range(
+    dev_target_t dev_tgt,
+    pipe_meter_tbl_hdl_t meter_tbl_hdl,
+    pipe_meter_idx_t first_idx,
+    uint32_t num_entries,
+    pipe_meter_spec_t *meter_specs,
+    uint32_t num_specs,
+    struct pipe_mgr_meter_op_list_t **head_p);
+
+pipe_status_t pipe_mgr_meter_mgr_lpf_ent_set_range(
+    dev_target_t dev_tgt,
+    pipe_lpf_tbl_hdl_t lpf_tbl_hdl,
+    pipe_lpf_idx_t first_idx,
+    uint32_t num_entries,
+    pipe_lpf_spec_t *lpf_specs,
+    uint32_t num_specs,
+    struct pipe_mgr_meter_op_list_t **head_p);
+
+pipe_status_t pipe_mgr_meter_mgr_wred_ent_set_range(
+    dev_target_t dev_tgt,
+    pipe_wred_tbl_hdl_t wred_tbl_hdl,
+    pipe_wred_idx_t first_idx,
+    uint32_t num_entries,
+    pipe_wred_spec_t *wred_specs,
+    uint32_t num_specs,
+    struct pipe_mgr_meter_op_list_t **head_p);
+
+/* Number of entries of a range, starting at entry i, which can be programmed
+ * by one operation: at most stage_room entries are left in the stage of entry
+ * i and, unless the range has a single spec, they must share its spec. */
+uint32_t pipe_mgr_meter_range_run_len(const void *specs,
+                                      size_t spec_sz,
+                                      uint32_t num_specs,
+                                      uint32_t num_entries,
+                                      uint32_t i,
+                                      uint32_t stage_room);
+
 pipe_status_t pipe_mgr_meter_process_op_list(
     pipe_sess_hdl_t sess_hdl,
     bf_dev_id_t dev_id,
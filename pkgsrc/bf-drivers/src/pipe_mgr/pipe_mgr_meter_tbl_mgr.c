@@ -51,6 +51,9 @@ typedef struct pipe_mgr_meter_op_list_t {
   bf_dev_pipe_t pipe_id;
   uint8_t stage_id;
   pipe_meter_idx_t meter_stage_idx;
+  /* Number of consecutive stage entries, starting at meter_stage_idx, which
+   * are programmed with the spec. */
+  uint32_t count;
   pipe_meter_data_type_e type;
   union {
     pipe_meter_spec_t meter_spec;
@@ -67,6 +70,7 @@ static pipe_mgr_meter_op_list_t *alloc_meter_op_list(
       PIPE_MGR_MALLOC(sizeof(pipe_mgr_meter_op_list_t));
   if (x) {
     x->next = NULL;
+    x->count = 1;
     x->type = meter_data_type;
     switch (x->type) {
       case METER_DATA_TYPE_METER:
@@ -210,26 +214,28 @@ pipe_status_t pipe_mgr_meter_mgr_meter_reset(
   /*
    * Range of meter IDs is num_entries per stage
    * Loop over all the stages and
-   * Add this meter spec update to a move list.
+   * Add one meter spec update covering the whole stage to a move list.
    */
-  unsigned meter_idx = 0;
   struct pipe_mgr_meter_op_list_t *ml_tail = NULL;
   for (uint8_t stage_idx = 0; stage_idx < meter_tbl_instance->num_stages;
        stage_idx++) {
     pipe_mgr_meter_tbl_stage_info_t *meter_tbl_stage_info;
     meter_tbl_stage_info = &meter_tbl_instance->meter_tbl_stage_info[stage_idx];
     stage_id = meter_tbl_stage_info->stage_id;
-    for (meter_idx = 0; meter_idx < meter_tbl_stage_info->num_entries;
-         meter_idx++) {
-      struct pipe_mgr_meter_op_list_t *op =
-          alloc_meter_op_list(ml_tail, METER_DATA_TYPE_METER, &meter_spec);
-      ml_tail = op;
-      op->pipe_id = dev_tgt.dev_pipe_id;
-      op->stage_id = stage_id;
-      op->meter_stage_idx = meter_idx;
-      if (!(*head_p)) {
-        *head_p = op;
-      }
+    if (!meter_tbl_stage_info->num_entries) continue;
+    struct pipe_mgr_meter_op_list_t *op =
+        alloc_meter_op_list(ml_tail, METER_DATA_TYPE_METER, &meter_spec);
+    if (!op) {
+      pipe_mgr_meter_free_ops(head_p);
+      return PIPE_NO_SYS_RESOURCES;
+    }
+    ml_tail = op;
+    op->pipe_id = dev_tgt.dev_pipe_id;
+    op->stage_id = stage_id;
+    op->meter_stage_idx = 0;
+    op->count = meter_tbl_stage_info->num_entries;
+    if (!(*head_p)) {
+      *head_p = op;
     }
   }
   return PIPE_SUCCESS;
@@ -302,7 +308,8 @@ pipe_status_t pipe_mgr_meter_mgr_meter_ent_set(
         return PIPE_UNEXPECTED;
       }
 
-      meter_stage_idx = meter_idx - meter_tbl_stage_info->ent_idx_offset;
+      /* Like LPF and WRED, the index is the same entry in every stage. */
+      meter_stage_idx = meter_idx;
 
       struct pipe_mgr_meter_op_list_t *op =
           alloc_meter_op_list(ml_tail, METER_DATA_TYPE_METER, meter_spec);
@@ -659,6 +666,213 @@ pipe_status_t pipe_mgr_meter_mgr_wred_ent_set(
   return PIPE_SUCCESS;
 }
 
+uint32_t pipe_mgr_meter_range_run_len(const void *specs,
+                                      size_t spec_sz,
+                                      uint32_t num_specs,
+                                      uint32_t num_entries,
+                                      uint32_t i,
+                                      uint32_t stage_room) {
+  const uint8_t *s = specs;
+  uint32_t n = 1;
+  /* Specs are compared bytewise so a mismatch in padding only costs an extra
+   * encode. */
+  while (i + n < num_entries && n < stage_room &&
+         (num_specs == 1 ||
+          !PIPE_MGR_MEMCMP(s + i * spec_sz, s + (i + n) * spec_sz, spec_sz))) {
+    n++;
+  }
+  return n;
+}
+
+/* Build the operations programming num_entries consecutive indices, starting
+ * at first_idx, of a meter, LPF or WRED table.  specs holds either a single
+ * spec used for the whole range or one spec per index.  Consecutive indices
+ * of a stage which share a spec are merged into one operation so the spec is
+ * only encoded once for them. */
+static pipe_status_t meter_mgr_ent_set_range(
+    dev_target_t dev_tgt,
+    pipe_meter_tbl_hdl_t tbl_hdl,
+    pipe_meter_data_type_e type,
+    pipe_meter_idx_t first_idx,
+    uint32_t num_entries,
+    void *specs,
+    size_t spec_sz,
+    uint32_t num_specs,
+    pipe_mgr_meter_op_list_t **head_p) {
+  pipe_mgr_meter_tbl_t *meter_tbl = NULL;
+  pipe_mgr_meter_tbl_instance_t *meter_tbl_instance = NULL;
+  pipe_mgr_meter_op_list_t *ml_tail = NULL;
+
+  if (!specs || !num_entries || (num_specs != 1 && num_specs != num_entries)) {
+    LOG_ERROR("%s:%d Invalid range of %d entries with %d specs, tbl hdl 0x%x",
+              __func__,
+              __LINE__,
+              num_entries,
+              num_specs,
+              tbl_hdl);
+    return PIPE_INVALID_ARG;
+  }
+
+  meter_tbl = pipe_mgr_meter_tbl_get(dev_tgt.device_id, tbl_hdl);
+  if (meter_tbl == NULL) {
+    LOG_ERROR("%s:%d Meter table not found for device id %d, tbl hdl 0x%x",
+              __func__,
+              __LINE__,
+              dev_tgt.device_id,
+              tbl_hdl);
+    return PIPE_OBJ_NOT_FOUND;
+  }
+
+  if (meter_tbl->type != (pipe_meter_impl_type_e)type) {
+    LOG_ERROR("%s:%d Table 0x%x, device %d is not a %s table",
+              __func__,
+              __LINE__,
+              tbl_hdl,
+              dev_tgt.device_id,
+              type == METER_DATA_TYPE_METER
+                  ? "meter"
+                  : (type == METER_DATA_TYPE_LPF ? "LPF" : "WRED"));
+    return PIPE_INVALID_ARG;
+  }
+
+  meter_tbl_instance =
+      pipe_mgr_meter_tbl_get_instance(meter_tbl, dev_tgt.dev_pipe_id);
+  if (meter_tbl_instance == NULL) {
+    LOG_ERROR(
+        "%s:%d : Meter table instance for tbl 0x%x, device id %d, pipe id %d"
+        " not found",
+        __func__,
+        __LINE__,
+        tbl_hdl,
+        dev_tgt.device_id,
+        dev_tgt.dev_pipe_id);
+    return PIPE_OBJ_NOT_FOUND;
+  }
+
+  if (first_idx >= meter_tbl->num_entries ||
+      num_entries > meter_tbl->num_entries - first_idx) {
+    LOG_ERROR(
+        "Dev %d Meter Tbl 0x%x (%s): requested range %d+%d is out of range, "
+        "only %d entries in table",
+        meter_tbl->dev_info->dev_id,
+        meter_tbl->meter_tbl_hdl,
+        meter_tbl->name,
+        first_idx,
+        num_entries,
+        meter_tbl->num_entries);
+    return PIPE_INVALID_ARG;
+  }
+
+  /* An over allocated table is replicated in every stage and an index is the
+   * same entry of each stage, otherwise each index lives in exactly one
+   * stage. */
+  unsigned num_passes =
+      meter_tbl->over_allocated ? meter_tbl_instance->num_stages : 1;
+  for (unsigned pass = 0; pass < num_passes; ++pass) {
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < num_entries; i += n) {
+      pipe_meter_idx_t idx = first_idx + i;
+      pipe_meter_idx_t stage_idx = idx;
+      pipe_mgr_meter_tbl_stage_info_t *stage_info;
+      if (meter_tbl->over_allocated) {
+        stage_info = &meter_tbl_instance->meter_tbl_stage_info[pass];
+      } else {
+        stage_info = pipe_mgr_meter_tbl_get_stage_info(
+            meter_tbl_instance,
+            pipe_mgr_meter_mgr_get_stage(meter_tbl_instance, idx));
+        if (stage_info) stage_idx = idx - stage_info->ent_idx_offset;
+      }
+      if (!stage_info || stage_idx >= stage_info->num_entries) {
+        PIPE_MGR_DBGCHK(0);
+        pipe_mgr_meter_free_ops(head_p);
+        return PIPE_UNEXPECTED;
+      }
+
+      n = pipe_mgr_meter_range_run_len(specs,
+                                       spec_sz,
+                                       num_specs,
+                                       num_entries,
+                                       i,
+                                       stage_info->num_entries - stage_idx);
+      pipe_mgr_meter_op_list_t *op = alloc_meter_op_list(
+          ml_tail,
+          type,
+          (uint8_t *)specs + (num_specs == 1 ? 0 : i * spec_sz));
+      if (!op) {
+        pipe_mgr_meter_free_ops(head_p);
+        return PIPE_NO_SYS_RESOURCES;
+      }
+      ml_tail = op;
+      op->pipe_id = dev_tgt.dev_pipe_id;
+      op->stage_id = stage_info->stage_id;
+      op->meter_stage_idx = stage_idx;
+      op->count = n;
+      if (!(*head_p)) {
+        *head_p = op;
+      }
+    }
+  }
+
+  return PIPE_SUCCESS;
+}
+
+pipe_status_t pipe_mgr_meter_mgr_meter_ent_set_range(
+    dev_target_t dev_tgt,
+    pipe_meter_tbl_hdl_t meter_tbl_hdl,
+    pipe_meter_idx_t first_idx,
+    uint32_t num_entries,
+    pipe_meter_spec_t *meter_specs,
+    uint32_t num_specs,
+    pipe_mgr_meter_op_list_t **head_p) {
+  return meter_mgr_ent_set_range(dev_tgt,
+                                 meter_tbl_hdl,
+                                 METER_DATA_TYPE_METER,
+                                 first_idx,
+                                 num_entries,
+                                 meter_specs,
+                                 sizeof *meter_specs,
+                                 num_specs,
+                                 head_p);
+}
+
+pipe_status_t pipe_mgr_meter_mgr_lpf_ent_set_range(
+    dev_target_t dev_tgt,
+    pipe_lpf_tbl_hdl_t lpf_tbl_hdl,
+    pipe_lpf_idx_t first_idx,
+    uint32_t num_entries,
+    pipe_lpf_spec_t *lpf_specs,
+    uint32_t num_specs,
+    pipe_mgr_meter_op_list_t **head_p) {
+  return meter_mgr_ent_set_range(dev_tgt,
+                                 lpf_tbl_hdl,
+                                 METER_DATA_TYPE_LPF,
+                                 first_idx,
+                                 num_entries,
+                                 lpf_specs,
+                                 sizeof *lpf_specs,
+                                 num_specs,
+                                 head_p);
+}
+
+pipe_status_t pipe_mgr_meter_mgr_wred_ent_set_range(
+    dev_target_t dev_tgt,
+    pipe_wred_tbl_hdl_t wred_tbl_hdl,
+    pipe_wred_idx_t first_idx,
+    uint32_t num_entries,
+    pipe_wred_spec_t *wred_specs,
+    uint32_t num_specs,
+    pipe_mgr_meter_op_list_t **head_p) {
+  return meter_mgr_ent_set_range(dev_tgt,
+                                 wred_tbl_hdl,
+                                 METER_DATA_TYPE_WRED,
+                                 first_idx,
+                                 num_entries,
+                                 wred_specs,
+                                 sizeof *wred_specs,
+                                 num_specs,
+                                 head_p);
+}
+
 static pipe_status_t save_one_meter_op(
     pipe_mgr_meter_tbl_instance_t *meter_tbl_instance,
     pipe_mgr_meter_op_list_t *op) {
@@ -709,12 +923,11 @@ pipe_status_t pipe_mgr_meter_process_op_list(pipe_sess_hdl_t sess_hdl,
   pipe_mgr_meter_tbl_t *meter_tbl = NULL;
   pipe_mgr_meter_tbl_instance_t *meter_tbl_instance = NULL;
   pipe_mgr_meter_tbl_stage_info_t *meter_tbl_stage_info = NULL;
-  pipe_mgr_meter_ram_alloc_info_t *ram_alloc_info = NULL;
-  uint8_t stage_id = 0;
-  uint32_t blk_idx = 0;
-  vpn_id_t vpn = 0;
-  mem_id_t ram_id = 0;
-  uint32_t ram_line_num = 0;
+  /* Operations of one list usually share a handful of specs, remember their
+   * encodings while the list is processed. */
+  pipe_mgr_meter_encode_cache_t encode_cache;
+  encode_cache.num_valid = 0;
+  encode_cache.next = 0;
 
   meter_tbl = pipe_mgr_meter_tbl_get(dev_id, meter_tbl_hdl);
   if (meter_tbl == NULL) {
@@ -750,74 +963,46 @@ pipe_status_t pipe_mgr_meter_process_op_list(pipe_sess_hdl_t sess_hdl,
           __func__,
           __LINE__,
           meter_tbl_hdl,
-          stage_id);
+          ml->stage_id);
       return PIPE_OBJ_NOT_FOUND;
     }
 
-    if (ml->meter_stage_idx >= meter_tbl_stage_info->num_entries) {
+    if (ml->meter_stage_idx >= meter_tbl_stage_info->num_entries ||
+        ml->count > meter_tbl_stage_info->num_entries - ml->meter_stage_idx) {
       LOG_ERROR(
-          "%s:%d Meter table 0x%x (%s) stage %d requested idx %d out of range, "
-          "stage size %d",
+          "%s:%d Meter table 0x%x (%s) stage %d requested idx %d count %d out "
+          "of range, stage size %d",
           __func__,
           __LINE__,
           meter_tbl_hdl,
           meter_tbl->name,
-          stage_id,
+          ml->stage_id,
           ml->meter_stage_idx,
+          ml->count,
           meter_tbl_stage_info->num_entries);
       return PIPE_INVALID_ARG;
     }
 
     if (pipe_mgr_hitless_warm_init_in_progress(dev_id)) {
-      sts = save_one_meter_op(meter_tbl_instance, ml);
-    } else {
-      ram_alloc_info = meter_tbl_stage_info->ram_alloc_info;
-      blk_idx = ml->meter_stage_idx / TOF_SRAM_UNIT_DEPTH;
-      vpn = ram_alloc_info->tbl_word_blk[blk_idx].vpn_id[0];
-      ram_line_num = ml->meter_stage_idx % TOF_SRAM_UNIT_DEPTH;
-      ram_id = ram_alloc_info->tbl_word_blk[blk_idx].mem_id[0];
-
-      switch (ml->type) {
-        case METER_DATA_TYPE_METER:
-          sts = pipe_mgr_meter_spec_update_drv_workflow(
-              sess_hdl,
-              dev_id,
-              meter_tbl,
-              meter_tbl_instance->pipe_bmp,
-              meter_tbl_stage_info,
-              vpn,
-              ram_id,
-              ram_line_num,
-              ml->meter_stage_idx,
-              &(ml->meter_spec.meter_spec));
-          break;
-        case METER_DATA_TYPE_LPF:
-          sts = pipe_mgr_lpf_spec_update_drv_workflow(
-              sess_hdl,
-              dev_id,
-              meter_tbl,
-              meter_tbl_instance->pipe_bmp,
-              meter_tbl_stage_info->stage_table_handle,
-              meter_tbl_stage_info->stage_id,
-              vpn,
-              ram_id,
-              ram_line_num,
-              &(ml->meter_spec.lpf_spec));
-          break;
-        case METER_DATA_TYPE_WRED:
-          sts = pipe_mgr_wred_spec_update_drv_workflow(
-              sess_hdl,
-              dev_id,
-              meter_tbl,
-              meter_tbl_instance->pipe_bmp,
-              meter_tbl_stage_info->stage_table_handle,
-              meter_tbl_stage_info->stage_id,
-              vpn,
-              ram_id,
-              ram_line_num,
-              &(ml->meter_spec.wred_spec));
-          break;
+      /* Replay is tracked per index, split ranges into single entries. */
+      pipe_mgr_meter_op_list_t one = *ml;
+      one.count = 1;
+      for (uint32_t i = 0; i < ml->count && PIPE_SUCCESS == sts; ++i) {
+        one.meter_stage_idx = ml->meter_stage_idx + i;
+        sts = save_one_meter_op(meter_tbl_instance, &one);
       }
+    } else {
+      sts = pipe_mgr_meter_range_update_drv_workflow(
+          sess_hdl,
+          dev_id,
+          meter_tbl,
+          meter_tbl_instance->pipe_bmp,
+          meter_tbl_stage_info,
+          (pipe_meter_impl_type_e)ml->type,
+          &ml->meter_spec,
+          ml->meter_stage_idx,
+          ml->count,
+          &encode_cache);
     }
 
     if (PIPE_SUCCESS != sts) {
@@ -847,6 +1032,7 @@ static pipe_status_t meter_prog_table_from_replay(
   if (meter_tbl->ref_type == PIPE_TBL_REF_TYPE_DIRECT) return PIPE_SUCCESS;
 
   pipe_mgr_meter_op_list_t dflt = {0};
+  dflt.count = 1;
   dflt.type = (pipe_meter_data_type_e)meter_tbl->type;
   if (meter_tbl->type == PIPE_METER_TYPE_STANDARD) {
     pipe_mgr_meter_get_default_meter_spec(
@@ -26,6 +26,9 @@
 #include <stdint.h>
 #include <unistd.h>
 #include <sched.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/time.h>
 
 #include "pipe_mgr_int.h"
@@ -36,9 +39,8 @@
 
 #define WR_BLK_LEN 20
 #define WR_REG_LEN 12
-#define SCANSET_MIN_LEN 36
-// Should be set to the longest defined
-#define MAX_RECORD_LEN SCANSET_MIN_LEN
+#define PRSR_HDL_LEN 8
+#define HDR_DATA_SZ_MAX 1000000 /* 1MB */
 
 int n_4 = 0;
 int n_8 = 0;
@@ -61,45 +63,189 @@ void pipeline_cfg_progress_bar(void) {
   }
 }
 
+/* A pipeline config file mapped in memory.  Records are parsed in place, the
+ * data of block writes is copied straight from the mapping into the DMA
+ * buffers. */
+typedef struct pipe_mgr_blob_s {
+  const uint8_t *data;
+  size_t size;
+  size_t pos;
+} pipe_mgr_blob_t;
+
+/* State shared by all the records of one pipeline config download. */
+typedef struct pipe_mgr_blob_dnld_s {
+  pipe_sess_hdl_t sess_hdl;
+  pipe_mgr_drv_ses_state_t *st;
+  rmt_dev_info_t *dev_info;
+  profile_id_t prof_id;
+  uint32_t log_pipe_mask;
+  pipe_prsr_instance_hdl_t prsr_hdl;
+  uint32_t prsr_stage;
+  uint32_t dprsr_stage;
+  uint32_t bwr_size;
+  int *stages_configured;
+} pipe_mgr_blob_dnld_t;
+
+static inline uint32_t blob_get32(pipe_mgr_blob_t *blob) {
+  uint32_t val;
+  PIPE_MGR_MEMCPY(&val, blob->data + blob->pos, 4);
+  blob->pos += 4;
+  return le32toh(val);
+}
+
+static inline uint64_t blob_get64(pipe_mgr_blob_t *blob) {
+  uint64_t val;
+  PIPE_MGR_MEMCPY(&val, blob->data + blob->pos, 8);
+  blob->pos += 8;
+  return le64toh(val);
+}
+
+static pipe_status_t blob_map(const char *cfg_file, pipe_mgr_blob_t *blob) {
+  struct stat st;
+  int fd = open(cfg_file, O_RDONLY);
+  if (fd < 0) return PIPE_INVALID_ARG;
+  if (fstat(fd, &st)) {
+    close(fd);
+    return PIPE_INVALID_ARG;
+  }
+  blob->data = NULL;
+  blob->size = 0;
+  blob->pos = 0;
+  if (st.st_size == 0) {
+    /* Nothing to download. */
+    close(fd);
+    return PIPE_SUCCESS;
+  }
+  void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) return PIPE_NO_SYS_RESOURCES;
+  madvise(data, st.st_size, MADV_SEQUENTIAL);
+  blob->data = data;
+  blob->size = st.st_size;
+  return PIPE_SUCCESS;
+}
+
+static void blob_unmap(pipe_mgr_blob_t *blob) {
+  if (blob->data) munmap((void *)blob->data, blob->size);
+  blob->data = NULL;
+  blob->size = 0;
+}
+
+static void blob_dump(bf_dev_id_t dev_id, const pipe_mgr_blob_t *blob) {
+#define BUF_SIZE 1024
+  char eb[BUF_SIZE * 4] = {0};
+  size_t ebp = 0;
+  size_t len = blob->size - blob->pos;
+  if (len > BUF_SIZE) len = BUF_SIZE;
+  for (size_t i = 0; i < len; i++) {
+    if ((i % 16) == 0)
+      ebp += snprintf(&eb[ebp],
+                      sizeof(eb) - ebp,
+                      "\n0x%zx : ",
+                      blob->pos + i);
+    ebp += snprintf(
+        &eb[ebp], sizeof(eb) - ebp, "%02x ", blob->data[blob->pos + i]);
+  }
+  LOG_ERROR("Dev %d pipeline config at 0x%zx:%s", dev_id, blob->pos, eb);
+#undef BUF_SIZE
+}
+
+/* Walk all records of a pipeline config to make sure each one is complete and
+ * well formed before anything is written to the device, so that a truncated
+ * or corrupted file does not leave the pipes partially programmed.  The
+ * download then parses the records without further bounds checks. */
+static pipe_status_t blob_validate(bf_dev_id_t dev_id,
+                                   pipe_mgr_blob_t *blob,
+                                   uint32_t *num_records) {
+  *num_records = 0;
+  blob->pos = 0;
+  while (blob->size - blob->pos >= 4) {
+    size_t start = blob->pos;
+    size_t left = blob->size - start;
+    size_t record_len = 0;
+    uint32_t atom_val = blob_get32(blob);
+    char atom_type = atom_val >> 24;
+
+    switch (atom_type) {
+      case 'H':
+        if (left >= 8) {
+          uint32_t len = blob_get32(blob);
+          /* The size includes the four byte size field. */
+          if (len > 4 && len - 4 <= HDR_DATA_SZ_MAX) record_len = 4 + len;
+        }
+        break;
+      case 'R':
+        record_len = WR_REG_LEN;
+        break;
+      case 'D':
+      case 'B':
+        if (left >= WR_BLK_LEN) {
+          blob->pos += 8;
+          uint32_t width = blob_get32(blob);
+          uint32_t ent = blob_get32(blob);
+          if (width < 8 || width > 128) {
+            LOG_ERROR("%s : Unsupported block write width of %d",
+                      __func__,
+                      width);
+            PIPE_MGR_DBGCHK(0);
+            return PIPE_INVALID_ARG;
+          }
+          record_len = WR_BLK_LEN + (size_t)width / 8 * ent;
+        }
+        break;
+      case 'P':
+        record_len = PRSR_HDL_LEN;
+        break;
+      default:
+        LOG_ERROR("Parse error: atom_val=%x atom_type=(%c)\n",
+                  atom_val,
+                  atom_type);
+        blob->pos = start;
+        blob_dump(dev_id, blob);
+        return PIPE_INVALID_ARG;
+    }
+    if (record_len == 0 || record_len > left) {
+      LOG_ERROR("Incomplete %c record at 0x%zx in pipeline config on dev %d",
+                atom_type,
+                start,
+                dev_id);
+      return PIPE_INVALID_ARG;
+    }
+    blob->pos = start + record_len;
+    ++*num_records;
+  }
+  blob->pos = 0;
+  return PIPE_SUCCESS;
+}
+
 /* Parse a header block encoded in BSON format, see
  * http://bsonspec.org/spec.html for details of the format.
  * Note we only parse a subset of the encoding types since we only use a few
  * types. */
-static inline pipe_status_t blob_hdr_elm(bf_dev_id_t dev_id,
-                                         profile_id_t prof_id,
-                                         uint32_t log_pipe_mask,
-                                         FILE *fd,
-                                         int *num_stages) {
+static inline pipe_status_t blob_hdr_elm(pipe_mgr_blob_dnld_t *dnld,
+                                         pipe_mgr_blob_t *blob) {
+  bf_dev_id_t dev_id = dnld->dev_info->dev_id;
+  profile_id_t prof_id = dnld->prof_id;
+  uint32_t log_pipe_mask = dnld->log_pipe_mask;
   const int string_type = 2;
   const int int32_type = 16;
-  const uint32_t data_sz_max = 1000000; /* 1MB */
   /* The next four bytes is the size of the element. */
   uint32_t len, data_sz;
-  int x = fread((uint8_t *)&len, 4, 1, fd);
-  len = le32toh(len);
+  len = blob_get32(blob);
   /* The data size is four bytes less since the total size includes the four
    * byte size field. */
   data_sz = len - 4;
 
-  /* Make sure the read was good. */
-  if (feof(fd) || ferror(fd) || x != 1) return PIPE_UNEXPECTED;
-  if (data_sz <= 0 || data_sz > data_sz_max) return PIPE_UNEXPECTED;
-
-  /* Get a buffer to hold the data and read it out. */
-  char *buf = PIPE_MGR_CALLOC(data_sz + 5, 1);
-  if (!buf) return PIPE_NO_SYS_RESOURCES;
-  x = fread(buf, data_sz, 1, fd);
-  if (feof(fd) || ferror(fd) || x != 1) {
-    PIPE_MGR_FREE(buf);
-    return PIPE_UNEXPECTED;
-  }
+  /* The data is parsed in place, blob_validate checked that it is complete. */
+  const char *buf = (const char *)blob->data + blob->pos;
+  blob->pos += data_sz;
 
   uint32_t i = 0;
   while (i < data_sz - 1) {
     if (buf[i] == string_type) {
       /* String name followed by a four byte integer followed by a second string
        * value.  The second string has a length equal to the integer value.  */
-      char *field_name = NULL, *field_value = NULL;
+      const char *field_name = NULL, *field_value = NULL;
       uint32_t val_len = 0;
       ++i;
       field_name = buf + i;
@@ -143,7 +289,7 @@ static inline pipe_status_t blob_hdr_elm(bf_dev_id_t dev_id,
 
     } else if (buf[i] == int32_type) {
       /* String name followed by 4 byte integer value. */
-      char *field_name = NULL;
+      const char *field_name = NULL;
       int32_t field_val = 0;
       ++i;
       field_name = buf + i;
@@ -163,7 +309,7 @@ static inline pipe_status_t blob_hdr_elm(bf_dev_id_t dev_id,
       }
 
       if (field_name_len == 6 && !strncmp("stages", field_name, 6)) {
-        *num_stages = field_val;
+        *dnld->stages_configured = field_val;
       }
       LOG_TRACE("Dev %d Profile %d to PipeMask 0x%x Property %s = %d",
                 dev_id,
@@ -175,50 +321,16 @@ static inline pipe_status_t blob_hdr_elm(bf_dev_id_t dev_id,
       return PIPE_UNEXPECTED;
     }
   }
-  PIPE_MGR_FREE(buf);
   return PIPE_SUCCESS;
 }
 
-static int blob_check_len(bf_dev_id_t dev_id, FILE *fd, size_t record_len) {
-  uint8_t fbuf[MAX_RECORD_LEN];
-  if (record_len > MAX_RECORD_LEN) {
-    LOG_ERROR("Unexpected record size %zu", record_len);
-    PIPE_MGR_DBGCHK(0);
-    return -2;
-  }
-
-  /* Back up to read the data out into variables. */
-  if (fseek(fd, -4, SEEK_CUR)) return -2;
-
-  /* Read the entire record out to be sure it is complete. */
-  size_t x = fread(fbuf, 1, record_len, fd);
-  if (feof(fd) || ferror(fd)) {
-    LOG_ERROR("Unexpected EOF while reading pipeline config on dev %d", dev_id);
-    return -2;
-  }
-  if (x != record_len) {
-    LOG_ERROR("Short read while reading pipeline config on dev %d", dev_id);
-    PIPE_MGR_DBGCHK(x == record_len);
-    return -2;
-  }
-
-  /* Now that we know that the full record is in the file back up again to the
-   * initial position, after the four byte header identifying the record type.*/
-  ;
-  if (fseek(fd, (0 - (record_len - 4)), SEEK_CUR)) return -2;
-
-  return 0;
-}
-
 /* Write block of registers handler */
-static int blob_wr_blk(pipe_sess_hdl_t sess_hdl,
-                       rmt_dev_info_t *dev_info,
-                       profile_id_t prof_id,
-                       uint32_t log_pipe_mask,
-                       pipe_prsr_instance_hdl_t prsr_hdl,
-                       FILE *fd,
+static int blob_wr_blk(pipe_mgr_blob_dnld_t *dnld,
+                       pipe_mgr_blob_t *blob,
                        bool is_reg) {
+  rmt_dev_info_t *dev_info = dnld->dev_info;
   bf_dev_id_t dev_id = dev_info->dev_id;
+  uint32_t log_pipe_mask = dnld->log_pipe_mask;
 
   uint32_t ent;
   uint32_t width;
@@ -226,35 +338,14 @@ static int blob_wr_blk(pipe_sess_hdl_t sess_hdl,
 
   /* Get stage info. */
   uint8_t num_mau_stages = dev_info->num_active_mau;
-  uint32_t prsr_stage = 0, dprsr_stage = 0;
-  if (LLD_OK != lld_sku_get_prsr_stage(dev_id, &prsr_stage)) return -2;
-  if (LLD_OK != lld_sku_get_dprsr_stage(dev_id, &dprsr_stage)) return -2;
-
-  if (blob_check_len(dev_id, fd, WR_BLK_LEN)) return -2;
+  uint32_t prsr_stage = dnld->prsr_stage, dprsr_stage = dnld->dprsr_stage;
 
   uint64_t addr, full_addr;
   bool shadowed = false;
-  // uint64_t tmp_addr;
-  size_t x = fread((void *)&addr, 8, 1, fd);  // 64b address
-  addr = le64toh(addr);
-  if (x != 1) {
-    PIPE_MGR_DBGCHK(x == 1);
-    return -2;
-  }
-  x = fread((void *)&width, 4, 1, fd);  // 32b data width
-  width = le32toh(width);
-  if (x != 1) {
-    PIPE_MGR_DBGCHK(x == 1);
-    return -2;
-  }
-  x = fread((void *)&ent, 4, 1, fd);  // 32b number of entries
-  ent = le32toh(ent);
-  if (x != 1) {
-    PIPE_MGR_DBGCHK(x == 1);
-    return -2;
-  }
+  addr = blob_get64(blob);   // 64b address
+  width = blob_get32(blob);  // 32b data width
+  ent = blob_get32(blob);    // 32b number of entries
 
-  if (feof(fd) || ferror(fd)) return -2;
   if (addr == 0ull) {
     LOG_ERROR("Unexpected addr in pipeline config on dev %d", dev_id);
     return -2;
@@ -288,25 +379,8 @@ static int blob_wr_blk(pipe_sess_hdl_t sess_hdl,
   else
     n_other++;
 
-  if (width > 128) {
-    LOG_ERROR("%s : Unsupported block write width of %d", __func__, width);
-    PIPE_MGR_DBGCHK(0);
-    return -2;
-  }
-
-  pipe_mgr_drv_ses_state_t *st =
-      pipe_mgr_drv_get_ses_state(&sess_hdl, __func__, __LINE__);
-  if (!st) {
-    PIPE_MGR_DBGCHK(0);
-    return -2;
-  }
-
   size_t num_bytes = width / 8 * ent;
-  uint32_t bwr_size = pipe_mgr_drv_buf_size(dev_id, PIPE_MGR_DRV_BUF_BWR);
-  if (bwr_size == 0) {
-    PIPE_MGR_DBGCHK(0);
-    return -2;
-  }
+  uint32_t bwr_size = dnld->bwr_size;
 
   uint32_t num_ent_per_write = bwr_size / (width / 8);  // Max possible
   size_t num_writes = num_bytes / bwr_size + ((num_bytes % bwr_size) ? 1 : 0);
@@ -318,23 +392,20 @@ static int blob_wr_blk(pipe_sess_hdl_t sess_hdl,
   uint8_t addr_step = (addr_type == addr_type_register) ? 4 : 1;
   // Following logic assumes that blk write is done to single memory type
   for (size_t wr_nb = 0; wr_nb < num_writes; wr_nb++) {
-    /* Allocate a buffer and read the configuration data into it*/
-    pipe_mgr_drv_buf_t *b = pipe_mgr_drv_buf_alloc(
-        st->sid, dev_id, bwr_size, PIPE_MGR_DRV_BUF_BWR, true);
-    if (!b) {
-      PIPE_MGR_DBGCHK(0);
-      return -2;
-    }
-
     // If remaining entries are less than max, update related variables
     if (num_ent_per_write > ent) num_ent_per_write = ent;
     size_t wr_width = num_ent_per_write * width / 8;
+    const uint8_t *data = blob->data + blob->pos;
+    blob->pos += wr_width;
 
-    x = fread((void *)b->addr, 1, wr_width, fd);
-    if (x != wr_width) {
-      PIPE_MGR_DBGCHK(x == wr_width);
+    /* Allocate a buffer and copy the configuration data into it*/
+    pipe_mgr_drv_buf_t *b = pipe_mgr_drv_buf_alloc(
+        dnld->st->sid, dev_id, bwr_size, PIPE_MGR_DRV_BUF_BWR, true);
+    if (!b) {
+      PIPE_MGR_DBGCHK(0);
       return -2;
     }
+    PIPE_MGR_MEMCPY(b->addr, data, wr_width);
 
     /* Pull the stage id from the full address. */
     uint32_t stage_id = dev_info->dev_cfg.stage_id_from_addr(full_addr);
@@ -361,8 +432,13 @@ static int blob_wr_blk(pipe_sess_hdl_t sess_hdl,
       /* lookup for parser memory contents
          -- ecc correction
          -- prsr programs */
-      pipe_mgr_lookup_cache_parser_bin_cfg(
-          dev_info, prsr_hdl, prof_id, full_addr, b->addr, wr_width, &shadowed);
+      pipe_mgr_lookup_cache_parser_bin_cfg(dev_info,
+                                           dnld->prsr_hdl,
+                                           dnld->prof_id,
+                                           full_addr,
+                                           b->addr,
+                                           wr_width,
+                                           &shadowed);
     }
 
     check_stage = !(stage_id >= num_mau_stages);
@@ -371,29 +447,32 @@ static int blob_wr_blk(pipe_sess_hdl_t sess_hdl,
       /* Debug build with less than the full complement of stages, drop this
        * write as it is to a stage which isn't present. */
       pipe_mgr_drv_buf_free(b);
-    } else {
-      // If data is prsr configuration, it will be configured to hardware in
-      // reconfig(), only not shadowed writes are handled here.
-      if (!shadowed) {
-        pipe_status_t status = pipe_mgr_drv_blk_wr(&sess_hdl,
-                                                   width / 8,
-                                                   num_ent_per_write,
-                                                   addr_step,
-                                                   full_addr,
-                                                   log_pipe_mask,
-                                                   b);
-        if (status != PIPE_SUCCESS) {
-          LOG_ERROR("%s : Write block push in blob download error %s",
-                    __func__,
-                    pipe_str_err(status));
-          PIPE_MGR_DBGCHK(PIPE_SUCCESS == status);
-          return -2;
-        }
-      } else {
-        pipe_mgr_drv_buf_free(b);
+      full_addr += addr_step * num_ent_per_write;
+      ent -= num_ent_per_write;
+      continue;
+    }
+
+    // If data is prsr configuration, it will be configured to hardware in
+    // reconfig(), only not shadowed writes are handled here.
+    if (!shadowed) {
+      pipe_status_t status = pipe_mgr_drv_blk_wr(&dnld->sess_hdl,
+                                                 width / 8,
+                                                 num_ent_per_write,
+                                                 addr_step,
+                                                 full_addr,
+                                                 log_pipe_mask,
+                                                 b);
+      if (status != PIPE_SUCCESS) {
+        LOG_ERROR("%s : Write block push in blob download error %s",
+                  __func__,
+                  pipe_str_err(status));
+        PIPE_MGR_DBGCHK(PIPE_SUCCESS == status);
+        return -2;
       }
-      write_blks[dev_id]++;
+    } else {
+      pipe_mgr_drv_buf_free(b);
     }
+    write_blks[dev_id]++;
     full_addr += addr_step * num_ent_per_write;
     ent -= num_ent_per_write;
   }
@@ -404,12 +483,8 @@ static int blob_wr_blk(pipe_sess_hdl_t sess_hdl,
 }
 
 /* Write register handler */
-static int blob_wr_reg(pipe_sess_hdl_t sess_hdl,
-                       rmt_dev_info_t *dev_info,
-                       profile_id_t prof_id,
-                       uint32_t log_pipe_mask,
-                       pipe_prsr_instance_hdl_t prsr_hdl,
-                       FILE *fd) {
+static int blob_wr_reg(pipe_mgr_blob_dnld_t *dnld, pipe_mgr_blob_t *blob) {
+  rmt_dev_info_t *dev_info = dnld->dev_info;
   bf_dev_id_t dev_id = dev_info->dev_id;
   uint32_t reg_addr = 0, reg_data = 0;
   pipe_instr_write_reg_t instr;
@@ -419,26 +494,10 @@ static int blob_wr_reg(pipe_sess_hdl_t sess_hdl,
 
   /* Get stage info. */
   uint8_t num_mau_stages = dev_info->num_active_mau;
-  uint32_t prsr_stage = 0, dprsr_stage = 0;
-  if (LLD_OK != lld_sku_get_prsr_stage(dev_id, &prsr_stage)) return -2;
-  if (LLD_OK != lld_sku_get_dprsr_stage(dev_id, &dprsr_stage)) return -2;
+  uint32_t prsr_stage = dnld->prsr_stage, dprsr_stage = dnld->dprsr_stage;
 
-  if (blob_check_len(dev_id, fd, WR_REG_LEN)) return -2;
-
-  size_t x = fread((void *)&reg_addr, 4, 1, fd);  // 32b address
-  reg_addr = le32toh(reg_addr);
-  if (x != 1) {
-    PIPE_MGR_DBGCHK(x == 1);
-    return -2;
-  }
-  x = fread((void *)&reg_data, 4, 1, fd);  // 32b data
-  reg_data = le32toh(reg_data);
-  if (x != 1) {
-    PIPE_MGR_DBGCHK(x == 1);
-    return -2;
-  }
-
-  if (feof(fd) || ferror(fd)) return -1;
+  reg_addr = blob_get32(blob);  // 32b address
+  reg_data = blob_get32(blob);  // 32b data
 
   /* Extract stage_id */
   stage_id = dev_info->dev_cfg.stage_id_from_addr(
@@ -455,22 +514,26 @@ static int blob_wr_reg(pipe_sess_hdl_t sess_hdl,
     case BF_DEV_FAMILY_TOFINO2:
     case BF_DEV_FAMILY_TOFINO3:
       pipe_mgr_lookup_cache_mirrtbl_register_content(
-          dev_info, log_pipe_mask, reg_addr, (uint8_t *)&reg_data, 4);
+          dev_info, dnld->log_pipe_mask, reg_addr, (uint8_t *)&reg_data, 4);
       break;
     default:
       break;
   }
   // check reg and get prsr map
   if (stage_id == prsr_stage) {
-    pipe_mgr_lookup_cache_parser_bin_reg_cfg(
-        dev_info, prsr_hdl, prof_id, reg_addr, reg_data, &shadowed);
+    pipe_mgr_lookup_cache_parser_bin_reg_cfg(dev_info,
+                                             dnld->prsr_hdl,
+                                             dnld->prof_id,
+                                             reg_addr,
+                                             reg_data,
+                                             &shadowed);
   }
   if (!shadowed) {
     construct_instr_reg_write(dev_id, &instr, reg_addr, reg_data);
     pipe_status_t status =
-        pipe_mgr_drv_ilist_add(&sess_hdl,
+        pipe_mgr_drv_ilist_add(&dnld->sess_hdl,
                                dev_info,
-                               &dev_info->profile_info[prof_id]->pipe_bmp,
+                               &dev_info->profile_info[dnld->prof_id]->pipe_bmp,
                                stage_id,
                                (uint8_t *)&instr,
                                sizeof(pipe_instr_write_reg_t));
@@ -617,97 +680,44 @@ static int blob_wr_reg(pipe_sess_hdl_t sess_hdl,
 
 
 // returns 0 on success, -1 on eof, -2 on failure
-static int write_next_bloblet(pipe_sess_hdl_t sess_hdl,
-                              rmt_dev_info_t *dev_info,
-                              profile_id_t prof_id,
-                              uint32_t log_pipe_mask,
-                              FILE *fd,
-                              int *stages_configured) {
+static int write_next_bloblet(pipe_mgr_blob_dnld_t *dnld,
+                              pipe_mgr_blob_t *blob) {
   uint32_t atom_val = 0;
 
-  bf_dev_id_t dev_id = dev_info->dev_id;
-
-  /* Get parser program handler */
-  static pipe_prsr_instance_hdl_t prsr_hdl = DEFAULT_PRSR_INSTANCE_HDL;
-  static profile_id_t prof_id_rst = 0;
-  if (prof_id_rst != prof_id) {
-    prof_id_rst = prof_id;
-    prsr_hdl = DEFAULT_PRSR_INSTANCE_HDL;
-  }
-
-read_next_bloblet:
-
   pipeline_cfg_progress_bar();
 
-  atom_val = 0;
-
-  /* Read four elements from FD, each element is one byte.  These bytes will
-   * determine what the next operation in the file is. */
-  size_t x = fread((void *)&atom_val, 4, 1, fd);
-  if (feof(fd) || ferror(fd) || x != 1) return -1;
-
-  atom_val = le32toh(atom_val);
+  /* The first four bytes of a record determine what the record is, the
+   * blob_validate pass already checked that each record is complete. */
+  if (blob->size - blob->pos < 4) return -1;
+  atom_val = blob_get32(blob);
   char atom_type = atom_val >> 24;
   pipe_status_t sts = PIPE_UNEXPECTED;
 
   switch (atom_type) {
     case 'H':
       /* Found a header block. */
-      sts = blob_hdr_elm(dev_id, prof_id, log_pipe_mask, fd, stages_configured);
-      if (PIPE_SUCCESS != sts) return sts;
-      goto read_next_bloblet;
+      sts = blob_hdr_elm(dnld, blob);
+      if (PIPE_SUCCESS != sts) {
+        LOG_ERROR("Invalid header in pipeline config on dev %d",
+                  dnld->dev_info->dev_id);
+        return -2;
+      }
+      return 0;
     case 'R':
-      sts =
-          blob_wr_reg(sess_hdl, dev_info, prof_id, log_pipe_mask, prsr_hdl, fd);
-      if (PIPE_SUCCESS != sts) return sts;
-      goto read_next_bloblet;
+      return blob_wr_reg(dnld, blob);
     case 'D':
     case 'B':
-      sts = blob_wr_blk(sess_hdl,
-                        dev_info,
-                        prof_id,
-                        log_pipe_mask,
-                        prsr_hdl,
-                        fd,
-                        atom_type == 'B');
-      if (PIPE_SUCCESS != sts) return sts;
-      return 0;
+      return blob_wr_blk(dnld, blob, atom_type == 'B');
     case 'P':
       /* Update prsr_instance_hdl */
-      x = fread((void *)&prsr_hdl, 4, 1, fd);
-      PIPE_MGR_DBGCHK(x == 1);
-      prsr_hdl = le32toh(prsr_hdl);
-      goto read_next_bloblet;
-
-
-
-
-
-
-    default: {
-      LOG_ERROR(
-          "Parse error: atom_val=%x atom_type=(%c)\n", atom_val, atom_type);
-      LOG_ERROR("fpos=%lu <%lxh>\n", ftell(fd), ftell(fd));
-#define BUF_SIZE 1025
-      uint8_t fbuf[BUF_SIZE];
-      char eb[BUF_SIZE * 4] = {0};
-      size_t ebp = 0;
-      if (fseek(fd, -4, SEEK_CUR)) return -2;
-      x = fread(fbuf, 1, BUF_SIZE - 1, fd);
-      for (size_t i = 0; i < x; i++) {
-        if ((i % 16) == 0)
-          ebp += snprintf(
-              &eb[ebp], sizeof(eb) - ebp, "\n0x%lx : ", fpos[dev_id] + i);
-        ebp += snprintf(&eb[ebp], sizeof(eb) - ebp, "%02x ", fbuf[i]);
-      }
-      LOG_ERROR("%s", eb);
-
-      PIPE_MGR_DBGCHK(0);
-      return -2;
-    }
+      dnld->prsr_hdl = blob_get32(blob);
+      return 0;
+    default:
+      break;
   }
   // Should not get here
-  return 0;
+  PIPE_MGR_DBGCHK(0);
+  return -2;
 }
 
 static pipe_status_t pipe_mgr_load_pipeline_cfg(
@@ -717,29 +727,57 @@ static pipe_status_t pipe_mgr_load_pipeline_cfg(
     uint32_t log_pipe_mask,
     int *stages_configured) {
   char *cfg_file = param->cfg_file;
+  bf_dev_id_t dev_id = dev_info->dev_id;
+  pipe_mgr_blob_t blob;
+  pipe_mgr_blob_dnld_t dnld;
+  uint32_t num_records = 0;
   int ret = 0;
 
-  FILE *blob_fd = fopen(cfg_file, "r");
-  if (!blob_fd) {
+  PIPE_MGR_MEMSET(&dnld, 0, sizeof dnld);
+  dnld.sess_hdl = sess_hdl;
+  dnld.dev_info = dev_info;
+  dnld.prof_id = param->prof_id;
+  dnld.log_pipe_mask = log_pipe_mask;
+  dnld.prsr_hdl = DEFAULT_PRSR_INSTANCE_HDL;
+  dnld.stages_configured = stages_configured;
+  dnld.st = pipe_mgr_drv_get_ses_state(&dnld.sess_hdl, __func__, __LINE__);
+  if (!dnld.st) {
+    PIPE_MGR_DBGCHK(0);
+    return PIPE_INVALID_ARG;
+  }
+  if (LLD_OK != lld_sku_get_prsr_stage(dev_id, &dnld.prsr_stage) ||
+      LLD_OK != lld_sku_get_dprsr_stage(dev_id, &dnld.dprsr_stage)) {
+    return PIPE_INVALID_ARG;
+  }
+  dnld.bwr_size = pipe_mgr_drv_buf_size(dev_id, PIPE_MGR_DRV_BUF_BWR);
+  if (dnld.bwr_size == 0) {
+    PIPE_MGR_DBGCHK(0);
+    return PIPE_INVALID_ARG;
+  }
+
+  pipe_status_t sts = blob_map(cfg_file, &blob);
+  if (PIPE_SUCCESS != sts) {
     LOG_ERROR("Could not open pipeline config file %s", cfg_file);
-    PIPE_MGR_DBGCHK(blob_fd);
+    PIPE_MGR_DBGCHK(PIPE_SUCCESS == sts);
     return PIPE_INVALID_ARG;
   }
-  if (fseek(blob_fd, 0, SEEK_SET)) {
-    fclose(blob_fd);
-    return -2;
+
+  sts = blob_validate(dev_id, &blob, &num_records);
+  if (PIPE_SUCCESS != sts) {
+    LOG_ERROR("Invalid pipeline config file %s", cfg_file);
+    blob_unmap(&blob);
+    return sts;
   }
+  LOG_TRACE("Dev %d pipeline config %s has %u records",
+            dev_id,
+            cfg_file,
+            num_records);
 
   do {
-    ret = write_next_bloblet(sess_hdl,
-                             dev_info,
-                             param->prof_id,
-                             log_pipe_mask,
-                             blob_fd,
-                             stages_configured);
+    ret = write_next_bloblet(&dnld, &blob);
   } while (ret == 0);
 
-  fclose(blob_fd);
+  blob_unmap(&blob);
   if (-2 == ret) {
     return PIPE_INVALID_ARG;
   }
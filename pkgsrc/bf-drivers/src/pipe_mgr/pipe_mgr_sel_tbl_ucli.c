@@ -25,7 +25,9 @@
  *****************************************************************************/
 /* Standard includes */
 #include <getopt.h>
+#include <inttypes.h>
 #include <limits.h>
+#include <time.h>
 
 /* Module includes */
 #include <pipe_mgr/pipe_mgr_config.h>
@@ -862,6 +864,231 @@ PIPE_MGR_SEL_TBL_CLI_CMD_DECLARE(ram_info) {
   return UCLI_STATUS_OK;
 }
 
+PIPE_MGR_SEL_TBL_CLI_CMD_DECLARE(mbr_tag) {
+  PIPE_MGR_CLI_PROLOGUE("mbr-tag",
+                        "Tag a selector member, or clear its tag without -t",
+                        "-d <dev_id> -h <tbl_handle> -m <mbr_hdl> [-t <tag>]");
+
+  bool got_dev = false, got_tbl_hdl = false, got_mbr = false, got_tag = false;
+  bf_dev_id_t dev_id = 0;
+  pipe_sel_tbl_hdl_t tbl_hdl = 0;
+  pipe_adt_ent_hdl_t mbr_hdl = 0;
+  uint32_t tag = 0;
+
+  int x;
+  while (-1 != (x = getopt(argc, argv, "d:h:m:t:"))) {
+    if (!optarg) {
+      aim_printf(&uc->pvs, "%s", usage);
+      return UCLI_STATUS_OK;
+    }
+    switch (x) {
+      case 'd':
+        dev_id = strtoul(optarg, NULL, 0);
+        got_dev = true;
+        break;
+      case 'h':
+        tbl_hdl = strtoul(optarg, NULL, 0);
+        got_tbl_hdl = true;
+        break;
+      case 'm':
+        mbr_hdl = strtoul(optarg, NULL, 0);
+        got_mbr = true;
+        break;
+      case 't':
+        tag = strtoul(optarg, NULL, 0);
+        got_tag = true;
+        break;
+      default:
+        aim_printf(&uc->pvs, "%s", usage);
+        return UCLI_STATUS_OK;
+    }
+  }
+  if (!got_dev || !got_tbl_hdl || !got_mbr) {
+    aim_printf(&uc->pvs, "%s", usage);
+    return UCLI_STATUS_OK;
+  }
+
+  pipe_sess_hdl_t sess_hdl;
+  pipe_status_t sts = pipe_mgr_client_init(&sess_hdl);
+  if (sts != PIPE_SUCCESS) {
+    aim_printf(&uc->pvs, "Session create failed: %s\n", pipe_str_err(sts));
+    return UCLI_STATUS_OK;
+  }
+  if (got_tag) {
+    sts = pipe_mgr_sel_mbr_tag_set(sess_hdl, dev_id, tbl_hdl, mbr_hdl, tag);
+  } else {
+    sts = pipe_mgr_sel_mbr_tag_clear(sess_hdl, dev_id, tbl_hdl, mbr_hdl);
+  }
+  if (sts != PIPE_SUCCESS) {
+    aim_printf(&uc->pvs, "Failed: %s\n", pipe_str_err(sts));
+  }
+  pipe_mgr_client_cleanup(sess_hdl);
+  return UCLI_STATUS_OK;
+}
+
+static uint64_t sel_ucli_elapsed_us(struct timespec *t1, struct timespec *t2) {
+  return (uint64_t)(t2->tv_sec - t1->tv_sec) * 1000000 +
+         (t2->tv_nsec - t1->tv_nsec) / 1000;
+}
+
+PIPE_MGR_SEL_TBL_CLI_CMD_DECLARE(tag_flap) {
+  PIPE_MGR_CLI_PROLOGUE(
+      "tag-flap",
+      "Time a down/up of the members with a tag across all groups, once with "
+      "one call per group member and once with one call for the tag",
+      "-d <dev_id> -h <tbl_handle> -t <tag> [-n <iterations>]");
+
+  bool got_dev = false, got_tbl_hdl = false, got_tag = false;
+  bf_dev_id_t dev_id = 0;
+  pipe_sel_tbl_hdl_t tbl_hdl = 0;
+  uint32_t tag = 0, iters = 1;
+
+  int x;
+  while (-1 != (x = getopt(argc, argv, "d:h:t:n:"))) {
+    if (!optarg) {
+      aim_printf(&uc->pvs, "%s", usage);
+      return UCLI_STATUS_OK;
+    }
+    switch (x) {
+      case 'd':
+        dev_id = strtoul(optarg, NULL, 0);
+        got_dev = true;
+        break;
+      case 'h':
+        tbl_hdl = strtoul(optarg, NULL, 0);
+        got_tbl_hdl = true;
+        break;
+      case 't':
+        tag = strtoul(optarg, NULL, 0);
+        got_tag = true;
+        break;
+      case 'n':
+        iters = strtoul(optarg, NULL, 0);
+        break;
+      default:
+        aim_printf(&uc->pvs, "%s", usage);
+        return UCLI_STATUS_OK;
+    }
+  }
+  if (!got_dev || !got_tbl_hdl || !got_tag || !iters) {
+    aim_printf(&uc->pvs, "%s", usage);
+    return UCLI_STATUS_OK;
+  }
+
+  sel_tbl_info_t *sel_tbl_info =
+      pipe_mgr_sel_tbl_info_get(dev_id, tbl_hdl, false);
+  bf_map_t *mbrs = NULL;
+  if (!sel_tbl_info) {
+    aim_printf(&uc->pvs, "Selector table 0x%x not found\n", tbl_hdl);
+    return UCLI_STATUS_OK;
+  }
+  if (BF_MAP_OK != bf_map_get(&sel_tbl_info->tag_mbrs, tag, (void **)&mbrs)) {
+    aim_printf(&uc->pvs, "No member has tag 0x%x\n", tag);
+    return UCLI_STATUS_OK;
+  }
+
+  /* Collect the active (group, member) pairs the tag reaches. */
+  uint32_t num_pairs = 0, max_pairs = 0;
+  pipe_sel_grp_hdl_t *grps = NULL;
+  pipe_adt_ent_hdl_t *pair_mbrs = NULL;
+  for (uint32_t i = 0; i < sel_tbl_info->no_sel_tbls; i++) {
+    Pvoid_t grp_array = sel_tbl_info->sel_tbl[i].sel_grp_array;
+    pipe_sel_grp_hdl_t grp_hdl;
+    sel_grp_info_t *grp;
+    JUDYL_FOREACH(grp_array, grp_hdl, sel_grp_info_t *, grp) {
+      unsigned long mbr_hdl;
+      void *unused;
+      bf_map_sts_t msts;
+      for (msts = bf_map_get_first(mbrs, &mbr_hdl, &unused); msts == BF_MAP_OK;
+           msts = bf_map_get_next(mbrs, &mbr_hdl, &unused)) {
+        sel_grp_mbr_t *mbr = pipe_mgr_sel_grp_mbr_get(grp, mbr_hdl, false);
+        if (!mbr || mbr->state != PIPE_MGR_GRP_MBR_STATE_ACTIVE) continue;
+        if (num_pairs == max_pairs) {
+          max_pairs = max_pairs ? 2 * max_pairs : 1024;
+          void *g = PIPE_MGR_REALLOC(grps, max_pairs * sizeof *grps);
+          if (g) grps = g;
+          void *m = PIPE_MGR_REALLOC(pair_mbrs, max_pairs * sizeof *pair_mbrs);
+          if (m) pair_mbrs = m;
+          if (!g || !m) {
+            aim_printf(&uc->pvs, "Out of memory\n");
+            goto done;
+          }
+        }
+        grps[num_pairs] = grp_hdl;
+        pair_mbrs[num_pairs] = mbr_hdl;
+        num_pairs++;
+      }
+    }
+  }
+  if (!num_pairs) {
+    aim_printf(&uc->pvs, "No active member with tag 0x%x\n", tag);
+    goto done;
+  }
+
+  pipe_sess_hdl_t sess_hdl;
+  pipe_status_t sts = pipe_mgr_client_init(&sess_hdl);
+  if (sts != PIPE_SUCCESS) {
+    aim_printf(&uc->pvs, "Session create failed: %s\n", pipe_str_err(sts));
+    goto done;
+  }
+
+  struct timespec t1, t2;
+  uint64_t per_call_us = 0, tag_us = 0;
+  uint32_t num_updated = 0;
+  for (uint32_t it = 0; it < iters && sts == PIPE_SUCCESS; it++) {
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    for (uint32_t i = 0; i < num_pairs && sts == PIPE_SUCCESS; i++) {
+      sts = pipe_mgr_sel_grp_mbr_disable(
+          sess_hdl, dev_id, tbl_hdl, grps[i], pair_mbrs[i], 0);
+    }
+    for (uint32_t i = 0; i < num_pairs && sts == PIPE_SUCCESS; i++) {
+      sts = pipe_mgr_sel_grp_mbr_enable(
+          sess_hdl, dev_id, tbl_hdl, grps[i], pair_mbrs[i], 0);
+    }
+    if (sts == PIPE_SUCCESS) sts = pipe_mgr_complete_operations(sess_hdl);
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    per_call_us += sel_ucli_elapsed_us(&t1, &t2);
+    if (sts != PIPE_SUCCESS) break;
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    sts = pipe_mgr_sel_tag_mbrs_state_set(
+        sess_hdl, dev_id, tbl_hdl, tag, false, &num_updated, 0);
+    if (sts == PIPE_SUCCESS) {
+      sts = pipe_mgr_sel_tag_mbrs_state_set(
+          sess_hdl, dev_id, tbl_hdl, tag, true, NULL, 0);
+    }
+    if (sts == PIPE_SUCCESS) sts = pipe_mgr_complete_operations(sess_hdl);
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    tag_us += sel_ucli_elapsed_us(&t1, &t2);
+  }
+  pipe_mgr_client_cleanup(sess_hdl);
+  if (sts != PIPE_SUCCESS) {
+    aim_printf(&uc->pvs, "Failed: %s\n", pipe_str_err(sts));
+    goto done;
+  }
+
+  aim_printf(&uc->pvs,
+             "tag 0x%x: %u group members, %u updated per tag call\n",
+             tag,
+             num_pairs,
+             num_updated);
+  aim_printf(&uc->pvs,
+             "per member calls: %" PRIu64 " us per down/up\n",
+             per_call_us / iters);
+  aim_printf(&uc->pvs,
+             "tag call        : %" PRIu64 " us per down/up\n",
+             tag_us / iters);
+  if (tag_us) {
+    aim_printf(
+        &uc->pvs, "speedup         : %.1fx\n", (double)per_call_us / tag_us);
+  }
+
+done:
+  if (grps) PIPE_MGR_FREE(grps);
+  if (pair_mbrs) PIPE_MGR_FREE(pair_mbrs);
+  return UCLI_STATUS_OK;
+}
+
 /* <auto.ucli.handlers.start> */
 static ucli_command_handler_f pipe_mgr_sel_tbl_ucli_ucli_handlers__[] = {
     PIPE_MGR_SEL_TBL_CLI_CMD_HNDLR(tbl_info),
@@ -869,6 +1096,8 @@ static ucli_command_handler_f pipe_mgr_sel_tbl_ucli_ucli_handlers__[] = {
     PIPE_MGR_SEL_TBL_CLI_CMD_HNDLR(stage_info),
     PIPE_MGR_SEL_TBL_CLI_CMD_HNDLR(entry_count),
     PIPE_MGR_SEL_TBL_CLI_CMD_HNDLR(ram_info),
+    PIPE_MGR_SEL_TBL_CLI_CMD_HNDLR(mbr_tag),
+    PIPE_MGR_SEL_TBL_CLI_CMD_HNDLR(tag_flap),
     NULL};
 
 /* <auto.ucli.handlers.end> */
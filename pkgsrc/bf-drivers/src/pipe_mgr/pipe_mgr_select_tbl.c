@@ -26,6 +26,7 @@
  */
 
 /* Module header files */
+#include <inttypes.h>
 #include <pipe_mgr/pipe_mgr_intf.h>
 #include <dvm/bf_drv_intf.h>
 #include <lld/bf_dma_if.h>
@@ -38,6 +39,7 @@
 /* Local header files */
 #include "pipe_mgr_int.h"
 #include "pipe_mgr_select_tbl.h"
+#include "pipe_mgr_adt_mgr_int.h"
 #include "pipe_mgr_db.h"
 #include "pipe_mgr_select_tbl_transaction.h"
 #include "pipe_mgr_select_ha.h"
@@ -1352,6 +1354,19 @@ cleanup:
   return NULL;
 }
 
+static void sel_tbl_tags_destroy(sel_tbl_info_t *sel_tbl_info) {
+  unsigned long tag;
+  bf_map_t *mbrs;
+
+  while (BF_MAP_OK ==
+         bf_map_get_first_rmv(&sel_tbl_info->tag_mbrs, &tag, (void **)&mbrs)) {
+    bf_map_destroy(mbrs);
+    PIPE_MGR_FREE(mbrs);
+  }
+  bf_map_destroy(&sel_tbl_info->tag_mbrs);
+  bf_map_destroy(&sel_tbl_info->mbr_tags);
+}
+
 static void pipe_mgr_sel_tbl_info_destroy(sel_tbl_info_t *sel_tbl_info,
                                           bool is_backup) {
   if (!sel_tbl_info) {
@@ -1367,6 +1382,7 @@ static void pipe_mgr_sel_tbl_info_destroy(sel_tbl_info_t *sel_tbl_info,
   }
 
   pipe_mgr_selector_tbl_cleanup_llp_ha_state(sel_tbl_info);
+  sel_tbl_tags_destroy(sel_tbl_info);
 
   PIPE_MGR_FREE(sel_tbl_info->name);
   PIPE_MGR_FREE(sel_tbl_info);
@@ -7361,6 +7377,219 @@ cleanup:
   return rc;
 }
 
+static uint64_t sel_wt_gcd(uint64_t a, uint64_t b) {
+  while (b) {
+    uint64_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+typedef struct sel_wt_rem_t {
+  uint32_t idx;
+  uint64_t rem;
+} sel_wt_rem_t;
+
+static int sel_wt_rem_cmp_desc(const void *a, const void *b) {
+  const sel_wt_rem_t *x = a, *y = b;
+  if (x->rem != y->rem) return x->rem < y->rem ? 1 : -1;
+  return x->idx < y->idx ? -1 : x->idx > y->idx;
+}
+
+/* Scale the weights down by their common divisor and return the new total.
+ */
+static uint64_t sel_wt_normalize(uint32_t num_mbrs, uint32_t *weights) {
+  uint64_t g = 0, total = 0;
+  uint32_t i;
+  for (i = 0; i < num_mbrs; i++) g = sel_wt_gcd(weights[i], g);
+  for (i = 0; i < num_mbrs; i++) {
+    weights[i] = (uint32_t)(weights[i] / g);
+    total += weights[i];
+  }
+  return total;
+}
+
+/*!
+ * Reduce a set of member weights so that their total fits in max_slots.
+ *
+ * Weights are first divided by their greatest common divisor, which is exact.
+ * If the total still does not fit, the slots are apportioned with the largest
+ * remainder method, each member keeping at least one slot, which bounds the
+ * error of every member's share by one slot. The result is normalized again
+ * so that no more slots than needed are used.
+ */
+pipe_status_t pipe_mgr_sel_weights_reduce(uint32_t num_mbrs,
+                                          const uint32_t *weights,
+                                          uint32_t max_slots,
+                                          uint32_t *out_weights,
+                                          pipe_sel_grp_weight_report_t *rpt) {
+  uint64_t req_total = 0, total = 0, seats = 0;
+  uint32_t i;
+  sel_wt_rem_t *rems = NULL;
+
+  if (num_mbrs && (!weights || !out_weights)) return PIPE_INVALID_ARG;
+  if (num_mbrs > max_slots) return PIPE_NO_SPACE;
+  for (i = 0; i < num_mbrs; i++) {
+    if (!weights[i]) return PIPE_INVALID_ARG;
+    req_total += weights[i];
+    out_weights[i] = weights[i];
+  }
+
+  total = sel_wt_normalize(num_mbrs, out_weights);
+  if (total > max_slots) {
+    /* Largest remainder apportionment of max_slots using the normalized
+     * weights, whose total is "total". */
+    rems = PIPE_MGR_CALLOC(num_mbrs, sizeof *rems);
+    if (!rems) return PIPE_NO_SYS_RESOURCES;
+    for (i = 0; i < num_mbrs; i++) {
+      uint64_t q = (uint64_t)out_weights[i] * max_slots;
+      rems[i].idx = i;
+      rems[i].rem = q % total;
+      out_weights[i] = (uint32_t)(q / total);
+      if (!out_weights[i]) {
+        /* Every member keeps one slot, it is given ahead of the others. */
+        out_weights[i] = 1;
+        rems[i].rem = 0;
+      }
+      seats += out_weights[i];
+    }
+    qsort(rems, num_mbrs, sizeof *rems, sel_wt_rem_cmp_desc);
+    /* Hand out the remaining slots by largest remainder. */
+    for (i = 0; seats < max_slots && i < num_mbrs; i++) {
+      out_weights[rems[i].idx]++;
+      seats++;
+    }
+    /* The minimum of one slot may have overcommitted, take slots back from
+     * the members with the smallest remainders first. */
+    while (seats > max_slots) {
+      bool taken = false;
+      for (i = num_mbrs; i > 0 && seats > max_slots; i--) {
+        uint32_t idx = rems[i - 1].idx;
+        if (out_weights[idx] > 1) {
+          out_weights[idx]--;
+          seats--;
+          taken = true;
+        }
+      }
+      if (!taken) break;
+    }
+    PIPE_MGR_FREE(rems);
+    total = sel_wt_normalize(num_mbrs, out_weights);
+  }
+
+  if (rpt) {
+    double max_err = 0;
+    for (i = 0; i < num_mbrs && total; i++) {
+      double err = (double)out_weights[i] / total -
+                   (double)weights[i] / req_total;
+      if (err < 0) err = -err;
+      if (err > max_err) max_err = err;
+    }
+    rpt->requested_total = req_total;
+    rpt->achieved_total = (uint32_t)total;
+    rpt->max_share_error_ppm = (uint32_t)(max_err * 1000000 + 0.5);
+  }
+  return PIPE_SUCCESS;
+}
+
+/*!
+ * API function to set a weighted membership of a group
+ */
+pipe_status_t rmt_sel_grp_mbrs_set_weighted(
+    pipe_sess_hdl_t sess_hdl,
+    bf_dev_id_t device_id,
+    pipe_sel_tbl_hdl_t sel_tbl_hdl,
+    pipe_sel_grp_hdl_t sel_grp_hdl,
+    uint32_t num_mbrs,
+    pipe_adt_ent_hdl_t *mbrs,
+    uint32_t *weights,
+    bool *enable,
+    uint32_t max_slots,
+    pipe_sel_grp_weight_report_t *report,
+    uint32_t pipe_api_flags,
+    struct pipe_mgr_sel_move_list_t **move_list) {
+  pipe_status_t rc = PIPE_SUCCESS;
+  pipe_sel_grp_weight_report_t rpt = {0};
+  uint32_t *red_weights = NULL;
+  pipe_adt_ent_hdl_t *exp_mbrs = NULL;
+  bool *exp_enable = NULL;
+  uint32_t max_size = 0, adt_offset = 0;
+  uint32_t i, j, n = 0;
+
+  rc = pipe_mgr_sel_grp_get_params(
+      device_id, sel_tbl_hdl, sel_grp_hdl, &max_size, &adt_offset);
+  if (rc != PIPE_SUCCESS) return rc;
+  if (!max_slots || max_slots > max_size) max_slots = max_size;
+
+  if (num_mbrs) {
+    red_weights = PIPE_MGR_CALLOC(num_mbrs, sizeof *red_weights);
+    if (!red_weights) return PIPE_NO_SYS_RESOURCES;
+  }
+  rc = pipe_mgr_sel_weights_reduce(
+      num_mbrs, weights, max_slots, red_weights, &rpt);
+  if (rc != PIPE_SUCCESS) {
+    LOG_ERROR(
+        "%s:%d Cannot fit %d weighted members in %d slots of sel grp %d in "
+        "table 0x%x device %d, %s",
+        __func__,
+        __LINE__,
+        num_mbrs,
+        max_slots,
+        sel_grp_hdl,
+        sel_tbl_hdl,
+        device_id,
+        pipe_str_err(rc));
+    goto cleanup;
+  }
+  LOG_DBG(
+      "%s:%d Sel grp %d in table 0x%x device %d: %d members, requested "
+      "total weight %" PRIu64 ", achieved %d, max share error %d ppm",
+      __func__,
+      __LINE__,
+      sel_grp_hdl,
+      sel_tbl_hdl,
+      device_id,
+      num_mbrs,
+      rpt.requested_total,
+      rpt.achieved_total,
+      rpt.max_share_error_ppm);
+  if (report) *report = rpt;
+
+  /* A weight is a member repeated in the membership list, the diff in
+   * rmt_sel_grp_mbrs_set then only adds or removes the weight deltas. */
+  if (rpt.achieved_total) {
+    exp_mbrs = PIPE_MGR_CALLOC(rpt.achieved_total, sizeof *exp_mbrs);
+    exp_enable = PIPE_MGR_CALLOC(rpt.achieved_total, sizeof *exp_enable);
+    if (!exp_mbrs || !exp_enable) {
+      rc = PIPE_NO_SYS_RESOURCES;
+      goto cleanup;
+    }
+  }
+  for (i = 0; i < num_mbrs; i++) {
+    for (j = 0; j < red_weights[i]; j++, n++) {
+      exp_mbrs[n] = mbrs[i];
+      exp_enable[n] = enable[i];
+    }
+  }
+
+  rc = rmt_sel_grp_mbrs_set(sess_hdl,
+                            device_id,
+                            sel_tbl_hdl,
+                            sel_grp_hdl,
+                            n,
+                            exp_mbrs,
+                            exp_enable,
+                            pipe_api_flags,
+                            move_list);
+
+cleanup:
+  if (red_weights) PIPE_MGR_FREE(red_weights);
+  if (exp_mbrs) PIPE_MGR_FREE(exp_mbrs);
+  if (exp_enable) PIPE_MGR_FREE(exp_enable);
+  return rc;
+}
+
 static pipe_status_t update_duplicate_mbrs(sel_grp_mbr_t *mbr,
                                            pipe_adt_ent_hdl_t *mbrs,
                                            bool *enable,
@@ -7511,6 +7740,65 @@ pipe_status_t rmt_sel_grp_mbrs_get(bf_dev_id_t device_id,
   return PIPE_SUCCESS;
 }
 
+/* Change the state of a member in all the words it occupies in a group. */
+static pipe_status_t sel_grp_mbr_state_set(
+    sel_tbl_info_t *sel_tbl_info,
+    sel_tbl_t *sel_tbl,
+    sel_grp_info_t *sel_grp_info,
+    pipe_sel_grp_mbr_hdl_t sel_grp_mbr_hdl,
+    bool enable,
+    struct pipe_mgr_sel_move_list_t **move_tail_p) {
+  pipe_status_t rc = PIPE_SUCCESS;
+  uint8_t data = enable ? 1 : 0;
+
+  rc = pipe_mgr_sel_grp_mbr_backup_one(
+      sel_tbl_info, sel_tbl, sel_grp_info, sel_grp_mbr_hdl);
+  if (rc != PIPE_SUCCESS) {
+    LOG_ERROR("%s:%d Error backing up group %d mbr %d rc 0x%x",
+              __func__,
+              __LINE__,
+              sel_grp_info->grp_hdl,
+              sel_grp_mbr_hdl,
+              rc);
+    return rc;
+  }
+
+  sel_grp_mbr_t *mbr =
+      pipe_mgr_sel_grp_mbr_get(sel_grp_info, sel_grp_mbr_hdl, false);
+  if (!mbr) {
+    LOG_ERROR("%s:%d %s(0x%x-%d) Sel group member %d not found in group %d",
+              __func__,
+              __LINE__,
+              sel_tbl_info->name,
+              sel_tbl_info->tbl_hdl,
+              sel_tbl_info->dev_id,
+              sel_grp_mbr_hdl,
+              sel_grp_info->grp_hdl);
+    return PIPE_OBJ_NOT_FOUND;
+  }
+
+  /* Stateful selection tables require updates per bit change while non-
+   * stateful tables can update on RAM word boundaries.  Use different worker
+   * functions for the two cases. */
+  rc = pipe_mgr_sel_grp_mbr_iterate(sel_tbl_info,
+                                    sel_grp_info,
+                                    sel_grp_mbr_hdl,
+                                    __func__,
+                                    mbr_enable_disable_in_stage,
+                                    &data,
+                                    move_tail_p);
+  if (rc != PIPE_SUCCESS) {
+    return rc;
+  }
+
+  mbr->state = enable ? PIPE_MGR_GRP_MBR_STATE_ACTIVE
+                      : PIPE_MGR_GRP_MBR_STATE_INACTIVE;
+  if (pipe_mgr_sel_update_active_mbr_count(sel_grp_info)) {
+    return PIPE_UNEXPECTED;
+  }
+  return PIPE_SUCCESS;
+}
+
 /* API function to disable a group member of a selection table */
 pipe_status_t rmt_sel_grp_mbr_disable(
     pipe_sess_hdl_t sess_hdl,
@@ -7525,7 +7813,6 @@ pipe_status_t rmt_sel_grp_mbr_disable(
   sel_grp_info_t *sel_grp_info = NULL;
   bf_dev_pipe_t pipe_id;
   sel_tbl_t *sel_tbl;
-  uint8_t data = 0;
 
   sel_tbl_info = pipe_mgr_sel_tbl_info_get(dev_id, sel_tbl_hdl, false);
   if (sel_tbl_info == NULL) {
@@ -7583,48 +7870,16 @@ pipe_status_t rmt_sel_grp_mbr_disable(
   sel_tbl->cur_sess_hdl = sess_hdl;
   sel_tbl->sess_flags = pipe_api_flags;
 
-  rc = pipe_mgr_sel_grp_mbr_backup_one(
-      sel_tbl_info, sel_tbl, sel_grp_info, sel_grp_mbr_hdl);
-  if (rc != PIPE_SUCCESS) {
-    LOG_ERROR("%s:%d Error backing up group %d mbr %d rc 0x%x",
-              __func__,
-              __LINE__,
-              sel_grp_info->grp_hdl,
-              sel_grp_mbr_hdl,
-              rc);
-    return rc;
-  }
-
-  sel_grp_mbr_t *mbr =
-      pipe_mgr_sel_grp_mbr_get(sel_grp_info, sel_grp_mbr_hdl, false);
-  if (!mbr) {
-    LOG_ERROR(
-        "%s:%d %s(0x%x-%d) "
-        "Sel group member %d not found in group %d",
-        __func__,
-        __LINE__,
-        sel_tbl_info->name,
-        sel_tbl_info->tbl_hdl,
-        sel_tbl_info->dev_id,
-        sel_grp_mbr_hdl,
-        sel_grp_info->grp_hdl);
-    return PIPE_OBJ_NOT_FOUND;
-  }
-
   struct pipe_mgr_sel_move_list_t move_head;
   move_head.next = NULL;
   struct pipe_mgr_sel_move_list_t *move_tail = &move_head;
 
-  /* Stateful selection tables require updates per bit change while non-
-   * stateful tables can update on RAM word boundaries.  Use different worker
-   * functions for the two cases. */
-  rc = pipe_mgr_sel_grp_mbr_iterate(sel_tbl_info,
-                                    sel_grp_info,
-                                    sel_grp_mbr_hdl,
-                                    __func__,
-                                    mbr_enable_disable_in_stage,
-                                    &data,
-                                    move_head_p ? &move_tail : NULL);
+  rc = sel_grp_mbr_state_set(sel_tbl_info,
+                             sel_tbl,
+                             sel_grp_info,
+                             sel_grp_mbr_hdl,
+                             false,
+                             move_head_p ? &move_tail : NULL);
   if (rc != PIPE_SUCCESS) {
     return rc;
   }
@@ -7632,11 +7887,6 @@ pipe_status_t rmt_sel_grp_mbr_disable(
     *move_head_p = move_head.next;
   }
 
-  mbr->state = PIPE_MGR_GRP_MBR_STATE_INACTIVE;
-  if (pipe_mgr_sel_update_active_mbr_count(sel_grp_info)) {
-    return PIPE_UNEXPECTED;
-  }
-
   PIPE_MGR_SEL_TBL_ASSERT(dev_id, sel_tbl_hdl);
   return PIPE_SUCCESS;
 }
@@ -7655,7 +7905,6 @@ pipe_status_t rmt_sel_grp_mbr_enable(
   sel_grp_info_t *sel_grp_info = NULL;
   bf_dev_pipe_t pipe_id;
   sel_tbl_t *sel_tbl;
-  uint8_t data = 1;
 
   sel_tbl_info = pipe_mgr_sel_tbl_info_get(dev_id, sel_tbl_hdl, false);
   if (sel_tbl_info == NULL) {
@@ -7711,60 +7960,261 @@ pipe_status_t rmt_sel_grp_mbr_enable(
   sel_tbl->cur_sess_hdl = sess_hdl;
   sel_tbl->sess_flags = pipe_api_flags;
 
-  rc = pipe_mgr_sel_grp_mbr_backup_one(
-      sel_tbl_info, sel_tbl, sel_grp_info, sel_grp_mbr_hdl);
+  struct pipe_mgr_sel_move_list_t move_head;
+  move_head.next = NULL;
+  struct pipe_mgr_sel_move_list_t *move_tail = &move_head;
+
+  rc = sel_grp_mbr_state_set(sel_tbl_info,
+                             sel_tbl,
+                             sel_grp_info,
+                             sel_grp_mbr_hdl,
+                             true,
+                             move_head_p ? &move_tail : NULL);
   if (rc != PIPE_SUCCESS) {
-    LOG_ERROR("%s:%d Error backing up group %d mbr %d rc 0x%x",
+    return rc;
+  }
+  if (move_head_p) {
+    *move_head_p = move_head.next;
+  }
+
+  PIPE_MGR_SEL_TBL_ASSERT(dev_id, sel_tbl_hdl);
+  return PIPE_SUCCESS;
+}
+
+/* Removes the tag of a member, if it has one. */
+static pipe_status_t sel_mbr_tag_rmv(sel_tbl_info_t *sel_tbl_info,
+                                     pipe_adt_ent_hdl_t adt_ent_hdl) {
+  bf_map_t *mbrs = NULL;
+  void *tag = NULL;
+
+  if (BF_MAP_OK != bf_map_get_rmv(&sel_tbl_info->mbr_tags, adt_ent_hdl, &tag))
+    return PIPE_SUCCESS;
+  if (BF_MAP_OK != bf_map_get(&sel_tbl_info->tag_mbrs,
+                              (uintptr_t)tag,
+                              (void **)&mbrs)) {
+    PIPE_MGR_DBGCHK(0);
+    return PIPE_UNEXPECTED;
+  }
+  bf_map_rmv(mbrs, adt_ent_hdl);
+  if (!bf_map_count(mbrs)) {
+    bf_map_rmv(&sel_tbl_info->tag_mbrs, (uintptr_t)tag);
+    bf_map_destroy(mbrs);
+    PIPE_MGR_FREE(mbrs);
+  }
+  return PIPE_SUCCESS;
+}
+
+/*!
+ * API function to tag a member of the action profile used by a selection
+ * table
+ */
+pipe_status_t rmt_sel_mbr_tag_set(pipe_sess_hdl_t sess_hdl,
+                                  bf_dev_id_t dev_id,
+                                  pipe_sel_tbl_hdl_t sel_tbl_hdl,
+                                  pipe_adt_ent_hdl_t adt_ent_hdl,
+                                  uint32_t tag) {
+  (void)sess_hdl;
+  sel_tbl_info_t *sel_tbl_info = NULL;
+  pipe_mgr_adt_t *adt = NULL;
+  bf_map_t *mbrs = NULL;
+  pipe_status_t rc;
+
+  sel_tbl_info = pipe_mgr_sel_tbl_info_get(dev_id, sel_tbl_hdl, false);
+  if (sel_tbl_info == NULL) {
+    LOG_ERROR("%s:%d sel table not found for handle 0x%x",
               __func__,
               __LINE__,
-              sel_grp_info->grp_hdl,
-              sel_grp_mbr_hdl,
-              rc);
-    return rc;
+              sel_tbl_hdl);
+    return PIPE_OBJ_NOT_FOUND;
   }
 
-  sel_grp_mbr_t *mbr =
-      pipe_mgr_sel_grp_mbr_get(sel_grp_info, sel_grp_mbr_hdl, false);
-  if (!mbr) {
-    LOG_ERROR("%s:%d %s(0x%x-%d) Sel group member %d not found in group %d",
+  /* Only existing members can be tagged, a tag is dropped when its member is
+   * deleted. */
+  adt = pipe_mgr_adt_get(dev_id, sel_tbl_info->adt_tbl_hdl);
+  if (!adt || !pipe_mgr_adt_get_entry_info(adt, adt_ent_hdl)) {
+    LOG_ERROR("%s:%d %s(0x%x-%d) Cannot tag mbr 0x%x, it does not exist",
               __func__,
               __LINE__,
               sel_tbl_info->name,
               sel_tbl_info->tbl_hdl,
               sel_tbl_info->dev_id,
-              sel_grp_mbr_hdl,
-              sel_grp_info->grp_hdl);
+              adt_ent_hdl);
     return PIPE_OBJ_NOT_FOUND;
   }
 
+  rc = sel_mbr_tag_rmv(sel_tbl_info, adt_ent_hdl);
+  if (rc != PIPE_SUCCESS) return rc;
+
+  if (BF_MAP_OK != bf_map_get(&sel_tbl_info->tag_mbrs, tag, (void **)&mbrs)) {
+    mbrs = PIPE_MGR_CALLOC(1, sizeof *mbrs);
+    if (!mbrs) return PIPE_NO_SYS_RESOURCES;
+    bf_map_init(mbrs);
+    if (BF_MAP_OK != bf_map_add(&sel_tbl_info->tag_mbrs, tag, mbrs)) {
+      PIPE_MGR_FREE(mbrs);
+      return PIPE_NO_SYS_RESOURCES;
+    }
+  }
+  if (BF_MAP_OK != bf_map_add(mbrs, adt_ent_hdl, NULL)) {
+    rc = PIPE_NO_SYS_RESOURCES;
+    goto cleanup;
+  }
+  if (BF_MAP_OK != bf_map_add(&sel_tbl_info->mbr_tags,
+                              adt_ent_hdl,
+                              (void *)(uintptr_t)tag)) {
+    bf_map_rmv(mbrs, adt_ent_hdl);
+    rc = PIPE_NO_SYS_RESOURCES;
+    goto cleanup;
+  }
+  return PIPE_SUCCESS;
+
+cleanup:
+  /* Do not leave an empty member set behind for the tag. */
+  if (!bf_map_count(mbrs)) {
+    bf_map_rmv(&sel_tbl_info->tag_mbrs, tag);
+    bf_map_destroy(mbrs);
+    PIPE_MGR_FREE(mbrs);
+  }
+  return rc;
+}
+
+/*!
+ * API function to remove the tag of a member
+ */
+pipe_status_t rmt_sel_mbr_tag_clear(pipe_sess_hdl_t sess_hdl,
+                                    bf_dev_id_t dev_id,
+                                    pipe_sel_tbl_hdl_t sel_tbl_hdl,
+                                    pipe_adt_ent_hdl_t adt_ent_hdl) {
+  (void)sess_hdl;
+  sel_tbl_info_t *sel_tbl_info = NULL;
+
+  sel_tbl_info = pipe_mgr_sel_tbl_info_get(dev_id, sel_tbl_hdl, false);
+  if (sel_tbl_info == NULL) {
+    LOG_ERROR("%s:%d sel table not found for handle 0x%x",
+              __func__,
+              __LINE__,
+              sel_tbl_hdl);
+    return PIPE_OBJ_NOT_FOUND;
+  }
+  return sel_mbr_tag_rmv(sel_tbl_info, adt_ent_hdl);
+}
+
+/*!
+ * Remove the tag of an action profile member being deleted from all the
+ * selection tables using that action profile
+ */
+void rmt_sel_adt_ent_del_tag_clear(bf_dev_id_t dev_id,
+                                   pipe_adt_tbl_hdl_t adt_tbl_hdl,
+                                   pipe_adt_ent_hdl_t adt_ent_hdl) {
+  pipe_sel_tbl_hdl_t tbl_hdl = 0;
+  sel_tbl_info_t *sel_tbl_info;
+
+  for (sel_tbl_info = pipe_mgr_sel_tbl_info_get_first(dev_id, &tbl_hdl);
+       sel_tbl_info;
+       sel_tbl_info = pipe_mgr_sel_tbl_info_get_next(dev_id, &tbl_hdl)) {
+    if (sel_tbl_info->adt_tbl_hdl != adt_tbl_hdl) continue;
+    sel_mbr_tag_rmv(sel_tbl_info, adt_ent_hdl);
+  }
+}
+
+/*!
+ * API function to disable or re-enable the members with a tag in all the
+ * groups of a selection table.  All the updates are returned on a single move
+ * list so that they are pushed to hardware as one instruction list.
+ */
+pipe_status_t rmt_sel_tag_mbrs_state_set(
+    pipe_sess_hdl_t sess_hdl,
+    bf_dev_id_t dev_id,
+    pipe_sel_tbl_hdl_t sel_tbl_hdl,
+    uint32_t tag,
+    bool enable,
+    uint32_t pipe_api_flags,
+    uint32_t *num_updated,
+    struct pipe_mgr_sel_move_list_t **move_head_p) {
+  sel_tbl_info_t *sel_tbl_info = NULL;
+  pipe_status_t rc = PIPE_SUCCESS;
+  enum pipe_mgr_grp_mbr_state_e state;
+  bf_map_t *mbrs = NULL;
+  uint32_t updated = 0;
+  uint32_t i;
+
+  sel_tbl_info = pipe_mgr_sel_tbl_info_get(dev_id, sel_tbl_hdl, false);
+  if (sel_tbl_info == NULL) {
+    LOG_ERROR("%s:%d sel table not found for handle 0x%x",
+              __func__,
+              __LINE__,
+              sel_tbl_hdl);
+    return PIPE_OBJ_NOT_FOUND;
+  }
+
+  LOG_TRACE("%s:%d - %s (%d - 0x%x) Request to %s mbrs with tag 0x%x",
+            __func__,
+            __LINE__,
+            sel_tbl_info->name,
+            sel_tbl_info->dev_id,
+            sel_tbl_info->tbl_hdl,
+            enable ? "enable" : "disable",
+            tag);
+
   struct pipe_mgr_sel_move_list_t move_head;
   move_head.next = NULL;
   struct pipe_mgr_sel_move_list_t *move_tail = &move_head;
 
-  /* Stateful selection tables require updates per bit change while non-
-   * stateful tables can update on RAM word boundaries.  Use different worker
-   * functions for the two cases. */
-  rc = pipe_mgr_sel_grp_mbr_iterate(sel_tbl_info,
-                                    sel_grp_info,
-                                    sel_grp_mbr_hdl,
-                                    __func__,
-                                    mbr_enable_disable_in_stage,
-                                    &data,
-                                    move_head_p ? &move_tail : NULL);
-  if (rc != PIPE_SUCCESS) {
-    return rc;
+  if (BF_MAP_OK != bf_map_get(&sel_tbl_info->tag_mbrs, tag, (void **)&mbrs))
+    goto done;
+
+  state = enable ? PIPE_MGR_GRP_MBR_STATE_ACTIVE
+                 : PIPE_MGR_GRP_MBR_STATE_INACTIVE;
+  for (i = 0; i < sel_tbl_info->no_sel_tbls; i++) {
+    sel_tbl_t *sel_tbl = &sel_tbl_info->sel_tbl[i];
+    pipe_sel_grp_hdl_t grp_hdl;
+    sel_grp_info_t *sel_grp_info;
+
+    /* Set-up the session parameters */
+    sel_tbl->cur_sess_hdl = sess_hdl;
+    sel_tbl->sess_flags = pipe_api_flags;
+
+    JUDYL_FOREACH(sel_tbl->sel_grp_array, grp_hdl, sel_grp_info_t *,
+                  sel_grp_info) {
+      unsigned long mbr_hdl;
+      void *unused;
+      bf_map_sts_t msts;
+
+      for (msts = bf_map_get_first(mbrs, &mbr_hdl, &unused); msts == BF_MAP_OK;
+           msts = bf_map_get_next(mbrs, &mbr_hdl, &unused)) {
+        sel_grp_mbr_t *mbr =
+            pipe_mgr_sel_grp_mbr_get(sel_grp_info, mbr_hdl, false);
+        if (!mbr || mbr->state == state) continue;
+        rc = sel_grp_mbr_state_set(sel_tbl_info,
+                                   sel_tbl,
+                                   sel_grp_info,
+                                   mbr_hdl,
+                                   enable,
+                                   move_head_p ? &move_tail : NULL);
+        if (rc != PIPE_SUCCESS) {
+          LOG_ERROR("%s:%d %s(0x%x-%d) Error %s mbr %lu in group 0x%x, %s",
+                    __func__,
+                    __LINE__,
+                    sel_tbl_info->name,
+                    sel_tbl_info->tbl_hdl,
+                    sel_tbl_info->dev_id,
+                    enable ? "enabling" : "disabling",
+                    mbr_hdl,
+                    grp_hdl,
+                    pipe_str_err(rc));
+          goto done;
+        }
+        updated++;
+      }
+    }
   }
+
+done:
+  /* Hand back the partial move list on errors too, the caller frees it. */
   if (move_head_p) {
     *move_head_p = move_head.next;
   }
-
-  mbr->state = PIPE_MGR_GRP_MBR_STATE_ACTIVE;
-  if (pipe_mgr_sel_update_active_mbr_count(sel_grp_info)) {
-    return PIPE_UNEXPECTED;
-  }
-
-  PIPE_MGR_SEL_TBL_ASSERT(dev_id, sel_tbl_hdl);
-  return PIPE_SUCCESS;
+  if (num_updated) *num_updated = updated;
+  return rc;
 }
 
 /* Activate a selection table group in a stage */
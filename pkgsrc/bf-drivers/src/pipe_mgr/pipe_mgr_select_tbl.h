@@ -345,6 +345,13 @@ typedef struct sel_tbl_info_s {
   /* Used to enable cache of group id mapping at selector table level.
    * Used by bfrt. Cannot be turned off once set on. */
   bool cache_id;
+  /* Member tags set by the application, e.g. the port a member forwards to,
+   * so that all groups using the tagged members are updated in one call.
+   *  tag_mbrs - Key: tag, Value: bf_map_t * of the tagged member handles
+   *  mbr_tags - Key: member handle, Value: tag
+   */
+  bf_map_t tag_mbrs;
+  bf_map_t mbr_tags;
 } sel_tbl_info_t;
 
 #define SEL_TBL_IS_SYMMETRIC(x) (x->is_symmetric == true)
@@ -461,6 +468,33 @@ pipe_status_t rmt_sel_grp_mbrs_set(pipe_sess_hdl_t sess_hdl,
                                    uint32_t pipe_api_flags,
                                    struct pipe_mgr_sel_move_list_t **move_list);
 
+/*!
+ * API function to set a weighted membership of a group, weights are reduced
+ * to fit in max_slots or in the group size when max_slots is zero
+ */
+pipe_status_t rmt_sel_grp_mbrs_set_weighted(
+    pipe_sess_hdl_t sess_hdl,
+    bf_dev_id_t device_id,
+    pipe_sel_tbl_hdl_t sel_tbl_hdl,
+    pipe_sel_grp_hdl_t sel_grp_hdl,
+    uint32_t num_mbrs,
+    pipe_adt_ent_hdl_t *mbrs,
+    uint32_t *weights,
+    bool *enable,
+    uint32_t max_slots,
+    pipe_sel_grp_weight_report_t *report,
+    uint32_t pipe_api_flags,
+    struct pipe_mgr_sel_move_list_t **move_list);
+
+/*!
+ * Reduce member weights so that their total fits in max_slots
+ */
+pipe_status_t pipe_mgr_sel_weights_reduce(uint32_t num_mbrs,
+                                          const uint32_t *weights,
+                                          uint32_t max_slots,
+                                          uint32_t *out_weights,
+                                          pipe_sel_grp_weight_report_t *rpt);
+
 /*!
  * API function to get membership of a group
  */
@@ -472,6 +506,46 @@ pipe_status_t rmt_sel_grp_mbrs_get(bf_dev_id_t device_id,
                                    bool *enable,
                                    uint32_t *mbrs_populated);
 
+/*!
+ * API function to tag a member of the action profile used by a selection
+ * table, a member has at most one tag
+ */
+pipe_status_t rmt_sel_mbr_tag_set(pipe_sess_hdl_t sess_hdl,
+                                  bf_dev_id_t dev_id,
+                                  pipe_sel_tbl_hdl_t sel_tbl_hdl,
+                                  pipe_adt_ent_hdl_t adt_ent_hdl,
+                                  uint32_t tag);
+
+/*!
+ * API function to remove the tag of a member
+ */
+pipe_status_t rmt_sel_mbr_tag_clear(pipe_sess_hdl_t sess_hdl,
+                                    bf_dev_id_t dev_id,
+                                    pipe_sel_tbl_hdl_t sel_tbl_hdl,
+                                    pipe_adt_ent_hdl_t adt_ent_hdl);
+
+/*!
+ * Remove the tag of an action profile member being deleted from all the
+ * selection tables using that action profile
+ */
+void rmt_sel_adt_ent_del_tag_clear(bf_dev_id_t dev_id,
+                                   pipe_adt_tbl_hdl_t adt_tbl_hdl,
+                                   pipe_adt_ent_hdl_t adt_ent_hdl);
+
+/*!
+ * API function to disable or re-enable the members with a tag in all the
+ * groups of a selection table
+ */
+pipe_status_t rmt_sel_tag_mbrs_state_set(
+    pipe_sess_hdl_t sess_hdl,
+    bf_dev_id_t dev_id,
+    pipe_sel_tbl_hdl_t sel_tbl_hdl,
+    uint32_t tag,
+    bool enable,
+    uint32_t pipe_api_flags,
+    uint32_t *num_updated,
+    struct pipe_mgr_sel_move_list_t **move_head_p);
+
 /* API function to disable a group member of a selection table */
 pipe_status_t rmt_sel_grp_mbr_disable(
     pipe_sess_hdl_t sess_hdl,
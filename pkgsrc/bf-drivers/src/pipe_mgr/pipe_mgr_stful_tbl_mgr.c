@@ -88,20 +88,24 @@ static bool table_width_is_valid(int width) {
   return 1 == width || 8 == width || 16 == width || 32 == width || 64 == width;
 }
 
+static enum stateful_width stful_width(int width, bool dbl_width) {
+  if (1 == width) return STFL_WDTH_1;
+  if (8 == width && !dbl_width) return STFL_WDTH_8;
+  if (8 == width && dbl_width) return STFL_WDTH_8x2;
+  if (16 == width && !dbl_width) return STFL_WDTH_16;
+  if (16 == width && dbl_width) return STFL_WDTH_16x2;
+  if (32 == width && !dbl_width) return STFL_WDTH_32;
+  if (32 == width && dbl_width) return STFL_WDTH_32x2;
+  if (64 == width && !dbl_width) return STFL_WDTH_64;
+  if (64 == width && dbl_width) return STFL_WDTH_64x2;
+  PIPE_MGR_DBGCHK(0);
+  return 0;
+}
+
 static enum stateful_width table_width(struct pipe_mgr_stful_tbl *t) {
   PIPE_MGR_DBGCHK(t);
   if (!t) return 0;
-  if (1 == t->width) return STFL_WDTH_1;
-  if (8 == t->width && !t->dbl_width) return STFL_WDTH_8;
-  if (8 == t->width && t->dbl_width) return STFL_WDTH_8x2;
-  if (16 == t->width && !t->dbl_width) return STFL_WDTH_16;
-  if (16 == t->width && t->dbl_width) return STFL_WDTH_16x2;
-  if (32 == t->width && !t->dbl_width) return STFL_WDTH_32;
-  if (32 == t->width && t->dbl_width) return STFL_WDTH_32x2;
-  if (64 == t->width && !t->dbl_width) return STFL_WDTH_64;
-  if (64 == t->width && t->dbl_width) return STFL_WDTH_64x2;
-  PIPE_MGR_DBGCHK(0);
-  return 0;
+  return stful_width(t->width, t->dbl_width);
 }
 
 static int bit_width_from_stateful_width(enum stateful_width w) {
@@ -2876,12 +2880,87 @@ static void rd_tbl_cb(void *cookie,
   if (user_cb_safe) {
     pipe_stful_tbl_sync_cback_fn sync_cb = t->sync_cb;
     void *sync_cookie = t->sync_cookie;
+    struct pipe_mgr_stful_sync_waiter *w = t->sync_waiters;
     t->sync_cb = NULL;
     t->sync_cookie = NULL;
-    if (sync_cb) sync_cb(dev, sync_cookie);
+    t->sync_waiters = NULL;
+    t->tbl_sync_in_progress = false;
+    pipe_mgr_stful_sync_complete(dev, sync_cb, sync_cookie, w);
   }
 }
 
+/* Notify the requester of a table sync and then everyone who joined the sync
+ * while it was in flight, in the order they asked.  The waiters are freed. */
+void pipe_mgr_stful_sync_complete(bf_dev_id_t dev,
+                                  pipe_stful_tbl_sync_cback_fn cb,
+                                  void *cookie,
+                                  struct pipe_mgr_stful_sync_waiter *waiters) {
+  if (cb) cb(dev, cookie);
+  while (waiters) {
+    struct pipe_mgr_stful_sync_waiter *next = waiters->next;
+    waiters->cb(dev, waiters->cookie);
+    PIPE_MGR_FREE(waiters);
+    waiters = next;
+  }
+}
+
+pipe_status_t pipe_mgr_stful_sync_waiter_add(
+    struct pipe_mgr_stful_sync_waiter **waiters,
+    pipe_stful_tbl_sync_cback_fn cb,
+    void *cookie) {
+  if (!cb) return PIPE_INVALID_ARG;
+  struct pipe_mgr_stful_sync_waiter *w = PIPE_MGR_MALLOC(sizeof *w);
+  if (!w) return PIPE_NO_SYS_RESOURCES;
+  w->next = NULL;
+  w->cb = cb;
+  w->cookie = cookie;
+  while (*waiters) waiters = &(*waiters)->next;
+  *waiters = w;
+  return PIPE_SUCCESS;
+}
+
+/* Queue an asynchronous sync request behind the table sync already in flight.
+ * Only requests for pipes that sync is reading can be served by it. */
+static pipe_status_t stful_tbl_sync_join(struct pipe_mgr_stful_tbl *t,
+                                         pipe_bitmap_t *pipes,
+                                         pipe_stful_tbl_sync_cback_fn cback_fn,
+                                         void *cookie) {
+  if (!cback_fn) return PIPE_ALREADY_EXISTS;
+  bf_dev_pipe_t p;
+  PIPE_BITMAP_ITER(pipes, p) {
+    if (!PIPE_BITMAP_GET(&t->tbl_sync_pipes, p)) return PIPE_ALREADY_EXISTS;
+  }
+  return pipe_mgr_stful_sync_waiter_add(&t->sync_waiters, cback_fn, cookie);
+}
+
+/* Determine the pipes a sync of the whole table for dev_tgt reads.  Allow
+ * BF_DEV_PIPE_ALL even for asymmetric tables and allow specific pipes even for
+ * symmetric tables.  This is because the entire table will be sync'ed and the
+ * data can be different in each pipe even for symmetric tables since the data
+ * plane is modifying the table contents. */
+static pipe_status_t stful_tbl_sync_pipes(struct pipe_mgr_stful_tbl *t,
+                                          dev_target_t dev_tgt,
+                                          pipe_bitmap_t *pipes) {
+  PIPE_BITMAP_INIT(pipes, PIPE_BMP_SIZE);
+  if (BF_DEV_PIPE_ALL == dev_tgt.dev_pipe_id) {
+    PIPE_BITMAP_ASSIGN(pipes, &t->pipes);
+  } else {
+    if (!table_is_in_pipe(t, dev_tgt.dev_pipe_id)) return PIPE_INVALID_ARG;
+    if (t->symmetric) {
+      PIPE_BITMAP_SET(pipes, dev_tgt.dev_pipe_id);
+    } else {
+      struct pipe_mgr_stful_tbl_inst *stbl_inst = NULL;
+      stbl_inst = get_stful_tbl_inst_by_pipe_id(t, dev_tgt.dev_pipe_id);
+      if (!stbl_inst) {
+        LOG_ERROR("%s:%d Stful table inst lookup failure", __func__, __LINE__);
+        return PIPE_INVALID_ARG;
+      }
+      PIPE_BITMAP_ASSIGN(pipes, &stbl_inst->pipe_bmp);
+    }
+  }
+  return PIPE_SUCCESS;
+}
+
 pipe_status_t pipe_mgr_stful_tbl_sync(pipe_sess_hdl_t sess_hdl,
                                       dev_target_t dev_tgt,
                                       pipe_stful_tbl_hdl_t st_hdl,
@@ -2894,35 +2973,20 @@ pipe_status_t pipe_mgr_stful_tbl_sync(pipe_sess_hdl_t sess_hdl,
     PIPE_MGR_DBGCHK(0);
     return PIPE_INVALID_ARG;
   }
-  /* Only one read in progress at a time. */
-  if (t->sync_cb) return PIPE_ALREADY_EXISTS;
   /* Validate the dev target. */
   if (!pipe_mgr_valid_dev_tgt(dev_tgt, __func__, __LINE__)) {
     return PIPE_INVALID_ARG;
   }
 
-  /* Allow BF_DEV_PIPE_ALL even for asymmetric tables and allow specific
-   * pipes even for symmetric tables.  This is because the entire table will
-   * be sync'ed and the data can be different in each pipe even for symmetric
-   * tables since the data plane is modifying the table contents. */
   pipe_bitmap_t pipes;
-  PIPE_BITMAP_INIT(&pipes, PIPE_BMP_SIZE);
-  if (BF_DEV_PIPE_ALL == dev_tgt.dev_pipe_id) {
-    PIPE_BITMAP_ASSIGN(&pipes, &t->pipes);
-  } else {
-    if (!table_is_in_pipe(t, dev_tgt.dev_pipe_id)) return PIPE_INVALID_ARG;
-    if (t->symmetric) {
-      PIPE_BITMAP_SET(&pipes, dev_tgt.dev_pipe_id);
-    } else {
-      struct pipe_mgr_stful_tbl_inst *stbl_inst = NULL;
-      stbl_inst = get_stful_tbl_inst_by_pipe_id(t, dev_tgt.dev_pipe_id);
-      if (!stbl_inst) {
-        LOG_ERROR("%s:%d Stful table inst lookup failure", __func__, __LINE__);
-        return PIPE_INVALID_ARG;
-      }
-      PIPE_BITMAP_ASSIGN(&pipes, &stbl_inst->pipe_bmp);
-    }
-  }
+  sts = stful_tbl_sync_pipes(t, dev_tgt, &pipes);
+  if (PIPE_SUCCESS != sts) return sts;
+
+  /* Only one read in progress at a time, but asynchronous consumers can share
+   * a table sync which is already running. */
+  if (t->tbl_sync_in_progress)
+    return stful_tbl_sync_join(t, &pipes, cback_fn, cookie);
+  if (t->sync_cb) return PIPE_ALREADY_EXISTS;
 
   /* Send one read instruction for each RAM line the table occupies. */
   rmt_dev_info_t *dev_info = t->dev_info;
@@ -2950,10 +3014,17 @@ pipe_status_t pipe_mgr_stful_tbl_sync(pipe_sess_hdl_t sess_hdl,
   }
   t->sync_cb = cback_fn;
   t->sync_cookie = cookie;
+  t->tbl_sync_in_progress = cback_fn != NULL;
+  PIPE_BITMAP_ASSIGN(&t->tbl_sync_pipes, &pipes);
   unsigned int p = 0;
   for (; p < t->dev_info->num_active_pipes; ++p) t->tbl_sync_rcvd_sz[p] = 0;
   sts = pipe_mgr_drv_ilist_rd_push(&sess_hdl, rd_tbl_cb, t);
-  if (PIPE_SUCCESS != sts) goto cleanup;
+  if (PIPE_SUCCESS != sts) {
+    t->sync_cb = NULL;
+    t->sync_cookie = NULL;
+    t->tbl_sync_in_progress = false;
+    goto cleanup;
+  }
 
   if (!cback_fn) {
     sts = pipe_mgr_drv_ilist_rd_cmplt_all(&sess_hdl);
@@ -3675,6 +3746,389 @@ pipe_status_t pipe_mgr_stful_ent_query_range(pipe_sess_hdl_t sess_hdl,
   return s;
 }
 
+/* Maximum number of changes handed to an export callback in one report. */
+#define PIPE_MGR_STFUL_EXPORT_CHUNK 1024
+
+/* Split a stateful spec into the low (or only) and high halves of the cell. */
+static void stful_spec_to_u64(enum stateful_width w,
+                              const pipe_stful_mem_spec_t *v,
+                              uint64_t *lo,
+                              uint64_t *hi) {
+  *lo = 0;
+  *hi = 0;
+  switch (w) {
+    case STFL_WDTH_1:
+      *lo = v->bit;
+      break;
+    case STFL_WDTH_8:
+      *lo = v->byte;
+      break;
+    case STFL_WDTH_8x2:
+      *lo = v->dbl_byte.lo;
+      *hi = v->dbl_byte.hi;
+      break;
+    case STFL_WDTH_16:
+      *lo = v->half;
+      break;
+    case STFL_WDTH_16x2:
+      *lo = v->dbl_half.lo;
+      *hi = v->dbl_half.hi;
+      break;
+    case STFL_WDTH_32:
+      *lo = v->word;
+      break;
+    case STFL_WDTH_32x2:
+      *lo = v->dbl_word.lo;
+      *hi = v->dbl_word.hi;
+      break;
+    case STFL_WDTH_64:
+      *lo = v->dbl;
+      break;
+    case STFL_WDTH_64x2:
+      *lo = v->dbl_dbl.lo;
+      *hi = v->dbl_dbl.hi;
+      break;
+    default:
+      PIPE_MGR_DBGCHK(0);
+      break;
+  }
+}
+
+static void stful_export_free(struct pipe_stful_export_s *e) {
+  if (e->baseline) {
+    for (int i = 0; i < e->num_stages * e->num_pipes; ++i) {
+      if (e->baseline[i]) PIPE_MGR_FREE(e->baseline[i]);
+    }
+    PIPE_MGR_FREE(e->baseline);
+  }
+  if (e->num_entries) PIPE_MGR_FREE(e->num_entries);
+  if (e->db_sz) PIPE_MGR_FREE(e->db_sz);
+  if (e->images) PIPE_MGR_FREE(e->images);
+  if (e->sum_lo) PIPE_MGR_FREE(e->sum_lo);
+  if (e->sum_hi) PIPE_MGR_FREE(e->sum_hi);
+  if (e->chg) PIPE_MGR_FREE(e->chg);
+  PIPE_MGR_LOCK_DESTROY(&e->mtx);
+  PIPE_MGR_FREE(e);
+}
+
+static bool stful_export_destroyed(struct pipe_stful_export_s *e) {
+  PIPE_MGR_LOCK(&e->mtx);
+  bool destroyed = e->destroy_pending;
+  PIPE_MGR_UNLOCK(&e->mtx);
+  return destroyed;
+}
+
+/* End a poll, returns true if the export was destroyed meanwhile and must now
+ * be freed by the caller. */
+static bool stful_export_poll_done(struct pipe_stful_export_s *e) {
+  PIPE_MGR_LOCK(&e->mtx);
+  bool destroyed = e->destroy_pending;
+  e->poll_pending = false;
+  PIPE_MGR_UNLOCK(&e->mtx);
+  return destroyed;
+}
+
+/* Hand a report to the callback unless the export has been destroyed, returns
+ * false if it has and the diff should stop. */
+static bool stful_export_report(struct pipe_stful_export_s *e,
+                                const pipe_stful_export_report_t *r) {
+  if (stful_export_destroyed(e)) return false;
+  e->cb(e->dev_tgt.device_id, r, e->cookie);
+  return true;
+}
+
+/* Record one changed cell, in changes mode a full report buffer is handed to
+ * the callback before more changes are collected. */
+static bool stful_export_add_change(struct pipe_stful_export_s *e,
+                                    enum stateful_width w,
+                                    bf_dev_pipe_t pipe,
+                                    pipe_stful_mem_idx_t index,
+                                    const pipe_stful_mem_spec_t *new_val,
+                                    const pipe_stful_mem_spec_t *old_val) {
+  if (PIPE_STFUL_EXPORT_SUMS == e->mode) {
+    uint64_t new_lo, new_hi, old_lo, old_hi;
+    stful_spec_to_u64(w, new_val, &new_lo, &new_hi);
+    stful_spec_to_u64(w, old_val, &old_lo, &old_hi);
+    e->sum_lo[pipe] += new_lo - old_lo;
+    e->sum_hi[pipe] += new_hi - old_hi;
+    ++e->num_chg;
+    return true;
+  }
+  if (e->num_chg == PIPE_MGR_STFUL_EXPORT_CHUNK) {
+    pipe_stful_export_report_t r = {0};
+    r.pipe = pipe;
+    r.num_changes = e->num_chg;
+    r.changes = e->chg;
+    r.last = false;
+    if (!stful_export_report(e, &r)) return false;
+    e->num_chg = 0;
+  }
+  e->chg[e->num_chg].index = index;
+  e->chg[e->num_chg].value = *new_val;
+  ++e->num_chg;
+  return true;
+}
+
+/* Compare one stage of a pipe's freshly synced data against the export's
+ * baseline.  The scan XORs four RAM lines (64 bytes) at a time so unchanged
+ * regions cost a handful of word compares; only RAM lines which differ are
+ * decoded and copied into the baseline. */
+static bool stful_export_diff_stage(struct pipe_stful_export_s *e,
+                                    int s,
+                                    bf_dev_pipe_t pipe,
+                                    pipe_stful_mem_idx_t first_idx,
+                                    const uint8_t *image) {
+  enum stateful_width w = e->width;
+  uint32_t per_line = 128 / bit_width_from_stateful_width(w);
+  uint32_t num_lines = e->db_sz[s] / 16;
+  const uint64_t *cur = (const uint64_t *)image;
+  uint64_t *old = (uint64_t *)e->baseline[s * e->num_pipes + pipe];
+
+  for (uint32_t blk = 0; blk < num_lines; blk += 4) {
+    uint32_t n = num_lines - blk < 4 ? num_lines - blk : 4;
+    uint64_t x = 0;
+    for (uint32_t i = 2 * blk; i < 2 * (blk + n); ++i) x |= cur[i] ^ old[i];
+    if (!x) continue;
+
+    for (uint32_t line = blk; line < blk + n; ++line) {
+      uint64_t *o = old + 2 * line;
+      const uint64_t *c = cur + 2 * line;
+      if (!((c[0] ^ o[0]) | (c[1] ^ o[1]))) continue;
+      for (uint32_t sw = 0; sw < per_line; ++sw) {
+        uint32_t idx = line * per_line + sw;
+        if (idx >= e->num_entries[s]) break;
+        pipe_stful_mem_spec_t new_val, old_val;
+        PIPE_MGR_MEMSET(&new_val, 0, sizeof new_val);
+        PIPE_MGR_MEMSET(&old_val, 0, sizeof old_val);
+        stful_data_decode(w, idx, &new_val, (uint8_t *)c);
+        stful_data_decode(w, idx, &old_val, (uint8_t *)o);
+        if (!PIPE_MGR_MEMCMP(&new_val, &old_val, sizeof new_val)) continue;
+        if (!stful_export_add_change(
+                e, w, pipe, first_idx + idx, &new_val, &old_val))
+          return false;
+      }
+      o[0] = c[0];
+      o[1] = c[1];
+    }
+  }
+  return true;
+}
+
+/* Diff one pipe's synced data, images[s] holding the pipe's copy of stage s or
+ * NULL if it was not read, and send the pipe's final report.  Returns false if
+ * the export was destroyed part way through. */
+bool pipe_mgr_stful_export_pipe_diff(struct pipe_stful_export_s *e,
+                                     bf_dev_pipe_t pipe,
+                                     uint8_t *const *images) {
+  pipe_stful_mem_idx_t first_idx = 0;
+  e->num_chg = 0;
+  for (int s = 0; s < e->num_stages; ++s) {
+    if (images[s] && !stful_export_diff_stage(e, s, pipe, first_idx, images[s]))
+      return false;
+    first_idx += e->num_entries[s];
+  }
+  pipe_stful_export_report_t r = {0};
+  r.pipe = pipe;
+  r.num_changes = e->num_chg;
+  r.last = true;
+  if (PIPE_STFUL_EXPORT_SUMS == e->mode) {
+    r.sum_lo = e->sum_lo[pipe];
+    r.sum_hi = e->sum_hi[pipe];
+  } else {
+    r.changes = e->chg;
+  }
+  return stful_export_report(e, &r);
+}
+
+/* The export's copy of the layout must still describe the table. */
+static bool stful_export_tbl_matches(struct pipe_stful_export_s *e,
+                                     struct pipe_mgr_stful_tbl *t) {
+  if (!t || t->num_stages != e->num_stages) return false;
+  if (table_width(t) != (enum stateful_width)e->width) return false;
+  for (int s = 0; s < t->num_stages; ++s) {
+    if (t->stages[s].num_entries != e->num_entries[s]) return false;
+    if (t->stages[s].db_sz != e->db_sz[s]) return false;
+  }
+  return true;
+}
+
+static void stful_export_sync_cb(bf_dev_id_t dev, void *cookie) {
+  struct pipe_stful_export_s *e = cookie;
+  struct pipe_mgr_stful_tbl *t = NULL;
+  if (stful_export_destroyed(e)) goto done;
+
+  t = stful_tbl_lkup(dev, e->hdl);
+  if (!stful_export_tbl_matches(e, t)) {
+    LOG_ERROR("Dev %d stateful export of tbl 0x%x lost its table",
+              dev,
+              e->hdl);
+    goto done;
+  }
+
+  for (int p = 0; p < e->num_pipes; ++p) {
+    if (!(e->pipe_msk & (1u << p))) continue;
+    for (int s = 0; s < e->num_stages; ++s)
+      e->images[s] = t->stages[s].db ? t->stages[s].db[p] : NULL;
+    if (!pipe_mgr_stful_export_pipe_diff(e, p, e->images)) break;
+  }
+
+done:
+  if (stful_export_poll_done(e)) stful_export_free(e);
+}
+
+pipe_status_t pipe_mgr_stful_export_alloc(dev_target_t dev_tgt,
+                                         pipe_stful_tbl_hdl_t hdl,
+                                         pipe_stful_export_mode_e mode,
+                                         pipe_stful_export_cback_fn cb,
+                                         void *cookie,
+                                         int width,
+                                         bool dbl_width,
+                                         int num_stages,
+                                         const uint32_t *num_entries,
+                                         const uint32_t *db_sz,
+                                         int num_pipes,
+                                         uint32_t pipe_msk,
+                                         struct pipe_stful_export_s **exp_p) {
+  if (!cb || !exp_p || num_stages <= 0 || num_pipes <= 0)
+    return PIPE_INVALID_ARG;
+  if (PIPE_STFUL_EXPORT_CHANGES != mode && PIPE_STFUL_EXPORT_SUMS != mode)
+    return PIPE_INVALID_ARG;
+  enum stateful_width w = stful_width(width, dbl_width);
+  if (!w) return PIPE_INVALID_ARG;
+
+  struct pipe_stful_export_s *e = PIPE_MGR_CALLOC(1, sizeof *e);
+  if (!e) return PIPE_NO_SYS_RESOURCES;
+  PIPE_MGR_LOCK_INIT(e->mtx);
+  e->dev_tgt = dev_tgt;
+  e->hdl = hdl;
+  e->mode = mode;
+  e->cb = cb;
+  e->cookie = cookie;
+  e->width = w;
+  e->pipe_msk = pipe_msk;
+  e->num_stages = num_stages;
+  e->num_pipes = num_pipes;
+  e->num_entries = PIPE_MGR_CALLOC(num_stages, sizeof *e->num_entries);
+  e->db_sz = PIPE_MGR_CALLOC(num_stages, sizeof *e->db_sz);
+  e->images = PIPE_MGR_CALLOC(num_stages, sizeof *e->images);
+  e->baseline = PIPE_MGR_CALLOC(num_stages * num_pipes, sizeof *e->baseline);
+  e->sum_lo = PIPE_MGR_CALLOC(num_pipes, sizeof *e->sum_lo);
+  e->sum_hi = PIPE_MGR_CALLOC(num_pipes, sizeof *e->sum_hi);
+  if (!e->num_entries || !e->db_sz || !e->images || !e->baseline ||
+      !e->sum_lo || !e->sum_hi)
+    goto cleanup;
+  if (PIPE_STFUL_EXPORT_CHANGES == mode) {
+    e->chg = PIPE_MGR_MALLOC(PIPE_MGR_STFUL_EXPORT_CHUNK * sizeof *e->chg);
+    if (!e->chg) goto cleanup;
+  }
+  for (int s = 0; s < num_stages; ++s) {
+    e->num_entries[s] = num_entries[s];
+    e->db_sz[s] = db_sz[s];
+    for (int p = 0; p < num_pipes; ++p) {
+      if (!(pipe_msk & (1u << p))) continue;
+      uint8_t **b = &e->baseline[s * num_pipes + p];
+      *b = PIPE_MGR_CALLOC(db_sz[s], 1);
+      if (!*b) goto cleanup;
+    }
+  }
+  *exp_p = e;
+  return PIPE_SUCCESS;
+
+cleanup:
+  stful_export_free(e);
+  return PIPE_NO_SYS_RESOURCES;
+}
+
+pipe_status_t pipe_mgr_stful_export_create(dev_target_t dev_tgt,
+                                          pipe_stful_tbl_hdl_t hdl,
+                                          pipe_stful_export_mode_e mode,
+                                          pipe_stful_export_cback_fn cb,
+                                          void *cookie,
+                                          struct pipe_stful_export_s **exp_p) {
+  pipe_status_t sts = PIPE_SUCCESS;
+  if (!pipe_mgr_valid_dev_tgt(dev_tgt, __func__, __LINE__))
+    return PIPE_INVALID_ARG;
+  struct pipe_mgr_stful_tbl *t = stful_tbl_lkup(dev_tgt.device_id, hdl);
+  if (!t) return PIPE_INVALID_ARG;
+  if (t->direct) {
+    LOG_ERROR("Dev %d tbl 0x%x cannot export a direct stateful table",
+              dev_tgt.device_id,
+              hdl);
+    return PIPE_NOT_SUPPORTED;
+  }
+
+  pipe_bitmap_t pipes;
+  sts = stful_tbl_sync_pipes(t, dev_tgt, &pipes);
+  if (PIPE_SUCCESS != sts) return sts;
+  uint32_t pipe_msk = 0;
+  bf_dev_pipe_t p;
+  PIPE_BITMAP_ITER(&pipes, p) { pipe_msk |= 1u << p; }
+
+  uint32_t *num_entries = PIPE_MGR_CALLOC(t->num_stages, sizeof *num_entries);
+  uint32_t *db_sz = PIPE_MGR_CALLOC(t->num_stages, sizeof *db_sz);
+  if (!num_entries || !db_sz) {
+    sts = PIPE_NO_SYS_RESOURCES;
+    goto done;
+  }
+  for (int s = 0; s < t->num_stages; ++s) {
+    num_entries[s] = t->stages[s].num_entries;
+    db_sz[s] = t->stages[s].db_sz;
+  }
+  sts = pipe_mgr_stful_export_alloc(dev_tgt,
+                                    hdl,
+                                    mode,
+                                    cb,
+                                    cookie,
+                                    t->width,
+                                    t->dbl_width,
+                                    t->num_stages,
+                                    num_entries,
+                                    db_sz,
+                                    t->dev_info->num_active_pipes,
+                                    pipe_msk,
+                                    exp_p);
+
+done:
+  if (num_entries) PIPE_MGR_FREE(num_entries);
+  if (db_sz) PIPE_MGR_FREE(db_sz);
+  return sts;
+}
+
+pipe_status_t pipe_mgr_stful_export_poll(pipe_sess_hdl_t sess_hdl,
+                                        struct pipe_stful_export_s *exp) {
+  PIPE_MGR_LOCK(&exp->mtx);
+  bool busy = exp->poll_pending || exp->destroy_pending;
+  if (!busy) exp->poll_pending = true;
+  PIPE_MGR_UNLOCK(&exp->mtx);
+  if (busy) return PIPE_ALREADY_EXISTS;
+
+  pipe_status_t sts = pipe_mgr_stful_tbl_sync(
+      sess_hdl, exp->dev_tgt, exp->hdl, stful_export_sync_cb, exp);
+  if (PIPE_SUCCESS != sts) {
+    LOG_ERROR("Dev %d pipe %x stateful export of tbl 0x%x failed, %s",
+              exp->dev_tgt.device_id,
+              exp->dev_tgt.dev_pipe_id,
+              exp->hdl,
+              pipe_str_err(sts));
+    /* No completion is coming, a destroy which raced with the failed sync
+     * left the free to us. */
+    if (stful_export_poll_done(exp)) stful_export_free(exp);
+  }
+  return sts;
+}
+
+pipe_status_t pipe_mgr_stful_export_destroy(struct pipe_stful_export_s *exp) {
+  /* The sync completion owns the export while a poll is in flight, let it do
+   * the free.  This also makes destroying the export from its own report
+   * callback safe. */
+  PIPE_MGR_LOCK(&exp->mtx);
+  bool in_poll = exp->poll_pending;
+  exp->destroy_pending = true;
+  PIPE_MGR_UNLOCK(&exp->mtx);
+  if (!in_poll) stful_export_free(exp);
+  return PIPE_SUCCESS;
+}
+
 pipe_status_t pipe_mgr_stful_direct_ent_query(pipe_sess_hdl_t sess_hdl,
                                               bf_dev_id_t dev,
                                               pipe_mat_tbl_hdl_t mat_tbl_hdl,
@@ -4149,6 +4603,20 @@ pipe_status_t pipe_mgr_stful_tbl_del(bf_dev_id_t dev,
     PIPE_MGR_DBGCHK(0);
     return PIPE_INVALID_ARG;
   }
+  /* An asynchronous sync which is still pending will never complete, release
+   * its requesters now.  The table is already out of the map so they, and any
+   * export polling it, find it gone rather than reading freed data. */
+  if (t->sync_cb || t->sync_waiters) {
+    pipe_stful_tbl_sync_cback_fn sync_cb = t->sync_cb;
+    void *sync_cookie = t->sync_cookie;
+    struct pipe_mgr_stful_sync_waiter *w = t->sync_waiters;
+    t->sync_cb = NULL;
+    t->sync_cookie = NULL;
+    t->sync_waiters = NULL;
+    t->tbl_sync_in_progress = false;
+    LOG_TRACE("Dev %d stateful tbl 0x%x deleted with a sync pending", dev, hdl);
+    pipe_mgr_stful_sync_complete(dev, sync_cb, sync_cookie, w);
+  }
   if (t->stages) {
     for (int s = 0; s < t->num_stages && t->stages[s].db; ++s) {
       for (int p = 0; p < (int)t->dev_info->num_active_pipes; ++p) {
@@ -4302,6 +4770,7 @@ pipe_status_t pipe_mgr_stful_tbl_add(pipe_sess_hdl_t shdl,
 
   PIPE_BITMAP_INIT(&stbl->pipes, PIPE_BMP_SIZE);
   PIPE_BITMAP_ASSIGN(&stbl->pipes, pipes);
+  PIPE_BITMAP_INIT(&stbl->tbl_sync_pipes, PIPE_BMP_SIZE);
 
   stbl->dev_info = dev_info;
   stbl->hdl = hdl;
@@ -49,6 +49,14 @@ struct pipe_mgr_stful_tbl_inst {
   pipe_bitmap_t pipe_bmp;
 };
 
+/* An asynchronous table sync request which joined a sync already in flight
+ * and is notified when that sync completes. */
+struct pipe_mgr_stful_sync_waiter {
+  struct pipe_mgr_stful_sync_waiter *next;
+  pipe_stful_tbl_sync_cback_fn cb;
+  void *cookie;
+};
+
 enum pipe_mgr_stful_tbl_type {
   pipe_mgr_stful_tbl_type_normal,
   pipe_mgr_stful_tbl_type_log,
@@ -120,6 +128,12 @@ struct pipe_mgr_stful_tbl {
   bool skip_shadow;
   pipe_stful_tbl_sync_cback_fn sync_cb;
   void *sync_cookie;
+  /* Set while an asynchronous sync of the whole table is in flight, later
+   * requests covering a subset of tbl_sync_pipes are queued on sync_waiters
+   * rather than rejected. */
+  bool tbl_sync_in_progress;
+  pipe_bitmap_t tbl_sync_pipes;
+  struct pipe_mgr_stful_sync_waiter *sync_waiters;
   bool logging_in_progress;
   uint32_t *tbl_sync_rcvd_sz;
   int sync_row_idx;    // When syncing one entry, the ram+line it is in
@@ -130,6 +144,38 @@ struct pipe_mgr_stful_tbl {
   uint32_t direction;  // Direction
 };
 
+/* A change tracking export of an indirect stateful table, see
+ * pipe_stful_export_create.  The baseline holds the table contents as of the
+ * previous poll, one buffer per stage and pipe laid out like the stage's db,
+ * and is updated in place as changed RAM lines are found.  The table's layout
+ * is copied when the export is created so a table which is deleted or
+ * replaced while a poll is in flight is detected rather than misread. */
+struct pipe_stful_export_s {
+  dev_target_t dev_tgt;
+  pipe_stful_tbl_hdl_t hdl;
+  pipe_stful_export_mode_e mode;
+  pipe_stful_export_cback_fn cb;
+  void *cookie;
+  int width;         /* Cell width, an enum stateful_width. */
+  uint32_t pipe_msk; /* Pipes being exported. */
+  int num_stages;
+  int num_pipes;
+  uint32_t *num_entries; /* Per stage entry counts. */
+  uint32_t *db_sz;       /* Per stage db sizes. */
+  uint8_t **images;      /* Per stage scratch, one pipe's synced data. */
+  uint8_t **baseline;    /* Indexed by stage * num_pipes + pipe. */
+  uint64_t *sum_lo;      /* Per pipe running totals for sums mode. */
+  uint64_t *sum_hi;
+  pipe_stful_export_change_t *chg; /* Report buffer for changes mode. */
+  uint32_t num_chg;
+  /* Protects poll_pending and destroy_pending.  While a poll is in flight the
+   * sync completion owns the export and a destroy only marks it, the
+   * completion then does the free. */
+  pipe_mgr_mutex_t mtx;
+  bool poll_pending;
+  bool destroy_pending;
+};
+
 struct pipe_mgr_stful_op_list_t;
 
 struct pipe_mgr_stful_tbl *pipe_mgr_stful_tbl_get(bf_dev_id_t dev,
@@ -167,6 +213,39 @@ pipe_status_t pipe_mgr_stful_tbl_sync(pipe_sess_hdl_t sess_hdl,
                                       pipe_stful_tbl_hdl_t st_hdl,
                                       pipe_stful_tbl_sync_cback_fn cb,
                                       void *cookie);
+void pipe_mgr_stful_sync_complete(bf_dev_id_t dev,
+                                  pipe_stful_tbl_sync_cback_fn cb,
+                                  void *cookie,
+                                  struct pipe_mgr_stful_sync_waiter *waiters);
+pipe_status_t pipe_mgr_stful_sync_waiter_add(
+    struct pipe_mgr_stful_sync_waiter **waiters,
+    pipe_stful_tbl_sync_cback_fn cb,
+    void *cookie);
+pipe_status_t pipe_mgr_stful_export_alloc(dev_target_t dev_tgt,
+                                         pipe_stful_tbl_hdl_t hdl,
+                                         pipe_stful_export_mode_e mode,
+                                         pipe_stful_export_cback_fn cb,
+                                         void *cookie,
+                                         int width,
+                                         bool dbl_width,
+                                         int num_stages,
+                                         const uint32_t *num_entries,
+                                         const uint32_t *db_sz,
+                                         int num_pipes,
+                                         uint32_t pipe_msk,
+                                         struct pipe_stful_export_s **exp_p);
+bool pipe_mgr_stful_export_pipe_diff(struct pipe_stful_export_s *exp,
+                                     bf_dev_pipe_t pipe,
+                                     uint8_t *const *images);
+pipe_status_t pipe_mgr_stful_export_create(dev_target_t dev_tgt,
+                                          pipe_stful_tbl_hdl_t hdl,
+                                          pipe_stful_export_mode_e mode,
+                                          pipe_stful_export_cback_fn cb,
+                                          void *cookie,
+                                          struct pipe_stful_export_s **exp_p);
+pipe_status_t pipe_mgr_stful_export_poll(pipe_sess_hdl_t sess_hdl,
+                                        struct pipe_stful_export_s *exp);
+pipe_status_t pipe_mgr_stful_export_destroy(struct pipe_stful_export_s *exp);
 pipe_status_t pipe_mgr_stful_direct_tbl_sync(
     pipe_sess_hdl_t sess_hdl,
     dev_target_t dev_tgt,
@@ -47,6 +47,7 @@
 #include "pipe_mgr_select_tbl.h"
 #include "pipe_mgr_tcam.h"
 #include "pipe_mgr_tcam_hw.h"
+#include "pipe_mgr_hitless_ha.h"
 #include "pipe_mgr_learn.h"
 #include "pipe_mgr_idle.h"
 #include "pipe_mgr_hw_dump.h"
@@ -1355,6 +1356,177 @@ PIPE_MGR_CLI_CMD_DECLARE(drv_state) {
   return UCLI_STATUS_OK;
 }
 
+PIPE_MGR_CLI_CMD_DECLARE(dr_stats) {
+  PIPE_MGR_CLI_PROLOGUE("dr-stats",
+                        " Show completion DR servicing statistics",
+                        "-d <dev> [-c clear]");
+
+  static const char *ring_names[PIPE_MGR_DRV_RING_CNT] = {
+      "ilist0", "ilist1", "ilist2", "ilist3", "rd_blk", "wr_blk"};
+  bf_dev_id_t dev_id = 0;
+  bool got_dev = false;
+  bool clear = false;
+
+  int c;
+  while ((c = getopt(argc, argv, "d:c")) != -1) {
+    switch (c) {
+      case 'd':
+        if (!optarg) {
+          aim_printf(&uc->pvs, "%s", usage);
+          return UCLI_STATUS_OK;
+        }
+        dev_id = strtoul(optarg, NULL, 0);
+        got_dev = true;
+        break;
+      case 'c':
+        clear = true;
+        break;
+      default:
+        aim_printf(&uc->pvs, "%s", usage);
+        return UCLI_STATUS_OK;
+    }
+  }
+  if (!got_dev) {
+    aim_printf(&uc->pvs, "%s", usage);
+    return UCLI_STATUS_OK;
+  }
+  if (!pipe_mgr_get_dev_info(dev_id)) {
+    aim_printf(&uc->pvs, "Device %d does not exist\n", dev_id);
+    return UCLI_STATUS_OK;
+  }
+  if (clear) {
+    pipe_mgr_drv_ring_stats_clear(dev_id);
+    return UCLI_STATUS_OK;
+  }
+
+  aim_printf(&uc->pvs,
+             "%-6s %-6s %7s %10s %10s %10s %10s %8s %7s %10s %10s\n",
+             "Subdev",
+             "Ring",
+             "Pending",
+             "Pushed",
+             "Completed",
+             "Polls",
+             "Skips",
+             "AvgOcc",
+             "MaxOcc",
+             "AvgBusyUs",
+             "MaxBusyUs");
+  uint32_t num_subdevices = pipe_mgr_get_num_active_subdevices(dev_id);
+  for (uint32_t subdev = 0; subdev < num_subdevices; ++subdev) {
+    for (int r = 0; r < PIPE_MGR_DRV_RING_CNT; ++r) {
+      pipe_mgr_drv_ring_t st;
+      pipe_mgr_drv_ring_stats_get(dev_id, subdev, r, &st);
+      aim_printf(&uc->pvs,
+                 "%-6u %-6s %7d %10" PRIu64 " %10" PRIu64 " %10" PRIu64
+                 " %10" PRIu64 " %8.1f %7d %10" PRIu64 " %10" PRIu64 "\n",
+                 subdev,
+                 ring_names[r],
+                 st.pending,
+                 st.pushed,
+                 st.completed,
+                 st.polls,
+                 st.skips,
+                 st.polls ? (double)st.occupancy_sum / st.polls : 0.0,
+                 st.occupancy_max,
+                 st.busy_cnt ? st.busy_total_us / st.busy_cnt : 0,
+                 st.busy_max_us);
+    }
+  }
+  return UCLI_STATUS_OK;
+}
+
+PIPE_MGR_CLI_CMD_DECLARE(dr_poll) {
+  PIPE_MGR_CLI_PROLOGUE(
+      "dr-poll",
+      " Show or set how completion DRs are polled",
+      "[-s <polls before sleeping>] [-m <max sleep usec, 0 never sleeps>] "
+      "[-w <usec between polls of idle DRs, 0 always polls>] [-p print]");
+
+  pipe_mgr_drv_poll_cfg_t cfg;
+  pipe_mgr_drv_poll_cfg_get(&cfg);
+
+  int c;
+  while ((c = getopt(argc, argv, "s:m:w:p")) != -1) {
+    switch (c) {
+      case 's':
+      case 'm':
+      case 'w':
+        if (!optarg) {
+          aim_printf(&uc->pvs, "%s", usage);
+          return UCLI_STATUS_OK;
+        }
+        if (c == 's') cfg.spin_cnt = strtoul(optarg, NULL, 0);
+        if (c == 'm') cfg.sleep_max_us = strtoul(optarg, NULL, 0);
+        if (c == 'w') cfg.sweep_us = strtoul(optarg, NULL, 0);
+        break;
+      case 'p':
+        break;
+      default:
+        aim_printf(&uc->pvs, "%s", usage);
+        return UCLI_STATUS_OK;
+    }
+  }
+  pipe_mgr_drv_poll_cfg_set(&cfg);
+
+  aim_printf(&uc->pvs, "Spin polls   : %u\n", cfg.spin_cnt);
+  aim_printf(&uc->pvs, "Max sleep us : %u\n", cfg.sleep_max_us);
+  aim_printf(&uc->pvs, "Sweep us     : %u\n", cfg.sweep_us);
+  return UCLI_STATUS_OK;
+}
+
+PIPE_MGR_CLI_CMD_DECLARE(ha_time) {
+  PIPE_MGR_CLI_PROLOGUE(
+      "ha-time",
+      " Show the duration of each phase of the last hitless HA restart",
+      "-d <dev> [-w <restore worker threads, 0 for one per CPU>]");
+
+  bf_dev_id_t dev_id = -1;
+  bool got_dev = false;
+
+  int c;
+  while ((c = getopt(argc, argv, "d:w:")) != -1) {
+    switch (c) {
+      case 'd':
+      case 'w':
+        if (!optarg) {
+          aim_printf(&uc->pvs, "%s", usage);
+          return UCLI_STATUS_OK;
+        }
+        if (c == 'w') {
+          pipe_mgr_hitless_ha_num_workers_set(strtoul(optarg, NULL, 0));
+          break;
+        }
+        dev_id = strtoul(optarg, NULL, 0);
+        got_dev = true;
+        break;
+      default:
+        aim_printf(&uc->pvs, "%s", usage);
+        return UCLI_STATUS_OK;
+    }
+  }
+  if (!got_dev || dev_id < 0 || dev_id >= PIPE_MGR_NUM_DEVICES) {
+    aim_printf(&uc->pvs, "%s", usage);
+    return UCLI_STATUS_OK;
+  }
+
+  aim_printf(&uc->pvs,
+             "Restore workers : %u\n",
+             pipe_mgr_hitless_ha_num_workers_get());
+  uint64_t total_us = 0;
+  pipe_mgr_hitless_ha_phase_e phase;
+  for (phase = 0; phase < PIPE_MGR_HA_PHASE_CNT; ++phase) {
+    uint64_t us = pipe_mgr_hitless_ha_phase_time_get(dev_id, phase);
+    total_us += us;
+    aim_printf(&uc->pvs,
+               "%-15s : %" PRIu64 " us\n",
+               pipe_mgr_hitless_ha_phase_name(phase),
+               us);
+  }
+  aim_printf(&uc->pvs, "%-15s : %" PRIu64 " us\n", "total", total_us);
+  return UCLI_STATUS_OK;
+}
+
 PIPE_MGR_CLI_CMD_DECLARE(log_ilist) {
   PIPE_MGR_CLI_PROLOGUE("log-ilist",
                         " Start/stop logging of ilist contents",
@@ -11815,6 +11987,9 @@ PIPE_MGR_CLI_CMD_DECLARE(hash_seed_dump) {
 static ucli_command_handler_f pipe_mgr_ucli_ucli_handlers__[] = {
     PIPE_MGR_CLI_CMD_HNDLR(log_ilist),
     PIPE_MGR_CLI_CMD_HNDLR(drv_state),
+    PIPE_MGR_CLI_CMD_HNDLR(dr_stats),
+    PIPE_MGR_CLI_CMD_HNDLR(dr_poll),
+    PIPE_MGR_CLI_CMD_HNDLR(ha_time),
     PIPE_MGR_CLI_CMD_HNDLR(decode_ilist),
     PIPE_MGR_CLI_CMD_HNDLR(dev),
     PIPE_MGR_CLI_CMD_HNDLR(pipe),
@@ -17,6 +17,9 @@
  #  SPDX-License-Identifier: Apache-2.0
 ################################################################################
 
+import logging
+import time
+
 from p4.v1 import p4runtime_pb2
 from p4runtime_base_tests import P4RuntimeTest, autocleanup
 from p4runtime_base_tests import ipv4_to_binary, stringify
@@ -24,6 +27,7 @@ from p4runtime_base_tests import ipv4_to_binary, stringify
 from bfruntime_client_base_tests import BfRuntimeTest
 import bfrt_grpc.client as client
 
+logger = logging.getLogger('Test')
 
 def get_one_meter_config():
     meter_config = p4runtime_pb2.MeterConfig()
@@ -373,6 +377,57 @@ class ReadActionProfileGroup(P4RuntimeUTest):
         self.assertIn(entity2, [rentity1, rentity2])
 
 
+class WriteThroughput(P4RuntimeUTest):
+    """@brief Measures P4Runtime write throughput by inserting and then
+    deleting every ingress port entry of t_mtr_0 in batched WriteRequests,
+    and the rate of the wildcard read in between.
+    The test only uses the P4Runtime service so it can be run unmodified
+    against both the PI and the BF-RT device manager to compare them.
+    """
+
+    batch_size = 64
+    num_entries = 512
+
+    def _write_batches(self, reqs, update_type):
+        start = time.time()
+        for req in reqs:
+            for update in req.updates:
+                update.type = update_type
+            self.write_request(req, store=False)
+        return time.time() - start
+
+    def runTest(self):
+        reqs = []
+        for first in range(0, self.num_entries, self.batch_size):
+            req = self.get_new_write_request()
+            for ig_port in range(first, first + self.batch_size):
+                self.push_update_add_entry_to_action(
+                    req, "t_mtr_0",
+                    [self.Exact("sm.ingress_port", stringify(ig_port, 2))],
+                    "t_mtr_0_send", [("port", stringify(ig_port, 2))])
+            reqs.append(req)
+
+        insert_time = self._write_batches(reqs, p4runtime_pb2.Update.INSERT)
+        wildcard_entity = p4runtime_pb2.Entity()
+        wildcard_entity.table_entry.table_id = self.get_obj_id(
+            "tables", "t_mtr_0")
+        start = time.time()
+        self.assertEqual(
+            len(list(self.read(wildcard_entity))), self.num_entries)
+        read_time = time.time() - start
+        delete_time = self._write_batches(reqs, p4runtime_pb2.Update.DELETE)
+        self.assertIsNone(self.read_one(wildcard_entity))
+
+        logger.info("Inserted %d entries in batches of %d: %.0f updates/s",
+                    self.num_entries, self.batch_size,
+                    self.num_entries / insert_time)
+        logger.info("Read %d entries with one wildcard read: %.0f entries/s",
+                    self.num_entries, self.num_entries / read_time)
+        logger.info("Deleted %d entries in batches of %d: %.0f updates/s",
+                    self.num_entries, self.batch_size,
+                    self.num_entries / delete_time)
+
+
 # This is copied from the @autocleanup code. It makes it easier to debug issues
 # with default entry reset.
 class ResetDefaultEntry(P4RuntimeUTest):
@@ -3388,6 +3388,72 @@ class TestStfulSelTbl(pd_base_tests.ThriftInterfaceDataPlane):
             sys.stdout.flush()
             self.conn_mgr.complete_operations(self.shdl)
 
+    def lag_sel_updates_process(self):
+        updates = self.client.lag_ap_sel_get_updates(dev_id)
+        for u in updates:
+            self.handle_lag_update(u)
+        self.conn_mgr.complete_operations(self.shdl)
+
+    def verify_lag_mbr_states(self, down_mbrs):
+        for grp_hdl in self.lag_groups:
+            for mbr_hdl in self.lag_grp_to_mbrs[grp_hdl]:
+                state = self.client.lag_ap_group_member_state_get(self.shdl, dev_id, grp_hdl, mbr_hdl)
+                if mbr_hdl in down_mbrs:
+                    self.assertEqual(state, stful_grp_mbr_state.MBR_INACTIVE)
+                else:
+                    self.assertEqual(state, stful_grp_mbr_state.MBR_ACTIVE)
+
+    def verify_tag_flap(self, ports_to_flap):
+        # Tag each port's members with the port number so that one call
+        # flaps the port in every group it is a member of.
+        for port in ports_to_flap:
+            for mbr_hdl in self.lag_mbr_hdls[port]:
+                self.client.lag_ap_member_tag_set(self.shdl, dev_id, mbr_hdl, port)
+
+        for port in ports_to_flap:
+            tagged = self.lag_mbr_hdls[port]
+            num_in_grps = 0
+            for grp_hdl in self.lag_groups:
+                num_in_grps += len(tagged & set(self.lag_grp_to_mbrs[grp_hdl]))
+            print(datetime.datetime.now(), "Tag flapping port", port, "in", num_in_grps, "group memberships")
+            sys.stdout.flush()
+
+            n = self.client.lag_ap_tag_members_state_set(self.shdl, dev_id, port, stful_grp_mbr_state.MBR_INACTIVE)
+            self.assertEqual(n, num_in_grps)
+            self.lag_sel_updates_process()
+            self.verify_lag_mbr_states(tagged)
+            self.verify_lag_stateful_tbl([port])
+
+            # Members already down are not counted again.
+            n = self.client.lag_ap_tag_members_state_set(self.shdl, dev_id, port, stful_grp_mbr_state.MBR_INACTIVE)
+            self.assertEqual(n, 0)
+
+            n = self.client.lag_ap_tag_members_state_set(self.shdl, dev_id, port, stful_grp_mbr_state.MBR_ACTIVE)
+            self.assertEqual(n, num_in_grps)
+            self.lag_sel_updates_process()
+            self.verify_lag_mbr_states(set())
+            self.verify_lag_stateful_tbl()
+
+        # A cleared tag no longer flaps the member.
+        port = ports_to_flap[0]
+        for mbr_hdl in self.lag_mbr_hdls[port]:
+            self.client.lag_ap_member_tag_clear(self.shdl, dev_id, mbr_hdl)
+        n = self.client.lag_ap_tag_members_state_set(self.shdl, dev_id, port, stful_grp_mbr_state.MBR_INACTIVE)
+        self.assertEqual(n, 0)
+        self.verify_lag_mbr_states(set())
+
+        # Handles which are not members cannot be tagged.
+        bad_hdl = max(self.all_lag_mbr_hdls) + 1
+        try:
+            self.client.lag_ap_member_tag_set(self.shdl, dev_id, bad_hdl, port)
+            self.assertTrue(False)
+        except InvalidTableOperation as e:
+            pass
+
+        for port in ports_to_flap[1:]:
+            for mbr_hdl in self.lag_mbr_hdls[port]:
+                self.client.lag_ap_member_tag_clear(self.shdl, dev_id, mbr_hdl)
+
     def runTest(self):
         # For each group, add some handles
         print(datetime.datetime.now(), "Adding members to selection groups...")
@@ -3468,6 +3534,9 @@ class TestStfulSelTbl(pd_base_tests.ThriftInterfaceDataPlane):
         ports_to_test = self.egr_ports
         self.verify_all_traffic_with_port_flap(ports_to_test)
 
+        # Flap the ports again through member tags, several groups at once.
+        self.verify_tag_flap(ports_to_test)
+
 
     def tearDown(self):
         print(datetime.datetime.now(), "Tear down started")
@@ -151,6 +151,17 @@ switch_status_t bf_switch_global_log_level_set(
 switch_status_t bf_switch_start_batch() { return smi::bf_rt::start_batch(); }
 switch_status_t bf_switch_end_batch() { return smi::bf_rt::end_batch(); }
 
+switch_status_t bf_switch_async_write_mode_set(bool enable,
+                                               uint32_t batch_size,
+                                               uint32_t flush_interval_us,
+                                               bf_switch_async_write_cb_t cb) {
+  return smi::bf_rt::async_write_mode_set(
+      enable, batch_size, flush_interval_us, cb);
+}
+switch_status_t bf_switch_async_write_flush() {
+  return smi::bf_rt::async_write_flush();
+}
+
 void bf_switch_record_comment_mode_set(bool on) {
   smi::record::record_comment_mode_set(on);
 }
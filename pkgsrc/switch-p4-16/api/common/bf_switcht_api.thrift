@@ -73,7 +73,9 @@ enum switcht_perf_table {
   LPM_ROUTE_IPV6,
   NEXTHOP,
   VLAN,
-  MCAST_MEMBER
+  MCAST_MEMBER,
+  STORE_CONTENTION,
+  ASYNC_ROUTE_IPV4
 }
 
 struct switcht_list_val_t {
@@ -211,10 +211,6 @@ uint64_t get_smi_acl_type(switch_object_id_t parent,
 
 const uint8_t ACL_SAMPLE_NULL_ID = 0xFF;
 
-// These will be combined to a uint16 map with dst in MSB
-std::map<switch_acl_range_attr_type, std::bitset<8>> global_acl_range_label = {
-    {SWITCH_ACL_RANGE_ATTR_TYPE_SRC_PORT, std::bitset<8>{}},
-    {SWITCH_ACL_RANGE_ATTR_TYPE_DST_PORT, std::bitset<8>{}}};
 std::vector<uint16_t> l4_ingress_src_port_entries(65536, 0);
 std::vector<uint16_t> l4_ingress_dst_port_entries(65536, 0);
 std::vector<uint16_t> l4_egress_src_port_entries(65536, 0);
@@ -1166,6 +1162,33 @@ void switch_compute_acl_rule_port_group_value(const uint64_t table_type,
   }
 }
 
+// Fold a label-less range into the entry's L4 port value/mask
+static void acl_range_ternary_get(const switch_object_id_t range_handle,
+                                  uint16_t &port,
+                                  uint16_t &port_mask) {
+  std::vector<std::pair<uint16_t, uint16_t>> prefixes;
+  switch_range_t range = {};
+
+  switch_store::v_get(range_handle, SWITCH_ACL_RANGE_ATTR_RANGE, range);
+  if (L4PortRangeEncoder::prefix_expand(range, &prefixes) != 1) return;
+
+  const uint16_t value = prefixes[0].first;
+  const uint16_t mask = prefixes[0].second;
+  if ((port ^ value) & port_mask & mask) {
+    switch_log(SWITCH_API_LEVEL_ERROR,
+               SWITCH_OBJECT_TYPE_ACL_ENTRY,
+               "{}.{}: L4 port {}/{} does not overlap range {}",
+               __func__,
+               __LINE__,
+               port,
+               port_mask,
+               range);
+    return;
+  }
+  port = (port & port_mask) | (value & mask);
+  port_mask |= mask;
+}
+
 acl_entry_object::acl_entry_object(const switch_object_id_t parent) {
   switch_store::v_get(parent, SWITCH_ACL_ENTRY_ATTR_ETH_TYPE, eth_type);
   switch_store::v_get(
@@ -1371,11 +1394,17 @@ acl_entry_object::acl_entry_object(const switch_object_id_t parent) {
     switch_store::v_get(
         src_port_range_id, SWITCH_ACL_RANGE_ATTR_LABEL, src_port_label);
     src_port_label_mask = src_port_label;
+    if (src_port_label == 0) {
+      acl_range_ternary_get(src_port_range_id, l4_src_port, l4_src_port_mask);
+    }
   }
   if (dst_port_range_id.data) {
     switch_store::v_get(
         dst_port_range_id, SWITCH_ACL_RANGE_ATTR_LABEL, dst_port_label);
     dst_port_label_mask = dst_port_label;
+    if (dst_port_label == 0) {
+      acl_range_ternary_get(dst_port_range_id, l4_dst_port, l4_dst_port_mask);
+    }
   }
 
   switch_log(SWITCH_API_LEVEL_DEBUG,
@@ -3126,11 +3155,280 @@ class acl_sample_session : public auto_object {
   }
 };
 
+L4PortRangeEncoder::L4PortRangeEncoder() {
+  range_labels_[SWITCH_ACL_RANGE_ATTR_TYPE_SRC_PORT] = {};
+  range_labels_[SWITCH_ACL_RANGE_ATTR_TYPE_DST_PORT] = {};
+}
+
+uint32_t L4PortRangeEncoder::prefix_expand(
+    const switch_range_t &range,
+    std::vector<std::pair<uint16_t, uint16_t>> *prefixes) {
+  uint32_t count = 0;
+  uint32_t lo = range.min;
+  uint32_t hi = range.max;
+
+  if (lo > hi || hi > 0xFFFF) return 0;
+
+  while (lo <= hi) {
+    // largest aligned block starting at lo that stays within the range
+    uint32_t size = lo ? (lo & (~lo + 1)) : 0x10000;
+    while (lo + size - 1 > hi) size >>= 1;
+    if (prefixes) {
+      prefixes->push_back(std::make_pair(static_cast<uint16_t>(lo),
+                                         static_cast<uint16_t>(~(size - 1))));
+    }
+    count++;
+    lo += size;
+  }
+  return count;
+}
+
+L4PortRangeEncoder::range_label_t *L4PortRangeEncoder::owner_label_get(
+    const switch_object_id_t range_handle) {
+  auto it = owners_.find(range_handle);
+  if (it == owners_.end()) return NULL;
+  return &range_labels_[it->second.first][it->second.second];
+}
+
+void L4PortRangeEncoder::owner_release(const switch_object_id_t range_handle) {
+  range_label_t *label = owner_label_get(range_handle);
+  if (!label) return;
+  label->ranges.erase(range_handle);
+  if (label->ranges.empty()) {
+    label->in_use = false;
+    label->users[0].clear();
+    label->users[1].clear();
+  }
+  owners_.erase(range_handle);
+}
+
+switch_status_t L4PortRangeEncoder::label_allocate(
+    const switch_object_id_t range_handle,
+    const uint64_t type,
+    const switch_range_t &range,
+    uint8_t &range_label) {
+  auto it = range_labels_.find(type);
+  if (it == range_labels_.end()) {
+    switch_log(SWITCH_API_LEVEL_ERROR,
+               SWITCH_OBJECT_TYPE_ACL_RANGE,
+               "{}.{}: Invalid Acl L4 port range type",
+               __func__,
+               __LINE__);
+    return SWITCH_STATUS_INVALID_PARAMETER;
+  }
+
+  auto owner = owners_.find(range_handle);
+  if (owner != owners_.end()) {
+    range_label = 1U << owner->second.second;
+    return SWITCH_STATUS_SUCCESS;
+  }
+
+  auto &labels = it->second;
+  uint8_t index = SWITCH_ACL_RANGE_LABEL_MAX;
+  for (uint8_t i = 0; i < SWITCH_ACL_RANGE_LABEL_MAX; i++) {
+    if (labels[i].in_use && labels[i].range == range) {
+      index = i;
+      break;
+    }
+    if (!labels[i].in_use && index == SWITCH_ACL_RANGE_LABEL_MAX) index = i;
+  }
+  if (index == SWITCH_ACL_RANGE_LABEL_MAX) {
+    return SWITCH_STATUS_INSUFFICIENT_RESOURCES;
+  }
+
+  labels[index].in_use = true;
+  labels[index].range = range;
+  labels[index].ranges.insert(range_handle);
+  owners_[range_handle] = std::make_pair(type, index);
+  range_label = 1U << index;
+
+  switch_log(SWITCH_API_LEVEL_DEBUG,
+             SWITCH_OBJECT_TYPE_ACL_RANGE,
+             "{}.{}: range {} type {} label {} shared by {} range(s)",
+             __func__,
+             __LINE__,
+             range,
+             type,
+             range_label,
+             labels[index].ranges.size());
+  return SWITCH_STATUS_SUCCESS;
+}
+
+switch_status_t L4PortRangeEncoder::label_reserve(
+    const switch_object_id_t range_handle,
+    const uint64_t type,
+    const switch_range_t &range,
+    const uint8_t range_label) {
+  auto it = range_labels_.find(type);
+  if (it == range_labels_.end() || range_label == 0) {
+    return SWITCH_STATUS_INVALID_PARAMETER;
+  }
+  if (owners_.find(range_handle) != owners_.end()) {
+    return SWITCH_STATUS_SUCCESS;
+  }
+
+  uint8_t index = 0;
+  while (((range_label >> index) & 1U) == 0) index++;
+
+  auto &label = it->second[index];
+  if (label.in_use && !(label.range == range)) {
+    switch_log(SWITCH_API_LEVEL_ERROR,
+               SWITCH_OBJECT_TYPE_ACL_RANGE,
+               "{}.{}: range {} label {} already in use by range {}",
+               __func__,
+               __LINE__,
+               range,
+               range_label,
+               label.range);
+    return SWITCH_STATUS_RESOURCE_IN_USE;
+  }
+  label.in_use = true;
+  label.range = range;
+  label.ranges.insert(range_handle);
+  owners_[range_handle] = std::make_pair(type, index);
+  return SWITCH_STATUS_SUCCESS;
+}
+
+bool L4PortRangeEncoder::user_add(const switch_object_id_t range_handle,
+                                  const bool ingress) {
+  range_label_t *label = owner_label_get(range_handle);
+  if (!label) return false;
+  auto &users = label->users[ingress ? 1 : 0];
+  users.insert(range_handle);
+  return users.size() == 1;
+}
+
+bool L4PortRangeEncoder::user_remove(const switch_object_id_t range_handle,
+                                     const bool ingress) {
+  range_label_t *label = owner_label_get(range_handle);
+  if (!label) return false;
+  auto &users = label->users[ingress ? 1 : 0];
+  bool last = users.erase(range_handle) && users.empty();
+  if (label->users[0].count(range_handle) == 0 &&
+      label->users[1].count(range_handle) == 0) {
+    owner_release(range_handle);
+  }
+  return last;
+}
+
+switch_status_t acl_range_encoding_stats_get(
+    const switch_object_id_t acl_table, acl_range_encoding_stats_t &stats) {
+  switch_status_t status = SWITCH_STATUS_SUCCESS;
+  std::vector<switch_object_id_t> acl_entry_handles;
+  const switch_attr_id_t range_attrs[] = {
+      SWITCH_ACL_ENTRY_ATTR_SRC_PORT_RANGE_ID,
+      SWITCH_ACL_ENTRY_ATTR_DST_PORT_RANGE_ID};
+
+  stats = {};
+  status = switch_store::v_get(
+      acl_table, SWITCH_ACL_TABLE_ATTR_ACL_ENTRY_HANDLES, acl_entry_handles);
+  if (status != SWITCH_STATUS_SUCCESS) return status;
+
+  for (const auto acl_entry : acl_entry_handles) {
+    uint32_t expansion = 1;
+    bool has_range = false;
+
+    for (const auto attr_id : range_attrs) {
+      switch_object_id_t range_handle = {};
+      switch_range_t range = {};
+      uint8_t range_label = 0;
+
+      status |= switch_store::v_get(acl_entry, attr_id, range_handle);
+      if (range_handle.data == 0) continue;
+      status |=
+          switch_store::v_get(range_handle, SWITCH_ACL_RANGE_ATTR_RANGE, range);
+      status |= switch_store::v_get(
+          range_handle, SWITCH_ACL_RANGE_ATTR_LABEL, range_label);
+
+      has_range = true;
+      if (range_label) {
+        stats.label_ranges++;
+      } else {
+        stats.ternary_ranges++;
+      }
+      expansion *= L4PortRangeEncoder::prefix_expand(range, nullptr);
+    }
+
+    stats.entries++;
+    stats.tcam_entries++;
+    stats.expanded_tcam_entries += expansion;
+    if (has_range) stats.range_entries++;
+  }
+
+  switch_log(SWITCH_API_LEVEL_DEBUG,
+             SWITCH_OBJECT_TYPE_ACL_TABLE,
+             "{}.{}: acl table {} entries {} with ranges {} label ranges {} "
+             "ternary ranges {} tcam entries {} prefix expanded {}",
+             __func__,
+             __LINE__,
+             acl_table,
+             stats.entries,
+             stats.range_entries,
+             stats.label_ranges,
+             stats.ternary_ranges,
+             stats.tcam_entries,
+             stats.expanded_tcam_entries);
+  return status;
+}
+
+/*
+ * Read-only view of acl_range_encoding_stats_get() as acl_table counters.
+ * The values are recomputed from the store on every get, so there is
+ * nothing to clear.
+ */
+class acl_table_range_stats : public auto_object {
+ private:
+  static const switch_object_type_t auto_ot =
+      SWITCH_OBJECT_TYPE_ACL_TABLE_RANGE_STATS;
+  static const switch_attr_id_t parent_attr_id =
+      SWITCH_ACL_TABLE_RANGE_STATS_ATTR_PARENT_HANDLE;
+  static const switch_attr_id_t status_attr_id =
+      SWITCH_ACL_TABLE_RANGE_STATS_ATTR_STATUS;
+
+ public:
+  acl_table_range_stats(const switch_object_id_t parent,
+                        switch_status_t &status)
+      : auto_object(auto_ot, parent_attr_id, parent) {
+    status = SWITCH_STATUS_SUCCESS;
+  }
+
+  switch_status_t counters_get(const switch_object_id_t handle,
+                               std::vector<switch_counter_t> &cntrs) {
+    acl_range_encoding_stats_t stats = {};
+    switch_status_t status = acl_range_encoding_stats_get(handle, stats);
+    if (status != SWITCH_STATUS_SUCCESS) return status;
+
+    const std::pair<uint16_t, uint32_t> values[] = {
+        {SWITCH_ACL_TABLE_COUNTER_ID_ENTRIES, stats.entries},
+        {SWITCH_ACL_TABLE_COUNTER_ID_RANGE_ENTRIES, stats.range_entries},
+        {SWITCH_ACL_TABLE_COUNTER_ID_LABEL_RANGES, stats.label_ranges},
+        {SWITCH_ACL_TABLE_COUNTER_ID_TERNARY_RANGES, stats.ternary_ranges},
+        {SWITCH_ACL_TABLE_COUNTER_ID_TCAM_ENTRIES, stats.tcam_entries},
+        {SWITCH_ACL_TABLE_COUNTER_ID_EXPANDED_TCAM_ENTRIES,
+         stats.expanded_tcam_entries}};
+    for (const auto &value : values) {
+      cntrs[value.first].counter_id = value.first;
+      cntrs[value.first].count = value.second;
+    }
+    return status;
+  }
+
+  switch_status_t counters_set(const switch_object_id_t handle) {
+    (void)handle;
+    return SWITCH_STATUS_SUCCESS;
+  }
+
+  switch_status_t counters_set(const switch_object_id_t handle,
+                               const std::vector<uint16_t> &cntr_ids) {
+    (void)handle;
+    (void)cntr_ids;
+    return SWITCH_STATUS_SUCCESS;
+  }
+};
+
 class l4_port_range {
  public:
   uint8_t range_bit_label = 0;
-  uint8_t alloc_bit = 0xFF;
-  uint16_t i = 0;
   switch_range_t range = {};
   switch_acl_range_attr_type type = SWITCH_ACL_RANGE_ATTR_TYPE_MAX;
   switch_object_id_t parent = {};
@@ -3149,31 +3447,22 @@ class l4_port_range {
 
     type = static_cast<switch_acl_range_attr_type>(t.enumdata);
 
-    // if acl_range has no pre-alloc bit label, then allocate
-    if (range_bit_label == 0) {
-      auto it = global_acl_range_label.find(type);
-      if (it == global_acl_range_label.end()) {
-        switch_log(SWITCH_API_LEVEL_ERROR,
-                   SWITCH_OBJECT_TYPE_ACL_RANGE,
-                   "{}.{}: Invalid Acl L4 port range type",
-                   __func__,
-                   __LINE__);
-        return;
-      }
-      auto &range_labels = it->second;
-      for (i = 0; i < range_labels.size(); i++) {
-        if (range_labels.test(i)) {
-          continue;
-        } else {
-          alloc_bit = i;
-          break;
-        }
-      }
-      if (alloc_bit != 0xFF) {
-        range_bit_label = 1U << alloc_bit;
+    auto encoder = L4PortRangeEncoder::instance();
+    // label restored from the store, e.g. on warm init replay. If another
+    // range owns that bit by now, leave it alone and take a new label.
+    if (range_bit_label != 0 &&
+        encoder->label_reserve(parent, type, range, range_bit_label) !=
+            SWITCH_STATUS_SUCCESS) {
+      range_bit_label = 0;
+      switch_store::v_set(parent, SWITCH_ACL_RANGE_ATTR_LABEL, range_bit_label);
+    }
+    if (range_bit_label == 0 && !L4PortRangeEncoder::is_ternary(range)) {
+      // matched in the ACL entry's L4 port field if a single prefix covers
+      // the range, otherwise allocate or share a label
+      if (encoder->label_allocate(parent, type, range, range_bit_label) ==
+          SWITCH_STATUS_SUCCESS) {
         switch_store::v_set(
             parent, SWITCH_ACL_RANGE_ATTR_LABEL, range_bit_label);
-        range_labels.set(alloc_bit, true);
       }
     }
   }
@@ -3212,6 +3501,8 @@ class l4_port_range {
     } else {
       return SWITCH_STATUS_INVALID_PARAMETER;
     }
+    if (range_bit_label == 0) return status;
+
     for (port = range.min; port <= range.max; port++) {
       if (set) {
         calc_label = (uint8_t)(*l4_port_entries)[port] | range_bit_label;
@@ -3261,8 +3552,7 @@ class l4_port_range {
   switch_status_t check_label() {
     // If WR/FR replay going on, ignore this check
     if (!switch_store::smiContext::context().in_warm_init()) {
-      auto it = global_acl_range_label.find(type);
-      if (it == global_acl_range_label.end()) {
+      if (!L4PortRangeEncoder::instance()->is_valid_type(type)) {
         switch_log(SWITCH_API_LEVEL_ERROR,
                    SWITCH_OBJECT_TYPE_ACL_RANGE,
                    "{}.{}: Invalid Acl L4 port range type",
@@ -3270,8 +3560,7 @@ class l4_port_range {
                    __LINE__);
         return SWITCH_STATUS_INVALID_PARAMETER;
       }
-      auto &range_labels = it->second;
-      if (range_bit_label == 0 && range_labels.all()) {
+      if (range_bit_label == 0 && !L4PortRangeEncoder::is_ternary(range)) {
         switch_log(SWITCH_API_LEVEL_ERROR,
                    SWITCH_OBJECT_TYPE_ACL_RANGE,
                    "{}.{}: ACL L4 port range labels unavailable for type {}",
@@ -3284,24 +3573,17 @@ class l4_port_range {
     return SWITCH_STATUS_SUCCESS;
   }
 
-  void del() {
-    uint8_t free_bit = 0;
-    uint8_t temp_bit_label = range_bit_label;
-    if (temp_bit_label != 0) {
-      while ((temp_bit_label & 1U) != 1U) {
-        free_bit++;
-        temp_bit_label >>= 1;
-      }
-      auto it = global_acl_range_label.find(type);
-      if (it == global_acl_range_label.end()) {
-        switch_log(SWITCH_API_LEVEL_ERROR,
-                   SWITCH_OBJECT_TYPE_ACL_RANGE,
-                   "{}.{}: Invalid Acl L4 port range type",
-                   __func__,
-                   __LINE__);
-        return;
-      }
-      it->second.set(free_bit, false);
+  switch_status_t add(bool ingress) {
+    if (!L4PortRangeEncoder::instance()->user_add(parent, ingress)) {
+      // label shared with an identical range already programmed
+      return SWITCH_STATUS_SUCCESS;
+    }
+    return program_l4_port_entries(ingress, true);
+  }
+
+  void del(bool ingress) {
+    if (L4PortRangeEncoder::instance()->user_remove(parent, ingress)) {
+      program_l4_port_entries(ingress, false);
     }
   }
 };
@@ -3363,7 +3645,7 @@ class ingress_l4_src_port : public auto_object, l4_port_range {
     }
 
     status = auto_object::create_update();
-    status = program_l4_port_entries(true, true);
+    status = l4_port_range::add(true);
     return status;
   }
 
@@ -3372,8 +3654,7 @@ class ingress_l4_src_port : public auto_object, l4_port_range {
       return SWITCH_STATUS_SUCCESS;
     }
 
-    l4_port_range::del();
-    program_l4_port_entries(true, false);
+    l4_port_range::del(true);
     return auto_object::del();
   }
 };
@@ -3435,7 +3716,7 @@ class ingress_l4_dst_port : public auto_object, l4_port_range {
     }
 
     status = auto_object::create_update();
-    status = program_l4_port_entries(true, true);
+    status = l4_port_range::add(true);
     return status;
   }
 
@@ -3444,8 +3725,7 @@ class ingress_l4_dst_port : public auto_object, l4_port_range {
       return SWITCH_STATUS_SUCCESS;
     }
 
-    l4_port_range::del();
-    program_l4_port_entries(true, false);
+    l4_port_range::del(true);
     return auto_object::del();
   }
 };
@@ -3493,7 +3773,7 @@ class egress_l4_src_port : public auto_object, l4_port_range {
     }
 
     status = auto_object::create_update();
-    status = program_l4_port_entries(false, true);
+    status = l4_port_range::add(false);
     return status;
   }
 
@@ -3502,8 +3782,7 @@ class egress_l4_src_port : public auto_object, l4_port_range {
       return SWITCH_STATUS_SUCCESS;
     }
 
-    l4_port_range::del();
-    program_l4_port_entries(false, false);
+    l4_port_range::del(false);
     return auto_object::del();
   }
 };
@@ -3551,7 +3830,7 @@ class egress_l4_dst_port : public auto_object, l4_port_range {
     }
 
     status = auto_object::create_update();
-    status = program_l4_port_entries(false, true);
+    status = l4_port_range::add(false);
     return status;
   }
 
@@ -3560,8 +3839,7 @@ class egress_l4_dst_port : public auto_object, l4_port_range {
       return SWITCH_STATUS_SUCCESS;
     }
 
-    l4_port_range::del();
-    program_l4_port_entries(false, false);
+    l4_port_range::del(false);
     return auto_object::del();
   }
 };
@@ -10120,12 +10398,15 @@ LabelManager *LabelManager::instance_ = NULL;
 PortGroupManager *PortGroupManager::instance_ = NULL;
 PortGroupLabel *PortGroupLabel::instance_ = NULL;
 MacAddrLabelManager *MacAddrLabelManager::instance_ = NULL;
+L4PortRangeEncoder *L4PortRangeEncoder::instance_ = NULL;
 IdMap *IdMap::instance_ = NULL;
 
 switch_status_t acl_init() {
   switch_status_t status = SWITCH_STATUS_SUCCESS;
 
   REGISTER_OBJECT(acl_factory, SWITCH_OBJECT_TYPE_ACL_FACTORY);
+  REGISTER_OBJECT(acl_table_range_stats,
+                  SWITCH_OBJECT_TYPE_ACL_TABLE_RANGE_STATS);
   REGISTER_OBJECT(default_ingress_system_acl,
                   SWITCH_OBJECT_TYPE_DEFAULT_INGRESS_SYSTEM_ACL);
   REGISTER_OBJECT(default_egress_system_acl,
@@ -18,6 +18,7 @@
  ******************************************************************************/
 
 
+#include <array>
 #include "utils.h"
 #include "p4_16_types.h"
 
@@ -751,6 +752,88 @@ class MacAddrLabelManager {
                                uint16_t &refcount);
 };
 
+#define SWITCH_ACL_RANGE_LABEL_MAX 8
+
+/**
+ * @brief L4 port range encoding
+ *
+ * A range that covers a single aligned power of two block of ports is
+ * matched on the L4 port ternary field of the ACL entry and needs no range
+ * label. Any other range takes one of SWITCH_ACL_RANGE_LABEL_MAX label bits
+ * of its range type. Ranges with the same type and bounds share the label,
+ * so the port to label tables are only written by the first user in each
+ * direction and cleared by the last one.
+ */
+class L4PortRangeEncoder {
+ private:
+  static L4PortRangeEncoder *instance_;
+  struct range_label_t {
+    bool in_use = false;
+    switch_range_t range = {};
+    // acl_range objects sharing this label
+    std::set<switch_object_id_t> ranges;
+    // acl_range objects with port entries programmed, egress/ingress
+    std::set<switch_object_id_t> users[2];
+  };
+  std::map<uint64_t, std::array<range_label_t, SWITCH_ACL_RANGE_LABEL_MAX>>
+      range_labels_;
+  // acl_range handle -> {range type, label index}
+  std::map<switch_object_id_t, std::pair<uint64_t, uint8_t>> owners_;
+
+  range_label_t *owner_label_get(const switch_object_id_t range_handle);
+  void owner_release(const switch_object_id_t range_handle);
+
+ public:
+  L4PortRangeEncoder();
+  static L4PortRangeEncoder *instance() {
+    if (instance_ == NULL) {
+      instance_ = new L4PortRangeEncoder;
+    }
+    return instance_;
+  }
+  // Minimal value/mask prefix cover of the range, returns the entry count
+  static uint32_t prefix_expand(
+      const switch_range_t &range,
+      std::vector<std::pair<uint16_t, uint16_t>> *prefixes);
+  static bool is_ternary(const switch_range_t &range) {
+    return prefix_expand(range, nullptr) == 1;
+  }
+  bool is_valid_type(const uint64_t type) {
+    return range_labels_.find(type) != range_labels_.end();
+  }
+  switch_status_t label_allocate(const switch_object_id_t range_handle,
+                                 const uint64_t type,
+                                 const switch_range_t &range,
+                                 uint8_t &range_label);
+  switch_status_t label_reserve(const switch_object_id_t range_handle,
+                                const uint64_t type,
+                                const switch_range_t &range,
+                                const uint8_t range_label);
+  // true if the port entries of the label have to be programmed
+  bool user_add(const switch_object_id_t range_handle, const bool ingress);
+  // true if the port entries of the label have to be cleared
+  bool user_remove(const switch_object_id_t range_handle, const bool ingress);
+};
+
+/**
+ * @brief Per ACL table range encoding summary
+ *
+ * tcam_entries is what the table consumes today, one per ACL entry.
+ * expanded_tcam_entries is what the same entries would take if every range
+ * was expanded into ternary prefixes.
+ */
+struct acl_range_encoding_stats_t {
+  uint32_t entries;
+  uint32_t range_entries;
+  uint32_t label_ranges;
+  uint32_t ternary_ranges;
+  uint32_t tcam_entries;
+  uint32_t expanded_tcam_entries;
+};
+
+switch_status_t acl_range_encoding_stats_get(
+    const switch_object_id_t acl_table, acl_range_encoding_stats_t &stats);
+
 }  // namespace smi
 
 #endif /*__SMI_ACL_H__ */
@@ -837,6 +837,142 @@ PerfResult ITableBMAIVlan::run(uint32_t entries, bool batch) {
   return perf_test;
 }
 
+PerfResult ITableBMAIStoreContention::run(uint32_t entries, bool batch) {
+  PerfResult perf_test(_test_name);
+  switch_status_t status = SWITCH_STATUS_SUCCESS;
+  uint32_t ports = _port_handle_list.size();
+  uint32_t vrfs = _vrf_handle_list.size();
+  std::atomic<uint32_t> errors(0);
+
+  // lookups only, there is nothing to batch
+  (void)batch;
+
+  if (ports == 0 || vrfs == 0) {
+    std::cerr << _test_name << ": no ports or vrfs to read" << std::endl;
+    perf_test.set_status(SWITCH_STATUS_FAILURE);
+    return perf_test;
+  }
+
+  auto reader = [&](uint32_t reads, uint32_t offset) {
+    for (uint32_t i = offset; i < offset + reads; i++) {
+      attr_w port_type(SWITCH_PORT_ATTR_TYPE);
+      attr_w vrf_device(SWITCH_VRF_ATTR_DEVICE);
+      if (bf_switch_attribute_get(_port_handle_list.at(i % ports),
+                                  SWITCH_PORT_ATTR_TYPE,
+                                  port_type) != SWITCH_STATUS_SUCCESS ||
+          bf_switch_attribute_get(_vrf_handle_list.at(i % vrfs),
+                                  SWITCH_VRF_ATTR_DEVICE,
+                                  vrf_device) != SWITCH_STATUS_SUCCESS) {
+        errors++;
+      }
+    }
+  };
+
+#ifdef __CPU_PROFILER__
+  ProfilerStart(get_prof_file_name(_test_name, entries, batch).c_str());
+  ProfilerFlush();
+#endif
+  for (uint32_t threads = 1; threads <= max_threads; threads *= 2) {
+    PerfResult step(_test_name + "-" + std::to_string(threads) + "-threads");
+    std::vector<std::thread> workers;
+    uint32_t reads = entries / threads;
+
+    step.start_clock();
+    for (uint32_t t = 0; t < threads; t++) {
+      workers.emplace_back(reader, reads, t * reads);
+    }
+    for (auto &worker : workers) {
+      worker.join();
+    }
+    step.end_clock();
+    // two lookups per read
+    step.compute_rate(2 * reads * threads);
+    perf_test = step;
+  }
+#ifdef __CPU_PROFILER__
+  ProfilerStop();
+#endif
+
+  if (errors != 0) {
+    std::cerr << _test_name << ": " << errors << " lookups failed" << std::endl;
+    status = SWITCH_STATUS_FAILURE;
+  }
+  perf_test.set_status(status);
+  return perf_test;
+}
+
+switch_status_t ITableBMAIAsyncRouteIpv4::add_routes(uint32_t &entries_added) {
+  switch_status_t status = SWITCH_STATUS_SUCCESS;
+  switch_object_id_t route_handle = {};
+  uint32_t vrfs = _vrf_handle_list.size();
+  uint32_t nhops = _nhop_handle_list.size();
+
+  entries_added = 0;
+  for (auto &prefix : _prefix_list) {
+    std::set<attr_w> attrs;
+    attrs.insert(attr_w(SWITCH_ROUTE_ATTR_DEVICE, _device));
+    attrs.insert(attr_w(SWITCH_ROUTE_ATTR_VRF_HANDLE,
+                        _vrf_handle_list.at(entries_added % vrfs)));
+    attrs.insert(attr_w(SWITCH_ROUTE_ATTR_NEXTHOP_HANDLE,
+                        _nhop_handle_list.at(entries_added % nhops)));
+    attrs.insert(attr_w(SWITCH_ROUTE_ATTR_IP_PREFIX, prefix));
+
+    status =
+        bf_switch_object_create(SWITCH_OBJECT_TYPE_ROUTE, attrs, route_handle);
+    if (status != SWITCH_STATUS_SUCCESS) {
+      std::cout << _test_name << ": error adding " << entries_added + 1
+                << " entry" << std::endl;
+      break;
+    }
+    _route_handles.push_back(route_handle);
+    entries_added++;
+  }
+  return status;
+}
+
+void ITableBMAIAsyncRouteIpv4::delete_routes() {
+  for (auto &handle : _route_handles) {
+    bf_switch_object_delete(handle);
+  }
+  _route_handles.clear();
+}
+
+PerfResult ITableBMAIAsyncRouteIpv4::run(uint32_t entries, bool batch) {
+  // Batch selects the async write path, without it the same routes are
+  // written synchronously so the two results of a run compare the modes.
+  PerfResult perf_test(_test_name + (batch ? "-async" : "-sync"));
+  switch_status_t status = SWITCH_STATUS_SUCCESS;
+  uint32_t entries_added(0);
+
+  ip4_prefix_list_gen(_prefix_list, std::min(entries, max_entries));
+
+#ifdef __CPU_PROFILER__
+  ProfilerStart(get_prof_file_name(_test_name, entries, batch).c_str());
+  ProfilerFlush();
+#endif
+  perf_test.start_clock();
+  if (batch) {
+    bf_switch_async_write_mode_set(
+        true, async_batch_size, async_flush_interval_us, nullptr);
+  }
+  status = add_routes(entries_added);
+  if (batch) {
+    bf_switch_async_write_flush();
+  }
+  perf_test.end_clock();
+  if (batch) {
+    bf_switch_async_write_mode_set(false, 0, 0, nullptr);
+  }
+#ifdef __CPU_PROFILER__
+  ProfilerStop();
+#endif
+  perf_test.compute_rate(entries_added);
+  std::cout << _test_name << ": entries_added: " << entries_added << std::endl;
+
+  perf_test.set_status(status);
+  return perf_test;
+}
+
 /* TO DO - test to be fixed within multicast enabling works
 PerfResult ITableBMAIMcastMember::run(uint32_t entries, bool batch) {
   PerfResult perf_test(_test_name);
@@ -21,7 +21,9 @@
 #ifndef __TEST_API_PERF_H__
 #define __TEST_API_PERF_H__
 
+#include <atomic>
 #include <iostream>
+#include <thread>  // NOLINT(build/c++11)
 #include <stdio.h>
 #include <dirent.h>
 #include "arpa/inet.h"
@@ -689,6 +691,66 @@ class ITableBMAIVlan : public ITable, public ITableHelper {
   PerfResult run(uint32_t entries, bool batch);
 };
 
+/**
+ * Contention profile of the object store. The same number of attribute
+ * lookups is spread over 1, 2, 4 and 8 threads, a store that scales with
+ * concurrent readers keeps the rate growing with the thread count.
+ */
+class ITableBMAIStoreContention : public ITable, public ITableHelper {
+ private:
+  const uint32_t max_threads = 8;
+  switch_object_id_t _device;
+  std::string _test_name;
+
+ public:
+  ITableBMAIStoreContention(switch_object_id_t device)
+      : _device(device), _test_name("bmai-store-contention") {
+    port_handle_list_get(_port_handle_list, max_ports);
+    vrf_gen(_vrf_handle_list, device, max_vrfs);
+  }
+  ~ITableBMAIStoreContention() {}
+  void clean() {
+    for (auto &handle : _vrf_handle_list) {
+      bf_switch_object_delete(handle);
+    }
+  }
+  PerfResult run(uint32_t entries, bool batch);
+};
+
+/**
+ * Host routes added synchronously and then again with async table writes,
+ * the rate reported is the async one.
+ */
+class ITableBMAIAsyncRouteIpv4 : public ITable, public ITableHelper {
+ private:
+  const uint32_t max_entries = 65000;
+  const uint32_t async_batch_size = 1024;
+  const uint32_t async_flush_interval_us = 1000;
+  std::vector<switch_object_id_t> _route_handles;
+  std::vector<switch_ip_prefix_t> _prefix_list;
+  switch_object_id_t _device;
+  std::string _test_name;
+
+  switch_status_t add_routes(uint32_t &entries_added);
+  void delete_routes();
+
+ public:
+  ITableBMAIAsyncRouteIpv4(switch_object_id_t device)
+      : _device(device), _test_name("bmai-async-route") {
+    vrf_gen(_vrf_handle_list, device, max_vrfs);
+    object_handle_list_get(
+        _nhop_handle_list, SWITCH_OBJECT_TYPE_NEXTHOP, max_nhops);
+  }
+  ~ITableBMAIAsyncRouteIpv4() {}
+  void clean() {
+    delete_routes();
+    for (auto &handle : _vrf_handle_list) {
+      bf_switch_object_delete(handle);
+    }
+  }
+  PerfResult run(uint32_t entries, bool batch);
+};
+
 /* TO DO - corresponding test to be fixed within multicast enabling works
 class ITableBMAIMcastMember : public ITable, public ITableHelper {
  private:
@@ -777,6 +839,18 @@ class ApiPerf {
            [](switch_object_id_t device) {
              return std::unique_ptr<smi::ITable>(new ITableBMAIVlan(device));
            }},
+          {std::make_pair(switcht_perf_api::BMAI,
+                          switcht_perf_table::STORE_CONTENTION),
+           [](switch_object_id_t device) {
+             return std::unique_ptr<smi::ITable>(
+                 new ITableBMAIStoreContention(device));
+           }},
+          {std::make_pair(switcht_perf_api::BMAI,
+                          switcht_perf_table::ASYNC_ROUTE_IPV4),
+           [](switch_object_id_t device) {
+             return std::unique_ptr<smi::ITable>(
+                 new ITableBMAIAsyncRouteIpv4(device));
+           }},
           /* TO DO - corresponding test to be fixed within multicast enabling
              works {std::make_pair(switcht_perf_api::BMAI,
                                     switcht_perf_table::MCAST_MEMBER),
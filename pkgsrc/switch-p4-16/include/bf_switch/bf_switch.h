@@ -813,6 +813,43 @@ switch_status_t bf_switch_start_batch();
  */
 switch_status_t bf_switch_end_batch();
 
+/**
+ * @brief Callback for objects whose table writes were pushed by an async
+ * flush. A failure status means some of the object's entries may not be in
+ * hardware and the application is expected to roll the object back.
+ */
+typedef void (*bf_switch_async_write_cb_t)(const switch_object_id_t object_id,
+                                           const switch_status_t status);
+
+/**
+ * @brief Enable or disable asynchronous table writes
+ * \n - Table writes on the default session are queued in a batch that is
+ * pushed once batch_size writes are pending or flush_interval_us has passed
+ * \n - Errors returned by the table APIs are still reported synchronously
+ * \n - Internally calls \ref async_write_mode_set
+ *
+ * @param[in] enable true to queue writes, false to return to synchronous mode
+ * @param[in] batch_size Number of pending writes that triggers a flush
+ * @param[in] flush_interval_us Maximum time a write stays queued
+ * @param[in] cb Optional callback run once per object after each flush
+ *
+ * @retval SWITCH_STATUS_SUCCESS Success
+ * @retval SWITCH_STATUS_INVALID_PARAMETER Zero batch size or interval
+ */
+switch_status_t bf_switch_async_write_mode_set(bool enable,
+                                               uint32_t batch_size,
+                                               uint32_t flush_interval_us,
+                                               bf_switch_async_write_cb_t cb);
+
+/**
+ * @brief Push all queued asynchronous table writes and wait for completion
+ * \n - Internally calls \ref async_write_flush
+ *
+ * @retval SWITCH_STATUS_SUCCESS Success of flush
+ * @retval SWITCH_STATUS_FAILURE Fail of flush
+ */
+switch_status_t bf_switch_async_write_flush();
+
 /**
  * @brief Get SDE and SAI versions
  *
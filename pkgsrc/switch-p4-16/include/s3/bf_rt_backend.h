@@ -111,6 +111,43 @@ switch_status_t end_batch();
 switch_status_t start_batch(std::shared_ptr<BfRtSession> user_session);
 switch_status_t end_batch(std::shared_ptr<BfRtSession> user_session);
 
+/**
+ * @brief Asynchronous table writes on the default session
+ *
+ * When enabled, entry add/modify/delete on the default session no longer
+ * wait for the hardware after every entry. Writes are queued in a session
+ * batch which is pushed once batch_size writes are pending or the oldest
+ * pending write is flush_interval_us old. Once a batch completes, cb is
+ * called once for every object with writes in it, from the thread that
+ * triggered the flush. A non success status means the hardware may not hold
+ * the object's entries and the callback is expected to roll it back.
+ * Errors returned by the table API itself are still reported synchronously.
+ */
+typedef void (*async_write_cb_t)(const switch_object_id_t object_id,
+                                 const switch_status_t status);
+switch_status_t async_write_mode_set(bool enable,
+                                     uint32_t batch_size,
+                                     uint32_t flush_interval_us,
+                                     async_write_cb_t cb);
+/* Push pending writes and wait for them to complete */
+switch_status_t async_write_flush();
+
+/**
+ * @brief Attributes the table writes issued by this thread to object_id until
+ * the scope ends. Nested scopes keep the outermost object, so writes made for
+ * auto objects are reported against the user object that caused them.
+ */
+class async_write_scope {
+ public:
+  explicit async_write_scope(const switch_object_id_t object_id);
+  ~async_write_scope();
+  async_write_scope(const async_write_scope &) = delete;
+  async_write_scope &operator=(const async_write_scope &) = delete;
+
+ private:
+  bool m_owner;
+};
+
 class _bfrtCacheObject {
  public:
   _bfrtCacheObject(bf_rt_table_id_t table_id,
@@ -236,6 +236,28 @@ typedef struct switch_pktdriver_tx_filter_action_s {
   uint16_t port_lag_index;
 } switch_pktdriver_tx_filter_action_t;
 
+/** packet driver I/O counters, summed over the worker queues */
+typedef struct switch_pktdriver_io_stats_s {
+  /** packets read from the cpu, knet and hostif fds */
+  uint64_t rx_pkts;
+
+  /** reads, one recvmmsg or tun queue drain per batch */
+  uint64_t rx_batches;
+
+  /** epoll wakeups of the packet driver workers */
+  uint64_t wakeups;
+
+  /** rx rate over the last full second */
+  uint64_t rx_pps;
+
+  /** time from wakeup to the packet being handed off */
+  uint64_t rx_latency_avg_ns;
+  uint64_t rx_latency_max_ns;
+
+  /** cpu port transmits that had to wait for socket buffer space */
+  uint64_t tx_waits;
+} switch_pktdriver_io_stats_t;
+
 bool switch_pktdriver_mode_is_kernel();
 void switch_pkt_dump_enable(bool enable);
 
@@ -306,6 +328,10 @@ switch_status_t switch_pktdriver_tx_filter_num_packets_get(
 switch_status_t switch_pktdriver_tx_filter_num_packets_clear(
     const uint16_t device, const uint64_t filter_id);
 
+switch_status_t switch_pktdriver_io_stats_get(
+    switch_pktdriver_io_stats_t *io_stats);
+switch_status_t switch_pktdriver_io_stats_clear(void);
+
 switch_status_t switch_pktdriver_reason_code_stats_get(
     const uint16_t device,
     const uint16_t reason_code,
@@ -251,6 +251,7 @@ class ACLTest(ApiHelper):
             self.LagIPv4AclTableTest()
             self.IPv6AclTableTest()
             self.AclRangeTest()
+            self.AclRangeEncodingTest()
             self.AclPriorityRangeVlanBPointTest()
             self.IPv4AclRedirectTest()
             self.IPv4RaclTableTest()
@@ -1252,6 +1253,109 @@ class ACLTest(ApiHelper):
             self.cleanlast()
     ############################################################################
 
+    def AclRangeEncodingTest(self):
+        print("AclRangeEncodingTest()")
+        if not self.client.is_feature_enable(SWITCH_FEATURE_INGRESS_L4_PORT_RANGE):
+            print("L4 port range feature not enabled, skipping")
+            return
+
+        table_type = SWITCH_ACL_TABLE_ATTR_TYPE_IPV4
+        if self.client.is_feature_enable(SWITCH_FEATURE_SHARED_INGRESS_IP_ACL):
+            table_type = SWITCH_ACL_TABLE_ATTR_TYPE_IP
+
+        def range_label(acl_range):
+            return self.attribute_get(acl_range, SWITCH_ACL_RANGE_ATTR_LABEL)
+
+        def add_dst_range(min, max):
+            return self.add_acl_range(self.device,
+                type=SWITCH_ACL_RANGE_ATTR_TYPE_DST_PORT,
+                range=switcht_range_t(min=min, max=max))
+
+        stack_depth = len(self.stack)
+        try:
+            # one aligned prefix, matched in the entry without a label
+            src_range = self.add_acl_range(self.device,
+                type=SWITCH_ACL_RANGE_ATTR_TYPE_SRC_PORT,
+                range=switcht_range_t(min=1024, max=2047))
+            self.assertEqual(range_label(src_range), 0)
+
+            # identical bounds share one label, other bounds take another
+            dst_range_c = add_dst_range(300, 400)
+            dst_range_b = add_dst_range(100, 200)
+            dst_range_a = add_dst_range(100, 200)
+            shared_label = range_label(dst_range_a)
+            self.assertNotEqual(shared_label, 0)
+            self.assertEqual(range_label(dst_range_b), shared_label)
+            self.assertNotEqual(range_label(dst_range_c), 0)
+            self.assertNotEqual(range_label(dst_range_c), shared_label)
+
+            acl_table = self.add_acl_table(self.device,
+                type=table_type,
+                bind_point_type=[acl_table_bp_port],
+                direction=SWITCH_ACL_TABLE_ATTR_DIRECTION_INGRESS)
+            self.add_acl_entry(self.device,
+                src_port_range_id=src_range,
+                priority=self.high_prio,
+                packet_action=SWITCH_ACL_ENTRY_ATTR_PACKET_ACTION_DROP,
+                table_handle=acl_table)
+            self.add_acl_entry(self.device,
+                dst_port_range_id=dst_range_a,
+                priority=self.low_prio,
+                packet_action=SWITCH_ACL_ENTRY_ATTR_PACKET_ACTION_DROP,
+                table_handle=acl_table)
+            self.add_acl_entry(self.device,
+                src_port_range_id=src_range,
+                dst_port_range_id=dst_range_b,
+                priority=self.low_prio,
+                packet_action=SWITCH_ACL_ENTRY_ATTR_PACKET_ACTION_DROP,
+                table_handle=acl_table)
+            self.add_acl_entry(self.device,
+                src_ip='192.168.0.5',
+                src_ip_mask='255.255.255.255',
+                priority=self.lower_prio,
+                packet_action=SWITCH_ACL_ENTRY_ATTR_PACKET_ACTION_DROP,
+                table_handle=acl_table)
+
+            stats = {}
+            for cntr in self.client.object_counters_get(acl_table):
+                stats[cntr.counter_id] = cntr.count
+            self.assertEqual(stats[SWITCH_ACL_TABLE_COUNTER_ID_ENTRIES], 4)
+            self.assertEqual(stats[SWITCH_ACL_TABLE_COUNTER_ID_RANGE_ENTRIES], 3)
+            self.assertEqual(stats[SWITCH_ACL_TABLE_COUNTER_ID_LABEL_RANGES], 2)
+            self.assertEqual(stats[SWITCH_ACL_TABLE_COUNTER_ID_TERNARY_RANGES], 2)
+            self.assertEqual(stats[SWITCH_ACL_TABLE_COUNTER_ID_TCAM_ENTRIES], 4)
+            # 1024-2047 is one prefix, 100-200 expands into 6 prefixes:
+            # 100-103, 104-111, 112-127, 128-191, 192-199 and 200
+            self.assertEqual(
+                stats[SWITCH_ACL_TABLE_COUNTER_ID_EXPANDED_TCAM_ENTRIES],
+                1 + 6 + 6 + 1)
+            # remove the acl entries and table
+            self.cleanlast(5)
+
+            # the shared label stays with the remaining range
+            self.cleanlast()
+            self.assertEqual(range_label(dst_range_b), shared_label)
+            dst_range_d = add_dst_range(500, 600)
+            self.assertNotEqual(range_label(dst_range_d), shared_label)
+            self.assertNotEqual(range_label(dst_range_d),
+                                range_label(dst_range_c))
+            self.cleanlast()
+
+            # once the last user is gone the label is free again. With
+            # dst_range_c holding one label, 7 more distinct ranges fit
+            self.cleanlast()
+            for i in range(7):
+                add_dst_range(2001 + 100 * i, 2050 + 100 * i)
+                self.assertEqual(self.status(), 0)
+            add_dst_range(3001, 3050)
+            self.assertNotEqual(self.status(), 0)
+            # all labels taken, identical bounds still share
+            add_dst_range(300, 400)
+            self.assertEqual(self.status(), 0)
+        finally:
+            self.cleanlast(len(self.stack) - stack_depth)
+    ############################################################################
+
     def AclPriorityRangeVlanBPointTest(self):
         print("AclPriorityRangeVlanBPointTest()")
 
@@ -357,3 +357,35 @@ class AclIpv4PerfTest(ApiHelper):
         pt.printResults()
         pt.dumpResults()
         self.cleanup()
+
+###############################################################################
+
+@group('perf')
+@disabled
+class StoreContentionPerfTest(ApiHelper):
+    def runTest(self):
+        pt = PerfTest(self, self.client.switch_api_perf_test,
+                        switcht_perf_table.STORE_CONTENTION, 100000, 400001, 100000)
+        pt.configure()
+        pt.run()
+        pt.printResults()
+        pt.dumpResults()
+        self.cleanup()
+
+###############################################################################
+
+@group('perf')
+@disabled
+class AsyncRoutePerfTest(ApiHelper):
+    """
+        BMAI results are for synchronous route writes and BMAI batch
+        results for the same routes written through the async write path
+    """
+    def runTest(self):
+        pt = PerfTest(self, self.client.switch_api_perf_test,
+                        switcht_perf_table.ASYNC_ROUTE_IPV4, 10000, 60001, 10000)
+        pt.configure()
+        pt.run()
+        pt.printResults()
+        pt.dumpResults()
+        self.cleanup()
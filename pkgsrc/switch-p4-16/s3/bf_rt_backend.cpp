@@ -31,6 +31,11 @@
 #include <utility>
 #include <sstream>
 #include <algorithm>
+#include <atomic>              // NOLINT(build/c++11)
+#include <chrono>              // NOLINT(build/c++11)
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <mutex>               // NOLINT(build/c++11)
+#include <thread>              // NOLINT(build/c++11)
 
 #include "s3/switch_store.h"
 #include "s3/attribute_util.h"
@@ -183,6 +188,8 @@ switch_status_t switch_bf_rt_init() {
 switch_status_t switch_bf_rt_clean() {
   // bf_status_t bf_status = BF_SUCCESS;
   active_pipes.clear();
+  // push what is still batched and stop the async flush timer
+  if (session) async_write_mode_set(false, 0, 0, nullptr);
   // TODO(bfn) disable until we figure how to cleanly stop the stats sync thread
   // bf_status = session->sessionDestroy();
   // return bf_rt_status_xlate(bf_status);
@@ -353,13 +360,18 @@ switch_status_t switch_bf_rt_flush() {
   return bf_rt_status_xlate(rc);
 }
 
+static void async_write_suspend(bool suspend);
+
 switch_status_t start_transaction() {
   bf_status_t bf_status = BF_SUCCESS;
 
   if (!session) return SWITCH_STATUS_FAILURE;
 
+  async_write_suspend(true);
+
   bf_status = session->beginTransaction(true);
   if (bf_status != BF_SUCCESS) {
+    async_write_suspend(false);
     switch_log(SWITCH_API_LEVEL_ERROR,
                SWITCH_OT_NONE,
                "{}.{}:{}: status: {} failed to start transaction",
@@ -379,6 +391,7 @@ switch_status_t commit_transaction() {
   if (!session) return SWITCH_STATUS_FAILURE;
 
   bf_status = session->commitTransaction(true);
+  async_write_suspend(false);
   if (bf_status != BF_SUCCESS) {
     switch_log(SWITCH_API_LEVEL_ERROR,
                SWITCH_OT_NONE,
@@ -398,8 +411,10 @@ switch_status_t start_batch() {
 
   if (!session) return SWITCH_STATUS_FAILURE;
 
+  async_write_suspend(true);
   bf_status = session->beginBatch();
   if (bf_status != BF_SUCCESS) {
+    async_write_suspend(false);
     switch_log(SWITCH_API_LEVEL_ERROR,
                SWITCH_OT_NONE,
                "{}.{}:{}: status: {} failed to start batching",
@@ -419,6 +434,7 @@ switch_status_t end_batch() {
   if (!session) return SWITCH_STATUS_FAILURE;
 
   bf_status = session->endBatch(true);
+  async_write_suspend(false);
   if (bf_status != BF_SUCCESS) {
     switch_log(SWITCH_API_LEVEL_ERROR,
                SWITCH_OT_NONE,
@@ -476,6 +492,235 @@ switch_status_t end_batch(std::shared_ptr<BfRtSession> user_session) {
   return SWITCH_STATUS_SUCCESS;
 }
 
+/******************************************************************************
+ * Asynchronous writes on the default session
+ *****************************************************************************/
+thread_local switch_object_id_t async_write_object = {};
+
+async_write_scope::async_write_scope(const switch_object_id_t object_id)
+    : m_owner(async_write_object.data == SWITCH_NULL_OBJECT_ID) {
+  if (m_owner) async_write_object = object_id;
+}
+
+async_write_scope::~async_write_scope() {
+  if (m_owner) async_write_object = {};
+}
+
+class asyncWriter {
+ public:
+  static asyncWriter &writer() {
+    static asyncWriter instance;
+    return instance;
+  }
+
+  std::mutex mtx;
+  std::atomic<bool> enabled{false};
+  /* set while the application runs its own batch or transaction */
+  bool suspended = false;
+  uint32_t batch_size = 0;
+  std::chrono::microseconds flush_interval{0};
+  async_write_cb_t cb = nullptr;
+
+  bool batch_open = false;
+  uint32_t pending = 0;
+  std::chrono::steady_clock::time_point first_pending;
+  /* objects with writes in the open batch, in write order */
+  std::vector<switch_object_id_t> objects;
+
+  std::thread timer;
+  std::condition_variable timer_cv;
+  bool timer_stop = false;
+
+  /*
+   * Ends the open batch and waits for the hardware, mtx must be held. The
+   * objects it covered are handed back in done so that the callback can be
+   * run after mtx is released.
+   */
+  switch_status_t flush_locked(std::vector<switch_object_id_t> &done) {
+    if (!batch_open) return SWITCH_STATUS_SUCCESS;
+    bf_status_t bf_status = session->endBatch(true);
+    batch_open = false;
+    pending = 0;
+    done.swap(objects);
+    objects.clear();
+    if (bf_status != BF_SUCCESS) {
+      switch_log(SWITCH_API_LEVEL_ERROR,
+                 SWITCH_OT_NONE,
+                 "{}.{}:{}: status: {} async batch of {} objects failed",
+                 __NS__,
+                 __func__,
+                 __LINE__,
+                 bf_err_str(bf_status),
+                 done.size());
+    }
+    return bf_rt_status_xlate(bf_status);
+  }
+
+  void notify(const std::vector<switch_object_id_t> &done,
+              switch_status_t status) {
+    if (!cb) return;
+    for (const auto object_id : done) cb(object_id, status);
+  }
+
+  bool flush_due() const {
+    return pending >= batch_size ||
+           std::chrono::steady_clock::now() - first_pending >= flush_interval;
+  }
+
+  /* Pushes batches that nobody else is going to flush */
+  void timer_loop() {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (!timer_stop) {
+      timer_cv.wait_for(lock, flush_interval);
+      if (!batch_open || !flush_due()) continue;
+      std::vector<switch_object_id_t> done;
+      switch_status_t status = flush_locked(done);
+      lock.unlock();
+      notify(done, status);
+      lock.lock();
+    }
+  }
+
+  ~asyncWriter() { timer_stop_join(); }
+
+  void timer_stop_join() {
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      timer_stop = true;
+    }
+    timer_cv.notify_all();
+    if (timer.joinable()) timer.join();
+  }
+};
+
+/*
+ * Held around a single entry write. If the write goes to the default session
+ * in async mode it ends up in the open batch instead of waiting for the
+ * hardware, otherwise it completes synchronously as before.
+ */
+class async_write_guard {
+ public:
+  explicit async_write_guard(const std::shared_ptr<BfRtSession> &table_session)
+      : m_session(table_session) {
+    asyncWriter &w = asyncWriter::writer();
+    if (!w.enabled || table_session != session) return;
+    m_lock = std::unique_lock<std::mutex>(w.mtx);
+    if (!w.enabled || w.suspended) {
+      m_lock.unlock();
+      return;
+    }
+    if (!w.batch_open) {
+      if (session->beginBatch() != BF_SUCCESS) {
+        m_lock.unlock();
+        return;
+      }
+      w.batch_open = true;
+      w.first_pending = std::chrono::steady_clock::now();
+    }
+    m_active = true;
+  }
+
+  ~async_write_guard() {
+    if (m_lock.owns_lock()) m_lock.unlock();
+    if (!m_done.empty()) asyncWriter::writer().notify(m_done, m_done_status);
+  }
+
+  /* Takes the place of sessionCompleteOperations after the write */
+  void complete(bf_status_t rc) {
+    if (!m_active) {
+      m_session->sessionCompleteOperations();
+      return;
+    }
+    asyncWriter &w = asyncWriter::writer();
+    if (rc == BF_SUCCESS) {
+      w.pending++;
+      if (async_write_object.data != SWITCH_NULL_OBJECT_ID &&
+          (w.objects.empty() || w.objects.back() != async_write_object)) {
+        w.objects.push_back(async_write_object);
+      }
+    }
+    if (w.flush_due()) m_done_status = w.flush_locked(m_done);
+  }
+
+  async_write_guard(const async_write_guard &) = delete;
+  async_write_guard &operator=(const async_write_guard &) = delete;
+
+ private:
+  const std::shared_ptr<BfRtSession> &m_session;
+  std::unique_lock<std::mutex> m_lock;
+  bool m_active = false;
+  std::vector<switch_object_id_t> m_done;
+  switch_status_t m_done_status = SWITCH_STATUS_SUCCESS;
+};
+
+switch_status_t async_write_flush() {
+  asyncWriter &w = asyncWriter::writer();
+  std::vector<switch_object_id_t> done;
+  std::unique_lock<std::mutex> lock(w.mtx);
+  switch_status_t status = w.flush_locked(done);
+  lock.unlock();
+  w.notify(done, status);
+  return status;
+}
+
+switch_status_t async_write_mode_set(bool enable,
+                                     uint32_t batch_size,
+                                     uint32_t flush_interval_us,
+                                     async_write_cb_t cb) {
+  if (!session) return SWITCH_STATUS_FAILURE;
+  if (enable && (batch_size == 0 || flush_interval_us == 0)) {
+    return SWITCH_STATUS_INVALID_PARAMETER;
+  }
+
+  asyncWriter &w = asyncWriter::writer();
+  w.timer_stop_join();
+  switch_status_t status = async_write_flush();
+  {
+    std::lock_guard<std::mutex> lock(w.mtx);
+    w.batch_size = batch_size;
+    w.flush_interval = std::chrono::microseconds(flush_interval_us);
+    w.cb = cb;
+    w.timer_stop = false;
+    w.enabled = enable;
+  }
+  if (enable) w.timer = std::thread(&asyncWriter::timer_loop, &w);
+
+  switch_log(SWITCH_API_LEVEL_INFO,
+             SWITCH_OT_NONE,
+             "{}.{}: async writes {}, batch size {} flush interval {}us",
+             __NS__,
+             __func__,
+             enable ? "enabled" : "disabled",
+             batch_size,
+             flush_interval_us);
+  return status;
+}
+
+/*
+ * Application batches and transactions own the default session, async
+ * batching stays off until they end and pending async writes are pushed
+ * first. Suspending before the flush keeps a write from opening a new batch
+ * in between.
+ */
+static void async_write_suspend(bool suspend) {
+  asyncWriter &w = asyncWriter::writer();
+  if (!w.enabled) return;
+  {
+    std::lock_guard<std::mutex> lock(w.mtx);
+    w.suspended = suspend;
+  }
+  if (suspend) async_write_flush();
+}
+
+/* sessionCompleteOperations for calls that are not queued in async mode */
+static void session_complete_operations(
+    const std::shared_ptr<BfRtSession> &table_session) {
+  if (asyncWriter::writer().enabled && table_session == session) {
+    async_write_flush();
+  }
+  table_session->sessionCompleteOperations();
+}
+
 /******************************************************************************
  * MatchKey
  *****************************************************************************/
@@ -2409,6 +2654,7 @@ switch_status_t _Table::entry_add(const _MatchKey &match_key,
     return bf_rt_status_xlate(rc);
   }
 
+  async_write_guard async_write(table_session);
   rc = table->tableEntryAdd(*table_session,
                             table_dev_tgt,
                             *(match_key.table_key),
@@ -2422,7 +2668,7 @@ switch_status_t _Table::entry_add(const _MatchKey &match_key,
                __LINE__,
                bf_err_str(rc),
                tableNameGetInternal(table));
-    table_session->sessionCompleteOperations();
+    async_write.complete(rc);
     return bf_rt_status_xlate(rc);
   }
   SWITCH_DEBUG_LOG(switch_log(SWITCH_API_LEVEL_DEBUG,
@@ -2432,7 +2678,7 @@ switch_status_t _Table::entry_add(const _MatchKey &match_key,
                               tableNameGetInternal(table)));
   bf_rt_status = true;
 
-  table_session->sessionCompleteOperations();
+  async_write.complete(rc);
   return bf_rt_status_xlate(rc);
 }
 
@@ -2443,6 +2689,7 @@ switch_status_t _Table::entry_delete(const _MatchKey &match_key) {
   if (!match_key.table_key) return rc;
   if (!table_session) return SWITCH_STATUS_FAILURE;
 
+  async_write_guard async_write(table_session);
   rc = table->tableEntryDel(
       *table_session, table_dev_tgt, *(match_key.table_key));
   if (rc != BF_SUCCESS) {
@@ -2454,7 +2701,7 @@ switch_status_t _Table::entry_delete(const _MatchKey &match_key) {
                __LINE__,
                bf_err_str(rc),
                tableNameGetInternal(table));
-    table_session->sessionCompleteOperations();
+    async_write.complete(rc);
     return bf_rt_status_xlate(rc);
   }
   SWITCH_DEBUG_LOG(switch_log(SWITCH_API_LEVEL_DEBUG,
@@ -2462,7 +2709,7 @@ switch_status_t _Table::entry_delete(const _MatchKey &match_key) {
                               "{}: tableEntryDel success for {}",
                               __func__,
                               tableNameGetInternal(table)));
-  table_session->sessionCompleteOperations();
+  async_write.complete(rc);
   return bf_rt_status_xlate(rc);
 }
 
@@ -2484,6 +2731,7 @@ switch_status_t _Table::entry_modify(const _MatchKey &match_key,
     return bf_rt_status_xlate(rc);
   }
 
+  async_write_guard async_write(table_session);
   rc = table->tableEntryMod(*table_session,
                             table_dev_tgt,
                             *(match_key.table_key),
@@ -2497,7 +2745,7 @@ switch_status_t _Table::entry_modify(const _MatchKey &match_key,
                __LINE__,
                bf_err_str(rc),
                tableNameGetInternal(table));
-    table_session->sessionCompleteOperations();
+    async_write.complete(rc);
     return bf_rt_status_xlate(rc);
   }
   SWITCH_DEBUG_LOG(switch_log(SWITCH_API_LEVEL_DEBUG,
@@ -2505,7 +2753,7 @@ switch_status_t _Table::entry_modify(const _MatchKey &match_key,
                               "{}: tableEntryMod success for {}",
                               __func__,
                               tableNameGetInternal(table)));
-  table_session->sessionCompleteOperations();
+  async_write.complete(rc);
   return bf_rt_status_xlate(rc);
 }
 
@@ -2538,7 +2786,7 @@ switch_status_t _Table::clear_entries() {
                __LINE__,
                bf_err_str(rc),
                tableNameGetInternal(table));
-    table_session->sessionCompleteOperations();
+    session_complete_operations(table_session);
     return bf_rt_status_xlate(rc);
   }
   SWITCH_DEBUG_LOG(switch_log(SWITCH_API_LEVEL_DEBUG,
@@ -2546,7 +2794,7 @@ switch_status_t _Table::clear_entries() {
                               "{}: tableEntryMod success for {}",
                               __func__,
                               tableNameGetInternal(table)));
-  table_session->sessionCompleteOperations();
+  session_complete_operations(table_session);
   return bf_rt_status_xlate(rc);
 }
 
@@ -2614,7 +2862,7 @@ switch_status_t _Table::default_entry_set(const _ActionEntry &action_entry,
              __LINE__,
              tableNameGetInternal(table));
 
-  table_session->sessionCompleteOperations();
+  session_complete_operations(table_session);
   return bf_rt_status_xlate(rc);
 }
 
@@ -2646,7 +2894,7 @@ switch_status_t _Table::default_entry_get(const _ActionEntry &action_entry) {
              __LINE__,
              tableNameGetInternal(table));
 
-  table_session->sessionCompleteOperations();
+  session_complete_operations(table_session);
   return bf_rt_status_xlate(rc);
 }
 
@@ -2727,7 +2975,7 @@ switch_status_t _Table::pvs_scope_set(const GressTarget &gress_target,
                tableNameGetInternal(table));
     return bf_rt_status_xlate(rc);
   }
-  table_session->sessionCompleteOperations();
+  session_complete_operations(table_session);
   return bf_rt_status_xlate(rc);
 }
 switch_status_t _Table::dynamic_hash_field_set(
@@ -2812,7 +3060,7 @@ switch_status_t _Table::dynamic_hash_field_set(
                bf_err_str(rc),
                tableNameGetInternal(table));
   }
-  table_session->sessionCompleteOperations();
+  session_complete_operations(table_session);
   return bf_rt_status_xlate(rc);
 }
 
@@ -2900,7 +3148,7 @@ switch_status_t _Table::dynamic_hash_algo_get(bf_rt_id_t action_id,
   }
   rotate = static_cast<uint32_t>(rotate_val);
 
-  table_session->sessionCompleteOperations();
+  session_complete_operations(table_session);
   return bf_rt_status_xlate(rc);
 }
 
@@ -2989,7 +3237,7 @@ switch_status_t _Table::dynamic_hash_algo_get(bf_rt_id_t action_id,
     return bf_rt_status_xlate(rc);
   }
 
-  table_session->sessionCompleteOperations();
+  session_complete_operations(table_session);
   return bf_rt_status_xlate(rc);
 }
 
@@ -3061,7 +3309,7 @@ switch_status_t _Table::dynamic_hash_algo_set(bf_rt_id_t action_id,
                bf_err_str(rc),
                tableNameGetInternal(table));
   }
-  table_session->sessionCompleteOperations();
+  session_complete_operations(table_session);
   return bf_rt_status_xlate(rc);
 }
 
@@ -3150,7 +3398,7 @@ switch_status_t _Table::dynamic_hash_algo_set(bf_rt_id_t action_id,
                bf_err_str(rc),
                tableNameGetInternal(table));
   }
-  table_session->sessionCompleteOperations();
+  session_complete_operations(table_session);
   return bf_rt_status_xlate(rc);
 }
 
@@ -3200,7 +3448,7 @@ switch_status_t _Table::asymmetric_scope_set() {
                tableNameGetInternal(table));
     return bf_rt_status_xlate(rc);
   }
-  table_session->sessionCompleteOperations();
+  session_complete_operations(table_session);
   return bf_rt_status_xlate(rc);
 }
 
@@ -3255,7 +3503,7 @@ switch_status_t _Table::do_hw_stats_sync() {
                tableNameGetInternal(table));
     return bf_rt_status_xlate(rc);
   }
-  table_session->sessionCompleteOperations();
+  session_complete_operations(table_session);
   return bf_rt_status_xlate(rc);
 }
 
@@ -3276,7 +3524,7 @@ switch_status_t _Table::table_size_get(size_t *size) {
                bf_err_str(rc),
                tableNameGetInternal(table));
   }
-  table_session->sessionCompleteOperations();
+  session_complete_operations(table_session);
   return bf_rt_status_xlate(rc);
 }
 
@@ -3324,7 +3572,7 @@ switch_status_t _Table::table_usage_get(uint32_t *usage) {
                tableNameGetInternal(table));
   }
 
-  table_session->sessionCompleteOperations();
+  session_complete_operations(table_session);
   return bf_rt_status_xlate(rc);
 }
 
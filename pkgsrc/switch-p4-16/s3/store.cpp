@@ -19,8 +19,12 @@
 
 
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <store.h>
 
+#include <cstdio>
 #include <fstream>
 #include <vector>
 #include <string>
@@ -36,17 +40,147 @@ namespace db {
 
 using ::smi::logging::switch_log;
 
-db_store *object_attr_hash = nullptr;
-const db_store *get_db() { return object_attr_hash; }
+db_shards *object_attr_hash = nullptr;
+const db_shards *get_db() { return object_attr_hash; }
 std::vector<switch_object_id_t> ordered_create_list;
 const std::vector<switch_object_id_t> &get_creation_list() {
   return ordered_create_list;
 }
 
-/* Mutex to protect the primary db_store. There is no global lock held anywhere
- * else and this is the only mutex which will provide concurrency
+/* Number of nested switch_store_lock() calls made by this thread. While it is
+ * non zero the thread owns every shard exclusively and the per object
+ * operations below must not take the shard locks again.
  */
-std::recursive_mutex db_mtx;
+thread_local int store_lock_depth = 0;
+
+inline db_shard &shard_get(const switch_object_id_t object_id) {
+  return (*object_attr_hash)[std::hash<switch_object_id_t>{}(object_id) %
+                             DB_STORE_SHARDS];
+}
+
+/*
+ * Per object type offset table, built from the model at db_load. Maps
+ * attr_id - base to the slot index in attribute_map::slots.
+ */
+#define ATTR_SLOT_NONE 0xFFFF
+struct attr_layout {
+  switch_attr_id_t base = 0;
+  std::vector<uint16_t> slot;
+};
+std::vector<attr_layout> attr_layouts;
+
+void attr_layouts_build(ModelInfo *model_info) {
+  attr_layouts.clear();
+  for (const auto &object_info : *model_info) {
+    const size_t ot = object_info.object_type;
+    if (attr_layouts.size() <= ot) attr_layouts.resize(ot + 1);
+    const auto &attr_md_list = object_info.get_attribute_list();
+    if (attr_md_list.empty()) continue;
+
+    const auto range = std::minmax_element(
+        attr_md_list.begin(),
+        attr_md_list.end(),
+        [](const AttributeMetadata &a, const AttributeMetadata &b) {
+          return a.attr_id < b.attr_id;
+        });
+    attr_layout &layout = attr_layouts[ot];
+    layout.base = range.first->attr_id;
+    layout.slot.assign(range.second->attr_id - layout.base + 1,
+                       ATTR_SLOT_NONE);
+    for (size_t i = 0; i < attr_md_list.size(); i++) {
+      layout.slot[attr_md_list[i].attr_id - layout.base] =
+          static_cast<uint16_t>(i);
+    }
+  }
+}
+
+inline size_t attr_slot_count(const switch_object_type_t object_type) {
+  if (object_type >= attr_layouts.size()) return 0;
+  const attr_layout &layout = attr_layouts[object_type];
+  return std::count_if(layout.slot.begin(),
+                       layout.slot.end(),
+                       [](uint16_t slot) { return slot != ATTR_SLOT_NONE; });
+}
+
+inline uint16_t attr_slot_get(const switch_object_type_t object_type,
+                              const switch_attr_id_t attr_id) {
+  if (object_type >= attr_layouts.size()) return ATTR_SLOT_NONE;
+  const attr_layout &layout = attr_layouts[object_type];
+  if (attr_id < layout.base) return ATTR_SLOT_NONE;
+  const size_t offset = attr_id - layout.base;
+  if (offset >= layout.slot.size()) return ATTR_SLOT_NONE;
+  return layout.slot[offset];
+}
+
+/* Returns the stored attribute or nullptr if it has no value */
+inline switch_attribute_t *attr_find(attribute_map &attr_map,
+                                     const switch_attr_id_t attr_id,
+                                     const uint16_t extra) {
+  if (extra == 0) {
+    const uint16_t slot = attr_slot_get(attr_map.object_type, attr_id);
+    if (slot < attr_map.slots.size()) {
+      switch_attribute_t &attr = attr_map.slots[slot];
+      return (attr.id == attr_id) ? &attr : nullptr;
+    }
+  }
+  auto it = std::find_if(attr_map.list_values.begin(),
+                         attr_map.list_values.end(),
+                         [&](value_wrapper const &object) {
+                           return (object.get_attr_id() == attr_id) &&
+                                  (object.extra == extra);
+                         });
+  if (it == attr_map.list_values.end()) return nullptr;
+  return &it->get_mutable();
+}
+
+/* Sets the value, adding the attribute if it has none yet */
+inline void attr_store(attribute_map &attr_map,
+                       const switch_attr_id_t attr_id,
+                       const uint16_t extra,
+                       const switch_attribute_value_t &value) {
+  if (extra == 0) {
+    const uint16_t slot = attr_slot_get(attr_map.object_type, attr_id);
+    if (slot < attr_map.slots.size()) {
+      attr_map.slots[slot].id = attr_id;
+      attr_map.slots[slot].value = value;
+      return;
+    }
+  }
+  switch_attribute_t *attr = attr_find(attr_map, attr_id, extra);
+  if (attr != nullptr)
+    attr->value = value;
+  else
+    attr_map.list_values.emplace_back(attr_id, extra, value);
+}
+
+/* Scoped shard lock, shared for lookups and exclusive for updates */
+class shard_guard {
+ public:
+  shard_guard(db_shard &shard, bool exclusive)
+      : m_mtx(shard.mtx),
+        m_exclusive(exclusive),
+        m_owned(store_lock_depth == 0) {
+    if (!m_owned) return;
+    if (m_exclusive)
+      m_mtx.lock();
+    else
+      m_mtx.lock_shared();
+  }
+  ~shard_guard() {
+    if (!m_owned) return;
+    if (m_exclusive)
+      m_mtx.unlock();
+    else
+      m_mtx.unlock_shared();
+  }
+  shard_guard(const shard_guard &) = delete;
+  shard_guard &operator=(const shard_guard &) = delete;
+
+ private:
+  std::shared_mutex &m_mtx;
+  const bool m_exclusive;
+  const bool m_owned;
+};
 
 class topoSort {
   std::unordered_map<switch_object_id_t, bool> vertices;
@@ -59,7 +193,8 @@ class topoSort {
   }
 
   // A recursive function used by goSort
-  void topologicalSort(const switch_object_id_t v) {
+  void topologicalSort(const switch_object_id_t v,
+                       std::vector<switch_object_id_t> &order) {
     if (v.data == 0) return;
 
     if (vertices.find(v) != vertices.end()) {
@@ -86,22 +221,24 @@ class topoSort {
     }
     // Recur for all the vertices adjacent to this vertex
     for (const auto edge : edges.at(v)) {
-      if (edge.data && !vertices[edge]) topologicalSort(edge);
+      if (edge.data && !vertices[edge]) topologicalSort(edge, order);
     }
 
     // Push current vertex to stack which stores result
-    ordered_create_list.push_back(v);
+    order.push_back(v);
   }
 
   // The function to do Topological Sort. It uses recursive topologicalSort()
-  void goSort() {
-    ordered_create_list.clear();
+  void goSort(std::vector<switch_object_id_t> &order) {
+    order.clear();
     // Call the recursive helper function to store Topological
     // Sort starting from all vertices one by one
     for (auto it = edges.begin(); it != edges.end(); it++) {
-      if (vertices[it->first] == false) topologicalSort(it->first);
+      if (vertices[it->first] == false) topologicalSort(it->first, order);
     }
   }
+
+  void goSort() { goSort(ordered_create_list); }
 };
 
 /*
@@ -117,7 +254,9 @@ class topoSort {
 void write_one_object(std::ofstream &out,
                       switch_object_id_t object,
                       ModelInfo *model_info) {
-  if (object_attr_hash->find(object) == object_attr_hash->end()) return;
+  db_store &objects = shard_get(object).objects;
+  auto object_it = objects.find(object);
+  if (object_it == objects.end()) return;
 
   switch_object_type_t object_type = switch_store::object_type_query(object);
   const ObjectInfo *object_info = model_info->get_object_info(object_type);
@@ -134,14 +273,23 @@ void write_one_object(std::ofstream &out,
   }
   std::string object_name = object_info->get_object_name_fqn();
 
-  (*object_attr_hash)[object].first++;
+  attribute_map &attr_map = object_it->second;
+  attr_map.dump_count++;
   std::stringstream this_object_out;
   this_object_out << object_name << ":";
   this_object_out << object;
 
-  for (auto &ita : (*object_attr_hash)[object].second) {
-    if (ita.attr_id == SPECIAL_OBJECT_STATUS_ATTR_ID) continue;
-    value_key_t key = {.attr_id = ita.attr_id, .extra = ita.extra};
+  std::vector<value_key_t> keys;
+  for (const auto &attr : attr_map.slots) {
+    if (attr.id != 0) keys.push_back({.attr_id = attr.id, .extra = 0});
+  }
+  for (const auto &ita : attr_map.list_values) {
+    keys.push_back({.attr_id = ita.get_attr_id(), .extra = ita.extra});
+  }
+
+  for (const auto &key : keys) {
+    const switch_attribute_value_t &value =
+        attr_find(attr_map, key.attr_id, key.extra)->value;
     const AttributeMetadata *attr_md =
         object_info->get_attr_metadata(key.attr_id);
     if (attr_md == NULL) {
@@ -158,7 +306,7 @@ void write_one_object(std::ofstream &out,
     }
     std::string attr_name = attr_md->get_attr_name_fqn();
     this_object_out << "," << std::dec << attr_name << "#" << key.extra << "#";
-    switch_attribute_value_t m_value = ita.get_value();
+    const switch_attribute_value_t &m_value = value;
     // This is a list attribute and holds the total list count
     if (m_value.type == SWITCH_TYPE_LIST) {
       if (key.extra == 0) {
@@ -173,12 +321,12 @@ void write_one_object(std::ofstream &out,
     } else if (m_value.type == SWITCH_TYPE_IP_ADDRESS) {
       this_object_out << static_cast<uint16_t>(m_value.ipaddr.addr_family)
                       << "-";
-      this_object_out << ita.get_value();
+      this_object_out << value;
     } else if (m_value.type == SWITCH_TYPE_IP_PREFIX) {
       this_object_out << static_cast<uint16_t>(
                              m_value.ipprefix.addr.addr_family)
                       << "-";
-      this_object_out << ita.get_value();
+      this_object_out << value;
     } else if (m_value.type == SWITCH_TYPE_OBJECT_ID) {
       switch_object_type_t attr_object_type =
           switch_store::object_type_query(m_value.oid);
@@ -200,7 +348,7 @@ void write_one_object(std::ofstream &out,
         std::string attr_object_name = attr_object_info->get_object_name_fqn();
         this_object_out << attr_object_name << ":";
       }
-      this_object_out << ita.get_value();
+      this_object_out << value;
     } else if (m_value.type == SWITCH_TYPE_ENUM) {
       auto value_md = attr_md->get_value_metadata();
       auto enums_md = value_md->get_enum_metadata();
@@ -210,7 +358,7 @@ void write_one_object(std::ofstream &out,
         }
       }
     } else {
-      this_object_out << ita.get_value();
+      this_object_out << value;
     }
   }
   out << this_object_out.str() << std::endl;
@@ -240,7 +388,7 @@ void write_one_object_one_attr(std::ofstream &out,
   }
   std::string object_name = object_info->get_object_name_fqn();
 
-  (*object_attr_hash)[object].first++;
+  shard_get(object).objects[object].dump_count++;
   std::stringstream this_object_out;
   this_object_out << object_name << ":";
   this_object_out << object;
@@ -392,12 +540,339 @@ switch_status_t db_print(bool stats_cache_only) {
 }
 #endif
 
+/*
+ * Binary warm boot snapshot, written next to the text dump.
+ *
+ * The text dump refers to object types, attributes and enums by name so it
+ * survives model changes, but parsing it and sorting the objects again is
+ * slow for large stores. The snapshot stores the raw attribute values and the
+ * creation order computed at dump time. It is only used when the model
+ * version and the schema hash match the running model and the checksum is
+ * good, otherwise warm boot falls back to the text dump.
+ *
+ * Layout, host byte order:
+ *   snapshot_header
+ *   object_count x { snapshot_object, attr_count x snapshot_attr }
+ *   order_count x switch_object_id_t, the ordered creation list
+ */
+#define DB_SNAPSHOT_MAGIC "S3SNAP\0"
+#define DB_SNAPSHOT_FORMAT_VERSION 1
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+struct snapshot_header {
+  char magic[8];
+  uint32_t format_version;
+  uint32_t model_version;
+  uint64_t schema_hash;
+  uint64_t object_count;
+  uint64_t order_count;
+  /* FNV-1a over everything following the header */
+  uint64_t checksum;
+};
+
+struct snapshot_object {
+  switch_object_id_t object_id;
+  uint32_t attr_count;
+  uint32_t reserved;
+};
+
+struct snapshot_attr {
+  switch_attr_id_t attr_id;
+  uint16_t extra;
+  uint32_t reserved;
+  switch_attribute_value_t value;
+};
+
+static_assert(sizeof(snapshot_header) % 8 == 0, "snapshot_header alignment");
+static_assert(sizeof(snapshot_object) % 8 == 0, "snapshot_object alignment");
+static_assert(sizeof(snapshot_attr) % 8 == 0, "snapshot_attr alignment");
+
+inline uint64_t fnv1a(const void *data, size_t len, uint64_t hash) {
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  for (size_t i = 0; i < len; i++) {
+    hash ^= bytes[i];
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
+inline uint64_t fnv1a(const std::string &str, uint64_t hash) {
+  return fnv1a(str.c_str(), str.size() + 1, hash);
+}
+
+/*
+ * Everything the raw values depend on: object type, attribute and enum
+ * numbering, attribute types and the flags used at restore.
+ */
+uint64_t schema_hash_get(ModelInfo *model_info) {
+  uint64_t hash = FNV_OFFSET_BASIS;
+  for (const auto &object_info : *model_info) {
+    hash = fnv1a(&object_info.object_type, sizeof(switch_object_type_t), hash);
+    hash = fnv1a(object_info.get_object_name_fqn(), hash);
+    for (const auto &attr_md : object_info.get_attribute_list()) {
+      const switch_attr_flags_t &flags = attr_md.get_flags();
+      const uint8_t attr_flags[] = {flags.is_status,
+                                    flags.is_internal,
+                                    flags.is_read_only};
+      const uint32_t type = attr_md.type;
+      hash = fnv1a(&attr_md.attr_id, sizeof(switch_attr_id_t), hash);
+      hash = fnv1a(&type, sizeof(type), hash);
+      hash = fnv1a(attr_flags, sizeof(attr_flags), hash);
+      hash = fnv1a(attr_md.get_attr_name_fqn(), hash);
+      const ValueMetadata *value_md = attr_md.get_value_metadata();
+      for (const auto &enum_md : value_md->get_enum_metadata()) {
+        hash = fnv1a(&enum_md.enum_value, sizeof(enum_md.enum_value), hash);
+        hash = fnv1a(enum_md.enum_name_fqn, hash);
+      }
+    }
+  }
+  return hash;
+}
+
+class snapshot_writer {
+ public:
+  explicit snapshot_writer(const std::string &file)
+      : m_out(file.c_str(), std::ofstream::trunc | std::ofstream::binary) {}
+  bool good() const { return m_out.good(); }
+  void write(const void *data, size_t len) {
+    m_out.write(static_cast<const char *>(data), len);
+    m_checksum = fnv1a(data, len, m_checksum);
+  }
+  void write_header(snapshot_header &header) {
+    header.checksum = m_checksum;
+    m_out.seekp(0);
+    m_out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  }
+  void close() { m_out.close(); }
+
+ private:
+  std::ofstream m_out;
+  uint64_t m_checksum = FNV_OFFSET_BASIS;
+};
+
+/*
+ * Objects are streamed out one by one, the header is filled in once the
+ * counts and the checksum are known. Expects the store lock to be held.
+ */
+switch_status_t db_snapshot_write(const std::string &snapshot_file,
+                                  ModelInfo *model_info) {
+  const std::string tmp_file = snapshot_file + ".tmp";
+  snapshot_writer out(tmp_file);
+  if (!out.good()) return SWITCH_STATUS_FAILURE;
+
+  snapshot_header header = {};
+  memcpy(header.magic, DB_SNAPSHOT_MAGIC, sizeof(header.magic));
+  header.format_version = DB_SNAPSHOT_FORMAT_VERSION;
+  header.model_version = model_info->get_version();
+  header.schema_hash = schema_hash_get(model_info);
+  out.write_header(header);
+
+  topoSort topo;
+  switch_object_id_t empty = {};
+  std::vector<snapshot_attr> attrs;
+  for (const auto &shard : *object_attr_hash) {
+    for (const auto &object : shard.objects) {
+      const switch_object_id_t object_id = object.first;
+      const attribute_map &attr_map = object.second;
+      const ObjectInfo *object_info =
+          model_info->get_object_info(attr_map.object_type);
+      if (object_info == NULL) continue;
+      const bool is_device =
+          object_info->get_object_name().compare("device") == 0;
+      topo.addEdge(object_id, empty);
+
+      attrs.clear();
+      auto add_attr = [&](const switch_attribute_t &attr, uint16_t extra) {
+        const AttributeMetadata *attr_md =
+            object_info->get_attr_metadata(attr.id);
+        if (attr_md == NULL) return;
+        snapshot_attr out_attr = {};
+        out_attr.attr_id = attr.id;
+        out_attr.extra = extra;
+        out_attr.value = attr.value;
+        const switch_attr_flags_t &flags = attr_md->get_flags();
+        if (flags.is_status) {
+          // status attributes always restart from 0
+          out_attr.value = {};
+          out_attr.value.type = attr.value.type;
+        }
+        if (out_attr.value.type == SWITCH_TYPE_LIST) {
+          out_attr.value.list.list = nullptr;
+        }
+        if (attr_md->type != SWITCH_TYPE_LIST && !is_device &&
+            out_attr.value.type == SWITCH_TYPE_OBJECT_ID &&
+            !flags.is_internal && !flags.is_read_only) {
+          topo.addEdge(object_id, out_attr.value.oid);
+        }
+        attrs.push_back(out_attr);
+      };
+      for (const auto &attr : attr_map.slots) {
+        if (attr.id != 0) add_attr(attr, 0);
+      }
+      for (const auto &ita : attr_map.list_values) {
+        add_attr(ita.get(), ita.extra);
+      }
+
+      snapshot_object out_object = {};
+      out_object.object_id = object_id;
+      out_object.attr_count = static_cast<uint32_t>(attrs.size());
+      out.write(&out_object, sizeof(out_object));
+      out.write(attrs.data(), attrs.size() * sizeof(snapshot_attr));
+      header.object_count++;
+    }
+  }
+
+  // Sort into a local list, the live create order must not change
+  std::vector<switch_object_id_t> snapshot_order;
+  topo.goSort(snapshot_order);
+  header.order_count = snapshot_order.size();
+  out.write(snapshot_order.data(),
+            snapshot_order.size() * sizeof(switch_object_id_t));
+  out.write_header(header);
+  out.close();
+  if (!out.good() || rename(tmp_file.c_str(), snapshot_file.c_str()) != 0) {
+    unlink(tmp_file.c_str());
+    return SWITCH_STATUS_FAILURE;
+  }
+  return SWITCH_STATUS_SUCCESS;
+}
+
+/*
+ * Checks the snapshot against the running model and walks the record headers
+ * so nothing is read past the end of the mapping later on.
+ */
+switch_status_t db_snapshot_validate(const uint8_t *base,
+                                     size_t size,
+                                     ModelInfo *model_info) {
+  if (size < sizeof(snapshot_header)) return SWITCH_STATUS_FAILURE;
+  const snapshot_header *header =
+      reinterpret_cast<const snapshot_header *>(base);
+  if (memcmp(header->magic, DB_SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 ||
+      header->format_version != DB_SNAPSHOT_FORMAT_VERSION) {
+    return SWITCH_STATUS_FAILURE;
+  }
+  if (header->model_version != model_info->get_version() ||
+      header->schema_hash != schema_hash_get(model_info)) {
+    switch_log(SWITCH_API_LEVEL_WARN,
+               SWITCH_OT_NONE,
+               "db_read: Snapshot was taken with model version {}, running "
+               "{}, ignoring it",
+               header->model_version,
+               model_info->get_version());
+    return SWITCH_STATUS_FAILURE;
+  }
+  if (fnv1a(base + sizeof(snapshot_header),
+            size - sizeof(snapshot_header),
+            FNV_OFFSET_BASIS) != header->checksum) {
+    switch_log(SWITCH_API_LEVEL_ERROR,
+               SWITCH_OT_NONE,
+               "db_read: Snapshot checksum mismatch, ignoring it");
+    return SWITCH_STATUS_FAILURE;
+  }
+
+  size_t offset = sizeof(snapshot_header);
+  for (uint64_t i = 0; i < header->object_count; i++) {
+    if (size - offset < sizeof(snapshot_object)) return SWITCH_STATUS_FAILURE;
+    const snapshot_object *object =
+        reinterpret_cast<const snapshot_object *>(base + offset);
+    offset += sizeof(snapshot_object);
+    if ((size - offset) / sizeof(snapshot_attr) < object->attr_count) {
+      return SWITCH_STATUS_FAILURE;
+    }
+    offset += object->attr_count * sizeof(snapshot_attr);
+  }
+  if ((size - offset) / sizeof(switch_object_id_t) != header->order_count) {
+    return SWITCH_STATUS_FAILURE;
+  }
+  return SWITCH_STATUS_SUCCESS;
+}
+
+/*
+ * The snapshot is mapped read only and the values are copied straight into
+ * the store, no parsing and no topological sort. Nothing in the store is
+ * touched until the whole file has been validated, so on failure the caller
+ * can still restore from the text dump.
+ */
+switch_status_t db_snapshot_load(const std::string &snapshot_file,
+                                 const std::string &text_file,
+                                 ModelInfo *model_info,
+                                 uint64_t &num_records) {
+  struct stat snapshot_stat = {}, text_stat = {};
+  if (stat(snapshot_file.c_str(), &snapshot_stat) != 0) {
+    return SWITCH_STATUS_ITEM_NOT_FOUND;
+  }
+  // a text dump written after the snapshot, e.g. by an older release, wins
+  if (stat(text_file.c_str(), &text_stat) == 0 &&
+      text_stat.st_mtime > snapshot_stat.st_mtime) {
+    return SWITCH_STATUS_FAILURE;
+  }
+
+  int fd = open(snapshot_file.c_str(), O_RDONLY);
+  if (fd < 0) return SWITCH_STATUS_FAILURE;
+  const size_t size = static_cast<size_t>(snapshot_stat.st_size);
+  void *map = size ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0)
+                   : MAP_FAILED;
+  close(fd);
+  if (map == MAP_FAILED) return SWITCH_STATUS_FAILURE;
+  madvise(map, size, MADV_SEQUENTIAL);
+
+  const uint8_t *base = static_cast<const uint8_t *>(map);
+  switch_status_t status = db_snapshot_validate(base, size, model_info);
+  if (status != SWITCH_STATUS_SUCCESS) {
+    munmap(map, size);
+    return status;
+  }
+
+  const snapshot_header *header =
+      reinterpret_cast<const snapshot_header *>(base);
+  size_t offset = sizeof(snapshot_header);
+  for (uint64_t i = 0; i < header->object_count; i++) {
+    const snapshot_object *object =
+        reinterpret_cast<const snapshot_object *>(base + offset);
+    offset += sizeof(*object);
+    const snapshot_attr *attrs =
+        reinterpret_cast<const snapshot_attr *>(base + offset);
+    offset += object->attr_count * sizeof(snapshot_attr);
+
+    switch_object_id_t object_id = object->object_id;
+    const switch_object_type_t object_type =
+        switch_store::object_type_query(object_id);
+    const ObjectInfo *object_info = model_info->get_object_info(object_type);
+    if (object_info == NULL) continue;
+
+    attribute_map *attr_map = object_create(object_id, object_info);
+    status = switch_store::oid_create(object_type, object_id, true);
+    if (status != SWITCH_STATUS_SUCCESS) {
+      switch_log(SWITCH_API_LEVEL_ERROR,
+                 object_type,
+                 "{}.{}: OID reserve fail for object: {} type: {}",
+                 __func__,
+                 __LINE__,
+                 object_id,
+                 object_type);
+      continue;
+    }
+    for (uint32_t j = 0; j < object->attr_count; j++) {
+      attr_store(*attr_map, attrs[j].attr_id, attrs[j].extra, attrs[j].value);
+    }
+    num_records++;
+  }
+
+  const switch_object_id_t *order =
+      reinterpret_cast<const switch_object_id_t *>(base + offset);
+  ordered_create_list.assign(order, order + header->order_count);
+  munmap(map, size);
+  return SWITCH_STATUS_SUCCESS;
+}
+
 /*
  * Read each object from DB and store to file
  */
 switch_status_t db_clear() {
-  std::lock_guard<std::recursive_mutex> guard(db_mtx);
-  object_attr_hash->clear();
+  switch_store_lock();
+  for (auto &shard : *object_attr_hash) shard.objects.clear();
+  switch_store_unlock();
   return SWITCH_STATUS_SUCCESS;
 }
 
@@ -405,7 +880,6 @@ switch_status_t db_clear() {
  * Read each object from DB and store to file
  */
 switch_status_t db_dump(const char *const dump_file) {
-  std::lock_guard<std::recursive_mutex> guard(db_mtx);
   uint64_t num_records = 0;
 
   ModelInfo *model_info = NULL;
@@ -419,14 +893,26 @@ switch_status_t db_dump(const char *const dump_file) {
   std::string out_file = dump_file;
   std::ofstream out;
   out.open(out_file.c_str(), std::ofstream::trunc);
+  switch_store_lock();
   if (out) {
-    for (auto it = object_attr_hash->begin(); it != object_attr_hash->end();
-         it++) {
-      write_one_object(out, it->first, model_info);
-      num_records++;
+    for (const auto &shard : *object_attr_hash) {
+      for (auto it = shard.objects.begin(); it != shard.objects.end(); it++) {
+        write_one_object(out, it->first, model_info);
+        num_records++;
+      }
     }
   }
   out.close();
+  // written after the text file so it is never older than it
+  if (db_snapshot_write(out_file + DB_SNAPSHOT_SUFFIX, model_info) !=
+      SWITCH_STATUS_SUCCESS) {
+    switch_log(SWITCH_API_LEVEL_ERROR,
+               SWITCH_OT_NONE,
+               "db_write: Failed to write snapshot, next warm boot will "
+               "restore from {}",
+               out_file.c_str());
+  }
+  switch_store_unlock();
   switch_log(SWITCH_API_LEVEL_WARN,
              SWITCH_OT_NONE,
              "db_write: Data flushed to persistent storage at {}",
@@ -593,19 +1079,33 @@ switch_status_t db_load(bool warm_init, const char *const warm_init_file) {
   topoSort topo;
   switch_object_id_t empty = {};
 
-  object_attr_hash = new db_store();
+  object_attr_hash = new db_shards();
+
+  model_info = switch_store::switch_model_info_get();
+  if (model_info == nullptr) {
+    return SWITCH_STATUS_FAILURE;
+  }
+  attr_layouts_build(model_info);
 
   // nothing to load if not warm_init_mode
   if (!warm_init) return status;
   switch_log(
       SWITCH_API_LEVEL_WARN, SWITCH_OT_NONE, "db_read: Warm boot initiated");
 
-  model_info = switch_store::switch_model_info_get();
-  if (model_info == nullptr) {
-    return SWITCH_STATUS_FAILURE;
+  std::string in_file = warm_init_file;
+  status = db_snapshot_load(
+      in_file + DB_SNAPSHOT_SUFFIX, in_file, model_info, num_records);
+  if (status == SWITCH_STATUS_SUCCESS) {
+    switch_log(SWITCH_API_LEVEL_WARN,
+               SWITCH_OT_NONE,
+               "db_read: Total records read from snapshot {}{}: {}",
+               in_file.c_str(),
+               DB_SNAPSHOT_SUFFIX,
+               num_records);
+    return status;
   }
+  status = SWITCH_STATUS_SUCCESS;
 
-  std::string in_file = warm_init_file;
   switch_log(SWITCH_API_LEVEL_WARN,
              SWITCH_OT_NONE,
              "db_read: Data reading from persistent storage at {}",
@@ -751,47 +1251,49 @@ switch_status_t db_load(bool warm_init, const char *const warm_init_file) {
   return status;
 }
 
+std::vector<switch_object_id_t> get_object_ids() {
+  std::vector<switch_object_id_t> object_ids;
+  for (auto &shard : *object_attr_hash) {
+    shard_guard guard(shard, false);
+    for (const auto &object : shard.objects) {
+      object_ids.push_back(object.first);
+    }
+  }
+  return object_ids;
+}
+
 bool object_exists(const switch_object_id_t object_id) {
-  return (object_attr_hash->find(object_id) != object_attr_hash->end());
+  db_shard &shard = shard_get(object_id);
+  shard_guard guard(shard, false);
+  return (shard.objects.find(object_id) != shard.objects.end());
 }
 
 switch_status_t object_delete(const switch_object_id_t object_id) {
-  CHECK_RET(!object_exists(object_id), SWITCH_STATUS_FAILURE);
-
   // SWITCH_LOG_DEBUG("store: removing object %lx", object_id.data);
 
-  std::lock_guard<std::recursive_mutex> guard(db_mtx);
-  size_t erased = object_attr_hash->erase(object_id);
+  db_shard &shard = shard_get(object_id);
+  shard_guard guard(shard, true);
+  size_t erased = shard.objects.erase(object_id);
   CHECK_RET(erased != 1, SWITCH_STATUS_FAILURE);
   return SWITCH_STATUS_SUCCESS;
 }
 
 attribute_map *object_create(const switch_object_id_t object_id,
                              const ObjectInfo *object_info) {
-  std::lock_guard<std::recursive_mutex> guard(db_mtx);
+  db_shard &shard = shard_get(object_id);
+  shard_guard guard(shard, true);
 
   // this creates an entry and returns the reference
-  attribute_map *attr_map = &(*object_attr_hash)[object_id];
-
-  // reserve attr_count number of entries and assign to map
-  // 1 extra for lock special attr
-  const auto &attr_md_list = object_info->get_attribute_list();
-  attribute_wrapper object_attrs;
-  object_attrs.reserve(attr_md_list.size() + 1);
-
-  // push special lock attr
-  switch_attribute_value_t special_value_in = {};
-  object_attrs.emplace_back(SPECIAL_OBJECT_STATUS_ATTR_ID,
-                            static_cast<uint64_t>(0),
-                            special_value_in);
-
-  // push the actual object attrs
-  for (const auto &attr_md : attr_md_list) {
+  attribute_map *attr_map = &shard.objects[object_id];
+
+  // all the slots are allocated at once and every attr starts out zeroed
+  attr_map->object_type = object_info->object_type;
+  attr_map->slots.assign(attr_slot_count(attr_map->object_type),
+                         switch_attribute_t{});
+  for (const auto &attr_md : object_info->get_attribute_list()) {
     switch_attribute_value_t value_in = {};
-    object_attrs.emplace_back(
-        attr_md.attr_id, static_cast<uint64_t>(0), value_in);
+    attr_store(*attr_map, attr_md.attr_id, 0, value_in);
   }
-  attr_map->second = std::move(object_attrs);
 
   return attr_map;
 }
@@ -799,39 +1301,34 @@ attribute_map *object_create(const switch_object_id_t object_id,
 switch_status_t object_create_with_attrs(
     const switch_object_id_t object_id,
     std::vector<value_wrapper> &object_attrs) {
-  std::lock_guard<std::recursive_mutex> guard(db_mtx);
+  db_shard &shard = shard_get(object_id);
+  shard_guard guard(shard, true);
 
   // this creates an entry and returns the reference
-  attribute_map *attr_map = &(*object_attr_hash)[object_id];
+  attribute_map *attr_map = &shard.objects[object_id];
 
-  switch_attribute_value_t value_in = {};
-  object_attrs.emplace_back(
-      SPECIAL_OBJECT_STATUS_ATTR_ID, static_cast<uint64_t>(0), value_in);
-
-  attr_map->second = std::move(object_attrs);
+  attr_map->object_type = switch_store::object_type_query(object_id);
+  attr_map->slots.assign(attr_slot_count(attr_map->object_type),
+                         switch_attribute_t{});
+  for (const auto &attr : object_attrs) {
+    attr_store(*attr_map, attr.get_attr_id(), attr.extra, attr.get_value());
+  }
 
   return SWITCH_STATUS_SUCCESS;
 }
 
-inline attribute_wrapper::iterator find_value_wrapper(
-    attribute_map *attr_map,
-    const switch_attr_id_t attr_id,
-    const uint16_t extra) {
-  return std::find_if(attr_map->second.begin(),
-                      attr_map->second.end(),
-                      [&](value_wrapper const &object) {
-                        return (object.attr_id == attr_id) &&
-                               (object.extra == extra);
-                      });
-}
+/*
+ * attr_map comes straight from object_create and the object id has not been
+ * handed out yet, so no other thread can reach this entry and no shard lock
+ * is needed. The attribute list is never resized here.
+ */
 switch_status_t value_create(attribute_map *attr_map,
                              const switch_attr_id_t attr_id,
                              const uint64_t extra,
                              const switch_attribute_value_t &value_in) {
-  std::lock_guard<std::recursive_mutex> guard(db_mtx);
-  auto ret = find_value_wrapper(attr_map, attr_id, extra);
-  if (ret != attr_map->second.end())
-    ret->set_value(value_in);
+  switch_attribute_t *attr = attr_find(*attr_map, attr_id, extra);
+  if (attr != nullptr)
+    attr->value = value_in;
   else
     return SWITCH_STATUS_FAILURE;
 
@@ -840,10 +1337,11 @@ switch_status_t value_create(attribute_map *attr_map,
 switch_status_t value_delete(const switch_object_id_t object_id,
                              const switch_attr_id_t attr_id,
                              const uint64_t extra) {
-  std::lock_guard<std::recursive_mutex> guard(db_mtx);
-  auto it = object_attr_hash->find(object_id);
+  db_shard &shard = shard_get(object_id);
+  shard_guard guard(shard, true);
+  auto it = shard.objects.find(object_id);
 
-  if (it == object_attr_hash->end()) {
+  if (it == shard.objects.end()) {
     switch_log(SWITCH_API_LEVEL_ERROR,
                switch_store::object_type_query(object_id),
                SMI_DELETE_OPERATION,
@@ -852,8 +1350,19 @@ switch_status_t value_delete(const switch_object_id_t object_id,
     return SWITCH_STATUS_ITEM_NOT_FOUND;
   }
 
-  auto ret = find_value_wrapper(&it->second, attr_id, extra);
-  if (ret != it->second.second.end()) it->second.second.erase(ret);
+  attribute_map &attr_map = it->second;
+  const uint16_t slot = attr_slot_get(attr_map.object_type, attr_id);
+  if (extra == 0 && slot < attr_map.slots.size()) {
+    attr_map.slots[slot] = switch_attribute_t{};
+    return SWITCH_STATUS_SUCCESS;
+  }
+  auto ret = std::find_if(attr_map.list_values.begin(),
+                          attr_map.list_values.end(),
+                          [&](value_wrapper const &object) {
+                            return (object.get_attr_id() == attr_id) &&
+                                   (object.extra == extra);
+                          });
+  if (ret != attr_map.list_values.end()) attr_map.list_values.erase(ret);
 
   return SWITCH_STATUS_SUCCESS;
 }
@@ -861,10 +1370,11 @@ switch_status_t value_set(const switch_object_id_t object_id,
                           const switch_attr_id_t attr_id,
                           const uint64_t extra,
                           const switch_attribute_value_t &value_in) {
-  std::lock_guard<std::recursive_mutex> guard(db_mtx);
-  auto it = object_attr_hash->find(object_id);
+  db_shard &shard = shard_get(object_id);
+  shard_guard guard(shard, true);
+  auto it = shard.objects.find(object_id);
 
-  if (it == object_attr_hash->end()) {
+  if (it == shard.objects.end()) {
     switch_log(SWITCH_API_LEVEL_ERROR,
                switch_store::object_type_query(object_id),
                SMI_DELETE_OPERATION,
@@ -873,11 +1383,7 @@ switch_status_t value_set(const switch_object_id_t object_id,
     return SWITCH_STATUS_ITEM_NOT_FOUND;
   }
 
-  auto ret = find_value_wrapper(&it->second, attr_id, extra);
-  if (ret != it->second.second.end())
-    ret->set_value(value_in);
-  else
-    it->second.second.push_back(value_wrapper(attr_id, extra, value_in));
+  attr_store(it->second, attr_id, extra, value_in);
   return SWITCH_STATUS_SUCCESS;
 }
 
@@ -885,10 +1391,11 @@ switch_status_t value_get(const switch_object_id_t object_id,
                           const switch_attr_id_t attr_id,
                           const uint64_t extra,
                           switch_attribute_value_t &value_out) {
-  std::lock_guard<std::recursive_mutex> guard(db_mtx);
-  auto it = object_attr_hash->find(object_id);
+  db_shard &shard = shard_get(object_id);
+  shard_guard guard(shard, false);
+  auto it = shard.objects.find(object_id);
 
-  if (it == object_attr_hash->end()) {
+  if (it == shard.objects.end()) {
     switch_log(SWITCH_API_LEVEL_ERROR,
                switch_store::object_type_query(object_id),
                SMI_GET_OPERATION,
@@ -897,10 +1404,9 @@ switch_status_t value_get(const switch_object_id_t object_id,
     return SWITCH_STATUS_ITEM_NOT_FOUND;
   }
 
-  auto ret = find_value_wrapper(&it->second, attr_id, extra);
-  if (ret != it->second.second.end()) {
-    const switch_attribute_value_t &value = ret->get_value();
-    value_out = value;
+  const switch_attribute_t *attr = attr_find(it->second, attr_id, extra);
+  if (attr != nullptr) {
+    value_out = attr->value;
     return SWITCH_STATUS_SUCCESS;
   } else {
     return SWITCH_STATUS_ITEM_NOT_FOUND;
@@ -910,10 +1416,11 @@ switch_status_t value_get(const switch_object_id_t object_id,
 switch_status_t value_get_all(
     const switch_object_id_t object_id,
     std::vector<std::reference_wrapper<const switch_attribute_t>> &value_out) {
-  std::lock_guard<std::recursive_mutex> guard(db_mtx);
-  auto it = object_attr_hash->find(object_id);
+  db_shard &shard = shard_get(object_id);
+  shard_guard guard(shard, false);
+  auto it = shard.objects.find(object_id);
 
-  if (it == object_attr_hash->end()) {
+  if (it == shard.objects.end()) {
     switch_log(SWITCH_API_LEVEL_ERROR,
                switch_store::object_type_query(object_id),
                SMI_GET_OPERATION,
@@ -922,65 +1429,60 @@ switch_status_t value_get_all(
     return SWITCH_STATUS_ITEM_NOT_FOUND;
   }
 
-  std::for_each(it->second.second.begin(),
-                it->second.second.end(),
-                [&value_out](value_wrapper &n) {
-                  if (n.attr_id != SPECIAL_OBJECT_STATUS_ATTR_ID)
-                    value_out.push_back(n.get());
-                });
+  for (const auto &attr : it->second.slots) {
+    if (attr.id != 0) value_out.push_back(attr);
+  }
+  for (const auto &n : it->second.list_values) value_out.push_back(n.get());
   return SWITCH_STATUS_SUCCESS;
 }
 
-void switch_store_lock(void) { db_mtx.lock(); }
+/*
+ * Take every shard exclusively, always in the same order. The lock is
+ * recursive per thread, nested calls only bump the depth.
+ */
+void switch_store_lock(void) {
+  if (store_lock_depth++ != 0) return;
+  for (auto &shard : *object_attr_hash) shard.mtx.lock();
+}
 
-void switch_store_unlock(void) { db_mtx.unlock(); }
+void switch_store_unlock(void) {
+  if (--store_lock_depth != 0) return;
+  for (auto it = object_attr_hash->rbegin(); it != object_attr_hash->rend();
+       it++) {
+    it->mtx.unlock();
+  }
+}
 
 int object_lock(const switch_object_id_t object_id) {
   pthread_t tid = pthread_self();
   bool locked = false;
+  db_shard &shard = shard_get(object_id);
   while (!locked) {
-    db_mtx.lock();
-    auto it = object_attr_hash->find(object_id);
-    if (it != object_attr_hash->end()) {
-      auto ret = find_value_wrapper(
-          &it->second,
-          static_cast<switch_attr_id_t>(SPECIAL_OBJECT_STATUS_ATTR_ID),
-          static_cast<uint64_t>(0));
-      if (ret != it->second.second.end()) {
-        switch_attribute_value_t &value = ret->get_value_mutable();
-        if (value.u64 != 0 && !pthread_equal(tid, ret->lock_tid)) {
-          db_mtx.unlock();
-          usleep(100);
-          continue;
-        } else {
-          ret->lock_tid = tid;
-          ++value.u64;
-          locked = true;
-        }
+    {
+      shard_guard guard(shard, true);
+      auto it = shard.objects.find(object_id);
+      if (it == shard.objects.end()) return 0;
+      attribute_map &attr_map = it->second;
+      if (attr_map.lock_count == 0 || pthread_equal(tid, attr_map.lock_tid)) {
+        attr_map.lock_tid = tid;
+        ++attr_map.lock_count;
+        locked = true;
       }
-    } else {
-      db_mtx.unlock();
-      return 0;
     }
-    db_mtx.unlock();
+    if (!locked) usleep(100);
   }
   return -1;
 }
 
 void object_unlock(const switch_object_id_t object_id) {
-  std::lock_guard<std::recursive_mutex> guard(db_mtx);
-  auto it = object_attr_hash->find(object_id);
-  if (it != object_attr_hash->end()) {
-    auto ret = find_value_wrapper(
-        &it->second,
-        static_cast<switch_attr_id_t>(SPECIAL_OBJECT_STATUS_ATTR_ID),
-        static_cast<uint64_t>(0));
-    if (ret != it->second.second.end()) {
-      pthread_t tid = pthread_self();
-      switch_attribute_value_t &value = ret->get_value_mutable();
-      if (value.u64 != 0 && pthread_equal(tid, ret->lock_tid)) {
-        --value.u64;
-      }
+  db_shard &shard = shard_get(object_id);
+  shard_guard guard(shard, true);
+  auto it = shard.objects.find(object_id);
+  if (it != shard.objects.end()) {
+    pthread_t tid = pthread_self();
+    attribute_map &attr_map = it->second;
+    if (attr_map.lock_count != 0 && pthread_equal(tid, attr_map.lock_tid)) {
+      --attr_map.lock_count;
     }
   }
 }
@@ -22,6 +22,7 @@
 #define S3_STORE_H__
 
 #include <mutex>  // NOLINT(build/c++11)
+#include <shared_mutex>
 #include <unordered_map>
 #include <map>
 #include <unordered_set>
@@ -31,6 +32,7 @@
 #include <utility>
 #include <vector>
 #include <algorithm>
+#include <array>
 #include <functional>
 
 #include "bf_switch/bf_switch_types.h"
@@ -69,43 +71,46 @@ class secondaryIndex {
                              secondaryIndexKeyHasher>
       secIndex;
   std::vector<secIndex> si;
-  std::mutex mtx;
-  typedef std::lock_guard<std::mutex> LOCK_GUARD;
+  /* one lock per object type, lookups only take it shared */
+  std::vector<std::shared_mutex> mtx;
+  typedef std::shared_lock<std::shared_mutex> READ_GUARD;
+  typedef std::unique_lock<std::shared_mutex> WRITE_GUARD;
 
  public:
-  secondaryIndex(size_t object_count) {
-    si = std::vector<secIndex>(object_count);
+  secondaryIndex(size_t object_count) : si(object_count), mtx(object_count) {
     for (auto &secondary_index : si) {
       secondary_index.reserve(512);
     }
   }
 
   void clear() {
-    LOCK_GUARD guard(mtx);
+    for (auto &lock : mtx) lock.lock();
     si.clear();
+    for (auto &lock : mtx) lock.unlock();
     return;
   }
 
   inline std::pair<secIndex::iterator, bool> insert(
       const std::vector<attr_w> &key, switch_object_id_t oid) {
-    LOCK_GUARD guard(mtx);
-    return si[oid.data >> OBJECT_ID_WIDTH].emplace(
+    const size_t ot = oid.data >> OBJECT_ID_WIDTH;
+    WRITE_GUARD guard(mtx[ot]);
+    return si[ot].emplace(
         std::piecewise_construct, std::make_tuple(key), std::make_tuple(oid));
   }
 
   inline size_t erase(switch_object_type_t ot, const std::vector<attr_w> &key) {
-    LOCK_GUARD guard(mtx);
+    WRITE_GUARD guard(mtx[ot]);
     return si[ot].erase(key);
   }
 
   inline secIndex::iterator find(switch_object_type_t ot,
                                  const std::vector<attr_w> &key) {
-    LOCK_GUARD guard(mtx);
+    READ_GUARD guard(mtx[ot]);
     return si[ot].find(key);
   }
 
   inline secIndex::iterator end(switch_object_type_t ot) {
-    LOCK_GUARD guard(mtx);
+    READ_GUARD guard(mtx[ot]);
     return si[ot].end();
   }
 };
@@ -134,16 +139,19 @@ class objectGraph {
       objRefs;
   typedef std::unordered_map<uint64_t, objRefs> graph;
   std::vector<graph> refs;
-  std::mutex mtx;
-  typedef std::lock_guard<std::mutex> LOCK_GUARD;
+  /* one lock per referenced object type, lookups only take it shared */
+  std::vector<std::shared_mutex> mtx;
+  typedef std::shared_lock<std::shared_mutex> READ_GUARD;
+  typedef std::unique_lock<std::shared_mutex> WRITE_GUARD;
 
  public:
-  objectGraph(size_t object_count) { refs = std::vector<graph>(object_count); }
+  objectGraph(size_t object_count) : refs(object_count), mtx(object_count) {}
 
   const std::vector<object_and_attribute_t> &getRefs(
       const switch_object_id_t &dst, const switch_object_type_t src_type) {
-    LOCK_GUARD guard(mtx);
-    graph &ref = refs[dst.data >> OBJECT_ID_WIDTH];
+    const size_t ot = dst.data >> OBJECT_ID_WIDTH;
+    READ_GUARD guard(mtx[ot]);
+    graph &ref = refs[ot];
     auto it = ref.find(dst.data);
     if (it != ref.end()) {
       auto it2 = it->second.find(src_type);
@@ -155,8 +163,9 @@ class objectGraph {
   }
 
   void clear() {
-    LOCK_GUARD guard(mtx);
+    for (auto &lock : mtx) lock.lock();
     refs.clear();
+    for (auto &lock : mtx) lock.unlock();
     return;
   }
 
@@ -164,9 +173,10 @@ class objectGraph {
               switch_object_type_t src_type,
               const switch_object_id_t &src,
               switch_attr_id_t src_attr_id) {
-    LOCK_GUARD guard(mtx);
+    const size_t ot = dst.data >> OBJECT_ID_WIDTH;
+    WRITE_GUARD guard(mtx[ot]);
 
-    refs[dst.data >> OBJECT_ID_WIDTH][dst.data][src_type].emplace_back(
+    refs[ot][dst.data][src_type].emplace_back(
         src, src_attr_id);
     return true;
   }
@@ -175,9 +185,10 @@ class objectGraph {
   size_t erase(const switch_object_id_t &dst,
                const switch_object_type_t src_type,
                const switch_object_id_t &src) {
-    LOCK_GUARD guard(mtx);
+    const size_t ot = dst.data >> OBJECT_ID_WIDTH;
+    WRITE_GUARD guard(mtx[ot]);
 
-    auto &ref = refs[dst.data >> OBJECT_ID_WIDTH][dst.data][src_type];
+    auto &ref = refs[ot][dst.data][src_type];
     size_t num = 1;
 
     ref.erase(std::remove_if(ref.begin(),
@@ -196,9 +207,10 @@ class objectGraph {
                const switch_object_type_t src_type,
                const switch_object_id_t &src,
                const switch_attr_id_t src_attr_id) {
-    LOCK_GUARD guard(mtx);
+    const size_t ot = dst.data >> OBJECT_ID_WIDTH;
+    WRITE_GUARD guard(mtx[ot]);
 
-    auto &ref = refs[dst.data >> OBJECT_ID_WIDTH][dst.data][src_type];
+    auto &ref = refs[ot][dst.data][src_type];
     size_t num = 1;
 
     ref.erase(std::remove_if(ref.begin(),
@@ -212,12 +224,14 @@ class objectGraph {
   }
 
   const graph::iterator find(const switch_object_id_t &oid) {
-    LOCK_GUARD guard(mtx);
-    return refs[oid.data >> OBJECT_ID_WIDTH].find(oid.data);
+    const size_t ot = oid.data >> OBJECT_ID_WIDTH;
+    READ_GUARD guard(mtx[ot]);
+    return refs[ot].find(oid.data);
   }
   const graph::iterator end(const switch_object_id_t &oid) {
-    LOCK_GUARD guard(mtx);
-    return refs[oid.data >> OBJECT_ID_WIDTH].end();
+    const size_t ot = oid.data >> OBJECT_ID_WIDTH;
+    READ_GUARD guard(mtx[ot]);
+    return refs[ot].end();
   }
 };
 
@@ -234,22 +248,20 @@ typedef struct _value_key_t {
 
 class value_wrapper {
  public:
-  /* locking thread; the value is only valid if lock counter > 0 */
-  pthread_t lock_tid{};
-  switch_attr_id_t attr_id = 0;
   uint16_t extra = 0;
   /*  only stores base-type values, doesn't own any extra memory */
   value_wrapper(const switch_attr_id_t &_attr_id,
                 uint16_t _extra,
                 const switch_attribute_value_t &value) {
-    attr_id = _attr_id;
     extra = _extra;
     m_value.id = _attr_id;
     m_value.value = value;
   }
   ~value_wrapper() {}
 
+  inline switch_attr_id_t get_attr_id() const { return m_value.id; }
   inline const switch_attribute_t &get() const { return m_value; }
+  inline switch_attribute_t &get_mutable() { return m_value; }
   inline void set_value(const switch_attribute_value_t &value) {
     m_value.value = value;
   }
@@ -258,43 +270,62 @@ class value_wrapper {
   }
   inline switch_attribute_value_t &get_value_mutable() { return m_value.value; }
   inline bool operator()(const value_wrapper &other) const {
-    return (attr_id == other.attr_id && extra == other.extra);
+    return (m_value.id == other.m_value.id && extra == other.extra);
   }
 
  private:
   switch_attribute_t m_value;
 };
 
-struct KeyHasher {
-  std::size_t operator()(const value_key_t &k) const {
-    using std::size_t;
-    using std::hash;
-
-    return ((hash<uint16_t>()(k.attr_id) ^ (hash<uint16_t>()(k.extra) << 1)) >>
-            1);
-  }
-};
-
-// Use this to maintain object status, created, deleted, deleting, etc
-#define SPECIAL_OBJECT_STATUS_ATTR_ID 0xFFFF
-
 /*
  *  Value keys would look something like: ObjectID.AttributeID.Extra
  *  Where extra would be used for list indices, key hashes, etc.
- *  object delete is essentially delete of range of values,
- *  if we were to use a single layer map.
  *
+ *  Every attribute declared in the schema for the object type gets a fixed
+ *  slot, in schema order, and is reached by indexing the per type offset
+ *  table built from the model at db_load. A slot with id 0 holds no value.
+ *  Only list members (extra != 0) and attributes outside the schema are
+ *  stored out of line in list_values.
  */
 typedef std::vector<value_wrapper> attribute_wrapper;
-typedef std::pair<uint64_t, attribute_wrapper> attribute_map;
+struct attribute_map {
+  /* number of times this object was written out by db_dump */
+  uint64_t dump_count = 0;
+  /* locking thread; only valid if lock_count > 0 */
+  pthread_t lock_tid{};
+  uint32_t lock_count = 0;
+  switch_object_type_t object_type = 0;
+  std::vector<switch_attribute_t> slots;
+  attribute_wrapper list_values;
+};
 typedef std::unordered_map<switch_object_id_t, attribute_map> db_store;
 
-const db_store *get_db();
+/*
+ * The primary store is split in shards by object id hash, each one guarded
+ * by its own reader/writer lock, so that unrelated objects never contend and
+ * lookups never block each other.
+ */
+#define DB_STORE_SHARDS 64
+struct db_shard {
+  std::shared_mutex mtx;
+  db_store objects;
+};
+typedef std::array<db_shard, DB_STORE_SHARDS> db_shards;
+
+const db_shards *get_db();
+/* Snapshot of all object ids currently in the store */
+std::vector<switch_object_id_t> get_object_ids();
 switch_status_t db_load(bool warm_init, const char *const warm_init_file);
 switch_status_t db_clear();
 #if 0
 switch_status_t db_print(bool stats_cache_only);
 #endif
+/*
+ * Writes the text dump to dump_file and a binary snapshot of the same state
+ * to dump_file DB_SNAPSHOT_SUFFIX. db_load prefers the snapshot when it
+ * matches the running model.
+ */
+#define DB_SNAPSHOT_SUFFIX ".snap"
 switch_status_t db_dump(const char *const dump_file);
 const std::vector<switch_object_id_t> &get_creation_list();
 
@@ -18,12 +18,39 @@
  ******************************************************************************/
 
 
-#include <target-utils/third-party/judy-1.0.5/src/Judy.h>
 #include <assert.h>
 
 /* Local header includes */
 #include "switch_lpm_int.h"
 
+#define SWITCH_TRIE_FANOUT 256
+#define SWITCH_TRIE_MAX_DEPTH 64
+
+static inline bool switch_trie_bit_get(const uint64_t *bits, byte_t byte) {
+  return (bits[byte >> 6] >> (byte & 63)) & 1;
+}
+
+static inline void switch_trie_bit_set(uint64_t *bits, byte_t byte) {
+  bits[byte >> 6] |= 1ULL << (byte & 63);
+}
+
+static inline void switch_trie_bit_clear(uint64_t *bits, byte_t byte) {
+  bits[byte >> 6] &= ~(1ULL << (byte & 63));
+}
+
+/* Number of bits set below byte. */
+static inline unsigned switch_trie_bit_rank(const uint64_t *bits, byte_t byte) {
+  unsigned word = byte >> 6, rank = 0, i;
+  for (i = 0; i < word; i++) rank += __builtin_popcountll(bits[i]);
+  uint64_t mask = (1ULL << (byte & 63)) - 1;
+  return rank + __builtin_popcountll(bits[word] & mask);
+}
+
+static inline unsigned switch_trie_bit_count(const uint64_t *bits) {
+  return __builtin_popcountll(bits[0]) + __builtin_popcountll(bits[1]) +
+         __builtin_popcountll(bits[2]) + __builtin_popcountll(bits[3]);
+}
+
 static inline switch_status_t switch_trie_node_allocate(
     switch_trie_node_t **node) {
   switch_status_t status = SWITCH_STATUS_SUCCESS;
@@ -42,7 +69,7 @@ switch_status_t switch_lpm_trie_create(size_t key_width_bytes,
                                        bool auto_shrink,
                                        switch_lpm_trie_t **trie) {
   switch_status_t status = SWITCH_STATUS_SUCCESS;
-  assert(key_width_bytes <= 64);
+  assert(key_width_bytes <= SWITCH_TRIE_MAX_DEPTH);
 
   *trie = malloc(sizeof(switch_lpm_trie_t));
   if (!(*trie)) {
@@ -70,21 +97,16 @@ size_t switch_lpm_trie_size(switch_lpm_trie_t *trie) {
 }
 
 switch_status_t switch_trie_node_destroy(switch_trie_node_t *node) {
-  Word_t index = 0;
-  Word_t *pnode = NULL;
-  Word_t rc_word;
+  unsigned i, num_children = switch_trie_bit_count(node->child_bits);
   switch_status_t status = SWITCH_STATUS_SUCCESS;
 
-  JLF(pnode, node->PJLarray_branches, index);
-  while (pnode != NULL) {
-    status = switch_trie_node_destroy(((switch_trie_node_t *)*pnode));
-    JLN(pnode, node->PJLarray_branches, index);
+  for (i = 0; i < num_children; i++) {
+    status = switch_trie_node_destroy(node->children[i]);
   }
 
-  JLFA(rc_word, node->PJLarray_branches);
-  (void)rc_word;
-  JLFA(rc_word, node->PJLarray_prefixes);
-  (void)rc_word;
+  free(node->children);
+  free(node->leaves);
+  free(node->prefixes);
   free(node);
 
   return status;
@@ -102,26 +124,48 @@ switch_status_t switch_lpm_trie_destroy(switch_lpm_trie_t *trie) {
 
 static inline switch_trie_node_t *switch_trie_next_node_get(
     const switch_trie_node_t *current_node, byte_t byte) {
-  Word_t *pnode = NULL;
-  JLG(pnode, current_node->PJLarray_branches, (Word_t)byte);
-  if (!pnode) return NULL;
-  return (switch_trie_node_t *)*pnode;
+  if (!switch_trie_bit_get(current_node->child_bits, byte)) return NULL;
+  return current_node->children[switch_trie_bit_rank(current_node->child_bits,
+                                                     byte)];
 }
 
-static inline void switch_trie_next_node_set(switch_trie_node_t *current_node,
-                                             byte_t byte,
-                                             switch_trie_node_t *next_node) {
-  Word_t *pnode = NULL;
-  JLI(pnode, current_node->PJLarray_branches, (Word_t)byte);
-  *pnode = (Word_t)next_node;
-  return;
+/* The children array grows by powers of two, it is full when the number of
+ * children is zero or a power of two. */
+static inline switch_status_t switch_trie_next_node_set(
+    switch_trie_node_t *current_node,
+    byte_t byte,
+    switch_trie_node_t *next_node) {
+  unsigned num_children = switch_trie_bit_count(current_node->child_bits);
+  unsigned rank = switch_trie_bit_rank(current_node->child_bits, byte);
+
+  if ((num_children & (num_children - 1)) == 0) {
+    unsigned capacity = num_children ? num_children * 2 : 1;
+    switch_trie_node_t **children =
+        realloc(current_node->children, capacity * sizeof(*children));
+    if (!children) return SWITCH_STATUS_NO_MEMORY;
+    current_node->children = children;
+  }
+  memmove(&current_node->children[rank + 1],
+          &current_node->children[rank],
+          (num_children - rank) * sizeof(*current_node->children));
+  current_node->children[rank] = next_node;
+  switch_trie_bit_set(current_node->child_bits, byte);
+  return SWITCH_STATUS_SUCCESS;
 }
 
-static inline int switch_trie_branch_delete(switch_trie_node_t *current_node,
-                                            byte_t byte) {
-  int rc;
-  JLD(rc, current_node->PJLarray_branches, (Word_t)byte);
-  return rc;
+static inline void switch_trie_branch_delete(switch_trie_node_t *current_node,
+                                             byte_t byte) {
+  unsigned num_children = switch_trie_bit_count(current_node->child_bits);
+  unsigned rank = switch_trie_bit_rank(current_node->child_bits, byte);
+
+  memmove(&current_node->children[rank],
+          &current_node->children[rank + 1],
+          (num_children - rank - 1) * sizeof(*current_node->children));
+  switch_trie_bit_clear(current_node->child_bits, byte);
+  if (num_children == 1) {
+    free(current_node->children);
+    current_node->children = NULL;
+  }
 }
 
 static inline uint16_t switch_trie_prefix_key_get(uint32_t prefix_length,
@@ -130,51 +174,160 @@ static inline uint16_t switch_trie_prefix_key_get(uint32_t prefix_length,
                        : 0;
 }
 
-static inline int switch_trie_prefix_insert(switch_trie_node_t *current_node,
-                                            uint16_t prefix_key,
-                                            const value_t value) {
-  Word_t *pvalue;
-  int rc;
-  JLI(pvalue, current_node->PJLarray_prefixes, (Word_t)prefix_key);
-  rc = (*pvalue) ? 1 : 0;
-  *pvalue = (Word_t)value;
-  return rc;
+/* Rebuild the run length encoded leaves of a node from its prefixes. */
+static switch_status_t switch_trie_leaves_build(
+    switch_trie_node_t *current_node) {
+  const value_t *slots[SWITCH_TRIE_FANOUT] = {NULL};
+  uint8_t slot_len[SWITCH_TRIE_FANOUT] = {0};
+  switch_trie_leaves_t *leaves;
+  unsigned i, slot, num_leaves = 0;
+
+  current_node->dirty = false;
+  free(current_node->leaves);
+  current_node->leaves = NULL;
+  if (current_node->pref_num == 0) return SWITCH_STATUS_SUCCESS;
+
+  for (i = 0; i < current_node->pref_num; i++) {
+    const switch_trie_prefix_t *prefix = &current_node->prefixes[i];
+    unsigned length = prefix->prefix_key >> 8;
+    unsigned first = (prefix->prefix_key & 0xFF) << (8 - length);
+    for (slot = first; slot < first + (1U << (8 - length)); slot++) {
+      if (slot_len[slot] < length) {
+        slot_len[slot] = length;
+        slots[slot] = &prefix->value;
+      }
+    }
+  }
+
+  for (slot = 0; slot < SWITCH_TRIE_FANOUT; slot++) {
+    if (slot == 0 || slots[slot] != slots[slot - 1]) num_leaves++;
+  }
+  leaves = malloc(sizeof(*leaves) + num_leaves * sizeof(leaves->leaves[0]));
+  if (!leaves) return SWITCH_STATUS_NO_MEMORY;
+  memset(leaves->leaf_bits, 0, sizeof(leaves->leaf_bits));
+  num_leaves = 0;
+  for (slot = 0; slot < SWITCH_TRIE_FANOUT; slot++) {
+    if (slot == 0 || slots[slot] != slots[slot - 1]) {
+      switch_trie_bit_set(leaves->leaf_bits, (byte_t)slot);
+      leaves->leaves[num_leaves++] = slots[slot];
+    }
+  }
+  current_node->leaves = leaves;
+  return SWITCH_STATUS_SUCCESS;
+}
+
+/* Longest match among the prefixes of 1 to 7 bits of a node. */
+static inline const value_t *switch_trie_leaf_get(
+    const switch_trie_node_t *current_node, byte_t byte) {
+  const switch_trie_leaves_t *leaves = current_node->leaves;
+  if (!leaves) return NULL;
+  /* Runs start at the bits set, byte belongs to the last one at or below. */
+  unsigned run = switch_trie_bit_rank(leaves->leaf_bits, byte) +
+                 switch_trie_bit_get(leaves->leaf_bits, byte) - 1;
+  return leaves->leaves[run];
 }
 
-static inline value_t *switch_trie_prefix_ptr_get(
+static inline switch_trie_prefix_t *switch_trie_prefix_ptr_get(
     const switch_trie_node_t *current_node, uint16_t prefix_key) {
-  Word_t *pvalue = NULL;
-  JLG(pvalue, current_node->PJLarray_prefixes, (Word_t)prefix_key);
-  return (value_t *)pvalue;
+  unsigned i;
+  for (i = 0; i < current_node->pref_num; i++) {
+    if (current_node->prefixes[i].prefix_key == prefix_key)
+      return &current_node->prefixes[i];
+  }
+  return NULL;
+}
+
+/*
+ * Returns 1 if the prefix was replaced, 0 if it was added. Pointers into the
+ * prefixes array do not survive an addition so the leaves are rebuilt, or
+ * marked dirty when the caller rebuilds them later.
+ */
+static inline int switch_trie_prefix_insert(switch_trie_node_t *current_node,
+                                            uint16_t prefix_key,
+                                            const value_t value,
+                                            bool defer_build,
+                                            switch_status_t *status) {
+  switch_trie_prefix_t *prefix;
+
+  if (prefix_key == 0) {
+    int rc = current_node->has_value ? 1 : 0;
+    current_node->value = value;
+    current_node->has_value = true;
+    return rc;
+  }
+
+  prefix = switch_trie_prefix_ptr_get(current_node, prefix_key);
+  if (prefix) {
+    prefix->value = value;
+    return 1;
+  }
+
+  prefix = realloc(current_node->prefixes,
+                   (current_node->pref_num + 1) * sizeof(*prefix));
+  if (!prefix) {
+    *status = SWITCH_STATUS_NO_MEMORY;
+    return 0;
+  }
+  current_node->prefixes = prefix;
+  current_node->prefixes[current_node->pref_num].prefix_key = prefix_key;
+  current_node->prefixes[current_node->pref_num].value = value;
+  current_node->pref_num++;
+  current_node->dirty = true;
+  if (!defer_build) *status = switch_trie_leaves_build(current_node);
+  return 0;
 }
 
-static inline int32_t switch_trie_prefix_delete(
+static inline switch_status_t switch_trie_prefix_delete(
     switch_trie_node_t *current_node, uint16_t prefix_key) {
-  int rc = 0;
-  JLD(rc, current_node->PJLarray_prefixes, (Word_t)prefix_key);
-  return rc;
+  switch_trie_prefix_t *prefix;
+
+  if (prefix_key == 0) {
+    if (!current_node->has_value) return SWITCH_STATUS_FAILURE;
+    current_node->has_value = false;
+    current_node->value = 0;
+    return SWITCH_STATUS_SUCCESS;
+  }
+
+  prefix = switch_trie_prefix_ptr_get(current_node, prefix_key);
+  if (!prefix) return SWITCH_STATUS_FAILURE;
+  *prefix = current_node->prefixes[--current_node->pref_num];
+  if (current_node->pref_num == 0) {
+    free(current_node->prefixes);
+    current_node->prefixes = NULL;
+  }
+  return switch_trie_leaves_build(current_node);
 }
 
-switch_status_t switch_lpm_trie_insert(switch_lpm_trie_t *trie,
-                                       const uint8_t *prefix,
-                                       size_t prefix_length,
-                                       const value_t value) {
+static inline bool switch_trie_node_empty(
+    const switch_trie_node_t *current_node) {
+  return !current_node->has_value && current_node->pref_num == 0 &&
+         switch_trie_bit_count(current_node->child_bits) == 0;
+}
+
+static switch_status_t switch_trie_insert(switch_lpm_trie_t *trie,
+                                          const uint8_t *prefix,
+                                          size_t prefix_length,
+                                          const value_t value,
+                                          bool defer_build) {
   switch_trie_node_t *current_node = trie->root;
   byte_t byte = 0;
   uint16_t prefix_key = 0;
   switch_status_t status = SWITCH_STATUS_SUCCESS;
 
+  if (prefix_length > trie->key_width_bytes * 8) {
+    return SWITCH_STATUS_INVALID_PARAMETER;
+  }
+
   while (prefix_length >= 8) {
     byte = (byte_t)*prefix;
     switch_trie_node_t *node = switch_trie_next_node_get(current_node, byte);
     if (!node) {
       status = switch_trie_node_allocate(&node);
-      if (node) {
-        node->parent = current_node;
-        node->child_id = byte;
-        switch_trie_next_node_set(current_node, byte, node);
-        current_node->branch_num++;
-      } else {
+      if (status == SWITCH_STATUS_SUCCESS) {
+        status = switch_trie_next_node_set(current_node, byte, node);
+        if (status != SWITCH_STATUS_SUCCESS) free(node);
+      }
+      if (status != SWITCH_STATUS_SUCCESS) {
         assert(status == SWITCH_STATUS_SUCCESS);
         return status;
       }
@@ -190,13 +343,54 @@ switch_status_t switch_lpm_trie_insert(switch_lpm_trie_t *trie,
         switch_trie_prefix_key_get((unsigned)prefix_length, (byte_t)*prefix);
   }
 
-  if (!switch_trie_prefix_insert(current_node, prefix_key, value))
-    current_node->pref_num++;
+  if (!switch_trie_prefix_insert(
+          current_node, prefix_key, value, defer_build, &status)) {
+    if (status != SWITCH_STATUS_SUCCESS) return status;
+    trie->num_entries++;
+  }
+  return status;
+}
+
+switch_status_t switch_lpm_trie_insert(switch_lpm_trie_t *trie,
+                                       const uint8_t *prefix,
+                                       size_t prefix_length,
+                                       const value_t value) {
+  return switch_trie_insert(trie, prefix, prefix_length, value, false);
+}
+
+static switch_status_t switch_trie_dirty_leaves_build(
+    switch_trie_node_t *current_node) {
+  unsigned i, num_children = switch_trie_bit_count(current_node->child_bits);
+  switch_status_t status = SWITCH_STATUS_SUCCESS;
 
-  trie->num_entries++;
+  if (current_node->dirty) status = switch_trie_leaves_build(current_node);
+  for (i = 0; i < num_children && status == SWITCH_STATUS_SUCCESS; i++) {
+    status = switch_trie_dirty_leaves_build(current_node->children[i]);
+  }
   return status;
 }
 
+switch_status_t switch_lpm_trie_bulk_insert(
+    switch_lpm_trie_t *trie,
+    const switch_lpm_trie_entry_t *entries,
+    size_t num_entries) {
+  switch_status_t status = SWITCH_STATUS_SUCCESS;
+  size_t i;
+
+  for (i = 0; i < num_entries && status == SWITCH_STATUS_SUCCESS; i++) {
+    status = switch_trie_insert(trie,
+                                entries[i].prefix,
+                                entries[i].prefix_length,
+                                entries[i].value,
+                                true);
+  }
+
+  /* Leaves of nodes modified before a failure are built as well, the
+   * prefixes inserted so far stay in the trie. */
+  switch_status_t build_status = switch_trie_dirty_leaves_build(trie->root);
+  return status != SWITCH_STATUS_SUCCESS ? status : build_status;
+}
+
 bool switch_lpm_trie_has_prefix(const switch_lpm_trie_t *trie,
                                 const uint8_t *prefix,
                                 size_t prefix_length) {
@@ -216,9 +410,10 @@ bool switch_lpm_trie_has_prefix(const switch_lpm_trie_t *trie,
   if (prefix_length != 0) {
     prefix_key =
         switch_trie_prefix_key_get((unsigned)prefix_length, (byte_t)*prefix);
+    return (switch_trie_prefix_ptr_get(current_node, prefix_key) != NULL);
   }
 
-  return (switch_trie_prefix_ptr_get(current_node, prefix_key) != NULL);
+  return current_node->has_value;
 }
 
 switch_status_t switch_lpm_trie_lookup(const switch_lpm_trie_t *trie,
@@ -226,55 +421,50 @@ switch_status_t switch_lpm_trie_lookup(const switch_lpm_trie_t *trie,
                                        value_t *pvalue) {
   const switch_trie_node_t *current_node = trie->root;
   size_t key_width = trie->key_width_bytes;
+  const value_t *pdata = NULL, *pleaf;
   byte_t byte;
-  value_t *pdata = NULL;
-  uint16_t prefix_key;
-  unsigned i;
-  switch_status_t status = SWITCH_STATUS_ITEM_NOT_FOUND;
 
   while (current_node) {
-    pdata = switch_trie_prefix_ptr_get(current_node, 0);
-    if (pdata) {
-      *pvalue = *pdata;
-      status = SWITCH_STATUS_SUCCESS;
-    }
+    if (current_node->has_value) pdata = &current_node->value;
+    if (key_width == 0) break;
 
-    if (key_width > 0) {
-      byte = (byte_t)*key;
-      for (i = 7; i > 0; i--) {
-        prefix_key = switch_trie_prefix_key_get((unsigned)i, byte);
-        pdata = switch_trie_prefix_ptr_get(current_node, prefix_key);
-        if (pdata) {
-          *pvalue = *pdata;
-          status = SWITCH_STATUS_SUCCESS;
-          break;
-        }
-      }
+    byte = (byte_t)*key;
+    pleaf = switch_trie_leaf_get(current_node, byte);
+    if (pleaf) pdata = pleaf;
 
-      current_node = switch_trie_next_node_get(current_node, byte);
-      key++;
-      key_width--;
-    } else {
-      break;
-    }
+    current_node = switch_trie_next_node_get(current_node, byte);
+    key++;
+    key_width--;
   }
 
-  return status;
+  if (!pdata) return SWITCH_STATUS_ITEM_NOT_FOUND;
+  *pvalue = *pdata;
+  return SWITCH_STATUS_SUCCESS;
 }
 
 switch_status_t switch_lpm_trie_delete(switch_lpm_trie_t *trie,
                                        const uint8_t *prefix,
                                        size_t prefix_length) {
+  switch_trie_node_t *path[SWITCH_TRIE_MAX_DEPTH + 1];
+  byte_t path_bytes[SWITCH_TRIE_MAX_DEPTH];
   switch_trie_node_t *current_node = trie->root;
+  size_t depth = 0;
   byte_t byte = 0;
   uint16_t prefix_key = 0;
-  value_t *pdata = NULL;
+  switch_status_t status;
+
+  if (prefix_length > trie->key_width_bytes * 8) {
+    return SWITCH_STATUS_FAILURE;
+  }
 
+  path[0] = current_node;
   while (prefix_length >= 8) {
     byte = (byte_t)*prefix;
     switch_trie_node_t *node = switch_trie_next_node_get(current_node, byte);
     if (!node) return SWITCH_STATUS_FAILURE;
 
+    path_bytes[depth] = byte;
+    path[++depth] = node;
     prefix++;
     prefix_length -= 8;
     current_node = node;
@@ -285,26 +475,17 @@ switch_status_t switch_lpm_trie_delete(switch_lpm_trie_t *trie,
         switch_trie_prefix_key_get((unsigned)prefix_length, (byte_t)*prefix);
   }
 
-  pdata = switch_trie_prefix_ptr_get(current_node, prefix_key);
-  if (!pdata) return SWITCH_STATUS_FAILURE;
+  status = switch_trie_prefix_delete(current_node, prefix_key);
+  if (status != SWITCH_STATUS_SUCCESS) return status;
+  trie->num_entries--;
 
   if (trie->release_memory) {
-    if (switch_trie_prefix_delete(current_node, prefix_key) != 1) {
-      return SWITCH_STATUS_FAILURE;
-    }
-    current_node->pref_num--;
-    while (current_node->pref_num == 0 && current_node->branch_num == 0) {
-      switch_trie_node_t *tmp_node = current_node;
-      current_node = current_node->parent;
-      if (!current_node) break;
-      if (switch_trie_branch_delete(current_node, tmp_node->child_id) != 1) {
-        return SWITCH_STATUS_FAILURE;
-      }
-      free(tmp_node);
-      current_node->branch_num--;
+    while (depth > 0 && switch_trie_node_empty(path[depth])) {
+      switch_trie_branch_delete(path[depth - 1], path_bytes[depth - 1]);
+      switch_trie_node_destroy(path[depth]);
+      depth--;
     }
   }
 
-  trie->num_entries--;
   return SWITCH_STATUS_SUCCESS;
 }
@@ -25,21 +25,45 @@
 extern "C" {
 #endif
 
-#include <target-utils/third-party/judy-1.0.5/src/Judy.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include "./log.h"
 
 typedef unsigned char byte_t;
 typedef uint64_t value_t;
 
+/*
+ * The trie consumes one key byte per level. Each node keeps a 256 bit bitmap
+ * of the bytes with a child node, the children are stored in byte order so
+ * the child of a byte is found by counting the bits below it. The prefixes of
+ * 1 to 7 bits stored in a node are expanded into a leaf vector: leaf_bits
+ * marks the first byte of each run of bytes sharing the same longest match,
+ * the match of a byte is the leaf of the run it belongs to. A lookup
+ * therefore costs two popcounts per byte instead of a search per prefix
+ * length. Prefixes ending on a byte boundary are the node value. The
+ * prefixes array is the mutable side of the node from which the leaf vector
+ * is rebuilt when the node changes.
+ */
+typedef struct switch_trie_prefix_s {
+  uint16_t prefix_key;
+  value_t value;
+} switch_trie_prefix_t;
+
+typedef struct switch_trie_leaves_s {
+  uint64_t leaf_bits[4];
+  const value_t *leaves[];
+} switch_trie_leaves_t;
+
 typedef struct switch_trie_node_s {
-  Pvoid_t PJLarray_branches;
-  Pvoid_t PJLarray_prefixes;
-  unsigned char branch_num;
-  unsigned char pref_num;
-  struct switch_trie_node_s *parent;
-  byte_t child_id;
+  uint64_t child_bits[4];
+  struct switch_trie_node_s **children;
+  switch_trie_leaves_t *leaves;
+  switch_trie_prefix_t *prefixes;
+  value_t value;
+  bool has_value;
+  bool dirty;
+  uint16_t pref_num;
 } switch_trie_node_t;
 
 typedef struct switch_lpm_trie_s {
@@ -49,6 +73,12 @@ typedef struct switch_lpm_trie_s {
   unsigned int num_entries;
 } switch_lpm_trie_t;
 
+typedef struct switch_lpm_trie_entry_s {
+  const uint8_t *prefix;
+  size_t prefix_length;
+  value_t value;
+} switch_lpm_trie_entry_t;
+
 switch_status_t switch_lpm_trie_create(size_t key_width_bytes,
                                        bool auto_shrink,
                                        switch_lpm_trie_t **trie);
@@ -70,6 +100,15 @@ switch_status_t switch_lpm_trie_lookup(const switch_lpm_trie_t *trie,
                                        const uint8_t *key,
                                        value_t *pvalue);
 
+/*
+ * Insert many prefixes at once, the leaves of each modified node are rebuilt
+ * once at the end instead of after every prefix.
+ */
+switch_status_t switch_lpm_trie_bulk_insert(
+    switch_lpm_trie_t *trie,
+    const switch_lpm_trie_entry_t *entries,
+    size_t num_entries);
+
 switch_status_t switch_lpm_trie_delete(switch_lpm_trie_t *trie,
                                        const uint8_t *prefix,
                                        size_t prefix_length);
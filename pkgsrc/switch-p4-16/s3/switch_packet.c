@@ -20,6 +20,9 @@
 /* Local header includes */
 #include "s3/switch_packet.h"
 #include "switch_utils.h"
+#include <sys/epoll.h>
+#include <poll.h>
+#include <target-utils/third-party/tommyds/tommyds/tommyhashdyn.h>
 #include "psample.h"
 #include "genl-packet.h"
 
@@ -80,16 +83,85 @@
 #endif
 
 #define PKTDRV_CMD_NONE '\0'
-#define PKTDRV_CMD_WAKE 'w'
 #define PKTDRV_CMD_EXIT 'e'
 
-pthread_t packet_driver_thread;
+/* epoll events and socket packets handled per packet driver wakeup */
+#define SWITCH_PKTDRIVER_MAX_EVENTS 64
+#define SWITCH_PKTDRIVER_RX_BATCH_SIZE 32
+
+/* hostif packets staged per queue for one sendmmsg on the cpu socket */
+#define SWITCH_PKTDRIVER_TX_BATCH_SIZE 32
+#define SWITCH_PKTDRIVER_TX_BUFFER_SIZE \
+  (SWITCH_PACKET_MAX_BUFFER_SIZE + sizeof(switch_packet_header_t))
+
+/* worker queues, capped by the number of online cpus */
+#define SWITCH_PKTDRIVER_MAX_QUEUES 4
+
+/* packet driver wakes up at least this often to update the rx rate */
+#define SWITCH_PKTDRIVER_PPS_INTERVAL_MS 1000
+
+/* cpu port tx wait for socket buffer space per retry */
+#define SWITCH_PKTDRIVER_TX_WAIT_MS 1000
+
+/*
+ * Packet and io counters are shared by the worker queues and the pcie rx
+ * callback, so they are only touched through these.
+ */
+#define SWITCH_PKTDRIVER_COUNTER_ADD(_counter, _value) \
+  __atomic_fetch_add(&(_counter), (_value), __ATOMIC_RELAXED)
+#define SWITCH_PKTDRIVER_COUNTER_GET(_counter) \
+  __atomic_load_n(&(_counter), __ATOMIC_RELAXED)
+#define SWITCH_PKTDRIVER_COUNTER_SET(_counter, _value) \
+  __atomic_store_n(&(_counter), (_value), __ATOMIC_RELAXED)
+
+/** packet driver queue */
+typedef struct switch_pktdriver_queue_s {
+  /** queue index, queue 0 owns the fds added by switch_pktdriver_fd_add */
+  switch_int32_t id;
+
+  /** worker thread serving the queue */
+  pthread_t thread;
+
+  /** epoll instance watching the fds of this queue */
+  switch_fd_t epoll_fd;
+
+  /** cpu socket of this queue, in the cpu port fanout group */
+  switch_fd_t cpu_fd;
+
+  /** preallocated buffers for batched reads */
+  switch_int8_t *rx_pool;
+
+  /** cpu frames staged for the next sendmmsg */
+  switch_int8_t *tx_pool;
+  switch_int32_t tx_size[SWITCH_PKTDRIVER_TX_BATCH_SIZE];
+  switch_int32_t num_tx;
+} switch_pktdriver_queue_t;
+
 static pthread_mutex_t cookie_mutex;
 static pthread_cond_t cookie_cv;
 static volatile int cookie = 0;
 
 switch_pktdriver_context_t *pktdriver_ctx = NULL;
-pthread_mutex_t fd_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Held shared while a packet is handled, by the queue workers and the pcie rx
+ * callback, and exclusive while fds or filters are added or removed. Writers
+ * are preferred so that busy queues cannot hold off a delete. Rx callbacks
+ * run under the shared lock and must not add or remove filters.
+ */
+pthread_rwlock_t fd_lock = PTHREAD_RWLOCK_WRITER_NONRECURSIVE_INITIALIZER_NP;
+
+/* libnl sockets are not thread safe */
+static pthread_mutex_t genl_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static inline void switch_pktdriver_counter_max(uint64_t *counter,
+                                                uint64_t value) {
+  uint64_t cur = __atomic_load_n(counter, __ATOMIC_RELAXED);
+  while (value > cur &&
+         !__atomic_compare_exchange_n(
+             counter, &cur, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+  }
+}
 
 static switch_status_t pktdriver_cmd_send(char cmd) {
   int rc = switch_fd_write(pktdriver_ctx->pipe_fd[1], &cmd, 1);
@@ -346,6 +418,92 @@ cleanup:
   return status;
 }
 
+static switch_status_t switch_pktdriver_queue_fd_add(
+    const switch_device_t device,
+    switch_pktdriver_queue_t *queue,
+    const switch_fd_t fd,
+    const switch_fd_t hostif_fd);
+
+/*
+ * Attaches the remaining tun queues of a multi-queue hostif, one per packet
+ * driver queue, so that the kernel spreads the hostif transmit flows across
+ * the workers. A queue that cannot be attached only costs parallelism.
+ */
+static void switch_pkt_hostif_queues_open(switch_device_t device,
+                                          const char *tun_path,
+                                          const struct ifreq *tun_ifr,
+                                          switch_fd_t hostif_fd) {
+  switch_fd_t *queue_fds = NULL;
+  switch_int32_t num_queues = pktdriver_ctx->num_queues;
+  switch_int32_t fdflags = 0;
+  struct ifreq ifr;
+
+  if (num_queues < 2) return;
+
+  queue_fds = SWITCH_MALLOC(sizeof(switch_fd_t), num_queues);
+  if (!queue_fds) return;
+  for (int q = 0; q < num_queues; q++) queue_fds[q] = SWITCH_FD_INVALID;
+
+  for (int q = 1; q < num_queues; q++) {
+    switch_fd_t queue_fd = switch_open(tun_path, O_RDWR);
+    if (queue_fd < 0) break;
+
+    SWITCH_MEMCPY(&ifr, tun_ifr, sizeof(ifr));
+    fdflags = switch_fcntl(queue_fd, F_GETFL, 0);
+    if (switch_ioctl(queue_fd, TUNSETIFF, (void *)&ifr) < 0 || fdflags < 0 ||
+        switch_fcntl(queue_fd, F_SETFL, fdflags | O_NONBLOCK) < 0 ||
+        switch_pktdriver_queue_fd_add(
+            device, &pktdriver_ctx->queues[q], queue_fd, hostif_fd) !=
+            SWITCH_STATUS_SUCCESS) {
+      SWITCH_PKT_WARN("hostif %s tun queue %d attach failed: %s",
+                      tun_ifr->ifr_name,
+                      q,
+                      strerror(errno));
+      switch_fd_close(queue_fd);
+      break;
+    }
+    queue_fds[q] = queue_fd;
+  }
+
+  pthread_rwlock_wrlock(&fd_lock);
+  if (SWITCH_ARRAY_INSERT(&pktdriver_ctx->hostif_queue_array,
+                          hostif_fd,
+                          (void *)queue_fds) != SWITCH_STATUS_SUCCESS) {
+    pthread_rwlock_unlock(&fd_lock);
+    for (int q = 1; q < num_queues; q++) {
+      if (queue_fds[q] == SWITCH_FD_INVALID) continue;
+      switch_pktdriver_fd_delete(device, queue_fds[q]);
+      switch_fd_close(queue_fds[q]);
+    }
+    SWITCH_FREE(queue_fds);
+    return;
+  }
+  pthread_rwlock_unlock(&fd_lock);
+}
+
+static void switch_pkt_hostif_queues_close(switch_device_t device,
+                                           switch_fd_t hostif_fd) {
+  void *queue_fds = NULL;
+
+  pthread_rwlock_wrlock(&fd_lock);
+  if (SWITCH_ARRAY_GET(&pktdriver_ctx->hostif_queue_array,
+                       hostif_fd,
+                       &queue_fds) != SWITCH_STATUS_SUCCESS) {
+    pthread_rwlock_unlock(&fd_lock);
+    return;
+  }
+  SWITCH_ARRAY_DELETE(&pktdriver_ctx->hostif_queue_array, hostif_fd);
+  pthread_rwlock_unlock(&fd_lock);
+
+  for (int q = 1; q < pktdriver_ctx->num_queues; q++) {
+    switch_fd_t queue_fd = ((switch_fd_t *)queue_fds)[q];
+    if (queue_fd == SWITCH_FD_INVALID) continue;
+    switch_pktdriver_fd_delete(device, queue_fd);
+    switch_fd_close(queue_fd);
+  }
+  SWITCH_FREE(queue_fds);
+}
+
 switch_status_t switch_pkt_hostif_create(
     switch_device_t device,
     const switch_pkt_hostif_info_t *hostif_info,
@@ -357,6 +515,8 @@ switch_status_t switch_pkt_hostif_create(
   switch_fd_t hostif_fd = SWITCH_FD_INVALID;
   switch_int32_t fdflags = 0;
   struct ifreq ifr;
+  struct ifreq tun_ifr;
+  const char *tun_path = "/dev/net/bf_tun";
   switch_fd_t sock_fd = SWITCH_FD_INVALID;
   switch_knet_hostif_knetdev_t hostif_knetdev;
   switch_knet_info_t *knet_info = NULL;
@@ -393,10 +553,12 @@ switch_status_t switch_pkt_hostif_create(
     }
     *knet_hostif_handle = hostif_knetdev.knet_hostif_id;
   } else {
-    hostif_fd = switch_open("/dev/net/bf_tun", O_RDWR);
+    SWITCH_MEMSET(&tun_ifr, 0, sizeof(tun_ifr));
+    hostif_fd = switch_open(tun_path, O_RDWR);
     if (hostif_fd < 0) {
       // fallback on linux native tuntap driver
-      hostif_fd = switch_open("/dev/net/tun", O_RDWR);
+      tun_path = "/dev/net/tun";
+      hostif_fd = switch_open(tun_path, O_RDWR);
       if (hostif_fd < 0) {
         SWITCH_PKT_ERROR(
             "hostif create failed on device %d interface %s:"
@@ -427,8 +589,14 @@ switch_status_t switch_pkt_hostif_create(
 
     SWITCH_MEMSET(&ifr, 0, sizeof(ifr));
     ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+    if (pktdriver_ctx->num_queues > 1) ifr.ifr_flags |= IFF_MULTI_QUEUE;
     switch_strncpy(ifr.ifr_name, intf_name, IFNAMSIZ);
     rc = switch_ioctl(hostif_fd, TUNSETIFF, (void *)&ifr);
+    if (rc < 0 && (ifr.ifr_flags & IFF_MULTI_QUEUE)) {
+      // tun driver or existing netdev without multi-queue support
+      ifr.ifr_flags &= ~IFF_MULTI_QUEUE;
+      rc = switch_ioctl(hostif_fd, TUNSETIFF, (void *)&ifr);
+    }
     if (rc < 0) {
       status = SWITCH_STATUS_FAILURE;
       SWITCH_PKT_ERROR(
@@ -440,6 +608,7 @@ switch_status_t switch_pkt_hostif_create(
           strerror(errno));
       goto cleanup;
     }
+    SWITCH_MEMCPY(&tun_ifr, &ifr, sizeof(tun_ifr));
 
     rc = switch_fcntl(hostif_fd, F_GETFL, fdflags);
     if (rc < 0) {
@@ -589,6 +758,9 @@ switch_status_t switch_pkt_hostif_create(
           switch_error_to_string(status));
       goto cleanup;
     }
+    if (tun_ifr.ifr_flags & IFF_MULTI_QUEUE) {
+      switch_pkt_hostif_queues_open(device, tun_path, &tun_ifr, hostif_fd);
+    }
   }
 
   switch_fd_close(sock_fd);
@@ -792,6 +964,7 @@ switch_status_t switch_pkt_hostif_delete(switch_device_t device,
   if (!pktdriver_ctx) return SWITCH_STATUS_FAILURE;
 
   if (!pktdriver_ctx->knet_pkt_driver) {
+    switch_pkt_hostif_queues_close(device, fd);
     status = switch_pktdriver_fd_delete(device, fd);
     if (status != SWITCH_STATUS_SUCCESS) {
       SWITCH_PKT_ERROR(
@@ -1061,18 +1234,14 @@ switch_status_t switch_packet_knet_cpuif_bind(switch_device_t device) {
   return status;
 }
 
-switch_status_t switch_packet_hostif_bind(switch_device_t device) {
+static switch_fd_t switch_packet_cpu_sock_open(void) {
   struct ifreq ifr;
   struct sockaddr_ll addr;
   switch_int32_t cpu_fd = 0;
   switch_int32_t flags = 0;
   switch_int32_t rc = 0;
-  char *intf_name = NULL;
-  switch_status_t status = SWITCH_STATUS_SUCCESS;
+  char *intf_name = pktdriver_ctx->intf_name;
 
-  if (!pktdriver_ctx) return SWITCH_STATUS_FAILURE;
-
-  intf_name = pktdriver_ctx->intf_name;
   // initialize raw socket
   cpu_fd = switch_socket(AF_PACKET, SOCK_RAW, IPPROTO_RAW);
   if (cpu_fd < 0) {
@@ -1080,7 +1249,7 @@ switch_status_t switch_packet_hostif_bind(switch_device_t device) {
         "hostif bind failed."
         "socket creation failed for %s.",
         intf_name);
-    return SWITCH_STATUS_FAILURE;
+    return SWITCH_FD_INVALID;
   }
 
   // set cpu port to be non-blocking
@@ -1091,7 +1260,7 @@ switch_status_t switch_packet_hostif_bind(switch_device_t device) {
         "socket getfl failed for %s.",
         intf_name);
     switch_fd_close(cpu_fd);
-    return SWITCH_STATUS_FAILURE;
+    return SWITCH_FD_INVALID;
   }
 
   flags |= O_NONBLOCK;
@@ -1102,7 +1271,7 @@ switch_status_t switch_packet_hostif_bind(switch_device_t device) {
         "Set flag for interface %s failed",
         intf_name);
     switch_fd_close(cpu_fd);
-    return SWITCH_STATUS_FAILURE;
+    return SWITCH_FD_INVALID;
   }
 
   // initialize cpu port
@@ -1115,7 +1284,7 @@ switch_status_t switch_packet_hostif_bind(switch_device_t device) {
         "IOCTL on %s failed",
         intf_name);
     switch_fd_close(cpu_fd);
-    return SWITCH_STATUS_FAILURE;
+    return SWITCH_FD_INVALID;
   }
 
   // bind to cpu port
@@ -1130,22 +1299,78 @@ switch_status_t switch_packet_hostif_bind(switch_device_t device) {
         "cpu interface bind failed for %s",
         intf_name);
     switch_fd_close(cpu_fd);
-    return SWITCH_STATUS_FAILURE;
+    return SWITCH_FD_INVALID;
   }
 
   pktdriver_ctx->cpu_ifindex = ifr.ifr_ifindex;
+  return cpu_fd;
+}
+
+/*
+ * Spreads cpu port receive over the packet driver queues with one socket per
+ * queue in a PACKET_FANOUT group. Hashing keeps a flow on one queue, and the
+ * kernel does not loop frames sent by a group member back to the group. If
+ * the fanout cannot be set up the queue 0 socket keeps receiving everything.
+ */
+static void switch_packet_cpu_fanout_bind(switch_device_t device) {
+  switch_int32_t fanout = (getpid() & 0xffff) | (PACKET_FANOUT_HASH << 16);
+
+  if (pktdriver_ctx->num_queues < 2) return;
+
+  if (setsockopt(pktdriver_ctx->cpu_fd,
+                 SOL_PACKET,
+                 PACKET_FANOUT,
+                 &fanout,
+                 sizeof(fanout)) < 0) {
+    SWITCH_PKT_WARN("cpu port fanout failed for %s: %s",
+                    pktdriver_ctx->intf_name,
+                    strerror(errno));
+    return;
+  }
+
+  for (int q = 1; q < pktdriver_ctx->num_queues; q++) {
+    switch_pktdriver_queue_t *queue = &pktdriver_ctx->queues[q];
+    switch_fd_t cpu_fd = switch_packet_cpu_sock_open();
+    if (cpu_fd == SWITCH_FD_INVALID) break;
+
+    if (setsockopt(cpu_fd, SOL_PACKET, PACKET_FANOUT, &fanout, sizeof(fanout)) <
+            0 ||
+        switch_pktdriver_queue_fd_add(device, queue, cpu_fd, cpu_fd) !=
+            SWITCH_STATUS_SUCCESS) {
+      SWITCH_PKT_WARN("cpu port fanout queue %d failed for %s: %s",
+                      q,
+                      pktdriver_ctx->intf_name,
+                      strerror(errno));
+      switch_fd_close(cpu_fd);
+      break;
+    }
+    queue->cpu_fd = cpu_fd;
+  }
+}
+
+switch_status_t switch_packet_hostif_bind(switch_device_t device) {
+  switch_int32_t cpu_fd = 0;
+  switch_status_t status = SWITCH_STATUS_SUCCESS;
+
+  if (!pktdriver_ctx) return SWITCH_STATUS_FAILURE;
+
+  cpu_fd = switch_packet_cpu_sock_open();
+  if (cpu_fd == SWITCH_FD_INVALID) return SWITCH_STATUS_FAILURE;
+
   pktdriver_ctx->cpu_fd = cpu_fd;
+  pktdriver_ctx->queues[0].cpu_fd = cpu_fd;
 
   status = switch_pktdriver_fd_add(device, cpu_fd);
   if (status != SWITCH_STATUS_SUCCESS) {
     SWITCH_PKT_ERROR(
         "hostif bind failed."
-        "cpu interface bind failed : %s, rc=%u",
-        switch_error_to_string(status),
-        rc);
+        "cpu interface bind failed : %s",
+        switch_error_to_string(status));
     return status;
   }
 
+  switch_packet_cpu_fanout_bind(device);
+
   return status;
 }
 
@@ -1248,6 +1473,236 @@ switch_status_t switch_pktdriver_packet_dump(switch_packet_info_t *pkt_info,
   return SWITCH_STATUS_SUCCESS;
 }
 
+/* Filters of a classifier sharing the same flags and reason code mask */
+typedef struct switch_pktdriver_filter_class_s {
+  uint64_t flags;
+  uint32_t mask;
+
+  /* upper bound of the rank of the filters in the class */
+  switch_int32_t max_rank;
+
+  switch_size_t num_filters;
+
+  /* buckets hashed on the masked key */
+  tommy_hashdyn buckets;
+
+  switch_node_t node;
+} switch_pktdriver_filter_class_t;
+
+/* Filters with the same masked key in a class, best first */
+typedef struct switch_pktdriver_filter_bucket_s {
+  switch_pktdriver_filter_match_t match;
+  switch_pktdriver_filter_class_t *cls;
+  tommy_list entries;
+  tommy_hashdyn_node node;
+} switch_pktdriver_filter_bucket_t;
+
+typedef void (*switch_pktdriver_filter_match_get_t)(
+    const uint64_t flags,
+    const uint32_t mask,
+    const void *key,
+    switch_pktdriver_filter_match_t *match);
+
+static void switch_packet_driver_rx_filter_match_get(
+    const uint64_t flags,
+    const uint32_t mask,
+    const void *key,
+    switch_pktdriver_filter_match_t *match) {
+  const switch_pktdriver_rx_filter_key_t *rx_key = key;
+
+  SWITCH_MEMSET(match, 0x0, sizeof(*match));
+  if (flags & SWITCH_PKTDRIVER_RX_FILTER_ATTR_DEV_PORT) {
+    match->field[0] = rx_key->dev_port;
+  }
+  if (flags & SWITCH_PKTDRIVER_RX_FILTER_ATTR_PORT_LAG_INDEX) {
+    match->field[1] = rx_key->port_lag_index;
+  }
+  if (flags & SWITCH_PKTDRIVER_RX_FILTER_ATTR_BD) {
+    match->field[2] = rx_key->bd;
+  }
+  if (flags & SWITCH_PKTDRIVER_RX_FILTER_ATTR_REASON_CODE) {
+    match->field[3] = rx_key->reason_code & mask;
+  }
+}
+
+static void switch_packet_driver_tx_filter_match_get(
+    const uint64_t flags,
+    const uint32_t mask,
+    const void *key,
+    switch_pktdriver_filter_match_t *match) {
+  const switch_pktdriver_tx_filter_key_t *tx_key = key;
+  UNUSED(mask);
+
+  SWITCH_MEMSET(match, 0x0, sizeof(*match));
+  if (flags & SWITCH_PKTDRIVER_TX_FILTER_ATTR_HOSTIF_FD) {
+    match->field[0] = (uint32_t)tx_key->hostif_fd;
+  }
+}
+
+static inline bool switch_packet_driver_filter_entry_better(
+    const switch_pktdriver_filter_entry_t *entry1,
+    const switch_pktdriver_filter_entry_t *entry2) {
+  if (entry1->rank != entry2->rank) return entry1->rank > entry2->rank;
+  return entry1->seq > entry2->seq;
+}
+
+static int switch_packet_driver_filter_entry_compare(const void *key1,
+                                                     const void *key2) {
+  return switch_packet_driver_filter_entry_better(key1, key2) ? -1 : 1;
+}
+
+static int switch_packet_driver_filter_class_compare(const void *key1,
+                                                     const void *key2) {
+  const switch_pktdriver_filter_class_t *cls1 = key1;
+  const switch_pktdriver_filter_class_t *cls2 = key2;
+
+  if (cls1->max_rank == cls2->max_rank) return 0;
+  return cls1->max_rank > cls2->max_rank ? -1 : 1;
+}
+
+static int switch_packet_driver_filter_bucket_compare(const void *arg,
+                                                      const void *obj) {
+  const switch_pktdriver_filter_bucket_t *bucket = obj;
+  return memcmp(arg, &bucket->match, sizeof(bucket->match));
+}
+
+static inline tommy_hash_t switch_packet_driver_filter_match_hash(
+    const switch_pktdriver_filter_match_t *match) {
+  return tommy_hash_u32(0, match, sizeof(*match));
+}
+
+static void switch_packet_driver_classifier_init(
+    switch_pktdriver_classifier_t *classifier) {
+  tommy_list_init(&classifier->classes);
+  classifier->next_seq = 0;
+  classifier->num_filters = 0;
+}
+
+static switch_status_t switch_packet_driver_classifier_insert(
+    switch_pktdriver_classifier_t *classifier,
+    const uint64_t flags,
+    const uint32_t mask,
+    const switch_pktdriver_filter_match_t *match,
+    switch_pktdriver_filter_entry_t *entry) {
+  switch_pktdriver_filter_class_t *cls = NULL;
+  switch_pktdriver_filter_bucket_t *bucket = NULL;
+  tommy_hash_t hash = switch_packet_driver_filter_match_hash(match);
+  switch_node_t *node = NULL;
+
+  for (node = tommy_list_head(&classifier->classes); node; node = node->next) {
+    switch_pktdriver_filter_class_t *tmp_cls = node->data;
+    if (tmp_cls->flags == flags && tmp_cls->mask == mask) {
+      cls = tmp_cls;
+      break;
+    }
+  }
+
+  if (!cls) {
+    cls = SWITCH_MALLOC(sizeof(switch_pktdriver_filter_class_t), 0x01);
+    if (!cls) return SWITCH_STATUS_NO_MEMORY;
+    SWITCH_MEMSET(cls, 0x0, sizeof(*cls));
+    cls->flags = flags;
+    cls->mask = mask;
+    cls->max_rank = entry->rank;
+    tommy_hashdyn_init(&cls->buckets);
+    tommy_list_insert_tail(&classifier->classes, &cls->node, cls);
+  }
+
+  bucket = tommy_hashdyn_search(&cls->buckets,
+                                switch_packet_driver_filter_bucket_compare,
+                                match,
+                                hash);
+  if (!bucket) {
+    bucket = SWITCH_MALLOC(sizeof(switch_pktdriver_filter_bucket_t), 0x01);
+    if (!bucket) {
+      if (cls->num_filters == 0) {
+        tommy_list_remove_existing(&classifier->classes, &cls->node);
+        tommy_hashdyn_done(&cls->buckets);
+        SWITCH_FREE(cls);
+      }
+      return SWITCH_STATUS_NO_MEMORY;
+    }
+    SWITCH_MEMSET(bucket, 0x0, sizeof(*bucket));
+    SWITCH_MEMCPY(&bucket->match, match, sizeof(*match));
+    bucket->cls = cls;
+    tommy_list_init(&bucket->entries);
+    tommy_hashdyn_insert(&cls->buckets, &bucket->node, bucket, hash);
+  }
+
+  entry->seq = ++classifier->next_seq;
+  entry->bucket = bucket;
+  tommy_list_insert_tail(&bucket->entries, &entry->node, entry);
+  tommy_list_sort(&bucket->entries, switch_packet_driver_filter_entry_compare);
+
+  cls->num_filters++;
+  if (entry->rank > cls->max_rank) cls->max_rank = entry->rank;
+  tommy_list_sort(&classifier->classes,
+                  switch_packet_driver_filter_class_compare);
+  classifier->num_filters++;
+  return SWITCH_STATUS_SUCCESS;
+}
+
+static void switch_packet_driver_classifier_remove(
+    switch_pktdriver_classifier_t *classifier,
+    switch_pktdriver_filter_entry_t *entry) {
+  switch_pktdriver_filter_bucket_t *bucket = entry->bucket;
+  switch_pktdriver_filter_class_t *cls = NULL;
+
+  if (!bucket) return;
+  cls = bucket->cls;
+
+  tommy_list_remove_existing(&bucket->entries, &entry->node);
+  entry->bucket = NULL;
+  if (tommy_list_empty(&bucket->entries)) {
+    tommy_hashdyn_remove_existing(&cls->buckets, &bucket->node);
+    SWITCH_FREE(bucket);
+  }
+
+  /* max_rank stays an upper bound, it only affects how early lookups stop */
+  if (--cls->num_filters == 0) {
+    tommy_list_remove_existing(&classifier->classes, &cls->node);
+    tommy_hashdyn_done(&cls->buckets);
+    SWITCH_FREE(cls);
+  }
+  classifier->num_filters--;
+}
+
+/*
+ * Returns the best filter matching key: classes are probed in rank order and
+ * the walk stops once no remaining class can hold a better filter.
+ */
+static switch_pktdriver_filter_entry_t *switch_packet_driver_classifier_lookup(
+    switch_pktdriver_classifier_t *classifier,
+    switch_pktdriver_filter_match_get_t match_get,
+    const void *key) {
+  switch_pktdriver_filter_entry_t *best = NULL;
+  switch_pktdriver_filter_match_t match;
+  switch_node_t *node = NULL;
+
+  for (node = tommy_list_head(&classifier->classes); node; node = node->next) {
+    switch_pktdriver_filter_class_t *cls = node->data;
+    switch_pktdriver_filter_bucket_t *bucket = NULL;
+    switch_pktdriver_filter_entry_t *entry = NULL;
+
+    if (best && cls->max_rank < best->rank) break;
+
+    match_get(cls->flags, cls->mask, key, &match);
+    bucket = tommy_hashdyn_search(
+        &cls->buckets,
+        switch_packet_driver_filter_bucket_compare,
+        &match,
+        switch_packet_driver_filter_match_hash(&match));
+    if (!bucket) continue;
+
+    entry = tommy_list_head(&bucket->entries)->data;
+    if (!best || switch_packet_driver_filter_entry_better(entry, best)) {
+      best = entry;
+    }
+  }
+
+  return best;
+}
+
 switch_status_t switch_packet_init(const char *cpu_port,
                                    bool use_pcie,
                                    bool use_kpkt) {
@@ -1275,8 +1730,87 @@ switch_status_t switch_packet_init(const char *cpu_port,
   return status;
 }
 
+static void switch_pktdriver_queues_free(void) {
+  if (!pktdriver_ctx->queues) return;
+
+  for (int q = 0; q < pktdriver_ctx->num_queues; q++) {
+    switch_pktdriver_queue_t *queue = &pktdriver_ctx->queues[q];
+    if (queue->epoll_fd != SWITCH_FD_INVALID) {
+      switch_fd_close(queue->epoll_fd);
+    }
+    SWITCH_FREE(queue->rx_pool);
+    SWITCH_FREE(queue->tx_pool);
+  }
+  SWITCH_FREE(pktdriver_ctx->queues);
+  pktdriver_ctx->queues = NULL;
+  pktdriver_ctx->num_queues = 0;
+}
+
+/*
+ * Sets up one queue per online cpu, up to SWITCH_PKTDRIVER_MAX_QUEUES. Every
+ * queue watches the command pipe so that each worker can be told to exit.
+ */
+static switch_status_t switch_pktdriver_queues_init(void) {
+  struct epoll_event event;
+  long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  switch_int32_t num_queues = SWITCH_PKTDRIVER_MAX_QUEUES;
+
+  if (num_cpus > 0 && num_cpus < num_queues) num_queues = num_cpus;
+
+  pktdriver_ctx->queues =
+      SWITCH_MALLOC(sizeof(switch_pktdriver_queue_t), num_queues);
+  if (!pktdriver_ctx->queues) return SWITCH_STATUS_NO_MEMORY;
+  SWITCH_MEMSET(pktdriver_ctx->queues,
+                0x0,
+                sizeof(switch_pktdriver_queue_t) * num_queues);
+  for (int q = 0; q < num_queues; q++) {
+    pktdriver_ctx->queues[q].id = q;
+    pktdriver_ctx->queues[q].epoll_fd = SWITCH_FD_INVALID;
+    pktdriver_ctx->queues[q].cpu_fd = SWITCH_FD_INVALID;
+  }
+  pktdriver_ctx->num_queues = num_queues;
+
+  for (int q = 0; q < num_queues; q++) {
+    switch_pktdriver_queue_t *queue = &pktdriver_ctx->queues[q];
+
+    queue->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (queue->epoll_fd < 0) {
+      SWITCH_PKT_ERROR("pktdriver init failed. epoll create failed:(%s)\n",
+                       strerror(errno));
+      queue->epoll_fd = SWITCH_FD_INVALID;
+      return SWITCH_STATUS_FAILURE;
+    }
+
+    queue->rx_pool = SWITCH_MALLOC(SWITCH_PACKET_MAX_BUFFER_SIZE,
+                                   SWITCH_PKTDRIVER_RX_BATCH_SIZE);
+    queue->tx_pool = SWITCH_MALLOC(SWITCH_PKTDRIVER_TX_BUFFER_SIZE,
+                                   SWITCH_PKTDRIVER_TX_BATCH_SIZE);
+    if (!queue->rx_pool || !queue->tx_pool) {
+      SWITCH_PKT_ERROR("pktdriver init failed. queue pool alloc failed\n");
+      return SWITCH_STATUS_NO_MEMORY;
+    }
+
+    SWITCH_MEMSET(&event, 0x0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = pktdriver_ctx->pipe_fd[0];
+    if (epoll_ctl(queue->epoll_fd,
+                  EPOLL_CTL_ADD,
+                  pktdriver_ctx->pipe_fd[0],
+                  &event) < 0) {
+      SWITCH_PKT_ERROR("pktdriver init failed. pipe add failed:(%s)\n",
+                       strerror(errno));
+      return SWITCH_STATUS_FAILURE;
+    }
+  }
+
+  return SWITCH_STATUS_SUCCESS;
+}
+
 switch_status_t switch_packet_clean() {
-  if (pktdriver_ctx) bf_sys_free(pktdriver_ctx);
+  if (pktdriver_ctx) {
+    switch_pktdriver_queues_free();
+    bf_sys_free(pktdriver_ctx);
+  }
   cookie = 0;
   return SWITCH_STATUS_SUCCESS;
 }
@@ -1301,17 +1835,19 @@ switch_status_t switch_pktdriver_init() {
 
   rc = switch_fcntl(pktdriver_ctx->pipe_fd[0], F_GETFL, 0);
   if (rc != 0) {
+    status = SWITCH_STATUS_FAILURE;
     SWITCH_PKT_ERROR("pktdriver init failed. F_GETFL failed:(%s)\n",
                      switch_error_to_string(status));
-    return SWITCH_STATUS_FAILURE;
+    goto cleanup;
   }
 
   flags = flags | O_NONBLOCK;
   rc = switch_fcntl(pktdriver_ctx->pipe_fd[0], F_SETFL, flags);
   if (rc != 0) {
+    status = SWITCH_STATUS_FAILURE;
     SWITCH_PKT_ERROR("pktdriver init failed. F_SETFL failed:(%s)\n",
                      switch_error_to_string(status));
-    return SWITCH_STATUS_FAILURE;
+    goto cleanup;
   }
 
   status = SWITCH_ARRAY_INIT(&pktdriver_ctx->fd_array);
@@ -1323,11 +1859,20 @@ switch_status_t switch_pktdriver_init() {
     goto cleanup;
   }
 
-  status = switch_pktdriver_fd_add(device, pktdriver_ctx->pipe_fd[0]);
+  status = SWITCH_ARRAY_INIT(&pktdriver_ctx->hostif_queue_array);
   if (status != SWITCH_STATUS_SUCCESS) {
-    SWITCH_PKT_ERROR("pktdriver init failed. fd add failed:(%s)\n",
+    SWITCH_PKT_ERROR(
+        "pktdriver init failed."
+        "hostif queue array init failed:(%s)\n",
+        switch_error_to_string(status));
+    goto cleanup;
+  }
+
+  status = switch_pktdriver_queues_init();
+  if (status != SWITCH_STATUS_SUCCESS) {
+    SWITCH_PKT_ERROR("pktdriver init failed. queue init failed:(%s)\n",
                      switch_error_to_string(status));
-    return SWITCH_STATUS_FAILURE;
+    goto cleanup;
   }
 
   if (pktdriver_ctx->knet_pkt_driver) {
@@ -1353,23 +1898,8 @@ switch_status_t switch_pktdriver_init() {
       }
     }
 
-    status = SWITCH_LIST_INIT(&pktdriver_ctx->rx_filter);
-    if (status != SWITCH_STATUS_SUCCESS) {
-      SWITCH_PKT_ERROR(
-          "pktdriver init failed."
-          "rx filter list init failed:(%s)\n",
-          switch_error_to_string(status));
-      goto cleanup;
-    }
-
-    status = SWITCH_LIST_INIT(&pktdriver_ctx->tx_filter);
-    if (status != SWITCH_STATUS_SUCCESS) {
-      SWITCH_PKT_ERROR(
-          "pktdriver init failed."
-          "rx filter list init failed:(%s)\n",
-          switch_error_to_string(status));
-      goto cleanup;
-    }
+    switch_packet_driver_classifier_init(&pktdriver_ctx->rx_filter);
+    switch_packet_driver_classifier_init(&pktdriver_ctx->tx_filter);
   }
 
   return status;
@@ -1377,6 +1907,7 @@ switch_status_t switch_pktdriver_init() {
 cleanup:
   tmp_status = switch_pktdriver_free();
   SWITCH_ASSERT(tmp_status == SWITCH_STATUS_SUCCESS);
+  switch_pktdriver_queues_free();
   return status;
 }
 
@@ -1386,116 +1917,40 @@ switch_status_t switch_pktdriver_free(void) {
 
   if (!pktdriver_ctx) return SWITCH_STATUS_FAILURE;
 
+  for (int q = 1; q < pktdriver_ctx->num_queues; q++) {
+    switch_pktdriver_queue_t *queue = &pktdriver_ctx->queues[q];
+    if (queue->cpu_fd == SWITCH_FD_INVALID) continue;
+    switch_pktdriver_fd_delete(device, queue->cpu_fd);
+    switch_fd_close(queue->cpu_fd);
+    queue->cpu_fd = SWITCH_FD_INVALID;
+  }
+
   if (pktdriver_ctx->cpu_fd != SWITCH_FD_INVALID) {
     switch_pktdriver_fd_delete(device, pktdriver_ctx->cpu_fd);
     switch_fd_close(pktdriver_ctx->cpu_fd);
+    pktdriver_ctx->cpu_fd = SWITCH_FD_INVALID;
+    if (pktdriver_ctx->queues) {
+      pktdriver_ctx->queues[0].cpu_fd = SWITCH_FD_INVALID;
+    }
   }
 
   if (pktdriver_ctx->pipe_fd[0] != SWITCH_FD_INVALID) {
-    switch_pktdriver_fd_delete(device, pktdriver_ctx->pipe_fd[0]);
     switch_fd_close(pktdriver_ctx->pipe_fd[0]);
+    pktdriver_ctx->pipe_fd[0] = SWITCH_FD_INVALID;
   }
 
   if (pktdriver_ctx->pipe_fd[1] != SWITCH_FD_INVALID) {
     switch_fd_close(pktdriver_ctx->pipe_fd[1]);
+    pktdriver_ctx->pipe_fd[1] = SWITCH_FD_INVALID;
   }
 
   return status;
 }
 
-static bool switch_packet_driver_tx_filter_match(
-    const uint64_t flags,
-    const switch_pktdriver_tx_filter_key_t *tx_key1,
-    const switch_pktdriver_tx_filter_key_t *tx_key2) {
-  SWITCH_ASSERT(tx_key1 && tx_key2);
-
-  if (flags & SWITCH_PKTDRIVER_TX_FILTER_ATTR_HOSTIF_FD) {
-    if (tx_key1->hostif_fd != tx_key2->hostif_fd) {
-      return false;
-    }
-  }
-
-  return true;
-}
-
-switch_int32_t switch_packet_driver_tx_filter_priority_compare(
-    const void *key1, const void *key2) {
-  switch_pktdriver_tx_filter_info_t *tx_info1 = NULL;
-  switch_pktdriver_tx_filter_info_t *tx_info2 = NULL;
-
-  SWITCH_ASSERT(key1 && key2);
-  if (!key1 || !key2) {
-    SWITCH_PKT_ERROR("tx filter priority compare failed: %s",
-                     switch_error_to_string(SWITCH_STATUS_INVALID_PARAMETER));
-    return -1;
-  }
-
-  tx_info1 = (switch_pktdriver_tx_filter_info_t *)key1;
-  tx_info2 = (switch_pktdriver_tx_filter_info_t *)key2;
-
-  return (switch_int32_t)tx_info1->priority -
-         (switch_int32_t)tx_info2->priority;
-}
-
-static bool switch_packet_driver_rx_filter_match(
-    const uint64_t flags,
-    const switch_pktdriver_rx_filter_key_t *rx_key1,
-    const switch_pktdriver_rx_filter_key_t *rx_key2) {
-  SWITCH_ASSERT(rx_key1 && rx_key2);
-
-  if (flags & SWITCH_PKTDRIVER_RX_FILTER_ATTR_DEV_PORT) {
-    if (rx_key1->dev_port != rx_key2->dev_port) {
-      return false;
-    }
-  }
-
-  if (flags & SWITCH_PKTDRIVER_RX_FILTER_ATTR_PORT_LAG_INDEX) {
-    if (rx_key1->port_lag_index != rx_key2->port_lag_index) {
-      return false;
-    }
-  }
-
-  if (flags & SWITCH_PKTDRIVER_RX_FILTER_ATTR_BD) {
-    if (rx_key1->bd != rx_key2->bd) {
-      return false;
-    }
-  }
-
-  if (flags & SWITCH_PKTDRIVER_RX_FILTER_ATTR_REASON_CODE) {
-    if ((rx_key1->reason_code & rx_key1->reason_code_mask) !=
-        (rx_key2->reason_code & rx_key1->reason_code_mask)) {
-      return false;
-    }
-  }
-
-  return true;
-}
-
-switch_int32_t switch_packet_driver_rx_filter_priority_compare(
-    const void *key1, const void *key2) {
-  switch_pktdriver_rx_filter_info_t *rx_info1 = NULL;
-  switch_pktdriver_rx_filter_info_t *rx_info2 = NULL;
-  switch_status_t status = SWITCH_STATUS_SUCCESS;
-
-  if (!key1 || !key2) {
-    SWITCH_PKT_ERROR("packet driver rx filter priority compare failed:(%s)\n",
-                     switch_error_to_string(status));
-    return -1;
-  }
-
-  rx_info1 = (switch_pktdriver_rx_filter_info_t *)key1;
-  rx_info2 = (switch_pktdriver_rx_filter_info_t *)key2;
-
-  return (switch_int32_t)rx_info2->priority -
-         (switch_int32_t)rx_info1->priority;
-}
-
 switch_status_t switch_pktdriver_rx_filter_info_get(
     switch_pktdriver_rx_filter_key_t *rx_key,
     switch_pktdriver_rx_filter_info_t **rx_info) {
-  switch_pktdriver_rx_filter_info_t *tmp_rx_info = NULL;
-  switch_node_t *node = NULL;
-  bool matched = false;
+  switch_pktdriver_filter_entry_t *entry = NULL;
   switch_status_t status = SWITCH_STATUS_SUCCESS;
 
   if (!pktdriver_ctx) return SWITCH_STATUS_FAILURE;
@@ -1510,28 +1965,20 @@ switch_status_t switch_pktdriver_rx_filter_info_get(
 
   *rx_info = NULL;
 
-  status = SWITCH_STATUS_ITEM_NOT_FOUND;
-  FOR_EACH_IN_LIST(pktdriver_ctx->rx_filter, node) {
-    tmp_rx_info = (switch_pktdriver_rx_filter_info_t *)node->data;
-    matched = switch_packet_driver_rx_filter_match(
-        tmp_rx_info->flags, &tmp_rx_info->rx_key, rx_key);
-
-    if (matched) {
-      *rx_info = tmp_rx_info;
-      return SWITCH_STATUS_SUCCESS;
-    }
-  }
-  FOR_EACH_IN_LIST_END();
+  entry = switch_packet_driver_classifier_lookup(
+      &pktdriver_ctx->rx_filter,
+      switch_packet_driver_rx_filter_match_get,
+      rx_key);
+  if (!entry) return SWITCH_STATUS_ITEM_NOT_FOUND;
 
+  *rx_info = entry->info;
   return status;
 }
 
 switch_status_t switch_pktdriver_tx_filter_info_get(
     switch_pktdriver_tx_filter_key_t *tx_key,
     switch_pktdriver_tx_filter_info_t **tx_info) {
-  switch_pktdriver_tx_filter_info_t *tmp_tx_info = NULL;
-  switch_node_t *node = NULL;
-  bool matched = false;
+  switch_pktdriver_filter_entry_t *entry = NULL;
   switch_status_t status = SWITCH_STATUS_SUCCESS;
 
   if (!pktdriver_ctx) return SWITCH_STATUS_FAILURE;
@@ -1546,20 +1993,60 @@ switch_status_t switch_pktdriver_tx_filter_info_get(
 
   *tx_info = NULL;
 
-  status = SWITCH_STATUS_ITEM_NOT_FOUND;
-  FOR_EACH_IN_LIST(pktdriver_ctx->tx_filter, node) {
-    tmp_tx_info = (switch_pktdriver_tx_filter_info_t *)node->data;
-    matched = switch_packet_driver_tx_filter_match(
-        tmp_tx_info->flags, &tmp_tx_info->tx_key, tx_key);
+  entry = switch_packet_driver_classifier_lookup(
+      &pktdriver_ctx->tx_filter,
+      switch_packet_driver_tx_filter_match_get,
+      tx_key);
+  if (!entry) return SWITCH_STATUS_ITEM_NOT_FOUND;
+
+  *tx_info = entry->info;
+  return status;
+}
+
+/*
+ * Sends on the raw cpu socket. The socket is non-blocking, so poll() is only
+ * needed for backpressure once the socket buffer is full.
+ */
+static switch_status_t switch_pktdriver_cpu_sock_send(switch_int8_t *out_packet,
+                                                      switch_int32_t pkt_size) {
+  struct sockaddr_ll addr;
+  struct pollfd pfd;
+  switch_int32_t rc = 0;
+
+  SWITCH_MEMSET(&addr, 0x0, sizeof(addr));
+  addr.sll_ifindex = pktdriver_ctx->cpu_ifindex;
 
-    if (matched) {
-      *tx_info = tmp_tx_info;
+  for (int retry = 2;; retry--) {
+    rc = switch_fd_send(pktdriver_ctx->cpu_fd,
+                        out_packet,
+                        pkt_size,
+                        0x0,
+                        (struct sockaddr *)&addr,
+                        sizeof(addr));
+    if (rc >= 0) {
       return SWITCH_STATUS_SUCCESS;
     }
+
+    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != ENOBUFS) {
+      SWITCH_PKT_ERROR("pktdriver cpu tx failed: errno=%s\n", strerror(errno));
+      return SWITCH_STATUS_FAILURE;
+    }
+
+    if (retry == 0) break;
+
+    SWITCH_PKTDRIVER_COUNTER_ADD(pktdriver_ctx->num_io_tx_waits, 1);
+    pfd.fd = pktdriver_ctx->cpu_fd;
+    pfd.events = POLLOUT;
+    pfd.revents = 0;
+    /* poll returns 0 if timeout, 1 if the socket is writable, -1 if error. */
+    rc = poll(&pfd, 1, SWITCH_PKTDRIVER_TX_WAIT_MS);
+    if (rc < 0) {
+      SWITCH_PKT_ERROR("cpu tx poll failed: %s", strerror(errno));
+    }
   }
-  FOR_EACH_IN_LIST_END();
 
-  return status;
+  SWITCH_PKT_DEBUG("pktdriver cp tx failed: cpu_fd is not ready to write\n");
+  return SWITCH_STATUS_SUCCESS;
 }
 
 switch_status_t switch_pktdriver_cpu_tx(switch_device_t device,
@@ -1609,72 +2096,26 @@ switch_status_t switch_pktdriver_cpu_tx(switch_device_t device,
       bf_pkt_free(device, pkt);
     }
   } else {
-    struct sockaddr_ll addr;
-    SWITCH_MEMSET(&addr, 0x0, sizeof(addr));
-    addr.sll_ifindex = pktdriver_ctx->cpu_ifindex;
-
-    for (int retry = 2; retry > 0; retry--) {
-      fd_set write_set;
-      struct timeval timeout;
-
-      /* Initialize the file descriptor set. */
-      FD_ZERO(&write_set);
-      FD_SET(pktdriver_ctx->cpu_fd, &write_set);
-
-      /* Initialize the timeout data structure. */
-      timeout.tv_sec = 1;
-      timeout.tv_usec = 0;
-
-      /* select returns 0 if timeout, 1 if input available, -1 if error. */
-      rc = select(FD_SETSIZE, NULL, &write_set, NULL, &timeout);
-      if (rc < 0) {
-        SWITCH_PKT_ERROR("cpu tx select failed: %s", strerror(errno));
-        continue;
-      }
-
-      if (!FD_ISSET((pktdriver_ctx->cpu_fd), &write_set)) {
-        SWITCH_PKT_DEBUG(
-            "pktdriver cp tx failed: cpu_fd is not ready to write\n");
-        continue;
-      }
-
-      rc = switch_fd_send(pktdriver_ctx->cpu_fd,
-                          out_packet,
-                          pkt_size,
-                          0x0,
-                          (struct sockaddr *)&addr,
-                          sizeof(addr));
-      if (rc >= 0) {
-        break;
-      }
-
-      SWITCH_PKT_ERROR("pktdriver cpu tx failed: errno=%s\n", strerror(errno));
-      return SWITCH_STATUS_FAILURE;
-    }
+    status = switch_pktdriver_cpu_sock_send(out_packet, pkt_size);
   }
 
   return status;
 }
 
-switch_status_t switch_pktdriver_tx(switch_packet_info_t *pkt_info) {
-  switch_int8_t out_packet[SWITCH_PACKET_MAX_BUFFER_SIZE +
-                           sizeof(switch_packet_header_t)];
+/*
+ * Builds the frame for the cpu port, the packet with the fabric and cpu
+ * headers inserted after the ethernet addresses, into out_packet.
+ */
+static switch_status_t switch_pktdriver_tx_encap(
+    switch_packet_info_t *pkt_info,
+    switch_int8_t *out_packet,
+    switch_int32_t *out_size) {
   uint16_t bd = 0;
   uint16_t in_offset = 0;
   uint16_t out_offset = 0;
   uint32_t pkt_size = 0;
   switch_status_t status = SWITCH_STATUS_SUCCESS;
 
-  if (!pktdriver_ctx) return SWITCH_STATUS_FAILURE;
-
-  if (!pktdriver_ctx->use_pcie && pktdriver_ctx->cpu_fd == SWITCH_FD_INVALID) {
-    SWITCH_PKT_ERROR(
-        "packet tx failed: "
-        "cpu fd not initialized:(%s)\n",
-        switch_error_to_string(status));
-    return status;
-  }
-
   pkt_size = pkt_info->pkt_size;
 
   if (pkt_info->pkt_type == SWITCH_PKTDRIVER_PACKET_TYPE_TX_NETDEV) {
@@ -1711,13 +2152,13 @@ switch_status_t switch_pktdriver_tx(switch_packet_info_t *pkt_info) {
       SWITCH_PKTINFO_TX_DEV_PORT(pkt_info) = SWITCH_INVALID_HW_PORT;
     }
     SWITCH_PKTINFO_BYPASS_FLAGS(pkt_info) = tx_info->tx_action.bypass_flags;
-    pktdriver_ctx->num_tx_netdev_packets++;
-    tx_info->num_packets++;
+    SWITCH_PKTDRIVER_COUNTER_ADD(pktdriver_ctx->num_tx_netdev_packets, 1);
+    SWITCH_PKTDRIVER_COUNTER_ADD(tx_info->num_packets, 1);
   } else {
     SWITCH_PKTINFO_BYPASS_FLAGS(pkt_info) =
         SWITCH_BYPASS_NONE | SWITCH_BYPASS_SYSTEM_ACL;
     SWITCH_PKTINFO_TX_DEV_PORT(pkt_info) = SWITCH_INVALID_HW_PORT;
-    pktdriver_ctx->num_tx_cb_packets++;
+    SWITCH_PKTDRIVER_COUNTER_ADD(pktdriver_ctx->num_tx_cb_packets, 1);
   }
 
   SWITCH_PKTINFO_PACKET_TYPE(pkt_info) = SWITCH_FABRIC_HEADER_TYPE_CPU;
@@ -1729,8 +2170,6 @@ switch_status_t switch_pktdriver_tx(switch_packet_info_t *pkt_info) {
     switch_pktdriver_packet_dump(pkt_info, false);
   }
 
-  SWITCH_MEMSET(out_packet, 0x0, sizeof(out_packet));
-
   SWITCH_MEMCPY(
       (out_packet + out_offset), pkt_info->pkt, SWITCH_PACKET_HEADER_OFFSET);
   out_offset += SWITCH_PACKET_HEADER_OFFSET;
@@ -1744,22 +2183,110 @@ switch_status_t switch_pktdriver_tx(switch_packet_info_t *pkt_info) {
   out_offset += sizeof(switch_packet_header_t);
   pkt_size += sizeof(switch_packet_header_t);
 
-  SWITCH_MEMCPY((out_packet + out_offset),
-                (pkt_info->pkt + in_offset),
-                pkt_info->pkt_size - in_offset);
+  SWITCH_MEMCPY((out_packet + out_offset),
+                (pkt_info->pkt + in_offset),
+                pkt_info->pkt_size - in_offset);
+
+  *out_size = pkt_size;
+  return status;
+}
+
+switch_status_t switch_pktdriver_tx(switch_packet_info_t *pkt_info) {
+  switch_int8_t out_packet[SWITCH_PKTDRIVER_TX_BUFFER_SIZE];
+  switch_int32_t pkt_size = 0;
+  switch_status_t status = SWITCH_STATUS_SUCCESS;
+
+  if (!pktdriver_ctx) return SWITCH_STATUS_FAILURE;
+
+  if (!pktdriver_ctx->use_pcie && pktdriver_ctx->cpu_fd == SWITCH_FD_INVALID) {
+    SWITCH_PKT_ERROR(
+        "packet tx failed: "
+        "cpu fd not initialized:(%s)\n",
+        switch_error_to_string(status));
+    return status;
+  }
+
+  status = switch_pktdriver_tx_encap(pkt_info, out_packet, &pkt_size);
+  if (status != SWITCH_STATUS_SUCCESS) return status;
+
+  status = switch_pktdriver_cpu_tx(pkt_info->device, out_packet, pkt_size);
+  if (status != SWITCH_STATUS_SUCCESS) {
+    SWITCH_PKT_ERROR(
+        "pktdriver tx failed: "
+        "pktdriver cpu tx failed:(%s)\n",
+        switch_error_to_string(status));
+    return status;
+  }
+
+  SWITCH_PKTDRIVER_COUNTER_ADD(pktdriver_ctx->num_tx_packets, 1);
+
+  return status;
+}
+
+/*
+ * Sends the frames staged on a queue with sendmmsg on its cpu socket. Socket
+ * buffer backpressure is handled like switch_pktdriver_cpu_sock_send, and a
+ * frame the socket rejects is dropped without holding up the rest.
+ */
+static void switch_pktdriver_tx_flush(switch_pktdriver_queue_t *queue) {
+  struct mmsghdr msgs[SWITCH_PKTDRIVER_TX_BATCH_SIZE];
+  struct iovec iovs[SWITCH_PKTDRIVER_TX_BATCH_SIZE];
+  struct sockaddr_ll addr;
+  struct pollfd pfd;
+  switch_fd_t cpu_fd = queue->cpu_fd;
+  switch_int32_t num_sent = 0;
+  switch_int32_t num_dropped = 0;
+  switch_int32_t rc = 0;
+
+  if (queue->num_tx == 0) return;
+  if (cpu_fd == SWITCH_FD_INVALID) cpu_fd = pktdriver_ctx->cpu_fd;
+
+  SWITCH_MEMSET(&addr, 0x0, sizeof(addr));
+  addr.sll_ifindex = pktdriver_ctx->cpu_ifindex;
+  SWITCH_MEMSET(msgs, 0x0, sizeof(msgs));
+  for (int i = 0; i < queue->num_tx; i++) {
+    iovs[i].iov_base = queue->tx_pool + i * SWITCH_PKTDRIVER_TX_BUFFER_SIZE;
+    iovs[i].iov_len = queue->tx_size[i];
+    msgs[i].msg_hdr.msg_name = &addr;
+    msgs[i].msg_hdr.msg_namelen = sizeof(addr);
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  for (int retry = 2; num_sent < queue->num_tx;) {
+    rc = sendmmsg(cpu_fd, msgs + num_sent, queue->num_tx - num_sent, 0x0);
+    if (rc > 0) {
+      num_sent += rc;
+      continue;
+    }
+
+    if (rc < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != ENOBUFS) {
+      SWITCH_PKT_ERROR("pktdriver cpu tx failed: errno=%s\n", strerror(errno));
+      num_sent++;
+      num_dropped++;
+      continue;
+    }
 
-  status = switch_pktdriver_cpu_tx(pkt_info->device, out_packet, pkt_size);
-  if (status != SWITCH_STATUS_SUCCESS) {
-    SWITCH_PKT_ERROR(
-        "pktdriver tx failed: "
-        "pktdriver cpu tx failed:(%s)\n",
-        switch_error_to_string(status));
-    return status;
-  }
+    if (retry-- == 0) {
+      SWITCH_PKT_DEBUG(
+          "pktdriver cp tx failed: cpu_fd is not ready to write\n");
+      num_dropped += queue->num_tx - num_sent;
+      break;
+    }
 
-  pktdriver_ctx->num_tx_packets++;
+    SWITCH_PKTDRIVER_COUNTER_ADD(pktdriver_ctx->num_io_tx_waits, 1);
+    pfd.fd = cpu_fd;
+    pfd.events = POLLOUT;
+    pfd.revents = 0;
+    rc = poll(&pfd, 1, SWITCH_PKTDRIVER_TX_WAIT_MS);
+    if (rc < 0) {
+      SWITCH_PKT_ERROR("cpu tx poll failed: %s", strerror(errno));
+    }
+  }
 
-  return status;
+  SWITCH_PKTDRIVER_COUNTER_ADD(pktdriver_ctx->num_tx_packets,
+                               (uint64_t)(queue->num_tx - num_dropped));
+  queue->num_tx = 0;
 }
 
 static switch_status_t send_msg_to_genl_psample(switch_packet_info_t *pkt_info,
@@ -1960,14 +2487,19 @@ static switch_status_t send_msg_to_genl(
     switch_packet_info_t *pkt_info, switch_pktdriver_rx_filter_key_t *rx_key) {
   uint16_t reason_code_value =
       rx_key->reason_code & SWITCH_REASON_CODE_VALUE_MASK;
+  switch_status_t status = SWITCH_STATUS_NOT_SUPPORTED;
 
+  pthread_mutex_lock(&genl_mutex);
   switch (rx_key->reason_code & SWITCH_REASON_CODE_TYPE_MASK) {
     case SWITCH_SFLOW_REASON_CODE:
-      return send_msg_to_genl_psample(pkt_info, reason_code_value);
+      status = send_msg_to_genl_psample(pkt_info, reason_code_value);
+      break;
     case SWITCH_UDT_REASON_CODE:
-      return send_msg_to_genl_packet(pkt_info, reason_code_value);
+      status = send_msg_to_genl_packet(pkt_info, reason_code_value);
+      break;
   }
-  return SWITCH_STATUS_NOT_SUPPORTED;
+  pthread_mutex_unlock(&genl_mutex);
+  return status;
 }
 
 switch_status_t switch_pktdriver_netdev_rx(switch_packet_info_t *pkt_info) {
@@ -2191,8 +2723,10 @@ switch_status_t switch_pktdriver_rx(switch_packet_info_t *pkt_info) {
 
   reason_code = SWITCH_PKTINFO_REASON_CODE(pkt_info);
   if (reason_code < SWITCH_HOSTIF_MAX_REASON_CODE) {
-    pktdriver_ctx->rx_rc_pkts[reason_code].count++;
-    pktdriver_ctx->rx_rc_bytes[reason_code].count += pkt_info->pkt_size;
+    SWITCH_PKTDRIVER_COUNTER_ADD(pktdriver_ctx->rx_rc_pkts[reason_code].count,
+                                 1);
+    SWITCH_PKTDRIVER_COUNTER_ADD(pktdriver_ctx->rx_rc_bytes[reason_code].count,
+                                 (uint64_t)pkt_info->pkt_size);
   }
 
   dev_port = SWITCH_PKTINFO_RX_DEV_PORT(pkt_info);
@@ -2200,8 +2734,11 @@ switch_status_t switch_pktdriver_rx(switch_packet_info_t *pkt_info) {
     // status = switch_device_front_port_get(pkt_info->device, dev_port,
     // &fp_port);
     if (status == SWITCH_STATUS_SUCCESS) {
-      pktdriver_ctx->rx_port_pkts[fp_port].count++;
-      pktdriver_ctx->rx_port_bytes[fp_port].count += pkt_info->pkt_size;
+      SWITCH_PKTDRIVER_COUNTER_ADD(pktdriver_ctx->rx_port_pkts[fp_port].count,
+                                   1);
+      SWITCH_PKTDRIVER_COUNTER_ADD(
+          pktdriver_ctx->rx_port_bytes[fp_port].count,
+          (uint64_t)pkt_info->pkt_size);
     }
   }
 
@@ -2238,7 +2775,7 @@ switch_status_t switch_pktdriver_rx(switch_packet_info_t *pkt_info) {
               rx_key.reason_code);
           return status;
         }
-        rx_info->num_packets++;
+        SWITCH_PKTDRIVER_COUNTER_ADD(rx_info->num_packets, 1);
         break;
       case SWITCH_PKTDRIVER_CHANNEL_TYPE_CB_AND_NETDEV:
       case SWITCH_PKTDRIVER_CHANNEL_TYPE_FD:
@@ -2271,8 +2808,8 @@ switch_status_t switch_pktdriver_rx(switch_packet_info_t *pkt_info) {
               rx_key.reason_code);
           return status;
         }
-        rx_info->num_packets++;
-        pktdriver_ctx->num_rx_netdev_packets++;
+        SWITCH_PKTDRIVER_COUNTER_ADD(rx_info->num_packets, 1);
+        SWITCH_PKTDRIVER_COUNTER_ADD(pktdriver_ctx->num_rx_netdev_packets, 1);
         break;
       case SWITCH_PKTDRIVER_CHANNEL_TYPE_CB:
         if (pktdriver_ctx->rx_cb_internal) {
@@ -2281,101 +2818,150 @@ switch_status_t switch_pktdriver_rx(switch_packet_info_t *pkt_info) {
               pkt_info->pkt_size,
               pktdriver_ctx->dev_port_to_port_handle_map[dev_port],
               rx_info->rx_action.hostif_trap_handle);
-          pktdriver_ctx->num_rx_cb_packets++;
+          SWITCH_PKTDRIVER_COUNTER_ADD(pktdriver_ctx->num_rx_cb_packets, 1);
         }
-        rx_info->num_packets++;
+        SWITCH_PKTDRIVER_COUNTER_ADD(rx_info->num_packets, 1);
         break;
       default:
         break;
     }
   }
 
-  pktdriver_ctx->num_rx_packets++;
+  SWITCH_PKTDRIVER_COUNTER_ADD(pktdriver_ctx->num_rx_packets, 1);
 
   return status;
 }
 
-switch_status_t switch_pktdriver_knet_cpu_rx(switch_fd_t knet_fd) {
-  switch_packet_info_t pkt_info;
-  switch_int8_t in_packet[SWITCH_PACKET_MAX_BUFFER_SIZE];
-  switch_int32_t pkt_size = 0;
-  switch_status_t status = SWITCH_STATUS_SUCCESS;
-
-  pkt_size = switch_fd_read(knet_fd, in_packet, sizeof(in_packet));
-  if (pkt_size <= 0) {
-    status = SWITCH_STATUS_FAILURE;
-    SWITCH_PKT_ERROR("packet knet cpu rx failed: packet size < 0\n");
-    return status;
-  }
+static inline uint64_t switch_pktdriver_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
 
-  SWITCH_MEMSET(&pkt_info, 0x0, sizeof(pkt_info));
-  pkt_info.pkt_type = SWITCH_PKTDRIVER_PACKET_TYPE_RX_CPU_KNET;
-  pkt_info.pkt = in_packet;
-  pkt_info.pkt_size = pkt_size;
+/* Accounts one packet handed off by a packet driver queue */
+static inline void switch_pktdriver_io_rx_account(uint64_t wakeup_ns) {
+  uint64_t latency_ns = switch_pktdriver_now_ns() - wakeup_ns;
 
-  status = switch_pktdriver_rx(&pkt_info);
-  return status;
+  SWITCH_PKTDRIVER_COUNTER_ADD(pktdriver_ctx->num_io_rx_packets, 1);
+  SWITCH_PKTDRIVER_COUNTER_ADD(pktdriver_ctx->io_rx_latency_total_ns,
+                               latency_ns);
+  switch_pktdriver_counter_max(&pktdriver_ctx->io_rx_latency_max_ns,
+                               latency_ns);
 }
 
-switch_status_t switch_pktdriver_cpu_eth_rx(switch_fd_t cpu_fd) {
+/*
+ * Drains up to SWITCH_PKTDRIVER_RX_BATCH_SIZE packets from the cpu or knet
+ * socket with a single recvmmsg into the rx pool of the queue.
+ */
+static switch_status_t switch_pktdriver_sock_rx(
+    switch_pktdriver_queue_t *queue,
+    switch_fd_t fd,
+    switch_pktdriver_packet_type_t pkt_type,
+    uint64_t wakeup_ns) {
+  struct mmsghdr msgs[SWITCH_PKTDRIVER_RX_BATCH_SIZE];
+  struct iovec iovs[SWITCH_PKTDRIVER_RX_BATCH_SIZE];
   switch_packet_info_t pkt_info;
-  switch_int8_t in_packet[SWITCH_PACKET_MAX_BUFFER_SIZE];
-  switch_int32_t pkt_size = 0;
+  switch_int32_t num_pkts = 0;
   switch_status_t status = SWITCH_STATUS_SUCCESS;
+  switch_status_t tmp_status = SWITCH_STATUS_SUCCESS;
 
-  if (!pktdriver_ctx) return SWITCH_STATUS_FAILURE;
-
-  SWITCH_ASSERT(pktdriver_ctx->cpu_fd == cpu_fd);
+  SWITCH_MEMSET(msgs, 0x0, sizeof(msgs));
+  for (int i = 0; i < SWITCH_PKTDRIVER_RX_BATCH_SIZE; i++) {
+    iovs[i].iov_base = queue->rx_pool + i * SWITCH_PACKET_MAX_BUFFER_SIZE;
+    iovs[i].iov_len = SWITCH_PACKET_MAX_BUFFER_SIZE;
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
 
-  pkt_size = switch_fd_read(cpu_fd, in_packet, sizeof(in_packet));
-  if (pkt_size <= 0) {
-    status = SWITCH_STATUS_FAILURE;
-    SWITCH_PKT_ERROR("packet cpu eth rx failed: packet size < 0\n");
-    return status;
+  num_pkts = recvmmsg(
+      fd, msgs, SWITCH_PKTDRIVER_RX_BATCH_SIZE, MSG_DONTWAIT, NULL);
+  if (num_pkts < 0) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK) return status;
+    SWITCH_PKT_ERROR("packet rx failed on fd %d: %s\n", fd, strerror(errno));
+    return SWITCH_STATUS_FAILURE;
   }
+  SWITCH_PKTDRIVER_COUNTER_ADD(pktdriver_ctx->num_io_rx_batches, 1);
 
-  SWITCH_MEMSET(&pkt_info, 0x0, sizeof(pkt_info));
-  pkt_info.pkt_type = SWITCH_PKTDRIVER_PACKET_TYPE_RX_CPU_ETH;
-  pkt_info.pkt = in_packet;
-  pkt_info.pkt_size = pkt_size;
+  for (int i = 0; i < num_pkts; i++) {
+    if (msgs[i].msg_len == 0) continue;
+
+    SWITCH_MEMSET(&pkt_info, 0x0, sizeof(pkt_info));
+    pkt_info.pkt_type = pkt_type;
+    pkt_info.pkt = iovs[i].iov_base;
+    pkt_info.pkt_size = msgs[i].msg_len;
+
+    tmp_status = switch_pktdriver_rx(&pkt_info);
+    if (tmp_status != SWITCH_STATUS_SUCCESS) status = tmp_status;
+    switch_pktdriver_io_rx_account(wakeup_ns);
+  }
 
-  status = switch_pktdriver_rx(&pkt_info);
   return status;
 }
 
-switch_status_t switch_pktdriver_netdev_tx(switch_fd_t hostif_fd) {
+/*
+ * Drains up to SWITCH_PKTDRIVER_TX_BATCH_SIZE packets from one tun queue of a
+ * hostif. With a cpu socket the frames are staged on the queue and go out in
+ * one sendmmsg, otherwise each one is sent on its own.
+ */
+static switch_status_t switch_pktdriver_netdev_tx(
+    switch_pktdriver_queue_t *queue,
+    switch_fd_t fd,
+    switch_fd_t hostif_fd,
+    uint64_t wakeup_ns) {
   switch_packet_info_t pkt_info;
   switch_status_t status = SWITCH_STATUS_SUCCESS;
+  switch_status_t tmp_status = SWITCH_STATUS_SUCCESS;
   switch_int32_t pkt_size = 0;
-  switch_int8_t in_packet[SWITCH_PACKET_MAX_BUFFER_SIZE];
+  switch_int32_t num_pkts = 0;
+  bool batch = !pktdriver_ctx->use_pcie && !pktdriver_ctx->knet_pkt_driver &&
+               pktdriver_ctx->cpu_fd != SWITCH_FD_INVALID;
 
   SWITCH_ASSERT(hostif_fd != SWITCH_FD_INVALID);
 
-  pkt_size = switch_fd_read(hostif_fd, in_packet, sizeof(in_packet));
-  if (pkt_size <= 0) {
-    status = SWITCH_STATUS_INVALID_PARAMETER;
-    SWITCH_PKT_ERROR(
-        "pktdriver netdev tx failed for fd %d: "
-        "pkt size is less than 0:(%s)\n",
-        hostif_fd,
-        switch_error_to_string(status));
-    return status;
-  }
+  for (; num_pkts < SWITCH_PKTDRIVER_TX_BATCH_SIZE; num_pkts++) {
+    pkt_size =
+        switch_fd_read(fd, queue->rx_pool, SWITCH_PACKET_MAX_BUFFER_SIZE);
+    if (pkt_size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+    if (pkt_size <= 0) {
+      status = SWITCH_STATUS_INVALID_PARAMETER;
+      SWITCH_PKT_ERROR(
+          "pktdriver netdev tx failed for fd %d: "
+          "pkt size is less than 0:(%s)\n",
+          hostif_fd,
+          switch_error_to_string(status));
+      break;
+    }
 
-  SWITCH_MEMSET(&pkt_info, 0x0, sizeof(pkt_info));
-  pkt_info.fd = hostif_fd;
-  pkt_info.pkt = in_packet;
-  pkt_info.pkt_size = pkt_size;
-  pkt_info.pkt_type = SWITCH_PKTDRIVER_PACKET_TYPE_TX_NETDEV;
+    SWITCH_MEMSET(&pkt_info, 0x0, sizeof(pkt_info));
+    pkt_info.fd = hostif_fd;
+    pkt_info.pkt = queue->rx_pool;
+    pkt_info.pkt_size = pkt_size;
+    pkt_info.pkt_type = SWITCH_PKTDRIVER_PACKET_TYPE_TX_NETDEV;
 
-  status = switch_pktdriver_tx(&pkt_info);
-  if (status != SWITCH_STATUS_SUCCESS) {
-    SWITCH_PKT_WARN(
-        "pktdriver netdev tx failed for fd %d: "
-        "pktdriver cpu tx failed:(%s)\n",
-        hostif_fd,
-        switch_error_to_string(status));
-    return status;
+    if (batch) {
+      if (queue->num_tx == SWITCH_PKTDRIVER_TX_BATCH_SIZE) {
+        switch_pktdriver_tx_flush(queue);
+      }
+      tmp_status = switch_pktdriver_tx_encap(
+          &pkt_info,
+          queue->tx_pool + queue->num_tx * SWITCH_PKTDRIVER_TX_BUFFER_SIZE,
+          &queue->tx_size[queue->num_tx]);
+      if (tmp_status == SWITCH_STATUS_SUCCESS) queue->num_tx++;
+    } else {
+      tmp_status = switch_pktdriver_tx(&pkt_info);
+    }
+    switch_pktdriver_io_rx_account(wakeup_ns);
+    if (tmp_status != SWITCH_STATUS_SUCCESS) {
+      status = tmp_status;
+      SWITCH_PKT_WARN(
+          "pktdriver netdev tx failed for fd %d: "
+          "pktdriver cpu tx failed:(%s)\n",
+          hostif_fd,
+          switch_error_to_string(status));
+    }
+  }
+  if (num_pkts) {
+    SWITCH_PKTDRIVER_COUNTER_ADD(pktdriver_ctx->num_io_rx_batches, 1);
   }
 
   return status;
@@ -2401,18 +2987,37 @@ switch_status_t switch_pkt_xmit(char *pkt, int pkt_size) {
   return status;
 }
 
-switch_status_t switch_pktdriver_fd_add(const switch_device_t device,
-                                        const switch_fd_t fd) {
+static switch_status_t switch_pktdriver_queue_fd_add(
+    const switch_device_t device,
+    switch_pktdriver_queue_t *queue,
+    const switch_fd_t fd,
+    const switch_fd_t hostif_fd) {
   switch_status_t status = SWITCH_STATUS_SUCCESS;
 
   if (!pktdriver_ctx) return SWITCH_STATUS_FAILURE;
 
   SWITCH_ASSERT(fd != SWITCH_FD_INVALID);
 
-  pthread_mutex_lock(&fd_mutex);
+  pthread_rwlock_wrlock(&fd_lock);
   status = SWITCH_ARRAY_INSERT(
-      &pktdriver_ctx->fd_array, fd, (void *)((uintptr_t)fd));
-  pthread_mutex_unlock(&fd_mutex);
+      &pktdriver_ctx->fd_array, fd, (void *)((uintptr_t)hostif_fd));
+  if (status == SWITCH_STATUS_SUCCESS) {
+    /* the queue worker picks the fd up on its next epoll_wait */
+    struct epoll_event event;
+    SWITCH_MEMSET(&event, 0x0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(queue->epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0 &&
+        errno != EEXIST) {
+      SWITCH_PKT_ERROR("packet fd add failed on device %d fd 0x%x: %s\n",
+                       device,
+                       fd,
+                       strerror(errno));
+      SWITCH_ARRAY_DELETE(&pktdriver_ctx->fd_array, fd);
+      status = SWITCH_STATUS_FAILURE;
+    }
+  }
+  pthread_rwlock_unlock(&fd_lock);
   if (status != SWITCH_STATUS_SUCCESS) {
     SWITCH_PKT_ERROR(
         "packet fd add failed on device %d fd 0x%x: "
@@ -2423,17 +3028,17 @@ switch_status_t switch_pktdriver_fd_add(const switch_device_t device,
     return status;
   }
 
-  status = pktdriver_cmd_send(PKTDRV_CMD_WAKE);
-  if (status != SWITCH_STATUS_SUCCESS) {
-    SWITCH_PKT_DEBUG("notifying bf_switch_pkdrv thread failed %d fd 0x%x: %s",
-                     device,
-                     fd,
-                     switch_error_to_string(status));
-  }
-
   return SWITCH_STATUS_SUCCESS;
 }
 
+switch_status_t switch_pktdriver_fd_add(const switch_device_t device,
+                                        const switch_fd_t fd) {
+  if (!pktdriver_ctx || !pktdriver_ctx->queues) return SWITCH_STATUS_FAILURE;
+
+  return switch_pktdriver_queue_fd_add(
+      device, &pktdriver_ctx->queues[0], fd, fd);
+}
+
 switch_status_t switch_pktdriver_fd_delete(const switch_device_t device,
                                            const switch_fd_t fd) {
   switch_status_t status = SWITCH_STATUS_SUCCESS;
@@ -2442,9 +3047,20 @@ switch_status_t switch_pktdriver_fd_delete(const switch_device_t device,
 
   SWITCH_ASSERT(fd != SWITCH_FD_INVALID);
 
-  pthread_mutex_lock(&fd_mutex);
+  pthread_rwlock_wrlock(&fd_lock);
   status = SWITCH_ARRAY_DELETE(&pktdriver_ctx->fd_array, fd);
-  pthread_mutex_unlock(&fd_mutex);
+  /* a closed fd has already left the epoll set */
+  for (int q = 0; q < pktdriver_ctx->num_queues; q++) {
+    if (epoll_ctl(pktdriver_ctx->queues[q].epoll_fd, EPOLL_CTL_DEL, fd, NULL) <
+            0 &&
+        errno != EBADF && errno != ENOENT) {
+      SWITCH_PKT_DEBUG("packet fd epoll delete failed %d fd 0x%x: %s",
+                       device,
+                       fd,
+                       strerror(errno));
+    }
+  }
+  pthread_rwlock_unlock(&fd_lock);
   if (status != SWITCH_STATUS_SUCCESS) {
     SWITCH_PKT_ERROR(
         "packet fd delete failed on device %d fd 0x%x: "
@@ -2455,53 +3071,9 @@ switch_status_t switch_pktdriver_fd_delete(const switch_device_t device,
     return status;
   }
 
-  status = pktdriver_cmd_send(PKTDRV_CMD_WAKE);
-  if (status != SWITCH_STATUS_SUCCESS) {
-    SWITCH_PKT_DEBUG("notifying bf_switch_pkdrv thread failed %d fd 0x%x: %s",
-                     device,
-                     fd,
-                     switch_error_to_string(status));
-  }
-
   return SWITCH_STATUS_SUCCESS;
 }
 
-switch_status_t switch_packet_driver_fd_update(switch_fd_set *read_fds,
-                                               switch_int32_t *nfds) {
-  switch_fd_t hostif_fd = 0;
-  switch_fd_t *hostif_tmp_fd = NULL;
-  switch_status_t status = SWITCH_STATUS_SUCCESS;
-  switch_int32_t high_fd = 0;
-
-  if (!pktdriver_ctx) return SWITCH_STATUS_FAILURE;
-
-  SWITCH_ASSERT(read_fds != NULL);
-  SWITCH_ASSERT(nfds != NULL);
-  if (!read_fds || !nfds) {
-    status = SWITCH_STATUS_INVALID_PARAMETER;
-    SWITCH_PKT_ERROR("packet fd update failed %s",
-                     switch_error_to_string(status));
-    return status;
-  }
-
-  *nfds = 0;
-  FD_ZERO(read_fds);
-
-  pthread_mutex_lock(&fd_mutex);
-  FOR_EACH_IN_ARRAY(
-      hostif_fd, pktdriver_ctx->fd_array, switch_fd_t, hostif_tmp_fd) {
-    UNUSED(hostif_tmp_fd);
-
-    FD_SET(hostif_fd, read_fds);
-    high_fd = (high_fd > hostif_fd) ? high_fd : hostif_fd;
-  }
-  FOR_EACH_IN_ARRAY_END();
-  pthread_mutex_unlock(&fd_mutex);
-
-  *nfds = high_fd + 1;
-  return status;
-}
-
 static inline int is_knet_fd(switch_fd_t fd) {
   if (!pktdriver_ctx) return SWITCH_STATUS_FAILURE;
 
@@ -2511,110 +3083,125 @@ static inline int is_knet_fd(switch_fd_t fd) {
   return 0;
 }
 
-switch_status_t switch_packet_demux(switch_fd_set *read_fds) {
-  if (!pktdriver_ctx) return SWITCH_STATUS_FAILURE;
-
-  switch_fd_t *tmp_fd = NULL;
-  switch_fd_t fd = 0;
+static switch_status_t switch_packet_demux(switch_pktdriver_queue_t *queue,
+                                           switch_fd_t fd,
+                                           uint64_t wakeup_ns) {
+  void *hostif_fd = NULL;
   switch_status_t status = SWITCH_STATUS_SUCCESS;
 
-  SWITCH_ASSERT(read_fds != NULL);
-  if (!read_fds) {
-    status = SWITCH_STATUS_INVALID_PARAMETER;
-    SWITCH_PKT_ERROR("packet demux failed: %s", switch_error_to_string(status));
+  if (!pktdriver_ctx) return SWITCH_STATUS_FAILURE;
+
+  pthread_rwlock_rdlock(&fd_lock);
+  /* the fd may have been deleted after epoll_wait returned */
+  if (SWITCH_ARRAY_GET(&pktdriver_ctx->fd_array, fd, &hostif_fd) !=
+      SWITCH_STATUS_SUCCESS) {
+    pthread_rwlock_unlock(&fd_lock);
     return status;
   }
 
-  pthread_mutex_lock(&fd_mutex);
-  FOR_EACH_IN_ARRAY(fd, pktdriver_ctx->fd_array, switch_fd_t, tmp_fd) {
-    UNUSED(tmp_fd);
-
-    if (pktdriver_ctx->cpu_fd == fd &&
-        FD_ISSET(pktdriver_ctx->cpu_fd, read_fds)) {
-      status = switch_pktdriver_cpu_eth_rx(pktdriver_ctx->cpu_fd);
-      if (status != SWITCH_STATUS_SUCCESS) {
-        SWITCH_PKT_ERROR("packet demux failed from cpu fd 0x%d: %s\n",
-                         pktdriver_ctx->cpu_fd,
-                         switch_error_to_string(status));
-        pthread_mutex_unlock(&fd_mutex);
-        return status;
-      }
-    } else if (is_knet_fd(fd) && FD_ISSET(fd, read_fds)) {
-      status = switch_pktdriver_knet_cpu_rx(fd);
-      if (status != SWITCH_STATUS_SUCCESS) {
-        SWITCH_PKT_ERROR("packet demux failed from knet cpu fd %d: %s\n",
-                         fd,
-                         switch_error_to_string(status));
-        pthread_mutex_unlock(&fd_mutex);
-        return status;
-      }
-    } else if (FD_ISSET(fd, read_fds)) {
-      status = switch_pktdriver_netdev_tx(fd);
-      if (status != SWITCH_STATUS_SUCCESS) {
-        SWITCH_PKT_WARN("packet demux failed from fd %d: %s\n",
-                        fd,
-                        switch_error_to_string(status));
-        pthread_mutex_unlock(&fd_mutex);
-        return status;
-      }
+  if (queue->cpu_fd == fd) {
+    status = switch_pktdriver_sock_rx(
+        queue, fd, SWITCH_PKTDRIVER_PACKET_TYPE_RX_CPU_ETH, wakeup_ns);
+    if (status != SWITCH_STATUS_SUCCESS) {
+      SWITCH_PKT_ERROR("packet demux failed from cpu fd 0x%d: %s\n",
+                       fd,
+                       switch_error_to_string(status));
+    }
+  } else if (is_knet_fd(fd)) {
+    status = switch_pktdriver_sock_rx(
+        queue, fd, SWITCH_PKTDRIVER_PACKET_TYPE_RX_CPU_KNET, wakeup_ns);
+    if (status != SWITCH_STATUS_SUCCESS) {
+      SWITCH_PKT_ERROR("packet demux failed from knet cpu fd %d: %s\n",
+                       fd,
+                       switch_error_to_string(status));
+    }
+  } else {
+    status = switch_pktdriver_netdev_tx(
+        queue, fd, (switch_fd_t)(uintptr_t)hostif_fd, wakeup_ns);
+    if (status != SWITCH_STATUS_SUCCESS) {
+      SWITCH_PKT_WARN("packet demux failed from fd %d: %s\n",
+                      fd,
+                      switch_error_to_string(status));
     }
   }
-  FOR_EACH_IN_ARRAY_END();
-  pthread_mutex_unlock(&fd_mutex);
+  pthread_rwlock_unlock(&fd_lock);
 
   return status;
 }
 
+/*
+ * Worker of one packet driver queue. Queue 0 also serves the knet socket and
+ * the fds added with switch_pktdriver_fd_add, and updates the rx rate.
+ */
 static void *switch_packet_driver(void *args) {
-  UNUSED(args);
-  switch_fd_set read_fds;
-  switch_int32_t num_fd = 0;
-  switch_int32_t rc = 0;
-  switch_status_t status = SWITCH_STATUS_SUCCESS;
-  pthread_mutex_lock(&cookie_mutex);
-  cookie = 1;
-  pthread_cond_signal(&cookie_cv);
-  pthread_mutex_unlock(&cookie_mutex);
+  switch_pktdriver_queue_t *queue = (switch_pktdriver_queue_t *)args;
+  struct epoll_event events[SWITCH_PKTDRIVER_MAX_EVENTS];
+  switch_int32_t num_events = 0;
+  uint64_t wakeup_ns = 0;
+  uint64_t rx_pkts = 0;
+  uint64_t pps_start_ns = switch_pktdriver_now_ns();
+  uint64_t pps_start_pkts =
+      SWITCH_PKTDRIVER_COUNTER_GET(pktdriver_ctx->num_io_rx_packets);
+
+  if (queue->id == 0) {
+    pthread_mutex_lock(&cookie_mutex);
+    cookie = 1;
+    pthread_cond_signal(&cookie_cv);
+    pthread_mutex_unlock(&cookie_mutex);
+  }
 
   while (true) {
-    char cmd = PKTDRV_CMD_NONE;
-
-    status = switch_packet_driver_fd_update(&read_fds, &num_fd);
-    if (status != SWITCH_STATUS_SUCCESS) {
-      SWITCH_PKT_ERROR("packet driver fd update failed: %s",
-                       switch_error_to_string(status));
+    num_events = epoll_wait(queue->epoll_fd,
+                            events,
+                            SWITCH_PKTDRIVER_MAX_EVENTS,
+                            SWITCH_PKTDRIVER_PPS_INTERVAL_MS);
+    if (num_events < 0) {
+      if (errno == EINTR) continue;
+      SWITCH_PKT_ERROR("packet driver epoll wait failed: %s", strerror(errno));
       goto cleanup;
     }
 
-    if (!num_fd) {
-      continue;
+    wakeup_ns = switch_pktdriver_now_ns();
+    if (num_events > 0) {
+      SWITCH_PKTDRIVER_COUNTER_ADD(pktdriver_ctx->num_io_wakeups, 1);
     }
 
-    rc = switch_select(num_fd, &read_fds, NULL, NULL, NULL);
-    if (rc < 0) {
-      SWITCH_PKT_ERROR("packet driver select failed: %s",
-                       switch_error_to_string(status));
-      goto cleanup;
-    }
+    for (int i = 0; i < num_events; i++) {
+      switch_fd_t fd = events[i].data.fd;
 
-    if (rc == 0) {
-      SWITCH_PKT_DEBUG("packet driver without fds. ignoring");
-      continue;
-    }
+      if (fd == pktdriver_ctx->pipe_fd[0]) {
+        /* one exit command per queue, another queue may have taken it */
+        char cmd = PKTDRV_CMD_NONE;
+        pktdriver_cmd_recv(&cmd);
+        if (cmd == PKTDRV_CMD_EXIT) {
+          SWITCH_PKT_DEBUG("packet driver queue %d exit", queue->id);
+          goto cleanup;
+        }
+        continue;
+      }
 
-    if (FD_ISSET(pktdriver_ctx->pipe_fd[0], &read_fds)) {
-      FD_CLR(pktdriver_ctx->pipe_fd[0], &read_fds);
-      pktdriver_cmd_recv(&cmd);
-      if (cmd == PKTDRV_CMD_EXIT) {
-        SWITCH_PKT_DEBUG("packet driver exit");
-        goto cleanup;
+      switch_packet_demux(queue, fd, wakeup_ns);
+    }
+    switch_pktdriver_tx_flush(queue);
+
+    if (queue->id == 0 && wakeup_ns - pps_start_ns >=
+                              SWITCH_PKTDRIVER_PPS_INTERVAL_MS * 1000000ULL) {
+      rx_pkts = SWITCH_PKTDRIVER_COUNTER_GET(pktdriver_ctx->num_io_rx_packets);
+      /* counters cleared since the last update */
+      if (rx_pkts < pps_start_pkts) {
+        pps_start_pkts = 0;
       }
+      SWITCH_PKTDRIVER_COUNTER_SET(
+          pktdriver_ctx->io_rx_pps,
+          (rx_pkts - pps_start_pkts) * 1000000000ULL /
+              (wakeup_ns - pps_start_ns));
+      pps_start_ns = wakeup_ns;
+      pps_start_pkts = rx_pkts;
     }
-
-    switch_packet_demux(&read_fds);
   }
 
 cleanup:
+  switch_pktdriver_tx_flush(queue);
   return NULL;
 }
 
@@ -2718,6 +3305,7 @@ switch_status_t switch_pktdriver_rx_filter_create(
     const switch_pktdriver_rx_filter_action_t *rx_action,
     uint64_t *filter_id) {
   switch_pktdriver_rx_filter_info_t *rx_info = NULL;
+  switch_pktdriver_filter_match_t match;
   switch_status_t status = SWITCH_STATUS_SUCCESS;
 
   if (!pktdriver_ctx) return SWITCH_STATUS_FAILURE;
@@ -2762,25 +3350,26 @@ switch_status_t switch_pktdriver_rx_filter_create(
   SWITCH_MEMCPY(&rx_info->rx_action, rx_action, sizeof(*rx_action));
   rx_info->flags = flags;
   rx_info->priority = priority;
-
-  status =
-      SWITCH_LIST_INSERT(&pktdriver_ctx->rx_filter, &rx_info->node, rx_info);
-  if (status != SWITCH_STATUS_SUCCESS) {
-    SWITCH_PKT_ERROR(
-        "pktdriver rx filter create failed on device %d: "
-        "rx filter list insert failed:(%s)\n",
-        device,
-        switch_error_to_string(status));
-    SWITCH_FREE(rx_info);
-    return status;
+  rx_info->entry.rank = priority;
+  rx_info->entry.info = rx_info;
+
+  switch_packet_driver_rx_filter_match_get(
+      flags, rx_key->reason_code_mask, rx_key, &match);
+  pthread_rwlock_wrlock(&fd_lock);
+  status = switch_packet_driver_classifier_insert(&pktdriver_ctx->rx_filter,
+                                                  flags,
+                                                  rx_key->reason_code_mask,
+                                                  &match,
+                                                  &rx_info->entry);
+  if (status == SWITCH_STATUS_SUCCESS &&
+      rx_action->channel_type == SWITCH_PKTDRIVER_CHANNEL_TYPE_NETDEV) {
+    pktdriver_ctx->dev_port_to_fd_map[rx_key->dev_port] = rx_action->fd;
   }
-
-  status = SWITCH_LIST_SORT(&pktdriver_ctx->rx_filter,
-                            switch_packet_driver_rx_filter_priority_compare);
+  pthread_rwlock_unlock(&fd_lock);
   if (status != SWITCH_STATUS_SUCCESS) {
     SWITCH_PKT_ERROR(
         "pktdriver rx filter create failed on device %d: "
-        "rx filter sort failed:(%s)\n",
+        "rx filter insert failed:(%s)\n",
         device,
         switch_error_to_string(status));
     SWITCH_FREE(rx_info);
@@ -2789,10 +3378,6 @@ switch_status_t switch_pktdriver_rx_filter_create(
 
   *filter_id = (uintptr_t)rx_info;
 
-  if (rx_action->channel_type == SWITCH_PKTDRIVER_CHANNEL_TYPE_NETDEV) {
-    pktdriver_ctx->dev_port_to_fd_map[rx_key->dev_port] = rx_action->fd;
-  }
-
   SWITCH_PKT_DEBUG(
       "packet driver rx filter created on device %d "
       "handle 0x%" PRIx64 "\n",
@@ -2836,6 +3421,7 @@ switch_status_t switch_pktdriver_rx_filter_delete(
     return status;
   }
 
+  pthread_rwlock_wrlock(&fd_lock);
   if (rx_info->rx_action.channel_type == SWITCH_PKTDRIVER_CHANNEL_TYPE_NETDEV) {
     pktdriver_ctx->dev_port_to_fd_map[rx_key->dev_port] = -1;
   }
@@ -2852,15 +3438,9 @@ switch_status_t switch_pktdriver_rx_filter_delete(
   }
 #endif
 
-  status = SWITCH_LIST_DELETE(&pktdriver_ctx->rx_filter, &rx_info->node);
-  if (status != SWITCH_STATUS_SUCCESS) {
-    SWITCH_PKT_ERROR(
-        "packet driver rx filter delete failed on device %d "
-        "rx filter list delete failed:(%s)\n",
-        device,
-        switch_error_to_string(status));
-    return status;
-  }
+  switch_packet_driver_classifier_remove(&pktdriver_ctx->rx_filter,
+                                         &rx_info->entry);
+  pthread_rwlock_unlock(&fd_lock);
 
   SWITCH_PKT_DEBUG("packet driver rx filter deleted on device %d ", device);
   SWITCH_FREE(rx_info);
@@ -2876,7 +3456,7 @@ switch_status_t switch_pktdriver_rx_filter_num_packets_get(
   if (!pktdriver_ctx) return SWITCH_STATUS_FAILURE;
 
   rx_info = (switch_pktdriver_rx_filter_info_t *)((uintptr_t)filter_id);
-  if (rx_info) *counter = rx_info->num_packets;
+  if (rx_info) *counter = SWITCH_PKTDRIVER_COUNTER_GET(rx_info->num_packets);
 
   return status;
 }
@@ -2890,7 +3470,7 @@ switch_status_t switch_pktdriver_rx_filter_num_packets_clear(
   if (!pktdriver_ctx) return SWITCH_STATUS_FAILURE;
 
   rx_info = (switch_pktdriver_rx_filter_info_t *)((uintptr_t)filter_id);
-  if (rx_info) rx_info->num_packets = 0;
+  if (rx_info) SWITCH_PKTDRIVER_COUNTER_SET(rx_info->num_packets, 0);
 
   return status;
 }
@@ -2980,6 +3560,7 @@ switch_status_t switch_pktdriver_tx_filter_create(
     const switch_pktdriver_tx_filter_action_t *tx_action,
     switch_handle_t *tx_filter_handle) {
   switch_pktdriver_tx_filter_info_t *tx_info = NULL;
+  switch_pktdriver_filter_match_t match;
   switch_status_t status = SWITCH_STATUS_SUCCESS;
 
   if (!pktdriver_ctx) return SWITCH_STATUS_FAILURE;
@@ -3025,34 +3606,27 @@ switch_status_t switch_pktdriver_tx_filter_create(
   SWITCH_MEMSET(tx_info, 0, sizeof(switch_pktdriver_tx_filter_info_t));
   SWITCH_MEMCPY(&tx_info->tx_key, tx_key, sizeof(*tx_key));
   SWITCH_MEMCPY(&tx_info->tx_action, tx_action, sizeof(*tx_action));
-
-  status =
-      SWITCH_LIST_INSERT(&pktdriver_ctx->tx_filter, &tx_info->node, tx_info);
-  if (status != SWITCH_STATUS_SUCCESS) {
-    SWITCH_PKT_ERROR(
-        "pktdriver tx filter create failed on device %d: "
-        "tx filter list insert failed:(%s)\n",
-        device,
-        switch_error_to_string(status));
-    SWITCH_FREE(tx_info);
-    return status;
-  }
-
-  status = SWITCH_LIST_SORT(&pktdriver_ctx->tx_filter,
-                            switch_packet_driver_tx_filter_priority_compare);
+  tx_info->flags = flags;
+  tx_info->priority = priority;
+  /* lower tx priority values are matched first */
+  tx_info->entry.rank = -(switch_int32_t)priority;
+  tx_info->entry.info = tx_info;
+
+  switch_packet_driver_tx_filter_match_get(flags, 0, tx_key, &match);
+  pthread_rwlock_wrlock(&fd_lock);
+  status = switch_packet_driver_classifier_insert(
+      &pktdriver_ctx->tx_filter, flags, 0, &match, &tx_info->entry);
+  pthread_rwlock_unlock(&fd_lock);
   if (status != SWITCH_STATUS_SUCCESS) {
     SWITCH_PKT_ERROR(
         "pktdriver tx filter create failed on device %d: "
-        "tx filter sort failed:(%s)\n",
+        "tx filter insert failed:(%s)\n",
         device,
         switch_error_to_string(status));
     SWITCH_FREE(tx_info);
     return status;
   }
 
-  tx_info->flags = flags;
-  tx_info->priority = priority;
-
   *tx_filter_handle = (uintptr_t)tx_info;
   SWITCH_PKT_DEBUG("packet driver tx filter created on device %d ", device);
 
@@ -3104,15 +3678,10 @@ switch_status_t switch_pktdriver_tx_filter_delete(
   }
 #endif
 
-  status = SWITCH_LIST_DELETE(&pktdriver_ctx->tx_filter, &tx_info->node);
-  if (status != SWITCH_STATUS_SUCCESS) {
-    SWITCH_PKT_ERROR(
-        "packet driver tx filter delete failed on device %d "
-        "tx filter list delete failed:(%s)\n",
-        device,
-        switch_error_to_string(status));
-    return status;
-  }
+  pthread_rwlock_wrlock(&fd_lock);
+  switch_packet_driver_classifier_remove(&pktdriver_ctx->tx_filter,
+                                         &tx_info->entry);
+  pthread_rwlock_unlock(&fd_lock);
 
   SWITCH_PKT_DEBUG(
       "packet driver tx filter deleted on device %d "
@@ -3133,7 +3702,7 @@ switch_status_t switch_pktdriver_tx_filter_num_packets_get(
   if (!pktdriver_ctx) return SWITCH_STATUS_FAILURE;
 
   tx_info = (switch_pktdriver_tx_filter_info_t *)((uintptr_t)filter_id);
-  if (tx_info) *counter = tx_info->num_packets;
+  if (tx_info) *counter = SWITCH_PKTDRIVER_COUNTER_GET(tx_info->num_packets);
 
   return status;
 }
@@ -3147,11 +3716,47 @@ switch_status_t switch_pktdriver_tx_filter_num_packets_clear(
   if (!pktdriver_ctx) return SWITCH_STATUS_FAILURE;
 
   tx_info = (switch_pktdriver_tx_filter_info_t *)((uintptr_t)filter_id);
-  if (tx_info) tx_info->num_packets = 0;
+  if (tx_info) SWITCH_PKTDRIVER_COUNTER_SET(tx_info->num_packets, 0);
 
   return status;
 }
 
+switch_status_t switch_pktdriver_io_stats_get(
+    switch_pktdriver_io_stats_t *io_stats) {
+  if (!pktdriver_ctx || !io_stats) return SWITCH_STATUS_FAILURE;
+
+  SWITCH_MEMSET(io_stats, 0x0, sizeof(*io_stats));
+  io_stats->rx_pkts =
+      SWITCH_PKTDRIVER_COUNTER_GET(pktdriver_ctx->num_io_rx_packets);
+  io_stats->rx_batches =
+      SWITCH_PKTDRIVER_COUNTER_GET(pktdriver_ctx->num_io_rx_batches);
+  io_stats->wakeups =
+      SWITCH_PKTDRIVER_COUNTER_GET(pktdriver_ctx->num_io_wakeups);
+  io_stats->rx_pps = SWITCH_PKTDRIVER_COUNTER_GET(pktdriver_ctx->io_rx_pps);
+  if (io_stats->rx_pkts) {
+    io_stats->rx_latency_avg_ns =
+        SWITCH_PKTDRIVER_COUNTER_GET(pktdriver_ctx->io_rx_latency_total_ns) /
+        io_stats->rx_pkts;
+  }
+  io_stats->rx_latency_max_ns =
+      SWITCH_PKTDRIVER_COUNTER_GET(pktdriver_ctx->io_rx_latency_max_ns);
+  io_stats->tx_waits =
+      SWITCH_PKTDRIVER_COUNTER_GET(pktdriver_ctx->num_io_tx_waits);
+  return SWITCH_STATUS_SUCCESS;
+}
+
+switch_status_t switch_pktdriver_io_stats_clear(void) {
+  if (!pktdriver_ctx) return SWITCH_STATUS_FAILURE;
+
+  SWITCH_PKTDRIVER_COUNTER_SET(pktdriver_ctx->num_io_rx_packets, 0);
+  SWITCH_PKTDRIVER_COUNTER_SET(pktdriver_ctx->num_io_rx_batches, 0);
+  SWITCH_PKTDRIVER_COUNTER_SET(pktdriver_ctx->num_io_wakeups, 0);
+  SWITCH_PKTDRIVER_COUNTER_SET(pktdriver_ctx->io_rx_latency_total_ns, 0);
+  SWITCH_PKTDRIVER_COUNTER_SET(pktdriver_ctx->io_rx_latency_max_ns, 0);
+  SWITCH_PKTDRIVER_COUNTER_SET(pktdriver_ctx->num_io_tx_waits, 0);
+  return SWITCH_STATUS_SUCCESS;
+}
+
 switch_status_t switch_pktdriver_reason_code_stats_get(
     const switch_device_t device,
     const uint16_t reason_code,
@@ -3161,30 +3766,34 @@ switch_status_t switch_pktdriver_reason_code_stats_get(
   switch_status_t status = SWITCH_STATUS_SUCCESS;
   if (!pktdriver_ctx) return SWITCH_STATUS_FAILURE;
 
-  *pkts = pktdriver_ctx->rx_rc_pkts[reason_code].count;
-  *bytes = pktdriver_ctx->rx_rc_bytes[reason_code].count;
+  *pkts = SWITCH_PKTDRIVER_COUNTER_GET(
+      pktdriver_ctx->rx_rc_pkts[reason_code].count);
+  *bytes = SWITCH_PKTDRIVER_COUNTER_GET(
+      pktdriver_ctx->rx_rc_bytes[reason_code].count);
   return status;
 }
 
 switch_status_t switch_pktdriver_reason_code_stats_clear(
     const switch_device_t device, const uint16_t reason_code) {
   UNUSED(device);
-  pktdriver_ctx->rx_rc_pkts[reason_code].count = 0;
-  pktdriver_ctx->rx_rc_bytes[reason_code].count = 0;
+  SWITCH_PKTDRIVER_COUNTER_SET(pktdriver_ctx->rx_rc_pkts[reason_code].count, 0);
+  SWITCH_PKTDRIVER_COUNTER_SET(pktdriver_ctx->rx_rc_bytes[reason_code].count,
+                               0);
   return SWITCH_STATUS_SUCCESS;
 }
 
 switch_status_t switch_pktdriver_reason_code_pkts_clear(
     const switch_device_t device, const uint16_t reason_code) {
   UNUSED(device);
-  pktdriver_ctx->rx_rc_pkts[reason_code].count = 0;
+  SWITCH_PKTDRIVER_COUNTER_SET(pktdriver_ctx->rx_rc_pkts[reason_code].count, 0);
   return SWITCH_STATUS_SUCCESS;
 }
 
 switch_status_t switch_pktdriver_reason_code_bytes_clear(
     const switch_device_t device, const uint16_t reason_code) {
   UNUSED(device);
-  pktdriver_ctx->rx_rc_bytes[reason_code].count = 0;
+  SWITCH_PKTDRIVER_COUNTER_SET(pktdriver_ctx->rx_rc_bytes[reason_code].count,
+                               0);
   return SWITCH_STATUS_SUCCESS;
 }
 
@@ -3230,7 +3839,9 @@ bf_status_t switch_pktdriver_cpu_pcie_rx(bf_dev_id_t device,
   pkt_info.pkt = in_packet;
   pkt_info.pkt_size = packet_size;
 
+  pthread_rwlock_rdlock(&fd_lock);
   status = switch_pktdriver_rx(&pkt_info);
+  pthread_rwlock_unlock(&fd_lock);
   if (status != SWITCH_STATUS_SUCCESS) {
     SWITCH_PKT_ERROR(
         "%s.%d: pktdriver cpu pcie rx failed: "
@@ -3282,6 +3893,29 @@ static void switch_pktdriver_callback_deregister(switch_device_t device) {
 #endif
 }
 
+/*
+ * Stops the workers of queues [first, last). Each worker consumes one exit
+ * command, and they are only joined if every command could be queued.
+ */
+static void switch_pktdriver_queues_stop(switch_int32_t first,
+                                         switch_int32_t last) {
+  switch_status_t status = SWITCH_STATUS_SUCCESS;
+
+  for (int q = first; q < last; q++) {
+    if (pktdriver_cmd_send(PKTDRV_CMD_EXIT) != SWITCH_STATUS_SUCCESS) {
+      status = SWITCH_STATUS_FAILURE;
+    }
+  }
+  if (status != SWITCH_STATUS_SUCCESS) {
+    SWITCH_PKT_ERROR("packet driver exit command failed");
+    return;
+  }
+
+  for (int q = first; q < last; q++) {
+    pthread_join(pktdriver_ctx->queues[q].thread, NULL);
+  }
+}
+
 switch_status_t start_bf_switch_api_packet_driver(void) {
   if (!pktdriver_ctx) return SWITCH_STATUS_FAILURE;
   if (!pktdriver_ctx->use_kpkt && pktdriver_ctx->use_pcie) {
@@ -3294,12 +3928,35 @@ switch_status_t start_bf_switch_api_packet_driver(void) {
       return SWITCH_STATUS_FAILURE;
     }
   }
+  for (int q = 1; q < pktdriver_ctx->num_queues; q++) {
+    switch_pktdriver_queue_t *queue = &pktdriver_ctx->queues[q];
+    char thread_name[16];
+
+    int status =
+        pthread_create(&queue->thread, NULL, switch_packet_driver, queue);
+    if (status) {
+      SWITCH_PKT_ERROR("packet driver queue %d start failed: %s",
+                       q,
+                       strerror(status));
+      switch_pktdriver_queues_stop(1, q);
+      return status;
+    }
+    snprintf(
+        thread_name, sizeof(thread_name), "bf_switch_pk%hhu", (uint8_t)q);
+    pthread_setname_np(queue->thread, thread_name);
+  }
+
   pthread_mutex_init(&cookie_mutex, NULL);
   pthread_cond_init(&cookie_cv, NULL);
-  int status =
-      pthread_create(&packet_driver_thread, NULL, switch_packet_driver, NULL);
-  if (status) return status;
-  pthread_setname_np(packet_driver_thread, "bf_switch_pkdrv");
+  int status = pthread_create(&pktdriver_ctx->queues[0].thread,
+                              NULL,
+                              switch_packet_driver,
+                              &pktdriver_ctx->queues[0]);
+  if (status) {
+    switch_pktdriver_queues_stop(1, pktdriver_ctx->num_queues);
+    return status;
+  }
+  pthread_setname_np(pktdriver_ctx->queues[0].thread, "bf_switch_pkdrv");
   pthread_mutex_lock(&cookie_mutex);
   while (!cookie) {
     pthread_cond_wait(&cookie_cv, &cookie_mutex);
@@ -3312,11 +3969,9 @@ switch_status_t start_bf_switch_api_packet_driver(void) {
 
 switch_status_t stop_bf_switch_api_packet_driver(void) {
   switch_knet_info_t *knet_info = NULL;
-  switch_status_t status = pktdriver_cmd_send(PKTDRV_CMD_EXIT);
+  switch_status_t status = SWITCH_STATUS_SUCCESS;
 
-  if (status == SWITCH_STATUS_SUCCESS) {
-    pthread_join(packet_driver_thread, NULL);
-  }
+  switch_pktdriver_queues_stop(0, pktdriver_ctx->num_queues);
 
   if (pktdriver_ctx->knet_pkt_driver) {
     knet_info = &pktdriver_ctx->switch_kern_info;
@@ -3405,48 +4060,7 @@ switch_status_t switch_pktdriver_cpu_pkt_noalloc_tx(switch_device_t device,
     }
     // return failure;
   } else {
-    struct sockaddr_ll addr;
-    SWITCH_MEMSET(&addr, 0x0, sizeof(addr));
-    addr.sll_ifindex = pktdriver_ctx->cpu_ifindex;
-
-    for (int retry = 2; retry > 0; retry--) {
-      fd_set write_set;
-      struct timeval timeout;
-
-      /* Initialize the file descriptor set. */
-      FD_ZERO(&write_set);
-      FD_SET(pktdriver_ctx->cpu_fd, &write_set);
-
-      /* Initialize the timeout data structure. */
-      timeout.tv_sec = 1;
-      timeout.tv_usec = 0;
-
-      /* select returns 0 if timeout, 1 if input available, -1 if error. */
-      rc = select(FD_SETSIZE, NULL, &write_set, NULL, &timeout);
-      if (rc < 0) {
-        SWITCH_PKT_ERROR("cpu tx select failed: %s", strerror(errno));
-        continue;
-      }
-
-      if (!FD_ISSET((pktdriver_ctx->cpu_fd), &write_set)) {
-        SWITCH_PKT_DEBUG(
-            "pktdriver cp tx failed: cpu_fd is not ready to write\n");
-        continue;
-      }
-
-      rc = switch_fd_send(pktdriver_ctx->cpu_fd,
-                          out_packet,
-                          pkt_size,
-                          0x0,
-                          (struct sockaddr *)&addr,
-                          sizeof(addr));
-      if (rc >= 0) {
-        break;
-      }
-
-      SWITCH_PKT_ERROR("pktdriver cpu tx failed: errno=%s\n", strerror(errno));
-      return SWITCH_STATUS_FAILURE;
-    }
+    status = switch_pktdriver_cpu_sock_send(out_packet, pkt_size);
   }
 
   return status;
@@ -3470,7 +4084,7 @@ switch_status_t switch_pktdriver_pkt_tx(switch_packet_info_t *pkt_info) {
 
   if (!pktdriver_ctx) return SWITCH_STATUS_FAILURE;
 
-  pktdriver_ctx->num_tx_cb_packets++;
+  SWITCH_PKTDRIVER_COUNTER_ADD(pktdriver_ctx->num_tx_cb_packets, 1);
   SWITCH_PKTINFO_PACKET_TYPE(pkt_info) = SWITCH_FABRIC_HEADER_TYPE_CPU;
   SWITCH_PKTINFO_ETHER_TYPE(pkt_info) = SWITCH_FABRIC_HEADER_ETHTYPE;
 
@@ -3501,7 +4115,7 @@ switch_status_t switch_pktdriver_pkt_tx(switch_packet_info_t *pkt_info) {
     return status;
   }
 
-  pktdriver_ctx->num_tx_packets++;
+  SWITCH_PKTDRIVER_COUNTER_ADD(pktdriver_ctx->num_tx_packets, 1);
 
   return status;
 }
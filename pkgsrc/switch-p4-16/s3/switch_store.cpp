@@ -55,6 +55,12 @@ using ::smi::logging::switch_log;
 using ::smi::logging::logging_init;
 #ifndef TESTING
 using ::smi::bf_rt::switch_bf_rt_flush;
+using ::smi::bf_rt::async_write_scope;
+#else
+/* no backend in unit tests, nothing to tag */
+struct async_write_scope {
+  explicit async_write_scope(const switch_object_id_t) {}
+};
 #endif
 
 #define __NS__ "switch_store"
@@ -2738,7 +2744,7 @@ switch_status_t object_replay(bool warm_init) {
   if (!warm_init) return status;
 
   switch_log(SWITCH_API_LEVEL_WARN, SWITCH_OT_NONE, "Begin Object replay");
-  const db::db_store *object_attr_hash = db::get_db();
+  const db::db_shards *object_attr_hash = db::get_db();
   if (object_attr_hash == nullptr) {
     switch_log(SWITCH_API_LEVEL_ERROR,
                SWITCH_OT_NONE,
@@ -2757,9 +2763,7 @@ switch_status_t object_replay(bool warm_init) {
 
   switch_log(
       SWITCH_API_LEVEL_WARN, SWITCH_OT_NONE, "Begin Object replay stage 1");
-  for (auto it = object_attr_hash->begin(); it != object_attr_hash->end();
-       it++) {
-    switch_object_id_t object = it->first;
+  for (const auto object : db::get_object_ids()) {
     const ObjectInfo *object_info =
         model_info->get_object_info(switch_store::object_type_query(object));
     status = switch_store::object_replay_stage_1(
@@ -2861,7 +2865,7 @@ switch_status_t object_backup_stats_cache() {
     return SWITCH_STATUS_FAILURE;
   }
 
-  const db::db_store *object_attr_hash = db::get_db();
+  const db::db_shards *object_attr_hash = db::get_db();
   if (object_attr_hash == nullptr) {
     switch_log(SWITCH_API_LEVEL_ERROR,
                SWITCH_OT_NONE,
@@ -2878,9 +2882,7 @@ switch_status_t object_backup_stats_cache() {
       __func__,
       __LINE__);
 
-  for (auto it = object_attr_hash->begin(); it != object_attr_hash->end();
-       it++) {
-    switch_object_id_t object_id = it->first;
+  for (const auto object_id : db::get_object_ids()) {
     switch_object_type_t object_type =
         switch_store::object_type_query(object_id);
     const ObjectInfo *obj_info = model->get_object_info(object_type);
@@ -2946,7 +2948,7 @@ switch_status_t object_restore_stats_cache(bool warm_init) {
     return SWITCH_STATUS_SUCCESS;
   }
 
-  const db::db_store *object_attr_hash = db::get_db();
+  const db::db_shards *object_attr_hash = db::get_db();
   if (object_attr_hash == nullptr) {
     switch_log(SWITCH_API_LEVEL_ERROR,
                SWITCH_OT_NONE,
@@ -2964,9 +2966,7 @@ switch_status_t object_restore_stats_cache(bool warm_init) {
              __func__,
              __LINE__);
 
-  for (auto it = object_attr_hash->begin(); it != object_attr_hash->end();
-       it++) {
-    switch_object_id_t object_id = it->first;
+  for (const auto object_id : db::get_object_ids()) {
     switch_object_type_t object_type =
         switch_store::object_type_query(object_id);
     const ObjectInfo *obj_info = model->get_object_info(object_type);
@@ -3365,7 +3365,10 @@ switch_status_t object_create(const switch_object_type_t object_type,
     goto fail;
   }
 
-  status = object_create_internal(object_type, attrs, object_id);
+  {
+    async_write_scope async_write(object_id);
+    status = object_create_internal(object_type, attrs, object_id);
+  }
   if (status != SWITCH_STATUS_SUCCESS) {
     switch_log(SWITCH_API_LEVEL_ERROR,
                object_type,
@@ -3450,7 +3453,10 @@ switch_status_t object_create_by_id(const switch_object_type_t object_type,
     goto fail;
   }
 
-  status = object_create_internal(object_type, attrs, object_id);
+  {
+    async_write_scope async_write(object_id);
+    status = object_create_internal(object_type, attrs, object_id);
+  }
   if (status != SWITCH_STATUS_SUCCESS) {
     switch_log(SWITCH_API_LEVEL_ERROR,
                object_type,
@@ -3519,7 +3525,10 @@ switch_status_t object_create_by_hdl(const switch_object_type_t object_type,
     return SWITCH_STATUS_INVALID_PARAMETER;
   }
 
-  status = object_create_internal(object_type, attrs, object_id);
+  {
+    async_write_scope async_write(object_id);
+    status = object_create_internal(object_type, attrs, object_id);
+  }
   if (status != SWITCH_STATUS_SUCCESS) {
     switch_log(SWITCH_API_LEVEL_ERROR,
                object_type,
@@ -3717,6 +3726,7 @@ switch_status_t object_delete(switch_object_id_t object_id) {
   bool comment_mode;
 
   db::object_lock(object_id);
+  async_write_scope async_write(object_id);
 
   if (!object_type_valid(object_type)) {
     status = SWITCH_STATUS_INVALID_PARAMETER;
@@ -4288,6 +4298,7 @@ switch_status_t attribute_set(switch_object_id_t object_id,
                attr.id_get());
     return SWITCH_STATUS_INVALID_PARAMETER;
   }
+  async_write_scope async_write(object_id);
 
   const std::vector<KeyGroup> &key_groups = object_info->get_key_groups();
   bool attr_in_key_group = false;
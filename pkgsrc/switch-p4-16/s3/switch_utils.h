@@ -262,6 +262,45 @@ typedef enum switch_pktdriver_packet_type_s {
   SWITCH_PKTDRIVER_PACKET_TYPE_RX_CPU_KNET = 5,
 } switch_pktdriver_packet_type_t;
 
+/** classifier entry of an rx or tx filter */
+typedef struct switch_pktdriver_filter_entry_s {
+  /** higher rank wins, ties go to the most recently added filter */
+  switch_int32_t rank;
+
+  /** insertion order */
+  uint64_t seq;
+
+  /** owning rx or tx filter info */
+  void *info;
+
+  /** bucket holding the entry */
+  void *bucket;
+
+  /** bucket list node */
+  switch_node_t node;
+} switch_pktdriver_filter_entry_t;
+
+/** filter key with the fields outside the filter flags zeroed */
+typedef struct switch_pktdriver_filter_match_s {
+  uint32_t field[4];
+} switch_pktdriver_filter_match_t;
+
+/**
+ * Tuple space classifier. Filters are grouped into classes by their flags and
+ * reason code mask, and each class hashes its filters on the masked key, so a
+ * lookup costs one hash probe per class instead of a scan of every filter.
+ */
+typedef struct switch_pktdriver_classifier_s {
+  /** classes, in descending order of the best rank they may hold */
+  tommy_list classes;
+
+  /** insertion counter */
+  uint64_t next_seq;
+
+  /** number of filters */
+  switch_size_t num_filters;
+} switch_pktdriver_classifier_t;
+
 typedef struct switch_pktdriver_rx_filter_info_s {
   /** rx filter key */
   switch_pktdriver_rx_filter_key_t rx_key;
@@ -278,8 +317,8 @@ typedef struct switch_pktdriver_rx_filter_info_s {
   /** rx filter flags */
   uint64_t flags;
 
-  /** list node */
-  switch_node_t node;
+  /** classifier entry */
+  switch_pktdriver_filter_entry_t entry;
 } switch_pktdriver_rx_filter_info_t;
 
 typedef struct switch_pktdriver_tx_filter_info_s {
@@ -298,10 +337,18 @@ typedef struct switch_pktdriver_tx_filter_info_s {
   /** tx filter flags */
   uint64_t flags;
 
-  /** list node */
-  switch_node_t node;
+  /** classifier entry */
+  switch_pktdriver_filter_entry_t entry;
 } switch_pktdriver_tx_filter_info_t;
 
+switch_status_t switch_pktdriver_rx_filter_info_get(
+    switch_pktdriver_rx_filter_key_t *rx_key,
+    switch_pktdriver_rx_filter_info_t **rx_info);
+
+switch_status_t switch_pktdriver_tx_filter_info_get(
+    switch_pktdriver_tx_filter_key_t *tx_key,
+    switch_pktdriver_tx_filter_info_t **tx_info);
+
 /** cpu timestamp header */
 typedef struct PACKED switch_cpu_timestamp_header_s {
   /** Arrival Time */
@@ -411,13 +458,38 @@ typedef struct switch_pktdriver_context_s {
   /** dummy pipe fd */
   switch_fd_t pipe_fd[2];
 
+  /** packet driver fds, each mapped to the hostif fd that owns it */
   switch_array_t fd_array;
 
-  /** list of tx filters */
-  switch_list_t tx_filter;
+  /** extra tun queue fds by hostif fd */
+  switch_array_t hostif_queue_array;
+
+  /** packet driver queues, each served by its own worker thread */
+  struct switch_pktdriver_queue_s *queues;
+  switch_int32_t num_queues;
+
+  /** packets and reads done by the packet driver queues */
+  uint64_t num_io_rx_packets;
+  uint64_t num_io_rx_batches;
+
+  /** packet driver worker wakeups */
+  uint64_t num_io_wakeups;
+
+  /** rx packets per second over the last second */
+  uint64_t io_rx_pps;
+
+  /** per packet handling time in the packet driver queues */
+  uint64_t io_rx_latency_total_ns;
+  uint64_t io_rx_latency_max_ns;
+
+  /** cpu port transmits that waited for socket buffer space */
+  uint64_t num_io_tx_waits;
+
+  /** tx filters */
+  switch_pktdriver_classifier_t tx_filter;
 
-  /** list of rx filters */
-  switch_list_t rx_filter;
+  /** rx filters */
+  switch_pktdriver_classifier_t rx_filter;
 
   /** total rx packets */
   uint64_t num_rx_packets;
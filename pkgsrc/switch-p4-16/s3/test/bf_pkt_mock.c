@@ -50,7 +50,8 @@ int bf_pkt_tx(bf_dev_id_t dev_id,
               bf_pkt_tx_ring_t tx_ring,
               void *tx_cookie) {
   pkt_tx_passthrough(dev_id, pkt, tx_ring, tx_cookie);
-  tx_count++;
+  // called from every packet driver queue
+  __atomic_fetch_add(&tx_count, 1, __ATOMIC_RELAXED);
   return 0;
 }
 
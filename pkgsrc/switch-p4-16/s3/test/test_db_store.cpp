@@ -17,9 +17,14 @@
  *  SPDX-License-Identifier: Apache-2.0
  ******************************************************************************/
 
+#include <malloc.h>
+#include <unistd.h>
+
 #include <cassert>
 #include <iostream>
 #include <chrono>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
 
 #include "time.h"
 #include "../store.h"
@@ -40,11 +45,113 @@ uint64_t iter = 1000000;
 
 void test_store(const std::vector<switch_object_id_t> &oids,
                 const ObjectInfo *object_info) {
+  size_t heap_before = mallinfo2().uordblks;
   auto start = high_resolution_clock::now();
   for (const auto &oid : oids) db::object_create(oid, object_info);
   auto end = high_resolution_clock::now();
+  size_t heap_after = mallinfo2().uordblks;
   auto duration = duration_cast<microseconds>(end - start);
   std::cout << "Time: " << duration.count() << std::endl;
+  std::cout << "Bytes per object: " << (heap_after - heap_before) / oids.size()
+            << std::endl;
+}
+
+/* value_get/value_set on the first, middle and last attribute of the object */
+void test_value_get_set(const std::vector<switch_object_id_t> &oids,
+                        const ObjectInfo *object_info) {
+  const auto &attr_md_list = object_info->get_attribute_list();
+  const std::vector<switch_attr_id_t> attr_ids = {
+      attr_md_list.front().attr_id,
+      attr_md_list[attr_md_list.size() / 2].attr_id,
+      attr_md_list.back().attr_id};
+  for (const auto attr_id : attr_ids) {
+    switch_attribute_value_t value = {};
+    auto start = high_resolution_clock::now();
+    for (const auto &oid : oids) {
+      switch_status_t status = db::value_get(oid, attr_id, 0, value);
+      assert(status == SWITCH_STATUS_SUCCESS);
+      (void)status;
+    }
+    auto end = high_resolution_clock::now();
+    auto get_time = duration_cast<microseconds>(end - start);
+
+    start = high_resolution_clock::now();
+    for (const auto &oid : oids) {
+      switch_status_t status = db::value_set(oid, attr_id, 0, value);
+      assert(status == SWITCH_STATUS_SUCCESS);
+      (void)status;
+    }
+    end = high_resolution_clock::now();
+    auto set_time = duration_cast<microseconds>(end - start);
+    std::cout << "Attr: " << attr_id << " get: " << get_time.count()
+              << " set: " << set_time.count() << std::endl;
+  }
+}
+
+/* Same amount of lookups spread over more threads */
+void test_store_contention(const std::vector<switch_object_id_t> &oids,
+                           const ObjectInfo *object_info) {
+  const switch_attr_id_t attr_id =
+      object_info->get_attribute_list().front().attr_id;
+  for (size_t threads = 1; threads <= 8; threads *= 2) {
+    std::vector<std::thread> workers;
+    size_t reads = oids.size() / threads;
+    auto start = high_resolution_clock::now();
+    for (size_t t = 0; t < threads; t++) {
+      workers.emplace_back([&, t]() {
+        switch_attribute_value_t value = {};
+        for (size_t i = t * reads; i < (t + 1) * reads; i++) {
+          switch_status_t status = db::value_get(oids[i], attr_id, 0, value);
+          assert(status == SWITCH_STATUS_SUCCESS);
+          (void)status;
+        }
+      });
+    }
+    for (auto &worker : workers) worker.join();
+    auto end = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(end - start);
+    std::cout << "Threads: " << threads << " Time: " << duration.count()
+              << std::endl;
+  }
+}
+
+/* Warm init from the binary snapshot and from the text dump */
+void test_warm_restore(const std::vector<switch_object_id_t> &oids,
+                       const ObjectInfo *object_info,
+                       const char *const test_model_name) {
+  const char *const dump_file = "/tmp/db_store.txt";
+  // the dump needs typed values
+  for (const auto &attr_md : object_info->get_attribute_list()) {
+    switch_attribute_value_t value = {};
+    value.type = attr_md.type;
+    for (const auto &oid : oids) db::value_set(oid, attr_md.attr_id, 0, value);
+  }
+
+  const std::vector<switch_object_id_t> create_order = db::get_creation_list();
+  auto start = high_resolution_clock::now();
+  switch_store::object_info_dump(dump_file);
+  auto end = high_resolution_clock::now();
+  // writing the snapshot must not disturb the live create order
+  assert(db::get_creation_list() == create_order);
+  std::cout << "Dump time: "
+            << duration_cast<microseconds>(end - start).count() << std::endl;
+
+  switch_store::object_info_clean();
+  start = high_resolution_clock::now();
+  switch_store::object_info_init(test_model_name, true, dump_file);
+  end = high_resolution_clock::now();
+  std::cout << "Snapshot restore time: "
+            << duration_cast<microseconds>(end - start).count() << std::endl;
+
+  std::string snapshot_file = std::string(dump_file) + DB_SNAPSHOT_SUFFIX;
+  unlink(snapshot_file.c_str());
+  switch_store::object_info_clean();
+  start = high_resolution_clock::now();
+  switch_store::object_info_init(test_model_name, true, dump_file);
+  end = high_resolution_clock::now();
+  std::cout << "Text restore time: "
+            << duration_cast<microseconds>(end - start).count() << std::endl;
+  unlink(dump_file);
 }
 
 int main(void) {
@@ -73,6 +180,9 @@ int main(void) {
 #endif
 
   test_store(oids, object_info);
+  test_value_get_set(oids, object_info);
+  test_store_contention(oids, object_info);
+  test_warm_restore(oids, object_info, test_model_name);
 
 #ifdef __CPU_PROFILER__
   ProfilerStop();
@@ -0,0 +1,294 @@
+/*******************************************************************************
+ *  Copyright (C) 2024 Intel Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing,
+ *  software distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions
+ *  and limitations under the License.
+ *
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include <inttypes.h>
+#include "bf_switch/bf_switch_types.h"
+#include "../switch_lpm_int.h"
+
+#define MAX_KEY_BYTES 16
+
+typedef struct test_prefix_s {
+  uint8_t prefix[MAX_KEY_BYTES];
+  size_t len;
+  value_t value;
+  bool valid;
+} test_prefix_t;
+
+static uint64_t time_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static bool prefix_match(const uint8_t *prefix,
+                         size_t len,
+                         const uint8_t *key) {
+  size_t bytes = len / 8, bits = len % 8;
+  if (memcmp(prefix, key, bytes)) return false;
+  if (bits == 0) return true;
+  uint8_t mask = (uint8_t)(0xFF << (8 - bits));
+  return (prefix[bytes] & mask) == (key[bytes] & mask);
+}
+
+// longest prefix match by linear scan
+static switch_status_t reference_lookup(const test_prefix_t *prefixes,
+                                        size_t num_prefixes,
+                                        const uint8_t *key,
+                                        value_t *value) {
+  const test_prefix_t *best = NULL;
+  for (size_t i = 0; i < num_prefixes; i++) {
+    if (!prefixes[i].valid) continue;
+    if (best && prefixes[i].len <= best->len) continue;
+    if (prefix_match(prefixes[i].prefix, prefixes[i].len, key))
+      best = &prefixes[i];
+  }
+  if (!best) return SWITCH_STATUS_ITEM_NOT_FOUND;
+  *value = best->value;
+  return SWITCH_STATUS_SUCCESS;
+}
+
+// random prefixes clustered under a few first bytes so they overlap
+static void random_prefix(test_prefix_t *p, size_t key_bytes) {
+  for (size_t i = 0; i < key_bytes; i++) p->prefix[i] = rand() & 0xFF;
+  p->prefix[0] = rand() & 0x3;
+  p->len = rand() % (key_bytes * 8 + 1);
+  for (size_t i = p->len; i < key_bytes * 8; i++)
+    p->prefix[i / 8] &= (uint8_t) ~(0x80 >> (i % 8));
+  p->valid = true;
+}
+
+static void check_lookups(const switch_lpm_trie_t *trie,
+                          const test_prefix_t *prefixes,
+                          size_t num_prefixes,
+                          size_t key_bytes) {
+  for (int n = 0; n < 20000; n++) {
+    uint8_t key[MAX_KEY_BYTES];
+    value_t value = 0, expected = 0;
+    if (n % 2) {
+      // a key under one of the prefixes
+      const test_prefix_t *p = &prefixes[rand() % num_prefixes];
+      for (size_t i = 0; i < key_bytes; i++) key[i] = rand() & 0xFF;
+      memcpy(key, p->prefix, p->len / 8);
+      if (p->len % 8) {
+        uint8_t mask = (uint8_t)(0xFF << (8 - p->len % 8));
+        key[p->len / 8] =
+            (p->prefix[p->len / 8] & mask) | (key[p->len / 8] & ~mask);
+      }
+    } else {
+      for (size_t i = 0; i < key_bytes; i++) key[i] = rand() & 0xFF;
+      key[0] &= 0x3;
+    }
+    switch_status_t status = switch_lpm_trie_lookup(trie, key, &value);
+    switch_status_t ref_status =
+        reference_lookup(prefixes, num_prefixes, key, &expected);
+    assert(status == ref_status);
+    if (status == SWITCH_STATUS_SUCCESS) assert(value == expected);
+  }
+}
+
+void test_lpm_trie(size_t key_bytes) {
+  printf("%s %zu\n", __func__, key_bytes);
+  const size_t num_prefixes = 3000;
+  test_prefix_t *prefixes = calloc(num_prefixes, sizeof(test_prefix_t));
+  switch_lpm_trie_t *trie = NULL;
+  size_t num_valid = 0;
+
+  switch_status_t status = switch_lpm_trie_create(key_bytes, true, &trie);
+  assert(status == SWITCH_STATUS_SUCCESS);
+  for (size_t i = 0; i < num_prefixes; i++) {
+    test_prefix_t *p = &prefixes[i];
+    random_prefix(p, key_bytes);
+    p->value = i;
+    bool duplicate = false;
+    for (size_t j = 0; j < i; j++) {
+      if (prefixes[j].valid && prefixes[j].len == p->len &&
+          !memcmp(prefixes[j].prefix, p->prefix, key_bytes)) {
+        // the insert replaces the value of the earlier prefix
+        prefixes[j].valid = false;
+        duplicate = true;
+      }
+    }
+    status = switch_lpm_trie_insert(trie, p->prefix, p->len, p->value);
+    assert(status == SWITCH_STATUS_SUCCESS);
+    if (!duplicate) num_valid++;
+    assert(switch_lpm_trie_has_prefix(trie, p->prefix, p->len));
+  }
+  assert(switch_lpm_trie_size(trie) == num_valid);
+  check_lookups(trie, prefixes, num_prefixes, key_bytes);
+
+  // delete half the prefixes, the tree shrinks back as nodes empty
+  for (size_t i = 0; i < num_prefixes; i += 2) {
+    test_prefix_t *p = &prefixes[i];
+    if (!p->valid) continue;
+    status = switch_lpm_trie_delete(trie, p->prefix, p->len);
+    assert(status == SWITCH_STATUS_SUCCESS);
+    assert(!switch_lpm_trie_has_prefix(trie, p->prefix, p->len));
+    status = switch_lpm_trie_delete(trie, p->prefix, p->len);
+    assert(status == SWITCH_STATUS_FAILURE);
+    p->valid = false;
+    num_valid--;
+  }
+  assert(switch_lpm_trie_size(trie) == num_valid);
+  check_lookups(trie, prefixes, num_prefixes, key_bytes);
+
+  // bulk load the deleted ones back
+  switch_lpm_trie_entry_t *entries =
+      calloc(num_prefixes, sizeof(switch_lpm_trie_entry_t));
+  size_t num_entries = 0;
+  for (size_t i = 0; i < num_prefixes; i += 2) {
+    test_prefix_t *p = &prefixes[i];
+    bool present = false;
+    for (size_t j = 0; j < num_prefixes; j++) {
+      if (prefixes[j].valid && prefixes[j].len == p->len &&
+          !memcmp(prefixes[j].prefix, p->prefix, key_bytes))
+        present = true;
+    }
+    if (present) continue;
+    entries[num_entries].prefix = p->prefix;
+    entries[num_entries].prefix_length = p->len;
+    entries[num_entries].value = p->value;
+    num_entries++;
+    p->valid = true;
+    num_valid++;
+  }
+  status = switch_lpm_trie_bulk_insert(trie, entries, num_entries);
+  assert(status == SWITCH_STATUS_SUCCESS);
+  assert(switch_lpm_trie_size(trie) == num_valid);
+  check_lookups(trie, prefixes, num_prefixes, key_bytes);
+
+  // prefixes longer than the key are rejected
+  status =
+      switch_lpm_trie_insert(trie, prefixes[0].prefix, key_bytes * 8 + 1, 0);
+  assert(status == SWITCH_STATUS_INVALID_PARAMETER);
+
+  // delete all, only the root is left
+  for (size_t i = 0; i < num_prefixes; i++) {
+    if (!prefixes[i].valid) continue;
+    status = switch_lpm_trie_delete(trie, prefixes[i].prefix, prefixes[i].len);
+    assert(status == SWITCH_STATUS_SUCCESS);
+  }
+  assert(switch_lpm_trie_size(trie) == 0);
+  assert(trie->root->children == NULL && trie->root->prefixes == NULL);
+
+  status = switch_lpm_trie_destroy(trie);
+  assert(status == SWITCH_STATUS_SUCCESS);
+  free(entries);
+  free(prefixes);
+}
+
+// route table scale, mostly /24 with some shorter and host routes
+void test_lpm_trie_scale() {
+  printf("%s\n", __func__);
+  const uint32_t num_routes = 1000000;
+  const uint32_t num_lookups = 4000000;
+  uint8_t(*keys)[4] = malloc(num_routes * sizeof(*keys));
+  switch_lpm_trie_entry_t *entries =
+      malloc(num_routes * sizeof(switch_lpm_trie_entry_t));
+  switch_lpm_trie_t *trie = NULL;
+  switch_status_t status = SWITCH_STATUS_SUCCESS;
+  uint64_t start = 0, found = 0;
+
+  for (uint32_t i = 0; i < num_routes; i++) {
+    uint32_t addr = (10U << 24) + (i << 8);
+    size_t len = 24;
+    if (i % 16 == 0) len = 20;
+    if (i % 16 == 1) {
+      addr |= i & 0xFF;
+      len = 32;
+    }
+    keys[i][0] = addr >> 24;
+    keys[i][1] = addr >> 16;
+    keys[i][2] = addr >> 8;
+    keys[i][3] = addr;
+    entries[i].prefix = keys[i];
+    entries[i].prefix_length = len;
+    entries[i].value = i + 1;
+  }
+
+  status = switch_lpm_trie_create(4, true, &trie);
+  assert(status == SWITCH_STATUS_SUCCESS);
+  start = time_ns();
+  for (uint32_t i = 0; i < num_routes; i++) {
+    status = switch_lpm_trie_insert(
+        trie, entries[i].prefix, entries[i].prefix_length, entries[i].value);
+    assert(status == SWITCH_STATUS_SUCCESS);
+  }
+  printf("%u route inserts: %" PRIu64 " us\n",
+         num_routes,
+         (time_ns() - start) / 1000);
+  switch_lpm_trie_destroy(trie);
+
+  status = switch_lpm_trie_create(4, true, &trie);
+  assert(status == SWITCH_STATUS_SUCCESS);
+  start = time_ns();
+  status = switch_lpm_trie_bulk_insert(trie, entries, num_routes);
+  assert(status == SWITCH_STATUS_SUCCESS);
+  printf("%u route bulk insert: %" PRIu64 " us\n",
+         num_routes,
+         (time_ns() - start) / 1000);
+  assert(switch_lpm_trie_size(trie) == num_routes);
+
+  start = time_ns();
+  for (uint32_t i = 0; i < num_lookups; i++) {
+    uint8_t key[4];
+    uint32_t addr = (10U << 24) + (((i * 2654435761U) % num_routes) << 8) +
+                    (i & 0xFF);
+    key[0] = addr >> 24;
+    key[1] = addr >> 16;
+    key[2] = addr >> 8;
+    key[3] = addr;
+    value_t value = 0;
+    if (switch_lpm_trie_lookup(trie, key, &value) == SWITCH_STATUS_SUCCESS)
+      found++;
+  }
+  printf("%u route lookups over %u routes: %" PRIu64 " us\n",
+         num_lookups,
+         num_routes,
+         (time_ns() - start) / 1000);
+  assert(found == num_lookups);
+
+  start = time_ns();
+  for (uint32_t i = 0; i < num_routes; i++) {
+    status = switch_lpm_trie_delete(
+        trie, entries[i].prefix, entries[i].prefix_length);
+    assert(status == SWITCH_STATUS_SUCCESS);
+  }
+  printf("%u route deletes: %" PRIu64 " us\n",
+         num_routes,
+         (time_ns() - start) / 1000);
+
+  switch_lpm_trie_destroy(trie);
+  free(entries);
+  free(keys);
+}
+
+int main(void) {
+  srand(1);
+  test_lpm_trie(4);
+  test_lpm_trie(16);
+  test_lpm_trie_scale();
+
+  printf("\n\nAll tests passed!\n");
+  return 0;
+}
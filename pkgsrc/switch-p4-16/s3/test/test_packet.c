@@ -20,6 +20,7 @@
 #include <stdio.h>
 #include <assert.h>
 #include <time.h>
+#include <inttypes.h>
 #include "bf_switch/bf_switch_types.h"
 #include "s3/switch_packet.h"
 #include "../switch_utils.h"
@@ -90,6 +91,139 @@ void test_rx_filter() {
   assert(status == SWITCH_STATUS_SUCCESS);
 }
 
+static uint64_t time_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// classifier lookups with one filter per bd, plus overlapping trap filters
+void test_rx_filter_scale() {
+  printf("%s\n", __func__);
+  switch_status_t status = SWITCH_STATUS_SUCCESS;
+  const uint32_t num_filters = 10000;
+  const uint32_t num_lookups = 1000000;
+  static uint64_t filter_ids[10000];
+  uint64_t trap_id = 0, port_id = 0, dup_id = 0;
+  switch_pktdriver_rx_filter_key_t rx_key = {};
+  switch_pktdriver_rx_filter_action_t rx_action = {};
+  switch_pktdriver_rx_filter_info_t *rx_info = NULL;
+  uint64_t start = 0;
+
+  rx_action.channel_type = SWITCH_PKTDRIVER_CHANNEL_TYPE_CB;
+  start = time_ns();
+  for (uint32_t i = 0; i < num_filters; i++) {
+    rx_key.bd = i + 1;
+    status = switch_pktdriver_rx_filter_create(
+        device,
+        SWITCH_PKTDRIVER_RX_FILTER_PRIORITY_VLAN,
+        SWITCH_PKTDRIVER_RX_FILTER_ATTR_BD,
+        &rx_key,
+        &rx_action,
+        &filter_ids[i]);
+    assert(status == SWITCH_STATUS_SUCCESS);
+  }
+  printf("%u rx filter adds: %" PRIu64 " us\n",
+         num_filters,
+         (time_ns() - start) / 1000);
+
+  // higher priority trap on a reason code range
+  SWITCH_MEMSET(&rx_key, 0, sizeof(rx_key));
+  rx_key.reason_code = 0x120;
+  rx_key.reason_code_mask = 0xF00;
+  status = switch_pktdriver_rx_filter_create(
+      device,
+      SWITCH_PKTDRIVER_RX_FILTER_PRIORITY_TRAP,
+      SWITCH_PKTDRIVER_RX_FILTER_ATTR_REASON_CODE,
+      &rx_key,
+      &rx_action,
+      &trap_id);
+  assert(status == SWITCH_STATUS_SUCCESS);
+
+  // lower priority catch all per port
+  SWITCH_MEMSET(&rx_key, 0, sizeof(rx_key));
+  rx_key.dev_port = 10;
+  status = switch_pktdriver_rx_filter_create(
+      device,
+      SWITCH_PKTDRIVER_RX_FILTER_PRIORITY_PORT,
+      SWITCH_PKTDRIVER_RX_FILTER_ATTR_DEV_PORT,
+      &rx_key,
+      &rx_action,
+      &port_id);
+  assert(status == SWITCH_STATUS_SUCCESS);
+
+  SWITCH_MEMSET(&rx_key, 0, sizeof(rx_key));
+  rx_key.dev_port = 10;
+  rx_key.bd = 5000;
+  status = switch_pktdriver_rx_filter_info_get(&rx_key, &rx_info);
+  assert(status == SWITCH_STATUS_SUCCESS);
+  assert((uintptr_t)rx_info == filter_ids[4999]);
+
+  rx_key.reason_code = 0x1ab;
+  status = switch_pktdriver_rx_filter_info_get(&rx_key, &rx_info);
+  assert(status == SWITCH_STATUS_SUCCESS);
+  assert((uintptr_t)rx_info == trap_id);
+
+  rx_key.reason_code = 0;
+  rx_key.bd = num_filters + 1;
+  status = switch_pktdriver_rx_filter_info_get(&rx_key, &rx_info);
+  assert(status == SWITCH_STATUS_SUCCESS);
+  assert((uintptr_t)rx_info == port_id);
+
+  rx_key.dev_port = 11;
+  status = switch_pktdriver_rx_filter_info_get(&rx_key, &rx_info);
+  assert(status == SWITCH_STATUS_ITEM_NOT_FOUND);
+
+  // same key and priority, the filter added last wins
+  rx_key.bd = 100;
+  status = switch_pktdriver_rx_filter_create(
+      device,
+      SWITCH_PKTDRIVER_RX_FILTER_PRIORITY_VLAN,
+      SWITCH_PKTDRIVER_RX_FILTER_ATTR_BD,
+      &rx_key,
+      &rx_action,
+      &dup_id);
+  assert(status == SWITCH_STATUS_SUCCESS);
+  status = switch_pktdriver_rx_filter_info_get(&rx_key, &rx_info);
+  assert(status == SWITCH_STATUS_SUCCESS);
+  assert((uintptr_t)rx_info == dup_id);
+  status = switch_pktdriver_rx_filter_delete(device, &rx_key, dup_id);
+  assert(status == SWITCH_STATUS_SUCCESS);
+  status = switch_pktdriver_rx_filter_info_get(&rx_key, &rx_info);
+  assert(status == SWITCH_STATUS_SUCCESS);
+  assert((uintptr_t)rx_info == filter_ids[99]);
+
+  start = time_ns();
+  for (uint32_t i = 0; i < num_lookups; i++) {
+    rx_key.dev_port = i & 0x1f;
+    rx_key.bd = (i * 7919) % (num_filters + 100) + 1;
+    rx_key.reason_code = i & 0x3ff;
+    switch_pktdriver_rx_filter_info_get(&rx_key, &rx_info);
+  }
+  uint64_t elapsed = time_ns() - start;
+  printf("%u rx filter lookups over %u filters: %" PRIu64
+         " ns/lookup, %" PRIu64 " lookups/s\n",
+         num_lookups,
+         num_filters + 2,
+         elapsed / num_lookups,
+         (uint64_t)num_lookups * 1000000000 / elapsed);
+
+  for (uint32_t i = 0; i < num_filters; i++) {
+    rx_key.bd = i + 1;
+    status =
+        switch_pktdriver_rx_filter_delete(device, &rx_key, filter_ids[i]);
+    assert(status == SWITCH_STATUS_SUCCESS);
+  }
+  status = switch_pktdriver_rx_filter_delete(device, &rx_key, trap_id);
+  assert(status == SWITCH_STATUS_SUCCESS);
+  status = switch_pktdriver_rx_filter_delete(device, &rx_key, port_id);
+  assert(status == SWITCH_STATUS_SUCCESS);
+
+  rx_key.dev_port = 10;
+  status = switch_pktdriver_rx_filter_info_get(&rx_key, &rx_info);
+  assert(status == SWITCH_STATUS_ITEM_NOT_FOUND);
+}
+
 // clang-format off
 uint8_t test_pkt[SWITCH_PACKET_MAX_BUFFER_SIZE] = {
     0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x90, 0x00, 0x00, 0x00,
@@ -197,14 +331,33 @@ void test_fd() {
   switch_status_t status;
 
   uint16_t bd = 1, vlan = 1;
+  int fds[2];
+  switch_pktdriver_io_stats_t io_stats = {};
 
-  status = switch_pktdriver_fd_add(device, 2);
+  assert(pipe(fds) == 0);
+  status = switch_pktdriver_fd_add(device, fds[0]);
   assert(status == SWITCH_STATUS_SUCCESS);
   printf("*** packet fd add ***\n");
 
-  switch_pktdriver_fd_delete(device, 2);
+  // adding the same fd again is not an error
+  status = switch_pktdriver_fd_add(device, fds[0]);
+  assert(status == SWITCH_STATUS_SUCCESS);
+
+  status = switch_pktdriver_fd_delete(device, fds[0]);
   assert(status == SWITCH_STATUS_SUCCESS);
   printf("*** fd del ***\n");
+  close(fds[0]);
+  close(fds[1]);
+
+  status = switch_pktdriver_io_stats_get(&io_stats);
+  assert(status == SWITCH_STATUS_SUCCESS);
+  assert(io_stats.rx_batches <= io_stats.rx_pkts);
+  status = switch_pktdriver_io_stats_clear();
+  assert(status == SWITCH_STATUS_SUCCESS);
+  status = switch_pktdriver_io_stats_get(&io_stats);
+  assert(status == SWITCH_STATUS_SUCCESS);
+  assert(io_stats.rx_pkts == 0 && io_stats.rx_latency_max_ns == 0);
+  printf("*** io stats ***\n");
 
   status = switch_pktdriver_bd_to_vlan_mapping_add(device, bd, vlan);
   assert(status == SWITCH_STATUS_SUCCESS);
@@ -415,6 +568,74 @@ void test_cb_and_netdev() {
   printf("\n");
 }
 
+/*
+ * Runs the packet driver on a raw cpu socket over loopback. Frames sent out of
+ * the hostif are read from its tun queues, batched to the cpu port with
+ * sendmmsg and come back on the cpu fanout sockets.
+ */
+void test_cpu_sock_batch() {
+  printf("%s\n", __func__);
+  switch_status_t status;
+  uint64_t pkt_hostif_handle = 0;
+  int fd = 0;
+  uint64_t rx_filter_id = 0, tx_filter_id = 0, tx_pkts = 0;
+  switch_pktdriver_io_stats_t io_stats = {};
+  struct sockaddr_ll addr = {};
+  struct ifreq ifr = {};
+  uint8_t frame[64] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x0, 0x1,
+                       0x2,  0x3,  0x4,  0x5,  0x88, 0xb5};
+  const int n = 1000;
+
+  status = switch_packet_init("lo", false, false);
+  assert(status == SWITCH_STATUS_SUCCESS);
+  status = start_bf_switch_api_packet_driver();
+  assert(status == SWITCH_STATUS_SUCCESS);
+
+  setup_rx_filter_netdev(&pkt_hostif_handle, &fd, &rx_filter_id, &tx_filter_id);
+  status = switch_pktdriver_io_stats_clear();
+  assert(status == SWITCH_STATUS_SUCCESS);
+
+  int sock = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+  assert(sock >= 0);
+  strncpy(ifr.ifr_name, "test_intf", IFNAMSIZ);
+  assert(ioctl(sock, SIOCGIFINDEX, &ifr) == 0);
+  addr.sll_family = AF_PACKET;
+  addr.sll_ifindex = ifr.ifr_ifindex;
+  addr.sll_halen = ETH_ALEN;
+  for (int i = 0; i < n; i++) {
+    assert(sendto(sock,
+                  frame,
+                  sizeof(frame),
+                  0,
+                  (struct sockaddr *)&addr,
+                  sizeof(addr)) == sizeof(frame));
+  }
+  close(sock);
+  usleep(1000000);
+
+  status =
+      switch_pktdriver_tx_filter_num_packets_get(0, tx_filter_id, &tx_pkts);
+  assert(status == SWITCH_STATUS_SUCCESS);
+  assert(tx_pkts >= (uint64_t)n);
+  status = switch_pktdriver_io_stats_get(&io_stats);
+  assert(status == SWITCH_STATUS_SUCCESS);
+  // every frame is read once from the tun queues and once from the cpu port
+  assert(io_stats.rx_pkts >= 2 * (uint64_t)n);
+  assert(io_stats.rx_batches < io_stats.rx_pkts);
+  printf("*** cpu sock batch: %" PRIu64 " pkts %" PRIu64 " batches ***\n",
+         io_stats.rx_pkts,
+         io_stats.rx_batches);
+
+  teardown_rx_filter_netdev(pkt_hostif_handle, fd, rx_filter_id, tx_filter_id);
+
+  status = stop_bf_switch_api_packet_driver();
+  assert(status == SWITCH_STATUS_SUCCESS);
+  status = switch_packet_clean();
+  assert(status == SWITCH_STATUS_SUCCESS);
+
+  printf("\n");
+}
+
 void test_switch_packet_cb(char *pkt,
                            int pkt_size,
                            uint64_t port_lag_handle,
@@ -444,6 +665,7 @@ int main(void) {
   test_netdev();
   test_fd();
   test_rx_filter();
+  test_rx_filter_scale();
   test_cb();
   test_cb_and_netdev();
 
@@ -455,6 +677,8 @@ int main(void) {
   assert(status == SWITCH_STATUS_SUCCESS);
   printf("*** pkt clean ***\n");
 
+  test_cpu_sock_batch();
+
   printf("\n\nAll tests passed!\n");
   return 0;
 }
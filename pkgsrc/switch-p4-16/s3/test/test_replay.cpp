@@ -17,7 +17,10 @@
  *  SPDX-License-Identifier: Apache-2.0
  ******************************************************************************/
 
+#include <unistd.h>
+
 #include <cassert>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 
@@ -736,6 +739,57 @@ void test_mac() {
   assert(status == SWITCH_STATUS_SUCCESS);
 }
 
+void test_snapshot_read_back(switch_object_id_t oid, uint32_t uint32) {
+  switch_status_t status;
+  uint32_t uint32_new = 0;
+  switch_object_id_t first_handle = {};
+  switch_store::object_get_first_handle(test_object_1, first_handle);
+  assert(first_handle.data == oid.data);
+
+  attr_w uint32_attr(test_attribute_uint32);
+  status = switch_store::attribute_get(
+      first_handle, test_attribute_uint32, uint32_attr);
+  assert(status == SWITCH_STATUS_SUCCESS);
+  uint32_attr.v_get(uint32_new);
+  assert(uint32 == uint32_new);
+}
+
+void test_snapshot() {
+  std::cout << "**** Tesing warm init from binary snapshot ****" << std::endl;
+  switch_status_t status;
+
+  uint32_t uint32 = 0x12345678;
+  std::set<attr_w> attrs;
+  switch_object_id_t oid = {};
+  attrs.insert(attr_w(test_attribute_uint32, uint32));
+  status = switch_store::object_create(test_object_1, attrs, oid);
+  assert(status == SWITCH_STATUS_SUCCESS);
+
+  // snapshot alone is enough to restore
+  switch_store::object_info_dump("/tmp/db.txt");
+  unlink("/tmp/db.txt");
+  switch_store::object_info_clean();
+  switch_store::object_info_init(test_model_name, true, "/tmp/db.txt");
+  switch_store::object_replay(true);
+  test_snapshot_read_back(oid, uint32);
+
+  // corrupt snapshot is ignored and the text dump is used instead
+  switch_store::object_info_dump("/tmp/db.txt");
+  std::fstream snap("/tmp/db.txt.snap",
+                    std::ios::in | std::ios::out | std::ios::binary);
+  snap.seekp(-1, std::ios::end);
+  snap.put(0x5a);
+  snap.close();
+  switch_store::object_info_clean();
+  switch_store::object_info_init(test_model_name, true, "/tmp/db.txt");
+  switch_store::object_replay(true);
+  test_snapshot_read_back(oid, uint32);
+
+  // simulate cold init
+  switch_store::object_info_clean();
+  switch_store::object_info_init(test_model_name, false, NULL);
+}
+
 /*
  * Test object graph cycles and joins
  * device -> port1
@@ -1297,6 +1351,7 @@ int main(void) {
   test_ip_address_host();
   test_ip_address_lpm();
   test_mac();
+  test_snapshot();
   test_oid();
   test_lists();
   test_auto_objects();